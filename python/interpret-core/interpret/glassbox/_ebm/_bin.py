@@ -28,6 +28,13 @@ def eval_terms(X, n_samples, feature_names_in, feature_types_in, bins, term_feat
 
     _log.info("eval_terms")
 
+    native_terms = _native_eval_terms(
+        X, n_samples, feature_names_in, feature_types_in, bins, term_features
+    )
+    if native_terms is not None:
+        yield from native_terms
+        return
+
     requests = []
     waiting = dict()
     for term_idx, feature_idxs in enumerate(term_features):
@@ -128,6 +135,92 @@ def eval_terms(X, n_samples, feature_names_in, feature_types_in, bins, term_feat
                         requirements.clear()
 
 
+def _continuous_binnings(X, n_samples, feature_names_in, feature_types_in, bins, term_features):
+    # the native binning functions handle numeric matrices where every feature used is continuous. For
+    # anything else (pandas, strings, categoricals) return None and let the caller use unify_columns instead.
+    # Otherwise returns the float64 matrix, the unique (feature_idx, cuts) binnings, and the binning
+    # indexes of each term
+
+    if type(X) is not np.ndarray or X.ndim != 2:
+        return None
+    if X.shape[0] != n_samples or X.shape[1] != len(feature_names_in):
+        return None
+    if X.dtype.kind not in "fiub":
+        return None
+
+    binnings = []
+    binning_idxs = dict()
+    term_binnings = []
+    for feature_idxs in term_features:
+        dimension_binnings = []
+        for feature_idx in feature_idxs:
+            if feature_types_in[feature_idx] != "continuous":
+                return None
+            bin_levels = bins[feature_idx]
+            level_idx = min(len(bin_levels), len(feature_idxs)) - 1
+            cuts = bin_levels[level_idx]
+            if isinstance(cuts, dict):
+                return None
+            key = (feature_idx, level_idx)
+            binning_idx = binning_idxs.get(key, None)
+            if binning_idx is None:
+                binning_idx = len(binnings)
+                binning_idxs[key] = binning_idx
+                binnings.append((feature_idx, cuts))
+            dimension_binnings.append(binning_idx)
+        term_binnings.append(dimension_binnings)
+
+    if X.dtype.type is not np.float64:
+        X = X.astype(np.float64)
+
+    return X, binnings, term_binnings
+
+
+def _native_eval_terms(X, n_samples, feature_names_in, feature_types_in, bins, term_features):
+    # bins every column needed by the terms in a single native call, which reads each row of a C ordered
+    # matrix once instead of once per feature
+
+    continuous = _continuous_binnings(
+        X, n_samples, feature_names_in, feature_types_in, bins, term_features
+    )
+    if continuous is None:
+        return None
+    X, binnings, term_binnings = continuous
+
+    native = Native.get_native_singleton()
+    bin_indexes = native.discretize_matrix(X, binnings)
+    return (
+        (term_idx, [bin_indexes[binning_idx] for binning_idx in dimension_binnings])
+        for term_idx, dimension_binnings in enumerate(term_binnings)
+    )
+
+
+def _native_predict_scores(
+    X,
+    n_samples,
+    feature_names_in,
+    feature_types_in,
+    bins,
+    intercept,
+    term_scores,
+    term_features,
+):
+    continuous = _continuous_binnings(
+        X, n_samples, feature_names_in, feature_types_in, bins, term_features
+    )
+    if continuous is None:
+        return None
+    X, binnings, term_binnings = continuous
+
+    native = Native.get_native_singleton()
+    scores = native.predict_scores(
+        X, binnings, term_binnings, term_scores, np.atleast_1d(intercept)
+    )
+    if isinstance(intercept, float) or len(intercept) == 1:
+        scores = scores.reshape(n_samples)
+    return scores
+
+
 def ebm_predict_scores(
     X,
     n_samples,
@@ -139,6 +232,22 @@ def ebm_predict_scores(
     term_features,
     init_score=None,
 ):
+    if 0 < n_samples:
+        sample_scores = _native_predict_scores(
+            X,
+            n_samples,
+            feature_names_in,
+            feature_types_in,
+            bins,
+            intercept,
+            term_scores,
+            term_features,
+        )
+        if sample_scores is not None:
+            if init_score is not None:
+                sample_scores += init_score
+            return sample_scores
+
     shape = n_samples
     if not isinstance(intercept, float) and len(intercept) != 1:
         shape = (n_samples, len(intercept))
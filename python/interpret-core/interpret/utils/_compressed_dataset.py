@@ -95,6 +95,15 @@ def bin_native(
 
     native.fill_dataset_header(len(requests), n_weights, 1, dataset)
 
+    # features are handed to the native code in chunks so that it can pack them in
+    # parallel while we bound the memory held by the temporary bin index matrix
+    n_chunk = max(1, min(len(requests), (1 << 24) // max(1, n_samples)))
+    chunk = np.empty((n_chunk, n_samples), np.int64)
+    chunk_bins = []
+    chunk_missing = []
+    chunk_unknown = []
+    chunk_nominal = []
+
     for (feature_idx, feature_bins), (_, X_col, _, bad) in zip(
         responses,
         unify_columns(X, requests, feature_names_in, feature_types_in, None, False),
@@ -119,12 +128,28 @@ def bin_native(
         if bad is not None:
             X_col[bad != _none_ndarray] = n_bins - 1
 
-        native.fill_feature(
-            n_bins,
-            np.count_nonzero(X_col) != len(X_col),
-            bad is not None,
-            feature_types_in[feature_idx] == "nominal",
-            X_col,
+        chunk[len(chunk_bins)] = X_col
+        chunk_bins.append(n_bins)
+        chunk_missing.append(np.count_nonzero(X_col) != len(X_col))
+        chunk_unknown.append(bad is not None)
+        chunk_nominal.append(feature_types_in[feature_idx] == "nominal")
+
+        if len(chunk_bins) == n_chunk:
+            native.fill_features(
+                chunk_bins, chunk_missing, chunk_unknown, chunk_nominal, chunk, dataset
+            )
+            chunk_bins = []
+            chunk_missing = []
+            chunk_unknown = []
+            chunk_nominal = []
+
+    if len(chunk_bins) != 0:
+        native.fill_features(
+            chunk_bins,
+            chunk_missing,
+            chunk_unknown,
+            chunk_nominal,
+            chunk[: len(chunk_bins)],
             dataset,
         )
 
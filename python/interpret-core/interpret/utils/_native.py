@@ -24,6 +24,10 @@ class Native:
     CreateBoosterFlags_Default = 0x00000000
     CreateBoosterFlags_DifferentialPrivacy = 0x00000001
     CreateBoosterFlags_DisableApprox = 0x00000002
+    CreateBoosterFlags_TargetSorted = 0x00000008
+    CreateBoosterFlags_QuantizeGradients = 0x00000010
+    CreateBoosterFlags_QuantizeGradientsInt8 = 0x00000020
+    CreateBoosterFlags_Float32 = 0x00000040
 
     # TermBoostFlags
     TermBoostFlags_Default = 0x00000000
@@ -36,6 +40,8 @@ class Native:
     CreateInteractionFlags_Default = 0x00000000
     CreateInteractionFlags_DifferentialPrivacy = 0x00000001
     CreateInteractionFlags_DisableApprox = 0x00000002
+    CreateInteractionFlags_TargetSorted = 0x00000008
+    CreateInteractionFlags_Float32 = 0x00000010
 
     # CalcInteractionFlags
     CalcInteractionFlags_Default = 0x00000000
@@ -51,6 +57,13 @@ class Native:
     AccelerationFlags_GPU = AccelerationFlags_Nvidia
     AccelerationFlags_ALL = 0xFFFFFFFF
 
+    # LinkEbm (only the links that PredictScores can invert)
+    Link_mlogit = 20
+    Link_vlogit = 30
+    Link_logit = 40
+    Link_identity = 100
+    Link_log = 101
+
     # Tasks
     Task_Ranking = -3
     Task_Regression = -2
@@ -209,6 +222,11 @@ class Native:
 
         self._unsafe.SetTraceLevel(trace_level)
 
+    def set_thread_count(self, n_threads):
+        # applies to boosters created after this call. 0 means all hardware threads and
+        # negative values leave that many hardware threads unused
+        self._unsafe.SetThreadCount(n_threads)
+
     def clean_float(self, val):
         # the EBM spec does not allow subnormal floats to be in the model definition, so flush them to zero
         val_array = np.array([val], np.float64)
@@ -319,6 +337,89 @@ class Native:
 
         return cuts[: count_cuts.value]
 
+    def cut_quantiles(self, X, min_samples_bin, is_rounded, max_cuts):
+        # X is a 2D array with one row of values per feature.  min_samples_bin and
+        # max_cuts can be scalars or have one item per feature
+        X = np.ascontiguousarray(X, np.float64)
+        n_features = X.shape[0]
+        min_samples_bin = np.ascontiguousarray(
+            np.broadcast_to(min_samples_bin, n_features), np.int64
+        )
+        count_cuts = np.array(np.broadcast_to(max_cuts, n_features), np.int64)
+        if (count_cuts < 0).any():
+            raise Exception(f"max_cuts can't be negative: {max_cuts}.")
+
+        first_cuts = np.zeros(n_features + 1, np.int64)
+        np.cumsum(count_cuts, out=first_cuts[1:])
+        cuts = np.empty(first_cuts[-1], dtype=np.float64, order="C")
+
+        return_code = self._unsafe.CutQuantiles(
+            n_features,
+            X.shape[1],
+            Native._make_pointer(X, np.float64, 2),
+            Native._make_pointer(min_samples_bin, np.int64),
+            is_rounded,
+            Native._make_pointer(count_cuts, np.int64),
+            Native._make_pointer(cuts, np.float64),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "CutQuantiles")
+
+        return [
+            cuts[first : first + count]
+            for first, count in zip(first_cuts[:-1], count_cuts)
+        ]
+
+    def create_quantile_sketch(self, items_per_level):
+        n_bytes = self._unsafe.MeasureQuantileSketch(items_per_level)
+        if n_bytes < 0:  # pragma: no cover
+            raise Native._get_native_exception(n_bytes, "MeasureQuantileSketch")
+
+        sketch = np.empty(n_bytes, np.ubyte)
+        return_code = self._unsafe.InitQuantileSketch(
+            items_per_level, n_bytes, Native._make_pointer(sketch, np.ubyte)
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "InitQuantileSketch")
+
+        return sketch
+
+    def add_to_quantile_sketch(self, sketch, X_col):
+        X_col = np.ascontiguousarray(X_col, np.float64)
+        return_code = self._unsafe.AddToQuantileSketch(
+            X_col.shape[0],
+            Native._make_pointer(X_col, np.float64),
+            Native._make_pointer(sketch, np.ubyte),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "AddToQuantileSketch")
+
+    def merge_quantile_sketch(self, sketch_from, sketch_into):
+        return_code = self._unsafe.MergeQuantileSketch(
+            Native._make_pointer(sketch_from, np.ubyte),
+            Native._make_pointer(sketch_into, np.ubyte),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "MergeQuantileSketch")
+
+    def cut_quantile_sketch(self, sketch, min_samples_bin, is_rounded, max_cuts):
+        if max_cuts < 0:
+            raise Exception(f"max_cuts can't be negative: {max_cuts}.")
+
+        cuts = np.empty(max_cuts, dtype=np.float64, order="C")
+        count_cuts = ct.c_int64(max_cuts)
+        return_code = self._unsafe.CutQuantileSketch(
+            Native._make_pointer(sketch, np.ubyte),
+            min_samples_bin,
+            is_rounded,
+            ct.byref(count_cuts),
+            Native._make_pointer(cuts, np.float64),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "CutQuantileSketch")
+
+        return cuts[: count_cuts.value]
+
     def cut_winsorized(self, X_col, max_cuts):
         if max_cuts < 0:
             raise Exception(f"max_cuts can't be negative: {max_cuts}.")
@@ -383,6 +484,153 @@ class Native:
 
         return bin_indexes
 
+    def discretize_matrix(self, X, binnings):
+        # binnings is a list of (feature_idx, cuts). Returns bin indexes shaped (len(binnings), n_samples)
+        n_samples = X.shape[0]
+        bin_indexes = np.empty((len(binnings), n_samples), dtype=np.int64, order="C")
+        if not X.flags.c_contiguous:
+            # columns are already contiguous in fortran ordered data, so bin them directly
+            for binning_idx, (feature_idx, cuts) in enumerate(binnings):
+                bin_indexes[binning_idx] = self.discretize(
+                    np.ascontiguousarray(X[:, feature_idx]), cuts
+                )
+            return bin_indexes
+
+        binning_feature_idxs = np.array(
+            [feature_idx for feature_idx, _ in binnings], np.int64
+        )
+        binning_n_cuts = np.array([len(cuts) for _, cuts in binnings], np.int64)
+        binning_cuts = np.concatenate(
+            [cuts for _, cuts in binnings] + [np.empty(0, np.float64)]
+        ).astype(np.float64, copy=False)
+
+        return_code = self._unsafe.DiscretizeMatrix(
+            n_samples,
+            X.shape[1],
+            Native._make_pointer(X, np.float64, 2),
+            len(binnings),
+            Native._make_pointer(binning_feature_idxs, np.int64),
+            Native._make_pointer(binning_n_cuts, np.int64),
+            Native._make_pointer(binning_cuts, np.float64),
+            Native._make_pointer(bin_indexes, np.int64, 2),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "DiscretizeMatrix")
+
+        return bin_indexes
+
+    @staticmethod
+    def _scoring_matrix(X):
+        is_fortran = not X.flags.c_contiguous
+        if is_fortran and not X.flags.f_contiguous:
+            X = np.ascontiguousarray(X)
+            is_fortran = False
+        return X, is_fortran
+
+    @staticmethod
+    def _flatten_scoring_model(binnings, term_binnings, term_scores, intercept):
+        binning_feature_idxs = np.array(
+            [feature_idx for feature_idx, _ in binnings], np.int64
+        )
+        binning_is_categorical = np.zeros(len(binnings), np.int32)
+        binning_n_values = np.array([len(cuts) for _, cuts in binnings], np.int64)
+        # the missing bin, one more bin than cuts, and the unknown bin
+        binning_n_bins = binning_n_values + 2 + 1
+        binning_values = np.concatenate(
+            [cuts for _, cuts in binnings] + [np.empty(0, np.float64)]
+        ).astype(np.float64, copy=False)
+
+        term_dimension_counts = np.array([len(t) for t in term_binnings], np.int64)
+        term_binning_idxs = np.array(
+            [idx for t in term_binnings for idx in t], np.int64
+        )
+        term_scores_flat = np.concatenate(
+            [np.ravel(t) for t in term_scores] + [np.empty(0, np.float64)]
+        ).astype(np.float64, copy=False)
+        intercept = np.ascontiguousarray(intercept, np.float64)
+
+        return (
+            binning_feature_idxs,
+            binning_is_categorical,
+            binning_n_bins,
+            binning_n_values,
+            binning_values,
+            term_dimension_counts,
+            term_binning_idxs,
+            term_scores_flat,
+            intercept,
+        )
+
+    @staticmethod
+    def _scoring_model_args(model):
+        (
+            binning_feature_idxs,
+            binning_is_categorical,
+            binning_n_bins,
+            binning_n_values,
+            binning_values,
+            term_dimension_counts,
+            term_binning_idxs,
+            term_scores_flat,
+            intercept,
+        ) = model
+        return (
+            len(binning_feature_idxs),
+            Native._make_pointer(binning_feature_idxs, np.int64),
+            Native._make_pointer(binning_is_categorical, np.int32),
+            Native._make_pointer(binning_n_bins, np.int64),
+            Native._make_pointer(binning_n_values, np.int64),
+            Native._make_pointer(binning_values, np.float64),
+            None,
+            len(term_dimension_counts),
+            Native._make_pointer(term_dimension_counts, np.int64),
+            Native._make_pointer(term_binning_idxs, np.int64),
+            len(intercept),
+            Native._make_pointer(term_scores_flat, np.float64),
+            Native._make_pointer(intercept, np.float64),
+        )
+
+    def predict_scores(
+        self, X, binnings, term_binnings, term_scores, intercept, link=None
+    ):
+        """Evaluates an additive model over a matrix of continuous features.
+
+        Args:
+            X: 2-D float64 numpy array in C or Fortran order.
+            binnings: list of (feature_idx, cuts) tuples.
+            term_binnings: for each term, the indexes into binnings of its dimensions.
+            term_scores: for each term, its tensor of scores.
+            intercept: numpy array with the intercept for each score.
+            link: LinkEbm value of the inverse link to apply, or None for the raw scores.
+
+        Returns:
+            The scores for each sample.
+        """
+
+        n_samples, n_features = X.shape
+        X, is_fortran = Native._scoring_matrix(X)
+
+        model = Native._flatten_scoring_model(
+            binnings, term_binnings, term_scores, intercept
+        )
+        n_scores = len(model[-1])
+
+        scores = np.empty((n_samples, n_scores), np.float64, order="C")
+        return_code = self._unsafe.PredictScores(
+            n_samples,
+            n_features,
+            is_fortran,
+            # the transpose of a Fortran ordered matrix is C ordered
+            Native._make_pointer(X.T if is_fortran else X, np.float64, 2),
+            *Native._scoring_model_args(model),
+            Native.Link_identity if link is None else link,
+            Native._make_pointer(scores, np.float64, 2),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "PredictScores")
+
+        return scores
+
     def measure_dataset_header(self, n_features, n_weights, n_targets):
         n_bytes = self._unsafe.MeasureDataSetHeader(n_features, n_weights, n_targets)
         if n_bytes < 0:  # pragma: no cover
@@ -457,6 +705,29 @@ class Native:
         if return_code:  # pragma: no cover
             raise Native._get_native_exception(return_code, "FillFeature")
 
+    def fill_features(
+        self, n_bins, is_missing, is_unknown, is_nominal, bin_indexes, dataset
+    ):
+        # bin_indexes is a 2D array with one row of bin indexes per feature
+        n_bins = np.ascontiguousarray(n_bins, np.int64)
+        is_missing = np.ascontiguousarray(is_missing, np.int32)
+        is_unknown = np.ascontiguousarray(is_unknown, np.int32)
+        is_nominal = np.ascontiguousarray(is_nominal, np.int32)
+
+        return_code = self._unsafe.FillFeatures(
+            len(n_bins),
+            Native._make_pointer(n_bins, np.int64),
+            Native._make_pointer(is_missing, np.int32),
+            Native._make_pointer(is_unknown, np.int32),
+            Native._make_pointer(is_nominal, np.int32),
+            bin_indexes.shape[1],
+            Native._make_pointer(bin_indexes, np.int64, 2),
+            dataset.nbytes,
+            Native._make_pointer(dataset, np.ubyte),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "FillFeatures")
+
     def fill_weight(self, weights, dataset):
         return_code = self._unsafe.FillWeight(
             len(weights),
@@ -591,6 +862,27 @@ class Native:
 
         return bag
 
+    def subsample_without_replacement(self, rng, dataset, bag, n_subsample_samples):
+        """Draws a subsample of the training samples of dataset, stratified by class
+        for classification. Training samples that are not chosen become validation
+        samples, so the init_scores for bag can also be used with the returned bag."""
+        n_samples, _, _, _ = self.extract_dataset_header(dataset)
+
+        bag_out = np.empty(n_samples, dtype=np.int8, order="C")
+
+        return_code = self._unsafe.SubsampleWithoutReplacement(
+            Native._make_pointer(rng, np.ubyte, is_null_allowed=True),
+            Native._make_pointer(dataset, np.ubyte),
+            Native._make_pointer(bag, np.int8, 1, True),
+            n_subsample_samples,
+            Native._make_pointer(bag_out, np.int8),
+        )
+
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "SubsampleWithoutReplacement")
+
+        return bag_out
+
     def determine_task(self, objective):
         task = ct.c_int64(0)
 
@@ -776,6 +1068,12 @@ class Native:
         ]
         self._unsafe.SetTraceLevel.restype = None
 
+        self._unsafe.SetThreadCount.argtypes = [
+            # int64_t countThreads
+            ct.c_int64
+        ]
+        self._unsafe.SetThreadCount.restype = None
+
         self._unsafe.CleanFloats.argtypes = [
             # int64_t count
             ct.c_int64,
@@ -867,6 +1165,72 @@ class Native:
         ]
         self._unsafe.CutQuantile.restype = ct.c_int32
 
+        self._unsafe.CutQuantiles.argtypes = [
+            # int64_t countFeatures
+            ct.c_int64,
+            # int64_t countSamples
+            ct.c_int64,
+            # double * featureVals
+            ct.c_void_p,
+            # int64_t * minSamplesBin
+            ct.c_void_p,
+            # int32_t isRounded
+            ct.c_int32,
+            # int64_t * countCutsInOut
+            ct.c_void_p,
+            # double * cutsLowerBoundInclusiveOut
+            ct.c_void_p,
+        ]
+        self._unsafe.CutQuantiles.restype = ct.c_int32
+
+        self._unsafe.MeasureQuantileSketch.argtypes = [
+            # int64_t countItemsPerLevel
+            ct.c_int64,
+        ]
+        self._unsafe.MeasureQuantileSketch.restype = ct.c_int64
+
+        self._unsafe.InitQuantileSketch.argtypes = [
+            # int64_t countItemsPerLevel
+            ct.c_int64,
+            # int64_t countBytesAllocated
+            ct.c_int64,
+            # void * sketchOut
+            ct.c_void_p,
+        ]
+        self._unsafe.InitQuantileSketch.restype = ct.c_int32
+
+        self._unsafe.AddToQuantileSketch.argtypes = [
+            # int64_t countSamples
+            ct.c_int64,
+            # double * featureVals
+            ct.c_void_p,
+            # void * sketch
+            ct.c_void_p,
+        ]
+        self._unsafe.AddToQuantileSketch.restype = ct.c_int32
+
+        self._unsafe.MergeQuantileSketch.argtypes = [
+            # void * sketchFrom
+            ct.c_void_p,
+            # void * sketchInto
+            ct.c_void_p,
+        ]
+        self._unsafe.MergeQuantileSketch.restype = ct.c_int32
+
+        self._unsafe.CutQuantileSketch.argtypes = [
+            # void * sketch
+            ct.c_void_p,
+            # int64_t minSamplesBin
+            ct.c_int64,
+            # int32_t isRounded
+            ct.c_int32,
+            # int64_t * countCutsInOut
+            ct.POINTER(ct.c_int64),
+            # double * cutsLowerBoundInclusiveOut
+            ct.c_void_p,
+        ]
+        self._unsafe.CutQuantileSketch.restype = ct.c_int32
+
         self._unsafe.CutWinsorized.argtypes = [
             # int64_t countSamples
             ct.c_int64,
@@ -911,6 +1275,124 @@ class Native:
         ]
         self._unsafe.Discretize.restype = ct.c_int32
 
+        self._unsafe.DiscretizeMatrix.argtypes = [
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t countFeatures
+            ct.c_int64,
+            # double * featureMatrix
+            ct.c_void_p,
+            # int64_t countBinnings
+            ct.c_int64,
+            # int64_t * binningFeatureIndexes
+            ct.c_void_p,
+            # int64_t * binningCountCuts
+            ct.c_void_p,
+            # double * binningCuts
+            ct.c_void_p,
+            # int64_t * binIndexesOut
+            ct.c_void_p,
+        ]
+        self._unsafe.DiscretizeMatrix.restype = ct.c_int32
+
+        self._unsafe.PredictScores.argtypes = [
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t countFeatures
+            ct.c_int64,
+            # int32_t isFortranOrdered
+            ct.c_int32,
+            # double * featureMatrix
+            ct.c_void_p,
+            # int64_t countBinnings
+            ct.c_int64,
+            # int64_t * binningFeatureIndexes
+            ct.c_void_p,
+            # int32_t * binningIsCategorical
+            ct.c_void_p,
+            # int64_t * binningCountBins
+            ct.c_void_p,
+            # int64_t * binningCountValues
+            ct.c_void_p,
+            # double * binningValues
+            ct.c_void_p,
+            # int64_t * binningCategoryBins
+            ct.c_void_p,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * termDimensionCounts
+            ct.c_void_p,
+            # int64_t * termBinningIndexes
+            ct.c_void_p,
+            # int64_t countScores
+            ct.c_int64,
+            # double * termScores
+            ct.c_void_p,
+            # double * intercept
+            ct.c_void_p,
+            # int32_t link
+            ct.c_int32,
+            # double * scoresOut
+            ct.c_void_p,
+        ]
+        self._unsafe.PredictScores.restype = ct.c_int32
+
+        self._unsafe.CreateScoringModel.argtypes = [
+            # int64_t countBinnings
+            ct.c_int64,
+            # int64_t * binningFeatureIndexes
+            ct.c_void_p,
+            # int32_t * binningIsCategorical
+            ct.c_void_p,
+            # int64_t * binningCountBins
+            ct.c_void_p,
+            # int64_t * binningCountValues
+            ct.c_void_p,
+            # double * binningValues
+            ct.c_void_p,
+            # int64_t * binningCategoryBins
+            ct.c_void_p,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * termDimensionCounts
+            ct.c_void_p,
+            # int64_t * termBinningIndexes
+            ct.c_void_p,
+            # int64_t countScores
+            ct.c_int64,
+            # double * termScores
+            ct.c_void_p,
+            # double * intercept
+            ct.c_void_p,
+            # ScoringModelHandle * scoringModelHandleOut
+            ct.POINTER(ct.c_void_p),
+        ]
+        self._unsafe.CreateScoringModel.restype = ct.c_int32
+
+        self._unsafe.FreeScoringModel.argtypes = [
+            # void * scoringModelHandle
+            ct.c_void_p
+        ]
+        self._unsafe.FreeScoringModel.restype = None
+
+        self._unsafe.PredictScoresWithModel.argtypes = [
+            # void * scoringModelHandle
+            ct.c_void_p,
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t countFeatures
+            ct.c_int64,
+            # int32_t isFortranOrdered
+            ct.c_int32,
+            # double * featureMatrix
+            ct.c_void_p,
+            # int32_t link
+            ct.c_int32,
+            # double * scoresOut
+            ct.c_void_p,
+        ]
+        self._unsafe.PredictScoresWithModel.restype = ct.c_int32
+
         self._unsafe.MeasureDataSetHeader.argtypes = [
             # int64_t countFeatures
             ct.c_int64,
@@ -997,6 +1479,28 @@ class Native:
         ]
         self._unsafe.FillFeature.restype = ct.c_int32
 
+        self._unsafe.FillFeatures.argtypes = [
+            # int64_t countFeatures
+            ct.c_int64,
+            # int64_t * countBins
+            ct.c_void_p,
+            # int32_t * isMissing
+            ct.c_void_p,
+            # int32_t * isUnknown
+            ct.c_void_p,
+            # int32_t * isNominal
+            ct.c_void_p,
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t * binIndexes
+            ct.c_void_p,
+            # int64_t countBytesAllocated
+            ct.c_int64,
+            # void * fillMem
+            ct.c_void_p,
+        ]
+        self._unsafe.FillFeatures.restype = ct.c_int32
+
         self._unsafe.FillWeight.argtypes = [
             # int64_t countSamples
             ct.c_int64,
@@ -1105,6 +1609,20 @@ class Native:
         ]
         self._unsafe.SampleWithoutReplacementStratified.restype = ct.c_int32
 
+        self._unsafe.SubsampleWithoutReplacement.argtypes = [
+            # void * rng
+            ct.c_void_p,
+            # void * dataSet
+            ct.c_void_p,
+            # int8_t * bag
+            ct.c_void_p,
+            # int64_t countSubsampleSamples
+            ct.c_int64,
+            # int8_t * bagOut
+            ct.c_void_p,
+        ]
+        self._unsafe.SubsampleWithoutReplacement.restype = ct.c_int32
+
         self._unsafe.DetermineTask.argtypes = [
             # char * objective
             ct.c_char_p,
@@ -1233,6 +1751,40 @@ class Native:
         ]
         self._unsafe.ApplyTermUpdate.restype = ct.c_int32
 
+        self._unsafe.BoostRounds.argtypes = [
+            # void * rng
+            ct.c_void_p,
+            # void * boosterHandle
+            ct.c_void_p,
+            # int32_t flags
+            ct.c_int32,
+            # double learningRate
+            ct.c_double,
+            # int64_t minSamplesLeaf
+            ct.c_int64,
+            # int64_t maxLeaves
+            ct.c_int64,
+            # double greediness
+            ct.c_double,
+            # int64_t smoothingRounds
+            ct.c_int64,
+            # int64_t maxRounds
+            ct.c_int64,
+            # int64_t earlyStoppingRounds
+            ct.c_int64,
+            # double earlyStoppingTolerance
+            ct.c_double,
+            # BoostRoundsCallbackFunction callback
+            ct.c_void_p,
+            # void * callbackContext
+            ct.c_void_p,
+            # int64_t * countRoundsOut
+            ct.POINTER(ct.c_int64),
+            # double * bestMetricOut
+            ct.POINTER(ct.c_double),
+        ]
+        self._unsafe.BoostRounds.restype = ct.c_int32
+
         self._unsafe.GetBestTermScores.argtypes = [
             # void * boosterHandle
             ct.c_void_p,
@@ -1273,6 +1825,14 @@ class Native:
         ]
         self._unsafe.CreateInteractionDetector.restype = ct.c_int32
 
+        self._unsafe.CreateInteractionDetectorFromBooster.argtypes = [
+            # void * boosterHandle
+            ct.c_void_p,
+            # InteractionHandle * interactionHandleOut
+            ct.POINTER(ct.c_void_p),
+        ]
+        self._unsafe.CreateInteractionDetectorFromBooster.restype = ct.c_int32
+
         self._unsafe.FreeInteractionDetector.argtypes = [
             # void * interactionHandle
             ct.c_void_p
@@ -1297,6 +1857,62 @@ class Native:
         ]
         self._unsafe.CalcInteractionStrength.restype = ct.c_int32
 
+        self._unsafe.CalcInteractionStrengths.argtypes = [
+            # void * interactionHandle
+            ct.c_void_p,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * featureIndexes
+            ct.c_void_p,
+            # CalcInteractionFlags flags
+            ct.c_int32,
+            # int64_t maxCardinality
+            ct.c_int64,
+            # int64_t minSamplesLeaf
+            ct.c_int64,
+            # int64_t countTopTerms
+            ct.c_int64,
+            # int64_t * topTermIndexesOut
+            ct.c_void_p,
+            # double * strengthsOut
+            ct.c_void_p,
+            # int64_t * countPrunedTermsOut
+            ct.POINTER(ct.c_int64),
+        ]
+        self._unsafe.CalcInteractionStrengths.restype = ct.c_int32
+
+        self._unsafe.CalcInteractionStrengthsRefined.argtypes = [
+            # void * subsampleInteractionHandle
+            ct.c_void_p,
+            # void * interactionHandle
+            ct.c_void_p,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * featureIndexes
+            ct.c_void_p,
+            # int32_t flags
+            ct.c_int32,
+            # int64_t maxCardinality
+            ct.c_int64,
+            # int64_t minSamplesLeaf
+            ct.c_int64,
+            # int64_t countRefinedTerms
+            ct.c_int64,
+            # int64_t countTopTerms
+            ct.c_int64,
+            # int64_t * topTermIndexesOut
+            ct.c_void_p,
+            # double * strengthsOut
+            ct.c_void_p,
+            # int64_t * refinedTermIndexesOut
+            ct.c_void_p,
+        ]
+        self._unsafe.CalcInteractionStrengthsRefined.restype = ct.c_int32
+
 
 class Booster(AbstractContextManager):
     """Lightweight wrapper for EBM C boosting code."""
@@ -1536,6 +2152,64 @@ class Booster(AbstractContextManager):
         # _log.debug("Boosting step end")
         return avg_validation_metric.value
 
+    def boost_rounds(
+        self,
+        rng,
+        term_boost_flags,
+        learning_rate,
+        min_samples_leaf,
+        max_leaves,
+        greediness,
+        smoothing_rounds,
+        max_rounds,
+        early_stopping_rounds,
+        early_stopping_tolerance,
+    ):
+        """Runs whole boosting rounds inside the native library.
+
+        Args:
+            term_boost_flags: C interface options
+            learning_rate: Learning rate as a float.
+            min_samples_leaf: Min observations required to split.
+            max_leaves: Max leaf nodes on feature step.
+            greediness: Portion of greedy rounds per cyclic round.
+            smoothing_rounds: Number of initial rounds with random splits.
+            max_rounds: Maximum number of rounds.
+            early_stopping_rounds: Rounds without improvement before stopping.
+            early_stopping_tolerance: Minimum improvement to reset early stopping.
+
+        Returns:
+            Tuple of the number of rounds completed and the best validation metric.
+        """
+
+        self._term_idx = -1
+
+        native = Native.get_native_singleton()
+
+        n_rounds = ct.c_int64(0)
+        best_metric = ct.c_double(np.inf)
+        return_code = native._unsafe.BoostRounds(
+            Native._make_pointer(rng, np.ubyte, is_null_allowed=True),
+            self._booster_handle,
+            term_boost_flags,
+            learning_rate,
+            min_samples_leaf,
+            max_leaves,
+            greediness,
+            smoothing_rounds,
+            max_rounds,
+            early_stopping_rounds,
+            early_stopping_tolerance,
+            None,
+            None,
+            ct.byref(n_rounds),
+            ct.byref(best_metric),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "BoostRounds")
+
+        return n_rounds.value, best_metric.value
+
     def get_best_model(self):
         model = []
         for term_idx in range(len(self.term_features)):
@@ -1792,6 +2466,39 @@ class InteractionDetector(AbstractContextManager):
         _log.info("Allocation interaction end")
         return self
 
+    @classmethod
+    def from_booster(cls, booster):
+        """Creates an interaction detector that scores interactions against the
+        current model of an open Booster without rebuilding the dataset.
+
+        Every feature passed to calc_interaction_strength must be a main term of
+        the booster.  The returned detector is already open and stays valid after
+        the booster is closed.
+
+        Args:
+            booster: an open Booster
+
+        """
+        _log.info("Allocation interaction from booster start")
+
+        native = Native.get_native_singleton()
+
+        interaction_handle = ct.c_void_p(0)
+        return_code = native._unsafe.CreateInteractionDetectorFromBooster(
+            booster._booster_handle,
+            ct.byref(interaction_handle),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(
+                return_code, "CreateInteractionDetectorFromBooster"
+            )
+
+        self = cls.__new__(cls)
+        self._interaction_handle = interaction_handle.value
+
+        _log.info("Allocation interaction from booster end")
+        return self
+
     def __exit__(self, *args):
         self.close()
 
@@ -1832,3 +2539,236 @@ class InteractionDetector(AbstractContextManager):
 
         _log.info("Fast interaction strength end")
         return strength.value
+
+    def calc_interaction_strengths(
+        self,
+        terms,
+        calc_interaction_flags,
+        max_cardinality,
+        min_samples_leaf,
+        n_top_terms=0,
+    ):
+        """Provides strength measurements for many feature interactions in one call. Higher is better.
+
+        Args:
+            terms: list of feature index tuples
+            calc_interaction_flags: flags passed to CalcInteractionStrength
+            max_cardinality: the maximum number of tensor bins in a term
+            min_samples_leaf: the minimum number of samples in each leaf
+            n_top_terms: if 0, the strength of every term is returned. Otherwise only
+                the n_top_terms strongest terms are kept
+
+        Returns:
+            If n_top_terms is 0, an array with the strength of each term. Otherwise a tuple of
+            the term indexes and the strengths of the strongest terms, strongest first
+        """
+        _log.info("Fast interaction strengths start")
+
+        native = Native.get_native_singleton()
+
+        dimension_counts = np.fromiter(
+            (len(feature_idxs) for feature_idxs in terms), np.int64, len(terms)
+        )
+        feature_idxs = np.fromiter(
+            (feature_idx for feature_idxs in terms for feature_idx in feature_idxs),
+            np.int64,
+            int(dimension_counts.sum()),
+        )
+
+        if n_top_terms <= 0:
+            top_term_idxs = None
+            strengths = np.empty(len(terms), np.float64)
+        else:
+            top_term_idxs = np.empty(n_top_terms, np.int64)
+            strengths = np.empty(n_top_terms, np.float64)
+
+        n_pruned = ct.c_int64(0)
+        return_code = native._unsafe.CalcInteractionStrengths(
+            self._interaction_handle,
+            len(terms),
+            Native._make_pointer(dimension_counts, np.int64),
+            Native._make_pointer(feature_idxs, np.int64),
+            calc_interaction_flags,
+            max_cardinality,
+            min_samples_leaf,
+            max(0, n_top_terms),
+            Native._make_pointer(top_term_idxs, np.int64, is_null_allowed=True),
+            Native._make_pointer(strengths, np.float64),
+            ct.byref(n_pruned),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "CalcInteractionStrengths")
+
+        _log.info(
+            "Fast interaction strengths end, pruned %d of %d terms",
+            n_pruned.value,
+            len(terms),
+        )
+
+        if top_term_idxs is None:
+            return strengths
+        # unused entries have a term index of -1 when there are fewer terms than requested
+        n_used = np.count_nonzero(top_term_idxs >= 0)
+        return top_term_idxs[:n_used], strengths[:n_used]
+
+    def calc_interaction_strengths_refined(
+        self,
+        subsample_detector,
+        terms,
+        calc_interaction_flags,
+        max_cardinality,
+        min_samples_leaf,
+        n_refined_terms,
+        n_top_terms,
+    ):
+        """Ranks many feature interactions approximately. Every term is scored on
+        subsample_detector, and only the n_refined_terms strongest are scored again
+        on this detector.
+
+        Args:
+            subsample_detector: an InteractionDetector on a subsample of the data of this one,
+                normally from a bag made by Native.subsample_without_replacement
+            terms: list of feature index tuples
+            calc_interaction_flags: flags passed to CalcInteractionStrength
+            max_cardinality: the maximum number of tensor bins in a term
+            min_samples_leaf: the minimum number of samples in each leaf
+            n_refined_terms: the number of terms to score again on all the samples
+            n_top_terms: the number of strongest terms returned. Cannot be more than n_refined_terms
+
+        Returns:
+            A tuple of the term indexes and the strengths on all the samples of the strongest
+            terms, strongest first, and the indexes of the terms that were refined
+        """
+        _log.info("Refined interaction strengths start")
+
+        native = Native.get_native_singleton()
+
+        dimension_counts = np.fromiter(
+            (len(feature_idxs) for feature_idxs in terms), np.int64, len(terms)
+        )
+        feature_idxs = np.fromiter(
+            (feature_idx for feature_idxs in terms for feature_idx in feature_idxs),
+            np.int64,
+            int(dimension_counts.sum()),
+        )
+
+        top_term_idxs = np.empty(n_top_terms, np.int64)
+        strengths = np.empty(n_top_terms, np.float64)
+        refined_term_idxs = np.empty(n_refined_terms, np.int64)
+
+        return_code = native._unsafe.CalcInteractionStrengthsRefined(
+            subsample_detector._interaction_handle,
+            self._interaction_handle,
+            len(terms),
+            Native._make_pointer(dimension_counts, np.int64),
+            Native._make_pointer(feature_idxs, np.int64),
+            calc_interaction_flags,
+            max_cardinality,
+            min_samples_leaf,
+            n_refined_terms,
+            n_top_terms,
+            Native._make_pointer(top_term_idxs, np.int64),
+            Native._make_pointer(strengths, np.float64),
+            Native._make_pointer(refined_term_idxs, np.int64),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(
+                return_code, "CalcInteractionStrengthsRefined"
+            )
+
+        _log.info("Refined interaction strengths end")
+
+        # unused entries have a term index of -1 when there are fewer terms than requested
+        n_used = np.count_nonzero(top_term_idxs >= 0)
+        n_refined = np.count_nonzero(refined_term_idxs >= 0)
+        return (
+            top_term_idxs[:n_used],
+            strengths[:n_used],
+            refined_term_idxs[:n_refined],
+        )
+
+
+class ScoringModel(AbstractContextManager):
+    """Lightweight wrapper for a compiled EBM scoring model in C.
+
+    The native model is immutable once created, so a single instance can score
+    from several threads at once.
+    """
+
+    def __init__(self, binnings, term_binnings, term_scores, intercept):
+        """Initializes internal wrapper for EBM C code.
+
+        Args:
+            binnings: list of (feature_idx, cuts) tuples.
+            term_binnings: for each term, the indexes into binnings of its dimensions.
+            term_scores: for each term, its tensor of scores.
+            intercept: numpy array with the intercept for each score.
+        """
+
+        self.binnings = binnings
+        self.term_binnings = term_binnings
+        self.term_scores = term_scores
+        self.intercept = intercept
+
+    def __enter__(self):
+        native = Native.get_native_singleton()
+
+        model = Native._flatten_scoring_model(
+            self.binnings, self.term_binnings, self.term_scores, self.intercept
+        )
+        self._n_scores = len(model[-1])
+
+        scoring_model_handle = ct.c_void_p(0)
+        return_code = native._unsafe.CreateScoringModel(
+            *Native._scoring_model_args(model),
+            ct.byref(scoring_model_handle),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "CreateScoringModel")
+
+        self._scoring_model_handle = scoring_model_handle.value
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def close(self):
+        """Deallocates the C scoring model."""
+
+        scoring_model_handle = getattr(self, "_scoring_model_handle", None)
+        if scoring_model_handle:
+            native = Native.get_native_singleton()
+            self._scoring_model_handle = None
+            native._unsafe.FreeScoringModel(scoring_model_handle)
+
+    def predict(self, X, link=None):
+        """Evaluates the model over a matrix of continuous features.
+
+        Args:
+            X: 2-D float64 numpy array in C or Fortran order.
+            link: LinkEbm value of the inverse link to apply, or None for the raw scores.
+
+        Returns:
+            The scores for each sample.
+        """
+
+        native = Native.get_native_singleton()
+
+        n_samples, n_features = X.shape
+        X, is_fortran = Native._scoring_matrix(X)
+
+        scores = np.empty((n_samples, self._n_scores), np.float64, order="C")
+        return_code = native._unsafe.PredictScoresWithModel(
+            self._scoring_model_handle,
+            n_samples,
+            n_features,
+            is_fortran,
+            # the transpose of a Fortran ordered matrix is C ordered
+            Native._make_pointer(X.T if is_fortran else X, np.float64, 2),
+            Native.Link_identity if link is None else link,
+            Native._make_pointer(scores, np.float64, 2),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "PredictScoresWithModel")
+
+        return scores
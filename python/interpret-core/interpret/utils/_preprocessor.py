@@ -30,7 +30,12 @@ _log = logging.getLogger(__name__)
 _none_list = [None]
 
 
-def _cut_continuous(native, X_col, processing, binning, max_bins, min_samples_bin):
+# the number of features cut together by one CutQuantiles call, which bounds the
+# copy of the feature values that the native call needs
+_quantile_batch_features = 64
+
+
+def _continuous_processing(processing, binning):
     # called under: fit
 
     if (
@@ -46,7 +51,13 @@ def _cut_continuous(native, X_col, processing, binning, max_bins, min_samples_bi
             _log.error(msg)
             raise ValueError(msg)
         processing = binning
+    return processing
 
+
+def _cut_continuous(native, X_col, processing, binning, max_bins, min_samples_bin):
+    # called under: fit
+
+    processing = _continuous_processing(processing, binning)
     if processing == "quantile":
         # one bin for missing, one bin for unknown, and # of cuts is one less again
         cuts = native.cut_quantile(X_col, min_samples_bin, 0, max_bins - 3)
@@ -71,6 +82,36 @@ def _cut_continuous(native, X_col, processing, binning, max_bins, min_samples_bi
     return cuts
 
 
+def _cut_quantiles(
+    native,
+    pending,
+    is_rounded,
+    max_bins,
+    min_samples_bin,
+    sample_weight,
+    bins,
+    bin_weights,
+):
+    # called under: fit
+    # cuts the (feature_idx, X_col) items of pending in one native call, which spreads
+    # the features over the native threads and reuses the native sorting buffers
+
+    feature_idxs, X_cols = zip(*pending)
+    pending.clear()
+
+    # one bin for missing, one bin for unknown, and # of cuts is one less again
+    cuts_list = native.cut_quantiles(
+        np.stack(X_cols), min_samples_bin, is_rounded, max_bins - 3
+    )
+    for feature_idx, X_col, cuts in zip(feature_idxs, X_cols, cuts_list):
+        bin_indexes = native.discretize(X_col, cuts)
+        feature_bin_weights = np.bincount(
+            bin_indexes, weights=sample_weight, minlength=len(cuts) + 3
+        )
+        bins[feature_idx] = cuts
+        bin_weights[feature_idx] = feature_bin_weights.astype(np.float64, copy=False)
+
+
 class EBMPreprocessor(BaseEstimator, TransformerMixin):
     """Transformer that preprocesses data to be ready before EBM."""
 
@@ -222,6 +263,8 @@ class EBMPreprocessor(BaseEstimator, TransformerMixin):
         rng = native.create_rng(normalize_seed(self.random_state))
         is_privacy_bounds_warning = False
         is_privacy_types_warning = False
+        # continuous features waiting to be cut by CutQuantiles, by is_rounded
+        pending_quantiles = ([], [])
         for feature_idx, (feature_type_in, X_col, categories, bad) in enumerate(
             unify_columns(
                 X,
@@ -313,21 +356,34 @@ class EBMPreprocessor(BaseEstimator, TransformerMixin):
                 else:
                     min_feature_val = np.nanmin(X_col)
                     max_feature_val = np.nanmax(X_col)
-                    cuts = _cut_continuous(
-                        native,
-                        X_col,
-                        feature_type_given,
-                        self.binning,
-                        max_bins,
-                        self.min_samples_bin,
-                    )
-                    bin_indexes = native.discretize(X_col, cuts)
-                    feature_bin_weights = np.bincount(
-                        bin_indexes, weights=sample_weight, minlength=len(cuts) + 3
-                    )
-                    feature_bin_weights = feature_bin_weights.astype(
-                        np.float64, copy=False
+                    processing = _continuous_processing(
+                        feature_type_given, self.binning
                     )
+                    if processing == "quantile" or processing == "rounded_quantile":
+                        # the cuts and bin weights are filled in by _cut_quantiles
+                        cuts = None
+                        feature_bin_weights = None
+                        pending_quantiles[processing == "rounded_quantile"].append(
+                            (feature_idx, X_col)
+                        )
+                    else:
+                        cuts = _cut_continuous(
+                            native,
+                            X_col,
+                            processing,
+                            self.binning,
+                            max_bins,
+                            self.min_samples_bin,
+                        )
+                        bin_indexes = native.discretize(X_col, cuts)
+                        feature_bin_weights = np.bincount(
+                            bin_indexes,
+                            weights=sample_weight,
+                            minlength=len(cuts) + 3,
+                        )
+                        feature_bin_weights = feature_bin_weights.astype(
+                            np.float64, copy=False
+                        )
 
                     n_cuts = native.get_histogram_cut_count(X_col)
                     histogram_cuts = native.cut_uniform(X_col, n_cuts)
@@ -424,6 +480,32 @@ class EBMPreprocessor(BaseEstimator, TransformerMixin):
                 bins[feature_idx] = categories
             bin_weights[feature_idx] = feature_bin_weights
 
+            for is_rounded, pending in enumerate(pending_quantiles):
+                if _quantile_batch_features <= len(pending):
+                    _cut_quantiles(
+                        native,
+                        pending,
+                        is_rounded,
+                        max_bins,
+                        self.min_samples_bin,
+                        sample_weight,
+                        bins,
+                        bin_weights,
+                    )
+
+        for is_rounded, pending in enumerate(pending_quantiles):
+            if len(pending) != 0:
+                _cut_quantiles(
+                    native,
+                    pending,
+                    is_rounded,
+                    max_bins,
+                    self.min_samples_bin,
+                    sample_weight,
+                    bins,
+                    bin_weights,
+                )
+
         if is_privacy_bounds_warning:
             warn(
                 "Possible privacy violation: assuming min/max values per feature are public info. "
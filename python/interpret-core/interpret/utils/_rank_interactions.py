@@ -9,9 +9,9 @@ of the interaction of all pairs of features in a dataset.
 [1] https://www.cs.cornell.edu/~yinlou/papers/lou-kdd13.pdf
 """
 
-import heapq
+import numpy as np
 
-from ._native import InteractionDetector
+from ._native import InteractionDetector, Native
 
 
 def rank_interactions(
@@ -27,9 +27,23 @@ def rank_interactions(
     objective,
     experimental_params=None,
     n_output_interactions=0,
+    n_subsample_samples=0,
+    n_refined_interactions=0,
+    rng=None,
 ):
+    """Ranks the terms in iter_term_features by their FAST interaction strength.
+
+    If n_output_interactions, n_subsample_samples and n_refined_interactions are all positive and
+    there are more training samples than n_subsample_samples, every term is first scored on a
+    subsample of n_subsample_samples training samples drawn with rng, and only the
+    n_refined_interactions strongest are scored again on all the samples.
+    """
     try:
-        interaction_strengths = []
+        terms = [
+            feature_idxs
+            for feature_idxs in iter_term_features
+            if tuple(sorted(feature_idxs)) not in exclude
+        ]
         with InteractionDetector(
             dataset,
             bag,
@@ -38,24 +52,67 @@ def rank_interactions(
             objective,
             experimental_params,
         ) as interaction_detector:
-            for feature_idxs in iter_term_features:
-                if tuple(sorted(feature_idxs)) in exclude:
-                    continue
-                strength = interaction_detector.calc_interaction_strength(
-                    feature_idxs,
+            native = Native.get_native_singleton()
+            n_training_samples = (
+                native.extract_dataset_header(dataset)[0]
+                if bag is None
+                else int(np.count_nonzero(bag > 0))
+            )
+
+            # a single native call scores all the terms on the native thread pool and keeps
+            # only the strongest n_output_interactions if requested
+            if (
+                0 < n_output_interactions
+                and 0 < n_subsample_samples < n_training_samples
+                and 0 < n_refined_interactions
+            ):
+                subsample_bag = native.subsample_without_replacement(
+                    rng, dataset, bag, n_subsample_samples
+                )
+                # the init_scores of bag line up with subsample_bag because the training
+                # samples that were not chosen become validation samples
+                with InteractionDetector(
+                    dataset,
+                    subsample_bag,
+                    init_scores,
+                    create_interaction_flags,
+                    objective,
+                    experimental_params,
+                ) as subsample_detector:
+                    (
+                        term_idxs,
+                        strengths,
+                        _,
+                    ) = interaction_detector.calc_interaction_strengths_refined(
+                        subsample_detector,
+                        terms,
+                        calc_interaction_flags,
+                        max_cardinality,
+                        min_samples_leaf,
+                        max(n_refined_interactions, n_output_interactions),
+                        n_output_interactions,
+                    )
+            elif n_output_interactions <= 0:
+                strengths = interaction_detector.calc_interaction_strengths(
+                    terms,
+                    calc_interaction_flags,
+                    max_cardinality,
+                    min_samples_leaf,
+                )
+                term_idxs = range(len(terms))
+            else:
+                term_idxs, strengths = interaction_detector.calc_interaction_strengths(
+                    terms,
                     calc_interaction_flags,
                     max_cardinality,
                     min_samples_leaf,
+                    n_output_interactions,
                 )
-                item = (strength, feature_idxs)
-                if n_output_interactions <= 0:
-                    interaction_strengths.append(item)
-                else:
-                    if len(interaction_strengths) == n_output_interactions:
-                        heapq.heappushpop(interaction_strengths, item)
-                    else:
-                        heapq.heappush(interaction_strengths, item)
 
+        interaction_strengths = [
+            (float(strength), terms[term_idx])
+            for term_idx, strength in zip(term_idxs, strengths)
+        ]
         interaction_strengths.sort(reverse=True)
         return interaction_strengths
     except Exception as e:
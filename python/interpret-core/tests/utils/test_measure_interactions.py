@@ -1,6 +1,7 @@
 import pytest
 import numpy as np
 from math import isclose
+from itertools import combinations
 
 from sklearn.linear_model import LinearRegression, LogisticRegression
 from sklearn.dummy import DummyClassifier
@@ -11,6 +12,10 @@ from ..tutils import (
     synthetic_multiclass,
 )
 from interpret.utils import measure_interactions
+from interpret.utils._compressed_dataset import bin_native_by_dimension
+from interpret.utils._native import Native
+from interpret.utils._preprocessor import construct_bins
+from interpret.utils._rank_interactions import rank_interactions
 
 
 @pytest.fixture(scope="module")
@@ -251,6 +256,66 @@ def test_specific_results(regression_data):
     assert isclose(specific[(2, 0)], baseline[(0, 2)])
 
 
+def test_rank_interactions_refined(regression_data):
+    X, y = regression_data
+    y = np.asarray(y, dtype=np.float64)
+
+    binning_result = construct_bins(
+        X=X,
+        y=y,
+        sample_weight=None,
+        feature_names_given=None,
+        feature_types_given=None,
+        max_bins_leveled=[32],
+        binning="quantile",
+        min_samples_bin=1,
+        min_unique_continuous=0,
+    )
+    bins = binning_result[2]
+    dataset = bin_native_by_dimension(
+        n_classes=Native.Task_Regression,
+        n_dimensions=2,
+        bins=bins,
+        X=X,
+        y=y,
+        sample_weight=None,
+        feature_names_in=binning_result[0],
+        feature_types_in=binning_result[1],
+    )
+
+    def rank(n_subsample_samples, n_refined_interactions):
+        ranked = rank_interactions(
+            dataset=dataset,
+            bag=None,
+            init_scores=None,
+            iter_term_features=combinations(range(len(bins)), 2),
+            exclude=set(),
+            calc_interaction_flags=Native.CalcInteractionFlags_Default,
+            max_cardinality=1048576,
+            min_samples_leaf=2,
+            create_interaction_flags=Native.CreateInteractionFlags_Default,
+            objective="rmse",
+            n_output_interactions=3,
+            n_subsample_samples=n_subsample_samples,
+            n_refined_interactions=n_refined_interactions,
+            rng=Native.get_native_singleton().create_rng(42),
+        )
+        assert not isinstance(ranked, Exception)
+        return ranked
+
+    full = rank(0, 0)
+    assert 3 == len(full)
+
+    # refining all 6 pairs rescores every one of them on all the samples
+    refined = rank(len(y) // 2, 6)
+    assert [term for _, term in refined] == [term for _, term in full]
+    for (refined_strength, _), (full_strength, _) in zip(refined, full):
+        assert isclose(refined_strength, full_strength)
+
+    refined = rank(len(y) // 2, 4)
+    assert 3 == len(refined)
+
+
 def test_regression_task():
     from sklearn.datasets import load_diabetes
 
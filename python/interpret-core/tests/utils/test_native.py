@@ -49,6 +49,21 @@ def test_cut_winsorized():
     assert bin_counts[0] == 1
 
 
+def test_cut_quantiles():
+    np.random.seed(0)
+    X = np.random.random_sample((5, 200))
+    X[1] = np.round(X[1] * 10)
+    X[2, ::7] = np.nan
+
+    native = Native.get_native_singleton()
+
+    for is_rounded in (0, 1):
+        cuts_list = native.cut_quantiles(X, 3, is_rounded, 12)
+        assert len(cuts_list) == 5
+        for X_col, cuts in zip(X, cuts_list):
+            assert np.array_equal(cuts, native.cut_quantile(X_col, 3, is_rounded, 12))
+
+
 def test_suggest_graph_bound():
     native = Native.get_native_singleton()
     cuts = [25, 50, 75]
@@ -13,6 +13,7 @@
 #define ZONE_main
 #include "zones.h"
 
+#include "RandomDeterministic.hpp" // RandomDeterministic
 #include "Feature.hpp"
 #include "Term.hpp"
 #include "Transpose.hpp"
@@ -25,47 +26,19 @@ namespace DEFINED_ZONE_NAME {
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
-// we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before 
-// getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us
-// we only decrease the count if the count is non-zero, so at worst if there is a race condition then we'll output this log message more 
-// times than desired, but we can live with that
-static int g_cLogApplyTermUpdate = 10;
-
-EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
-   BoosterHandle boosterHandle,
-   double * avgValidationMetricOut
-) {
+// ApplyTermUpdateInternal applies the update that GenerateTermUpdateInternal left in the BoosterShell.  BoostRounds
+// calls it directly so that every round does not pay for the handle checks and logging of ApplyTermUpdate
+extern ErrorEbm ApplyTermUpdateInternal(BoosterShell * const pBoosterShell, double * const pValidationMetricAvgOut) {
    ErrorEbm error;
 
-   LOG_COUNTED_N(
-      &g_cLogApplyTermUpdate,
-      Trace_Info,
-      Trace_Verbose,
-      "ApplyTermUpdate: "
-      "boosterHandle=%p, "
-      "avgValidationMetricOut=%p"
-      ,
-      static_cast<void *>(boosterHandle),
-      static_cast<void *>(avgValidationMetricOut)
-   );
-
-   if(LIKELY(nullptr != avgValidationMetricOut)) {
-      // returning +inf means that boosting won't consider this to be an improvement.  After a few cycles
-      // it should exit with the last model that was good if the error was ignored (it shouldn't be ignored though)
-      *avgValidationMetricOut = std::numeric_limits<double>::infinity();
-   }
+   EBM_ASSERT(nullptr != pBoosterShell);
+   EBM_ASSERT(nullptr != pValidationMetricAvgOut);
 
-   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
-   if(nullptr == pBoosterShell) {
-      // already logged
-      return Error_IllegalParamVal;
-   }
+   // returning +inf means that boosting won't consider this to be an improvement
+   *pValidationMetricAvgOut = std::numeric_limits<double>::infinity();
 
    const size_t iTerm = pBoosterShell->GetTermIndex();
-   if(BoosterShell::k_illegalTermIndex == iTerm) {
-      LOG_0(Trace_Error, "ERROR ApplyTermUpdate bad internal state.  No Term index set");
-      return Error_IllegalParamVal;
-   }
+   EBM_ASSERT(BoosterShell::k_illegalTermIndex != iTerm);
 
    BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
    EBM_ASSERT(nullptr != pBoosterCore);
@@ -76,13 +49,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
 
    Term * const pTerm = pBoosterCore->GetTerms()[iTerm];
 
-   LOG_COUNTED_0(
-      pTerm->GetPointerCountLogEnterApplyTermUpdateMessages(),
-      Trace_Info,
-      Trace_Verbose,
-      "Entered ApplyTermUpdate"
-   );
-
    if(size_t { 0 } == pBoosterCore->GetCountScores()) {
       // if there is only 1 target class for classification, then we can predict the output with 100% accuracy.  
       // The term scores are a tensor with zero length array logits, which means for our representation that we 
@@ -141,6 +107,13 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
       "FloatScore must be either FloatBig or FloatSmall");
    size_t cFloatSize = sizeof(aUpdateScores[0]);
    bool bIgnored = false;
+
+   // the quantized subsets round their new gradients as soon as they are written, since their floating point 
+   // gradients live in scratch memory that the next quantized subset overwrites
+   RandomDeterministic rngQuantize;
+   if(EBM_FALSE != pBoosterCore->IsQuantizeGradients()) {
+      pBoosterCore->InitializeQuantizeRng(&rngQuantize);
+   }
    while(true) {
       if(0 != pBoosterCore->GetTrainingSet()->GetCountSamples()) {
          EBM_ASSERT(1 <= pBoosterCore->GetTrainingSet()->GetCountSubsets());
@@ -163,6 +136,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
                data.m_cSamples = pSubset->GetCountSamples();
                data.m_aPacked = pSubset->GetTermData(iTerm);
                data.m_aTargets = pSubset->GetTargetData();
+               data.m_iTargetConst = pSubset->GetTargetConst();
                data.m_aWeights = nullptr;
                data.m_aSampleScores = pSubset->GetSampleScores();
                data.m_aGradientsAndHessians = pSubset->GetGradHess();
@@ -170,6 +144,9 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
                if(Error_None != error) {
                   return error;
                }
+               if(nullptr != pSubset->GetQuantizedGradHess()) {
+                  pSubset->QuantizeGradHess(&rngQuantize, pBoosterCore->IsHessian(), pBoosterCore->GetCountScores());
+               }
             }
             ++pSubset;
          } while(pSubsetsEnd != pSubset);
@@ -209,6 +186,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
                data.m_cSamples = pSubset->GetCountSamples();
                data.m_aPacked = pSubset->GetTermData(iTerm);
                data.m_aTargets = pSubset->GetTargetData();
+               data.m_iTargetConst = pSubset->GetTargetConst();
                data.m_aWeights = pSubset->GetInnerBag(0)->GetWeights();
                data.m_aSampleScores = pSubset->GetSampleScores();
                data.m_aGradientsAndHessians = pSubset->GetGradHess();
@@ -304,6 +282,71 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
       }
    }
    
+   *pValidationMetricAvgOut = validationMetricAvg;
+   return Error_None;
+}
+
+// we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before 
+// getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us
+// we only decrease the count if the count is non-zero, so at worst if there is a race condition then we'll output this log message more 
+// times than desired, but we can live with that
+static int g_cLogApplyTermUpdate = 10;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
+   BoosterHandle boosterHandle,
+   double * avgValidationMetricOut
+) {
+   ErrorEbm error;
+
+   LOG_COUNTED_N(
+      &g_cLogApplyTermUpdate,
+      Trace_Info,
+      Trace_Verbose,
+      "ApplyTermUpdate: "
+      "boosterHandle=%p, "
+      "avgValidationMetricOut=%p"
+      ,
+      static_cast<void *>(boosterHandle),
+      static_cast<void *>(avgValidationMetricOut)
+   );
+
+   if(LIKELY(nullptr != avgValidationMetricOut)) {
+      // returning +inf means that boosting won't consider this to be an improvement.  After a few cycles
+      // it should exit with the last model that was good if the error was ignored (it shouldn't be ignored though)
+      *avgValidationMetricOut = std::numeric_limits<double>::infinity();
+   }
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   const size_t iTerm = pBoosterShell->GetTermIndex();
+   if(BoosterShell::k_illegalTermIndex == iTerm) {
+      LOG_0(Trace_Error, "ERROR ApplyTermUpdate bad internal state.  No Term index set");
+      return Error_IllegalParamVal;
+   }
+
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+   EBM_ASSERT(nullptr != pBoosterCore);
+   EBM_ASSERT(iTerm < pBoosterCore->GetCountTerms());
+   EBM_ASSERT(nullptr != pBoosterCore->GetTerms());
+   Term * const pTerm = pBoosterCore->GetTerms()[iTerm];
+
+   LOG_COUNTED_0(
+      pTerm->GetPointerCountLogEnterApplyTermUpdateMessages(),
+      Trace_Info,
+      Trace_Verbose,
+      "Entered ApplyTermUpdate"
+   );
+
+   double validationMetricAvg;
+   error = ApplyTermUpdateInternal(pBoosterShell, &validationMetricAvg);
+   if(Error_None != error) {
+      return error;
+   }
+
    if(nullptr != avgValidationMetricOut) {
       *avgValidationMetricOut = validationMetricAvg;
    }
@@ -0,0 +1,299 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "pch.hpp"
+
+#include <stdlib.h> // malloc, free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <algorithm> // std::push_heap, std::pop_heap
+
+#include "libebm.h" // ErrorEbm
+#include "logging.h" // EBM_ASSERT
+
+#define ZONE_main
+#include "zones.h"
+
+#include "common.hpp" // IsConvertError
+
+#include "RandomDeterministic.hpp"
+#include "BoosterCore.hpp"
+#include "BoosterShell.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+extern ErrorEbm GenerateTermUpdateInternal(
+   RandomDeterministic * pRng,
+   BoosterShell * const pBoosterShell,
+   const size_t iTerm,
+   const TermBoostFlags flags,
+   const double learningRate,
+   const size_t cSamplesLeafMin,
+   const IntEbm * const leavesMax,
+   double * const pGainAvgOut
+);
+
+extern ErrorEbm ApplyTermUpdateInternal(BoosterShell * const pBoosterShell, double * const pValidationMetricAvgOut);
+
+struct TermGain final {
+   double m_gain;
+   size_t m_iTerm;
+};
+static_assert(std::is_standard_layout<TermGain>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<TermGain>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+// The greedy rounds pick the term with the highest gain, and break ties by picking the lowest term index.
+// std::push_heap and std::pop_heap keep the largest element at the front, so "less" means lower priority.
+static bool IsLowerPriority(const TermGain & lhs, const TermGain & rhs) {
+   if(lhs.m_gain != rhs.m_gain) {
+      return lhs.m_gain < rhs.m_gain;
+   }
+   return rhs.m_iTerm < lhs.m_iTerm;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION BoostRounds(
+   void * rng,
+   BoosterHandle boosterHandle,
+   TermBoostFlags flags,
+   double learningRate,
+   IntEbm minSamplesLeaf,
+   IntEbm maxLeaves,
+   double greediness,
+   IntEbm smoothingRounds,
+   IntEbm maxRounds,
+   IntEbm earlyStoppingRounds,
+   double earlyStoppingTolerance,
+   BoostRoundsCallbackFunction callback,
+   void * callbackContext,
+   IntEbm * countRoundsOut,
+   double * bestMetricOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered BoostRounds: "
+      "rng=%p, "
+      "boosterHandle=%p, "
+      "flags=0x%" UTermBoostFlagsPrintf ", "
+      "learningRate=%le, "
+      "minSamplesLeaf=%" IntEbmPrintf ", "
+      "maxLeaves=%" IntEbmPrintf ", "
+      "greediness=%le, "
+      "smoothingRounds=%" IntEbmPrintf ", "
+      "maxRounds=%" IntEbmPrintf ", "
+      "earlyStoppingRounds=%" IntEbmPrintf ", "
+      "earlyStoppingTolerance=%le, "
+      "callback=%p, "
+      "callbackContext=%p, "
+      "countRoundsOut=%p, "
+      "bestMetricOut=%p"
+      ,
+      rng,
+      static_cast<void *>(boosterHandle),
+      static_cast<UTermBoostFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      learningRate,
+      minSamplesLeaf,
+      maxLeaves,
+      greediness,
+      smoothingRounds,
+      maxRounds,
+      earlyStoppingRounds,
+      earlyStoppingTolerance,
+      reinterpret_cast<void *>(callback),
+      callbackContext,
+      static_cast<void *>(countRoundsOut),
+      static_cast<void *>(bestMetricOut)
+   );
+
+   ErrorEbm error;
+
+   if(LIKELY(nullptr != countRoundsOut)) {
+      *countRoundsOut = IntEbm { 0 };
+   }
+   if(LIKELY(nullptr != bestMetricOut)) {
+      *bestMetricOut = std::numeric_limits<double>::infinity();
+   }
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   if(maxRounds < IntEbm { 0 }) {
+      LOG_0(Trace_Error, "ERROR BoostRounds maxRounds cannot be negative");
+      return Error_IllegalParamVal;
+   }
+   if(std::isnan(greediness)) {
+      LOG_0(Trace_Error, "ERROR BoostRounds greediness cannot be NaN");
+      return Error_IllegalParamVal;
+   }
+   if(std::isnan(earlyStoppingTolerance)) {
+      LOG_0(Trace_Error, "ERROR BoostRounds earlyStoppingTolerance cannot be NaN");
+      return Error_IllegalParamVal;
+   }
+
+   if(0 != (static_cast<UTermBoostFlags>(flags) & static_cast<UTermBoostFlags>(~(
+      static_cast<UTermBoostFlags>(TermBoostFlags_DisableNewtonGain) |
+      static_cast<UTermBoostFlags>(TermBoostFlags_DisableNewtonUpdate) |
+      static_cast<UTermBoostFlags>(TermBoostFlags_GradientSums) |
+      static_cast<UTermBoostFlags>(TermBoostFlags_RandomSplits)
+   )))) {
+      LOG_0(Trace_Error, "ERROR BoostRounds flags contains unknown flags. Ignoring extras.");
+   }
+
+   size_t cSamplesLeafMin = size_t { 1 }; // this is the min value
+   if(IntEbm { 1 } <= minSamplesLeaf) {
+      cSamplesLeafMin = static_cast<size_t>(minSamplesLeaf);
+      if(IsConvertError<size_t>(minSamplesLeaf)) {
+         cSamplesLeafMin = std::numeric_limits<size_t>::max();
+      }
+   } else {
+      LOG_0(Trace_Warning, "WARNING BoostRounds minSamplesLeaf can't be less than 1.  Adjusting to 1.");
+   }
+
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+   const size_t cTerms = pBoosterCore->GetCountTerms();
+
+   // the handle and arguments were checked once above, so each round calls the internal boosting routines
+   // directly.  GenerateTermUpdateInternal expects no pending update
+   pBoosterShell->SetTermIndex(BoosterShell::k_illegalTermIndex);
+
+   // GenerateTermUpdate only reads the leaves for the dimensions of the term it is boosting
+   IntEbm aLeavesMax[k_cDimensionsMax];
+   for(size_t iDimension = 0; iDimension < k_cDimensionsMax; ++iDimension) {
+      aLeavesMax[iDimension] = maxLeaves;
+   }
+
+   TermGain * aHeap = nullptr;
+   if(size_t { 0 } != cTerms) {
+      if(IsMultiplyError(sizeof(TermGain), cTerms)) {
+         LOG_0(Trace_Warning, "WARNING BoostRounds IsMultiplyError(sizeof(TermGain), cTerms)");
+         return Error_OutOfMemory;
+      }
+      aHeap = static_cast<TermGain *>(malloc(sizeof(TermGain) * cTerms));
+      if(nullptr == aHeap) {
+         LOG_0(Trace_Warning, "WARNING BoostRounds nullptr == aHeap");
+         return Error_OutOfMemory;
+      }
+   }
+   TermGain * pHeapEnd = aHeap;
+
+   // the first round is always cyclic since we need to get the initial gains
+   double greedyPortion = 0.0;
+
+   double metricMin = std::numeric_limits<double>::infinity();
+   double metricBreakpoint = std::numeric_limits<double>::infinity();
+   IntEbm cNoChangeRun = 0;
+   IntEbm cSmoothingRoundsRemaining = smoothingRounds;
+
+   IntEbm cRounds = 0;
+   while(cRounds < maxRounds) {
+      if(greedyPortion < 1.0) {
+         // cyclic round, so every term gets boosted once and its gain goes back into the heap
+         pHeapEnd = aHeap;
+      }
+
+      TermBoostFlags flagsRound = flags;
+      if(IntEbm { 0 } < cSmoothingRoundsRemaining) {
+         flagsRound = static_cast<TermBoostFlags>(static_cast<UTermBoostFlags>(flagsRound) |
+            static_cast<UTermBoostFlags>(TermBoostFlags_DisableNewtonGain) |
+            static_cast<UTermBoostFlags>(TermBoostFlags_DisableNewtonUpdate) |
+            static_cast<UTermBoostFlags>(TermBoostFlags_RandomSplits));
+      }
+
+      for(size_t iTermCyclic = 0; iTermCyclic < cTerms; ++iTermCyclic) {
+         size_t iTerm = iTermCyclic;
+         if(1.0 <= greedyPortion) {
+            EBM_ASSERT(aHeap != pHeapEnd);
+            std::pop_heap(aHeap, pHeapEnd, IsLowerPriority);
+            --pHeapEnd;
+            iTerm = pHeapEnd->m_iTerm;
+         }
+
+         double gainAvg;
+         error = GenerateTermUpdateInternal(
+            reinterpret_cast<RandomDeterministic *>(rng),
+            pBoosterShell,
+            iTerm,
+            flagsRound,
+            learningRate,
+            cSamplesLeafMin,
+            aLeavesMax,
+            &gainAvg
+         );
+         if(Error_None != error) {
+            free(aHeap);
+            return error;
+         }
+
+         pHeapEnd->m_gain = gainAvg;
+         pHeapEnd->m_iTerm = iTerm;
+         ++pHeapEnd;
+         std::push_heap(aHeap, pHeapEnd, IsLowerPriority);
+
+         double metric;
+         error = ApplyTermUpdateInternal(pBoosterShell, &metric);
+         if(Error_None != error) {
+            free(aHeap);
+            return error;
+         }
+         metricMin = EbmMin(metricMin, metric);
+      }
+      ++cRounds;
+
+      // TODO: like the python version this was ported from, the tolerance only re-triggers if the threshold
+      //       is re-passed instead of being based on a smooth window of the last earlyStoppingRounds metrics
+      if(IntEbm { 0 } == cNoChangeRun) {
+         metricBreakpoint = metricMin;
+      }
+      if(metricMin + earlyStoppingTolerance < metricBreakpoint) {
+         cNoChangeRun = 0;
+      } else {
+         ++cNoChangeRun;
+      }
+
+      if(1.0 <= greedyPortion) {
+         greedyPortion -= 1.0;
+      }
+
+      if(IntEbm { 0 } < cSmoothingRoundsRemaining) {
+         // the cuts are chosen randomly during the smoothing rounds, which leads to high variance in the
+         // validation metric, so do not make early stopping progress during them
+         cNoChangeRun = 0;
+         --cSmoothingRoundsRemaining;
+      } else {
+         // do not progress into greedy rounds until we are done with the smoothing rounds
+         greedyPortion += greediness;
+      }
+
+      if(IntEbm { 0 } < earlyStoppingRounds && earlyStoppingRounds <= cNoChangeRun) {
+         break;
+      }
+
+      if(nullptr != callback) {
+         if(EBM_FALSE != (*callback)(callbackContext, cRounds - IntEbm { 1 }, metricMin)) {
+            LOG_0(Trace_Info, "INFO BoostRounds callback requested that boosting stop");
+            break;
+         }
+      }
+   }
+
+   free(aHeap);
+
+   if(LIKELY(nullptr != countRoundsOut)) {
+      *countRoundsOut = cRounds;
+   }
+   if(LIKELY(nullptr != bestMetricOut)) {
+      *bestMetricOut = metricMin;
+   }
+
+   LOG_N(Trace_Info, "Exited BoostRounds: cRounds=%" IntEbmPrintf ", metricMin=%le", cRounds, metricMin);
+   return Error_None;
+}
+
+} // DEFINED_ZONE_NAME
@@ -7,7 +7,6 @@
 #include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // numeric_limits
-#include <thread>
 
 #include "logging.h" // EBM_ASSERT
 
@@ -18,6 +17,8 @@
 #include "Bin.hpp" // IsOverflowBinSize
 
 #include "ebm_internal.hpp"
+#include "RandomDeterministic.hpp" // RandomDeterministic
+#include "RandomNondeterministic.hpp" // RandomNondeterministic
 #include "dataset_shared.hpp" // GetDataSetSharedHeader
 #include "Tensor.hpp" // Tensor
 #include "Feature.hpp" // Feature
@@ -25,6 +26,7 @@
 #include "InnerBag.hpp" // InnerBag
 #include "TreeNode.hpp" // IsOverflowTreeNodeSize
 #include "SplitPosition.hpp" // IsOverflowSplitPositionSize
+#include "ThreadPool.hpp" // ThreadPool
 #include "BoosterCore.hpp"
 
 namespace DEFINED_ZONE_NAME {
@@ -34,6 +36,14 @@ namespace DEFINED_ZONE_NAME {
 
 class RandomDeterministic;
 
+// below this many training samples per subset it isn't worth binning the subsets in separate slots
+static constexpr size_t k_cSlotSamplesMin = 16384;
+// each slot adds a few passes over the tensor bins to every boosting step, so a slot also needs this many samples per
+// tensor bin of the largest term to keep those passes small next to the binning itself
+static constexpr size_t k_cSlotSamplesPerTensorBin = 32;
+// the largest SIMD pack we support is 64 items wide
+static constexpr size_t k_cSubsetSamplesAlign = 64;
+
 extern ErrorEbm Unbag(
    const size_t cSamples,
    const BagEbm * const aBag,
@@ -45,6 +55,8 @@ extern ErrorEbm GetObjective(
    const Config * const pConfig,
    const char * sObjective,
    const AccelerationFlags acceleration,
+   const bool bDoublePrecision,
+   const bool bFloat32,
    ObjectiveWrapper * const pCpuObjectiveWrapperOut,
    ObjectiveWrapper * const pSIMDObjectiveWrapperOut
 ) noexcept;
@@ -267,11 +279,6 @@ static bool CheckBoosterRestrictions(
    }
 }
 
-//static int g_TODO_removeThisThreadTest = 0;
-//void TODO_removeThisThreadTest() {
-//   g_TODO_removeThisThreadTest = 1;
-//}
-
 ErrorEbm BoosterCore::Create(
    void * const rng,
    const size_t cTerms,
@@ -299,25 +306,6 @@ ErrorEbm BoosterCore::Create(
 
    ErrorEbm error;
 
-   //try {
-   //   // TODO: eliminate this code I added to test that threads are available on the majority of our systems
-   //   std::thread testThread(TODO_removeThisThreadTest);
-   //   testThread.join();
-   //   if(0 == g_TODO_removeThisThreadTest) {
-   //      LOG_0(Trace_Warning, "WARNING BoosterCore::Create thread not started");
-   //      return Error_UnexpectedInternal;
-   //   }
-   //} catch(const std::bad_alloc &) {
-   //   LOG_0(Trace_Warning, "WARNING BoosterCore::Create thread start out of memory");
-   //   return Error_OutOfMemory;
-   //} catch(...) {
-   //   // the C++ standard doesn't really seem to say what kind of exceptions we'd get for various errors, so
-   //   // about the best we can do is catch(...) since the exact exceptions seem to be implementation specific
-   //   LOG_0(Trace_Warning, "WARNING BoosterCore::Create thread start failed");
-   //   return Error_ThreadStartFailed;
-   //}
-   //LOG_0(Trace_Info, "INFO BoosterCore::Create thread started");
-
    BoosterCore * pBoosterCore;
    try {
       pBoosterCore = new BoosterCore();
@@ -338,6 +326,9 @@ ErrorEbm BoosterCore::Create(
 
    pBoosterCore->m_bDisableApprox = 0 != (CreateBoosterFlags_DisableApprox & flags) ? EBM_TRUE : EBM_FALSE;
 
+   // capture the thread count at creation since the BoosterShell sizes its ThreadPool and scratch memory from it
+   pBoosterCore->m_cThreads = ThreadPool::GetCountThreadsConfig();
+
    UIntShared countSamples;
    size_t cFeatures;
    size_t cWeights;
@@ -362,6 +353,16 @@ ErrorEbm BoosterCore::Create(
       LOG_0(Trace_Warning, "WARNING BoosterCore::Create size_t { 1 } < cWeights");
       return Error_IllegalParamVal;
    }
+   pBoosterCore->m_bWeighted = size_t { 0 } != cWeights ? EBM_TRUE : EBM_FALSE;
+   if(0 != ((CreateBoosterFlags_QuantizeGradients | CreateBoosterFlags_QuantizeGradientsInt8) & flags)) {
+      if(size_t { 0 } != cWeights) {
+         // the quantized bin sums are integers, which only works when the bag weights are integer occurrence counts
+         LOG_0(Trace_Warning, "WARNING BoosterCore::Create CreateBoosterFlags_QuantizeGradients ignored for weighted datasets");
+      } else {
+         pBoosterCore->m_cQuantizedBytes = 0 != (CreateBoosterFlags_QuantizeGradientsInt8 & flags) ? 
+            static_cast<int>(sizeof(int8_t)) : static_cast<int>(sizeof(int16_t));
+      }
+   }
    if(size_t { 1 } != cTargets) {
       LOG_0(Trace_Warning, "WARNING BoosterCore::Create 1 != cTargets");
       return Error_IllegalParamVal;
@@ -402,7 +403,6 @@ ErrorEbm BoosterCore::Create(
             &defaultValSparse,
             &cNonDefaultsSparse
          );
-         EBM_ASSERT(!bSparse); // we do not handle yet
          if(IsConvertError<size_t>(countBins)) {
             LOG_0(Trace_Error, "ERROR BoosterCore::Create IsConvertError<size_t>(countBins)");
             return Error_IllegalParamVal;
@@ -621,6 +621,10 @@ ErrorEbm BoosterCore::Create(
          &config,
          sObjective, 
          acceleration,
+         // with approximations disabled the caller wants double results, so stay out of the float32 zones unless
+         // float32 was asked for explicitly
+         0 != (CreateBoosterFlags_DisableApprox & flags) && 0 == (CreateBoosterFlags_Float32 & flags),
+         0 != (CreateBoosterFlags_Float32 & flags),
          &pBoosterCore->m_objectiveCpu,
          &pBoosterCore->m_objectiveSIMD
       );
@@ -677,8 +681,51 @@ ErrorEbm BoosterCore::Create(
                sizeof(UIntSmall) == pBoosterCore->m_objectiveSIMD.m_cUIntBytes ||
                sizeof(FloatSmall) == pBoosterCore->m_objectiveSIMD.m_cFloatBytes;
 
+            size_t cTrainingSubsetSamplesMax = bForceMultipleSubsets ? k_cSubsetSamplesMax : SIZE_MAX;
+            const size_t cSlotSamplesMin = IsMultiplyError(k_cSlotSamplesPerTensorBin, cTensorBinsMax) ? SIZE_MAX :
+               EbmMax(k_cSlotSamplesMin, k_cSlotSamplesPerTensorBin * cTensorBinsMax);
+            const size_t cSlotsUseful = EbmMin(k_cBinSumsSlotsMax, cTrainingSamples / cSlotSamplesMin);
+            if(size_t { 2 } <= cSlotsUseful) {
+               // GenerateTermUpdate bins equal contiguous ranges of training subsets in separate slots, which the
+               // threads pick up. The split depends only on the samples and the terms so that the summation order,
+               // and so the model, is the same for any thread count, including the default of 1
+               size_t cSubsets = (cTrainingSamples - 1) / cTrainingSubsetSamplesMax + 1;
+               cSubsets = EbmMax(cSubsets, cSlotsUseful);
+               cTrainingSubsetSamplesMax = (cTrainingSamples - 1) / cSubsets + 1;
+               // round up to a multiple of every SIMD pack size so that the SIMD subsets do not leave remainders
+               cTrainingSubsetSamplesMax = (cTrainingSubsetSamplesMax + (k_cSubsetSamplesAlign - 1)) & 
+                  ~(k_cSubsetSamplesAlign - 1);
+               EBM_ASSERT(!bForceMultipleSubsets || cTrainingSubsetSamplesMax <= k_cSubsetSamplesMax);
+            }
+
             const bool bHessian = pBoosterCore->IsHessian();
 
+            // the data subsets are built from a copy of the dataset sorted by class.  Nothing after construction
+            // depends on the original sample order, so the copy and its permutation are discarded once built
+            unsigned char * pDataSetSorted = nullptr;
+            BagEbm * aBagSorted = nullptr;
+            double * aInitScoresSorted = nullptr;
+            if(0 != (CreateBoosterFlags_TargetSorted & flags) && !pBoosterCore->IsRmse()) {
+               size_t * aiOriginal;
+               error = SortDataSetByTarget(pDataSetShared, aBag, &pDataSetSorted, &aBagSorted, &aiOriginal);
+               if(Error_None != error) {
+                  return error;
+               }
+               if(nullptr != aiOriginal) {
+                  error = SortInitScores(cSamples, aiOriginal, cScores, aInitScores, &aInitScoresSorted);
+                  free(aiOriginal);
+                  if(Error_None != error) {
+                     free(aBagSorted);
+                     free(pDataSetSorted);
+                     return error;
+                  }
+               }
+            }
+            const bool bTargetSorted = nullptr != pDataSetSorted;
+            const unsigned char * const pDataSetInit = bTargetSorted ? pDataSetSorted : pDataSetShared;
+            const BagEbm * const aBagInit = bTargetSorted ? aBagSorted : aBag;
+            const double * const aInitScoresInit = bTargetSorted ? aInitScoresSorted : aInitScores;
+
             pBoosterCore->m_cInnerBags = cInnerBags; // this is used to destruct m_trainingSet, so store it first
             error = pBoosterCore->m_trainingSet.InitDataSetBoosting(
                true,
@@ -687,49 +734,84 @@ ErrorEbm BoosterCore::Create(
                !pBoosterCore->IsRmse(),
                rng,
                cScores,
-               bForceMultipleSubsets ? k_cSubsetSamplesMax : SIZE_MAX,
+               cTrainingSubsetSamplesMax,
                &pBoosterCore->m_objectiveCpu,
                &pBoosterCore->m_objectiveSIMD,
-               pDataSetShared,
+               pDataSetInit,
                BagEbm { 1 },
                cSamples,
-               aBag,
-               aInitScores,
+               aBagInit,
+               aInitScoresInit,
                cTrainingSamples,
                cInnerBags,
                cWeights,
                cTerms,
                pBoosterCore->m_apTerms,
-               aiTermFeatures
+               aiTermFeatures,
+               bTargetSorted
             );
+            if(Error_None == error) {
+               error = pBoosterCore->m_validationSet.InitDataSetBoosting(
+                  pBoosterCore->IsRmse(),
+                  false,
+                  !pBoosterCore->IsRmse(),
+                  !pBoosterCore->IsRmse(),
+                  rng,
+                  cScores,
+                  bForceMultipleSubsets ? k_cSubsetSamplesMax : SIZE_MAX,
+                  &pBoosterCore->m_objectiveCpu,
+                  &pBoosterCore->m_objectiveSIMD,
+                  pDataSetInit,
+                  BagEbm { -1 },
+                  cSamples,
+                  aBagInit,
+                  aInitScoresInit,
+                  cValidationSamples,
+                  0,
+                  cWeights,
+                  cTerms,
+                  pBoosterCore->m_apTerms,
+                  aiTermFeatures,
+                  bTargetSorted
+               );
+            }
+            free(aInitScoresSorted);
+            free(aBagSorted);
+            free(pDataSetSorted);
             if(Error_None != error) {
                return error;
             }
 
-            error = pBoosterCore->m_validationSet.InitDataSetBoosting(
-               pBoosterCore->IsRmse(),
-               false,
-               !pBoosterCore->IsRmse(),
-               !pBoosterCore->IsRmse(),
-               rng,
-               cScores,
-               bForceMultipleSubsets ? k_cSubsetSamplesMax : SIZE_MAX,
-               &pBoosterCore->m_objectiveCpu,
-               &pBoosterCore->m_objectiveSIMD,
-               pDataSetShared,
-               BagEbm { -1 },
-               cSamples,
-               aBag,
-               aInitScores,
-               cValidationSamples,
-               0,
-               cWeights,
-               cTerms,
-               pBoosterCore->m_apTerms,
-               aiTermFeatures
-            );
-            if(Error_None != error) {
-               return error;
+            if(0 != pBoosterCore->m_cQuantizedBytes && pBoosterCore->IsRmse()) {
+               // RMSE updates its gradients in place since they are the residuals, so they cannot be rounded
+               LOG_0(Trace_Warning, "WARNING BoosterCore::Create CreateBoosterFlags_QuantizeGradients ignored for RMSE");
+               pBoosterCore->m_cQuantizedBytes = 0;
+            }
+            if(0 != pBoosterCore->m_cQuantizedBytes && 0 != cTrainingSamples) {
+               error = pBoosterCore->m_trainingSet.InitQuantizedGradHess(bHessian, cScores, cInnerBags, 
+                  pBoosterCore->m_cQuantizedBytes);
+               if(Error_None != error) {
+                  return error;
+               }
+
+               // InitDataSetBoosting has moved rng past the inner bags, so copying it here does not correlate
+               // the rounding with the bags, and leaves the caller's rng where it would be without quantization
+               if(nullptr == rng) {
+                  try {
+                     RandomNondeterministic<uint64_t> randomGenerator;
+                     pBoosterCore->m_seedQuantize = randomGenerator.Next(std::numeric_limits<uint64_t>::max());
+                  } catch(const std::bad_alloc &) {
+                     LOG_0(Trace_Warning, "WARNING BoosterCore::Create Out of memory in std::random_device");
+                     return Error_OutOfMemory;
+                  } catch(...) {
+                     LOG_0(Trace_Warning, "WARNING BoosterCore::Create Unknown error in std::random_device");
+                     return Error_UnexpectedInternal;
+                  }
+               } else {
+                  RandomDeterministic cpuRng;
+                  cpuRng.Initialize(*reinterpret_cast<const RandomDeterministic *>(rng));
+                  pBoosterCore->m_seedQuantize = cpuRng.Next<uint64_t>();
+               }
             }
 
             size_t cBytesPerFastBinMax = 0;
@@ -861,6 +943,15 @@ ErrorEbm BoosterCore::Create(
    return Error_None;
 }
 
+void BoosterCore::InitializeQuantizeRng(RandomDeterministic * const pRng) {
+   EBM_ASSERT(nullptr != pRng);
+   EBM_ASSERT(0 != m_cQuantizedBytes);
+
+   // the rounding noise is deterministic given the seed, but differs between boosting steps
+   pRng->Initialize(m_seedQuantize);
+   m_seedQuantize = pRng->Next<uint64_t>();
+}
+
 ErrorEbm BoosterCore::InitializeBoosterGradientsAndHessians(
    void * const aMulticlassMidwayTemp,
    FloatScore * const aUpdateScores
@@ -882,6 +973,11 @@ ErrorEbm BoosterCore::InitializeBoosterGradientsAndHessians(
       EBM_ASSERT(nullptr != pSubset);
       EBM_ASSERT(1 <= pDataSet->GetCountSubsets());
       const DataSubsetBoosting * const pSubsetsEnd = pSubset + pDataSet->GetCountSubsets();
+
+      RandomDeterministic rngQuantize;
+      if(0 != m_cQuantizedBytes) {
+         InitializeQuantizeRng(&rngQuantize);
+      }
       do {
          EBM_ASSERT(1 <= pSubset->GetCountSamples());
 
@@ -900,6 +996,7 @@ ErrorEbm BoosterCore::InitializeBoosterGradientsAndHessians(
          data.m_cSamples = pSubset->GetCountSamples();
          data.m_aPacked = nullptr;
          data.m_aTargets = pSubset->GetTargetData();
+         data.m_iTargetConst = pSubset->GetTargetConst();
          data.m_aWeights = nullptr;
          data.m_aSampleScores = pSubset->GetSampleScores();
          data.m_aGradientsAndHessians = pSubset->GetGradHess();
@@ -907,6 +1004,9 @@ ErrorEbm BoosterCore::InitializeBoosterGradientsAndHessians(
          if(Error_None != error) {
             return error;
          }
+         if(nullptr != pSubset->GetQuantizedGradHess()) {
+            pSubset->QuantizeGradHess(&rngQuantize, IsHessian(), cScores);
+         }
 
          ++pSubset;
       } while(pSubsetsEnd != pSubset);
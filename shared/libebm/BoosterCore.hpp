@@ -40,6 +40,9 @@ class BoosterCore final {
 
    size_t m_cScores;
    BoolEbm m_bDisableApprox;
+   BoolEbm m_bWeighted;
+   int m_cQuantizedBytes;
+   uint64_t m_seedQuantize;
 
    size_t m_cFeatures;
    FeatureBoosting * m_aFeatures;
@@ -49,6 +52,8 @@ class BoosterCore final {
 
    size_t m_cInnerBags;
 
+   size_t m_cThreads;
+
    Tensor ** m_apCurrentTermTensors;
    Tensor ** m_apBestTermTensors;
 
@@ -81,11 +86,15 @@ class BoosterCore final {
       m_REFERENCE_COUNT(1), // we're not visible on any other thread yet, so no synchronization required
       m_cScores(0),
       m_bDisableApprox(EBM_FALSE),
+      m_bWeighted(EBM_FALSE),
+      m_cQuantizedBytes(0),
+      m_seedQuantize(0),
       m_cFeatures(0),
       m_aFeatures(nullptr),
       m_cTerms(0),
       m_apTerms(nullptr),
       m_cInnerBags(0),
+      m_cThreads(1),
       m_apCurrentTermTensors(nullptr),
       m_apBestTermTensors(nullptr),
       m_bestModelMetric(std::numeric_limits<double>::infinity()),
@@ -113,6 +122,10 @@ public:
       return m_cScores;
    }
 
+   inline size_t GetCountThreads() const {
+      return m_cThreads;
+   }
+
    inline size_t GetCountBytesFastBins() const {
       return m_cBytesFastBins;
    }
@@ -129,6 +142,14 @@ public:
       return m_cBytesTreeNodes;
    }
 
+   inline size_t GetCountFeatures() const {
+      return m_cFeatures;
+   }
+
+   inline const FeatureBoosting * GetFeatures() const {
+      return m_aFeatures;
+   }
+
    inline size_t GetCountTerms() const {
       return m_cTerms;
    }
@@ -188,6 +209,10 @@ public:
       FloatScore * const aUpdateScores
    );
 
+   // the training subsets quantize their gradients with pRng right after each ObjectiveApplyUpdate.  Each call
+   // starts a new rounding stream, so call it once per boosting step when IsQuantizeGradients()
+   void InitializeQuantizeRng(RandomDeterministic * const pRng);
+
    inline double FinishMetric(const double metricSum) {
       EBM_ASSERT(nullptr != m_objectiveCpu.m_pObjective);
       return FinishMetricC(&m_objectiveCpu, metricSum);
@@ -213,6 +238,22 @@ public:
       return m_bDisableApprox;
    }
 
+   inline BoolEbm IsWeighted() const {
+      return m_bWeighted;
+   }
+
+   inline BoolEbm IsQuantizeGradients() const {
+      return 0 != m_cQuantizedBytes ? EBM_TRUE : EBM_FALSE;
+   }
+
+   inline const ObjectiveWrapper * GetObjectiveCpu() const {
+      return &m_objectiveCpu;
+   }
+
+   inline const ObjectiveWrapper * GetObjectiveSIMD() const {
+      return &m_objectiveSIMD;
+   }
+
    inline double LearningRateAdjustmentDifferentialPrivacy() const noexcept {
       EBM_ASSERT(nullptr != m_objectiveCpu.m_pObjective);
       return m_objectiveCpu.m_learningRateAdjustmentDifferentialPrivacy;
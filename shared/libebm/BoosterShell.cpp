@@ -18,6 +18,7 @@
 #include "Transpose.hpp"
 #include "Tensor.hpp" // Tensor
 
+#include "ThreadPool.hpp" // ThreadPool
 #include "BoosterCore.hpp" // BoosterCore
 #include "BoosterShell.hpp"
 
@@ -42,6 +43,23 @@ void BoosterShell::Free(BoosterShell * const pBoosterShell) {
    if(nullptr != pBoosterShell) {
       Tensor::Free(pBoosterShell->m_pTermUpdate);
       Tensor::Free(pBoosterShell->m_pInnerTermUpdate);
+      ThreadPool::Free(pBoosterShell->m_pThreadPool);
+      if(nullptr != pBoosterShell->m_apWorkerShells) {
+         EBM_ASSERT(2 <= pBoosterShell->m_cBagWorkers);
+         for(size_t iWorker = 0; iWorker < pBoosterShell->m_cBagWorkers - 1; ++iWorker) {
+            BoosterShell::Free(pBoosterShell->m_apWorkerShells[iWorker]);
+         }
+         free(pBoosterShell->m_apWorkerShells);
+      }
+      if(nullptr != pBoosterShell->m_apBagTermUpdates) {
+         const size_t cInnerBags = pBoosterShell->m_pBoosterCore->GetCountInnerBags();
+         for(size_t iBag = 0; iBag < cInnerBags; ++iBag) {
+            Tensor::Free(pBoosterShell->m_apBagTermUpdates[iBag]);
+         }
+         free(pBoosterShell->m_apBagTermUpdates);
+      }
+      free(pBoosterShell->m_aBagRngs);
+      free(pBoosterShell->m_aBagGains);
       AlignedFree(pBoosterShell->m_aBoostingFastBinsTemp);
       AlignedFree(pBoosterShell->m_aBoostingMainBins);
       AlignedFree(pBoosterShell->m_aMulticlassMidwayTemp);
@@ -74,11 +92,13 @@ BoosterShell * BoosterShell::Create(BoosterCore * const pBoosterCore) {
    return pNew;
 }
 
-ErrorEbm BoosterShell::FillAllocations() {
+ErrorEbm BoosterShell::FillAllocations(const bool bWorker) {
    EBM_ASSERT(nullptr != m_pBoosterCore);
 
    LOG_0(Trace_Info, "Entered BoosterShell::FillAllocations");
 
+   ErrorEbm error = Error_OutOfMemory;
+
    const size_t cScores = m_pBoosterCore->GetCountScores();
    if(size_t { 0 } != cScores) {
       m_pTermUpdate = Tensor::Allocate(k_cDimensionsMax, cScores);
@@ -91,15 +111,79 @@ ErrorEbm BoosterShell::FillAllocations() {
          goto failed_allocation;
       }
 
+      // The training subsets are binned in cSlots slots that depend only on the training set so that the
+      // sums do not depend on the thread count. Worker shells are driven by the ThreadPool of the shell that owns
+      // them, so they bin their slots one after another. Otherwise we either boost whole inner bags in parallel,
+      // or if there are too few inner bags to keep the threads busy we bin the slots of each bag in parallel.
+      const size_t cSlots = EbmMin(k_cBinSumsSlotsMax, 
+         EbmMax(size_t { 1 }, m_pBoosterCore->GetTrainingSet()->GetCountSubsets()));
+      size_t cSlotThreads = 1;
+      size_t cBagWorkers = 1;
+      if(!bWorker) {
+         const size_t cThreads = m_pBoosterCore->GetCountThreads();
+         cSlotThreads = EbmMin(cThreads, cSlots);
+         const size_t cInnerBags = m_pBoosterCore->GetCountInnerBags();
+         if(size_t { 2 } <= cInnerBags) {
+            cBagWorkers = EbmMin(cThreads, cInnerBags);
+         }
+         if(cBagWorkers < cSlotThreads) {
+            cBagWorkers = 1;
+         } else {
+            cSlotThreads = 1;
+         }
+      }
+      // binning the slots one after another needs one set of bins to accumulate into and one to bin the next slot
+      const bool bBinSumsThreaded = size_t { 2 } <= cSlotThreads;
+      const size_t cSlotsAllocated = bBinSumsThreaded ? cSlots : EbmMin(size_t { 2 }, cSlots);
+
+      // Inner bags that are boosted one after another on this shell can have their histograms built together in
+      // a single pass over the data. We only do this for single score models since that is what the kernels
+      // support, and the multiclass bins are large enough that several of them would not stay in the cache.
+      size_t cBagsPerPass = 1;
+      if(!bWorker && size_t { 1 } == cBagWorkers && size_t { 1 } == cScores) {
+         const size_t cInnerBags = m_pBoosterCore->GetCountInnerBags();
+         if(size_t { 2 } <= cInnerBags) {
+            cBagsPerPass = EbmMin(k_cBagsPerPassMax, cInnerBags);
+         }
+      }
+      EBM_ASSERT(!IsMultiplyError(cSlotsAllocated, cBagsPerPass)); // both are small
+      const size_t cBinsSets = cSlotsAllocated * cBagsPerPass;
+
+      const size_t cPoolThreads = EbmMax(cSlotThreads, cBagWorkers);
+      if(size_t { 2 } <= cPoolThreads) {
+         error = ThreadPool::Create(cPoolThreads, &m_pThreadPool);
+         if(Error_None != error) {
+            goto failed_allocation;
+         }
+         error = Error_OutOfMemory;
+      }
+      m_cBinSumsSlots = cSlots;
+      m_cBinSumsSlotsAllocated = cSlotsAllocated;
+      m_bBinSumsThreaded = bBinSumsThreaded;
+      m_cBagsPerPass = cBagsPerPass;
+
       if(0 != m_pBoosterCore->GetCountBytesFastBins()) {
-         m_aBoostingFastBinsTemp = static_cast<BinBase *>(AlignedAlloc(m_pBoosterCore->GetCountBytesFastBins()));
+         // keep each slot aligned for SIMD since the fast bins are written by the compute zones
+         const size_t cBytesFastBinsSlot = 
+            (m_pBoosterCore->GetCountBytesFastBins() + (SIMD_BYTE_ALIGNMENT - 1)) & ~(SIMD_BYTE_ALIGNMENT - 1);
+         if(IsMultiplyError(cBytesFastBinsSlot, cBinsSets)) {
+            goto failed_allocation;
+         }
+         m_cBytesFastBinsSlot = cBytesFastBinsSlot;
+         m_aBoostingFastBinsTemp = static_cast<BinBase *>(AlignedAlloc(cBytesFastBinsSlot * cBinsSets));
          if(nullptr == m_aBoostingFastBinsTemp) {
             goto failed_allocation;
          }
       }
 
       if(0 != m_pBoosterCore->GetCountBytesMainBins()) {
-         m_aBoostingMainBins = static_cast<BinBase *>(AlignedAlloc(m_pBoosterCore->GetCountBytesMainBins()));
+         const size_t cBytesMainBinsSlot =
+            (m_pBoosterCore->GetCountBytesMainBins() + (SIMD_BYTE_ALIGNMENT - 1)) & ~(SIMD_BYTE_ALIGNMENT - 1);
+         if(IsMultiplyError(cBytesMainBinsSlot, cBinsSets)) {
+            goto failed_allocation;
+         }
+         m_cBytesMainBinsSlot = cBytesMainBinsSlot;
+         m_aBoostingMainBins = static_cast<BinBase *>(AlignedAlloc(cBytesMainBinsSlot * cBinsSets));
          if(nullptr == m_aBoostingMainBins) {
             goto failed_allocation;
          }
@@ -163,6 +247,66 @@ ErrorEbm BoosterShell::FillAllocations() {
             goto failed_allocation;
          }
       }
+
+      if(size_t { 2 } <= cBagWorkers) {
+         const size_t cInnerBags = m_pBoosterCore->GetCountInnerBags();
+
+         if(IsMultiplyError(sizeof(Tensor *), cInnerBags)) {
+            goto failed_allocation;
+         }
+         m_apBagTermUpdates = static_cast<Tensor **>(malloc(sizeof(Tensor *) * cInnerBags));
+         if(nullptr == m_apBagTermUpdates) {
+            goto failed_allocation;
+         }
+         for(size_t iBag = 0; iBag < cInnerBags; ++iBag) {
+            m_apBagTermUpdates[iBag] = nullptr;
+         }
+         for(size_t iBag = 0; iBag < cInnerBags; ++iBag) {
+            m_apBagTermUpdates[iBag] = Tensor::Allocate(k_cDimensionsMax, cScores);
+            if(nullptr == m_apBagTermUpdates[iBag]) {
+               goto failed_allocation;
+            }
+         }
+
+         if(IsMultiplyError(sizeof(RandomDeterministic), cInnerBags)) {
+            goto failed_allocation;
+         }
+         m_aBagRngs = static_cast<RandomDeterministic *>(malloc(sizeof(RandomDeterministic) * cInnerBags));
+         if(nullptr == m_aBagRngs) {
+            goto failed_allocation;
+         }
+
+         if(IsMultiplyError(sizeof(double), cInnerBags)) {
+            goto failed_allocation;
+         }
+         m_aBagGains = static_cast<double *>(malloc(sizeof(double) * cInnerBags));
+         if(nullptr == m_aBagGains) {
+            goto failed_allocation;
+         }
+
+         const size_t cWorkerShells = cBagWorkers - 1;
+         m_apWorkerShells = static_cast<BoosterShell **>(malloc(sizeof(BoosterShell *) * cWorkerShells));
+         if(nullptr == m_apWorkerShells) {
+            goto failed_allocation;
+         }
+         for(size_t iWorker = 0; iWorker < cWorkerShells; ++iWorker) {
+            m_apWorkerShells[iWorker] = nullptr;
+         }
+         m_cBagWorkers = cBagWorkers;
+         for(size_t iWorker = 0; iWorker < cWorkerShells; ++iWorker) {
+            BoosterShell * const pWorkerShell = BoosterShell::Create(m_pBoosterCore);
+            if(nullptr == pWorkerShell) {
+               goto failed_allocation;
+            }
+            m_pBoosterCore->AddReferenceCount();
+            m_apWorkerShells[iWorker] = pWorkerShell;
+
+            error = pWorkerShell->FillAllocations(true);
+            if(Error_None != error) {
+               goto failed_allocation;
+            }
+         }
+      }
    }
 
    LOG_0(Trace_Info, "Exited BoosterShell::FillAllocations");
@@ -170,7 +314,7 @@ ErrorEbm BoosterShell::FillAllocations() {
 
 failed_allocation:;
    LOG_0(Trace_Warning, "WARNING Exited BoosterShell::FillAllocations with allocation failure");
-   return Error_OutOfMemory;
+   return error;
 }
 
 EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
@@ -231,7 +375,11 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
    if(0 != (static_cast<UCreateBoosterFlags>(flags) & static_cast<UCreateBoosterFlags>(~(
       static_cast<UCreateBoosterFlags>(CreateBoosterFlags_DifferentialPrivacy) | 
       static_cast<UCreateBoosterFlags>(CreateBoosterFlags_DisableApprox) |
-      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_BinaryAsMulticlass)
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_BinaryAsMulticlass) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_TargetSorted) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_QuantizeGradients) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_QuantizeGradientsInt8) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_Float32)
    )))) {
       LOG_0(Trace_Error, "ERROR CreateBooster flags contains unknown flags. Ignoring extras.");
    }
@@ -293,7 +441,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
       return Error_OutOfMemory;
    }
 
-   error = pBoosterShell->FillAllocations();
+   error = pBoosterShell->FillAllocations(false);
    if(Error_None != error) {
       BoosterShell::Free(pBoosterShell);
       return error;
@@ -371,7 +519,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBoosterView(
    }
    pBoosterCore->AddReferenceCount();
 
-   error = pBoosterShellNew->FillAllocations();
+   error = pBoosterShellNew->FillAllocations(false);
    if(Error_None != error) {
       // TODO: we might move the call to FillAllocations to be more lazy incase the caller doesn't use it all
       BoosterShell::Free(pBoosterShellNew);
@@ -12,6 +12,8 @@
 #include "logging.h" // EBM_ASSERT
 #include "unzoned.h"
 
+#include "common.hpp" // IndexByte
+
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
 #error DEFINED_ZONE_NAME must be defined
@@ -21,6 +23,8 @@ class Tensor;
 
 struct BinBase;
 class BoosterCore;
+class ThreadPool;
+class RandomDeterministic;
 
 template<bool bHessian, size_t cCompilerScores>
 struct SplitPosition;
@@ -39,6 +43,29 @@ class BoosterShell final {
    Tensor * m_pTermUpdate;
    Tensor * m_pInnerTermUpdate;
 
+   ThreadPool * m_pThreadPool;
+
+   // when there are enough inner bags, whole bags are boosted in parallel. Each additional thread boosts into its
+   // own worker BoosterShell that shares our BoosterCore, and each bag gets its own rng, gain and term update
+   // so that the results can be combined deterministically afterwards
+   size_t m_cBagWorkers;
+   BoosterShell ** m_apWorkerShells;
+   Tensor ** m_apBagTermUpdates;
+   RandomDeterministic * m_aBagRngs;
+   double * m_aBagGains;
+
+   // the training subsets are binned in m_cBinSumsSlots contiguous ranges which are then summed in slot order
+   // into the first main bins slot. The slot count depends only on the training set, so the thread count never
+   // changes the sums. When the slots are binned on the ThreadPool each slot gets its own fast bins and main bins,
+   // otherwise the slots are binned one after another through 2 sets of bins. Within each slot there are fast
+   // bins and main bins for each of the inner bags that are binned together in a single pass over the data.
+   size_t m_cBinSumsSlots;
+   size_t m_cBinSumsSlotsAllocated;
+   bool m_bBinSumsThreaded;
+   size_t m_cBagsPerPass;
+   size_t m_cBytesFastBinsSlot;
+   size_t m_cBytesMainBinsSlot;
+
    // TODO: try to merge some of this memory so that we get more CPU cache residency
    BinBase * m_aBoostingFastBinsTemp;
    BinBase * m_aBoostingMainBins;
@@ -68,6 +95,18 @@ public:
       m_iTerm = k_illegalTermIndex;
       m_pTermUpdate = nullptr;
       m_pInnerTermUpdate = nullptr;
+      m_pThreadPool = nullptr;
+      m_cBagWorkers = 1;
+      m_apWorkerShells = nullptr;
+      m_apBagTermUpdates = nullptr;
+      m_aBagRngs = nullptr;
+      m_aBagGains = nullptr;
+      m_cBinSumsSlots = 1;
+      m_cBinSumsSlotsAllocated = 1;
+      m_bBinSumsThreaded = false;
+      m_cBagsPerPass = 1;
+      m_cBytesFastBinsSlot = 0;
+      m_cBytesMainBinsSlot = 0;
       m_aBoostingFastBinsTemp = nullptr;
       m_aBoostingMainBins = nullptr;
       m_aMulticlassMidwayTemp = nullptr;
@@ -77,7 +116,7 @@ public:
 
    static void Free(BoosterShell * const pBoosterShell);
    static BoosterShell * Create(BoosterCore * const pBoosterCore);
-   ErrorEbm FillAllocations();
+   ErrorEbm FillAllocations(const bool bWorker);
 
    INLINE_ALWAYS static BoosterShell * GetBoosterShellFromHandle(const BoosterHandle boosterHandle) {
       if(nullptr == boosterHandle) {
@@ -120,6 +159,58 @@ public:
       return m_pInnerTermUpdate;
    }
 
+   INLINE_ALWAYS ThreadPool * GetThreadPool() {
+      // nullptr if this booster is single threaded
+      return m_pThreadPool;
+   }
+
+   INLINE_ALWAYS size_t GetCountBagWorkers() const {
+      return m_cBagWorkers;
+   }
+
+   INLINE_ALWAYS BoosterShell * GetWorkerShell(const size_t iThread) {
+      EBM_ASSERT(iThread < m_cBagWorkers);
+      // the calling thread of the ThreadPool always has index 0 and it boosts with our own scratch memory
+      return size_t { 0 } == iThread ? this : m_apWorkerShells[iThread - 1];
+   }
+
+   INLINE_ALWAYS Tensor * GetBagTermUpdate(const size_t iBag) {
+      EBM_ASSERT(nullptr != m_apBagTermUpdates);
+      return m_apBagTermUpdates[iBag];
+   }
+
+   INLINE_ALWAYS RandomDeterministic * GetBagRngs() {
+      return m_aBagRngs;
+   }
+
+   INLINE_ALWAYS double * GetBagGains() {
+      return m_aBagGains;
+   }
+
+   INLINE_ALWAYS size_t GetCountBinSumsSlots() const {
+      return m_cBinSumsSlots;
+   }
+
+   INLINE_ALWAYS bool IsBinSumsThreaded() const {
+      return m_bBinSumsThreaded;
+   }
+
+   INLINE_ALWAYS size_t GetCountBagsPerPass() const {
+      return m_cBagsPerPass;
+   }
+
+   INLINE_ALWAYS BinBase * GetBoostingFastBinsSlot(const size_t iSlot, const size_t iPassBag) {
+      EBM_ASSERT(iSlot < m_cBinSumsSlotsAllocated);
+      EBM_ASSERT(iPassBag < m_cBagsPerPass);
+      return IndexByte(m_aBoostingFastBinsTemp, m_cBytesFastBinsSlot * (iSlot * m_cBagsPerPass + iPassBag));
+   }
+
+   INLINE_ALWAYS BinBase * GetBoostingMainBinsSlot(const size_t iSlot, const size_t iPassBag) {
+      EBM_ASSERT(iSlot < m_cBinSumsSlotsAllocated);
+      EBM_ASSERT(iPassBag < m_cBagsPerPass);
+      return IndexByte(m_aBoostingMainBins, m_cBytesMainBinsSlot * (iSlot * m_cBagsPerPass + iPassBag));
+   }
+
    INLINE_ALWAYS BinBase * GetBoostingFastBinsTemp() {
       // call this if the bins were already allocated and we just need the pointer
       return m_aBoostingFastBinsTemp;
@@ -7,6 +7,8 @@
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // numeric_limits
 #include <string.h> // memcpy
+#include <algorithm> // sort, push_heap, pop_heap, sort_heap
+#include <cmath> // ceil
 
 #include "libebm.h" // ErrorEbm
 #include "logging.h" // EBM_ASSERT
@@ -18,10 +20,12 @@
 #include "Bin.hpp" // GetBinSize
 
 #include "ebm_internal.hpp" // k_cDimensionsMax
+#include "ebm_stats.hpp" // k_hessianMin
 #include "Feature.hpp"
 #include "DataSetInteraction.hpp"
 #include "InteractionCore.hpp"
 #include "InteractionShell.hpp"
+#include "ThreadPool.hpp"
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -67,59 +71,33 @@ extern double PartitionTwoDimensionalInteraction(
 #endif // NDEBUG
 );
 
+extern double PartitionMultiDimensionalInteraction(
+   InteractionCore * const pInteractionCore,
+   const size_t cRealDimensions,
+   const size_t * const acBins,
+   const CalcInteractionFlags flags,
+   const size_t cSamplesLeafMin,
+   BinBase * aAuxiliaryBinsBase,
+   BinBase * const aBinsBase
+#ifndef NDEBUG
+   , const BinBase * const aDebugCopyBinsBase
+   , const BinBase * const pBinsEndDebug
+#endif // NDEBUG
+);
+
 // there is a race condition for decrementing this variable, but if a thread loses the 
 // race then it just doesn't get decremented as quickly, which we can live with
 static int g_cLogCalcInteractionStrength = 10;
+static int g_cLogCalcInteractionStrengths = 10;
+static int g_cLogCalcInteractionStrengthsRefined = 10;
 
-EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
-   InteractionHandle interactionHandle,
-   IntEbm countDimensions,
-   const IntEbm * featureIndexes,
-   CalcInteractionFlags flags,
-   IntEbm maxCardinality,
-   IntEbm minSamplesLeaf,
-   double * avgInteractionStrengthOut
+static void ConvertInteractionParams(
+   const CalcInteractionFlags flags,
+   const IntEbm maxCardinality,
+   const IntEbm minSamplesLeaf,
+   size_t * const pcCardinalityMaxOut,
+   size_t * const pcSamplesLeafMinOut
 ) {
-   LOG_COUNTED_N(
-      &g_cLogCalcInteractionStrength,
-      Trace_Info,
-      Trace_Verbose,
-      "CalcInteractionStrength: "
-      "interactionHandle=%p, "
-      "countDimensions=%" IntEbmPrintf ", "
-      "featureIndexes=%p, "
-      "flags=0x%" UCalcInteractionFlagsPrintf ", "
-      "maxCardinality=%" IntEbmPrintf ", "
-      "minSamplesLeaf=%" IntEbmPrintf ", "
-      "avgInteractionStrengthOut=%p"
-      ,
-      static_cast<void *>(interactionHandle),
-      countDimensions,
-      static_cast<const void *>(featureIndexes),
-      static_cast<UCalcInteractionFlags>(flags), // signed to unsigned conversion is defined behavior in C++
-      maxCardinality,
-      minSamplesLeaf,
-      static_cast<void *>(avgInteractionStrengthOut)
-   );
-
-   ErrorEbm error;
-
-   if(LIKELY(nullptr != avgInteractionStrengthOut)) {
-      *avgInteractionStrengthOut = k_illegalGainDouble;
-   }
-
-   InteractionShell * const pInteractionShell = InteractionShell::GetInteractionShellFromHandle(interactionHandle);
-   if(nullptr == pInteractionShell) {
-      // already logged
-      return Error_IllegalParamVal;
-   }
-   LOG_COUNTED_0(
-      pInteractionShell->GetPointerCountLogEnterMessages(), 
-      Trace_Info, 
-      Trace_Verbose, 
-      "Entered CalcInteractionStrength"
-   );
-
    if(0 != (static_cast<UCalcInteractionFlags>(flags) & static_cast<UCalcInteractionFlags>(~(
       static_cast<UCalcInteractionFlags>(CalcInteractionFlags_Pure) | 
       static_cast<UCalcInteractionFlags>(CalcInteractionFlags_EnableNewton)
@@ -139,6 +117,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
    } else {
       LOG_0(Trace_Warning, "WARNING CalcInteractionStrength maxCardinality can't be less than 0. Turning off.");
    }
+   *pcCardinalityMaxOut = cCardinalityMax;
 
    size_t cSamplesLeafMin = size_t { 1 }; // this is the min value
    if(IntEbm { 1 } <= minSamplesLeaf) {
@@ -151,37 +130,377 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
    } else {
       LOG_0(Trace_Warning, "WARNING CalcInteractionStrength minSamplesLeaf can't be less than 1. Adjusting to 1.");
    }
+   *pcSamplesLeafMinOut = cSamplesLeafMin;
+}
 
-   if(countDimensions <= IntEbm { 0 }) {
-      if(IntEbm { 0 } == countDimensions) {
-         LOG_0(Trace_Info, "INFO CalcInteractionStrength empty feature list");
-         if(LIKELY(nullptr != avgInteractionStrengthOut)) {
-            *avgInteractionStrengthOut = 0.0;
-         }
-         return Error_None;
+static size_t GetFastBinSize(const DataSubsetInteraction * const pSubset, const bool bHessian, const size_t cScores) {
+   if(sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes) {
+      if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
+         return GetBinSize<FloatBig, UIntBig>(bHessian, cScores);
       } else {
-         LOG_0(Trace_Error, "ERROR CalcInteractionStrength countDimensions must be positive");
-         return Error_IllegalParamVal;
+         EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
+         return GetBinSize<FloatSmall, UIntBig>(bHessian, cScores);
+      }
+   } else {
+      EBM_ASSERT(sizeof(UIntSmall) == pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+      if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
+         return GetBinSize<FloatBig, UIntSmall>(bHessian, cScores);
+      } else {
+         EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
+         return GetBinSize<FloatSmall, UIntSmall>(bHessian, cScores);
       }
    }
-   if(nullptr == featureIndexes) {
-      LOG_0(Trace_Error, "ERROR CalcInteractionStrength featureIndexes cannot be nullptr if 0 < countDimensions");
-      return Error_IllegalParamVal;
+}
+
+// ScaleGain turns the gain of a split of the main bins into the strength that we report
+static double ScaleGain(InteractionCore * const pInteractionCore, const CalcInteractionFlags flags, double gain) {
+   // if totalWeight < 1 then gain could overflow to +inf, so do the division first
+   const double totalWeight = pInteractionCore->GetDataSetInteraction()->GetWeightTotal();
+   EBM_ASSERT(0 < totalWeight); // if all are zeros we assume there are no weights and use the count
+   gain /= totalWeight;
+   if(0 != (static_cast<UCalcInteractionFlags>(flags) & static_cast<UCalcInteractionFlags>(CalcInteractionFlags_EnableNewton))) {
+      gain /= pInteractionCore->HessianConstant();
+      gain *= pInteractionCore->GainAdjustmentHessianBoosting();
+   } else {
+      gain *= pInteractionCore->GainAdjustmentGradientBoosting();
    }
-   if(IntEbm { k_cDimensionsMax } < countDimensions) {
-      LOG_0(Trace_Warning, "WARNING CalcInteractionStrength countDimensions too large and would cause out of memory condition");
-      return Error_OutOfMemory;
+   const double gradientConstant = pInteractionCore->GradientConstant();
+   gain *= gradientConstant;
+   gain *= gradientConstant;
+   return gain;
+}
+
+// CalcStrengthFromMainBins turns the main bins of a term into its strength.  aMainBins holds the tensor of the term
+// followed by room for cAuxillaryBins auxiliary bins, which must hold at least 2^cDimensions bins for splitting.
+// Terms need at least 2 dimensions to be an interaction
+static double CalcStrengthFromMainBins(
+   InteractionCore * const pInteractionCore,
+   const size_t cDimensions,
+   const size_t * const acBins,
+   const CalcInteractionFlags flags,
+   const size_t cSamplesLeafMin,
+   const size_t cTensorBins,
+   const size_t cAuxillaryBins,
+   BinBase * const aMainBins
+#ifndef NDEBUG
+   , const BinBase * const pDebugMainBinsEnd
+#endif // NDEBUG
+) {
+   const size_t cScores = pInteractionCore->GetCountScores();
+   const size_t cBytesPerMainBin = GetBinSize<FloatMain, UIntMain>(pInteractionCore->IsHessian(), cScores);
+
+   // terms with a single dimension are k_illegalGainDouble, which means they won't be considered but indicates they
+   // were not handled
+   double bestGain = k_illegalGainDouble;
+
+#ifndef NDEBUG
+   // make a copy of the original bins for debugging purposes
+
+   BinBase * aDebugCopyBins = nullptr;
+   if(!IsMultiplyError(cBytesPerMainBin, cTensorBins)) {
+      ANALYSIS_ASSERT(0 != cBytesPerMainBin);
+      ANALYSIS_ASSERT(1 <= cTensorBins);
+      aDebugCopyBins = static_cast<BinBase *>(malloc(cBytesPerMainBin * cTensorBins));
+      if(nullptr != aDebugCopyBins) {
+         // if we can't allocate, don't fail.. just stop checking
+         memcpy(aDebugCopyBins, aMainBins, cTensorBins * cBytesPerMainBin);
+      }
+   }
+#endif // NDEBUG
+
+   BinBase * aAuxiliaryBins = IndexBin(aMainBins, cBytesPerMainBin * cTensorBins);
+   aAuxiliaryBins->ZeroMem(cBytesPerMainBin, cAuxillaryBins);
+
+   TensorTotalsBuild(
+      pInteractionCore->IsHessian(),
+      cScores,
+      cDimensions,
+      acBins,
+      aAuxiliaryBins,
+      aMainBins
+#ifndef NDEBUG
+      , aDebugCopyBins
+      , pDebugMainBinsEnd
+#endif // NDEBUG
+   );
+
+   if(2 <= cDimensions) {
+      if(2 == cDimensions) {
+         LOG_0(Trace_Verbose, "CalcInteractionStrength Starting bin sweep loop");
+
+         bestGain = PartitionTwoDimensionalInteraction(
+            pInteractionCore,
+            cDimensions,
+            acBins,
+            flags,
+            cSamplesLeafMin,
+            aAuxiliaryBins,
+            aMainBins
+#ifndef NDEBUG
+            , aDebugCopyBins
+            , pDebugMainBinsEnd
+#endif // NDEBUG
+         );
+      } else {
+         LOG_0(Trace_Verbose, "CalcInteractionStrength Starting greedy cut search");
+
+         bestGain = PartitionMultiDimensionalInteraction(
+            pInteractionCore,
+            cDimensions,
+            acBins,
+            flags,
+            cSamplesLeafMin,
+            aAuxiliaryBins,
+            aMainBins
+#ifndef NDEBUG
+            , aDebugCopyBins
+            , pDebugMainBinsEnd
+#endif // NDEBUG
+         );
+      }
+
+      bestGain = ScaleGain(pInteractionCore, flags, bestGain);
+
+      if(UNLIKELY(/* NaN */ !LIKELY(bestGain <= std::numeric_limits<double>::max()))) {
+         // We simplify our caller's handling by returning -lowest as our error indicator. -lowest will sort to being the
+         // least important item, which is good, but it also signals an overflow without the weirness of NaNs.
+         EBM_ASSERT(std::isnan(bestGain) || std::numeric_limits<double>::infinity() == bestGain);
+         bestGain = k_illegalGainDouble;
+      } else if(UNLIKELY(bestGain < 0.0)) {
+         // gain can't mathematically be legally negative, but it can be here in the following situations:
+         //   1) for impure interaction gain we subtract the parent partial gain, and there can be floating point
+         //      noise that makes this slightly negative
+         //   2) for impure interaction gain we subtract the parent partial gain, but if there were no legal cuts
+         //      then the partial gain before subtracting the parent partial gain was zero and we then get a 
+         //      substantially negative value.  In this case we should not have subtracted the parent partial gain
+         //      since we had never even calculated the 4 quadrant partial gain, but we handle this scenario 
+         //      here instead of inside the templated function.
+
+         EBM_ASSERT(!std::isnan(bestGain));
+         // make bestGain k_illegalGainDouble if it's -infinity, otherwise make it zero
+         bestGain = std::numeric_limits<double>::lowest() <= bestGain ? 0.0 : k_illegalGainDouble;
+      } else {
+         EBM_ASSERT(!std::isnan(bestGain));
+         EBM_ASSERT(!std::isinf(bestGain));
+      }
+
+      EBM_ASSERT(k_illegalGainDouble == bestGain || 0.0 <= bestGain);
+   } else {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrength a term needs at least 2 dimensions to be an interaction");
+   }
+
+#ifndef NDEBUG
+   free(aDebugCopyBins);
+#endif // NDEBUG
+
+   return bestGain;
+}
+
+// the bound below is raised by this fraction of the partial gain of the children so that the floating point noise
+// of summing the bins in a different order than PartitionTwoDimensionalInteraction can never prune a strong pair
+static constexpr FloatCalc k_boundSlack = FloatCalc { 1e-9 };
+
+// AddPartialGainBound adds the partial gain of a bin to *pGain.  It returns false if the bin has gradients but too
+// little hessian to divide by, since then merging it into other bins can increase the partial gain
+template<bool bHessian>
+static bool AddPartialGainBound(
+   const size_t cScores,
+   const Bin<FloatMain, UIntMain, bHessian> * const pBin,
+   FloatCalc * const pGain
+) {
+   static constexpr bool bUseLogitBoost = k_bUseLogitboost && bHessian;
+   const auto * const aGradientPairs = pBin->GetGradientPairs();
+   size_t iScore = 0;
+   do {
+      const FloatCalc n = static_cast<FloatCalc>(aGradientPairs[iScore].m_sumGradients);
+      const FloatCalc d = static_cast<FloatCalc>(bUseLogitBoost ? aGradientPairs[iScore].GetHess() : pBin->GetWeight());
+      if(UNLIKELY(d < k_hessianMin) && FloatCalc { 0 } != n) {
+         return false;
+      }
+      *pGain += EbmStats::CalcPartialGain(n, d);
+      ++iScore;
+   } while(cScores != iScore);
+   return true;
+}
+
+// CalcPairStrengthBoundInternal returns an upper bound on the strength that CalcStrengthFromMainBins returns for a
+// pair with impure gain, without building the tensor totals or sweeping every pair of cuts.  Merging bins never
+// increases the sum of the partial gains, so the 4 quadrants of any pair of cuts cannot beat the best single cut of
+// dimension 0 that keeps every bin of dimension 1 separate.  aMainBins must not have been through TensorTotalsBuild
+// yet and the auxiliary bins are used as scratch space
+template<bool bHessian>
+static double CalcPairStrengthBoundInternal(
+   InteractionCore * const pInteractionCore,
+   const size_t * const acBins,
+   const CalcInteractionFlags flags,
+   const size_t cAuxillaryBins,
+   BinBase * const aMainBinsBase
+) {
+   const size_t cScores = pInteractionCore->GetCountScores();
+   const size_t cBytesPerBin = GetBinSize<FloatMain, UIntMain>(bHessian, cScores);
+   const size_t cBins0 = acBins[0];
+   const size_t cBins1 = acBins[1];
+   EBM_ASSERT(2 <= cBins0);
+   EBM_ASSERT(2 <= cBins1);
+   const size_t cCuts = cBins0 - size_t { 1 };
+
+   // the scaling is linear, so the bound survives it only if it does not flip the order
+   if(!(0.0 <= ScaleGain(pInteractionCore, flags, 1.0))) {
+      return std::numeric_limits<double>::infinity();
+   }
+
+   auto * const aBins = aMainBinsBase->Specialize<FloatMain, UIntMain, bHessian>();
+
+   // the auxiliary bins hold a running bin and the total bin followed by the partial gains of each cut
+   EBM_ASSERT(size_t { 2 } * cBytesPerBin + sizeof(FloatCalc) * cCuts <= cBytesPerBin * cAuxillaryBins);
+   UNUSED(cAuxillaryBins);
+   auto * const pRunning = IndexBin(aBins, cBytesPerBin * cBins0 * cBins1);
+   pRunning->ZeroMem(cBytesPerBin, 2);
+   auto * const pTotal = IndexBin(pRunning, cBytesPerBin);
+   FloatCalc * const aCutGains = reinterpret_cast<FloatCalc *>(IndexBin(pRunning, cBytesPerBin * 2));
+   for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+      aCutGains[iCut] = 0;
+   }
+
+   const auto * pRow = aBins;
+   size_t iBin1 = 0;
+   do {
+      // the part of the row below each cut
+      pRunning->ZeroMem(cBytesPerBin);
+      size_t iCut = 0;
+      do {
+         pRunning->Add(cScores, *IndexBin(pRow, cBytesPerBin * iCut));
+         if(!AddPartialGainBound<bHessian>(cScores, pRunning, &aCutGains[iCut])) {
+            return std::numeric_limits<double>::infinity();
+         }
+         ++iCut;
+      } while(cCuts != iCut);
+
+      // the part of the row above each cut
+      pRunning->ZeroMem(cBytesPerBin);
+      do {
+         pRunning->Add(cScores, *IndexBin(pRow, cBytesPerBin * iCut));
+         --iCut;
+         if(!AddPartialGainBound<bHessian>(cScores, pRunning, &aCutGains[iCut])) {
+            return std::numeric_limits<double>::infinity();
+         }
+      } while(size_t { 0 } != iCut);
+      pRunning->Add(cScores, *pRow);
+      pTotal->Add(cScores, *pRunning);
+
+      pRow = IndexBin(pRow, cBytesPerBin * cBins0);
+      ++iBin1;
+   } while(cBins1 != iBin1);
+
+   FloatCalc bestGain = 0;
+   for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+      // propagate NaN values, which are never pruned
+      if(UNLIKELY(/* NaN */ !LIKELY(aCutGains[iCut] <= bestGain))) {
+         bestGain = aCutGains[iCut];
+      }
+   }
+   bestGain += bestGain * k_boundSlack;
+
+   FloatCalc parentGain = 0;
+   if(!AddPartialGainBound<bHessian>(cScores, pTotal, &parentGain)) {
+      return std::numeric_limits<double>::infinity();
+   }
+   const double bound = ScaleGain(pInteractionCore, flags, static_cast<double>(bestGain - parentGain));
+   if(UNLIKELY(/* NaN */ !LIKELY(bound <= std::numeric_limits<double>::max()))) {
+      return std::numeric_limits<double>::infinity();
+   }
+   return bound < 0.0 ? 0.0 : bound;
+}
+
+static double CalcPairStrengthBound(
+   InteractionCore * const pInteractionCore,
+   const size_t * const acBins,
+   const CalcInteractionFlags flags,
+   const size_t cAuxillaryBins,
+   BinBase * const aMainBins
+) {
+   EBM_ASSERT(0 == (static_cast<UCalcInteractionFlags>(flags) & static_cast<UCalcInteractionFlags>(CalcInteractionFlags_Pure)));
+   if(pInteractionCore->IsHessian()) {
+      return CalcPairStrengthBoundInternal<true>(pInteractionCore, acBins, flags, cAuxillaryBins, aMainBins);
+   } else {
+      return CalcPairStrengthBoundInternal<false>(pInteractionCore, acBins, flags, cAuxillaryBins, aMainBins);
+   }
+}
+
+// TopStrengths holds the strongest strengths that one thread of CalcInteractionStrengths has calculated so far.  A
+// thread only prunes the terms whose bound is below the weakest of its own countTopTerms strengths.  That can never
+// be above the weakest of the final top terms, so pruning does not change the top terms and needs no locking
+struct TopStrengths final {
+   size_t m_cHeap;
+   size_t m_cUsed;
+   // a heap whose front is the weakest strength
+   double * m_aHeap;
+   size_t m_cPruned;
+};
+static_assert(std::is_standard_layout<TopStrengths>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<TopStrengths>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+static bool IsWeakerStrength(const double lhs, const double rhs) {
+   return rhs < lhs;
+}
+
+static bool PruneTerm(TopStrengths * const pTopStrengths, const double bound) {
+   if(pTopStrengths->m_cHeap == pTopStrengths->m_cUsed && bound < pTopStrengths->m_aHeap[0]) {
+      ++pTopStrengths->m_cPruned;
+      return true;
+   }
+   return false;
+}
+
+static void AddTopStrength(TopStrengths * const pTopStrengths, const double strength) {
+   double * const aHeap = pTopStrengths->m_aHeap;
+   if(pTopStrengths->m_cUsed < pTopStrengths->m_cHeap) {
+      aHeap[pTopStrengths->m_cUsed] = strength;
+      ++pTopStrengths->m_cUsed;
+      std::push_heap(aHeap, aHeap + pTopStrengths->m_cUsed, IsWeakerStrength);
+   } else if(aHeap[0] < strength) {
+      std::pop_heap(aHeap, aHeap + pTopStrengths->m_cUsed, IsWeakerStrength);
+      aHeap[pTopStrengths->m_cUsed - 1] = strength;
+      std::push_heap(aHeap, aHeap + pTopStrengths->m_cUsed, IsWeakerStrength);
+   }
+}
+
+// CalcTermStrength only writes to the bins and log counters of pInteractionShell and only reads the InteractionCore,
+// so several threads can calculate strengths at the same time if each has its own InteractionShell.  If
+// pTopStrengths is not nullptr, pairs that cannot be among its top strengths are pruned and get k_illegalGainDouble
+static ErrorEbm CalcTermStrength(
+   InteractionShell * const pInteractionShell,
+   const size_t cDimensions,
+   const IntEbm * const featureIndexes,
+   const CalcInteractionFlags flags,
+   const size_t cCardinalityMax,
+   const size_t cSamplesLeafMin,
+   TopStrengths * const pTopStrengths,
+   double * const pStrengthOut
+) {
+   EBM_ASSERT(nullptr != pInteractionShell);
+   EBM_ASSERT(size_t { 0 } == cDimensions || nullptr != featureIndexes);
+   EBM_ASSERT(cDimensions <= k_cDimensionsMax);
+   EBM_ASSERT(nullptr != pStrengthOut);
+
+   ErrorEbm error;
+
+   *pStrengthOut = k_illegalGainDouble;
+
+   if(size_t { 0 } == cDimensions) {
+      LOG_0(Trace_Info, "INFO CalcInteractionStrength empty feature list");
+      *pStrengthOut = 0.0;
+      return Error_None;
    }
-   size_t cDimensions = static_cast<size_t>(countDimensions);
 
    InteractionCore * const pInteractionCore = pInteractionShell->GetInteractionCore();
 
    const size_t cScores = pInteractionCore->GetCountScores();
    if(size_t { 0 } == cScores) {
       LOG_0(Trace_Info, "INFO CalcInteractionStrength target with 1 class perfectly predicts the target");
-      if(nullptr != avgInteractionStrengthOut) {
-         *avgInteractionStrengthOut = 0.0;
-      }
+      *pStrengthOut = 0.0;
       return Error_None;
    }
 
@@ -191,9 +510,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
    if(size_t { 0 } == pDataSet->GetCountSamples()) {
       // if there are zero samples, there isn't much basis to say whether there are interactions, so just return zero
       LOG_0(Trace_Info, "INFO CalcInteractionStrength zero samples");
-      if(nullptr != avgInteractionStrengthOut) {
-         *avgInteractionStrengthOut = 0.0;
-      }
+      *pStrengthOut = 0.0;
       return Error_None;
    }
 
@@ -229,11 +546,13 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
       const size_t cBins = pFeature->GetCountBins();
       if(UNLIKELY(cBins <= size_t { 1 })) {
          LOG_0(Trace_Info, "INFO CalcInteractionStrength term contains a feature with only 1 or 0 bins");
-         if(nullptr != avgInteractionStrengthOut) {
-            *avgInteractionStrengthOut = 0.0;
-         }
+         *pStrengthOut = 0.0;
          return Error_None;
       }
+      if(pInteractionCore->IsFeatureDataMissing(iFeature)) {
+         LOG_0(Trace_Error, "ERROR CalcInteractionStrength the booster of this interaction detector has no main term for a feature in featureIndexes");
+         return Error_IllegalParamVal;
+      }
       binSums.m_acBins[iDimension] = cBins;
 
       // if cBins could be 1, then we'd need to check at runtime for overflow of cAuxillaryBinsForBuildFastTotals
@@ -250,9 +569,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
          // so we need to check if our caller gave us a tensor that overflows multiplication
          // if we overflow this, then we'd be above the cCardinalityMax value, so set it to 0.0
          LOG_0(Trace_Info, "INFO CalcInteractionStrength IsMultiplyError(cTensorBins, cBins)");
-         if (nullptr != avgInteractionStrengthOut) {
-            *avgInteractionStrengthOut = 0.0;
-         }
+         *pStrengthOut = 0.0;
          return Error_None;
       }
       cTensorBins *= cBins;
@@ -264,13 +581,14 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
 
    if(cCardinalityMax < cTensorBins) {
       LOG_0(Trace_Info, "INFO CalcInteractionStrength cCardinalityMax < cTensorBins");
-      if (nullptr != avgInteractionStrengthOut) {
-         *avgInteractionStrengthOut = 0.0;
-      }
+      *pStrengthOut = 0.0;
       return Error_None;
    }
 
-   static constexpr size_t cAuxillaryBinsForSplitting = 4;
+   // splitting needs a bin for each of the 2^cDimensions cells.  Every dimension has 2 or more bins, so this is no
+   // more than cTensorBins
+   const size_t cAuxillaryBinsForSplitting = size_t { 1 } << cDimensions;
+   EBM_ASSERT(cAuxillaryBinsForSplitting <= cTensorBins);
    const size_t cAuxillaryBins = EbmMax(cAuxillaryBinsForBuildFastTotals, cAuxillaryBinsForSplitting);
 
    if(IsAddError(cTensorBins, cAuxillaryBins)) {
@@ -303,23 +621,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
    DataSubsetInteraction * pSubset = pInteractionCore->GetDataSetInteraction()->GetSubsets();
    const DataSubsetInteraction * const pSubsetsEnd = pSubset + pInteractionCore->GetDataSetInteraction()->GetCountSubsets();
    do {
-      size_t cBytesPerFastBin;
-      if(sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes) {
-         if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
-            cBytesPerFastBin = GetBinSize<FloatBig, UIntBig>(bHessian, cScores);
-         } else {
-            EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-            cBytesPerFastBin = GetBinSize<FloatSmall, UIntBig>(bHessian, cScores);
-         }
-      } else {
-         EBM_ASSERT(sizeof(UIntSmall) == pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-         if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
-            cBytesPerFastBin = GetBinSize<FloatBig, UIntSmall>(bHessian, cScores);
-         } else {
-            EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-            cBytesPerFastBin = GetBinSize<FloatSmall, UIntSmall>(bHessian, cScores);
-         }
-      }
+      const size_t cBytesPerFastBin = GetFastBinSize(pSubset, bHessian, cScores);
       if(IsMultiplyError(cBytesPerFastBin, cTensorBins)) {
          LOG_0(Trace_Warning, "WARNING CalcInteractionStrength IsMultiplyError(cBytesPerBin, cTensorBins)");
          return Error_OutOfMemory;
@@ -354,6 +656,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
       } while(cDimensions != iDimensionLoop);
 
       binSums.m_cRuntimeRealDimensions = cDimensions;
+      binSums.m_cPartners = 0;
 
       binSums.m_bHessian = pInteractionCore->IsHessian() ? EBM_TRUE : EBM_FALSE;
       binSums.m_cScores = cScores;
@@ -390,96 +693,33 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
 
 
 
-#ifndef NDEBUG
-   // make a copy of the original bins for debugging purposes
-
-   BinBase * aDebugCopyBins = nullptr;
-   if(!IsMultiplyError(cBytesPerMainBin, cTensorBins)) {
-      ANALYSIS_ASSERT(0 != cBytesPerMainBin);
-      ANALYSIS_ASSERT(1 <= cTensorBins);
-      aDebugCopyBins = static_cast<BinBase *>(malloc(cBytesPerMainBin * cTensorBins));
-      if(nullptr != aDebugCopyBins) {
-         // if we can't allocate, don't fail.. just stop checking
-         memcpy(aDebugCopyBins, aMainBins, cTensorBins * cBytesPerMainBin);
+   if(nullptr != pTopStrengths && 2 == cDimensions &&
+      0 == (static_cast<UCalcInteractionFlags>(flags) & static_cast<UCalcInteractionFlags>(CalcInteractionFlags_Pure))) {
+      const double bound = CalcPairStrengthBound(pInteractionCore, binSums.m_acBins, flags, cAuxillaryBins, aMainBins);
+      if(PruneTerm(pTopStrengths, bound)) {
+         return Error_None;
       }
    }
-#endif // NDEBUG
-
-   BinBase * aAuxiliaryBins = IndexBin(aMainBins, cBytesPerMainBin * cTensorBins);
-   aAuxiliaryBins->ZeroMem(cBytesPerMainBin, cAuxillaryBins);
 
-   TensorTotalsBuild(
-      pInteractionCore->IsHessian(),
-      cScores,
+   const double bestGain = CalcStrengthFromMainBins(
+      pInteractionCore,
       cDimensions,
       binSums.m_acBins,
-      aAuxiliaryBins,
+      flags,
+      cSamplesLeafMin,
+      cTensorBins,
+      cAuxillaryBins,
       aMainBins
 #ifndef NDEBUG
-      , aDebugCopyBins
       , pDebugMainBinsEnd
 #endif // NDEBUG
    );
+   *pStrengthOut = bestGain;
+   if(nullptr != pTopStrengths) {
+      AddTopStrength(pTopStrengths, bestGain);
+   }
 
-   if(2 == cDimensions) {
-      LOG_0(Trace_Verbose, "CalcInteractionStrength Starting bin sweep loop");
-
-      double bestGain = PartitionTwoDimensionalInteraction(
-         pInteractionCore,
-         cDimensions,
-         binSums.m_acBins,
-         flags,
-         cSamplesLeafMin,
-         aAuxiliaryBins,
-         aMainBins
-#ifndef NDEBUG
-         , aDebugCopyBins
-         , pDebugMainBinsEnd
-#endif // NDEBUG
-      );
-
-      // if totalWeight < 1 then bestGain could overflow to +inf, so do the division first
-      const double totalWeight = pDataSet->GetWeightTotal();
-      EBM_ASSERT(0 < totalWeight); // if all are zeros we assume there are no weights and use the count
-      bestGain /= totalWeight;
-      if(0 != (static_cast<UCalcInteractionFlags>(flags) & static_cast<UCalcInteractionFlags>(CalcInteractionFlags_EnableNewton))) {
-         bestGain /= pInteractionCore->HessianConstant();
-         bestGain *= pInteractionCore->GainAdjustmentHessianBoosting();
-      } else {
-         bestGain *= pInteractionCore->GainAdjustmentGradientBoosting();
-      }
-      const double gradientConstant = pInteractionCore->GradientConstant();
-      bestGain *= gradientConstant;
-      bestGain *= gradientConstant;
-
-      if(UNLIKELY(/* NaN */ !LIKELY(bestGain <= std::numeric_limits<double>::max()))) {
-         // We simplify our caller's handling by returning -lowest as our error indicator. -lowest will sort to being the
-         // least important item, which is good, but it also signals an overflow without the weirness of NaNs.
-         EBM_ASSERT(std::isnan(bestGain) || std::numeric_limits<double>::infinity() == bestGain);
-         bestGain = k_illegalGainDouble;
-      } else if(UNLIKELY(bestGain < 0.0)) {
-         // gain can't mathematically be legally negative, but it can be here in the following situations:
-         //   1) for impure interaction gain we subtract the parent partial gain, and there can be floating point
-         //      noise that makes this slightly negative
-         //   2) for impure interaction gain we subtract the parent partial gain, but if there were no legal cuts
-         //      then the partial gain before subtracting the parent partial gain was zero and we then get a 
-         //      substantially negative value.  In this case we should not have subtracted the parent partial gain
-         //      since we had never even calculated the 4 quadrant partial gain, but we handle this scenario 
-         //      here instead of inside the templated function.
-
-         EBM_ASSERT(!std::isnan(bestGain));
-         // make bestGain k_illegalGainDouble if it's -infinity, otherwise make it zero
-         bestGain = std::numeric_limits<double>::lowest() <= bestGain ? 0.0 : k_illegalGainDouble;
-      } else {
-         EBM_ASSERT(!std::isnan(bestGain));
-         EBM_ASSERT(!std::isinf(bestGain));
-      }
-
-      if(nullptr != avgInteractionStrengthOut) {
-         *avgInteractionStrengthOut = bestGain;
-      }
-
-      EBM_ASSERT(k_illegalGainDouble == bestGain || 0.0 <= bestGain);
+   if(2 <= cDimensions) {
       LOG_COUNTED_N(
          pInteractionShell->GetPointerCountLogExitMessages(),
          Trace_Info,
@@ -489,20 +729,959 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
          ,
          bestGain
       );
-   } else {
-      LOG_0(Trace_Warning, "WARNING CalcInteractionStrength We only support pairs for interaction detection currently");
+   }
+
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
+   InteractionHandle interactionHandle,
+   IntEbm countDimensions,
+   const IntEbm * featureIndexes,
+   CalcInteractionFlags flags,
+   IntEbm maxCardinality,
+   IntEbm minSamplesLeaf,
+   double * avgInteractionStrengthOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogCalcInteractionStrength,
+      Trace_Info,
+      Trace_Verbose,
+      "CalcInteractionStrength: "
+      "interactionHandle=%p, "
+      "countDimensions=%" IntEbmPrintf ", "
+      "featureIndexes=%p, "
+      "flags=0x%" UCalcInteractionFlagsPrintf ", "
+      "maxCardinality=%" IntEbmPrintf ", "
+      "minSamplesLeaf=%" IntEbmPrintf ", "
+      "avgInteractionStrengthOut=%p"
+      ,
+      static_cast<void *>(interactionHandle),
+      countDimensions,
+      static_cast<const void *>(featureIndexes),
+      static_cast<UCalcInteractionFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      maxCardinality,
+      minSamplesLeaf,
+      static_cast<void *>(avgInteractionStrengthOut)
+   );
+
+   if(LIKELY(nullptr != avgInteractionStrengthOut)) {
+      *avgInteractionStrengthOut = k_illegalGainDouble;
+   }
+
+   InteractionShell * const pInteractionShell = InteractionShell::GetInteractionShellFromHandle(interactionHandle);
+   if(nullptr == pInteractionShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+   LOG_COUNTED_0(
+      pInteractionShell->GetPointerCountLogEnterMessages(), 
+      Trace_Info, 
+      Trace_Verbose, 
+      "Entered CalcInteractionStrength"
+   );
+
+   size_t cCardinalityMax;
+   size_t cSamplesLeafMin;
+   ConvertInteractionParams(flags, maxCardinality, minSamplesLeaf, &cCardinalityMax, &cSamplesLeafMin);
+
+   if(countDimensions < IntEbm { 0 }) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrength countDimensions must be positive");
+      return Error_IllegalParamVal;
+   }
+   if(IntEbm { 0 } != countDimensions && nullptr == featureIndexes) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrength featureIndexes cannot be nullptr if 0 < countDimensions");
+      return Error_IllegalParamVal;
+   }
+   if(IntEbm { k_cDimensionsMax } < countDimensions) {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrength countDimensions too large and would cause out of memory condition");
+      return Error_OutOfMemory;
+   }
+   const size_t cDimensions = static_cast<size_t>(countDimensions);
+
+   double strength;
+   const ErrorEbm error = CalcTermStrength(
+      pInteractionShell,
+      cDimensions,
+      featureIndexes,
+      flags,
+      cCardinalityMax,
+      cSamplesLeafMin,
+      nullptr,
+      &strength
+   );
+   if(nullptr != avgInteractionStrengthOut) {
+      *avgInteractionStrengthOut = strength;
+   }
+   return error;
+}
+
+// pairs that share their first feature (the anchor) are binned together in one pass over the data as long as their
+// tensors stay small enough to keep the fast bins of the whole group in cache
+static constexpr size_t k_cAnchorTensorBinsMax = size_t { 1 } << 16;
+
+// GetAnchorPairTensorBins returns the number of tensor bins of a pair that CalcInteractionStrengths can bin together
+// with other pairs of the same anchor, or zero if the term needs to go through CalcTermStrength on its own.  Illegal
+// terms also go through CalcTermStrength, which logs them and returns the error
+static size_t GetAnchorPairTensorBins(
+   InteractionCore * const pInteractionCore,
+   const size_t cDimensions,
+   const IntEbm * const featureIndexes,
+   const size_t cCardinalityMax
+) {
+   if(size_t { 2 } != cDimensions) {
+      return 0;
+   }
+   const IntEbm countFeatures = static_cast<IntEbm>(pInteractionCore->GetCountFeatures());
+   const IntEbm indexAnchor = featureIndexes[0];
+   const IntEbm indexPartner = featureIndexes[1];
+   if(indexAnchor < IntEbm { 0 } || countFeatures <= indexAnchor ||
+      indexPartner < IntEbm { 0 } || countFeatures <= indexPartner) {
+      return 0;
+   }
+   const FeatureInteraction * const aFeatures = pInteractionCore->GetFeatures();
+   const size_t cAnchorBins = aFeatures[static_cast<size_t>(indexAnchor)].GetCountBins();
+   const size_t cPartnerBins = aFeatures[static_cast<size_t>(indexPartner)].GetCountBins();
+   if(cAnchorBins <= size_t { 1 } || cPartnerBins <= size_t { 1 } ||
+      k_cAnchorTensorBinsMax < cAnchorBins || k_cAnchorTensorBinsMax < cPartnerBins) {
+      return 0;
+   }
+   if(pInteractionCore->IsFeatureDataMissing(static_cast<size_t>(indexAnchor)) ||
+      pInteractionCore->IsFeatureDataMissing(static_cast<size_t>(indexPartner))) {
+      // CalcTermStrength reports the error
+      return 0;
+   }
+   const size_t cTensorBins = cAnchorBins * cPartnerBins; // both are below 2^16, so this cannot overflow
+   if(k_cAnchorTensorBinsMax < cTensorBins || cCardinalityMax < cTensorBins) {
+      return 0;
+   }
+   return cTensorBins;
+}
+
+// CalcAnchorPairStrengths calculates the same strengths as CalcTermStrength for the pairs (iAnchor, aiPartners[i]),
+// but bins all of them in a single pass over the data with BinSumsInteraction so that the gradients and the bins of
+// the anchor are only read once.  Every pair must have passed GetAnchorPairTensorBins, and together they must have no
+// more than k_cAnchorTensorBinsMax tensor bins.  pTopStrengths prunes pairs the same way as in CalcTermStrength
+static ErrorEbm CalcAnchorPairStrengths(
+   InteractionShell * const pInteractionShell,
+   const size_t iAnchor,
+   const size_t cPartners,
+   const size_t * const aiPartners,
+   const CalcInteractionFlags flags,
+   const size_t cSamplesLeafMin,
+   TopStrengths * const pTopStrengths,
+   double * const * const apStrengthsOut
+) {
+   EBM_ASSERT(nullptr != pInteractionShell);
+   EBM_ASSERT(size_t { 2 } <= cPartners);
+   EBM_ASSERT(cPartners <= k_cPartnersPerPassMax);
+
+   ErrorEbm error;
+
+   InteractionCore * const pInteractionCore = pInteractionShell->GetInteractionCore();
+   const FeatureInteraction * const aFeatures = pInteractionCore->GetFeatures();
+   const size_t cScores = pInteractionCore->GetCountScores();
+   const bool bHessian = pInteractionCore->IsHessian();
+   EBM_ASSERT(size_t { 1 } <= cScores);
+
+   const FeatureInteraction * const pAnchor = &aFeatures[iAnchor];
+   const size_t cAnchorBins = pAnchor->GetCountBins();
+
+   // for a pair, TensorTotalsBuild needs 1 + cAnchorBins auxiliary bins
+   static constexpr size_t cAuxillaryBinsForSplitting = 4;
+   const size_t cAuxillaryBins = EbmMax(size_t { 1 } + cAnchorBins, cAuxillaryBinsForSplitting);
+
+   size_t acTensorBins[k_cPartnersPerPassMax];
+   size_t cTotalTensorBins = 0;
+   size_t iPartner = 0;
+   do {
+      acTensorBins[iPartner] = cAnchorBins * aFeatures[aiPartners[iPartner]].GetCountBins();
+      cTotalTensorBins += acTensorBins[iPartner];
+      ++iPartner;
+   } while(cPartners != iPartner);
+   // the tensors are limited to k_cAnchorTensorBinsMax bins in total, so none of the sizes below can overflow
+   EBM_ASSERT(cTotalTensorBins <= k_cAnchorTensorBinsMax);
+
+   // the main bins of each pair are its tensor followed by its auxiliary bins, and the pairs follow each other
+   const size_t cBytesPerMainBin = GetBinSize<FloatMain, UIntMain>(bHessian, cScores);
+   BinBase * const aMainBins =
+      pInteractionShell->GetInteractionMainBins(cBytesPerMainBin, cTotalTensorBins + cAuxillaryBins * cPartners);
+   if(UNLIKELY(nullptr == aMainBins)) {
+      // already logged
+      return Error_OutOfMemory;
+   }
+   BinBase * apMainBins[k_cPartnersPerPassMax];
+   size_t cBytesMainOffset = 0;
+   iPartner = 0;
+   do {
+      BinBase * const aPairMainBins = IndexBin(aMainBins, cBytesMainOffset);
+      apMainBins[iPartner] = aPairMainBins;
+      memset(aPairMainBins, 0, cBytesPerMainBin * acTensorBins[iPartner]);
+      cBytesMainOffset += cBytesPerMainBin * (acTensorBins[iPartner] + cAuxillaryBins);
+      ++iPartner;
+   } while(cPartners != iPartner);
+
+   BinSumsInteractionBridge binSums;
+   binSums.m_cRuntimeRealDimensions = 1;
+   binSums.m_acBins[0] = cAnchorBins;
+   binSums.m_bHessian = bHessian ? EBM_TRUE : EBM_FALSE;
+   binSums.m_cScores = cScores;
+   binSums.m_cPartners = cPartners;
+
+   EBM_ASSERT(1 <= pInteractionCore->GetDataSetInteraction()->GetCountSubsets());
+   DataSubsetInteraction * pSubset = pInteractionCore->GetDataSetInteraction()->GetSubsets();
+   const DataSubsetInteraction * const pSubsetsEnd = pSubset + pInteractionCore->GetDataSetInteraction()->GetCountSubsets();
+   do {
+      const size_t cBytesPerFastBin = GetFastBinSize(pSubset, bHessian, cScores);
+      const size_t cUIntBytes = pSubset->GetObjectiveWrapper()->m_cUIntBytes;
+
+      // round the fast bins of each pair up so that every pair starts aligned for SIMD
+      size_t acBytesFastBins[k_cPartnersPerPassMax];
+      size_t cBytesFastBins = 0;
+      iPartner = 0;
+      do {
+         const size_t cBytes = cBytesPerFastBin * acTensorBins[iPartner];
+         acBytesFastBins[iPartner] = (cBytes + (SIMD_BYTE_ALIGNMENT - 1)) & ~(SIMD_BYTE_ALIGNMENT - 1);
+         cBytesFastBins += acBytesFastBins[iPartner];
+         ++iPartner;
+      } while(cPartners != iPartner);
+
+      // this doesn't need to be freed since it's tracked and re-used by the class InteractionShell
+      BinBase * const aFastBins = pInteractionShell->GetInteractionFastBinsTemp(cBytesFastBins);
+      if(UNLIKELY(nullptr == aFastBins)) {
+         // already logged
+         return Error_OutOfMemory;
+      }
 
-      // TODO: handle interaction detection for higher dimensions
+      EBM_ASSERT(1 <= pAnchor->GetBitsRequiredMin());
+      binSums.m_aaPacked[0] = pSubset->GetFeatureData(iAnchor);
+      binSums.m_acItemsPerBitPack[0] = GetCountItemsBitPacked(pAnchor->GetBitsRequiredMin(), cUIntBytes);
+
+      size_t cBytesFastOffset = 0;
+      iPartner = 0;
+      do {
+         const size_t iFeature = aiPartners[iPartner];
+         const FeatureInteraction * const pFeature = &aFeatures[iFeature];
 
-      // for now, just return any interactions that have other than 2 dimensions as k_illegalGainDouble, 
-      // which means they won't be considered but indicates they were not handled
+         BinBase * const aPairFastBins = IndexBin(aFastBins, cBytesFastOffset);
+         aPairFastBins->ZeroMem(cBytesPerFastBin, acTensorBins[iPartner]);
+         cBytesFastOffset += acBytesFastBins[iPartner];
+
+         EBM_ASSERT(1 <= pFeature->GetBitsRequiredMin());
+         binSums.m_acPartnerBins[iPartner] = pFeature->GetCountBins();
+         binSums.m_acPartnerItemsPerBitPack[iPartner] = GetCountItemsBitPacked(pFeature->GetBitsRequiredMin(), cUIntBytes);
+         binSums.m_aaPartnerPacked[iPartner] = pSubset->GetFeatureData(iFeature);
+         binSums.m_aaPartnerFastBins[iPartner] = aPairFastBins;
+
+         ++iPartner;
+      } while(cPartners != iPartner);
+
+      binSums.m_cSamples = pSubset->GetCountSamples();
+      binSums.m_aGradientsAndHessians = pSubset->GetGradHess();
+      binSums.m_aWeights = pSubset->GetWeights();
+
+      binSums.m_aFastBins = aFastBins;
+#ifndef NDEBUG
+      binSums.m_pDebugFastBinsEnd = IndexBin(aFastBins, cBytesFastBins);
+#endif // NDEBUG
+
+      error = pSubset->BinSumsInteraction(&binSums);
+      if(Error_None != error) {
+         return error;
+      }
+
+      iPartner = 0;
+      do {
+         ConvertAddBin(
+            cScores,
+            bHessian,
+            acTensorBins[iPartner],
+            sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes,
+            sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes,
+            binSums.m_aaPartnerFastBins[iPartner],
+            std::is_same<UIntMain, uint64_t>::value,
+            std::is_same<FloatMain, double>::value,
+            apMainBins[iPartner]
+         );
+         ++iPartner;
+      } while(cPartners != iPartner);
+
+      ++pSubset;
+   } while(pSubsetsEnd != pSubset);
+
+   size_t aiOrder[k_cPartnersPerPassMax];
+   double aBounds[k_cPartnersPerPassMax];
+   iPartner = 0;
+   do {
+      aiOrder[iPartner] = iPartner;
+      aBounds[iPartner] = std::numeric_limits<double>::infinity();
+      ++iPartner;
+   } while(cPartners != iPartner);
+
+   if(nullptr != pTopStrengths &&
+      0 == (static_cast<UCalcInteractionFlags>(flags) & static_cast<UCalcInteractionFlags>(CalcInteractionFlags_Pure))) {
+      iPartner = 0;
+      do {
+         const size_t acBins[2] = { cAnchorBins, aFeatures[aiPartners[iPartner]].GetCountBins() };
+         aBounds[iPartner] = CalcPairStrengthBound(pInteractionCore, acBins, flags, cAuxillaryBins, apMainBins[iPartner]);
+         ++iPartner;
+      } while(cPartners != iPartner);
+
+      // the pairs with the highest bounds are most likely to be strong, so calculate them first to prune the rest
+      std::sort(aiOrder, aiOrder + cPartners, [&aBounds](const size_t iPartner1, const size_t iPartner2) {
+         return aBounds[iPartner2] < aBounds[iPartner1] ||
+            (aBounds[iPartner1] == aBounds[iPartner2] && iPartner1 < iPartner2);
+      });
    }
 
+   size_t iOrder = 0;
+   do {
+      iPartner = aiOrder[iOrder];
+      *apStrengthsOut[iPartner] = k_illegalGainDouble;
+      if(nullptr == pTopStrengths || !PruneTerm(pTopStrengths, aBounds[iPartner])) {
+         const size_t acBins[2] = { cAnchorBins, aFeatures[aiPartners[iPartner]].GetCountBins() };
+         const double strength = CalcStrengthFromMainBins(
+            pInteractionCore,
+            2,
+            acBins,
+            flags,
+            cSamplesLeafMin,
+            acTensorBins[iPartner],
+            cAuxillaryBins,
+            apMainBins[iPartner]
 #ifndef NDEBUG
-   free(aDebugCopyBins);
+            , IndexBin(apMainBins[iPartner], cBytesPerMainBin * (acTensorBins[iPartner] + cAuxillaryBins))
 #endif // NDEBUG
+         );
+         *apStrengthsOut[iPartner] = strength;
+         if(nullptr != pTopStrengths) {
+            AddTopStrength(pTopStrengths, strength);
+         }
+      }
+      ++iOrder;
+   } while(cPartners != iOrder);
 
    return Error_None;
 }
 
+struct CalcInteractionStrengthsContext final {
+   InteractionShell * m_pInteractionShell;
+   // the InteractionShell of thread iThread is m_aThreadShells[iThread - 1] for threads other than the caller
+   InteractionShell * m_aThreadShells;
+   const IntEbm * m_acDimensions;
+   const size_t * m_aiFirstFeatures;
+   const IntEbm * m_aFeatureIndexes;
+   // task i calculates the terms m_aiTaskTerms[m_aiTaskStarts[i]] up to m_aiTaskTerms[m_aiTaskStarts[i + 1]]. Tasks
+   // with several terms are pairs that share their anchor
+   const size_t * m_aiTaskTerms;
+   const size_t * m_aiTaskStarts;
+   CalcInteractionFlags m_flags;
+   size_t m_cCardinalityMax;
+   size_t m_cSamplesLeafMin;
+   // the TopStrengths of each thread when pruning, otherwise nullptr
+   TopStrengths * m_aTopStrengths;
+   double * m_aStrengthsOut;
+};
+
+static ErrorEbm CalcTermStrengthTask(void * const pContextVoid, const size_t iTask, const size_t iThread) {
+   const CalcInteractionStrengthsContext * const pContext =
+      static_cast<const CalcInteractionStrengthsContext *>(pContextVoid);
+
+   InteractionShell * const pInteractionShell =
+      size_t { 0 } == iThread ? pContext->m_pInteractionShell : &pContext->m_aThreadShells[iThread - 1];
+
+   TopStrengths * const pTopStrengths =
+      nullptr == pContext->m_aTopStrengths ? nullptr : &pContext->m_aTopStrengths[iThread];
+
+   const size_t iStart = pContext->m_aiTaskStarts[iTask];
+   const size_t cTaskTerms = pContext->m_aiTaskStarts[iTask + 1] - iStart;
+   const size_t * const aiTerms = &pContext->m_aiTaskTerms[iStart];
+
+   if(size_t { 1 } == cTaskTerms) {
+      const size_t iTerm = aiTerms[0];
+      return CalcTermStrength(
+         pInteractionShell,
+         static_cast<size_t>(pContext->m_acDimensions[iTerm]),
+         &pContext->m_aFeatureIndexes[pContext->m_aiFirstFeatures[iTerm]],
+         pContext->m_flags,
+         pContext->m_cCardinalityMax,
+         pContext->m_cSamplesLeafMin,
+         pTopStrengths,
+         &pContext->m_aStrengthsOut[iTerm]
+      );
+   }
+
+   size_t aiPartners[k_cPartnersPerPassMax];
+   double * apStrengthsOut[k_cPartnersPerPassMax];
+   for(size_t iTaskTerm = 0; iTaskTerm < cTaskTerms; ++iTaskTerm) {
+      const size_t iTerm = aiTerms[iTaskTerm];
+      aiPartners[iTaskTerm] =
+         static_cast<size_t>(pContext->m_aFeatureIndexes[pContext->m_aiFirstFeatures[iTerm] + size_t { 1 }]);
+      apStrengthsOut[iTaskTerm] = &pContext->m_aStrengthsOut[iTerm];
+   }
+   return CalcAnchorPairStrengths(
+      pInteractionShell,
+      static_cast<size_t>(pContext->m_aFeatureIndexes[pContext->m_aiFirstFeatures[aiTerms[0]]]),
+      cTaskTerms,
+      aiPartners,
+      pContext->m_flags,
+      pContext->m_cSamplesLeafMin,
+      pTopStrengths,
+      apStrengthsOut
+   );
+}
+
+struct TermStrength final {
+   double m_strength;
+   size_t m_iTerm;
+};
+static_assert(std::is_standard_layout<TermStrength>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<TermStrength>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+// stronger terms come first, and for equal strengths the lower term index comes first, so the order is total and
+// the top terms do not depend on which thread calculated them
+static bool IsStrongerTerm(const TermStrength & lhs, const TermStrength & rhs) {
+   return rhs.m_strength < lhs.m_strength || (lhs.m_strength == rhs.m_strength && lhs.m_iTerm < rhs.m_iTerm);
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrengths(
+   InteractionHandle interactionHandle,
+   IntEbm countTerms,
+   const IntEbm * dimensionCounts,
+   const IntEbm * featureIndexes,
+   CalcInteractionFlags flags,
+   IntEbm maxCardinality,
+   IntEbm minSamplesLeaf,
+   IntEbm countTopTerms,
+   IntEbm * topTermIndexesOut,
+   double * strengthsOut,
+   IntEbm * countPrunedTermsOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogCalcInteractionStrengths,
+      Trace_Info,
+      Trace_Verbose,
+      "CalcInteractionStrengths: "
+      "interactionHandle=%p, "
+      "countTerms=%" IntEbmPrintf ", "
+      "dimensionCounts=%p, "
+      "featureIndexes=%p, "
+      "flags=0x%" UCalcInteractionFlagsPrintf ", "
+      "maxCardinality=%" IntEbmPrintf ", "
+      "minSamplesLeaf=%" IntEbmPrintf ", "
+      "countTopTerms=%" IntEbmPrintf ", "
+      "topTermIndexesOut=%p, "
+      "strengthsOut=%p, "
+      "countPrunedTermsOut=%p"
+      ,
+      static_cast<void *>(interactionHandle),
+      countTerms,
+      static_cast<const void *>(dimensionCounts),
+      static_cast<const void *>(featureIndexes),
+      static_cast<UCalcInteractionFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      maxCardinality,
+      minSamplesLeaf,
+      countTopTerms,
+      static_cast<void *>(topTermIndexesOut),
+      static_cast<void *>(strengthsOut),
+      static_cast<void *>(countPrunedTermsOut)
+   );
+
+   if(nullptr != countPrunedTermsOut) {
+      *countPrunedTermsOut = IntEbm { 0 };
+   }
+
+   InteractionShell * const pInteractionShell = InteractionShell::GetInteractionShellFromHandle(interactionHandle);
+   if(nullptr == pInteractionShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   if(countTerms < IntEbm { 0 } || IsConvertError<size_t>(countTerms)) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths countTerms must be a non-negative size_t");
+      return Error_IllegalParamVal;
+   }
+   const size_t cTerms = static_cast<size_t>(countTerms);
+
+   if(countTopTerms < IntEbm { 0 } || IsConvertError<size_t>(countTopTerms)) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths countTopTerms must be a non-negative size_t");
+      return Error_IllegalParamVal;
+   }
+   const size_t cTopTerms = static_cast<size_t>(countTopTerms);
+
+   // with zero countTopTerms strengthsOut receives the strength of every term, otherwise the top terms
+   const size_t cOut = size_t { 0 } == cTopTerms ? cTerms : cTopTerms;
+   if(size_t { 0 } == cOut) {
+      LOG_0(Trace_Info, "INFO CalcInteractionStrengths no terms");
+      return Error_None;
+   }
+   if(nullptr == strengthsOut || (size_t { 0 } != cTopTerms && nullptr == topTermIndexesOut)) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths the output arrays cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+   for(size_t iOut = 0; iOut < cOut; ++iOut) {
+      strengthsOut[iOut] = k_illegalGainDouble;
+   }
+   if(size_t { 0 } != cTopTerms) {
+      for(size_t iOut = 0; iOut < cTopTerms; ++iOut) {
+         topTermIndexesOut[iOut] = IntEbm { -1 };
+      }
+   }
+   if(size_t { 0 } == cTerms) {
+      LOG_0(Trace_Info, "INFO CalcInteractionStrengths no terms");
+      return Error_None;
+   }
+   if(nullptr == dimensionCounts) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths dimensionCounts cannot be nullptr if 0 < countTerms");
+      return Error_IllegalParamVal;
+   }
+
+   size_t cCardinalityMax;
+   size_t cSamplesLeafMin;
+   ConvertInteractionParams(flags, maxCardinality, minSamplesLeaf, &cCardinalityMax, &cSamplesLeafMin);
+
+   // the number of threads is limited by the number of tasks, which is at most the number of terms
+   const size_t cThreadsMax = EbmMin(ThreadPool::GetCountThreadsConfig(), cTerms);
+
+   // when only some of the terms are kept, pairs whose strength cannot reach the top terms are pruned before
+   // sweeping their cuts.  Purified gain has no cheap bound, so those pairs are always calculated in full
+   const size_t cHeap = EbmMin(cTopTerms, cTerms);
+   const bool bPrune = size_t { 0 } != cTopTerms && cHeap < cTerms &&
+      0 == (static_cast<UCalcInteractionFlags>(flags) & static_cast<UCalcInteractionFlags>(CalcInteractionFlags_Pure));
+
+   // one allocation holds the extra InteractionShells, then for each term the index of its first feature, the terms
+   // sorted into tasks, the anchor and tensor bin count used for sorting them, and the start of each task.  When only
+   // the top terms are kept, the strengths of all the terms and the heap of the top terms follow, and when pruning
+   // the TopStrengths of each thread and their heaps come last
+   static constexpr size_t cIndexArrays = 5;
+   const size_t cBytesStrengths = size_t { 0 } == cTopTerms ? size_t { 0 } : sizeof(double);
+   const size_t cBytesPerTerm = sizeof(size_t) * cIndexArrays + cBytesStrengths;
+   const size_t cBytesPerThreadTop = bPrune ? sizeof(TopStrengths) + sizeof(double) * cHeap : size_t { 0 };
+   if(IsMultiplyError(sizeof(InteractionShell), cThreadsMax) || IsMultiplyError(cBytesPerTerm, cTerms) ||
+      IsMultiplyError(cBytesPerThreadTop, cThreadsMax) ||
+      IsAddError(sizeof(InteractionShell) * cThreadsMax, cBytesPerTerm * cTerms, sizeof(size_t),
+         sizeof(TermStrength) * cHeap, cBytesPerThreadTop * cThreadsMax)) {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths the terms are too large for memory");
+      return Error_OutOfMemory;
+   }
+   const size_t cBytesShells = sizeof(InteractionShell) * (cThreadsMax - size_t { 1 });
+   char * const aMem = static_cast<char *>(malloc(cBytesShells + cBytesPerTerm * cTerms + sizeof(size_t) +
+      sizeof(TermStrength) * cHeap + cBytesPerThreadTop * cThreadsMax));
+   if(nullptr == aMem) {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths nullptr == aMem");
+      return Error_OutOfMemory;
+   }
+   InteractionShell * const aThreadShells = reinterpret_cast<InteractionShell *>(aMem);
+   size_t * const aiFirstFeatures = reinterpret_cast<size_t *>(aMem + cBytesShells);
+   size_t * const aiTaskTerms = aiFirstFeatures + cTerms;
+   size_t * const aiAnchors = aiTaskTerms + cTerms;
+   size_t * const acTensorBins = aiAnchors + cTerms;
+   size_t * const aiTaskStarts = acTensorBins + cTerms;
+   char * const pAfterIndexes = reinterpret_cast<char *>(aiTaskStarts + cTerms + size_t { 1 });
+   double * const aStrengths = size_t { 0 } == cTopTerms ? strengthsOut : reinterpret_cast<double *>(pAfterIndexes);
+   TermStrength * const aHeap = reinterpret_cast<TermStrength *>(pAfterIndexes + cBytesStrengths * cTerms);
+   TopStrengths * const aTopStrengths = bPrune ? reinterpret_cast<TopStrengths *>(aHeap + cHeap) : nullptr;
+
+   ErrorEbm error = Error_None;
+   size_t cTasks = 0;
+   size_t cThreads;
+
+   size_t iFirstFeature = 0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const IntEbm countDimensions = dimensionCounts[iTerm];
+      if(countDimensions < IntEbm { 0 }) {
+         LOG_0(Trace_Error, "ERROR CalcInteractionStrengths dimensionCounts value cannot be negative");
+         error = Error_IllegalParamVal;
+         goto exit_free;
+      }
+      if(IntEbm { k_cDimensionsMax } < countDimensions) {
+         LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths countDimensions too large and would cause out of memory condition");
+         error = Error_OutOfMemory;
+         goto exit_free;
+      }
+      if(IntEbm { 0 } != countDimensions && nullptr == featureIndexes) {
+         LOG_0(Trace_Error, "ERROR CalcInteractionStrengths featureIndexes cannot be nullptr if there are dimensions");
+         error = Error_IllegalParamVal;
+         goto exit_free;
+      }
+      aiFirstFeatures[iTerm] = iFirstFeature;
+      // cannot overflow since each term adds at most k_cDimensionsMax and the caller's array fits in memory
+      iFirstFeature += static_cast<size_t>(countDimensions);
+   }
+
+   {
+      // group the pairs by their anchor so that each group is binned in one pass over the data.  Everything else is
+      // a task of its own.  The grouping only changes how the bins are summed, not the strengths
+      InteractionCore * const pInteractionCore = pInteractionShell->GetInteractionCore();
+      const bool bGroupPairs = size_t { 0 } != pInteractionCore->GetCountScores() &&
+         size_t { 0 } != pInteractionCore->GetDataSetInteraction()->GetCountSamples();
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         aiTaskTerms[iTerm] = iTerm;
+         const IntEbm * const pFeatureIndexes = nullptr == featureIndexes ? nullptr : &featureIndexes[aiFirstFeatures[iTerm]];
+         const size_t cTensorBins = !bGroupPairs ? size_t { 0 } : GetAnchorPairTensorBins(
+            pInteractionCore, static_cast<size_t>(dimensionCounts[iTerm]), pFeatureIndexes, cCardinalityMax);
+         acTensorBins[iTerm] = cTensorBins;
+         aiAnchors[iTerm] = size_t { 0 } == cTensorBins ? std::numeric_limits<size_t>::max() :
+            static_cast<size_t>(pFeatureIndexes[0]);
+      }
+      std::sort(aiTaskTerms, aiTaskTerms + cTerms, [aiAnchors](const size_t iTerm1, const size_t iTerm2) {
+         return aiAnchors[iTerm1] < aiAnchors[iTerm2] || (aiAnchors[iTerm1] == aiAnchors[iTerm2] && iTerm1 < iTerm2);
+      });
+   }
+
+   {
+      size_t iSorted = 0;
+      do {
+         aiTaskStarts[cTasks] = iSorted;
+         ++cTasks;
+         const size_t iTermFirst = aiTaskTerms[iSorted];
+         ++iSorted;
+         if(size_t { 0 } != acTensorBins[iTermFirst]) {
+            const size_t iAnchor = aiAnchors[iTermFirst];
+            size_t cGroupTensorBins = acTensorBins[iTermFirst];
+            size_t cGroup = 1;
+            while(iSorted != cTerms && cGroup != k_cPartnersPerPassMax) {
+               const size_t iTerm = aiTaskTerms[iSorted];
+               if(iAnchor != aiAnchors[iTerm] || k_cAnchorTensorBinsMax - cGroupTensorBins < acTensorBins[iTerm]) {
+                  break;
+               }
+               cGroupTensorBins += acTensorBins[iTerm];
+               ++cGroup;
+               ++iSorted;
+            }
+         }
+      } while(cTerms != iSorted);
+      aiTaskStarts[cTasks] = cTerms;
+   }
+
+   cThreads = EbmMin(cThreadsMax, cTasks);
+   for(size_t iThread = 1; iThread < cThreads; ++iThread) {
+      aThreadShells[iThread - 1].InitializeUnfailing(pInteractionShell->GetInteractionCore());
+   }
+   if(nullptr != aTopStrengths) {
+      double * const aTopHeaps = reinterpret_cast<double *>(aTopStrengths + cThreadsMax);
+      for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+         aTopStrengths[iThread].m_cHeap = cHeap;
+         aTopStrengths[iThread].m_cUsed = 0;
+         aTopStrengths[iThread].m_aHeap = aTopHeaps + cHeap * iThread;
+         aTopStrengths[iThread].m_cPruned = 0;
+      }
+   }
+
+   {
+      ThreadPool * pThreadPool = nullptr;
+      error = ThreadPool::Create(cThreads, &pThreadPool);
+      if(Error_None == error) {
+         CalcInteractionStrengthsContext context;
+         context.m_pInteractionShell = pInteractionShell;
+         context.m_aThreadShells = aThreadShells;
+         context.m_acDimensions = dimensionCounts;
+         context.m_aiFirstFeatures = aiFirstFeatures;
+         context.m_aFeatureIndexes = featureIndexes;
+         context.m_aiTaskTerms = aiTaskTerms;
+         context.m_aiTaskStarts = aiTaskStarts;
+         context.m_flags = flags;
+         context.m_cCardinalityMax = cCardinalityMax;
+         context.m_cSamplesLeafMin = cSamplesLeafMin;
+         context.m_aTopStrengths = aTopStrengths;
+         context.m_aStrengthsOut = aStrengths;
+
+         error = pThreadPool->Run(cTasks, CalcTermStrengthTask, &context);
+
+         ThreadPool::Free(pThreadPool);
+      }
+   }
+
+   for(size_t iThread = 1; iThread < cThreads; ++iThread) {
+      aThreadShells[iThread - 1].FreeBins();
+   }
+
+   if(Error_None == error && nullptr != aTopStrengths) {
+      size_t cPruned = 0;
+      for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+         cPruned += aTopStrengths[iThread].m_cPruned;
+      }
+      LOG_N(Trace_Info, "INFO CalcInteractionStrengths pruned %zu of %zu terms", cPruned, cTerms);
+      if(nullptr != countPrunedTermsOut) {
+         *countPrunedTermsOut = static_cast<IntEbm>(cPruned);
+      }
+   }
+
+   if(Error_None == error && size_t { 0 } != cTopTerms) {
+      // keep the top terms in a heap whose front is the weakest of them
+      size_t cHeapUsed = 0;
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         TermStrength item;
+         item.m_strength = aStrengths[iTerm];
+         item.m_iTerm = iTerm;
+         if(cHeapUsed < cHeap) {
+            aHeap[cHeapUsed] = item;
+            ++cHeapUsed;
+            std::push_heap(aHeap, aHeap + cHeapUsed, IsStrongerTerm);
+         } else if(IsStrongerTerm(item, aHeap[0])) {
+            std::pop_heap(aHeap, aHeap + cHeapUsed, IsStrongerTerm);
+            aHeap[cHeapUsed - 1] = item;
+            std::push_heap(aHeap, aHeap + cHeapUsed, IsStrongerTerm);
+         }
+      }
+      std::sort_heap(aHeap, aHeap + cHeapUsed, IsStrongerTerm);
+      for(size_t iOut = 0; iOut < cHeapUsed; ++iOut) {
+         topTermIndexesOut[iOut] = static_cast<IntEbm>(aHeap[iOut].m_iTerm);
+         strengthsOut[iOut] = aHeap[iOut].m_strength;
+      }
+   }
+
+exit_free:;
+   free(aMem);
+
+   LOG_N(Trace_Info, "Exited CalcInteractionStrengths: error=%" ErrorEbmPrintf, error);
+   return error;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrengthsRefined(
+   InteractionHandle subsampleInteractionHandle,
+   InteractionHandle interactionHandle,
+   IntEbm countTerms,
+   const IntEbm * dimensionCounts,
+   const IntEbm * featureIndexes,
+   CalcInteractionFlags flags,
+   IntEbm maxCardinality,
+   IntEbm minSamplesLeaf,
+   IntEbm countRefinedTerms,
+   IntEbm countTopTerms,
+   IntEbm * topTermIndexesOut,
+   double * strengthsOut,
+   IntEbm * refinedTermIndexesOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogCalcInteractionStrengthsRefined,
+      Trace_Info,
+      Trace_Verbose,
+      "CalcInteractionStrengthsRefined: "
+      "subsampleInteractionHandle=%p, "
+      "interactionHandle=%p, "
+      "countTerms=%" IntEbmPrintf ", "
+      "dimensionCounts=%p, "
+      "featureIndexes=%p, "
+      "flags=0x%" UCalcInteractionFlagsPrintf ", "
+      "maxCardinality=%" IntEbmPrintf ", "
+      "minSamplesLeaf=%" IntEbmPrintf ", "
+      "countRefinedTerms=%" IntEbmPrintf ", "
+      "countTopTerms=%" IntEbmPrintf ", "
+      "topTermIndexesOut=%p, "
+      "strengthsOut=%p, "
+      "refinedTermIndexesOut=%p"
+      ,
+      static_cast<void *>(subsampleInteractionHandle),
+      static_cast<void *>(interactionHandle),
+      countTerms,
+      static_cast<const void *>(dimensionCounts),
+      static_cast<const void *>(featureIndexes),
+      static_cast<UCalcInteractionFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      maxCardinality,
+      minSamplesLeaf,
+      countRefinedTerms,
+      countTopTerms,
+      static_cast<void *>(topTermIndexesOut),
+      static_cast<void *>(strengthsOut),
+      static_cast<void *>(refinedTermIndexesOut)
+   );
+
+   if(countTopTerms <= IntEbm { 0 } || IsConvertError<size_t>(countTopTerms)) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengthsRefined countTopTerms must be a positive size_t");
+      return Error_IllegalParamVal;
+   }
+   const size_t cTopTerms = static_cast<size_t>(countTopTerms);
+
+   if(countRefinedTerms < countTopTerms || IsConvertError<size_t>(countRefinedTerms)) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengthsRefined countRefinedTerms must be a size_t no less than countTopTerms");
+      return Error_IllegalParamVal;
+   }
+   const size_t cRefinedTermsMax = static_cast<size_t>(countRefinedTerms);
+
+   if(nullptr == topTermIndexesOut || nullptr == strengthsOut) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengthsRefined the output arrays cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+   for(size_t iOut = 0; iOut < cTopTerms; ++iOut) {
+      topTermIndexesOut[iOut] = IntEbm { -1 };
+      strengthsOut[iOut] = k_illegalGainDouble;
+   }
+   if(nullptr != refinedTermIndexesOut) {
+      for(size_t iOut = 0; iOut < cRefinedTermsMax; ++iOut) {
+         refinedTermIndexesOut[iOut] = IntEbm { -1 };
+      }
+   }
+
+   InteractionShell * const pSubsampleInteractionShell =
+      InteractionShell::GetInteractionShellFromHandle(subsampleInteractionHandle);
+   if(nullptr == pSubsampleInteractionShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+   InteractionShell * const pInteractionShell = InteractionShell::GetInteractionShellFromHandle(interactionHandle);
+   if(nullptr == pInteractionShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+   InteractionCore * const pSubsampleInteractionCore = pSubsampleInteractionShell->GetInteractionCore();
+   InteractionCore * const pInteractionCore = pInteractionShell->GetInteractionCore();
+   if(pSubsampleInteractionCore->GetCountFeatures() != pInteractionCore->GetCountFeatures()) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengthsRefined the interaction detectors must have the same features");
+      return Error_IllegalParamVal;
+   }
+
+   if(countTerms < IntEbm { 0 } || IsConvertError<size_t>(countTerms)) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengthsRefined countTerms must be a non-negative size_t");
+      return Error_IllegalParamVal;
+   }
+   const size_t cTerms = static_cast<size_t>(countTerms);
+   if(size_t { 0 } == cTerms) {
+      LOG_0(Trace_Info, "INFO CalcInteractionStrengthsRefined no terms");
+      return Error_None;
+   }
+   if(nullptr == dimensionCounts) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengthsRefined dimensionCounts cannot be nullptr if 0 < countTerms");
+      return Error_IllegalParamVal;
+   }
+
+   const size_t cRefinedTerms = EbmMin(cRefinedTermsMax, cTerms);
+
+   // minSamplesLeaf counts samples, so scale it down to the size of the subsample to keep the same cuts legal
+   IntEbm minSamplesLeafSubsample = minSamplesLeaf;
+   const size_t cSamples = pInteractionCore->GetDataSetInteraction()->GetCountSamples();
+   if(IntEbm { 1 } < minSamplesLeaf && size_t { 0 } != cSamples) {
+      const double scaled = std::ceil(static_cast<double>(minSamplesLeaf) *
+         static_cast<double>(pSubsampleInteractionCore->GetDataSetInteraction()->GetCountSamples()) /
+         static_cast<double>(cSamples));
+      minSamplesLeafSubsample = scaled < static_cast<double>(minSamplesLeaf) ?
+         EbmMax(IntEbm { 1 }, static_cast<IntEbm>(scaled)) : minSamplesLeaf;
+   }
+
+   // one allocation holds the first feature of each term, then the candidate term indexes with their approximate
+   // strengths, the dimension counts of the candidates and their strengths on all the samples, then the candidates
+   // sorted by those strengths, and lastly the feature indexes of the candidates
+   if(IsMultiplyError(sizeof(size_t), cTerms) ||
+      IsMultiplyError(sizeof(IntEbm) * 2 + sizeof(double) * 2 + sizeof(TermStrength) +
+         sizeof(IntEbm) * k_cDimensionsMax, cRefinedTerms) ||
+      IsAddError(sizeof(size_t) * cTerms, (sizeof(IntEbm) * 2 + sizeof(double) * 2 + sizeof(TermStrength) +
+         sizeof(IntEbm) * k_cDimensionsMax) * cRefinedTerms)) {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrengthsRefined the terms are too large for memory");
+      return Error_OutOfMemory;
+   }
+   char * const aMem = static_cast<char *>(malloc(sizeof(size_t) * cTerms + (sizeof(IntEbm) * 2 +
+      sizeof(double) * 2 + sizeof(TermStrength) + sizeof(IntEbm) * k_cDimensionsMax) * cRefinedTerms));
+   if(nullptr == aMem) {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrengthsRefined nullptr == aMem");
+      return Error_OutOfMemory;
+   }
+   size_t * const aiFirstFeatures = reinterpret_cast<size_t *>(aMem);
+   double * const aApproxStrengths = reinterpret_cast<double *>(aiFirstFeatures + cTerms);
+   double * const aStrengths = aApproxStrengths + cRefinedTerms;
+   TermStrength * const aSorted = reinterpret_cast<TermStrength *>(aStrengths + cRefinedTerms);
+   IntEbm * const aiCandidates = reinterpret_cast<IntEbm *>(aSorted + cRefinedTerms);
+   IntEbm * const acCandidateDimensions = aiCandidates + cRefinedTerms;
+   IntEbm * const aCandidateFeatureIndexes = acCandidateDimensions + cRefinedTerms;
+
+   ErrorEbm error;
+   size_t cCandidates = 0;
+   size_t cCandidateFeatures = 0;
+
+   if(cRefinedTerms < cTerms) {
+      // rank every term on the subsample and keep the strongest as the candidates.  This also checks the terms
+      error = CalcInteractionStrengths(
+         subsampleInteractionHandle,
+         countTerms,
+         dimensionCounts,
+         featureIndexes,
+         flags,
+         maxCardinality,
+         minSamplesLeafSubsample,
+         static_cast<IntEbm>(cRefinedTerms),
+         aiCandidates,
+         aApproxStrengths,
+         nullptr
+      );
+      if(Error_None != error) {
+         goto exit_free;
+      }
+      while(cCandidates != cRefinedTerms && IntEbm { 0 } <= aiCandidates[cCandidates]) {
+         ++cCandidates;
+      }
+   } else {
+      // every term would be refined, so there is nothing to gain from the subsample
+      LOG_0(Trace_Info, "INFO CalcInteractionStrengthsRefined refining all the terms");
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         const IntEbm countDimensions = dimensionCounts[iTerm];
+         if(countDimensions < IntEbm { 0 } || IntEbm { k_cDimensionsMax } < countDimensions ||
+            (IntEbm { 0 } != countDimensions && nullptr == featureIndexes)) {
+            LOG_0(Trace_Error, "ERROR CalcInteractionStrengthsRefined illegal dimensionCounts value");
+            error = Error_IllegalParamVal;
+            goto exit_free;
+         }
+         aiCandidates[iTerm] = static_cast<IntEbm>(iTerm);
+      }
+      cCandidates = cTerms;
+   }
+
+   {
+      size_t iFirstFeature = 0;
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         aiFirstFeatures[iTerm] = iFirstFeature;
+         iFirstFeature += static_cast<size_t>(dimensionCounts[iTerm]);
+      }
+   }
+   for(size_t iCandidate = 0; iCandidate < cCandidates; ++iCandidate) {
+      const size_t iTerm = static_cast<size_t>(aiCandidates[iCandidate]);
+      const IntEbm countDimensions = dimensionCounts[iTerm];
+      acCandidateDimensions[iCandidate] = countDimensions;
+      for(size_t iDimension = 0; iDimension < static_cast<size_t>(countDimensions); ++iDimension) {
+         aCandidateFeatureIndexes[cCandidateFeatures] = featureIndexes[aiFirstFeatures[iTerm] + iDimension];
+         ++cCandidateFeatures;
+      }
+   }
+
+   if(size_t { 0 } != cCandidates) {
+      error = CalcInteractionStrengths(
+         interactionHandle,
+         static_cast<IntEbm>(cCandidates),
+         acCandidateDimensions,
+         aCandidateFeatureIndexes,
+         flags,
+         maxCardinality,
+         minSamplesLeaf,
+         IntEbm { 0 },
+         nullptr,
+         aStrengths,
+         nullptr
+      );
+      if(Error_None != error) {
+         goto exit_free;
+      }
+   }
+
+   for(size_t iCandidate = 0; iCandidate < cCandidates; ++iCandidate) {
+      aSorted[iCandidate].m_strength = aStrengths[iCandidate];
+      aSorted[iCandidate].m_iTerm = static_cast<size_t>(aiCandidates[iCandidate]);
+      if(nullptr != refinedTermIndexesOut) {
+         refinedTermIndexesOut[iCandidate] = aiCandidates[iCandidate];
+      }
+   }
+   std::sort(aSorted, aSorted + cCandidates, IsStrongerTerm);
+   for(size_t iOut = 0; iOut < EbmMin(cTopTerms, cCandidates); ++iOut) {
+      topTermIndexesOut[iOut] = static_cast<IntEbm>(aSorted[iOut].m_iTerm);
+      strengthsOut[iOut] = aSorted[iOut].m_strength;
+   }
+
+   LOG_N(Trace_Info, "INFO CalcInteractionStrengthsRefined refined %zu of %zu terms", cCandidates, cTerms);
+
+exit_free:;
+   free(aMem);
+
+   LOG_N(Trace_Info, "Exited CalcInteractionStrengthsRefined: error=%" ErrorEbmPrintf, error);
+   return error;
+}
+
 } // DEFINED_ZONE_NAME
@@ -23,6 +23,7 @@
 #include "common.hpp" // IsConvertError
 
 #include "RandomDeterministic.hpp"
+#include "ThreadPool.hpp"
 
 // TODO: check this file for how we handle subnormal numbers.  NEVER RETURN SUBNORMALS!
 
@@ -2473,16 +2474,61 @@ INLINE_RELEASE_UNTEMPLATED static size_t GetUncuttableRangeLengthMin(
 }
 
 // we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
-static int g_cLogEnterCutQuantile = 25;
-static int g_cLogExitCutQuantile = 25;
+// CutQuantileBuffers holds the scratch memory of CutQuantileInternal.  It is only ever grown, so cutting many
+// features with the same buffers reallocates a handful of times instead of twice per feature
+struct CutQuantileBuffers final {
+   CutQuantileBuffers() = default; // preserve our POD status
+   ~CutQuantileBuffers() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
 
-EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
-   IntEbm countSamples,
-   const double * featureVals,
+   inline void SafeInitCutQuantileBuffers() {
+      m_aFeatureVals = nullptr;
+      m_cBytesFeatureVals = 0;
+      m_pMem = nullptr;
+      m_cBytesMem = 0;
+   }
+
+   inline void DestructCutQuantileBuffers() {
+      free(m_pMem);
+      free(m_aFeatureVals);
+   }
+
+   void * m_aFeatureVals;
+   size_t m_cBytesFeatureVals;
+   void * m_pMem;
+   size_t m_cBytesMem;
+};
+static_assert(std::is_standard_layout<CutQuantileBuffers>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<CutQuantileBuffers>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+// returns a buffer of at least cBytes, or nullptr if out of memory.  The previous contents are not kept
+static void * GrowCutQuantileBuffer(void ** const ppBuffer, size_t * const pcBytesBuffer, const size_t cBytes) {
+   EBM_ASSERT(nullptr != ppBuffer);
+   EBM_ASSERT(nullptr != pcBytesBuffer);
+   if(*pcBytesBuffer < cBytes || nullptr == *ppBuffer) {
+      free(*ppBuffer);
+      *pcBytesBuffer = 0;
+      // malloc(0) is allowed to return nullptr, so always ask for at least 1 byte
+      *ppBuffer = malloc(EbmMax(cBytes, size_t { 1 }));
+      if(nullptr == *ppBuffer) {
+         return nullptr;
+      }
+      *pcBytesBuffer = cBytes;
+   }
+   return *ppBuffer;
+}
+
+static ErrorEbm CutQuantileInternal(
+   const IntEbm countSamples,
+   const double * const featureVals,
    IntEbm minSamplesBin,
-   BoolEbm isRounded,
-   IntEbm * countCutsInOut,
-   double * cutsLowerBoundInclusiveOut
+   const BoolEbm isRounded,
+   IntEbm * const countCutsInOut,
+   double * const cutsLowerBoundInclusiveOut,
+   CutQuantileBuffers * const pBuffers
 ) {
    // don't expose this random seed.  It's used to settle tiebreakers and will only make 
    // marginal changes to where the cuts are placed.  Exposing it just means we need to 
@@ -2490,25 +2536,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
    // take a random number to be useful, which would be odd for a preprocessor.
    static constexpr uint64_t seed = 9397611943394063143u;
 
-   LOG_COUNTED_N(
-      &g_cLogEnterCutQuantile,
-      Trace_Info,
-      Trace_Verbose,
-      "Entered CutQuantile: "
-      "countSamples=%" IntEbmPrintf ", "
-      "featureVals=%p, "
-      "minSamplesBin=%" IntEbmPrintf ", "
-      "isRounded=%s, "
-      "countCutsInOut=%p, "
-      "cutsLowerBoundInclusiveOut=%p"
-      ,
-      countSamples,
-      static_cast<const void *>(featureVals),
-      minSamplesBin,
-      ObtainTruth(isRounded),
-      static_cast<void *>(countCutsInOut),
-      static_cast<void *>(cutsLowerBoundInclusiveOut)
-   );
+   EBM_ASSERT(nullptr != pBuffers);
 
    ErrorEbm error;
 
@@ -2546,7 +2574,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
 
          const size_t cSamplesIncludingMissingVals = static_cast<size_t>(countSamples);
 
-
          if(IsMultiplyError(sizeof(double), cSamplesIncludingMissingVals)) {
             LOG_0(Trace_Error, "ERROR CutQuantile IsMultiplyError(sizeof(double), cSamplesIncludingMissingVals)");
 
@@ -2555,7 +2582,8 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
             goto exit_with_log;
          }
          const size_t cBytesFeatureVals = sizeof(double) * cSamplesIncludingMissingVals;
-         double * const aFeatureVals = static_cast<double *>(malloc(cBytesFeatureVals));
+         double * const aFeatureVals = static_cast<double *>(
+            GrowCutQuantileBuffer(&pBuffers->m_aFeatureVals, &pBuffers->m_cBytesFeatureVals, cBytesFeatureVals));
          if(UNLIKELY(nullptr == aFeatureVals)) {
             LOG_0(Trace_Error, "ERROR CutQuantile nullptr == aFeatureVals");
 
@@ -2574,7 +2602,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
          EBM_ASSERT(cSamples <= cSamplesIncludingMissingVals);
 
          if(UNLIKELY(cSamples <= size_t { 1 })) {
-            free(aFeatureVals);
             // we can't really cut 0 or 1 samples.  Now that we know our min, max, etc values, we can exit
             // or if there was only 1 non-missing value
             countCutsRet = IntEbm { 0 };
@@ -2586,7 +2613,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
          const IntEbm countCuts = *countCutsInOut;
 
          if(UNLIKELY(countCuts <= IntEbm { 0 })) {
-            free(aFeatureVals);
             countCutsRet = IntEbm { 0 };
             error = Error_None;
             if(UNLIKELY(countCuts < IntEbm { 0 })) {
@@ -2600,7 +2626,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
             // if we have a potential bin cut, then cutsLowerBoundInclusiveOut shouldn't be nullptr
             LOG_0(Trace_Error, "ERROR CutQuantile nullptr == cutsLowerBoundInclusiveOut");
 
-            free(aFeatureVals);
             countCutsRet = IntEbm { 0 };
             error = Error_IllegalParamVal;
 
@@ -2620,7 +2645,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
             // in order to make any cuts.  Anything less and we should just return now.
             // We also use this as a comparison to ensure that minSamplesBin is convertible to a size_t
 
-            free(aFeatureVals);
             countCutsRet = IntEbm { 0 };
             error = Error_None;
             goto exit_with_log;
@@ -2656,7 +2680,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
          // of pointers below of double * to index into aFeatureVals 
          if(UNLIKELY(IsMultiplyError(std::max(sizeof(*cutsLowerBoundInclusiveOut), sizeof(double *)), cCutsMax))) {
             LOG_0(Trace_Warning, "WARNING CutQuantile IsMultiplyError(std::max(sizeof(*cutsLowerBoundInclusiveOut), sizeof(double *)), cCutsMax)");
-            free(aFeatureVals);
             countCutsRet = IntEbm { 0 };
             error = Error_OutOfMemory;
             goto exit_with_log;
@@ -2683,7 +2706,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
          // cSamples is a size_t
          EBM_ASSERT(cCuttingRanges <= cCutsMax + size_t { 1 });
          if(UNLIKELY(size_t { 0 } == cCuttingRanges)) {
-            free(aFeatureVals);
             countCutsRet = IntEbm { 0 };
             error = Error_None;
             goto exit_with_log;
@@ -2691,7 +2713,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
 
          if(UNLIKELY(IsMultiplyError(sizeof(NeighbourJump), cSamples))) {
             LOG_0(Trace_Warning, "WARNING CutQuantile IsMultiplyError(sizeof(NeighbourJump), cSamples)");
-            free(aFeatureVals);
             countCutsRet = IntEbm { 0 };
             error = Error_OutOfMemory;
             goto exit_with_log;
@@ -2711,7 +2732,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
          const size_t cCutsWithEndpointsMax = cCutsMax + size_t { 2 };
          if(UNLIKELY(IsMultiplyError(sizeof(CutPoint), cCutsWithEndpointsMax))) {
             LOG_0(Trace_Warning, "WARNING CutQuantile IsMultiplyError(sizeof(CutPoint), cCutsWithEndpointsMax)");
-            free(aFeatureVals);
             countCutsRet = IntEbm { 0 };
             error = Error_OutOfMemory;
             goto exit_with_log;
@@ -2720,20 +2740,17 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
 
          if(UNLIKELY(IsMultiplyError(sizeof(CuttingRange), cCuttingRanges))) {
             LOG_0(Trace_Warning, "WARNING CutQuantile IsMultiplyError(sizeof(CuttingRange), cCuttingRanges)");
-            free(aFeatureVals);
             countCutsRet = IntEbm { 0 };
             error = Error_OutOfMemory;
             goto exit_with_log;
          }
          const size_t cBytesCuttingRanges = sizeof(CuttingRange) * cCuttingRanges;
 
-
          const size_t cBytesToNeighbourJump = size_t { 0 };
          const size_t cBytesToValCutPointers = cBytesToNeighbourJump + cBytesNeighbourJumps;
 
          if(UNLIKELY(IsAddError(cBytesToValCutPointers, cBytesValCutPointers))) {
             LOG_0(Trace_Warning, "WARNING CutQuantile IsAddError(cBytesToValCutPointers, cBytesValCutPointers))");
-            free(aFeatureVals);
             countCutsRet = IntEbm { 0 };
             error = Error_OutOfMemory;
             goto exit_with_log;
@@ -2742,7 +2759,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
 
          if(UNLIKELY(IsAddError(cBytesToCuts, cBytesCuts))) {
             LOG_0(Trace_Warning, "WARNING CutQuantile IsAddError(cBytesToCuts, cBytesCuts))");
-            free(aFeatureVals);
             countCutsRet = IntEbm { 0 };
             error = Error_OutOfMemory;
             goto exit_with_log;
@@ -2751,17 +2767,15 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
 
          if(UNLIKELY(IsAddError(cBytesToCuttingRange, cBytesCuttingRanges))) {
             LOG_0(Trace_Warning, "WARNING CutQuantile IsAddError(cBytesToCuttingRange, cBytesCuttingRanges))");
-            free(aFeatureVals);
             countCutsRet = IntEbm { 0 };
             error = Error_OutOfMemory;
             goto exit_with_log;
          }
          const size_t cBytesToEnd = cBytesToCuttingRange + cBytesCuttingRanges;
 
-         char * const pMem = static_cast<char *>(malloc(cBytesToEnd));
+         char * const pMem = static_cast<char *>(GrowCutQuantileBuffer(&pBuffers->m_pMem, &pBuffers->m_cBytesMem, cBytesToEnd));
          if(UNLIKELY(nullptr == pMem)) {
             LOG_0(Trace_Warning, "WARNING CutQuantile nullptr == pMem");
-            free(aFeatureVals);
             countCutsRet = IntEbm { 0 };
             error = Error_OutOfMemory;
             goto exit_with_log;
@@ -2872,9 +2886,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
                   if(Error_None != error) {
                      // any error messages should have been written to the log inside TradeCutSegment
 
-                     free(pMem);
-                     free(aFeatureVals);
-
                      countCutsRet = IntEbm { 0 };
                      goto exit_with_log;
                   }
@@ -3027,18 +3038,12 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
          } catch(const std::bad_alloc &) {
             LOG_0(Trace_Warning, "WARNING CutQuantile out of memory");
 
-            free(pMem);
-            free(aFeatureVals);
-
             countCutsRet = IntEbm { 0 };
             error = Error_OutOfMemory;
             goto exit_with_log;
          } catch(...) {
             LOG_0(Trace_Warning, "WARNING CutQuantile exception");
 
-            free(pMem);
-            free(aFeatureVals);
-
             countCutsRet = IntEbm { 0 };
             error = Error_UnexpectedInternal;
             goto exit_with_log;
@@ -3250,9 +3255,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
          countCutsRet = static_cast<IntEbm>(cCutsRet);
          EBM_ASSERT(countCutsRet <= countCuts);
 
-         free(pMem);
-         free(aFeatureVals);
-
          error = Error_None;
       }
 
@@ -3262,6 +3264,55 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
       *countCutsInOut = countCutsRet;
    }
 
+   return error;
+}
+
+static int g_cLogEnterCutQuantile = 25;
+static int g_cLogExitCutQuantile = 25;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
+   IntEbm countSamples,
+   const double * featureVals,
+   IntEbm minSamplesBin,
+   BoolEbm isRounded,
+   IntEbm * countCutsInOut,
+   double * cutsLowerBoundInclusiveOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogEnterCutQuantile,
+      Trace_Info,
+      Trace_Verbose,
+      "Entered CutQuantile: "
+      "countSamples=%" IntEbmPrintf ", "
+      "featureVals=%p, "
+      "minSamplesBin=%" IntEbmPrintf ", "
+      "isRounded=%s, "
+      "countCutsInOut=%p, "
+      "cutsLowerBoundInclusiveOut=%p"
+      ,
+      countSamples,
+      static_cast<const void *>(featureVals),
+      minSamplesBin,
+      ObtainTruth(isRounded),
+      static_cast<void *>(countCutsInOut),
+      static_cast<void *>(cutsLowerBoundInclusiveOut)
+   );
+
+   CutQuantileBuffers buffers;
+   buffers.SafeInitCutQuantileBuffers();
+
+   const ErrorEbm error = CutQuantileInternal(
+      countSamples,
+      featureVals,
+      minSamplesBin,
+      isRounded,
+      countCutsInOut,
+      cutsLowerBoundInclusiveOut,
+      &buffers
+   );
+
+   buffers.DestructCutQuantileBuffers();
+
    LOG_COUNTED_N(
       &g_cLogExitCutQuantile,
       Trace_Info,
@@ -3270,11 +3321,171 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
       "countCuts=%" IntEbmPrintf ", "
       "return=%" ErrorEbmPrintf
       ,
-      countCutsRet,
+      nullptr == countCutsInOut ? IntEbm { 0 } : *countCutsInOut,
       error
    );
 
    return error;
 }
 
+struct CutQuantilesContext final {
+   IntEbm m_countSamples;
+   const double * m_aFeatureVals;
+   const IntEbm * m_aMinSamplesBin;
+   BoolEbm m_isRounded;
+   IntEbm * m_aCountCuts;
+   double * m_aCuts;
+   // the cuts of feature i start at m_aCuts + m_aiFirstCuts[i]
+   const size_t * m_aiFirstCuts;
+   // each thread reuses its own buffers for all of the features that it cuts
+   CutQuantileBuffers * m_aBuffers;
+};
+static_assert(std::is_standard_layout<CutQuantilesContext>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<CutQuantilesContext>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+static ErrorEbm CutQuantileTask(void * const pContextVoid, const size_t iTask, const size_t iThread) {
+   const CutQuantilesContext * const pContext = static_cast<const CutQuantilesContext *>(pContextVoid);
+
+   const size_t cSamples = static_cast<size_t>(pContext->m_countSamples);
+   return CutQuantileInternal(
+      pContext->m_countSamples,
+      nullptr == pContext->m_aFeatureVals ? nullptr : pContext->m_aFeatureVals + cSamples * iTask,
+      pContext->m_aMinSamplesBin[iTask],
+      pContext->m_isRounded,
+      &pContext->m_aCountCuts[iTask],
+      nullptr == pContext->m_aCuts ? nullptr : pContext->m_aCuts + pContext->m_aiFirstCuts[iTask],
+      &pContext->m_aBuffers[iThread]
+   );
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantiles(
+   IntEbm countFeatures,
+   IntEbm countSamples,
+   const double * featureVals,
+   const IntEbm * minSamplesBin,
+   BoolEbm isRounded,
+   IntEbm * countCutsInOut,
+   double * cutsLowerBoundInclusiveOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered CutQuantiles: "
+      "countFeatures=%" IntEbmPrintf ", "
+      "countSamples=%" IntEbmPrintf ", "
+      "featureVals=%p, "
+      "minSamplesBin=%p, "
+      "isRounded=%s, "
+      "countCutsInOut=%p, "
+      "cutsLowerBoundInclusiveOut=%p"
+      ,
+      countFeatures,
+      countSamples,
+      static_cast<const void *>(featureVals),
+      static_cast<const void *>(minSamplesBin),
+      ObtainTruth(isRounded),
+      static_cast<void *>(countCutsInOut),
+      static_cast<void *>(cutsLowerBoundInclusiveOut)
+   );
+
+   if(countFeatures < IntEbm { 0 } || IsConvertError<size_t>(countFeatures)) {
+      LOG_0(Trace_Error, "ERROR CutQuantiles countFeatures must be a non-negative size_t");
+      return Error_IllegalParamVal;
+   }
+   const size_t cFeatures = static_cast<size_t>(countFeatures);
+   if(size_t { 0 } == cFeatures) {
+      LOG_0(Trace_Info, "INFO CutQuantiles no features");
+      return Error_None;
+   }
+   if(nullptr == minSamplesBin || nullptr == countCutsInOut) {
+      LOG_0(Trace_Error, "ERROR CutQuantiles minSamplesBin and countCutsInOut cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+   if(countSamples < IntEbm { 0 } || IsConvertError<size_t>(countSamples) || 
+      IsMultiplyError(cFeatures, static_cast<size_t>(countSamples))) {
+      LOG_0(Trace_Error, "ERROR CutQuantiles countSamples is outside the range of a valid index");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsAddError(cFeatures, size_t { 1 }) || IsMultiplyError(sizeof(size_t), cFeatures + size_t { 1 })) {
+      LOG_0(Trace_Warning, "WARNING CutQuantiles IsMultiplyError(sizeof(size_t), cFeatures + size_t { 1 })");
+      return Error_OutOfMemory;
+   }
+   size_t * const aiFirstCuts = static_cast<size_t *>(malloc(sizeof(size_t) * (cFeatures + size_t { 1 })));
+   if(nullptr == aiFirstCuts) {
+      LOG_0(Trace_Warning, "WARNING CutQuantiles nullptr == aiFirstCuts");
+      return Error_OutOfMemory;
+   }
+
+   // each feature writes its cuts into the space that it requested, right after the space of the previous feature
+   size_t cCutsTotal = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      aiFirstCuts[iFeature] = cCutsTotal;
+      const IntEbm countCuts = countCutsInOut[iFeature];
+      if(countCuts < IntEbm { 0 } || IsConvertError<size_t>(countCuts) || 
+         IsAddError(cCutsTotal, static_cast<size_t>(countCuts))) {
+         LOG_0(Trace_Error, "ERROR CutQuantiles countCutsInOut must contain non-negative counts");
+         free(aiFirstCuts);
+         return Error_IllegalParamVal;
+      }
+      cCutsTotal += static_cast<size_t>(countCuts);
+   }
+   aiFirstCuts[cFeatures] = cCutsTotal;
+
+   ErrorEbm error;
+   CutQuantileBuffers * aBuffers = nullptr;
+   size_t cThreads = 0;
+
+   ThreadPool * pThreadPool = nullptr;
+   error = ThreadPool::Create(EbmMin(ThreadPool::GetCountThreadsConfig(), cFeatures), &pThreadPool);
+   if(Error_None != error) {
+      goto exit_free;
+   }
+   cThreads = pThreadPool->GetCountThreads();
+
+   if(IsMultiplyError(sizeof(CutQuantileBuffers), cThreads)) {
+      LOG_0(Trace_Warning, "WARNING CutQuantiles IsMultiplyError(sizeof(CutQuantileBuffers), cThreads)");
+      error = Error_OutOfMemory;
+      goto exit_free;
+   }
+   aBuffers = static_cast<CutQuantileBuffers *>(malloc(sizeof(CutQuantileBuffers) * cThreads));
+   if(nullptr == aBuffers) {
+      LOG_0(Trace_Warning, "WARNING CutQuantiles nullptr == aBuffers");
+      error = Error_OutOfMemory;
+      goto exit_free;
+   }
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      aBuffers[iThread].SafeInitCutQuantileBuffers();
+   }
+
+   {
+      CutQuantilesContext context;
+      context.m_countSamples = countSamples;
+      context.m_aFeatureVals = featureVals;
+      context.m_aMinSamplesBin = minSamplesBin;
+      context.m_isRounded = isRounded;
+      context.m_aCountCuts = countCutsInOut;
+      context.m_aCuts = cutsLowerBoundInclusiveOut;
+      context.m_aiFirstCuts = aiFirstCuts;
+      context.m_aBuffers = aBuffers;
+
+      // the features are handed out dynamically, so a few features with many unique values do not hold up the rest
+      error = pThreadPool->Run(cFeatures, CutQuantileTask, &context);
+   }
+
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      aBuffers[iThread].DestructCutQuantileBuffers();
+   }
+
+exit_free:;
+   free(aBuffers);
+   ThreadPool::Free(pThreadPool);
+   free(aiFirstCuts);
+
+   LOG_N(Trace_Info, "Exited CutQuantiles: return=%" ErrorEbmPrintf, error);
+
+   return error;
+}
+
 } // DEFINED_ZONE_NAME
@@ -6,6 +6,8 @@
 
 #include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
+#include <cmath> // std::abs, std::floor, std::isnan, std::isinf
+#include <limits> // numeric_limits
 
 #define ZONE_main
 #include "zones.h"
@@ -41,7 +43,12 @@ void DataSubsetBoosting::DestructDataSubsetBoosting(const size_t cTerms, const s
 
    AlignedFree(m_aTargetData);
    AlignedFree(m_aSampleScores);
-   AlignedFree(m_aGradHess);
+   if(nullptr != m_aQuantizedGradHess) {
+      // m_aGradHess is the DataSetBoosting scratch memory, which the DataSetBoosting frees
+      AlignedFree(m_aQuantizedGradHess);
+   } else {
+      AlignedFree(m_aGradHess);
+   }
 
    LOG_0(Trace_Info, "Exited DataSubsetBoosting::DestructDataSubsetBoosting");
 }
@@ -374,6 +381,14 @@ struct FeatureDimension {
    int m_cItemsPerBitPackFrom;
    int m_cBitsPerItemMaxFrom;
    int m_iShiftFrom;
+
+   // sparse features step through their non-default samples instead of the bit packed data.  Either way the
+   // feature ends up in the dense bit packed term data, so sparse storage only makes the shared dataset smaller
+   bool m_bSparse;
+   UIntShared m_defaultValSparse;
+   size_t m_iSampleSparse;
+   const SparseFeatureDataSetSharedEntry * m_pNonDefault;
+   const SparseFeatureDataSetSharedEntry * m_pNonDefaultsEnd;
 };
 static_assert(std::is_standard_layout<FeatureDimension>::value,
    "We use the struct hack in several places, so disallow non-standard_layout types in general");
@@ -450,38 +465,48 @@ ErrorEbm DataSetBoosting::InitTermData(
                   &cNonDefaultsSparse
                );
                EBM_ASSERT(nullptr != pFeatureDataFrom);
-               EBM_ASSERT(!bSparse); // we don't support sparse yet
 
                EBM_ASSERT(!IsConvertError<size_t>(cBinsUnused)); // since we previously extracted cBins and checked
                EBM_ASSERT(static_cast<size_t>(cBinsUnused) == cBins);
 
-               pDimensionInfoInit->m_pFeatureDataFrom = static_cast<const UIntShared *>(pFeatureDataFrom);
                pDimensionInfoInit->m_cBins = cBins;
-
-               const int cBitsRequiredMin = CountBitsRequired(cBins - size_t { 1 });
-               EBM_ASSERT(1 <= cBitsRequiredMin);
-               EBM_ASSERT(cBitsRequiredMin <= COUNT_BITS(UIntShared)); // comes from shared data set
-               EBM_ASSERT(cBitsRequiredMin <= COUNT_BITS(size_t)); // since cBins fits into size_t (previous call to GetDataSetSharedFeature)
-
-               const int cItemsPerBitPackFrom = GetCountItemsBitPacked<UIntShared>(cBitsRequiredMin);
-               EBM_ASSERT(1 <= cItemsPerBitPackFrom);
-               EBM_ASSERT(cItemsPerBitPackFrom <= COUNT_BITS(UIntShared));
-
-               const int cBitsPerItemMaxFrom = GetCountBits<UIntShared>(cItemsPerBitPackFrom);
-               EBM_ASSERT(1 <= cBitsPerItemMaxFrom);
-               EBM_ASSERT(cBitsPerItemMaxFrom <= COUNT_BITS(UIntShared));
-
-               // we can only guarantee that cBitsPerItemMaxFrom is less than or equal to COUNT_BITS(UIntShared)
-               // so we need to construct our mask in that type, but afterwards we can convert it to a 
-               // size_t since we know the ultimate answer must fit into that since cBins fits into a size_t. If in theory 
-               // UIntShared were allowed to be a billion bits, then the mask could be 65 bits while the end
-               // result would be forced to be 64 bits or less since we use the maximum number of bits per item possible
-               const size_t maskBitsFrom = static_cast<size_t>(MakeLowMask<UIntShared>(cBitsPerItemMaxFrom));
-
-               pDimensionInfoInit->m_cItemsPerBitPackFrom = cItemsPerBitPackFrom;
-               pDimensionInfoInit->m_cBitsPerItemMaxFrom = cBitsPerItemMaxFrom;
-               pDimensionInfoInit->m_maskBitsFrom = maskBitsFrom;
-               pDimensionInfoInit->m_iShiftFrom = static_cast<int>((cSharedSamples - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPackFrom));
+               pDimensionInfoInit->m_bSparse = bSparse;
+               if(bSparse) {
+                  const SparseFeatureDataSetSharedEntry * const aNonDefaults =
+                     static_cast<const SparseFeatureDataSetSharedEntry *>(pFeatureDataFrom);
+                  pDimensionInfoInit->m_pFeatureDataFrom = nullptr;
+                  pDimensionInfoInit->m_defaultValSparse = defaultValSparse;
+                  pDimensionInfoInit->m_iSampleSparse = 0;
+                  pDimensionInfoInit->m_pNonDefault = aNonDefaults;
+                  pDimensionInfoInit->m_pNonDefaultsEnd = aNonDefaults + cNonDefaultsSparse;
+               } else {
+                  pDimensionInfoInit->m_pFeatureDataFrom = static_cast<const UIntShared *>(pFeatureDataFrom);
+
+                  const int cBitsRequiredMin = CountBitsRequired(cBins - size_t { 1 });
+                  EBM_ASSERT(1 <= cBitsRequiredMin);
+                  EBM_ASSERT(cBitsRequiredMin <= COUNT_BITS(UIntShared)); // comes from shared data set
+                  EBM_ASSERT(cBitsRequiredMin <= COUNT_BITS(size_t)); // since cBins fits into size_t (previous call to GetDataSetSharedFeature)
+
+                  const int cItemsPerBitPackFrom = GetCountItemsBitPacked<UIntShared>(cBitsRequiredMin);
+                  EBM_ASSERT(1 <= cItemsPerBitPackFrom);
+                  EBM_ASSERT(cItemsPerBitPackFrom <= COUNT_BITS(UIntShared));
+
+                  const int cBitsPerItemMaxFrom = GetCountBits<UIntShared>(cItemsPerBitPackFrom);
+                  EBM_ASSERT(1 <= cBitsPerItemMaxFrom);
+                  EBM_ASSERT(cBitsPerItemMaxFrom <= COUNT_BITS(UIntShared));
+
+                  // we can only guarantee that cBitsPerItemMaxFrom is less than or equal to COUNT_BITS(UIntShared)
+                  // so we need to construct our mask in that type, but afterwards we can convert it to a 
+                  // size_t since we know the ultimate answer must fit into that since cBins fits into a size_t. If in theory 
+                  // UIntShared were allowed to be a billion bits, then the mask could be 65 bits while the end
+                  // result would be forced to be 64 bits or less since we use the maximum number of bits per item possible
+                  const size_t maskBitsFrom = static_cast<size_t>(MakeLowMask<UIntShared>(cBitsPerItemMaxFrom));
+
+                  pDimensionInfoInit->m_cItemsPerBitPackFrom = cItemsPerBitPackFrom;
+                  pDimensionInfoInit->m_cBitsPerItemMaxFrom = cBitsPerItemMaxFrom;
+                  pDimensionInfoInit->m_maskBitsFrom = maskBitsFrom;
+                  pDimensionInfoInit->m_iShiftFrom = static_cast<int>((cSharedSamples - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPackFrom));
+               }
 
                ++pDimensionInfoInit;
             }
@@ -557,18 +582,22 @@ ErrorEbm DataSetBoosting::InitTermData(
                            if(0 != cAdvances) {
                               FeatureDimension * pDimensionInfo = dimensionInfo;
                               do {
-                                 const int cItemsPerBitPackFrom = pDimensionInfo->m_cItemsPerBitPackFrom;
-                                 size_t cCompleteAdvanced = cAdvances / static_cast<size_t>(cItemsPerBitPackFrom);
-                                 int iShiftFrom = pDimensionInfo->m_iShiftFrom;
-                                 EBM_ASSERT(0 <= iShiftFrom);
-                                 iShiftFrom -= static_cast<int>(cAdvances % static_cast<size_t>(cItemsPerBitPackFrom));
-                                 pDimensionInfo->m_iShiftFrom = iShiftFrom;
-                                 if(iShiftFrom < 0) {
-                                    pDimensionInfo->m_iShiftFrom = iShiftFrom + cItemsPerBitPackFrom;
-                                    EBM_ASSERT(0 <= pDimensionInfo->m_iShiftFrom);
-                                    ++cCompleteAdvanced;
+                                 if(pDimensionInfo->m_bSparse) {
+                                    pDimensionInfo->m_iSampleSparse += cAdvances;
+                                 } else {
+                                    const int cItemsPerBitPackFrom = pDimensionInfo->m_cItemsPerBitPackFrom;
+                                    size_t cCompleteAdvanced = cAdvances / static_cast<size_t>(cItemsPerBitPackFrom);
+                                    int iShiftFrom = pDimensionInfo->m_iShiftFrom;
+                                    EBM_ASSERT(0 <= iShiftFrom);
+                                    iShiftFrom -= static_cast<int>(cAdvances % static_cast<size_t>(cItemsPerBitPackFrom));
+                                    pDimensionInfo->m_iShiftFrom = iShiftFrom;
+                                    if(iShiftFrom < 0) {
+                                       pDimensionInfo->m_iShiftFrom = iShiftFrom + cItemsPerBitPackFrom;
+                                       EBM_ASSERT(0 <= pDimensionInfo->m_iShiftFrom);
+                                       ++cCompleteAdvanced;
+                                    }
+                                    pDimensionInfo->m_pFeatureDataFrom += cCompleteAdvanced;
                                  }
-                                 pDimensionInfo->m_pFeatureDataFrom += cCompleteAdvanced;
 
                                  ++pDimensionInfo;
                               } while(pDimensionInfoInit != pDimensionInfo);
@@ -579,27 +608,38 @@ ErrorEbm DataSetBoosting::InitTermData(
                         size_t tensorMultiple = 1;
                         FeatureDimension * pDimensionInfo = dimensionInfo;
                         do {
-                           const UIntShared * const pFeatureDataFrom = pDimensionInfo->m_pFeatureDataFrom;
-                           const UIntShared bitsFrom = *pFeatureDataFrom;
-
-                           int iShiftFrom = pDimensionInfo->m_iShiftFrom;
-                           EBM_ASSERT(0 <= iShiftFrom);
-                           EBM_ASSERT(iShiftFrom * pDimensionInfo->m_cBitsPerItemMaxFrom < COUNT_BITS(UIntShared));
-                           const size_t iFeatureBin = static_cast<size_t>(bitsFrom >>
-                              (iShiftFrom * pDimensionInfo->m_cBitsPerItemMaxFrom)) &
-                              pDimensionInfo->m_maskBitsFrom;
+                           size_t iFeatureBin;
+                           if(pDimensionInfo->m_bSparse) {
+                              iFeatureBin = static_cast<size_t>(GetSparseFeatureBin(
+                                 &pDimensionInfo->m_pNonDefault,
+                                 pDimensionInfo->m_pNonDefaultsEnd,
+                                 pDimensionInfo->m_defaultValSparse,
+                                 pDimensionInfo->m_iSampleSparse
+                              ));
+                              ++pDimensionInfo->m_iSampleSparse;
+                           } else {
+                              const UIntShared * const pFeatureDataFrom = pDimensionInfo->m_pFeatureDataFrom;
+                              const UIntShared bitsFrom = *pFeatureDataFrom;
+
+                              int iShiftFrom = pDimensionInfo->m_iShiftFrom;
+                              EBM_ASSERT(0 <= iShiftFrom);
+                              EBM_ASSERT(iShiftFrom * pDimensionInfo->m_cBitsPerItemMaxFrom < COUNT_BITS(UIntShared));
+                              iFeatureBin = static_cast<size_t>(bitsFrom >>
+                                 (iShiftFrom * pDimensionInfo->m_cBitsPerItemMaxFrom)) &
+                                 pDimensionInfo->m_maskBitsFrom;
+
+                              --iShiftFrom;
+                              pDimensionInfo->m_iShiftFrom = iShiftFrom;
+                              if(iShiftFrom < 0) {
+                                 EBM_ASSERT(-1 == iShiftFrom);
+                                 pDimensionInfo->m_iShiftFrom = iShiftFrom + pDimensionInfo->m_cItemsPerBitPackFrom;
+                                 pDimensionInfo->m_pFeatureDataFrom = pFeatureDataFrom + 1;
+                              }
+                           }
 
                            // we check our dataSet when we get the header, and cBins has been checked to fit into size_t
                            EBM_ASSERT(iFeatureBin < pDimensionInfo->m_cBins);
 
-                           --iShiftFrom;
-                           pDimensionInfo->m_iShiftFrom = iShiftFrom;
-                           if(iShiftFrom < 0) {
-                              EBM_ASSERT(-1 == iShiftFrom);
-                              pDimensionInfo->m_iShiftFrom = iShiftFrom + pDimensionInfo->m_cItemsPerBitPackFrom;
-                              pDimensionInfo->m_pFeatureDataFrom = pFeatureDataFrom + 1;
-                           }
-
                            // we check for overflows during Term construction, but let's check here again
                            EBM_ASSERT(!IsMultiplyError(tensorMultiple, pDimensionInfo->m_cBins));
 
@@ -956,7 +996,8 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
    const size_t cWeights,
    const size_t cTerms,
    const Term * const * const apTerms,
-   const IntEbm * const aiTermFeatures
+   const IntEbm * const aiTermFeatures,
+   const bool bTargetSorted
 ) {
    LOG_0(Trace_Info, "Entered DataSetBoosting::InitDataSetBoosting");
 
@@ -983,34 +1024,71 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
 
       EBM_ASSERT(1 == pObjectiveCpu->m_cSIMDPack);
       EBM_ASSERT(nullptr == pObjectiveSIMD->m_pObjective && 0 == pObjectiveSIMD->m_cSIMDPack ||
-         nullptr != pObjectiveSIMD->m_pObjective && 2 <= pObjectiveSIMD->m_cSIMDPack);
+         nullptr != pObjectiveSIMD->m_pObjective && 1 <= pObjectiveSIMD->m_cSIMDPack);
       const size_t cSIMDPack = pObjectiveSIMD->m_cSIMDPack;
 
+      // When the dataset is sorted by target each class gets its own subsets, which lets the objective treat the
+      // target as a constant.  Otherwise, all the samples are treated as a single run.
+      size_t cRuns = 1;
+      size_t * acRunSamples = &m_cSamples;
+      if(bTargetSorted) {
+         ptrdiff_t cClasses;
+         const void * const aTargets = GetDataSetSharedTarget(pDataSetShared, 0, &cClasses);
+         EBM_ASSERT(nullptr != aTargets); // we previously called GetDataSetSharedTarget and got back non-null result
+         UNUSED(aTargets);
+         if(ptrdiff_t { 2 } <= cClasses) {
+            const size_t cClassesSorted = static_cast<size_t>(cClasses);
+            if(IsMultiplyError(sizeof(size_t), cClassesSorted)) {
+               LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting IsMultiplyError(sizeof(size_t), cClassesSorted)");
+               return Error_OutOfMemory;
+            }
+            acRunSamples = static_cast<size_t *>(malloc(sizeof(size_t) * cClassesSorted));
+            if(nullptr == acRunSamples) {
+               LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting nullptr == acRunSamples");
+               return Error_OutOfMemory;
+            }
+            error = CountIncludedClassSamples(pDataSetShared, direction, aBag, cClassesSorted, acRunSamples);
+            if(Error_None != error) {
+               free(acRunSamples);
+               return error;
+            }
+            cRuns = cClassesSorted;
+         }
+      }
+
       size_t cSubsets = 0;
-      size_t cIncludedSamplesRemainingInit = cIncludedSamples;
-      do {
-         size_t cSubsetSamples = EbmMin(cIncludedSamplesRemainingInit, cSubsetItemsMax);
+      for(size_t iRun = 0; iRun < cRuns; ++iRun) {
+         size_t cIncludedSamplesRemainingInit = acRunSamples[iRun];
+         while(size_t { 0 } != cIncludedSamplesRemainingInit) {
+            size_t cSubsetSamples = EbmMin(cIncludedSamplesRemainingInit, cSubsetItemsMax);
 
-         if(size_t { 0 } == cSIMDPack || cSubsetSamples < cSIMDPack) {
-            // these remaing items cannot be processed with the SIMD compute, so they go into the CPU compute
-         } else {
-            // drop any items which cannot fit into the SIMD pack
-            cSubsetSamples = cSubsetSamples - cSubsetSamples % cSIMDPack;
+            if(size_t { 0 } == cSIMDPack || cSubsetSamples < cSIMDPack) {
+               // these remaing items cannot be processed with the SIMD compute, so they go into the CPU compute
+            } else {
+               // drop any items which cannot fit into the SIMD pack
+               cSubsetSamples = cSubsetSamples - cSubsetSamples % cSIMDPack;
+            }
+            ++cSubsets;
+            EBM_ASSERT(1 <= cSubsetSamples);
+            EBM_ASSERT(cSubsetSamples <= cIncludedSamplesRemainingInit);
+            cIncludedSamplesRemainingInit -= cSubsetSamples;
          }
-         ++cSubsets;
-         EBM_ASSERT(1 <= cSubsetSamples);
-         EBM_ASSERT(cSubsetSamples <= cIncludedSamplesRemainingInit);
-         cIncludedSamplesRemainingInit -= cSubsetSamples;
-      } while(size_t { 0 } != cIncludedSamplesRemainingInit);
+      }
       EBM_ASSERT(1 <= cSubsets);
 
       if(IsMultiplyError(sizeof(DataSubsetBoosting), cSubsets)) {
          LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting IsMultiplyError(sizeof(DataSubsetBoosting), cSubsets)");
+         if(&m_cSamples != acRunSamples) {
+            free(acRunSamples);
+         }
          return Error_OutOfMemory;
       }
       DataSubsetBoosting * pSubset = static_cast<DataSubsetBoosting *>(malloc(sizeof(DataSubsetBoosting) * cSubsets));
       if(nullptr == pSubset) {
          LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting nullptr == pSubset");
+         if(&m_cSamples != acRunSamples) {
+            free(acRunSamples);
+         }
          return Error_OutOfMemory;
       }
       m_aSubsets = pSubset;
@@ -1024,9 +1102,18 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
          ++pSubsetInit;
       } while(pSubsetsEnd != pSubsetInit);
 
-      size_t cIncludedSamplesRemaining = cIncludedSamples;
+      error = Error_None;
+      size_t iRun = 0;
+      size_t cIncludedSamplesRemaining = acRunSamples[0];
       do {
-         EBM_ASSERT(1 <= cIncludedSamplesRemaining);
+         while(size_t { 0 } == cIncludedSamplesRemaining) {
+            // skip over any classes that have no samples in this set
+            ++iRun;
+            EBM_ASSERT(iRun < cRuns);
+            cIncludedSamplesRemaining = acRunSamples[iRun];
+         }
+         pSubset->m_iTargetConst = 
+            &m_cSamples == acRunSamples ? k_iTargetPerSample : static_cast<ptrdiff_t>(iRun);
 
          size_t cSubsetSamples = EbmMin(cIncludedSamplesRemaining, cSubsetItemsMax);
 
@@ -1049,12 +1136,14 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
          EBM_ASSERT(1 <= cTerms);
          if(IsMultiplyError(sizeof(void *), cTerms)) {
             LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting IsMultiplyError(sizeof(void *), cTerms)");
-            return Error_OutOfMemory;
+            error = Error_OutOfMemory;
+            goto free_runs;
          }
          void ** paTermData = static_cast<void **>(malloc(sizeof(void *) * cTerms));
          if(nullptr == paTermData) {
             LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting nullptr == paTermData");
-            return Error_OutOfMemory;
+            error = Error_OutOfMemory;
+            goto free_runs;
          }
          pSubset->m_aaTermData = paTermData;
 
@@ -1067,7 +1156,8 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
          InnerBag * const aInnerBags = InnerBag::AllocateInnerBags(cInnerBags);
          if(nullptr == aInnerBags) {
             LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting nullptr == aInnerBags");
-            return Error_OutOfMemory;
+            error = Error_OutOfMemory;
+            goto free_runs;
          }
          pSubset->m_aInnerBags = aInnerBags;
 
@@ -1075,6 +1165,14 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
       } while(pSubsetsEnd != pSubset);
       EBM_ASSERT(0 == cIncludedSamplesRemaining);
 
+   free_runs:;
+      if(&m_cSamples != acRunSamples) {
+         free(acRunSamples);
+      }
+      if(Error_None != error) {
+         return error;
+      }
+
       if(bAllocateGradients) {
          error = InitGradHess(bAllocateHessians, cScores);
          if(Error_None != error) {
@@ -1137,10 +1235,214 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
    return Error_None;
 }
 
+ErrorEbm DataSetBoosting::InitQuantizedGradHess(
+   const bool bHessian, 
+   const size_t cScores, 
+   const size_t cInnerBags, 
+   const int cQuantizedBytes
+) {
+   LOG_0(Trace_Info, "Entered DataSetBoosting::InitQuantizedGradHess");
+
+   EBM_ASSERT(1 <= cScores);
+   EBM_ASSERT(nullptr != m_aSubsets);
+   EBM_ASSERT(1 <= m_cSubsets);
+   EBM_ASSERT(sizeof(int8_t) == static_cast<size_t>(cQuantizedBytes) || sizeof(int16_t) == static_cast<size_t>(cQuantizedBytes));
+   EBM_ASSERT(nullptr == m_aGradHessQuantizeScratch);
+
+   // InitGradHess already checked that this multiplication does not overflow
+   const size_t cTotalScores = bHessian ? cScores << 1 : cScores;
+   const size_t cInnerBagsAfterZero = size_t { 0 } == cInnerBags ? size_t { 1 } : cInnerBags;
+
+   // the quantized values use all but the sign bit of the integer type
+   const size_t cLevelsType = (size_t { 1 } << (static_cast<size_t>(cQuantizedBytes) * size_t { 8 } - size_t { 1 })) - size_t { 1 };
+
+   size_t cBytesScratch = 0;
+   DataSubsetBoosting * pSubset = m_aSubsets;
+   const DataSubsetBoosting * const pSubsetsEnd = pSubset + m_cSubsets;
+   do {
+      const size_t cSubsetSamples = pSubset->m_cSamples;
+      EBM_ASSERT(1 <= cSubsetSamples);
+
+      // BinSumsBoosting accumulates the quantized values into int32_t bins, so limit the number of levels such that
+      // even if every sample of the most replicated bag landed in the same bin the sum could not overflow
+      size_t cItemsMax = 0;
+      size_t iBag = 0;
+      do {
+         const uint8_t * pCountOccurrences = pSubset->m_aInnerBags[iBag].GetCountOccurrences();
+         size_t cItems = cSubsetSamples;
+         if(nullptr != pCountOccurrences) {
+            cItems = 0;
+            const uint8_t * const pCountOccurrencesEnd = pCountOccurrences + cSubsetSamples;
+            do {
+               cItems += static_cast<size_t>(*pCountOccurrences);
+               ++pCountOccurrences;
+            } while(pCountOccurrencesEnd != pCountOccurrences);
+         }
+         cItemsMax = EbmMax(cItemsMax, cItems);
+         ++iBag;
+      } while(cInnerBagsAfterZero != iBag);
+
+      const size_t cLevelsMax = static_cast<size_t>(std::numeric_limits<int32_t>::max()) / EbmMax(cItemsMax, size_t { 1 });
+      if(size_t { 1 } <= cLevelsMax) {
+         pSubset->m_quantizedMax = static_cast<int32_t>(EbmMin(cLevelsMax, cLevelsType));
+
+         if(IsMultiplyError(static_cast<size_t>(cQuantizedBytes), cTotalScores, cSubsetSamples)) {
+            LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitQuantizedGradHess IsMultiplyError(static_cast<size_t>(cQuantizedBytes), cTotalScores, cSubsetSamples)");
+            return Error_OutOfMemory;
+         }
+         void * const aQuantizedGradHess = AlignedAlloc(static_cast<size_t>(cQuantizedBytes) * cTotalScores * cSubsetSamples);
+         if(nullptr == aQuantizedGradHess) {
+            LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitQuantizedGradHess nullptr == aQuantizedGradHess");
+            return Error_OutOfMemory;
+         }
+         pSubset->m_aQuantizedGradHess = aQuantizedGradHess;
+         pSubset->m_cQuantizedBytes = cQuantizedBytes;
+
+         // the floating point gradients are quantized as soon as they are written, so the quantized subsets take 
+         // turns using one scratch buffer instead of each keeping its own
+         const size_t cBytesGradHess = pSubset->m_pObjective->m_cFloatBytes * cTotalScores * cSubsetSamples;
+         cBytesScratch = EbmMax(cBytesScratch, cBytesGradHess);
+         AlignedFree(pSubset->m_aGradHess);
+         pSubset->m_aGradHess = nullptr;
+      } else {
+         // this subset is too large to quantize safely, so it keeps using its floating point gradients
+         LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitQuantizedGradHess subset is too large to quantize");
+      }
+
+      ++pSubset;
+   } while(pSubsetsEnd != pSubset);
+
+   if(size_t { 0 } != cBytesScratch) {
+      void * const aGradHessQuantizeScratch = AlignedAlloc(cBytesScratch);
+      if(nullptr == aGradHessQuantizeScratch) {
+         LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitQuantizedGradHess nullptr == aGradHessQuantizeScratch");
+         return Error_OutOfMemory;
+      }
+      m_aGradHessQuantizeScratch = aGradHessQuantizeScratch;
+
+      pSubset = m_aSubsets;
+      do {
+         if(nullptr != pSubset->m_aQuantizedGradHess) {
+            pSubset->m_aGradHess = aGradHessQuantizeScratch;
+         }
+         ++pSubset;
+      } while(pSubsetsEnd != pSubset);
+   }
+
+   LOG_0(Trace_Info, "Exited DataSetBoosting::InitQuantizedGradHess");
+   return Error_None;
+}
+
+template<typename TFloat, typename TQuantized>
+static void QuantizeSubset(
+   RandomDeterministic * const pRng,
+   const bool bHessian,
+   const size_t cSIMDPack,
+   const size_t cItems,
+   const int32_t quantizedMax,
+   const TFloat * const aGradHess,
+   TQuantized * const aQuantizedGradHess,
+   FloatMain * const pGradientScaleOut,
+   FloatMain * const pHessianScaleOut
+) {
+   // the items alternate between cSIMDPack gradients and cSIMDPack hessians when there are hessians
+   const size_t cKinds = bHessian ? size_t { 2 } : size_t { 1 };
+
+   FloatMain aAbsMax[2] = { 0.0, 0.0 };
+   size_t iItem = 0;
+   do {
+      const size_t iKind = iItem / cSIMDPack % cKinds;
+      const FloatMain absVal = std::abs(static_cast<FloatMain>(aGradHess[iItem]));
+      if(aAbsMax[iKind] < absVal || std::isnan(absVal)) {
+         aAbsMax[iKind] = absVal;
+      }
+      ++iItem;
+   } while(cItems != iItem);
+
+   FloatMain aScale[2];
+   FloatMain aMultiple[2] = { 0.0, 0.0 };
+   size_t iKind = 0;
+   do {
+      const FloatMain absMax = aAbsMax[iKind];
+      if(std::isnan(absMax) || std::isinf(absMax)) {
+         // the floating point BinSums would have produced NaN or infinite sums, so make the dequantized sums NaN too
+         aScale[iKind] = std::numeric_limits<FloatMain>::quiet_NaN();
+      } else if(FloatMain { 0 } == absMax) {
+         aScale[iKind] = 0.0;
+      } else {
+         aScale[iKind] = absMax / static_cast<FloatMain>(quantizedMax);
+         aMultiple[iKind] = static_cast<FloatMain>(quantizedMax) / absMax;
+      }
+      ++iKind;
+   } while(cKinds != iKind);
+
+   // stochastic rounding rounds up with a probability equal to the fractional part, so each quantized value
+   // is an unbiased estimate of the original and the rounding errors cancel out in the bin sums
+   static constexpr FloatMain k_uniformScale = FloatMain { 1.0 } / FloatMain { 4294967296.0 };
+   const FloatMain levelMax = static_cast<FloatMain>(quantizedMax);
+   iItem = 0;
+   do {
+      const FloatMain multiple = aMultiple[iItem / cSIMDPack % cKinds];
+      TQuantized quantized = 0;
+      if(FloatMain { 0 } != multiple) {
+         const FloatMain uniform = static_cast<FloatMain>(pRng->Next<uint32_t>()) * k_uniformScale;
+         FloatMain level = std::floor(static_cast<FloatMain>(aGradHess[iItem]) * multiple + uniform);
+         level = EbmMin(EbmMax(level, -levelMax), levelMax);
+         quantized = static_cast<TQuantized>(level);
+      }
+      aQuantizedGradHess[iItem] = quantized;
+      ++iItem;
+   } while(cItems != iItem);
+
+   *pGradientScaleOut = aScale[0];
+   *pHessianScaleOut = bHessian ? aScale[1] : FloatMain { 0 };
+}
+
+template<typename TQuantized>
+static void QuantizeSubset(
+   RandomDeterministic * const pRng,
+   const bool bHessian,
+   const size_t cItems,
+   const ObjectiveWrapper * const pObjective,
+   const int32_t quantizedMax,
+   const void * const aGradHess,
+   TQuantized * const aQuantizedGradHess,
+   FloatMain * const pGradientScaleOut,
+   FloatMain * const pHessianScaleOut
+) {
+   if(sizeof(FloatBig) == pObjective->m_cFloatBytes) {
+      QuantizeSubset<FloatBig, TQuantized>(pRng, bHessian, pObjective->m_cSIMDPack, cItems, quantizedMax,
+         static_cast<const FloatBig *>(aGradHess), aQuantizedGradHess, pGradientScaleOut, pHessianScaleOut);
+   } else {
+      EBM_ASSERT(sizeof(FloatSmall) == pObjective->m_cFloatBytes);
+      QuantizeSubset<FloatSmall, TQuantized>(pRng, bHessian, pObjective->m_cSIMDPack, cItems, quantizedMax,
+         static_cast<const FloatSmall *>(aGradHess), aQuantizedGradHess, pGradientScaleOut, pHessianScaleOut);
+   }
+}
+
+void DataSubsetBoosting::QuantizeGradHess(RandomDeterministic * const pRng, const bool bHessian, const size_t cScores) {
+   EBM_ASSERT(nullptr != pRng);
+   EBM_ASSERT(1 <= cScores);
+   EBM_ASSERT(nullptr != m_aQuantizedGradHess);
+   EBM_ASSERT(nullptr != m_aGradHess);
+   EBM_ASSERT(nullptr != m_pObjective);
+
+   const size_t cItems = (bHessian ? cScores << 1 : cScores) * m_cSamples;
+   if(sizeof(int8_t) == static_cast<size_t>(m_cQuantizedBytes)) {
+      QuantizeSubset<int8_t>(pRng, bHessian, cItems, m_pObjective, m_quantizedMax, m_aGradHess,
+         static_cast<int8_t *>(m_aQuantizedGradHess), &m_quantizedGradientScale, &m_quantizedHessianScale);
+   } else {
+      EBM_ASSERT(sizeof(int16_t) == static_cast<size_t>(m_cQuantizedBytes));
+      QuantizeSubset<int16_t>(pRng, bHessian, cItems, m_pObjective, m_quantizedMax, m_aGradHess,
+         static_cast<int16_t *>(m_aQuantizedGradHess), &m_quantizedGradientScale, &m_quantizedHessianScale);
+   }
+}
+
 void DataSetBoosting::DestructDataSetBoosting(const size_t cTerms, const size_t cInnerBags) {
    LOG_0(Trace_Info, "Entered DataSetBoosting::DestructDataSetBoosting");
 
    free(m_aBagWeightTotals);
+   AlignedFree(m_aGradHessQuantizeScratch);
 
    DataSubsetBoosting * pSubset = m_aSubsets;
    if(nullptr != pSubset) {
@@ -13,6 +13,8 @@
 
 #include "bridge.h" // UIntMain
 
+#include "ebm_internal.hpp" // FloatMain
+
 #include "InnerBag.hpp" // InnerBag
 
 namespace DEFINED_ZONE_NAME {
@@ -20,6 +22,7 @@ namespace DEFINED_ZONE_NAME {
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
+class RandomDeterministic;
 class Term;
 struct DataSetBoosting;
 
@@ -35,8 +38,14 @@ struct DataSubsetBoosting final {
       m_cSamples = 0;
       m_pObjective = nullptr;
       m_aGradHess = nullptr;
+      m_aQuantizedGradHess = nullptr;
+      m_cQuantizedBytes = 0;
+      m_quantizedMax = 0;
+      m_quantizedGradientScale = 0.0;
+      m_quantizedHessianScale = 0.0;
       m_aSampleScores = nullptr;
       m_aTargetData = nullptr;
+      m_iTargetConst = k_iTargetPerSample;
       m_aaTermData = nullptr;
       m_aInnerBags = nullptr;
    }
@@ -68,10 +77,34 @@ struct DataSubsetBoosting final {
       return (*m_pObjective->m_pBinSumsBoostingC)(m_pObjective, pParams);
    }
 
+   // if the subset is quantized this is scratch memory shared by all the quantized subsets of the DataSetBoosting, 
+   // and it only holds this subset's gradients between the ObjectiveApplyUpdate call and the QuantizeGradHess call
    inline void * GetGradHess() {
       return m_aGradHess;
    }
 
+   // nullptr unless the booster quantizes its gradients.  Same layout as GetGradHess, but with int8_t or int16_t 
+   // items depending on GetCountQuantizedBytes
+   inline const void * GetQuantizedGradHess() const {
+      return m_aQuantizedGradHess;
+   }
+
+   inline int GetCountQuantizedBytes() const {
+      return m_cQuantizedBytes;
+   }
+
+   // call right after ObjectiveApplyUpdate writes new gradients into GetGradHess of a quantized subset
+   void QuantizeGradHess(RandomDeterministic * const pRng, const bool bHessian, const size_t cScores);
+
+   // multiply the integer sums of GetQuantizedGradHess by these to recover the gradient and hessian sums
+   inline FloatMain GetQuantizedGradientScale() const {
+      return m_quantizedGradientScale;
+   }
+
+   inline FloatMain GetQuantizedHessianScale() const {
+      return m_quantizedHessianScale;
+   }
+
    inline void * GetSampleScores() {
       return m_aSampleScores;
    }
@@ -80,6 +113,11 @@ struct DataSubsetBoosting final {
       return m_aTargetData;
    }
 
+   // the class shared by all the samples in this subset, or k_iTargetPerSample
+   inline ptrdiff_t GetTargetConst() const {
+      return m_iTargetConst;
+   }
+
    inline const void * GetTermData(const size_t iTerm) const {
       EBM_ASSERT(nullptr != m_aaTermData);
       return m_aaTermData[iTerm];
@@ -95,8 +133,14 @@ private:
    size_t m_cSamples;
    const ObjectiveWrapper * m_pObjective;
    void * m_aGradHess;
+   void * m_aQuantizedGradHess;
+   int m_cQuantizedBytes;
+   int32_t m_quantizedMax;
+   FloatMain m_quantizedGradientScale;
+   FloatMain m_quantizedHessianScale;
    void * m_aSampleScores;
    void * m_aTargetData;
+   ptrdiff_t m_iTargetConst;
    void ** m_aaTermData;
    InnerBag * m_aInnerBags;
 };
@@ -116,6 +160,7 @@ struct DataSetBoosting final {
       m_cSubsets = 0;
       m_aSubsets = nullptr;
       m_aBagWeightTotals = nullptr;
+      m_aGradHessQuantizeScratch = nullptr;
    }
 
    ErrorEbm InitDataSetBoosting(
@@ -138,11 +183,19 @@ struct DataSetBoosting final {
       const size_t cWeights,
       const size_t cTerms,
       const Term * const * const apTerms,
-      const IntEbm * const aiTermFeatures
+      const IntEbm * const aiTermFeatures,
+      const bool bTargetSorted
    );
 
    void DestructDataSetBoosting(const size_t cTerms, const size_t cInnerBags);
 
+   ErrorEbm InitQuantizedGradHess(
+      const bool bHessian, 
+      const size_t cScores, 
+      const size_t cInnerBags, 
+      const int cQuantizedBytes
+   );
+
    inline size_t GetCountSamples() const {
       return m_cSamples;
    }
@@ -201,6 +254,7 @@ private:
    size_t m_cSubsets;
    DataSubsetBoosting * m_aSubsets;
    double * m_aBagWeightTotals;
+   void * m_aGradHessQuantizeScratch;
 };
 static_assert(std::is_standard_layout<DataSetBoosting>::value,
    "We use the struct hack in several places, so disallow non-standard_layout types in general");
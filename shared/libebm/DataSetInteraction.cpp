@@ -11,8 +11,12 @@
 #include "zones.h"
 
 #include "ebm_internal.hpp"
+#include "Feature.hpp" // FeatureBoosting
+#include "Term.hpp" // Term
 #include "dataset_shared.hpp" // UIntShared
+#include "DataSetBoosting.hpp" // DataSetBoosting
 #include "DataSetInteraction.hpp"
+#include "InnerBag.hpp" // InnerBag
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -124,7 +128,6 @@ ErrorEbm DataSetInteraction::InitFeatureData(
          &cNonDefaultsSparse
       );
       EBM_ASSERT(nullptr != aFeatureDataFrom);
-      EBM_ASSERT(!bSparse); // we don't support sparse yet
 
       EBM_ASSERT(!IsConvertError<size_t>(countBins)); // checked in a previous call to GetDataSetSharedFeature
       const size_t cBins = static_cast<size_t>(countBins);
@@ -156,6 +159,13 @@ ErrorEbm DataSetInteraction::InitFeatureData(
          int iShiftFrom = static_cast<int>((cSharedSamples - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPackFrom));
 
          const UIntShared * pFeatureDataFrom = static_cast<const UIntShared *>(aFeatureDataFrom);
+
+         // sparse features step through their non-default samples instead of the bit packed data
+         const SparseFeatureDataSetSharedEntry * pNonDefault = 
+            static_cast<const SparseFeatureDataSetSharedEntry *>(aFeatureDataFrom);
+         const SparseFeatureDataSetSharedEntry * const pNonDefaultsEnd = pNonDefault + (bSparse ? cNonDefaultsSparse : 0);
+         size_t iSampleSparse = 0;
+
          const BagEbm * pSampleReplication = aBag;
          BagEbm replication = 0;
          UIntShared iFeatureBin;
@@ -215,31 +225,40 @@ ErrorEbm DataSetInteraction::InitFeatureData(
                            } while(replication <= BagEbm { 0 });
                            const size_t cAdvances = pSampleReplication - pSampleReplicationOriginal - 1;
 
-                           size_t cCompleteAdvanced = cAdvances / static_cast<size_t>(cItemsPerBitPackFrom);
-                           iShiftFrom -= static_cast<int>(cAdvances % static_cast<size_t>(cItemsPerBitPackFrom));
-                           if(iShiftFrom < 0) {
-                              iShiftFrom += cItemsPerBitPackFrom;
-                              EBM_ASSERT(0 <= iShiftFrom);
-                              ++cCompleteAdvanced;
+                           if(bSparse) {
+                              iSampleSparse += cAdvances;
+                           } else {
+                              size_t cCompleteAdvanced = cAdvances / static_cast<size_t>(cItemsPerBitPackFrom);
+                              iShiftFrom -= static_cast<int>(cAdvances % static_cast<size_t>(cItemsPerBitPackFrom));
+                              if(iShiftFrom < 0) {
+                                 iShiftFrom += cItemsPerBitPackFrom;
+                                 EBM_ASSERT(0 <= iShiftFrom);
+                                 ++cCompleteAdvanced;
+                              }
+                              pFeatureDataFrom += cCompleteAdvanced;
                            }
-                           pFeatureDataFrom += cCompleteAdvanced;
                         }
 
-                        const UIntShared bitsFrom = *pFeatureDataFrom;
+                        if(bSparse) {
+                           iFeatureBin = GetSparseFeatureBin(&pNonDefault, pNonDefaultsEnd, defaultValSparse, iSampleSparse);
+                           ++iSampleSparse;
+                        } else {
+                           const UIntShared bitsFrom = *pFeatureDataFrom;
 
-                        EBM_ASSERT(0 <= iShiftFrom);
-                        EBM_ASSERT(iShiftFrom * cBitsPerItemMaxFrom < COUNT_BITS(UIntShared));
-                        iFeatureBin = (bitsFrom >> (iShiftFrom * cBitsPerItemMaxFrom)) & maskBitsFrom;
+                           EBM_ASSERT(0 <= iShiftFrom);
+                           EBM_ASSERT(iShiftFrom * cBitsPerItemMaxFrom < COUNT_BITS(UIntShared));
+                           iFeatureBin = (bitsFrom >> (iShiftFrom * cBitsPerItemMaxFrom)) & maskBitsFrom;
+
+                           --iShiftFrom;
+                           if(iShiftFrom < 0) {
+                              EBM_ASSERT(-1 == iShiftFrom);
+                              iShiftFrom += cItemsPerBitPackFrom;
+                              ++pFeatureDataFrom;
+                           }
+                        }
 
                         EBM_ASSERT(!IsConvertError<size_t>(iFeatureBin));
                         EBM_ASSERT(static_cast<size_t>(iFeatureBin) < cBins);
-
-                        --iShiftFrom;
-                        if(iShiftFrom < 0) {
-                           EBM_ASSERT(-1 == iShiftFrom);
-                           iShiftFrom += cItemsPerBitPackFrom;
-                           ++pFeatureDataFrom;
-                        }
                      }
 
                      EBM_ASSERT(1 <= replication);
@@ -384,7 +403,8 @@ ErrorEbm DataSetInteraction::InitDataSetInteraction(
    const BagEbm * const aBag,
    const size_t cIncludedSamples,
    const size_t cWeights,
-   const size_t cFeatures
+   const size_t cFeatures,
+   const bool bTargetSorted
 ) {
    LOG_0(Trace_Info, "Entered DataSetInteraction::InitDataSetInteraction");
 
@@ -409,34 +429,70 @@ ErrorEbm DataSetInteraction::InitDataSetInteraction(
 
       EBM_ASSERT(1 == pObjectiveCpu->m_cSIMDPack);
       EBM_ASSERT(nullptr == pObjectiveSIMD->m_pObjective && 0 == pObjectiveSIMD->m_cSIMDPack ||
-         nullptr != pObjectiveSIMD->m_pObjective && 2 <= pObjectiveSIMD->m_cSIMDPack);
+         nullptr != pObjectiveSIMD->m_pObjective && 1 <= pObjectiveSIMD->m_cSIMDPack);
       const size_t cSIMDPack = pObjectiveSIMD->m_cSIMDPack;
 
-      size_t cSubsets = 0;
-      size_t cIncludedSamplesRemainingInit = cIncludedSamples;
-      do {
-         size_t cSubsetSamples = EbmMin(cIncludedSamplesRemainingInit, cSubsetItemsMax);
+      // see DataSetBoosting::InitDataSetBoosting.  Each class gets its own subsets when sorted by target
+      size_t cRuns = 1;
+      size_t * acRunSamples = &m_cSamples;
+      if(bTargetSorted) {
+         ptrdiff_t cClasses;
+         const void * const aTargets = GetDataSetSharedTarget(pDataSetShared, 0, &cClasses);
+         EBM_ASSERT(nullptr != aTargets); // we previously called GetDataSetSharedTarget and got back non-null result
+         UNUSED(aTargets);
+         if(ptrdiff_t { 2 } <= cClasses) {
+            const size_t cClassesSorted = static_cast<size_t>(cClasses);
+            if(IsMultiplyError(sizeof(size_t), cClassesSorted)) {
+               LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitDataSetInteraction IsMultiplyError(sizeof(size_t), cClassesSorted)");
+               return Error_OutOfMemory;
+            }
+            acRunSamples = static_cast<size_t *>(malloc(sizeof(size_t) * cClassesSorted));
+            if(nullptr == acRunSamples) {
+               LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitDataSetInteraction nullptr == acRunSamples");
+               return Error_OutOfMemory;
+            }
+            error = CountIncludedClassSamples(pDataSetShared, BagEbm { 1 }, aBag, cClassesSorted, acRunSamples);
+            if(Error_None != error) {
+               free(acRunSamples);
+               return error;
+            }
+            cRuns = cClassesSorted;
+         }
+      }
 
-         if(size_t { 0 } == cSIMDPack || cSubsetSamples < cSIMDPack) {
-            // these remaing items cannot be processed with the SIMD compute, so they go into the CPU compute
-         } else {
-            // drop any items which cannot fit into the SIMD pack
-            cSubsetSamples = cSubsetSamples - cSubsetSamples % cSIMDPack;
+      size_t cSubsets = 0;
+      for(size_t iRun = 0; iRun < cRuns; ++iRun) {
+         size_t cIncludedSamplesRemainingInit = acRunSamples[iRun];
+         while(size_t { 0 } != cIncludedSamplesRemainingInit) {
+            size_t cSubsetSamples = EbmMin(cIncludedSamplesRemainingInit, cSubsetItemsMax);
+
+            if(size_t { 0 } == cSIMDPack || cSubsetSamples < cSIMDPack) {
+               // these remaing items cannot be processed with the SIMD compute, so they go into the CPU compute
+            } else {
+               // drop any items which cannot fit into the SIMD pack
+               cSubsetSamples = cSubsetSamples - cSubsetSamples % cSIMDPack;
+            }
+            ++cSubsets;
+            EBM_ASSERT(1 <= cSubsetSamples);
+            EBM_ASSERT(cSubsetSamples <= cIncludedSamplesRemainingInit);
+            cIncludedSamplesRemainingInit -= cSubsetSamples;
          }
-         ++cSubsets;
-         EBM_ASSERT(1 <= cSubsetSamples);
-         EBM_ASSERT(cSubsetSamples <= cIncludedSamplesRemainingInit);
-         cIncludedSamplesRemainingInit -= cSubsetSamples;
-      } while(size_t { 0 } != cIncludedSamplesRemainingInit);
+      }
       EBM_ASSERT(1 <= cSubsets);
 
       if(IsMultiplyError(sizeof(DataSubsetInteraction), cSubsets)) {
          LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitDataSetInteraction IsMultiplyError(sizeof(DataSubsetInteraction), cSubsets)");
+         if(&m_cSamples != acRunSamples) {
+            free(acRunSamples);
+         }
          return Error_OutOfMemory;
       }
       DataSubsetInteraction * pSubset = static_cast<DataSubsetInteraction *>(malloc(sizeof(DataSubsetInteraction) * cSubsets));
       if(nullptr == pSubset) {
          LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitDataSetInteraction nullptr == pSubset");
+         if(&m_cSamples != acRunSamples) {
+            free(acRunSamples);
+         }
          return Error_OutOfMemory;
       }
       m_aSubsets = pSubset;
@@ -450,9 +506,18 @@ ErrorEbm DataSetInteraction::InitDataSetInteraction(
          ++pSubsetInit;
       } while(pSubsetsEnd != pSubsetInit);
 
-      size_t cIncludedSamplesRemaining = cIncludedSamples;
+      error = Error_None;
+      size_t iRun = 0;
+      size_t cIncludedSamplesRemaining = acRunSamples[0];
       do {
-         EBM_ASSERT(1 <= cIncludedSamplesRemaining);
+         while(size_t { 0 } == cIncludedSamplesRemaining) {
+            // skip over any classes that have no samples in this set
+            ++iRun;
+            EBM_ASSERT(iRun < cRuns);
+            cIncludedSamplesRemaining = acRunSamples[iRun];
+         }
+         pSubset->m_iTargetConst = 
+            &m_cSamples == acRunSamples ? k_iTargetPerSample : static_cast<ptrdiff_t>(iRun);
 
          size_t cSubsetSamples = EbmMin(cIncludedSamplesRemaining, cSubsetItemsMax);
 
@@ -475,12 +540,14 @@ ErrorEbm DataSetInteraction::InitDataSetInteraction(
          if(0 != cFeatures) {
             if(IsMultiplyError(sizeof(void *), cFeatures)) {
                LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitDataSetInteraction IsMultiplyError(sizeof(void *), cFeatures)");
-               return Error_OutOfMemory;
+               error = Error_OutOfMemory;
+               goto free_runs;
             }
             void ** paFeatureData = static_cast<void **>(malloc(sizeof(void *) * cFeatures));
             if(nullptr == paFeatureData) {
                LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitDataSetInteraction nullptr == paData");
-               return Error_OutOfMemory;
+               error = Error_OutOfMemory;
+               goto free_runs;
             }
             pSubset->m_aaFeatureData = paFeatureData;
 
@@ -495,6 +562,14 @@ ErrorEbm DataSetInteraction::InitDataSetInteraction(
       } while(pSubsetsEnd != pSubset);
       EBM_ASSERT(0 == cIncludedSamplesRemaining);
 
+   free_runs:;
+      if(&m_cSamples != acRunSamples) {
+         free(acRunSamples);
+      }
+      if(Error_None != error) {
+         return error;
+      }
+
       error = InitGradHess(bAllocateHessians, cScores);
       if(Error_None != error) {
          return error;
@@ -528,6 +603,125 @@ ErrorEbm DataSetInteraction::InitDataSetInteraction(
    return Error_None;
 }
 
+ErrorEbm DataSetInteraction::InitDataSetInteractionFromBoosting(
+   DataSetBoosting * const pDataSetBoosting,
+   const size_t cInnerBags,
+   const size_t cFeatures,
+   const FeatureBoosting * const aFeatures,
+   const size_t cTerms,
+   const Term * const * const apTerms
+) {
+   LOG_0(Trace_Info, "Entered DataSetInteraction::InitDataSetInteractionFromBoosting");
+
+   EBM_ASSERT(nullptr != pDataSetBoosting);
+   EBM_ASSERT(nullptr != aFeatures || 0 == cFeatures);
+   EBM_ASSERT(nullptr != apTerms || 0 == cTerms);
+
+   EBM_ASSERT(0 == m_cSamples);
+   EBM_ASSERT(0 == m_cSubsets);
+   EBM_ASSERT(nullptr == m_aSubsets);
+   EBM_ASSERT(0.0 == m_weightTotal);
+
+   const size_t cSamples = pDataSetBoosting->GetCountSamples();
+   if(0 != cSamples) {
+      const size_t cSubsets = pDataSetBoosting->GetCountSubsets();
+      EBM_ASSERT(1 <= cSubsets);
+
+      if(IsMultiplyError(sizeof(DataSubsetInteraction), cSubsets)) {
+         LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitDataSetInteractionFromBoosting IsMultiplyError(sizeof(DataSubsetInteraction), cSubsets)");
+         return Error_OutOfMemory;
+      }
+      DataSubsetInteraction * const aSubsets = static_cast<DataSubsetInteraction *>(malloc(sizeof(DataSubsetInteraction) * cSubsets));
+      if(nullptr == aSubsets) {
+         LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitDataSetInteractionFromBoosting nullptr == aSubsets");
+         return Error_OutOfMemory;
+      }
+      m_aSubsets = aSubsets;
+      m_cSubsets = cSubsets;
+      m_bBorrowed = true;
+      m_cSamples = cSamples;
+
+      const DataSubsetInteraction * const pSubsetsEnd = aSubsets + cSubsets;
+
+      DataSubsetInteraction * pSubsetInit = aSubsets;
+      do {
+         pSubsetInit->SafeInitDataSubsetInteraction();
+         ++pSubsetInit;
+      } while(pSubsetsEnd != pSubsetInit);
+
+      // the boosting gradients are not multiplied by the weights, which is fine since BinSumsInteraction multiplies
+      // them in.  Inner bags mix their sample counts into their weights, so with inner bags we can only use
+      // unweighted samples, and our caller checks for that
+      DataSubsetBoosting * pSubsetFrom = pDataSetBoosting->GetSubsets();
+      DataSubsetInteraction * pSubset = aSubsets;
+      do {
+         pSubset->m_cSamples = pSubsetFrom->GetCountSamples();
+         pSubset->m_iTargetConst = pSubsetFrom->GetTargetConst();
+         pSubset->m_pObjective = pSubsetFrom->GetObjectiveWrapper();
+         pSubset->m_aGradHess = pSubsetFrom->GetGradHess();
+         EBM_ASSERT(nullptr != pSubset->m_aGradHess);
+         if(size_t { 0 } == cInnerBags) {
+            pSubset->m_aWeights = const_cast<void *>(pSubsetFrom->GetInnerBag(0)->GetWeights());
+         }
+
+         if(0 != cFeatures) {
+            if(IsMultiplyError(sizeof(void *), cFeatures)) {
+               LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitDataSetInteractionFromBoosting IsMultiplyError(sizeof(void *), cFeatures)");
+               return Error_OutOfMemory;
+            }
+            void ** paFeatureData = static_cast<void **>(malloc(sizeof(void *) * cFeatures));
+            if(nullptr == paFeatureData) {
+               LOG_0(Trace_Warning, "WARNING DataSetInteraction::InitDataSetInteractionFromBoosting nullptr == paFeatureData");
+               return Error_OutOfMemory;
+            }
+            pSubset->m_aaFeatureData = paFeatureData;
+
+            const void * const * const paFeatureDataEnd = paFeatureData + cFeatures;
+            do {
+               *paFeatureData = nullptr;
+               ++paFeatureData;
+            } while(paFeatureDataEnd != paFeatureData);
+         }
+
+         ++pSubsetFrom;
+         ++pSubset;
+      } while(pSubsetsEnd != pSubset);
+
+      // A term with one real dimension holds the bin index of that feature, packed with the same number of bits
+      // that we would use for the feature, so its data can be used as the feature data.  Features without such a
+      // term have no data and CalcInteractionStrength rejects them
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         const Term * const pTerm = apTerms[iTerm];
+         EBM_ASSERT(nullptr != pTerm);
+         if(size_t { 1 } == pTerm->GetCountRealDimensions()) {
+            const TermFeature * pTermFeature = pTerm->GetTermFeatures();
+            while(pTermFeature->m_pFeature->GetCountBins() <= size_t { 1 }) {
+               ++pTermFeature;
+            }
+            const size_t iFeature = static_cast<size_t>(pTermFeature->m_pFeature - aFeatures);
+            EBM_ASSERT(iFeature < cFeatures);
+            EBM_ASSERT(CountBitsRequired(aFeatures[iFeature].GetCountBins() - size_t { 1 }) == pTerm->GetBitsRequiredMin());
+
+            pSubsetFrom = pDataSetBoosting->GetSubsets();
+            pSubset = aSubsets;
+            if(nullptr == pSubset->m_aaFeatureData[iFeature]) {
+               do {
+                  pSubset->m_aaFeatureData[iFeature] = const_cast<void *>(pSubsetFrom->GetTermData(iTerm));
+                  EBM_ASSERT(nullptr != pSubset->m_aaFeatureData[iFeature]);
+                  ++pSubsetFrom;
+                  ++pSubset;
+               } while(pSubsetsEnd != pSubset);
+            }
+         }
+      }
+
+      m_weightTotal = size_t { 0 } == cInnerBags ? pDataSetBoosting->GetBagWeightTotal(0) : static_cast<double>(cSamples);
+   }
+
+   LOG_0(Trace_Info, "Exited DataSetInteraction::InitDataSetInteractionFromBoosting");
+   return Error_None;
+}
+
 void DataSetInteraction::DestructDataSetInteraction(const size_t cFeatures) {
    LOG_0(Trace_Info, "Entered DataSetInteraction::DestructDataSetInteraction");
 
@@ -536,7 +730,12 @@ void DataSetInteraction::DestructDataSetInteraction(const size_t cFeatures) {
       EBM_ASSERT(1 <= m_cSubsets);
       const DataSubsetInteraction * const pSubsetsEnd = pSubset + m_cSubsets;
       do {
-         pSubset->DestructDataSubsetInteraction(cFeatures);
+         if(m_bBorrowed) {
+            // everything except the feature data pointer array belongs to the booster
+            free(pSubset->m_aaFeatureData);
+         } else {
+            pSubset->DestructDataSubsetInteraction(cFeatures);
+         }
          ++pSubset;
       } while(pSubsetsEnd != pSubset);
       free(m_aSubsets);
@@ -18,6 +18,9 @@ namespace DEFINED_ZONE_NAME {
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
+class FeatureBoosting;
+class Term;
+struct DataSetBoosting;
 struct DataSetInteraction;
 
 struct DataSubsetInteraction final {
@@ -32,6 +35,7 @@ struct DataSubsetInteraction final {
       m_cSamples = 0;
       m_pObjective = nullptr;
       m_aGradHess = nullptr;
+      m_iTargetConst = k_iTargetPerSample;
       m_aaFeatureData = nullptr;
       m_aWeights = nullptr;
    }
@@ -68,6 +72,11 @@ struct DataSubsetInteraction final {
       return m_aGradHess;
    }
 
+   inline const void * GetGradHess() const {
+      EBM_ASSERT(nullptr != m_aGradHess);
+      return m_aGradHess;
+   }
+
    inline const void * GetFeatureData(const size_t iFeature) const {
       EBM_ASSERT(nullptr != m_aaFeatureData);
       return m_aaFeatureData[iFeature];
@@ -77,11 +86,17 @@ struct DataSubsetInteraction final {
       return m_aWeights;
    }
 
+   // the class shared by all the samples in this subset, or k_iTargetPerSample
+   inline ptrdiff_t GetTargetConst() const {
+      return m_iTargetConst;
+   }
+
 private:
 
    size_t m_cSamples;
    const ObjectiveWrapper * m_pObjective;
    void * m_aGradHess;
+   ptrdiff_t m_iTargetConst;
    void ** m_aaFeatureData;
    void * m_aWeights;
 };
@@ -102,6 +117,7 @@ struct DataSetInteraction final {
       m_cSubsets = 0;
       m_aSubsets = nullptr;
       m_weightTotal = 0.0;
+      m_bBorrowed = false;
    }
 
    ErrorEbm InitDataSetInteraction(
@@ -115,7 +131,19 @@ struct DataSetInteraction final {
       const BagEbm * const aBag,
       const size_t cIncludedSamples,
       const size_t cWeights,
-      const size_t cFeatures
+      const size_t cFeatures,
+      const bool bTargetSorted
+   );
+
+   // borrows the gradients, weights and bit packed feature data of a booster's training set instead of building
+   // them from the shared dataset.  The booster must outlive this object
+   ErrorEbm InitDataSetInteractionFromBoosting(
+      DataSetBoosting * const pDataSetBoosting,
+      const size_t cInnerBags,
+      const size_t cFeatures,
+      const FeatureBoosting * const aFeatures,
+      const size_t cTerms,
+      const Term * const * const apTerms
    );
 
    void DestructDataSetInteraction(const size_t cFeatures);
@@ -157,6 +185,7 @@ private:
    size_t m_cSubsets;
    DataSubsetInteraction * m_aSubsets;
    double m_weightTotal;
+   bool m_bBorrowed;
 };
 static_assert(std::is_standard_layout<DataSetInteraction>::value,
    "We use the struct hack in several places, so disallow non-standard_layout types in general");
@@ -22,6 +22,8 @@ extern ErrorEbm GetObjective(
    const Config * const pConfig,
    const char * sObjective,
    const AccelerationFlags acceleration,
+   const bool bDoublePrecision,
+   const bool bFloat32,
    ObjectiveWrapper * const pCpuObjectiveWrapperOut,
    ObjectiveWrapper * const pSIMDObjectiveWrapperOut
 ) noexcept;
@@ -46,7 +48,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION DetermineTask(
    Config config;
    config.cOutputs = 1;
    config.isDifferentialPrivacy = EBM_FALSE;
-   const ErrorEbm error = GetObjective(&config, objective, AccelerationFlags_NONE, &objectiveWrapper, nullptr);
+   const ErrorEbm error = GetObjective(&config, objective, AccelerationFlags_NONE, false, false, &objectiveWrapper, nullptr);
    if(Error_None != error) {
       LOG_0(Trace_Error, "ERROR DetermineTask GetObjective failed");
 
@@ -123,7 +125,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION DetermineLinkFunction(
    Config config;
    config.cOutputs = cScores;
    config.isDifferentialPrivacy = 0 != (LinkFlags_DifferentialPrivacy & flags) ? EBM_TRUE : EBM_FALSE;
-   const ErrorEbm error = GetObjective(&config, objective, AccelerationFlags_NONE, &objectiveWrapper, nullptr);
+   const ErrorEbm error = GetObjective(&config, objective, AccelerationFlags_NONE, false, false, &objectiveWrapper, nullptr);
    if(Error_None != error) {
       LOG_0(Trace_Error, "ERROR DetermineLinkFunction GetObjective failed");
 
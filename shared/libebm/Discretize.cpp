@@ -18,7 +18,11 @@
 #define ZONE_main
 #include "zones.h"
 
+#include "bridge.h" // DiscretizeBridge
 #include "common.hpp" // IsConvertError
+#include "ebm_internal.hpp" // TransposeStripe
+
+#include "ThreadPool.hpp"
 
 // TODO: check this file for how we handle subnormal numbers!  It's tricky if we get them
 
@@ -131,6 +135,11 @@ namespace DEFINED_ZONE_NAME {
 //       transpose_8192 = 6.26907
 //       transpose_16384 = 7.73406
 
+extern DISCRETIZE_C GetDiscretizeSIMD() noexcept;
+
+// Below this many samples the SIMD kernels don't have enough work to pay for the call through the zone bridge
+static constexpr size_t k_cSamplesSIMDMin = 8;
+
 EBM_API_BODY IntEbm EBM_CALLING_CONVENTION DiscretizeOneSample(
    const double featureVal,
    IntEbm countCuts,
@@ -217,6 +226,72 @@ EBM_API_BODY IntEbm EBM_CALLING_CONVENTION DiscretizeOneSample(
    return static_cast<IntEbm>(middle);
 }
 
+extern void BuildEytzingerCuts(
+   const size_t cCuts,
+   const double * const aCuts,
+   const size_t cLevels,
+   double * const aEytzingerOut
+) noexcept {
+   EBM_ASSERT(size_t { 1 } <= cCuts);
+   EBM_ASSERT(cLevels == GetEytzingerLevels(cCuts));
+
+   // slot 0 is never read.  Node k at depth d is the (2 * (k - 2^d) + 1) * 2^(levels - 1 - d)th node in sorted order
+   aEytzingerOut[0] = std::numeric_limits<double>::quiet_NaN();
+   double * pOut = &aEytzingerOut[1];
+   for(size_t iDepth = 0; iDepth < cLevels; ++iDepth) {
+      const size_t cNodes = size_t { 1 } << iDepth;
+      const size_t cShift = cLevels - size_t { 1 } - iDepth;
+      for(size_t iNode = 0; iNode < cNodes; ++iNode) {
+         const size_t iSorted = (((iNode << 1) + size_t { 1 }) << cShift) - size_t { 1 };
+         // NaN compares false, so the padding acts like cuts above every value
+         *pOut = iSorted < cCuts ? aCuts[iSorted] : std::numeric_limits<double>::quiet_NaN();
+         ++pOut;
+      }
+   }
+   EBM_ASSERT(pOut == aEytzingerOut + (size_t { 1 } << cLevels));
+}
+
+extern void DiscretizeEytzinger(
+   const size_t cSamples,
+   const double * const aFeatureVals,
+   const size_t cCuts,
+   const size_t cLevels,
+   const double * const aEytzinger,
+   IntEbm * const aBinIndexesOut
+) noexcept {
+   EBM_ASSERT(size_t { 1 } <= cCuts);
+   EBM_ASSERT(cLevels == GetEytzingerLevels(cCuts));
+
+   if(PREDICTABLE(k_cSamplesSIMDMin <= cSamples)) {
+      const DISCRETIZE_C pDiscretizeSIMD = GetDiscretizeSIMD();
+      if(nullptr != pDiscretizeSIMD) {
+         DiscretizeBridge params;
+         params.m_cSamples = cSamples;
+         params.m_aFeatureVals = aFeatureVals;
+         params.m_cCuts = cCuts;
+         params.m_cEytzingerLevels = cLevels;
+         params.m_aCutsLowerBoundInclusive = aEytzinger;
+         params.m_aBinIndexesOut = aBinIndexesOut;
+         (*pDiscretizeSIMD)(&params);
+         return;
+      }
+   }
+
+   const size_t iLeafFirst = size_t { 1 } << cLevels;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const double val = aFeatureVals[iSample];
+      // no data dependent branches, so the searches of neighbouring samples overlap in the out of order window
+      size_t iNode = 1;
+      for(size_t iLevel = 0; iLevel < cLevels; ++iLevel) {
+         iNode = (iNode << 1) + (UNPREDICTABLE(aEytzinger[iNode] <= val) ? size_t { 1 } : size_t { 0 });
+      }
+      // the leaf we land on, counted from the left, is the number of cuts <= val.  NaN values land on leaf 0
+      const size_t iBin = iNode - iLeafFirst + (UNPREDICTABLE(std::isnan(val)) ? size_t { 0 } : size_t { 1 });
+      EBM_ASSERT(iBin <= cCuts + size_t { 1 });
+      aBinIndexesOut[iSample] = static_cast<IntEbm>(iBin);
+   }
+}
+
 // don't bother using a lock here.  We don't care if an extra log message is written out due to thread parallism
 static int g_cLogEnterDiscretize = 25;
 static int g_cLogExitDiscretize = 25;
@@ -389,6 +464,56 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
       }
 # endif // NDEBUG
 
+      // building the layout touches every cut, so only do it when there are enough samples to pay for that
+      if(!IsConvertError<size_t>(countCuts) && IsEytzingerCuts(static_cast<size_t>(countCuts)) &&
+         static_cast<size_t>(countCuts) <= cSamples) {
+
+         const size_t cCuts = static_cast<size_t>(countCuts);
+         const size_t cLevels = GetEytzingerLevels(cCuts);
+         // if the allocation fails we can still bin with the sorted cuts below
+         double * const aEytzinger = static_cast<double *>(AlignedAlloc(sizeof(double) << cLevels));
+         if(nullptr != aEytzinger) {
+            BuildEytzingerCuts(cCuts, cutsLowerBoundInclusive, cLevels, aEytzinger);
+            DiscretizeEytzinger(cSamples, featureVals, cCuts, cLevels, aEytzinger, binIndexesOut);
+            AlignedFree(aEytzinger);
+
+#ifndef NDEBUG
+            for(size_t iDebug = 0; iDebug < cSamples; ++iDebug) {
+               EBM_ASSERT(binIndexesOut[iDebug] == DiscretizeOneSample(featureVals[iDebug], countCuts, cutsLowerBoundInclusive));
+            }
+#endif // NDEBUG
+
+            error = Error_None;
+            goto exit_with_log;
+         }
+      }
+
+      if(PREDICTABLE(k_cSamplesSIMDMin <= cSamples)) {
+         const DISCRETIZE_C pDiscretizeSIMD = GetDiscretizeSIMD();
+         // leave giant and illegal countCuts values to the scalar code below, which checks them and logs the error
+         if(nullptr != pDiscretizeSIMD && countCuts <= IntEbm { std::numeric_limits<int32_t>::max() } &&
+            !IsMultiplyError(sizeof(*cutsLowerBoundInclusive), static_cast<size_t>(countCuts))) {
+
+            DiscretizeBridge params;
+            params.m_cSamples = cSamples;
+            params.m_aFeatureVals = featureVals;
+            params.m_cCuts = static_cast<size_t>(countCuts);
+            params.m_cEytzingerLevels = 0;
+            params.m_aCutsLowerBoundInclusive = cutsLowerBoundInclusive;
+            params.m_aBinIndexesOut = binIndexesOut;
+            (*pDiscretizeSIMD)(&params);
+
+#ifndef NDEBUG
+            for(size_t iDebug = 0; iDebug < cSamples; ++iDebug) {
+               EBM_ASSERT(binIndexesOut[iDebug] == DiscretizeOneSample(featureVals[iDebug], countCuts, cutsLowerBoundInclusive));
+            }
+#endif // NDEBUG
+
+            error = Error_None;
+            goto exit_with_log;
+         }
+      }
+
       if(PREDICTABLE(IntEbm { 1 } == countCuts)) {
          const double cut0 = cutsLowerBoundInclusive[0];
          do {
@@ -1031,4 +1156,281 @@ exit_with_log:;
    return error;
 }
 
+extern void TransposeStripe(
+   const size_t cRows,
+   const size_t cColumnsMatrix,
+   const double * const aRows,
+   const size_t cColumns,
+   const size_t * const aiColumns,
+   double * const aColumnsOut
+) noexcept {
+   EBM_ASSERT(size_t { 1 } <= cColumns && cColumns <= k_cTransposeStripeColumnsMax);
+
+   // we read each row once, and all the columns we want from it are usually in the same few cache lines.  The writes
+   // go to cColumns separate streams, which is the cost that limits how wide a stripe can usefully be
+   const double * pRow = aRows;
+   const double * const pRowsEnd = aRows + cRows * cColumnsMatrix;
+   double * pOut = aColumnsOut;
+   while(pRowsEnd != pRow) {
+      double * pColumnOut = pOut;
+      for(size_t iColumn = 0; iColumn < cColumns; ++iColumn) {
+         EBM_ASSERT(aiColumns[iColumn] < cColumnsMatrix);
+         *pColumnOut = pRow[aiColumns[iColumn]];
+         pColumnOut += cRows;
+      }
+      ++pOut;
+      pRow += cColumnsMatrix;
+   }
+}
+
+// Each task transposes and bins a block of rows.  The transposed stripe of the block stays in L2 while we bin it
+static constexpr size_t k_cDiscretizeMatrixBlockRows = 256;
+
+struct DiscretizeMatrixContext final {
+   size_t m_cSamples;
+   size_t m_cFeatures;
+   const double * m_aFeatureMatrix;
+   size_t m_cBinnings;
+   const size_t * m_aiFeatures;
+   const size_t * m_acCuts;
+   const double * const * m_apCuts;
+   // nullptr for binnings that use the sorted cuts directly
+   const double * const * m_apEytzinger;
+   const size_t * m_acEytzingerLevels;
+   IntEbm * m_aBinIndexesOut;
+   // per thread: k_cTransposeStripeColumnsMax * k_cDiscretizeMatrixBlockRows transposed values
+   double * m_aScratch;
+};
+
+static ErrorEbm DiscretizeMatrixBlock(void * const pContextVoid, const size_t iTask, const size_t iThread) {
+   const DiscretizeMatrixContext * const pContext = static_cast<const DiscretizeMatrixContext *>(pContextVoid);
+
+   const size_t cSamples = pContext->m_cSamples;
+   const size_t iSampleStart = iTask * k_cDiscretizeMatrixBlockRows;
+   EBM_ASSERT(iSampleStart < cSamples);
+   const size_t cRows = EbmMin(k_cDiscretizeMatrixBlockRows, cSamples - iSampleStart);
+
+   double * const aColumns = &pContext->m_aScratch[iThread * k_cTransposeStripeColumnsMax * k_cDiscretizeMatrixBlockRows];
+   const double * const aRows = &pContext->m_aFeatureMatrix[iSampleStart * pContext->m_cFeatures];
+
+   const size_t cBinnings = pContext->m_cBinnings;
+   for(size_t iBinningStart = 0; iBinningStart < cBinnings; iBinningStart += k_cTransposeStripeColumnsMax) {
+      const size_t cColumns = EbmMin(k_cTransposeStripeColumnsMax, cBinnings - iBinningStart);
+      TransposeStripe(
+         cRows,
+         pContext->m_cFeatures,
+         aRows,
+         cColumns,
+         &pContext->m_aiFeatures[iBinningStart],
+         aColumns
+      );
+      for(size_t iColumn = 0; iColumn < cColumns; ++iColumn) {
+         const size_t iBinning = iBinningStart + iColumn;
+         const double * const aEytzinger = pContext->m_apEytzinger[iBinning];
+         if(nullptr != aEytzinger) {
+            DiscretizeEytzinger(
+               cRows,
+               &aColumns[iColumn * cRows],
+               pContext->m_acCuts[iBinning],
+               pContext->m_acEytzingerLevels[iBinning],
+               aEytzinger,
+               &pContext->m_aBinIndexesOut[iBinning * cSamples + iSampleStart]
+            );
+            continue;
+         }
+         const ErrorEbm error = Discretize(
+            static_cast<IntEbm>(cRows),
+            &aColumns[iColumn * cRows],
+            static_cast<IntEbm>(pContext->m_acCuts[iBinning]),
+            pContext->m_apCuts[iBinning],
+            &pContext->m_aBinIndexesOut[iBinning * cSamples + iSampleStart]
+         );
+         if(Error_None != error) {
+            return error;
+         }
+      }
+   }
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION DiscretizeMatrix(
+   IntEbm countSamples,
+   IntEbm countFeatures,
+   const double * featureMatrix,
+   IntEbm countBinnings,
+   const IntEbm * binningFeatureIndexes,
+   const IntEbm * binningCountCuts,
+   const double * binningCuts,
+   IntEbm * binIndexesOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered DiscretizeMatrix: "
+      "countSamples=%" IntEbmPrintf ", "
+      "countFeatures=%" IntEbmPrintf ", "
+      "featureMatrix=%p, "
+      "countBinnings=%" IntEbmPrintf ", "
+      "binningFeatureIndexes=%p, "
+      "binningCountCuts=%p, "
+      "binningCuts=%p, "
+      "binIndexesOut=%p"
+      ,
+      countSamples,
+      countFeatures,
+      static_cast<const void *>(featureMatrix),
+      countBinnings,
+      static_cast<const void *>(binningFeatureIndexes),
+      static_cast<const void *>(binningCountCuts),
+      static_cast<const void *>(binningCuts),
+      static_cast<void *>(binIndexesOut)
+   );
+
+   if(countSamples < IntEbm { 0 } || IsConvertError<size_t>(countSamples)) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix countSamples must be a non-negative size_t");
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   if(countFeatures < IntEbm { 0 } || IsConvertError<size_t>(countFeatures)) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix countFeatures must be a non-negative size_t");
+      return Error_IllegalParamVal;
+   }
+   const size_t cFeatures = static_cast<size_t>(countFeatures);
+
+   if(countBinnings < IntEbm { 0 } || IsConvertError<size_t>(countBinnings)) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix countBinnings must be a non-negative size_t");
+      return Error_IllegalParamVal;
+   }
+   const size_t cBinnings = static_cast<size_t>(countBinnings);
+
+   if(size_t { 0 } == cSamples || size_t { 0 } == cBinnings) {
+      LOG_0(Trace_Info, "Exited DiscretizeMatrix with nothing to bin");
+      return Error_None;
+   }
+
+   if(nullptr == featureMatrix || nullptr == binningFeatureIndexes || nullptr == binningCountCuts ||
+      nullptr == binIndexesOut) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix the input and output arrays cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+   if(IsMultiplyError(sizeof(*featureMatrix), cSamples, cFeatures)) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix IsMultiplyError(sizeof(*featureMatrix), cSamples, cFeatures)");
+      return Error_IllegalParamVal;
+   }
+   if(IsMultiplyError(sizeof(*binIndexesOut), cSamples, cBinnings)) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix IsMultiplyError(sizeof(*binIndexesOut), cSamples, cBinnings)");
+      return Error_IllegalParamVal;
+   }
+
+   const size_t cBlocks = (cSamples - size_t { 1 }) / k_cDiscretizeMatrixBlockRows + size_t { 1 };
+
+   // one allocation holds the per binning feature indexes, cut counts, Eytzinger level counts, Eytzinger pointers,
+   // and cut pointers.  The thread scratch is kept with the library wide pool between calls
+   static constexpr size_t cBytesPerBinning = sizeof(size_t) * 3 + sizeof(const double *) * 2;
+   static constexpr size_t cBytesScratchPerThread =
+      sizeof(double) * k_cTransposeStripeColumnsMax * k_cDiscretizeMatrixBlockRows;
+   if(IsMultiplyError(cBytesPerBinning, cBinnings)) {
+      LOG_0(Trace_Warning, "WARNING DiscretizeMatrix the binnings are too large for memory");
+      return Error_OutOfMemory;
+   }
+   char * const pBinnings = static_cast<char *>(malloc(cBytesPerBinning * cBinnings));
+   if(nullptr == pBinnings) {
+      LOG_0(Trace_Warning, "WARNING DiscretizeMatrix nullptr == pBinnings");
+      return Error_OutOfMemory;
+   }
+   size_t * const aiFeatures = reinterpret_cast<size_t *>(pBinnings);
+   size_t * const acCuts = aiFeatures + cBinnings;
+   size_t * const acEytzingerLevels = acCuts + cBinnings;
+   double ** const apEytzinger = reinterpret_cast<double **>(pBinnings + sizeof(size_t) * 3 * cBinnings);
+   const double ** const apCuts =
+      reinterpret_cast<const double **>(pBinnings + (sizeof(size_t) * 3 + sizeof(double *)) * cBinnings);
+   for(size_t iBinning = 0; iBinning < cBinnings; ++iBinning) {
+      apEytzinger[iBinning] = nullptr;
+   }
+
+   ErrorEbm error = Error_None;
+   const double * pCuts = binningCuts;
+   for(size_t iBinning = 0; iBinning < cBinnings; ++iBinning) {
+      const IntEbm indexFeature = binningFeatureIndexes[iBinning];
+      if(indexFeature < IntEbm { 0 } || IsConvertError<size_t>(indexFeature) ||
+         cFeatures <= static_cast<size_t>(indexFeature)) {
+         LOG_0(Trace_Error, "ERROR DiscretizeMatrix binningFeatureIndexes value out of range");
+         error = Error_IllegalParamVal;
+         goto exit_free;
+      }
+      const IntEbm countCuts = binningCountCuts[iBinning];
+      if(countCuts < IntEbm { 0 } || IsConvertError<size_t>(countCuts)) {
+         LOG_0(Trace_Error, "ERROR DiscretizeMatrix binningCountCuts value out of range");
+         error = Error_IllegalParamVal;
+         goto exit_free;
+      }
+      if(IntEbm { 0 } != countCuts && nullptr == binningCuts) {
+         LOG_0(Trace_Error, "ERROR DiscretizeMatrix binningCuts cannot be nullptr");
+         error = Error_IllegalParamVal;
+         goto exit_free;
+      }
+      const size_t cCuts = static_cast<size_t>(countCuts);
+      aiFeatures[iBinning] = static_cast<size_t>(indexFeature);
+      acCuts[iBinning] = cCuts;
+      acEytzingerLevels[iBinning] = 0;
+      apCuts[iBinning] = pCuts;
+      // every block shares the layout, so it pays for itself when there are as many samples as cuts
+      if(IsEytzingerCuts(cCuts) && cCuts <= cSamples) {
+         const size_t cLevels = GetEytzingerLevels(cCuts);
+         double * const aEytzinger = static_cast<double *>(AlignedAlloc(sizeof(double) << cLevels));
+         if(nullptr == aEytzinger) {
+            LOG_0(Trace_Warning, "WARNING DiscretizeMatrix nullptr == aEytzinger");
+            error = Error_OutOfMemory;
+            goto exit_free;
+         }
+         BuildEytzingerCuts(cCuts, pCuts, cLevels, aEytzinger);
+         acEytzingerLevels[iBinning] = cLevels;
+         apEytzinger[iBinning] = aEytzinger;
+      }
+      // Discretize checks the remaining limits on countCuts before touching the cuts
+      pCuts = nullptr == pCuts ? nullptr : pCuts + static_cast<size_t>(countCuts);
+   }
+
+   {
+      // starting and joining threads on every call would cost more than binning a small matrix
+      ThreadPool * pThreadPool = nullptr;
+      error = ThreadPool::BorrowShared(&pThreadPool);
+      if(Error_None == error) {
+         // malloc aligns the scratch for doubles
+         double * const aScratch = reinterpret_cast<double *>(pThreadPool->GetScratch(cBytesScratchPerThread));
+         if(nullptr == aScratch) {
+            ThreadPool::GiveBack(pThreadPool);
+            error = Error_OutOfMemory;
+            goto exit_free;
+         }
+
+         DiscretizeMatrixContext context;
+         context.m_cSamples = cSamples;
+         context.m_cFeatures = cFeatures;
+         context.m_aFeatureMatrix = featureMatrix;
+         context.m_cBinnings = cBinnings;
+         context.m_aiFeatures = aiFeatures;
+         context.m_acCuts = acCuts;
+         context.m_apCuts = apCuts;
+         context.m_apEytzinger = apEytzinger;
+         context.m_acEytzingerLevels = acEytzingerLevels;
+         context.m_aBinIndexesOut = binIndexesOut;
+         context.m_aScratch = aScratch;
+
+         error = pThreadPool->Run(cBlocks, DiscretizeMatrixBlock, &context);
+
+         ThreadPool::GiveBack(pThreadPool);
+      }
+   }
+
+exit_free:;
+   for(size_t iBinning = 0; iBinning < cBinnings; ++iBinning) {
+      AlignedFree(apEytzinger[iBinning]);
+   }
+   free(pBinnings);
+
+   LOG_N(Trace_Info, "Exited DiscretizeMatrix: error=%" ErrorEbmPrintf, error);
+   return error;
+}
+
 } // DEFINED_ZONE_NAME
@@ -26,6 +26,7 @@
 #include "Term.hpp"
 #include "InnerBag.hpp"
 #include "Tensor.hpp"
+#include "ThreadPool.hpp"
 #include "BoosterCore.hpp"
 #include "BoosterShell.hpp"
 
@@ -442,125 +443,580 @@ static ErrorEbm BoostRandom(
    return Error_None;
 }
 
-// we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before getting 
-// the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us we only decrease the count if the 
-// count is non-zero, so at worst if there is a race condition then we'll output this log message more times than desired, but we can live with that
-static int g_cLogGenerateTermUpdate = 10;
+// the histograms of all inner bags that are binned together should fit comfortably in the L2 cache
+static constexpr size_t k_cBytesBagsPerPassMax = 262144;
+
+struct BinSumsBoostingSlots {
+   BoosterShell * m_pBoosterShell;
+   size_t m_iTerm;
+   size_t m_iBag;
+   size_t m_cPassBags;
+   bool m_bSingleBin;
+   size_t m_cTensorBins;
+   size_t m_cBytesMainBins;
+   size_t m_cSlots;
+};
+
+template<bool bHessian>
+static void AddQuantizedBins(
+   const size_t cScores,
+   const size_t cTensorBins,
+   const FloatMain gradientScale,
+   const FloatMain hessianScale,
+   const int32_t * const aIntBins,
+   BinBase * const aMainBinsBase
+) {
+   auto * const aMainBins = aMainBinsBase->Specialize<FloatMain, UIntMain, bHessian>();
+   const size_t cBytesPerMainBin = GetBinSize<FloatMain, UIntMain>(bHessian, cScores);
+   const auto * const pMainBinsEnd = IndexBin(aMainBins, cBytesPerMainBin * cTensorBins);
 
+   const int32_t * pIntBin = aIntBins;
+   auto * pMainBin = aMainBins;
+   do {
+      const int32_t cOccurrences = *pIntBin;
+      ++pIntBin;
+      pMainBin->SetCountSamples(pMainBin->GetCountSamples() + static_cast<UIntMain>(cOccurrences));
+      // quantization is only allowed without sample weights, so the weight is the replicated sample count
+      pMainBin->SetWeight(pMainBin->GetWeight() + static_cast<FloatMain>(cOccurrences));
+
+      auto * const aGradientPairs = pMainBin->GetGradientPairs();
+      size_t iScore = 0;
+      do {
+         aGradientPairs[iScore].m_sumGradients += static_cast<FloatMain>(*pIntBin) * gradientScale;
+         ++pIntBin;
+         if(bHessian) {
+            aGradientPairs[iScore].SetHess(aGradientPairs[iScore].GetHess() + 
+               static_cast<FloatMain>(*pIntBin) * hessianScale);
+            ++pIntBin;
+         }
+         ++iScore;
+      } while(cScores != iScore);
 
-EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(
-   void * rng,
-   BoosterHandle boosterHandle,
-   IntEbm indexTerm,
-   TermBoostFlags flags,
-   double learningRate,
-   IntEbm minSamplesLeaf,
-   const IntEbm * leavesMax,
-   double * avgGainOut
+      pMainBin = IndexBin(pMainBin, cBytesPerMainBin);
+   } while(pMainBinsEnd != pMainBin);
+}
+
+static ErrorEbm BinSumsBoostingRange(
+   const BinSumsBoostingSlots * const pSlots,
+   const size_t iSlot,
+   const size_t iSlotBins
 ) {
-   ErrorEbm error;
+   // bins the fixed contiguous range of training subsets that belongs to slot iSlot into the fast and main bins of
+   // iSlotBins. The assignment of subsets to slots does not depend on the thread count, so the results do not either
+   BoosterShell * const pBoosterShell = pSlots->m_pBoosterShell;
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+   const size_t cScores = pBoosterCore->GetCountScores();
+   const size_t cTensorBins = pSlots->m_cTensorBins;
 
-   LOG_COUNTED_N(
-      &g_cLogGenerateTermUpdate,
-      Trace_Info,
-      Trace_Verbose,
-      "GenerateTermUpdate: "
-      "rng=%p, "
-      "boosterHandle=%p, "
-      "indexTerm=%" IntEbmPrintf ", "
-      "flags=0x%" UTermBoostFlagsPrintf ", "
-      "learningRate=%le, "
-      "minSamplesLeaf=%" IntEbmPrintf ", "
-      "leavesMax=%p, "
-      "avgGainOut=%p"
-      ,
-      rng,
-      static_cast<void *>(boosterHandle),
-      indexTerm,
-      static_cast<UTermBoostFlags>(flags), // signed to unsigned conversion is defined behavior in C++
-      learningRate,
-      minSamplesLeaf,
-      static_cast<const void *>(leavesMax),
-      static_cast<void *>(avgGainOut)
-   );
+   // bags [m_iBag, m_iBag + m_cPassBags) are binned together in one pass over each subset
+   const size_t cPassBags = pSlots->m_cPassBags;
+   EBM_ASSERT(1 <= cPassBags);
+   EBM_ASSERT(cPassBags <= pBoosterShell->GetCountBagsPerPass());
 
-   if(LIKELY(nullptr != avgGainOut)) {
-      *avgGainOut = k_illegalGainDouble;
+   size_t iPassBag = 0;
+   do {
+      memset(pBoosterShell->GetBoostingMainBinsSlot(iSlotBins, iPassBag), 0, pSlots->m_cBytesMainBins);
+      ++iPassBag;
+   } while(cPassBags != iPassBag);
+
+   const size_t cSubsets = pBoosterCore->GetTrainingSet()->GetCountSubsets();
+   EBM_ASSERT(1 <= cSubsets);
+   EBM_ASSERT(pSlots->m_cSlots <= cSubsets);
+   EBM_ASSERT(!IsMultiplyError(cSubsets, pSlots->m_cSlots));
+   DataSubsetBoosting * pSubset = pBoosterCore->GetTrainingSet()->GetSubsets() + cSubsets * iSlot / pSlots->m_cSlots;
+   const DataSubsetBoosting * const pSubsetsEnd = 
+      pBoosterCore->GetTrainingSet()->GetSubsets() + cSubsets * (iSlot + 1) / pSlots->m_cSlots;
+   EBM_ASSERT(pSubset < pSubsetsEnd);
+   do {
+      int cPack;
+      if(UNLIKELY(pSlots->m_bSingleBin)) {
+         // this is kind of hacky where if any one of a number of things occurs (like we have only 1 leaf)
+         // we sum everything into a single bin. The alternative would be to always sum into the tensor bins
+         // but then collapse them afterwards into a single bin, but that's more work.
+         cPack = k_cItemsPerBitPackNone;
+      } else {
+         const Term * const pTerm = pBoosterCore->GetTerms()[pSlots->m_iTerm];
+         EBM_ASSERT(1 <= pTerm->GetBitsRequiredMin());
+         cPack = GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+      }
+
+      size_t cBytesPerFastBin;
+      if(sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes) {
+         if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
+            cBytesPerFastBin = GetBinSize<FloatBig, UIntBig>(pBoosterCore->IsHessian(), cScores);
+         } else {
+            EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
+            cBytesPerFastBin = GetBinSize<FloatSmall, UIntBig>(pBoosterCore->IsHessian(), cScores);
+         }
+      } else {
+         EBM_ASSERT(sizeof(UIntSmall) == pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+         if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
+            cBytesPerFastBin = GetBinSize<FloatBig, UIntSmall>(pBoosterCore->IsHessian(), cScores);
+         } else {
+            EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
+            cBytesPerFastBin = GetBinSize<FloatSmall, UIntSmall>(pBoosterCore->IsHessian(), cScores);
+         }
+      }
+      EBM_ASSERT(!IsMultiplyError(cBytesPerFastBin, cTensorBins));
+
+      BinBase * const aFastBins = pBoosterShell->GetBoostingFastBinsSlot(iSlotBins, 0);
+      EBM_ASSERT(nullptr != aFastBins);
+
+      if(nullptr != pSubset->GetQuantizedGradHess()) {
+         // the floating point gradients are gone by now, so we sum the quantized gradients into integer bins.
+         // The integer bins are never larger than the fast bins, so we borrow the fast bins of the first bag
+         const size_t cInt32PerBin = size_t { 1 } + (pBoosterCore->IsHessian() ? size_t { 2 } : size_t { 1 }) * cScores;
+         EBM_ASSERT(sizeof(int32_t) * cInt32PerBin <= cBytesPerFastBin);
+         int32_t * const aIntBins = reinterpret_cast<int32_t *>(aFastBins);
+
+         BinSumsBoostingBridge params;
+         params.m_bHessian = pBoosterCore->IsHessian() ? EBM_TRUE : EBM_FALSE;
+         params.m_cScores = cScores;
+         params.m_cPack = cPack;
+         params.m_cSamples = pSubset->GetCountSamples();
+         params.m_aGradientsAndHessians = pSubset->GetQuantizedGradHess();
+         params.m_aWeights = nullptr;
+         params.m_aPacked = pSubset->GetTermData(pSlots->m_iTerm);
+         params.m_aFastBins = aIntBins;
+         params.m_cQuantizedBytes = pSubset->GetCountQuantizedBytes();
+         params.m_cBags = 1;
+#ifndef NDEBUG
+         params.m_pDebugFastBinsEnd = &aIntBins[cInt32PerBin * cTensorBins];
+#endif // NDEBUG
+
+         iPassBag = 0;
+         do {
+            memset(aIntBins, 0, sizeof(*aIntBins) * cInt32PerBin * cTensorBins);
+            params.m_pCountOccurrences = pSubset->GetInnerBag(pSlots->m_iBag + iPassBag)->GetCountOccurrences();
+            const ErrorEbm error = pSubset->BinSumsBoosting(&params);
+            if(Error_None != error) {
+               return error;
+            }
+
+            BinBase * const aMainBins = pBoosterShell->GetBoostingMainBinsSlot(iSlotBins, iPassBag);
+            if(pBoosterCore->IsHessian()) {
+               AddQuantizedBins<true>(cScores, cTensorBins, pSubset->GetQuantizedGradientScale(), 
+                  pSubset->GetQuantizedHessianScale(), aIntBins, aMainBins);
+            } else {
+               AddQuantizedBins<false>(cScores, cTensorBins, pSubset->GetQuantizedGradientScale(), 
+                  pSubset->GetQuantizedHessianScale(), aIntBins, aMainBins);
+            }
+            ++iPassBag;
+         } while(cPassBags != iPassBag);
+         ++pSubset;
+         continue;
+      }
+
+      BinSumsBoostingBridge params;
+      params.m_bHessian = pBoosterCore->IsHessian() ? EBM_TRUE : EBM_FALSE;
+      params.m_cScores = cScores;
+      params.m_cPack = cPack;
+      params.m_cSamples = pSubset->GetCountSamples();
+      params.m_aGradientsAndHessians = pSubset->GetGradHess();
+      params.m_aPacked = pSubset->GetTermData(pSlots->m_iTerm);
+      params.m_cQuantizedBytes = 0;
+      params.m_cBags = cPassBags;
+      if(size_t { 1 } == cPassBags) {
+         aFastBins->ZeroMem(cBytesPerFastBin, cTensorBins);
+
+         params.m_aWeights = pSubset->GetInnerBag(pSlots->m_iBag)->GetWeights();
+         params.m_pCountOccurrences = pSubset->GetInnerBag(pSlots->m_iBag)->GetCountOccurrences();
+         params.m_aFastBins = aFastBins;
+      } else {
+         EBM_ASSERT(k_cItemsPerBitPackNone != cPack);
+         EBM_ASSERT(size_t { 1 } == cScores);
+
+         params.m_aWeights = nullptr;
+         params.m_pCountOccurrences = nullptr;
+         params.m_aFastBins = nullptr;
+         iPassBag = 0;
+         do {
+            BinBase * const aPassBagFastBins = pBoosterShell->GetBoostingFastBinsSlot(iSlotBins, iPassBag);
+            aPassBagFastBins->ZeroMem(cBytesPerFastBin, cTensorBins);
+
+            const InnerBag * const pInnerBag = pSubset->GetInnerBag(pSlots->m_iBag + iPassBag);
+            params.m_aaBagWeights[iPassBag] = pInnerBag->GetWeights();
+            params.m_apBagCountOccurrences[iPassBag] = pInnerBag->GetCountOccurrences();
+            params.m_aaBagFastBins[iPassBag] = aPassBagFastBins;
+            ++iPassBag;
+         } while(cPassBags != iPassBag);
+      }
+#ifndef NDEBUG
+      params.m_pDebugFastBinsEnd = IndexBin(aFastBins, cBytesPerFastBin * cTensorBins);
+#endif // NDEBUG
+      const ErrorEbm error = pSubset->BinSumsBoosting(&params);
+      if(Error_None != error) {
+         return error;
+      }
+
+      iPassBag = 0;
+      do {
+         ConvertAddBin(
+            cScores,
+            pBoosterCore->IsHessian(),
+            cTensorBins,
+            sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes,
+            sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes,
+            pBoosterShell->GetBoostingFastBinsSlot(iSlotBins, iPassBag),
+            std::is_same<UIntMain, uint64_t>::value,
+            std::is_same<FloatMain, double>::value,
+            pBoosterShell->GetBoostingMainBinsSlot(iSlotBins, iPassBag)
+         );
+         ++iPassBag;
+      } while(cPassBags != iPassBag);
+      ++pSubset;
+   } while(pSubsetsEnd != pSubset);
+
+   return Error_None;
+}
+
+static ErrorEbm BinSumsBoostingSlot(void * const pContext, const size_t iSlot, const size_t iThread) {
+   // each slot has its own fast and main bins when the slots are binned in parallel
+   UNUSED(iThread);
+   return BinSumsBoostingRange(static_cast<const BinSumsBoostingSlots *>(pContext), iSlot, iSlot);
+}
+
+static void AddMainBinsSlot(
+   const BinSumsBoostingSlots * const pSlots,
+   const size_t iSlotBins,
+   const size_t iBinStart,
+   const size_t cBins
+) {
+   // adds the main bins [iBinStart, iBinStart + cBins) of iSlotBins into the first slot for every bag in the pass
+   BoosterShell * const pBoosterShell = pSlots->m_pBoosterShell;
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+   const size_t cScores = pBoosterCore->GetCountScores();
+
+   const size_t cBytesPerMainBin = GetBinSize<FloatMain, UIntMain>(pBoosterCore->IsHessian(), cScores);
+   const size_t iByteStart = cBytesPerMainBin * iBinStart;
+
+   size_t iPassBag = 0;
+   do {
+      ConvertAddBin(
+         cScores,
+         pBoosterCore->IsHessian(),
+         cBins,
+         std::is_same<UIntMain, uint64_t>::value,
+         std::is_same<FloatMain, double>::value,
+         IndexBin(pBoosterShell->GetBoostingMainBinsSlot(iSlotBins, iPassBag), iByteStart),
+         std::is_same<UIntMain, uint64_t>::value,
+         std::is_same<FloatMain, double>::value,
+         IndexBin(pBoosterShell->GetBoostingMainBinsSlot(0, iPassBag), iByteStart)
+      );
+      ++iPassBag;
+   } while(pSlots->m_cPassBags != iPassBag);
+}
+
+static ErrorEbm ReduceMainBinsSlots(void * const pContext, const size_t iTask, const size_t iThread) {
+   // each task adds the slots in slot order into the first slot for a separate range of tensor bins, which is the
+   // same order that BinSumsBoostingAll uses when the slots are binned one after another
+   UNUSED(iThread);
+
+   const BinSumsBoostingSlots * const pSlots = static_cast<const BinSumsBoostingSlots *>(pContext);
+   const size_t cSlots = pSlots->m_cSlots;
+   const size_t cTensorBins = pSlots->m_cTensorBins;
+
+   const size_t cBinsPerTask = (cTensorBins - 1) / cSlots + 1;
+   const size_t iBinStart = cBinsPerTask * iTask;
+   if(cTensorBins <= iBinStart) {
+      return Error_None;
    }
+   const size_t cBins = EbmMin(cBinsPerTask, cTensorBins - iBinStart);
 
-   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
-   if(nullptr == pBoosterShell) {
-      // already logged
-      return Error_IllegalParamVal;
+   size_t iSlot = 1;
+   do {
+      AddMainBinsSlot(pSlots, iSlot, iBinStart, cBins);
+      ++iSlot;
+   } while(cSlots != iSlot);
+
+   return Error_None;
+}
+
+static ErrorEbm BinSumsBoostingAll(BinSumsBoostingSlots * const pSlots) {
+   BoosterShell * const pBoosterShell = pSlots->m_pBoosterShell;
+   const size_t cSlots = pSlots->m_cSlots;
+   if(size_t { 1 } == cSlots) {
+      return BinSumsBoostingRange(pSlots, 0, 0);
    }
 
-   // set this to illegal so if we exit with an error we have an invalid index
-   pBoosterShell->SetTermIndex(BoosterShell::k_illegalTermIndex);
+   ErrorEbm error;
+   if(pBoosterShell->IsBinSumsThreaded()) {
+      ThreadPool * const pThreadPool = pBoosterShell->GetThreadPool();
+      EBM_ASSERT(nullptr != pThreadPool);
+      error = pThreadPool->Run(cSlots, BinSumsBoostingSlot, pSlots);
+      if(Error_None != error) {
+         return error;
+      }
+      return pThreadPool->Run(cSlots, ReduceMainBinsSlots, pSlots);
+   }
 
-   if(indexTerm < 0) {
-      LOG_0(Trace_Error, "ERROR GenerateTermUpdate indexTerm must be positive");
-      return Error_IllegalParamVal;
+   // without threads the slots are binned one after another into the second set of bins and each is added to the
+   // first set as soon as it is complete.  This makes exactly the same sums as the threaded path
+   error = BinSumsBoostingRange(pSlots, 0, 0);
+   if(Error_None != error) {
+      return error;
    }
+   size_t iSlot = 1;
+   do {
+      error = BinSumsBoostingRange(pSlots, iSlot, 1);
+      if(Error_None != error) {
+         return error;
+      }
+      AddMainBinsSlot(pSlots, 1, 0, pSlots->m_cTensorBins);
+      ++iSlot;
+   } while(cSlots != iSlot);
+   return Error_None;
+}
 
-   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
-   EBM_ASSERT(nullptr != pBoosterCore);
+struct BoostBagsContext {
+   BoosterShell * m_pBoosterShell;
+   Term * m_pTerm;
+   size_t m_iTerm;
+   TermBoostFlags m_flags;
+   const IntEbm * m_leavesMax;
+   IntEbm m_lastDimensionLeavesMax;
+   bool m_bSingleBin;
+   size_t m_cSignificantBinCount;
+   size_t m_iDimensionImportant;
+   size_t m_cSamplesLeafMin;
+   size_t m_cRealDimensions;
+   size_t m_cTensorBins;
+   size_t m_cBytesMainBins;
+   double m_gainMultiple;
+#ifndef NDEBUG
+   size_t m_cBytesDebugMainBins;
+#endif // NDEBUG
 
-   if(static_cast<IntEbm>(pBoosterCore->GetCountTerms()) <= indexTerm) {
-      LOG_0(Trace_Error, "ERROR GenerateTermUpdate indexTerm above the number of terms that we have");
-      return Error_IllegalParamVal;
+   // used when boosting the bags in parallel
+   size_t m_cBags;
+};
+
+static ErrorEbm BinSumsBags(
+   const BoostBagsContext * const pContext,
+   BoosterShell * const pBoosterShell,
+   const size_t iBag,
+   const size_t cPassBags
+) {
+   // pBoosterShell is either the shell we were called with or one of its worker shells. The histograms
+   // only touch the scratch memory of pBoosterShell, so several bags can be binned concurrently
+   BinSumsBoostingSlots binSumsSlots;
+   binSumsSlots.m_pBoosterShell = pBoosterShell;
+   binSumsSlots.m_iTerm = pContext->m_iTerm;
+   binSumsSlots.m_iBag = iBag;
+   binSumsSlots.m_cPassBags = cPassBags;
+   binSumsSlots.m_bSingleBin = pContext->m_bSingleBin;
+   binSumsSlots.m_cTensorBins = pContext->m_cTensorBins;
+   binSumsSlots.m_cBytesMainBins = pContext->m_cBytesMainBins;
+   binSumsSlots.m_cSlots = pBoosterShell->GetCountBinSumsSlots();
+   return BinSumsBoostingAll(&binSumsSlots);
+}
+
+static ErrorEbm BoostBag(
+   const BoostBagsContext * const pContext,
+   BoosterShell * const pBoosterShell,
+   RandomDeterministic * const pRng,
+   const size_t iBag,
+   double * const pGainOut
+) {
+   // the histograms for iBag must already be in the main bins of pBoosterShell. The partitioning below only
+   // touches the scratch memory of pBoosterShell, so several bags can run concurrently on different shells
+
+   ErrorEbm error;
+
+#ifndef NDEBUG
+   pBoosterShell->SetDebugMainBinsEnd(IndexBin(pBoosterShell->GetBoostingMainBins(), pContext->m_cBytesDebugMainBins));
+#endif // NDEBUG
+
+   // TODO: we can exit here back to python to allow caller modification to our histograms
+   //       although having inner bags makes this complicated since each inner bag has it's own
+   //       histogram, so we'd need to exit and re-enter 100 times over if we had 100 inner bags
+   //       and we'd need to have the BinBoosting function be called 100 times, followed by 100 calls
+   //       to cut the tensor, then we'd need to have a single final call to combine the results
+   //       which is more complicated.  It will be nicer if we end up eliminated inner bagging
+   //       or use subsampling each boost step to avoid having multiple inner bags
+
+   *pGainOut = 0.0;
+   if(UNLIKELY(pContext->m_bSingleBin)) {
+      LOG_0(Trace_Warning, "WARNING GenerateTermUpdate boosting zero dimensional");
+      BoostZeroDimensional(pBoosterShell, pContext->m_flags);
+   } else {
+      const double weightTotal = pBoosterShell->GetBoosterCore()->GetTrainingSet()->GetBagWeightTotal(iBag);
+      EBM_ASSERT(0 < weightTotal); // if all are zeros we assume there are no weights and use the count
+
+      double gain;
+      if(0 != (TermBoostFlags_RandomSplits & pContext->m_flags) || 2 < pContext->m_cRealDimensions) {
+         if(size_t { 1 } != pContext->m_cSamplesLeafMin) {
+            LOG_0(Trace_Warning,
+               "WARNING GenerateTermUpdate cSamplesLeafMin is ignored when doing random splitting"
+            );
+         }
+         // THIS RANDOM SPLIT OPTION IS PRIMARILY USED FOR DIFFERENTIAL PRIVACY EBMs
+
+         error = BoostRandom(
+            pRng,
+            pBoosterShell,
+            pContext->m_iTerm,
+            pContext->m_flags,
+            pContext->m_leavesMax,
+            &gain
+         );
+         if(Error_None != error) {
+            return error;
+         }
+      } else if(1 == pContext->m_cRealDimensions) {
+         EBM_ASSERT(nullptr != pContext->m_leavesMax); // otherwise we'd use BoostZeroDimensional above
+         EBM_ASSERT(IntEbm { 2 } <= pContext->m_lastDimensionLeavesMax); // otherwise we'd use BoostZeroDimensional above
+         EBM_ASSERT(size_t { 2 } <= pContext->m_cSignificantBinCount); // otherwise we'd use BoostZeroDimensional above
+
+         EBM_ASSERT(1 == pContext->m_pTerm->GetCountRealDimensions());
+         EBM_ASSERT(pContext->m_cSignificantBinCount == pContext->m_pTerm->GetCountTensorBins());
+         EBM_ASSERT(0 == pContext->m_pTerm->GetCountAuxillaryBins());
+
+         error = BoostSingleDimensional(
+            pRng,
+            pBoosterShell,
+            pContext->m_cSignificantBinCount,
+            static_cast<FloatMain>(weightTotal),
+            pContext->m_iDimensionImportant,
+            pContext->m_cSamplesLeafMin,
+            pContext->m_lastDimensionLeavesMax,
+            &gain
+         );
+         if(Error_None != error) {
+            return error;
+         }
+      } else {
+         error = BoostMultiDimensional(
+            pBoosterShell,
+            pContext->m_iTerm,
+            pContext->m_cSamplesLeafMin,
+            &gain
+         );
+         if(Error_None != error) {
+            return error;
+         }
+      }
+
+      // gain should be +inf if there was an overflow in our callees
+      EBM_ASSERT(!std::isnan(gain));
+      EBM_ASSERT(0 <= gain);
+
+      // this could re-promote gain to be +inf again if weightTotal < 1.0
+      // do the sample count inversion here in case adding all the avgeraged gains pushes us into +inf
+      *pGainOut = gain / weightTotal * pContext->m_gainMultiple;
    }
-   size_t iTerm = static_cast<size_t>(indexTerm);
 
-   // this is true because 0 < pBoosterCore->m_cTerms since our caller needs to pass in a valid indexTerm to this function
-   EBM_ASSERT(nullptr != pBoosterCore->GetTerms());
-   Term * const pTerm = pBoosterCore->GetTerms()[iTerm];
+   return Error_None;
+}
 
-   LOG_COUNTED_0(
-      pTerm->GetPointerCountLogEnterGenerateTermUpdateMessages(),
-      Trace_Info,
-      Trace_Verbose,
-      "Entered GenerateTermUpdate"
+static ErrorEbm BoostBagTask(void * const pContext, const size_t iBag, const size_t iThread) {
+   const BoostBagsContext * const pBoostBags = static_cast<const BoostBagsContext *>(pContext);
+   BoosterShell * const pBoosterShell = pBoostBags->m_pBoosterShell;
+   BoosterShell * const pWorkerShell = pBoosterShell->GetWorkerShell(iThread);
+
+   ErrorEbm error = BinSumsBags(pBoostBags, pWorkerShell, iBag, 1);
+   if(Error_None != error) {
+      return error;
+   }
+
+   error = BoostBag(
+      pBoostBags,
+      pWorkerShell,
+      &pBoosterShell->GetBagRngs()[iBag],
+      iBag,
+      &pBoosterShell->GetBagGains()[iBag]
    );
+   if(Error_None != error) {
+      return error;
+   }
 
-   if(0 != (static_cast<UTermBoostFlags>(flags) & static_cast<UTermBoostFlags>(~(
-      static_cast<UTermBoostFlags>(TermBoostFlags_DisableNewtonGain) |
-      static_cast<UTermBoostFlags>(TermBoostFlags_DisableNewtonUpdate) |
-      static_cast<UTermBoostFlags>(TermBoostFlags_GradientSums) |
-      static_cast<UTermBoostFlags>(TermBoostFlags_RandomSplits)
-   )))) {
-      LOG_0(Trace_Error, "ERROR GenerateTermUpdate flags contains unknown flags. Ignoring extras.");
+   // the worker shell will be reused for another bag, so keep a copy of this bag's update for merging later
+   return pBoosterShell->GetBagTermUpdate(iBag)->Copy(*pWorkerShell->GetInnerTermUpdate());
+}
+
+static ErrorEbm BoostBagsParallel(
+   BoostBagsContext * const pContext, 
+   RandomDeterministic * const pRng, 
+   double * const pGainAvgOut
+) {
+   BoosterShell * const pBoosterShell = pContext->m_pBoosterShell;
+   ThreadPool * const pThreadPool = pBoosterShell->GetThreadPool();
+   EBM_ASSERT(nullptr != pThreadPool);
+   const size_t cBags = pContext->m_cBags;
+   EBM_ASSERT(2 <= cBags);
+   const size_t cDimensions = pContext->m_pTerm->GetCountDimensions();
+
+   ErrorEbm error;
+
+   // the bags can be boosted in any order, so give each bag its own rng, seeded in bag order.  The serial path
+   // seeds its bags the same way, so the thread count does not change random splits
+   RandomDeterministic * const aBagRngs = pBoosterShell->GetBagRngs();
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      aBagRngs[iBag].Initialize(pRng->Next<uint64_t>());
+      pBoosterShell->GetBagTermUpdate(iBag)->SetCountDimensions(cDimensions);
+   }
+   for(size_t iWorker = 0; iWorker < pBoosterShell->GetCountBagWorkers(); ++iWorker) {
+      Tensor * const pInnerTermUpdate = pBoosterShell->GetWorkerShell(iWorker)->GetInnerTermUpdate();
+      pInnerTermUpdate->SetCountDimensions(cDimensions);
+      pInnerTermUpdate->Reset();
    }
 
-   if(std::isnan(learningRate)) {
-      LOG_0(Trace_Warning, "WARNING GenerateTermUpdate learningRate is NaN");
-   } else if(std::numeric_limits<double>::infinity() == learningRate) {
-      LOG_0(Trace_Warning, "WARNING GenerateTermUpdate learningRate is +infinity");
-   } else if(0.0 == learningRate) {
-      LOG_0(Trace_Warning, "WARNING GenerateTermUpdate learningRate is zero");
-   } else if(learningRate < double { 0 }) {
-      LOG_0(Trace_Warning, "WARNING GenerateTermUpdate learningRate is negative");
+   error = pThreadPool->Run(cBags, BoostBagTask, pContext);
+   if(Error_None != error) {
+      return error;
    }
 
-   size_t cSamplesLeafMin = size_t { 1 }; // this is the min value
-   if(IntEbm { 1 } <= minSamplesLeaf) {
-      cSamplesLeafMin = static_cast<size_t>(minSamplesLeaf);
-      if(IsConvertError<size_t>(minSamplesLeaf)) {
-         // we can never exceed a size_t number of samples, so let's just set it to the maximum if we were going to 
-         // overflow because it will generate the same results as if we used the true number
-         cSamplesLeafMin = std::numeric_limits<size_t>::max();
+   // merge the bag updates in bag order, which is the order that the serial path adds them in, so that the
+   // floating point sums are identical for any thread count.  Merging is cheap next to boosting a bag
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      error = pBoosterShell->GetTermUpdate()->Add(*pBoosterShell->GetBagTermUpdate(iBag));
+      if(Error_None != error) {
+         return error;
       }
-   } else {
-      LOG_0(Trace_Warning, "WARNING GenerateTermUpdate minSamplesLeaf can't be less than 1.  Adjusting to 1.");
    }
 
+   double gainAvg = 0.0;
+   const double * const aBagGains = pBoosterShell->GetBagGains();
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      gainAvg += aBagGains[iBag];
+      EBM_ASSERT(!std::isnan(gainAvg));
+      EBM_ASSERT(0.0 <= gainAvg);
+   }
+   *pGainAvgOut = gainAvg;
+   return Error_None;
+}
+
+
+// GenerateTermUpdateInternal boosts a term on a BoosterShell that our caller has already validated.  BoostRounds 
+// calls it directly so that every round does not pay for the handle checks and logging of GenerateTermUpdate
+extern ErrorEbm GenerateTermUpdateInternal(
+   RandomDeterministic * pRng,
+   BoosterShell * const pBoosterShell,
+   const size_t iTerm,
+   const TermBoostFlags flags,
+   const double learningRate,
+   const size_t cSamplesLeafMin,
+   const IntEbm * const leavesMax,
+   double * const pGainAvgOut
+) {
+   ErrorEbm error;
+
+   EBM_ASSERT(nullptr != pBoosterShell);
+   EBM_ASSERT(BoosterShell::k_illegalTermIndex == pBoosterShell->GetTermIndex());
+   EBM_ASSERT(nullptr != pGainAvgOut);
+
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+   EBM_ASSERT(nullptr != pBoosterCore);
+   EBM_ASSERT(iTerm < pBoosterCore->GetCountTerms());
+   EBM_ASSERT(nullptr != pBoosterCore->GetTerms());
+   Term * const pTerm = pBoosterCore->GetTerms()[iTerm];
+
    const size_t cScores = pBoosterCore->GetCountScores();
    if(size_t { 0 } == cScores) {
       // if there is only 1 target class for classification, then we can predict the output with 100% accuracy.  
       // The term scores are a tensor with zero length array logits, which means for our representation that we have 
       // zero items in the array total. Since we can predit the output with 100% accuracy, our gain will be 0.
-      if(LIKELY(nullptr != avgGainOut)) {
-         *avgGainOut = 0.0;
-      }
+      *pGainAvgOut = 0.0;
       pBoosterShell->SetTermIndex(iTerm);
 
       LOG_0(Trace_Warning, "WARNING GenerateTermUpdate size_t { 0 } == cScores");
@@ -576,9 +1032,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(
       // if GetCountTensorBins is 0, then we leave pBoosterShell->GetTermUpdate() with invalid data since
       // out Tensor class does not support tensors of zero elements
 
-      if(LIKELY(nullptr != avgGainOut)) {
-         *avgGainOut = 0.0;
-      }
+      *pGainAvgOut = 0.0;
       pBoosterShell->SetTermIndex(iTerm);
 
       LOG_0(Trace_Warning, "WARNING GenerateTermUpdate size_t { 0 } == cTensorBins");
@@ -659,7 +1113,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(
       multiple *= learningRate;
       gainMultiple *= gradientConstant;
 
-      RandomDeterministic * pRng = reinterpret_cast<RandomDeterministic *>(rng);
       RandomDeterministic rngInternal;
       // TODO: move this code down into our called functions since we can happily pass down nullptr into there and then use the rng CPU register trick at the lowest function level
       if(nullptr == pRng) {
@@ -703,16 +1156,10 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(
          cTensorBins = 1;
       }
 
-      BinBase * const aFastBins = pBoosterShell->GetBoostingFastBinsTemp();
-      EBM_ASSERT(nullptr != aFastBins);
-
       const size_t cBytesPerMainBin = GetBinSize<FloatMain, UIntMain>(pBoosterCore->IsHessian(), cScores);
       EBM_ASSERT(!IsMultiplyError(cBytesPerMainBin, cTensorBins));
       const size_t cBytesMainBins = cBytesPerMainBin * cTensorBins;
 
-      BinBase * const aMainBins = pBoosterShell->GetBoostingMainBins();
-      EBM_ASSERT(nullptr != aMainBins);
-
 #ifndef NDEBUG
       size_t cAuxillaryBins = pTerm->GetCountAuxillaryBins();
       if(0 != (TermBoostFlags_RandomSplits & flags) || 2 < cRealDimensions) {
@@ -721,173 +1168,87 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(
       }
       EBM_ASSERT(!IsAddError(cTensorBins, cAuxillaryBins));
       EBM_ASSERT(!IsMultiplyError(cBytesPerMainBin, cTensorBins + cAuxillaryBins));
-      pBoosterShell->SetDebugMainBinsEnd(IndexBin(aMainBins, cBytesPerMainBin * (cTensorBins + cAuxillaryBins)));
 #endif // NDEBUG
 
-      size_t iBag = 0;
+      BoostBagsContext boostBags;
+      boostBags.m_pBoosterShell = pBoosterShell;
+      boostBags.m_pTerm = pTerm;
+      boostBags.m_iTerm = iTerm;
+      boostBags.m_flags = flags;
+      boostBags.m_leavesMax = leavesMax;
+      boostBags.m_lastDimensionLeavesMax = lastDimensionLeavesMax;
+      boostBags.m_bSingleBin = IntEbm { 0 } == lastDimensionLeavesMax;
+      boostBags.m_cSignificantBinCount = cSignificantBinCount;
+      boostBags.m_iDimensionImportant = iDimensionImportant;
+      boostBags.m_cSamplesLeafMin = cSamplesLeafMin;
+      boostBags.m_cRealDimensions = cRealDimensions;
+      boostBags.m_cTensorBins = cTensorBins;
+      boostBags.m_cBytesMainBins = cBytesMainBins;
+      boostBags.m_gainMultiple = gainMultiple;
+#ifndef NDEBUG
+      boostBags.m_cBytesDebugMainBins = cBytesPerMainBin * (cTensorBins + cAuxillaryBins);
+#endif // NDEBUG
+      boostBags.m_cBags = cInnerBagsAfterZero;
+
       EBM_ASSERT(1 <= cInnerBagsAfterZero);
-      do {
-         memset(aMainBins, 0, cBytesMainBins);
+      if(size_t { 2 } <= pBoosterShell->GetCountBagWorkers()) {
+         error = BoostBagsParallel(&boostBags, pRng, &gainAvg);
+         if(Error_None != error) {
+            return error;
+         }
+      } else {
+         // Binning is bound by reading the term data and gradients, which are the same for every inner bag, so
+         // we bin several bags together in one pass when their histograms are small enough to stay in the cache
+         size_t cBagsPerPass = 1;
+         if(!boostBags.m_bSingleBin && size_t { 2 } <= pBoosterShell->GetCountBagsPerPass()) {
+            cBagsPerPass = EbmMin(pBoosterShell->GetCountBagsPerPass(), 
+               EbmMax(size_t { 1 }, k_cBytesBagsPerPassMax / cBytesMainBins));
+         }
 
-         EBM_ASSERT(1 <= pBoosterCore->GetTrainingSet()->GetCountSubsets());
-         DataSubsetBoosting * pSubset = pBoosterCore->GetTrainingSet()->GetSubsets();
-         const DataSubsetBoosting * const pSubsetsEnd = pSubset + pBoosterCore->GetTrainingSet()->GetCountSubsets();
+         size_t iBag = 0;
          do {
-            int cPack;
-            if(UNLIKELY(IntEbm { 0 } == lastDimensionLeavesMax)) {
-               // this is kind of hacky where if any one of a number of things occurs (like we have only 1 leaf)
-               // we sum everything into a single bin. The alternative would be to always sum into the tensor bins
-               // but then collapse them afterwards into a single bin, but that's more work.
-               cPack = k_cItemsPerBitPackNone;
-            } else {
-               EBM_ASSERT(1 <= pTerm->GetBitsRequiredMin());
-               cPack = GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-            }
-
-            size_t cBytesPerFastBin;
-            if(sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes) {
-               if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
-                  cBytesPerFastBin = GetBinSize<FloatBig, UIntBig>(pBoosterCore->IsHessian(), cScores);
-               } else {
-                  EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-                  cBytesPerFastBin = GetBinSize<FloatSmall, UIntBig>(pBoosterCore->IsHessian(), cScores);
-               }
-            } else {
-               EBM_ASSERT(sizeof(UIntSmall) == pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-               if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
-                  cBytesPerFastBin = GetBinSize<FloatBig, UIntSmall>(pBoosterCore->IsHessian(), cScores);
-               } else {
-                  EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-                  cBytesPerFastBin = GetBinSize<FloatSmall, UIntSmall>(pBoosterCore->IsHessian(), cScores);
-               }
-            }
-            EBM_ASSERT(!IsMultiplyError(cBytesPerFastBin, cTensorBins));
-
-            aFastBins->ZeroMem(cBytesPerFastBin, cTensorBins);
-
-            BinSumsBoostingBridge params;
-            params.m_bHessian = pBoosterCore->IsHessian() ? EBM_TRUE : EBM_FALSE;
-            params.m_cScores = cScores;
-            params.m_cPack = cPack;
-            params.m_cSamples = pSubset->GetCountSamples();
-            params.m_aGradientsAndHessians = pSubset->GetGradHess();
-            params.m_aWeights = pSubset->GetInnerBag(iBag)->GetWeights();
-            params.m_pCountOccurrences = pSubset->GetInnerBag(iBag)->GetCountOccurrences();
-            params.m_aPacked = pSubset->GetTermData(iTerm);
-            params.m_aFastBins = aFastBins;
-   #ifndef NDEBUG
-            params.m_pDebugFastBinsEnd = IndexBin(aFastBins, cBytesPerFastBin * cTensorBins);
-   #endif // NDEBUG
-            error = pSubset->BinSumsBoosting(&params);
+            const size_t cPassBags = EbmMin(cBagsPerPass, cInnerBagsAfterZero - iBag);
+            error = BinSumsBags(&boostBags, pBoosterShell, iBag, cPassBags);
             if(Error_None != error) {
                return error;
             }
 
-            ConvertAddBin(
-               cScores,
-               pBoosterCore->IsHessian(),
-               cTensorBins,
-               sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes,
-               sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes,
-               aFastBins,
-               std::is_same<UIntMain, uint64_t>::value,
-               std::is_same<FloatMain, double>::value,
-               aMainBins
-            );
-            ++pSubset;
-         } while(pSubsetsEnd != pSubset);
-
-         // TODO: we can exit here back to python to allow caller modification to our histograms
-         //       although having inner bags makes this complicated since each inner bag has it's own
-         //       histogram, so we'd need to exit and re-enter 100 times over if we had 100 inner bags
-         //       and we'd need to have the BinBoosting function be called 100 times, followed by 100 calls
-         //       to cut the tensor, then we'd need to have a single final call to combine the results
-         //       which is more complicated.  It will be nicer if we end up eliminated inner bagging
-         //       or use subsampling each boost step to avoid having multiple inner bags
-
-
-         if(UNLIKELY(IntEbm { 0 } == lastDimensionLeavesMax)) {
-            LOG_0(Trace_Warning, "WARNING GenerateTermUpdate boosting zero dimensional");
-            BoostZeroDimensional(pBoosterShell, flags);
-         } else {
-            const double weightTotal = pBoosterCore->GetTrainingSet()->GetBagWeightTotal(iBag);
-            EBM_ASSERT(0 < weightTotal); // if all are zeros we assume there are no weights and use the count
-
-            double gain;
-            if(0 != (TermBoostFlags_RandomSplits & flags) || 2 < cRealDimensions) {
-               if(size_t { 1 } != cSamplesLeafMin) {
-                  LOG_0(Trace_Warning,
-                     "WARNING GenerateTermUpdate cSamplesLeafMin is ignored when doing random splitting"
-                  );
+            size_t iPassBag = 0;
+            do {
+               if(size_t { 0 } != iPassBag) {
+                  // the partitioning code works on the first main bins, which we are done with
+                  memcpy(pBoosterShell->GetBoostingMainBins(), 
+                     pBoosterShell->GetBoostingMainBinsSlot(0, iPassBag), cBytesMainBins);
                }
-               // THIS RANDOM SPLIT OPTION IS PRIMARILY USED FOR DIFFERENTIAL PRIVACY EBMs
-
-               error = BoostRandom(
-                  pRng,
-                  pBoosterShell,
-                  iTerm,
-                  flags,
-                  leavesMax,
-                  &gain
-               );
-               if(Error_None != error) {
-                  return error;
+
+               // seed each bag from pRng exactly like BoostBagsParallel does.  A lone bag uses pRng directly,
+               // which keeps the models from before bags could be boosted in parallel
+               RandomDeterministic rngBag;
+               RandomDeterministic * pRngBag = pRng;
+               if(size_t { 1 } != cInnerBagsAfterZero) {
+                  rngBag.Initialize(pRng->Next<uint64_t>());
+                  pRngBag = &rngBag;
                }
-            } else if(1 == cRealDimensions) {
-               EBM_ASSERT(nullptr != leavesMax); // otherwise we'd use BoostZeroDimensional above
-               EBM_ASSERT(IntEbm { 2 } <= lastDimensionLeavesMax); // otherwise we'd use BoostZeroDimensional above
-               EBM_ASSERT(size_t { 2 } <= cSignificantBinCount); // otherwise we'd use BoostZeroDimensional above
-
-               EBM_ASSERT(1 == pTerm->GetCountRealDimensions());
-               EBM_ASSERT(cSignificantBinCount == pTerm->GetCountTensorBins());
-               EBM_ASSERT(0 == pTerm->GetCountAuxillaryBins());
-
-               error = BoostSingleDimensional(
-                  pRng,
-                  pBoosterShell,
-                  cSignificantBinCount,
-                  static_cast<FloatMain>(weightTotal),
-                  iDimensionImportant,
-                  cSamplesLeafMin,
-                  lastDimensionLeavesMax,
-                  &gain
-               );
+
+               double gain;
+               error = BoostBag(&boostBags, pBoosterShell, pRngBag, iBag, &gain);
                if(Error_None != error) {
                   return error;
                }
-            } else {
-               error = BoostMultiDimensional(
-                  pBoosterShell,
-                  iTerm,
-                  cSamplesLeafMin,
-                  &gain
-               );
+               gainAvg += gain;
+               EBM_ASSERT(!std::isnan(gainAvg));
+               EBM_ASSERT(0.0 <= gainAvg);
+
+               error = pBoosterShell->GetTermUpdate()->Add(*pBoosterShell->GetInnerTermUpdate());
                if(Error_None != error) {
                   return error;
                }
-            }
-
-            // gain should be +inf if there was an overflow in our callees
-            EBM_ASSERT(!std::isnan(gain));
-            EBM_ASSERT(0 <= gain);
 
-            // this could re-promote gain to be +inf again if weightTotal < 1.0
-            // do the sample count inversion here in case adding all the avgeraged gains pushes us into +inf
-            gain = gain / weightTotal * gainMultiple;
-            gainAvg += gain;
-            EBM_ASSERT(!std::isnan(gainAvg));
-            EBM_ASSERT(0.0 <= gainAvg);
-         }
-
-         // TODO : when we thread this code, let's have each thread take a lock and update the combined line segment.  They'll each do it while the 
-         // others are working, so there should be no blocking and our final result won't require adding by the main thread
-         error = pBoosterShell->GetTermUpdate()->Add(*pBoosterShell->GetInnerTermUpdate());
-         if(Error_None != error) {
-            return error;
-         }
-
-         ++iBag;
-      } while(cInnerBagsAfterZero != iBag);
+               ++iBag;
+               ++iPassBag;
+            } while(cPassBags != iPassBag);
+         } while(cInnerBagsAfterZero != iBag);
+      }
 
       // gainAvg is +inf on overflow. It cannot be NaN, but check for that anyways since it's free
       EBM_ASSERT(!std::isnan(gainAvg));
@@ -962,6 +1323,135 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(
    EBM_ASSERT(std::numeric_limits<double>::infinity() != gainAvg);
    EBM_ASSERT(k_illegalGainDouble == gainAvg || double { 0 } <= gainAvg);
 
+   *pGainAvgOut = gainAvg;
+   return Error_None;
+}
+
+// we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before getting 
+// the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us we only decrease the count if the 
+// count is non-zero, so at worst if there is a race condition then we'll output this log message more times than desired, but we can live with that
+static int g_cLogGenerateTermUpdate = 10;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(
+   void * rng,
+   BoosterHandle boosterHandle,
+   IntEbm indexTerm,
+   TermBoostFlags flags,
+   double learningRate,
+   IntEbm minSamplesLeaf,
+   const IntEbm * leavesMax,
+   double * avgGainOut
+) {
+   ErrorEbm error;
+
+   LOG_COUNTED_N(
+      &g_cLogGenerateTermUpdate,
+      Trace_Info,
+      Trace_Verbose,
+      "GenerateTermUpdate: "
+      "rng=%p, "
+      "boosterHandle=%p, "
+      "indexTerm=%" IntEbmPrintf ", "
+      "flags=0x%" UTermBoostFlagsPrintf ", "
+      "learningRate=%le, "
+      "minSamplesLeaf=%" IntEbmPrintf ", "
+      "leavesMax=%p, "
+      "avgGainOut=%p"
+      ,
+      rng,
+      static_cast<void *>(boosterHandle),
+      indexTerm,
+      static_cast<UTermBoostFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      learningRate,
+      minSamplesLeaf,
+      static_cast<const void *>(leavesMax),
+      static_cast<void *>(avgGainOut)
+   );
+
+   if(LIKELY(nullptr != avgGainOut)) {
+      *avgGainOut = k_illegalGainDouble;
+   }
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   // set this to illegal so if we exit with an error we have an invalid index
+   pBoosterShell->SetTermIndex(BoosterShell::k_illegalTermIndex);
+
+   if(indexTerm < 0) {
+      LOG_0(Trace_Error, "ERROR GenerateTermUpdate indexTerm must be positive");
+      return Error_IllegalParamVal;
+   }
+
+   BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+   EBM_ASSERT(nullptr != pBoosterCore);
+
+   if(static_cast<IntEbm>(pBoosterCore->GetCountTerms()) <= indexTerm) {
+      LOG_0(Trace_Error, "ERROR GenerateTermUpdate indexTerm above the number of terms that we have");
+      return Error_IllegalParamVal;
+   }
+   const size_t iTerm = static_cast<size_t>(indexTerm);
+
+   // this is true because 0 < pBoosterCore->m_cTerms since our caller needs to pass in a valid indexTerm to this function
+   EBM_ASSERT(nullptr != pBoosterCore->GetTerms());
+   Term * const pTerm = pBoosterCore->GetTerms()[iTerm];
+
+   LOG_COUNTED_0(
+      pTerm->GetPointerCountLogEnterGenerateTermUpdateMessages(),
+      Trace_Info,
+      Trace_Verbose,
+      "Entered GenerateTermUpdate"
+   );
+
+   if(0 != (static_cast<UTermBoostFlags>(flags) & static_cast<UTermBoostFlags>(~(
+      static_cast<UTermBoostFlags>(TermBoostFlags_DisableNewtonGain) |
+      static_cast<UTermBoostFlags>(TermBoostFlags_DisableNewtonUpdate) |
+      static_cast<UTermBoostFlags>(TermBoostFlags_GradientSums) |
+      static_cast<UTermBoostFlags>(TermBoostFlags_RandomSplits)
+   )))) {
+      LOG_0(Trace_Error, "ERROR GenerateTermUpdate flags contains unknown flags. Ignoring extras.");
+   }
+
+   if(std::isnan(learningRate)) {
+      LOG_0(Trace_Warning, "WARNING GenerateTermUpdate learningRate is NaN");
+   } else if(std::numeric_limits<double>::infinity() == learningRate) {
+      LOG_0(Trace_Warning, "WARNING GenerateTermUpdate learningRate is +infinity");
+   } else if(0.0 == learningRate) {
+      LOG_0(Trace_Warning, "WARNING GenerateTermUpdate learningRate is zero");
+   } else if(learningRate < double { 0 }) {
+      LOG_0(Trace_Warning, "WARNING GenerateTermUpdate learningRate is negative");
+   }
+
+   size_t cSamplesLeafMin = size_t { 1 }; // this is the min value
+   if(IntEbm { 1 } <= minSamplesLeaf) {
+      cSamplesLeafMin = static_cast<size_t>(minSamplesLeaf);
+      if(IsConvertError<size_t>(minSamplesLeaf)) {
+         // we can never exceed a size_t number of samples, so let's just set it to the maximum if we were going to 
+         // overflow because it will generate the same results as if we used the true number
+         cSamplesLeafMin = std::numeric_limits<size_t>::max();
+      }
+   } else {
+      LOG_0(Trace_Warning, "WARNING GenerateTermUpdate minSamplesLeaf can't be less than 1.  Adjusting to 1.");
+   }
+
+   double gainAvg;
+   error = GenerateTermUpdateInternal(
+      reinterpret_cast<RandomDeterministic *>(rng),
+      pBoosterShell,
+      iTerm,
+      flags,
+      learningRate,
+      cSamplesLeafMin,
+      leavesMax,
+      &gainAvg
+   );
+   if(Error_None != error) {
+      return error;
+   }
+
    if(nullptr != avgGainOut) {
       *avgGainOut = gainAvg;
    }
@@ -135,7 +135,6 @@ WARNING_PUSH
 WARNING_DISABLE_UNINITIALIZED_LOCAL_VARIABLE
 extern void InitializeRmseGradientsAndHessiansInteraction(
    const unsigned char * const pDataSetShared,
-   const size_t cWeights,
    const BagEbm * const aBag,
    const double * const aInitScores,
    DataSetInteraction * const pDataSet
@@ -157,12 +156,6 @@ extern void InitializeRmseGradientsAndHessiansInteraction(
       DataSubsetInteraction * pSubset = pDataSet->GetSubsets();
       EBM_ASSERT(nullptr != pSubset);
 
-      const FloatShared * pWeight = nullptr;
-      if(size_t { 0 } != cWeights) {
-         pWeight = GetDataSetSharedWeight(pDataSetShared, 0);
-         EBM_ASSERT(nullptr != pWeight);
-      }
-
       EBM_ASSERT(1 <= pDataSet->GetCountSubsets());
       const DataSubsetInteraction * const pSubsetsEnd = pSubset + pDataSet->GetCountSubsets();
 
@@ -177,9 +170,6 @@ extern void InitializeRmseGradientsAndHessiansInteraction(
          void * pGradHess = pSubset->GetGradHess();
          EBM_ASSERT(nullptr != pGradHess);
          const void * const pGradHessEnd = IndexByte(pGradHess, pSubset->GetObjectiveWrapper()->m_cFloatBytes * pSubset->GetCountSamples());
-
-         EBM_ASSERT(nullptr == pWeight && nullptr == pSubset->GetWeights() ||
-            nullptr != pWeight && nullptr != pSubset->GetWeights());
          do {
             if(BagEbm { 0 } == replication) {
                replication = 1;
@@ -219,16 +209,6 @@ extern void InitializeRmseGradientsAndHessiansInteraction(
                // to keep the original scores when computing the gradient updates.
 
                gradient = initScore - static_cast<double>(data);
-
-               if(nullptr != pWeight) {
-                  // This is only used during the initialization of interaction detection. For boosting
-                  // we currently multiply by the weight during bin summation instead since we use the weight
-                  // there to include the inner bagging counts of occurences.
-                  // Whether this multiplication happens or not is controlled by the caller by passing in the
-                  // weight array or not.
-                  pWeight += cSharedAdvances;
-                  gradient *= static_cast<double>(pWeight[-1]);
-               }
             }
 
             if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
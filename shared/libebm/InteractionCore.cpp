@@ -20,6 +20,7 @@
 #include "Feature.hpp" // Feature
 #include "dataset_shared.hpp" // GetDataSetSharedHeader
 #include "InteractionCore.hpp"
+#include "BoosterCore.hpp" // BoosterCore
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -37,6 +38,8 @@ extern ErrorEbm GetObjective(
    const Config * const pConfig,
    const char * sObjective,
    const AccelerationFlags acceleration,
+   const bool bDoublePrecision,
+   const bool bFloat32,
    ObjectiveWrapper * const pCpuObjectiveWrapperOut,
    ObjectiveWrapper * const pSIMDObjectiveWrapperOut
 ) noexcept;
@@ -60,7 +63,10 @@ void InteractionCore::Free(InteractionCore * const pInteractionCore) {
          // object
          std::atomic_thread_fence(std::memory_order_acquire);
          LOG_0(Trace_Info, "INFO InteractionCore::Free deleting InteractionCore");
+         BoosterCore * const pBoosterCore = pInteractionCore->m_pBoosterCore;
          delete pInteractionCore;
+         // release the booster after we no longer reference its dataset or objectives
+         BoosterCore::Free(pBoosterCore);
       }
    }
 
@@ -229,7 +235,6 @@ ErrorEbm InteractionCore::Create(
             &defaultValSparse,
             &cNonDefaultsSparse
          );
-         EBM_ASSERT(!bSparse); // not handled yet
 
          if(IsConvertError<size_t>(countBins)) {
             LOG_0(Trace_Error, "ERROR InteractionCore::Create IsConvertError<size_t>(countBins)");
@@ -284,6 +289,10 @@ ErrorEbm InteractionCore::Create(
          &config, 
          sObjective, 
          acceleration,
+         // with approximations disabled the caller wants double results, so stay out of the float32 zones unless
+         // float32 was asked for explicitly
+         0 != (CreateInteractionFlags_DisableApprox & flags) && 0 == (CreateInteractionFlags_Float32 & flags),
+         0 != (CreateInteractionFlags_Float32 & flags),
          &pInteractionCore->m_objectiveCpu, 
          &pInteractionCore->m_objectiveSIMD
       );
@@ -353,7 +362,8 @@ ErrorEbm InteractionCore::Create(
             aBag,
             cTrainingSamples,
             cWeights,
-            cFeatures
+            cFeatures,
+            0 != (CreateInteractionFlags_TargetSorted & flags)
          );
          if(Error_None != error) {
             return error;
@@ -370,11 +380,130 @@ ErrorEbm InteractionCore::Create(
    return Error_None;
 }
 
+ErrorEbm InteractionCore::CreateFromBooster(
+   BoosterCore * const pBoosterCore,
+   InteractionCore ** const ppInteractionCoreOut
+) {
+   LOG_0(Trace_Info, "Entered InteractionCore::CreateFromBooster");
+
+   EBM_ASSERT(nullptr != pBoosterCore);
+   EBM_ASSERT(nullptr != ppInteractionCoreOut);
+   EBM_ASSERT(nullptr == *ppInteractionCoreOut);
+
+   if(EBM_FALSE != pBoosterCore->IsQuantizeGradients()) {
+      // the booster only keeps the quantized training gradients, which the interaction BinSums cannot read
+      LOG_0(Trace_Warning, "WARNING InteractionCore::CreateFromBooster the booster quantizes its gradients");
+      return Error_IllegalParamVal;
+   }
+
+   ErrorEbm error;
+
+   InteractionCore * pInteractionCore;
+   try {
+      pInteractionCore = new InteractionCore();
+   } catch(const std::bad_alloc &) {
+      LOG_0(Trace_Warning, "WARNING InteractionCore::CreateFromBooster Out of memory allocating InteractionCore");
+      return Error_OutOfMemory;
+   } catch(...) {
+      LOG_0(Trace_Warning, "WARNING InteractionCore::CreateFromBooster Unknown error");
+      return Error_UnexpectedInternal;
+   }
+   if(nullptr == pInteractionCore) {
+      LOG_0(Trace_Warning, "WARNING InteractionCore::CreateFromBooster nullptr == pInteractionCore");
+      return Error_OutOfMemory;
+   }
+   *ppInteractionCoreOut = pInteractionCore;
+
+   // from here on the booster lives at least as long as we do, even if we fail below
+   pBoosterCore->AddReferenceCount();
+   pInteractionCore->m_pBoosterCore = pBoosterCore;
+
+   pInteractionCore->m_bDisableApprox = pBoosterCore->IsDisableApprox();
+
+   const size_t cFeatures = pBoosterCore->GetCountFeatures();
+   size_t cBinsMax = 0;
+   if(0 != cFeatures) {
+      if(IsMultiplyError(sizeof(FeatureInteraction), cFeatures)) {
+         LOG_0(Trace_Warning, "WARNING InteractionCore::CreateFromBooster IsMultiplyError(sizeof(FeatureInteraction), cFeatures)");
+         return Error_OutOfMemory;
+      }
+      pInteractionCore->m_cFeatures = cFeatures;
+      FeatureInteraction * const aFeatures =
+         static_cast<FeatureInteraction *>(malloc(sizeof(FeatureInteraction) * cFeatures));
+      if(nullptr == aFeatures) {
+         LOG_0(Trace_Warning, "WARNING InteractionCore::CreateFromBooster nullptr == aFeatures");
+         return Error_OutOfMemory;
+      }
+      pInteractionCore->m_aFeatures = aFeatures;
+
+      const FeatureBoosting * const aFeaturesFrom = pBoosterCore->GetFeatures();
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         const FeatureBoosting * const pFeatureFrom = &aFeaturesFrom[iFeature];
+         aFeatures[iFeature].Initialize(
+            pFeatureFrom->GetCountBins(),
+            pFeatureFrom->IsMissing(),
+            pFeatureFrom->IsUnknown(),
+            pFeatureFrom->IsNominal()
+         );
+         cBinsMax = EbmMax(cBinsMax, pFeatureFrom->GetCountBins());
+      }
+   }
+
+   const size_t cScores = pBoosterCore->GetCountScores();
+   if(size_t { 0 } != cScores) {
+      pInteractionCore->m_cScores = cScores;
+
+      // the objectives are owned by the booster, which our destructor knows not to free
+      pInteractionCore->m_objectiveCpu = *pBoosterCore->GetObjectiveCpu();
+      pInteractionCore->m_objectiveSIMD = *pBoosterCore->GetObjectiveSIMD();
+
+      DataSetBoosting * const pTrainingSet = pBoosterCore->GetTrainingSet();
+      if(0 != cFeatures && 0 != pTrainingSet->GetCountSamples()) {
+         if(size_t { 0 } != pBoosterCore->GetCountInnerBags() && EBM_FALSE != pBoosterCore->IsWeighted()) {
+            // the inner bag weights include the bagging counts, and the booster does not keep the weights alone
+            LOG_0(Trace_Error, "ERROR InteractionCore::CreateFromBooster the booster cannot have both inner bags and sample weights");
+            return Error_IllegalParamVal;
+         }
+
+         if(CheckInteractionRestrictions(pInteractionCore, &pInteractionCore->m_objectiveCpu, cBinsMax)) {
+            LOG_0(Trace_Warning, "WARNING InteractionCore::CreateFromBooster cannot fit indexes in the cpu zone");
+            return Error_IllegalParamVal;
+         }
+         if(0 != pInteractionCore->m_objectiveSIMD.m_cUIntBytes) {
+            // the booster's subsets already use the SIMD zone, so unlike Create we cannot fall back to the cpu zone
+            if(CheckInteractionRestrictions(pInteractionCore, &pInteractionCore->m_objectiveSIMD, cBinsMax)) {
+               LOG_0(Trace_Warning, "WARNING InteractionCore::CreateFromBooster cannot fit indexes in the SIMD zone");
+               return Error_IllegalParamVal;
+            }
+         }
+
+         if(IsOverflowBinSize<FloatMain, UIntMain>(pInteractionCore->IsHessian(), cScores)) {
+            LOG_0(Trace_Warning, "WARNING InteractionCore::CreateFromBooster IsOverflowBinSize overflow");
+            return Error_OutOfMemory;
+         }
+
+         error = pInteractionCore->m_dataFrame.InitDataSetInteractionFromBoosting(
+            pTrainingSet,
+            pBoosterCore->GetCountInnerBags(),
+            cFeatures,
+            pBoosterCore->GetFeatures(),
+            pBoosterCore->GetCountTerms(),
+            pBoosterCore->GetTerms()
+         );
+         if(Error_None != error) {
+            return error;
+         }
+      }
+   }
+
+   LOG_0(Trace_Info, "Exited InteractionCore::CreateFromBooster");
+   return Error_None;
+}
+
 WARNING_PUSH
 WARNING_DISABLE_UNINITIALIZED_LOCAL_VARIABLE
 ErrorEbm InteractionCore::InitializeInteractionGradientsAndHessians(
    const unsigned char * const pDataSetShared,
-   const size_t cWeights,
    const BagEbm * const aBag,
    const double * const aInitScores
 ) {
@@ -562,6 +691,7 @@ ErrorEbm InteractionCore::InitializeInteractionGradientsAndHessians(
             data.m_aPacked = nullptr;
             data.m_aWeights = nullptr;
             data.m_aGradientsAndHessians = pSubset->GetGradHess();
+            data.m_iTargetConst = pSubset->GetTargetConst();
             // this is a kind of hack (a good one) where we are sending in an update of all zeros in order to 
             // reuse the same code that we use for boosting in order to generate our gradients and hessians
             error = pSubset->ObjectiveApplyUpdate(&data);
@@ -648,6 +778,7 @@ ErrorEbm InteractionCore::InitializeInteractionGradientsAndHessians(
             data.m_aPacked = nullptr;
             data.m_aWeights = nullptr;
             data.m_aGradientsAndHessians = pSubset->GetGradHess();
+            data.m_iTargetConst = k_iTargetPerSample;
             // this is a kind of hack (a good one) where we are sending in an update of all zeros in order to 
             // reuse the same code that we use for boosting in order to generate our gradients and hessians
             error = pSubset->ObjectiveApplyUpdate(&data);
@@ -665,76 +796,6 @@ ErrorEbm InteractionCore::InitializeInteractionGradientsAndHessians(
       AlignedFree(const_cast<void *>(data.m_aUpdateTensorScores));
    free_sample_scores:
       AlignedFree(data.m_aSampleScores);
-
-      if(size_t { 0 } != cWeights) {
-         // optimize by now multiplying the gradients and hessians by the weights. The gradients and hessians are constants
-         // after we exit this function and we just bin the non-changing values after this. By multiplying here
-         // we can avoid doing the multiplication each time we bin them.
-
-         const FloatShared * pWeight = GetDataSetSharedWeight(pDataSetShared, 0);
-         EBM_ASSERT(nullptr != pWeight);
-
-         size_t cTotalScores = cScores;
-         if(IsHessian()) {
-            EBM_ASSERT(!IsMultiplyError(size_t { 2 }, cTotalScores)); // we are accessing allocated memory
-            cTotalScores = cTotalScores << 1;
-         }
-
-         const BagEbm * pSampleReplication = aBag;
-         BagEbm replication = 0;
-         FloatShared weight;
-
-         DataSubsetInteraction * pSubset = GetDataSetInteraction()->GetSubsets();
-         do {
-            const size_t cSIMDPack = pSubset->GetObjectiveWrapper()->m_cSIMDPack;
-
-            EBM_ASSERT(1 <= pSubset->GetCountSamples());
-            EBM_ASSERT(0 == pSubset->GetCountSamples() % cSIMDPack);
-
-            void * pGradHess = pSubset->GetGradHess();
-            const void * const pGradHessEnd = IndexByte(pGradHess, pSubset->GetObjectiveWrapper()->m_cFloatBytes * cTotalScores * pSubset->GetCountSamples());
-            do {
-               size_t iPartition = 0;
-               do {
-                  if(BagEbm { 0 } == replication) {
-                     replication = 1;
-                     if(nullptr != pSampleReplication) {
-                        do {
-                           replication = *pSampleReplication;
-                           ++pSampleReplication;
-                           ++pWeight;
-                        } while(replication <= BagEbm { 0 });
-                        --pWeight;
-                     }
-                     weight = *pWeight;
-                     ++pWeight;
-                  }
-                  size_t iScore = 0;
-                  if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
-                     const FloatBig weightConverted = static_cast<FloatBig>(weight);
-                     do {
-                        reinterpret_cast<FloatBig *>(pGradHess)[iScore * cSIMDPack + iPartition] *= weightConverted;
-                        ++iScore;
-                     } while(cTotalScores != iScore);
-                  } else {
-                     EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-                     const FloatSmall weightConverted = static_cast<FloatSmall>(weight);
-                     do {
-                        reinterpret_cast<FloatSmall *>(pGradHess)[iScore * cSIMDPack + iPartition] *= weightConverted;
-                        ++iScore;
-                     } while(cTotalScores != iScore);
-                  }
-                  --replication;
-
-                  ++iPartition;
-               } while(cSIMDPack != iPartition);
-               pGradHess = IndexByte(pGradHess, pSubset->GetObjectiveWrapper()->m_cFloatBytes * cTotalScores * cSIMDPack);
-            } while(pGradHessEnd != pGradHess);
-
-            ++pSubset;
-         } while(pSubsetsEnd != pSubset);
-         EBM_ASSERT(0 == replication);
-      }
    }
    return error;
 }
@@ -20,6 +20,7 @@ namespace DEFINED_ZONE_NAME {
 #endif // DEFINED_ZONE_NAME
 
 class FeatureInteraction;
+class BoosterCore;
 
 class InteractionCore final {
 
@@ -41,13 +42,18 @@ class InteractionCore final {
    ObjectiveWrapper m_objectiveCpu;
    ObjectiveWrapper m_objectiveSIMD;
 
+   // if we were created from a booster, then the dataset and the objectives belong to it and we hold a reference
+   BoosterCore * m_pBoosterCore;
+
    inline ~InteractionCore() {
       // this only gets called after our reference count has been decremented to zero
 
       m_dataFrame.DestructDataSetInteraction(m_cFeatures);
       free(m_aFeatures);
-      FreeObjectiveWrapperInternals(&m_objectiveCpu);
-      FreeObjectiveWrapperInternals(&m_objectiveSIMD);
+      if(nullptr == m_pBoosterCore) {
+         FreeObjectiveWrapperInternals(&m_objectiveCpu);
+         FreeObjectiveWrapperInternals(&m_objectiveSIMD);
+      }
    };
 
    inline InteractionCore() noexcept :
@@ -55,7 +61,8 @@ class InteractionCore final {
       m_cScores(0),
       m_bDisableApprox(EBM_FALSE),
       m_cFeatures(0),
-      m_aFeatures(nullptr)
+      m_aFeatures(nullptr),
+      m_pBoosterCore(nullptr)
    {
       m_dataFrame.SafeInitDataSetInteraction();
       InitializeObjectiveWrapperUnfailing(&m_objectiveCpu);
@@ -90,6 +97,13 @@ public:
       return m_cFeatures;
    }
 
+   inline bool IsFeatureDataMissing(const size_t iFeature) {
+      // only detectors created from a booster can be missing the data of features that have 2 or more bins
+      EBM_ASSERT(iFeature < m_cFeatures);
+      return nullptr != m_pBoosterCore && size_t { 0 } != m_dataFrame.GetCountSamples() &&
+         nullptr == m_dataFrame.GetSubsets()->GetFeatureData(iFeature);
+   }
+
    static void Free(InteractionCore * const pInteractionCore);
    static ErrorEbm Create(
       const unsigned char * const pDataSetShared,
@@ -103,10 +117,13 @@ public:
       const double * const experimentalParams,
       InteractionCore ** const ppInteractionCoreOut
    );
+   static ErrorEbm CreateFromBooster(
+      BoosterCore * const pBoosterCore,
+      InteractionCore ** const ppInteractionCoreOut
+   );
 
    ErrorEbm InitializeInteractionGradientsAndHessians(
       const unsigned char * const pDataSetShared,
-      const size_t cWeights,
       const BagEbm * const aBag,
       const double * const aInitScores
    );
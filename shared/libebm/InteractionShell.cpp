@@ -14,6 +14,8 @@
 #include "bridge.hpp"
 
 #include "dataset_shared.hpp" // GetDataSetSharedHeader
+#include "BoosterCore.hpp" // BoosterCore
+#include "BoosterShell.hpp" // BoosterShell
 #include "InteractionCore.hpp"
 #include "InteractionShell.hpp"
 
@@ -24,7 +26,6 @@ namespace DEFINED_ZONE_NAME {
 
 extern void InitializeRmseGradientsAndHessiansInteraction(
    const unsigned char * const pDataSetShared,
-   const size_t cWeights,
    const BagEbm * const aBag,
    const double * const aInitScores,
    DataSetInteraction * const pDataSet
@@ -34,8 +35,7 @@ void InteractionShell::Free(InteractionShell * const pInteractionShell) {
    LOG_0(Trace_Info, "Entered InteractionShell::Free");
 
    if(nullptr != pInteractionShell) {
-      AlignedFree(pInteractionShell->m_aInteractionFastBinsTemp);
-      AlignedFree(pInteractionShell->m_aInteractionMainBins);
+      pInteractionShell->FreeBins();
       InteractionCore::Free(pInteractionShell->m_pInteractionCore);
       
       // before we free our memory, indicate it was freed so if our higher level language attempts to use it we have
@@ -63,6 +63,16 @@ InteractionShell * InteractionShell::Create(InteractionCore * const pInteraction
    return pNew;
 }
 
+void InteractionShell::FreeBins() {
+   AlignedFree(m_aInteractionFastBinsTemp);
+   m_aInteractionFastBinsTemp = nullptr;
+   m_cBytesFastBins = 0;
+
+   AlignedFree(m_aInteractionMainBins);
+   m_aInteractionMainBins = nullptr;
+   m_cAllocatedMainBins = 0;
+}
+
 BinBase * InteractionShell::GetInteractionFastBinsTemp(const size_t cBytes) {
    ANALYSIS_ASSERT(0 != cBytes);
 
@@ -163,7 +173,9 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
    if(0 != (static_cast<UCreateInteractionFlags>(flags) & static_cast<UCreateInteractionFlags>(~(
       static_cast<UCreateInteractionFlags>(CreateInteractionFlags_DifferentialPrivacy) |
       static_cast<UCreateInteractionFlags>(CreateInteractionFlags_DisableApprox) |
-      static_cast<UCreateInteractionFlags>(CreateInteractionFlags_BinaryAsMulticlass)
+      static_cast<UCreateInteractionFlags>(CreateInteractionFlags_BinaryAsMulticlass) |
+      static_cast<UCreateInteractionFlags>(CreateInteractionFlags_TargetSorted) |
+      static_cast<UCreateInteractionFlags>(CreateInteractionFlags_Float32)
    )))) {
       LOG_0(Trace_Error, "ERROR CreateInteractionDetector flags contains unknown flags. Ignoring extras.");
    }
@@ -198,14 +210,37 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
       return Error_IllegalParamVal;
    }
 
+   // the interaction detector is built from a copy of the dataset sorted by class, which is discarded once the
+   // gradients are initialized since interaction strengths do not depend on the sample order
+   unsigned char * pDataSetSorted = nullptr;
+   BagEbm * aBagSorted = nullptr;
+   size_t * aiOriginal = nullptr;
+   if(0 != (CreateInteractionFlags_TargetSorted & flags)) {
+      error = SortDataSetByTarget(
+         static_cast<const unsigned char *>(dataSet),
+         bag,
+         &pDataSetSorted,
+         &aBagSorted,
+         &aiOriginal
+      );
+      if(Error_None != error) {
+         return error;
+      }
+   }
+   const unsigned char * const pDataSetInit = 
+      nullptr != pDataSetSorted ? pDataSetSorted : static_cast<const unsigned char *>(dataSet);
+   const BagEbm * const aBagInit = nullptr != pDataSetSorted ? aBagSorted : bag;
+   const CreateInteractionFlags flagsInit = nullptr != pDataSetSorted ? flags : 
+      static_cast<CreateInteractionFlags>(flags & ~CreateInteractionFlags_TargetSorted);
+
    InteractionCore * pInteractionCore = nullptr;
    error = InteractionCore::Create(
-      static_cast<const unsigned char *>(dataSet),
+      pDataSetInit,
       cSamples, 
       cFeatures,
       cWeights,
-      bag,
-      flags,
+      aBagInit,
+      flagsInit,
       acceleration,
       objective,
       experimentalParams,
@@ -214,6 +249,9 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
    if(Error_None != error) {
       // legal to call if nullptr. On error we can get back a legal pInteractionCore to delete
       InteractionCore::Free(pInteractionCore);
+      free(aiOriginal);
+      free(aBagSorted);
+      free(pDataSetSorted);
       return error;
    }
 
@@ -222,32 +260,48 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
       // if the memory allocation for pInteractionShell failed then 
       // there was no place to put the pInteractionCore, so free it
       InteractionCore::Free(pInteractionCore);
+      free(aiOriginal);
+      free(aBagSorted);
+      free(pDataSetSorted);
       return Error_OutOfMemory;
    }
 
    if(size_t { 0 } != pInteractionCore->GetCountScores()) {
       if(!pInteractionCore->IsRmse()) {
-         error = pInteractionCore->InitializeInteractionGradientsAndHessians(
-            static_cast<const unsigned char *>(dataSet),
-            cWeights,
-            bag,
-            initScores
-         );
+         double * aInitScoresSorted = nullptr;
+         if(nullptr != aiOriginal) {
+            error = SortInitScores(cSamples, aiOriginal, pInteractionCore->GetCountScores(), initScores, &aInitScoresSorted);
+         }
+         if(Error_None == error) {
+            error = pInteractionCore->InitializeInteractionGradientsAndHessians(
+               pDataSetInit,
+               aBagInit,
+               nullptr != aiOriginal ? aInitScoresSorted : initScores
+            );
+         }
+         free(aInitScoresSorted);
          if(Error_None != error) {
             // DO NOT FREE pInteractionCore since it's owned by pInteractionShell, which we free here
             InteractionShell::Free(pInteractionShell);
+            free(aiOriginal);
+            free(aBagSorted);
+            free(pDataSetSorted);
             return error;
          }
       } else {
+         // regression is never sorted by target
+         EBM_ASSERT(nullptr == pDataSetSorted);
          InitializeRmseGradientsAndHessiansInteraction(
             static_cast<const unsigned char *>(dataSet),
-            cWeights,
             bag,
             initScores,
             pInteractionCore->GetDataSetInteraction()
          );
       }
    }
+   free(aiOriginal);
+   free(aBagSorted);
+   free(pDataSetSorted);
 
    const InteractionHandle handle = pInteractionShell->GetHandle();
 
@@ -257,6 +311,55 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
    return Error_None;
 }
 
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetectorFromBooster(
+   BoosterHandle boosterHandle,
+   InteractionHandle * interactionHandleOut
+) {
+   LOG_N(Trace_Info, "Entered CreateInteractionDetectorFromBooster: "
+      "boosterHandle=%p, "
+      "interactionHandleOut=%p"
+      ,
+      static_cast<void *>(boosterHandle),
+      static_cast<const void *>(interactionHandleOut)
+   );
+
+   ErrorEbm error;
+
+   if(nullptr == interactionHandleOut) {
+      LOG_0(Trace_Error, "ERROR CreateInteractionDetectorFromBooster nullptr == interactionHandleOut");
+      return Error_IllegalParamVal;
+   }
+   *interactionHandleOut = nullptr; // set this to nullptr as soon as possible so the caller doesn't attempt to free it
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   // the booster keeps its training set gradients in sync with its current model, so unlike
+   // CreateInteractionDetector there are no gradients to initialize here
+   InteractionCore * pInteractionCore = nullptr;
+   error = InteractionCore::CreateFromBooster(pBoosterShell->GetBoosterCore(), &pInteractionCore);
+   if(Error_None != error) {
+      InteractionCore::Free(pInteractionCore);
+      return error;
+   }
+
+   InteractionShell * const pInteractionShell = InteractionShell::Create(pInteractionCore);
+   if(UNLIKELY(nullptr == pInteractionShell)) {
+      InteractionCore::Free(pInteractionCore);
+      return Error_OutOfMemory;
+   }
+
+   const InteractionHandle handle = pInteractionShell->GetHandle();
+
+   LOG_N(Trace_Info, "Exited CreateInteractionDetectorFromBooster: *interactionHandleOut=%p", static_cast<void *>(handle));
+
+   *interactionHandleOut = handle;
+   return Error_None;
+}
+
 EBM_API_BODY void EBM_CALLING_CONVENTION FreeInteractionDetector(
    InteractionHandle interactionHandle
 ) {
@@ -93,6 +93,10 @@ public:
       return &m_cLogExitMessages;
    }
 
+   // frees the bins but leaves the InteractionCore alone.  CalcInteractionStrengths gives each extra thread its own
+   // InteractionShell that shares the InteractionCore of the caller, and frees those through this
+   void FreeBins();
+
    BinBase * GetInteractionFastBinsTemp(const size_t cBytes);
 
    BinBase * GetInteractionMainBins(const size_t cBytesPerMainBin, const size_t cMainBins);
@@ -0,0 +1,455 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "pch.hpp"
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "logging.h"
+#include "unzoned.h" // LIKELY
+
+#define ZONE_main
+#include "zones.h"
+
+#include "GradientPair.hpp"
+#include "Bin.hpp"
+
+#include "ebm_internal.hpp"
+#include "ebm_stats.hpp"
+#include "TensorTotalsSum.hpp"
+#include "InteractionCore.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// purification of the cells is iterative for 3 or more dimensions.  Each sweep removes the weighted mean along every
+// dimension, and we stop once a sweep changes no update by more than this fraction of the largest update
+static constexpr FloatCalc k_purifyTolerance = FloatCalc { 1e-12 };
+static constexpr size_t k_cPurifySweepsMax = 1000;
+
+// For 3 or more dimensions trying every combination of cuts is too slow to screen many terms, so we search greedily.
+// Each round cuts the dimension and point that most improve the gain given the cuts chosen so far, until every
+// dimension has one cut.  A final round then moves each cut to its best point given the cuts of the other
+// dimensions, this time optimizing the gain that we return, which is the purified gain if requested.  The cuts
+// split the tensor into 2^cDimensions cells which we keep in the auxiliary bins
+template<bool bHessian, size_t cCompilerScores, size_t cCompilerDimensions>
+class PartitionMultiDimensionalInteractionInternal final {
+public:
+
+   PartitionMultiDimensionalInteractionInternal() = delete; // this is a static class.  Do not construct
+
+   typedef Bin<FloatMain, UIntMain, bHessian, GetArrayScores(cCompilerScores)> BinSpecialized;
+
+   // CalcCellsGain fills the cells of the dimensions in cutMask and sums their partial gains.  Dimensions that
+   // are not in cutMask are summed over entirely.  Returns false if any cell has fewer than cSamplesLeafMin samples
+   INLINE_RELEASE_UNTEMPLATED static bool CalcCellsGain(
+      const size_t cScores,
+      const size_t cRealDimensions,
+      const TensorSumDimension * const aDimensions,
+      const size_t cutMask,
+      const bool bPure,
+      const size_t cSamplesLeafMin,
+      BinSpecialized * const aCells,
+      const BinSpecialized * const aBins,
+      FloatCalc * const pGainOut
+#ifndef NDEBUG
+      , const BinSpecialized * const aDebugCopyBins
+      , const BinBase * const pBinsEndDebug
+#endif // NDEBUG
+   ) {
+      static constexpr bool bUseLogitBoost = k_bUseLogitboost && bHessian;
+
+      const size_t cBytesPerBin = GetBinSize<FloatMain, UIntMain>(bHessian, cScores);
+
+      // the cells are indexed by their direction vector, which only has bits in cutMask
+      size_t cCells = 0;
+      size_t directionVector = 0;
+      do {
+         auto * const pCell = IndexBin(aCells, cBytesPerBin * directionVector);
+         ASSERT_BIN_OK(cBytesPerBin, pCell, pBinsEndDebug);
+         TensorTotalsSum<bHessian, cCompilerScores, cCompilerDimensions>(
+            cScores,
+            cRealDimensions,
+            aDimensions,
+            directionVector,
+            aBins,
+            *pCell,
+            pCell->GetGradientPairs()
+#ifndef NDEBUG
+            , aDebugCopyBins
+            , pBinsEndDebug
+#endif // NDEBUG
+         );
+         if(UNLIKELY(pCell->GetCountSamples() < cSamplesLeafMin)) {
+            return false;
+         }
+         ++cCells;
+         directionVector = (directionVector - cutMask) & cutMask;
+      } while(size_t { 0 } != directionVector);
+
+      FloatCalc gain = 0;
+      if(!bPure) {
+         size_t iCell = 0;
+         directionVector = 0;
+         do {
+            const auto * const pCell = IndexBin(aCells, cBytesPerBin * directionVector);
+            const auto * const aGradientPairs = pCell->GetGradientPairs();
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               gain += EbmStats::CalcPartialGain(
+                  static_cast<FloatCalc>(aGradientPairs[iScore].m_sumGradients),
+                  static_cast<FloatCalc>(bUseLogitBoost ? aGradientPairs[iScore].GetHess() : pCell->GetWeight())
+               );
+            }
+            ++iCell;
+            directionVector = (directionVector - cutMask) & cutMask;
+         } while(size_t { 0 } != directionVector);
+         EBM_ASSERT(cCells == iCell);
+      } else {
+         // purified gain is only defined once every dimension is cut, so the cells are a full 2^cDimensions cube
+         EBM_ASSERT(MakeLowMask<size_t>(static_cast<int>(cRealDimensions)) == cutMask);
+
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            // if any of the denominators (weights) are zero then the purified gain will be zero, like for pairs
+            bool bZero = false;
+            FloatCalc maxUpdate = 0;
+            for(size_t iCell = 0; iCell < cCells; ++iCell) {
+               auto * const pCell = IndexBin(aCells, cBytesPerBin * iCell);
+               auto * const aGradientPairs = pCell->GetGradientPairs();
+               const FloatCalc d = static_cast<FloatCalc>(bUseLogitBoost ? aGradientPairs[iScore].GetHess() : pCell->GetWeight());
+               if(FloatCalc { 0 } == d) {
+                  bZero = true;
+                  break;
+               }
+               // the cells are not needed after this call, so replace the sum of the gradients with the update
+               const FloatCalc update = static_cast<FloatCalc>(aGradientPairs[iScore].m_sumGradients) / d;
+               aGradientPairs[iScore].m_sumGradients = static_cast<FloatMain>(update);
+               maxUpdate = EbmMax(maxUpdate, std::abs(update));
+            }
+            if(bZero) {
+               continue;
+            }
+
+            // remove the weighted mean of every pair of cells that differ only along one dimension until nothing
+            // changes.  This converges to the purified updates that the closed form for pairs calculates
+            const FloatCalc tolerance = maxUpdate * k_purifyTolerance;
+            for(size_t iSweep = 0; iSweep < k_cPurifySweepsMax; ++iSweep) {
+               FloatCalc maxChange = 0;
+               for(size_t iDimension = 0; iDimension < cRealDimensions; ++iDimension) {
+                  const size_t bit = size_t { 1 } << iDimension;
+                  for(size_t iCellLow = 0; iCellLow < cCells; ++iCellLow) {
+                     if(size_t { 0 } == (bit & iCellLow)) {
+                        auto * const pLow = IndexBin(aCells, cBytesPerBin * iCellLow);
+                        auto * const pHigh = IndexBin(aCells, cBytesPerBin * (iCellLow | bit));
+                        auto * const pGradientPairLow = &pLow->GetGradientPairs()[iScore];
+                        auto * const pGradientPairHigh = &pHigh->GetGradientPairs()[iScore];
+                        const FloatCalc dLow = static_cast<FloatCalc>(bUseLogitBoost ? pGradientPairLow->GetHess() : pLow->GetWeight());
+                        const FloatCalc dHigh = static_cast<FloatCalc>(bUseLogitBoost ? pGradientPairHigh->GetHess() : pHigh->GetWeight());
+                        const FloatCalc uLow = static_cast<FloatCalc>(pGradientPairLow->m_sumGradients);
+                        const FloatCalc uHigh = static_cast<FloatCalc>(pGradientPairHigh->m_sumGradients);
+                        const FloatCalc mean = (uLow * dLow + uHigh * dHigh) / (dLow + dHigh);
+                        pGradientPairLow->m_sumGradients = static_cast<FloatMain>(uLow - mean);
+                        pGradientPairHigh->m_sumGradients = static_cast<FloatMain>(uHigh - mean);
+                        maxChange = EbmMax(maxChange, std::abs(mean));
+                     }
+                  }
+               }
+               if(!(tolerance < maxChange)) {
+                  // also exits for NaN values, which then show up in the gain
+                  break;
+               }
+            }
+
+            for(size_t iCell = 0; iCell < cCells; ++iCell) {
+               const auto * const pCell = IndexBin(aCells, cBytesPerBin * iCell);
+               const auto * const pGradientPair = &pCell->GetGradientPairs()[iScore];
+               gain += EbmStats::CalcPartialGainFromUpdate(
+                  static_cast<FloatCalc>(pGradientPair->m_sumGradients),
+                  static_cast<FloatCalc>(bUseLogitBoost ? pGradientPair->GetHess() : pCell->GetWeight())
+               );
+            }
+         }
+      }
+      *pGainOut = gain;
+      return true;
+   }
+
+   INLINE_RELEASE_UNTEMPLATED static double Func(
+      InteractionCore * const pInteractionCore,
+      const size_t cRuntimeRealDimensions,
+      const size_t * const acBins,
+      const CalcInteractionFlags flags,
+      const size_t cSamplesLeafMin,
+      BinBase * const aAuxiliaryBinsBase,
+      BinBase * const aBinsBase
+#ifndef NDEBUG
+      , const BinBase * const aDebugCopyBinsBase
+      , const BinBase * const pBinsEndDebug
+#endif // NDEBUG
+   ) {
+      auto * const aCells = aAuxiliaryBinsBase->Specialize<FloatMain, UIntMain, bHessian, GetArrayScores(cCompilerScores)>();
+      const auto * const aBins = aBinsBase->Specialize<FloatMain, UIntMain, bHessian, GetArrayScores(cCompilerScores)>();
+
+#ifndef NDEBUG
+      const auto * const aDebugCopyBins = aDebugCopyBinsBase->Specialize<FloatMain, UIntMain, bHessian, GetArrayScores(cCompilerScores)>();
+#endif // NDEBUG
+
+      const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pInteractionCore->GetCountScores());
+      const size_t cBytesPerBin = GetBinSize<FloatMain, UIntMain>(bHessian, cScores);
+
+      const size_t cRealDimensions = GET_COUNT_DIMENSIONS(cCompilerDimensions, cRuntimeRealDimensions);
+      EBM_ASSERT(k_dynamicDimensions == cCompilerDimensions || cCompilerDimensions == cRuntimeRealDimensions);
+      EBM_ASSERT(3 <= cRealDimensions);
+      EBM_ASSERT(cRealDimensions <= k_cDimensionsMax);
+
+      EBM_ASSERT(0 < cSamplesLeafMin);
+
+      const bool bPure = 0 != (CalcInteractionFlags_Pure & flags);
+
+      // a dimension without a cut has its point at the last bin, so that summing the low side covers all of it
+      TensorSumDimension aDimensions[k_dynamicDimensions == cCompilerDimensions ? k_cDimensionsMax : cCompilerDimensions];
+      size_t iDimensionInit = 0;
+      do {
+         EBM_ASSERT(2 <= acBins[iDimensionInit]); // 1 cBins in any dimension returns an interaction score of 0
+         aDimensions[iDimensionInit].m_cBins = acBins[iDimensionInit];
+         aDimensions[iDimensionInit].m_iPoint = acBins[iDimensionInit] - 1;
+         ++iDimensionInit;
+      } while(cRealDimensions != iDimensionInit);
+
+      bool bNaN = false;
+      FloatCalc gain = 0;
+
+      size_t cutMask = 0;
+      const size_t cutMaskAll = MakeLowMask<size_t>(static_cast<int>(cRealDimensions));
+      do {
+         size_t iDimensionBest = 0;
+         size_t iPointBest = 0;
+         bool bFound = false;
+         FloatCalc bestGain = 0;
+         for(size_t iDimension = 0; iDimension < cRealDimensions; ++iDimension) {
+            const size_t bit = size_t { 1 } << iDimension;
+            if(size_t { 0 } == (bit & cutMask)) {
+               const size_t cBins = aDimensions[iDimension].m_cBins;
+               for(size_t iPoint = 0; iPoint < cBins - 1; ++iPoint) {
+                  aDimensions[iDimension].m_iPoint = iPoint;
+                  if(CalcCellsGain(cScores, cRealDimensions, aDimensions, cutMask | bit, false, cSamplesLeafMin,
+                     aCells, aBins, &gain
+#ifndef NDEBUG
+                     , aDebugCopyBins, pBinsEndDebug
+#endif // NDEBUG
+                  )) {
+                     if(UNLIKELY(std::isnan(gain))) {
+                        bNaN = true;
+                     } else if(!bFound || bestGain < gain) {
+                        bFound = true;
+                        bestGain = gain;
+                        iDimensionBest = iDimension;
+                        iPointBest = iPoint;
+                     }
+                  }
+               }
+               aDimensions[iDimension].m_iPoint = cBins - 1;
+            }
+         }
+         if(!bFound) {
+            // no legal cut left in some dimension, so there is no interaction between all of the dimensions
+            return bNaN ? std::numeric_limits<double>::quiet_NaN() : 0.0;
+         }
+         aDimensions[iDimensionBest].m_iPoint = iPointBest;
+         cutMask |= size_t { 1 } << iDimensionBest;
+      } while(cutMaskAll != cutMask);
+
+      FloatCalc bestGain = 0;
+      if(!CalcCellsGain(cScores, cRealDimensions, aDimensions, cutMaskAll, bPure, cSamplesLeafMin,
+         aCells, aBins, &bestGain
+#ifndef NDEBUG
+         , aDebugCopyBins, pBinsEndDebug
+#endif // NDEBUG
+      )) {
+         // the last greedy round checked these cells
+         EBM_ASSERT(false);
+         return 0.0;
+      }
+
+      size_t iDimension = 0;
+      do {
+         const size_t cBins = aDimensions[iDimension].m_cBins;
+         size_t iPointBest = aDimensions[iDimension].m_iPoint;
+         for(size_t iPoint = 0; iPoint < cBins - 1; ++iPoint) {
+            if(iPoint != iPointBest) {
+               aDimensions[iDimension].m_iPoint = iPoint;
+               if(CalcCellsGain(cScores, cRealDimensions, aDimensions, cutMaskAll, bPure, cSamplesLeafMin,
+                  aCells, aBins, &gain
+#ifndef NDEBUG
+                  , aDebugCopyBins, pBinsEndDebug
+#endif // NDEBUG
+               )) {
+                  if(UNLIKELY(std::isnan(gain))) {
+                     bNaN = true;
+                  } else if(bestGain < gain) {
+                     bestGain = gain;
+                     iPointBest = iPoint;
+                  }
+               }
+            }
+         }
+         aDimensions[iDimension].m_iPoint = iPointBest;
+         ++iDimension;
+      } while(cRealDimensions != iDimension);
+
+      if(bNaN || std::isnan(bestGain)) {
+         return std::numeric_limits<double>::quiet_NaN();
+      }
+
+      EBM_ASSERT(0 <= bestGain);
+
+      if(!bPure) {
+         // like for pairs, subtract the partial gain of the parent which is the last bin of the tensor totals
+         const auto * const pTotal = NegativeIndexBin(aCells, cBytesPerBin);
+         const FloatMain weightAll = pTotal->GetWeight();
+         const auto * const aGradientPairs = pTotal->GetGradientPairs();
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            static constexpr bool bUseLogitBoost = k_bUseLogitboost && bHessian;
+            bestGain -= EbmStats::CalcPartialGain(
+               static_cast<FloatCalc>(aGradientPairs[iScore].m_sumGradients),
+               static_cast<FloatCalc>(bUseLogitBoost ? aGradientPairs[iScore].GetHess() : weightAll)
+            );
+         }
+      }
+
+      // we clean up bestGain in the caller, since this function is templated and created many times
+      return static_cast<double>(bestGain);
+   }
+};
+
+template<bool bHessian, size_t cCompilerScores>
+INLINE_RELEASE_TEMPLATED static double PartitionMultiDimensionalInteractionDimensions(
+   InteractionCore * const pInteractionCore,
+   const size_t cRealDimensions,
+   const size_t * const acBins,
+   const CalcInteractionFlags flags,
+   const size_t cSamplesLeafMin,
+   BinBase * const aAuxiliaryBinsBase,
+   BinBase * const aBinsBase
+#ifndef NDEBUG
+   , const BinBase * const aDebugCopyBinsBase
+   , const BinBase * const pBinsEndDebug
+#endif // NDEBUG
+) {
+   // triples are what we screen most, so they get their own compiled version.  TensorTotalsSum requires that
+   // anything above 3 dimensions goes through the dynamic version
+   if(size_t { 3 } == cRealDimensions) {
+      return PartitionMultiDimensionalInteractionInternal<bHessian, cCompilerScores, 3>::Func(
+         pInteractionCore,
+         cRealDimensions,
+         acBins,
+         flags,
+         cSamplesLeafMin,
+         aAuxiliaryBinsBase,
+         aBinsBase
+#ifndef NDEBUG
+         , aDebugCopyBinsBase
+         , pBinsEndDebug
+#endif // NDEBUG
+      );
+   } else {
+      return PartitionMultiDimensionalInteractionInternal<bHessian, cCompilerScores, k_dynamicDimensions>::Func(
+         pInteractionCore,
+         cRealDimensions,
+         acBins,
+         flags,
+         cSamplesLeafMin,
+         aAuxiliaryBinsBase,
+         aBinsBase
+#ifndef NDEBUG
+         , aDebugCopyBinsBase
+         , pBinsEndDebug
+#endif // NDEBUG
+      );
+   }
+}
+
+// aAuxiliaryBinsBase needs room for 2^cRealDimensions bins, and the last bin of the tensor totals before it needs
+// to hold the totals of all the bins, which is where TensorTotalsBuild puts them
+extern double PartitionMultiDimensionalInteraction(
+   InteractionCore * const pInteractionCore,
+   const size_t cRealDimensions,
+   const size_t * const acBins,
+   const CalcInteractionFlags flags,
+   const size_t cSamplesLeafMin,
+   BinBase * aAuxiliaryBinsBase,
+   BinBase * const aBinsBase
+#ifndef NDEBUG
+   , const BinBase * const aDebugCopyBinsBase
+   , const BinBase * const pBinsEndDebug
+#endif // NDEBUG
+) {
+   const size_t cRuntimeScores = pInteractionCore->GetCountScores();
+
+   EBM_ASSERT(1 <= cRuntimeScores);
+   if(pInteractionCore->IsHessian()) {
+      if(size_t { 1 } != cRuntimeScores) {
+         return PartitionMultiDimensionalInteractionDimensions<true, k_dynamicScores>(
+            pInteractionCore,
+            cRealDimensions,
+            acBins,
+            flags,
+            cSamplesLeafMin,
+            aAuxiliaryBinsBase,
+            aBinsBase
+#ifndef NDEBUG
+            , aDebugCopyBinsBase
+            , pBinsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         return PartitionMultiDimensionalInteractionDimensions<true, k_oneScore>(
+            pInteractionCore,
+            cRealDimensions,
+            acBins,
+            flags,
+            cSamplesLeafMin,
+            aAuxiliaryBinsBase,
+            aBinsBase
+#ifndef NDEBUG
+            , aDebugCopyBinsBase
+            , pBinsEndDebug
+#endif // NDEBUG
+         );
+      }
+   } else {
+      if(size_t { 1 } != cRuntimeScores) {
+         return PartitionMultiDimensionalInteractionDimensions<false, k_dynamicScores>(
+            pInteractionCore,
+            cRealDimensions,
+            acBins,
+            flags,
+            cSamplesLeafMin,
+            aAuxiliaryBinsBase,
+            aBinsBase
+#ifndef NDEBUG
+            , aDebugCopyBinsBase
+            , pBinsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         return PartitionMultiDimensionalInteractionDimensions<false, k_oneScore>(
+            pInteractionCore,
+            cRealDimensions,
+            acBins,
+            flags,
+            cSamplesLeafMin,
+            aAuxiliaryBinsBase,
+            aBinsBase
+#ifndef NDEBUG
+            , aDebugCopyBinsBase
+            , pBinsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+}
+
+} // DEFINED_ZONE_NAME
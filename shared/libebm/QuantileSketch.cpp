@@ -0,0 +1,510 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "pch.hpp"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <algorithm> // std::sort
+#include <string.h> // memcpy
+
+#include "libebm.h" // EBM_API_BODY
+#include "logging.h" // EBM_ASSERT
+#include "unzoned.h" // LIKELY
+
+#define ZONE_main
+#include "zones.h"
+
+#include "common.hpp" // IsConvertError
+
+#include "ebm_internal.hpp" // EbmMax
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// The quantile sketch lets the caller compute quantile cuts over data that is too big to hold in memory at once.
+// The caller feeds it chunks of a feature with AddToQuantileSketch, can combine sketches built on separate shards
+// with MergeQuantileSketch, and finally obtains the cuts with CutQuantileSketch which runs the same algorithm as
+// CutQuantile.  The sketch lives entirely inside a single caller allocated buffer that holds no pointers, so it
+// can be copied, saved, or sent between processes as raw bytes (like the shared dataset, it is in machine endianness).
+//
+// The sketch is a deterministic compactor stack (the KLL/MRL family).  Level h holds up to k items that each
+// represent 2^h original samples.  When a level fills, it is sorted and every other item is promoted to the next
+// level, alternating between the even and the odd items on each compaction of that level so that the rank errors
+// tend to cancel.  The total weight of the retained items always equals the number of samples added, and for inputs
+// of fewer than k samples nothing is compacted so the cuts are identical to CutQuantile's.
+
+static constexpr UIntEbm k_quantileSketchWorkingId = 0x5D2B;
+static constexpr UIntEbm k_quantileSketchErrorId = 0x0327;
+
+// each compaction halves the item count, so 2^k_cQuantileSketchLevels * k samples can be added before we run out
+static constexpr size_t k_cQuantileSketchLevels = 48;
+
+// when there has been compaction we expand the weighted items back into a sample of this many values (or fewer if
+// there were fewer samples) that we can hand to CutQuantile
+static constexpr size_t k_cQuantileSketchExpandMin = size_t { 1 } << 20;
+
+struct HeaderQuantileSketch final {
+   HeaderQuantileSketch() = delete; // this is a POD that lives in the caller's buffer, so don't allow construction
+
+   UIntEbm m_id;
+   UIntEbm m_cItemsPerLevel;
+   UIntEbm m_cSamples; // non-missing samples added, which is also the total weight of the retained items
+   UIntEbm m_cMissing;
+   UIntEbm m_compactionParity; // bit h selects which half of level h survives its next compaction
+   UIntEbm m_acLevelItems[k_cQuantileSketchLevels];
+};
+static_assert(std::is_standard_layout<HeaderQuantileSketch>::value,
+   "These structs are shared between processes, so they definetly need to be standard layout and trivial");
+static_assert(std::is_trivial<HeaderQuantileSketch>::value,
+   "These structs are shared between processes, so they definetly need to be standard layout and trivial");
+static_assert(0 == sizeof(HeaderQuantileSketch) % sizeof(double), "The items need to be aligned after the header");
+
+struct WeightedItem final {
+   WeightedItem() = default; // preserve our POD status
+   ~WeightedItem() = default; // preserve our POD status
+
+   double m_val;
+   UIntEbm m_weight;
+
+   inline bool operator<(const WeightedItem & rhs) const noexcept {
+      return m_val < rhs.m_val;
+   }
+};
+static_assert(std::is_standard_layout<WeightedItem>::value && std::is_trivial<WeightedItem>::value,
+   "We use malloc and std::sort on this, so it needs to be POD");
+
+// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
+static int g_cLogEnterAddToQuantileSketch = 25;
+static int g_cLogEnterCutQuantileSketch = 25;
+
+static size_t GetCountBytesQuantileSketch(const size_t cItemsPerLevel) {
+   // returns 0 on overflow
+   if(IsMultiplyError(sizeof(double), cItemsPerLevel, k_cQuantileSketchLevels)) {
+      return 0;
+   }
+   const size_t cBytesItems = sizeof(double) * cItemsPerLevel * k_cQuantileSketchLevels;
+   if(IsAddError(sizeof(HeaderQuantileSketch), cBytesItems)) {
+      return 0;
+   }
+   return sizeof(HeaderQuantileSketch) + cBytesItems;
+}
+
+static bool IsIllegalCountItemsPerLevel(const IntEbm countItemsPerLevel) {
+   // the compactors discard exactly half of a full level, so the level size needs to be even
+   return countItemsPerLevel < IntEbm { 2 } || IsConvertError<size_t>(countItemsPerLevel) ||
+      0 != (countItemsPerLevel & IntEbm { 1 }) || 0 == GetCountBytesQuantileSketch(static_cast<size_t>(countItemsPerLevel));
+}
+
+static HeaderQuantileSketch * GetQuantileSketch(void * const pSketch, const char * const sFunction) {
+   if(nullptr == pSketch) {
+      LOG_N(Trace_Error, "ERROR %s nullptr == sketch", sFunction);
+      return nullptr;
+   }
+   HeaderQuantileSketch * const pHeader = reinterpret_cast<HeaderQuantileSketch *>(pSketch);
+   if(k_quantileSketchWorkingId != pHeader->m_id) {
+      LOG_N(Trace_Error, "ERROR %s sketch was not initialized or is in an error state", sFunction);
+      return nullptr;
+   }
+
+   // the sketch can come from a file or another process, so check everything that we later index or divide with
+
+   const UIntEbm countItemsPerLevel = pHeader->m_cItemsPerLevel;
+   if(IsConvertError<IntEbm>(countItemsPerLevel) ||
+      IsIllegalCountItemsPerLevel(static_cast<IntEbm>(countItemsPerLevel))) {
+      LOG_N(Trace_Error, "ERROR %s sketch has an illegal countItemsPerLevel", sFunction);
+      return nullptr;
+   }
+
+   UIntEbm weightTotal = 0;
+   for(size_t iLevel = 0; iLevel < k_cQuantileSketchLevels; ++iLevel) {
+      // a level is compacted as soon as it fills, so a full level is never left behind
+      const UIntEbm cItems = pHeader->m_acLevelItems[iLevel];
+      if(countItemsPerLevel <= cItems) {
+         LOG_N(Trace_Error, "ERROR %s sketch has a level with too many items", sFunction);
+         return nullptr;
+      }
+      if(IsMultiplyError(cItems, UIntEbm { 1 } << iLevel)) {
+         LOG_N(Trace_Error, "ERROR %s sketch has an item weight that overflows", sFunction);
+         return nullptr;
+      }
+      const UIntEbm weightLevel = cItems << iLevel;
+      if(IsAddError(weightTotal, weightLevel)) {
+         LOG_N(Trace_Error, "ERROR %s sketch has an item weight that overflows", sFunction);
+         return nullptr;
+      }
+      weightTotal += weightLevel;
+   }
+   if(weightTotal != pHeader->m_cSamples) {
+      LOG_N(Trace_Error, "ERROR %s sketch has a sample count that does not match its items", sFunction);
+      return nullptr;
+   }
+   if(IsAddError(pHeader->m_cSamples, pHeader->m_cMissing)) {
+      LOG_N(Trace_Error, "ERROR %s sketch has sample counts that overflow", sFunction);
+      return nullptr;
+   }
+
+   return pHeader;
+}
+
+static double * GetLevelItems(HeaderQuantileSketch * const pHeader, const size_t iLevel) {
+   EBM_ASSERT(iLevel < k_cQuantileSketchLevels);
+   double * const aItems = reinterpret_cast<double *>(pHeader + 1);
+   return aItems + static_cast<size_t>(pHeader->m_cItemsPerLevel) * iLevel;
+}
+
+static ErrorEbm PushItem(HeaderQuantileSketch * const pHeader, const size_t iLevel, const double val);
+
+static ErrorEbm CompactLevel(HeaderQuantileSketch * const pHeader, const size_t iLevel) {
+   const size_t cItemsPerLevel = static_cast<size_t>(pHeader->m_cItemsPerLevel);
+   EBM_ASSERT(cItemsPerLevel == static_cast<size_t>(pHeader->m_acLevelItems[iLevel]));
+
+   if(k_cQuantileSketchLevels <= iLevel + 1) {
+      LOG_0(Trace_Error, "ERROR CompactLevel the quantile sketch is full");
+      return Error_OutOfMemory;
+   }
+
+   double * const aLevel = GetLevelItems(pHeader, iLevel);
+   std::sort(aLevel, aLevel + cItemsPerLevel);
+
+   const UIntEbm bit = UIntEbm { 1 } << iLevel;
+   const size_t iStart = 0 != (pHeader->m_compactionParity & bit) ? size_t { 1 } : size_t { 0 };
+   pHeader->m_compactionParity ^= bit;
+
+   // pushing into the higher levels never touches this level, so we can keep reading from it until we're done
+   for(size_t i = iStart; i < cItemsPerLevel; i += 2) {
+      const ErrorEbm error = PushItem(pHeader, iLevel + 1, aLevel[i]);
+      if(Error_None != error) {
+         return error;
+      }
+   }
+   pHeader->m_acLevelItems[iLevel] = 0;
+   return Error_None;
+}
+
+static ErrorEbm PushItem(HeaderQuantileSketch * const pHeader, const size_t iLevel, const double val) {
+   EBM_ASSERT(iLevel < k_cQuantileSketchLevels);
+
+   size_t cItems = static_cast<size_t>(pHeader->m_acLevelItems[iLevel]);
+   EBM_ASSERT(cItems < static_cast<size_t>(pHeader->m_cItemsPerLevel));
+   GetLevelItems(pHeader, iLevel)[cItems] = val;
+   ++cItems;
+   pHeader->m_acLevelItems[iLevel] = static_cast<UIntEbm>(cItems);
+
+   if(static_cast<size_t>(pHeader->m_cItemsPerLevel) == cItems) {
+      return CompactLevel(pHeader, iLevel);
+   }
+   return Error_None;
+}
+
+EBM_API_BODY IntEbm EBM_CALLING_CONVENTION MeasureQuantileSketch(IntEbm countItemsPerLevel) {
+   if(IsIllegalCountItemsPerLevel(countItemsPerLevel)) {
+      LOG_0(Trace_Error, "ERROR MeasureQuantileSketch countItemsPerLevel must be an even number of 2 or more");
+      return Error_IllegalParamVal;
+   }
+   const size_t cBytes = GetCountBytesQuantileSketch(static_cast<size_t>(countItemsPerLevel));
+   if(IsConvertError<IntEbm>(cBytes)) {
+      LOG_0(Trace_Error, "ERROR MeasureQuantileSketch IsConvertError<IntEbm>(cBytes)");
+      return Error_OutOfMemory;
+   }
+   return static_cast<IntEbm>(cBytes);
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION InitQuantileSketch(
+   IntEbm countItemsPerLevel,
+   IntEbm countBytesAllocated,
+   void * sketchOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered InitQuantileSketch: "
+      "countItemsPerLevel=%" IntEbmPrintf ", "
+      "countBytesAllocated=%" IntEbmPrintf ", "
+      "sketchOut=%p"
+      ,
+      countItemsPerLevel,
+      countBytesAllocated,
+      sketchOut
+   );
+
+   if(nullptr == sketchOut) {
+      LOG_0(Trace_Error, "ERROR InitQuantileSketch nullptr == sketchOut");
+      return Error_IllegalParamVal;
+   }
+   if(IsIllegalCountItemsPerLevel(countItemsPerLevel)) {
+      LOG_0(Trace_Error, "ERROR InitQuantileSketch countItemsPerLevel must be an even number of 2 or more");
+      return Error_IllegalParamVal;
+   }
+   const size_t cItemsPerLevel = static_cast<size_t>(countItemsPerLevel);
+   if(IsConvertError<size_t>(countBytesAllocated) ||
+      static_cast<size_t>(countBytesAllocated) < GetCountBytesQuantileSketch(cItemsPerLevel)) {
+      LOG_0(Trace_Error, "ERROR InitQuantileSketch countBytesAllocated is smaller than MeasureQuantileSketch");
+      return Error_IllegalParamVal;
+   }
+
+   HeaderQuantileSketch * const pHeader = reinterpret_cast<HeaderQuantileSketch *>(sketchOut);
+   pHeader->m_id = k_quantileSketchWorkingId;
+   pHeader->m_cItemsPerLevel = static_cast<UIntEbm>(cItemsPerLevel);
+   pHeader->m_cSamples = 0;
+   pHeader->m_cMissing = 0;
+   pHeader->m_compactionParity = 0;
+   for(size_t iLevel = 0; iLevel < k_cQuantileSketchLevels; ++iLevel) {
+      pHeader->m_acLevelItems[iLevel] = 0;
+   }
+
+   LOG_0(Trace_Info, "Exited InitQuantileSketch");
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION AddToQuantileSketch(
+   IntEbm countSamples,
+   const double * featureVals,
+   void * sketch
+) {
+   LOG_COUNTED_N(
+      &g_cLogEnterAddToQuantileSketch,
+      Trace_Info,
+      Trace_Verbose,
+      "Entered AddToQuantileSketch: "
+      "countSamples=%" IntEbmPrintf ", "
+      "featureVals=%p, "
+      "sketch=%p"
+      ,
+      countSamples,
+      static_cast<const void *>(featureVals),
+      sketch
+   );
+
+   HeaderQuantileSketch * const pHeader = GetQuantileSketch(sketch, "AddToQuantileSketch");
+   if(nullptr == pHeader) {
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countSamples)) {
+      LOG_0(Trace_Error, "ERROR AddToQuantileSketch countSamples must be a non-negative size_t");
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   if(size_t { 0 } != cSamples && nullptr == featureVals) {
+      LOG_0(Trace_Error, "ERROR AddToQuantileSketch nullptr == featureVals");
+      return Error_IllegalParamVal;
+   }
+
+   const double * pVal = featureVals;
+   const double * const pValsEnd = featureVals + cSamples;
+   while(pValsEnd != pVal) {
+      const double val = *pVal;
+      ++pVal;
+      if(std::isnan(val)) {
+         ++pHeader->m_cMissing;
+      } else {
+         ++pHeader->m_cSamples;
+         const ErrorEbm error = PushItem(pHeader, 0, val);
+         if(Error_None != error) {
+            pHeader->m_id = k_quantileSketchErrorId;
+            return error;
+         }
+      }
+   }
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION MergeQuantileSketch(
+   const void * sketchFrom,
+   void * sketchInto
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered MergeQuantileSketch: "
+      "sketchFrom=%p, "
+      "sketchInto=%p"
+      ,
+      sketchFrom,
+      sketchInto
+   );
+
+   // GetQuantileSketch doesn't modify the sketch, and we only read from sketchFrom below
+   HeaderQuantileSketch * const pFrom = GetQuantileSketch(const_cast<void *>(sketchFrom), "MergeQuantileSketch");
+   if(nullptr == pFrom) {
+      return Error_IllegalParamVal;
+   }
+   HeaderQuantileSketch * const pInto = GetQuantileSketch(sketchInto, "MergeQuantileSketch");
+   if(nullptr == pInto) {
+      return Error_IllegalParamVal;
+   }
+   if(pFrom == pInto) {
+      LOG_0(Trace_Error, "ERROR MergeQuantileSketch a sketch cannot be merged into itself");
+      return Error_IllegalParamVal;
+   }
+   if(pFrom->m_cItemsPerLevel != pInto->m_cItemsPerLevel) {
+      LOG_0(Trace_Error, "ERROR MergeQuantileSketch the sketches must have the same countItemsPerLevel");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsAddError(pInto->m_cSamples, pFrom->m_cSamples, pInto->m_cMissing, pFrom->m_cMissing)) {
+      LOG_0(Trace_Error, "ERROR MergeQuantileSketch the merged sample counts overflow");
+      return Error_IllegalParamVal;
+   }
+   pInto->m_cSamples += pFrom->m_cSamples;
+   pInto->m_cMissing += pFrom->m_cMissing;
+
+   // items keep their weight by entering the level that they came from in the other sketch
+   for(size_t iLevel = 0; iLevel < k_cQuantileSketchLevels; ++iLevel) {
+      const double * pItem = GetLevelItems(pFrom, iLevel);
+      const double * const pItemsEnd = pItem + static_cast<size_t>(pFrom->m_acLevelItems[iLevel]);
+      while(pItemsEnd != pItem) {
+         const ErrorEbm error = PushItem(pInto, iLevel, *pItem);
+         if(Error_None != error) {
+            pInto->m_id = k_quantileSketchErrorId;
+            return error;
+         }
+         ++pItem;
+      }
+   }
+
+   LOG_0(Trace_Info, "Exited MergeQuantileSketch");
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantileSketch(
+   const void * sketch,
+   IntEbm minSamplesBin,
+   BoolEbm isRounded,
+   IntEbm * countCutsInOut,
+   double * cutsLowerBoundInclusiveOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogEnterCutQuantileSketch,
+      Trace_Info,
+      Trace_Verbose,
+      "Entered CutQuantileSketch: "
+      "sketch=%p, "
+      "minSamplesBin=%" IntEbmPrintf ", "
+      "isRounded=%s, "
+      "countCutsInOut=%p, "
+      "cutsLowerBoundInclusiveOut=%p"
+      ,
+      sketch,
+      minSamplesBin,
+      ObtainTruth(isRounded),
+      static_cast<void *>(countCutsInOut),
+      static_cast<void *>(cutsLowerBoundInclusiveOut)
+   );
+
+   HeaderQuantileSketch * const pHeader = GetQuantileSketch(const_cast<void *>(sketch), "CutQuantileSketch");
+   if(nullptr == pHeader) {
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == countCutsInOut) {
+      LOG_0(Trace_Error, "ERROR CutQuantileSketch nullptr == countCutsInOut");
+      return Error_IllegalParamVal;
+   }
+
+   size_t cRetained = 0;
+   for(size_t iLevel = 0; iLevel < k_cQuantileSketchLevels; ++iLevel) {
+      cRetained += static_cast<size_t>(pHeader->m_acLevelItems[iLevel]);
+   }
+   const size_t cItemsLevel0 = static_cast<size_t>(pHeader->m_acLevelItems[0]);
+
+   if(cRetained <= size_t { 1 }) {
+      // CutQuantile can't cut 0 or 1 samples, so the value is irrelevant, but let it check the params and the output
+      const double val = 0.0;
+      return CutQuantile(static_cast<IntEbm>(cRetained), &val, minSamplesBin, isRounded, countCutsInOut,
+         cutsLowerBoundInclusiveOut);
+   }
+
+   ErrorEbm error;
+   double * aExpanded = nullptr;
+   WeightedItem * aWeighted = nullptr;
+   size_t cExpanded;
+
+   if(cItemsLevel0 == cRetained) {
+      // nothing was compacted, so the retained items are exactly the samples added
+      cExpanded = cRetained;
+      aExpanded = static_cast<double *>(malloc(sizeof(double) * cExpanded));
+      if(nullptr == aExpanded) {
+         LOG_0(Trace_Warning, "WARNING CutQuantileSketch nullptr == aExpanded");
+         return Error_OutOfMemory;
+      }
+      memcpy(aExpanded, GetLevelItems(pHeader, 0), sizeof(double) * cExpanded);
+   } else {
+      const UIntEbm cSamples = pHeader->m_cSamples;
+      cExpanded = EbmMax(k_cQuantileSketchExpandMin, cRetained << 2);
+      if(cSamples < static_cast<UIntEbm>(cExpanded)) {
+         cExpanded = static_cast<size_t>(cSamples);
+      }
+
+      if(IsMultiplyError(sizeof(WeightedItem), cRetained) || IsMultiplyError(sizeof(double), cExpanded)) {
+         LOG_0(Trace_Warning, "WARNING CutQuantileSketch IsMultiplyError");
+         return Error_OutOfMemory;
+      }
+      aWeighted = static_cast<WeightedItem *>(malloc(sizeof(WeightedItem) * cRetained));
+      if(nullptr == aWeighted) {
+         LOG_0(Trace_Warning, "WARNING CutQuantileSketch nullptr == aWeighted");
+         return Error_OutOfMemory;
+      }
+      aExpanded = static_cast<double *>(malloc(sizeof(double) * cExpanded));
+      if(nullptr == aExpanded) {
+         LOG_0(Trace_Warning, "WARNING CutQuantileSketch nullptr == aExpanded");
+         error = Error_OutOfMemory;
+         goto exit_with_log;
+      }
+
+      WeightedItem * pWeighted = aWeighted;
+      for(size_t iLevel = 0; iLevel < k_cQuantileSketchLevels; ++iLevel) {
+         const double * pItem = GetLevelItems(pHeader, iLevel);
+         const double * const pItemsEnd = pItem + static_cast<size_t>(pHeader->m_acLevelItems[iLevel]);
+         while(pItemsEnd != pItem) {
+            pWeighted->m_val = *pItem;
+            pWeighted->m_weight = UIntEbm { 1 } << iLevel;
+            ++pWeighted;
+            ++pItem;
+         }
+      }
+      std::sort(aWeighted, aWeighted + cRetained);
+
+      // each item fills the slots of the expanded sample that its cumulative weight covers.  The final cumulative
+      // weight is cSamples which maps to exactly cExpanded, so every slot gets filled
+      const double scale = static_cast<double>(cExpanded) / static_cast<double>(cSamples);
+      UIntEbm weightCumulative = 0;
+      size_t iExpanded = 0;
+      for(size_t iWeighted = 0; iWeighted < cRetained; ++iWeighted) {
+         weightCumulative += aWeighted[iWeighted].m_weight;
+         size_t iEnd = cExpanded;
+         if(weightCumulative < cSamples) {
+            iEnd = static_cast<size_t>(static_cast<double>(weightCumulative) * scale + 0.5);
+            iEnd = EbmMin(iEnd, cExpanded);
+         }
+         const double val = aWeighted[iWeighted].m_val;
+         while(iExpanded < iEnd) {
+            aExpanded[iExpanded] = val;
+            ++iExpanded;
+         }
+      }
+      EBM_ASSERT(cSamples == weightCumulative);
+      EBM_ASSERT(cExpanded == iExpanded);
+
+      // minSamplesBin is in units of the original samples, so scale it down to the expanded sample
+      if(IntEbm { 1 } < minSamplesBin && cExpanded < cSamples) {
+         const double minSamplesBinScaled = static_cast<double>(minSamplesBin) * scale;
+         minSamplesBin = minSamplesBinScaled < 1.0 ? IntEbm { 1 } : static_cast<IntEbm>(minSamplesBinScaled + 0.5);
+      }
+   }
+
+   if(IsConvertError<IntEbm>(cExpanded)) {
+      LOG_0(Trace_Warning, "WARNING CutQuantileSketch IsConvertError<IntEbm>(cExpanded)");
+      error = Error_OutOfMemory;
+      goto exit_with_log;
+   }
+   error = CutQuantile(static_cast<IntEbm>(cExpanded), aExpanded, minSamplesBin, isRounded, countCutsInOut,
+      cutsLowerBoundInclusiveOut);
+
+exit_with_log:;
+
+   free(aWeighted);
+   free(aExpanded);
+   return error;
+}
+
+} // DEFINED_ZONE_NAME
@@ -0,0 +1,1070 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "pch.hpp"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <limits> // std::numeric_limits
+#include <string.h> // memcpy
+
+#include "libebm.h"
+#include "logging.h"
+#include "unzoned.h" // LIKELY
+
+#define ZONE_main
+#include "zones.h"
+
+#include "common.hpp" // IsConvertError
+#include "ebm_internal.hpp" // TransposeStripe, DiscretizeEytzinger
+
+#include "ThreadPool.hpp"
+#include "ScoringModel.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// Each task bins and scores a block of samples.  The bin indexes for every binning in the block are held at once
+// so that pairs can reuse the binning of their mains, so we size the blocks to keep that scratch space in L2.
+static constexpr size_t k_cBytesScoringScratch = size_t { 262144 };
+static constexpr size_t k_cScoringBlockSamplesMin = size_t { 64 };
+static constexpr size_t k_cScoringBlockSamplesMax = size_t { 4096 };
+
+// keep at least one column of the transpose stripe so that the scratch space is never empty, even for intercept
+// only models
+static size_t GetBytesPerBlockSample(const size_t cBinnings) {
+   const size_t cStripeColumns = EbmMin(k_cTransposeStripeColumnsMax, EbmMax(size_t { 1 }, cBinnings));
+   return sizeof(IntEbm) * cBinnings + sizeof(double) * cStripeColumns;
+}
+
+static size_t GetBlockSamplesMax(const size_t cBytesPerBlockSample) {
+   return EbmMax(k_cScoringBlockSamplesMin,
+      EbmMin(k_cScoringBlockSamplesMax, k_cBytesScoringScratch / cBytesPerBlockSample));
+}
+
+// reserves a cache aligned section of cItems * cBytesItem bytes at the end of the arena.  Returns true on overflow
+static bool ReserveArenaSection(
+   size_t * const pcBytesArena,
+   const size_t cItems,
+   const size_t cBytesItem,
+   size_t * const piByteSectionOut
+) {
+   const size_t cBytesArena = *pcBytesArena;
+   if(IsAddError(cBytesArena, SIMD_BYTE_ALIGNMENT - size_t { 1 })) {
+      return true;
+   }
+   const size_t iByteSection = (cBytesArena + (SIMD_BYTE_ALIGNMENT - size_t { 1 })) & ~(SIMD_BYTE_ALIGNMENT - size_t { 1 });
+   if(IsMultiplyError(cItems, cBytesItem) || IsAddError(iByteSection, cItems * cBytesItem)) {
+      return true;
+   }
+   *piByteSectionOut = iByteSection;
+   *pcBytesArena = iByteSection + cItems * cBytesItem;
+   return false;
+}
+
+struct ScoringContext final {
+   const ScoringModel * m_pScoringModel;
+   const ScoringBinning * m_aBinnings;
+   size_t m_cBinnings;
+   const ScoringTerm * m_aTerms;
+   size_t m_cTerms;
+   size_t m_cScores;
+   const double * m_aIntercept;
+
+   size_t m_cSamples;
+   size_t m_cFeatures;
+   bool m_bFortranOrdered;
+   const double * m_aFeatureMatrix;
+   LinkEbm m_link;
+   double * m_aScoresOut;
+
+   size_t m_cBlockSamples;
+   // per thread: m_cBinnings * m_cBlockSamples bin indexes followed by a stripe of transposed feature columns
+   // that holds up to k_cTransposeStripeColumnsMax columns of m_cBlockSamples values each
+   size_t m_cBytesScratchPerThread;
+   unsigned char * m_aScratch;
+};
+
+static IntEbm DiscretizeCategory(const double val, const ScoringBinning * const pBinning) {
+   if(PREDICTABLE(std::isnan(val))) {
+      return IntEbm { 0 };
+   }
+
+   const double * const aValues = pBinning->m_aValues;
+   size_t iLow = 0;
+   size_t iHigh = pBinning->m_cValues;
+   while(iLow < iHigh) {
+      const size_t iMid = iLow + ((iHigh - iLow) >> 1);
+      const double midVal = aValues[iMid];
+      if(midVal == val) {
+         return pBinning->m_aCategoryBins[iMid];
+      }
+      if(midVal < val) {
+         iLow = iMid + size_t { 1 };
+      } else {
+         iHigh = iMid;
+      }
+   }
+   // the unknown bin is always the last one
+   return static_cast<IntEbm>(pBinning->m_cBins - size_t { 1 });
+}
+
+static void ApplyInverseLink(const LinkEbm link, const size_t cScores, double * const aScores) {
+   if(Link_log == link) {
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         aScores[iScore] = std::exp(aScores[iScore]);
+      }
+   } else if(Link_logit == link || Link_vlogit == link) {
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         // match the python inv_link, which computes exp(x) / (exp(x) + 1) and fixes up +inf afterwards
+         const double val = std::exp(aScores[iScore]);
+         aScores[iScore] = std::isinf(val) ? 1.0 : val / (val + 1.0);
+      }
+   } else if(Link_mlogit == link) {
+      EBM_ASSERT(size_t { 2 } <= cScores);
+
+      bool bNaN = false;
+      size_t cPositiveInf = 0;
+      double maxScore = -std::numeric_limits<double>::infinity();
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         const double score = aScores[iScore];
+         bNaN = bNaN || std::isnan(score);
+         cPositiveInf += std::numeric_limits<double>::infinity() == score ? size_t { 1 } : size_t { 0 };
+         maxScore = EbmMax(maxScore, score);
+      }
+
+      if(bNaN) {
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            aScores[iScore] = std::numeric_limits<double>::quiet_NaN();
+         }
+      } else if(size_t { 0 } != cPositiveInf || -std::numeric_limits<double>::infinity() == maxScore) {
+         // the infinite scores share the probability, and if all scores are -inf then all classes share it
+         const double prob = 1.0 / static_cast<double>(size_t { 0 } != cPositiveInf ? cPositiveInf : cScores);
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            const bool bShare = size_t { 0 } == cPositiveInf || std::numeric_limits<double>::infinity() == aScores[iScore];
+            aScores[iScore] = bShare ? prob : 0.0;
+         }
+      } else {
+         double sum = 0.0;
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            const double val = std::exp(aScores[iScore] - maxScore);
+            aScores[iScore] = val;
+            sum += val;
+         }
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            aScores[iScore] /= sum;
+         }
+      }
+   } else {
+      EBM_ASSERT(Link_identity == link);
+   }
+}
+
+static ErrorEbm ScoreBlock(void * const pContextVoid, const size_t iTask, const size_t iThread) {
+   const ScoringContext * const pContext = static_cast<const ScoringContext *>(pContextVoid);
+
+   const size_t cBlockSamples = pContext->m_cBlockSamples;
+   const size_t iSampleStart = iTask * cBlockSamples;
+   EBM_ASSERT(iSampleStart < pContext->m_cSamples);
+   const size_t cSamples = EbmMin(cBlockSamples, pContext->m_cSamples - iSampleStart);
+
+   unsigned char * const pScratch = pContext->m_aScratch + pContext->m_cBytesScratchPerThread * iThread;
+   IntEbm * const aaBinIndexes = reinterpret_cast<IntEbm *>(pScratch);
+   double * const aColumns = reinterpret_cast<double *>(aaBinIndexes + pContext->m_cBinnings * cBlockSamples);
+
+   const size_t cFeatures = pContext->m_cFeatures;
+   const ScoringBinning * const aBinnings = pContext->m_aBinnings;
+   size_t iStripeStart = 0;
+   size_t cStripeColumns = 0;
+   for(size_t iBinning = 0; iBinning < pContext->m_cBinnings; ++iBinning) {
+      const ScoringBinning * const pBinning = &aBinnings[iBinning];
+      IntEbm * const aBinIndexes = &aaBinIndexes[iBinning * cBlockSamples];
+
+      const double * aVals;
+      if(pContext->m_bFortranOrdered) {
+         aVals = &pContext->m_aFeatureMatrix[pBinning->m_iFeature * pContext->m_cSamples + iSampleStart];
+      } else {
+         if(iStripeStart + cStripeColumns == iBinning) {
+            // transpose the next stripe of binnings in a single pass over the rows of the block.  Gathering one
+            // column at a time would stream every row through the cache once per binning
+            iStripeStart = iBinning;
+            cStripeColumns = EbmMin(k_cTransposeStripeColumnsMax, pContext->m_cBinnings - iBinning);
+            size_t aiColumns[k_cTransposeStripeColumnsMax];
+            for(size_t iColumn = 0; iColumn < cStripeColumns; ++iColumn) {
+               aiColumns[iColumn] = aBinnings[iStripeStart + iColumn].m_iFeature;
+            }
+            TransposeStripe(
+               cSamples,
+               cFeatures,
+               &pContext->m_aFeatureMatrix[iSampleStart * cFeatures],
+               cStripeColumns,
+               aiColumns,
+               aColumns
+            );
+         }
+         aVals = &aColumns[(iBinning - iStripeStart) * cSamples];
+      }
+
+      if(nullptr != pBinning->m_aEytzinger) {
+         DiscretizeEytzinger(
+            cSamples,
+            aVals,
+            pBinning->m_cValues,
+            pBinning->m_cEytzingerLevels,
+            pBinning->m_aEytzinger,
+            aBinIndexes
+         );
+      } else if(nullptr == pBinning->m_aCategoryBins) {
+         const ErrorEbm error = Discretize(
+            static_cast<IntEbm>(cSamples),
+            aVals,
+            static_cast<IntEbm>(pBinning->m_cValues),
+            pBinning->m_aValues,
+            aBinIndexes
+         );
+         if(Error_None != error) {
+            return error;
+         }
+      } else {
+         for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+            aBinIndexes[iSample] = DiscretizeCategory(aVals[iSample], pBinning);
+         }
+      }
+   }
+
+   const size_t cScores = pContext->m_cScores;
+   double * const aScoresOut = &pContext->m_aScoresOut[iSampleStart * cScores];
+   const double * const aIntercept = pContext->m_aIntercept;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      memcpy(&aScoresOut[iSample * cScores], aIntercept, sizeof(*aIntercept) * cScores);
+   }
+
+   const ScoringTerm * const aTerms = pContext->m_aTerms;
+   for(size_t iTerm = 0; iTerm < pContext->m_cTerms; ++iTerm) {
+      const ScoringTerm * const pTerm = &aTerms[iTerm];
+      const size_t cDimensions = pTerm->m_cDimensions;
+      const size_t * const aiBinnings = pTerm->m_aiBinnings;
+      const size_t * const acStrides = pTerm->m_acStrides;
+      const double * const aTermScores = pTerm->m_aScores;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         size_t iTensorScore = 0;
+         for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+            const size_t iBinning = aiBinnings[iDimension];
+            const IntEbm iBin = aaBinIndexes[iBinning * cBlockSamples + iSample];
+            EBM_ASSERT(IntEbm { 0 } <= iBin && static_cast<size_t>(iBin) < aBinnings[iBinning].m_cBins);
+            iTensorScore += static_cast<size_t>(iBin) * acStrides[iDimension];
+         }
+         const double * const aTensorScores = &aTermScores[iTensorScore];
+         double * const aSampleScores = &aScoresOut[iSample * cScores];
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            aSampleScores[iScore] += aTensorScores[iScore];
+         }
+      }
+   }
+
+   if(Link_identity != pContext->m_link) {
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         ApplyInverseLink(pContext->m_link, cScores, &aScoresOut[iSample * cScores]);
+      }
+   }
+
+   return Error_None;
+}
+
+bool ScoringModel::IsLinkSupported(const LinkEbm link, const size_t cScores) {
+   if(Link_identity == link || Link_log == link || Link_vlogit == link) {
+      return true;
+   }
+   if(Link_logit == link) {
+      return size_t { 1 } == cScores;
+   }
+   if(Link_mlogit == link) {
+      return size_t { 2 } <= cScores;
+   }
+   return false;
+}
+
+void ScoringModel::Free(ScoringModel * const pScoringModel) {
+   LOG_0(Trace_Info, "Entered ScoringModel::Free");
+
+   if(nullptr != pScoringModel) {
+      // simple check to make use after free errors less likely
+      pScoringModel->m_handleVerification = k_handleVerificationFreed;
+      ThreadPool::Free(pScoringModel->m_pThreadPool);
+      AlignedFree(pScoringModel);
+   }
+
+   LOG_0(Trace_Info, "Exited ScoringModel::Free");
+}
+
+ErrorEbm ScoringModel::Create(
+   const bool bView,
+   const size_t cSamplesView,
+   const size_t cBinnings,
+   const IntEbm * const binningFeatureIndexes,
+   const BoolEbm * const binningIsCategorical,
+   const IntEbm * const binningCountBins,
+   const IntEbm * const binningCountValues,
+   const double * const binningValues,
+   const IntEbm * const binningCategoryBins,
+   const size_t cTerms,
+   const IntEbm * const termDimensionCounts,
+   const IntEbm * const termBinningIndexes,
+   const size_t cScores,
+   const double * const termScores,
+   const double * const intercept,
+   ScoringModel ** const ppScoringModelOut
+) {
+   LOG_0(Trace_Info, "Entered ScoringModel::Create");
+
+   EBM_ASSERT(nullptr != ppScoringModelOut);
+   EBM_ASSERT(nullptr == *ppScoringModelOut);
+
+   if(size_t { 0 } != cBinnings) {
+      if(nullptr == binningFeatureIndexes || nullptr == binningIsCategorical || nullptr == binningCountBins ||
+         nullptr == binningCountValues) {
+         LOG_0(Trace_Error, "ERROR ScoringModel::Create the binning arrays cannot be nullptr");
+         return Error_IllegalParamVal;
+      }
+   }
+   if(size_t { 0 } != cTerms && nullptr == termDimensionCounts) {
+      LOG_0(Trace_Error, "ERROR ScoringModel::Create termDimensionCounts cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+
+   // first pass: validate everything and measure the arena
+
+   size_t cFeaturesMin = 0;
+   size_t cValuesTotal = 0;
+   size_t cEytzingerTotal = 0;
+   for(size_t iBinning = 0; iBinning < cBinnings; ++iBinning) {
+      const IntEbm indexFeature = binningFeatureIndexes[iBinning];
+      if(indexFeature < IntEbm { 0 } || IsConvertError<size_t>(indexFeature) ||
+         std::numeric_limits<size_t>::max() == static_cast<size_t>(indexFeature)) {
+         LOG_0(Trace_Error, "ERROR ScoringModel::Create binningFeatureIndexes value out of range");
+         return Error_IllegalParamVal;
+      }
+      cFeaturesMin = EbmMax(cFeaturesMin, static_cast<size_t>(indexFeature) + size_t { 1 });
+
+      const IntEbm countValues = binningCountValues[iBinning];
+      if(countValues < IntEbm { 0 } || IsConvertError<size_t>(countValues) ||
+         std::numeric_limits<IntEbm>::max() - IntEbm { 2 } < countValues) {
+         LOG_0(Trace_Error, "ERROR ScoringModel::Create binningCountValues value out of range");
+         return Error_IllegalParamVal;
+      }
+      const size_t cValues = static_cast<size_t>(countValues);
+
+      const IntEbm countBins = binningCountBins[iBinning];
+      if(countBins < IntEbm { 0 } || IsConvertError<size_t>(countBins)) {
+         LOG_0(Trace_Error, "ERROR ScoringModel::Create binningCountBins value out of range");
+         return Error_IllegalParamVal;
+      }
+      const size_t cBins = static_cast<size_t>(countBins);
+
+      if(IsAddError(cValuesTotal, cValues)) {
+         LOG_0(Trace_Error, "ERROR ScoringModel::Create IsAddError(cValuesTotal, cValues)");
+         return Error_IllegalParamVal;
+      }
+      if(size_t { 0 } != cValues && nullptr == binningValues) {
+         LOG_0(Trace_Error, "ERROR ScoringModel::Create binningValues cannot be nullptr");
+         return Error_IllegalParamVal;
+      }
+
+      if(EBM_FALSE != binningIsCategorical[iBinning]) {
+         // categoricals need a missing bin and an unknown bin, even if there are no categories
+         if(cBins < size_t { 2 }) {
+            LOG_0(Trace_Error, "ERROR ScoringModel::Create categorical binnings need at least 2 bins");
+            return Error_IllegalParamVal;
+         }
+         if(nullptr == binningCategoryBins) {
+            LOG_0(Trace_Error, "ERROR ScoringModel::Create binningCategoryBins cannot be nullptr with categoricals");
+            return Error_IllegalParamVal;
+         }
+         for(size_t iCategory = 0; iCategory < cValues; ++iCategory) {
+            const IntEbm iBin = binningCategoryBins[cValuesTotal + iCategory];
+            if(iBin < IntEbm { 0 } || IsConvertError<size_t>(iBin) || cBins <= static_cast<size_t>(iBin)) {
+               LOG_0(Trace_Error, "ERROR ScoringModel::Create binningCategoryBins value out of range");
+               return Error_IllegalParamVal;
+            }
+            const double val = binningValues[cValuesTotal + iCategory];
+            if(std::isnan(val) || size_t { 0 } != iCategory && !(binningValues[cValuesTotal + iCategory - 1] < val)) {
+               LOG_0(Trace_Error, "ERROR ScoringModel::Create categorical values must be strictly increasing");
+               return Error_IllegalParamVal;
+            }
+         }
+      } else {
+         // the missing bin, one more bin than cuts, and the unknown bin, which we never produce for doubles
+         if(cBins < cValues + size_t { 2 }) {
+            LOG_0(Trace_Error, "ERROR ScoringModel::Create continuous binnings need at least countCuts + 2 bins");
+            return Error_IllegalParamVal;
+         }
+         if(IsEytzingerCuts(cValues) && (!bView || cValues <= cSamplesView)) {
+            const size_t cSlots = size_t { 1 } << GetEytzingerLevels(cValues);
+            if(IsAddError(cEytzingerTotal, cSlots)) {
+               LOG_0(Trace_Warning, "WARNING ScoringModel::Create IsAddError(cEytzingerTotal, cSlots)");
+               return Error_OutOfMemory;
+            }
+            cEytzingerTotal += cSlots;
+         }
+      }
+
+      cValuesTotal += cValues;
+   }
+
+   size_t cDimensionsTotal = 0;
+   size_t cTensorScoresTotal = 0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      const IntEbm countDimensions = termDimensionCounts[iTerm];
+      if(countDimensions < IntEbm { 0 } || IsConvertError<size_t>(countDimensions)) {
+         LOG_0(Trace_Error, "ERROR ScoringModel::Create termDimensionCounts value out of range");
+         return Error_IllegalParamVal;
+      }
+      const size_t cDimensions = static_cast<size_t>(countDimensions);
+      if(size_t { 0 } != cDimensions && nullptr == termBinningIndexes) {
+         LOG_0(Trace_Error, "ERROR ScoringModel::Create termBinningIndexes cannot be nullptr");
+         return Error_IllegalParamVal;
+      }
+      if(IsAddError(cDimensionsTotal, cDimensions)) {
+         LOG_0(Trace_Error, "ERROR ScoringModel::Create IsAddError(cDimensionsTotal, cDimensions)");
+         return Error_IllegalParamVal;
+      }
+
+      size_t cTensorScores = cScores;
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const IntEbm indexBinning = termBinningIndexes[cDimensionsTotal + iDimension];
+         if(indexBinning < IntEbm { 0 } || IsConvertError<size_t>(indexBinning) ||
+            cBinnings <= static_cast<size_t>(indexBinning)) {
+            LOG_0(Trace_Error, "ERROR ScoringModel::Create termBinningIndexes value out of range");
+            return Error_IllegalParamVal;
+         }
+         const size_t cBins = static_cast<size_t>(binningCountBins[static_cast<size_t>(indexBinning)]);
+         if(IsMultiplyError(cTensorScores, cBins)) {
+            LOG_0(Trace_Error, "ERROR ScoringModel::Create IsMultiplyError(cTensorScores, cBins)");
+            return Error_IllegalParamVal;
+         }
+         cTensorScores *= cBins;
+      }
+      if(IsAddError(cTensorScoresTotal, cTensorScores)) {
+         LOG_0(Trace_Error, "ERROR ScoringModel::Create IsAddError(cTensorScoresTotal, cTensorScores)");
+         return Error_IllegalParamVal;
+      }
+
+      cDimensionsTotal += cDimensions;
+      cTensorScoresTotal += cTensorScores;
+   }
+   if(size_t { 0 } != cTensorScoresTotal && nullptr == termScores) {
+      LOG_0(Trace_Error, "ERROR ScoringModel::Create termScores cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+
+   // views leave the cuts, categories and tensors where the caller has them
+   const size_t cValuesCopy = bView ? size_t { 0 } : cValuesTotal;
+   const size_t cTensorScoresCopy = bView ? size_t { 0 } : cTensorScoresTotal;
+
+   size_t cBytesArena = sizeof(ScoringModel);
+   size_t iByteBinnings;
+   size_t iByteTerms;
+   size_t iByteBinningIndexes;
+   size_t iByteStrides;
+   size_t iByteIntercept;
+   size_t iByteValues;
+   size_t iByteCategoryBins;
+   size_t iByteEytzinger;
+   size_t iByteTensors;
+   if(ReserveArenaSection(&cBytesArena, cBinnings, sizeof(ScoringBinning), &iByteBinnings) ||
+      ReserveArenaSection(&cBytesArena, cTerms, sizeof(ScoringTerm), &iByteTerms) ||
+      ReserveArenaSection(&cBytesArena, cDimensionsTotal, sizeof(size_t), &iByteBinningIndexes) ||
+      ReserveArenaSection(&cBytesArena, cDimensionsTotal, sizeof(size_t), &iByteStrides) ||
+      ReserveArenaSection(&cBytesArena, cScores, sizeof(double), &iByteIntercept) ||
+      ReserveArenaSection(&cBytesArena, cValuesCopy, sizeof(double), &iByteValues) ||
+      ReserveArenaSection(&cBytesArena, cValuesCopy, sizeof(IntEbm), &iByteCategoryBins) ||
+      ReserveArenaSection(&cBytesArena, cEytzingerTotal, sizeof(double), &iByteEytzinger) ||
+      ReserveArenaSection(&cBytesArena, cTensorScoresCopy, sizeof(double), &iByteTensors)) {
+      LOG_0(Trace_Warning, "WARNING ScoringModel::Create the model is too large for memory");
+      return Error_OutOfMemory;
+   }
+
+   ThreadPool * pThreadPool = nullptr;
+   if(!bView) {
+      ErrorEbm error = ThreadPool::Create(ThreadPool::GetCountThreadsConfig(), &pThreadPool);
+      if(Error_None != error) {
+         return error;
+      }
+      // size the scratch for the largest block now so that Score never needs to allocate on this pool
+      const size_t cBytesPerBlockSample = GetBytesPerBlockSample(cBinnings);
+      const size_t cBlockSamplesMax = GetBlockSamplesMax(cBytesPerBlockSample);
+      if(IsMultiplyError(cBytesPerBlockSample, cBlockSamplesMax) ||
+         nullptr == pThreadPool->GetScratch(cBytesPerBlockSample * cBlockSamplesMax)) {
+         LOG_0(Trace_Warning, "WARNING ScoringModel::Create out of memory allocating the scratch space");
+         ThreadPool::Free(pThreadPool);
+         return Error_OutOfMemory;
+      }
+   }
+
+   unsigned char * const pArena = static_cast<unsigned char *>(AlignedAlloc(cBytesArena));
+   if(nullptr == pArena) {
+      LOG_0(Trace_Warning, "WARNING ScoringModel::Create nullptr == pArena");
+      ThreadPool::Free(pThreadPool);
+      return Error_OutOfMemory;
+   }
+
+   // second pass: fill the arena
+
+   ScoringBinning * const aBinnings = reinterpret_cast<ScoringBinning *>(pArena + iByteBinnings);
+   ScoringTerm * const aTerms = reinterpret_cast<ScoringTerm *>(pArena + iByteTerms);
+   size_t * const aiBinningsAll = reinterpret_cast<size_t *>(pArena + iByteBinningIndexes);
+   size_t * const acStridesAll = reinterpret_cast<size_t *>(pArena + iByteStrides);
+   double * const aIntercept = reinterpret_cast<double *>(pArena + iByteIntercept);
+   double * const aValuesCopy = reinterpret_cast<double *>(pArena + iByteValues);
+   IntEbm * const aCategoryBinsCopy = reinterpret_cast<IntEbm *>(pArena + iByteCategoryBins);
+   double * const aEytzingerAll = reinterpret_cast<double *>(pArena + iByteEytzinger);
+   double * const aTensorsCopy = reinterpret_cast<double *>(pArena + iByteTensors);
+
+   if(size_t { 0 } != cValuesCopy) {
+      memcpy(aValuesCopy, binningValues, sizeof(*aValuesCopy) * cValuesCopy);
+   }
+   if(size_t { 0 } != cTensorScoresCopy) {
+      memcpy(aTensorsCopy, termScores, sizeof(*aTensorsCopy) * cTensorScoresCopy);
+   }
+   // binningValues can only be nullptr if there are no values, but Discretize needs a non-null pointer even then
+   const double * const aValuesAll = bView && nullptr != binningValues ? binningValues : aValuesCopy;
+   const double * const aTensorsAll = bView ? termScores : aTensorsCopy;
+
+   size_t iValue = 0;
+   size_t iEytzinger = 0;
+   for(size_t iBinning = 0; iBinning < cBinnings; ++iBinning) {
+      ScoringBinning * const pBinning = &aBinnings[iBinning];
+      const size_t cValues = static_cast<size_t>(binningCountValues[iBinning]);
+      pBinning->m_iFeature = static_cast<size_t>(binningFeatureIndexes[iBinning]);
+      pBinning->m_cBins = static_cast<size_t>(binningCountBins[iBinning]);
+      pBinning->m_cValues = cValues;
+      pBinning->m_aValues = &aValuesAll[iValue];
+      pBinning->m_aCategoryBins = nullptr;
+      pBinning->m_cEytzingerLevels = 0;
+      pBinning->m_aEytzinger = nullptr;
+      if(EBM_FALSE != binningIsCategorical[iBinning]) {
+         if(bView) {
+            pBinning->m_aCategoryBins = &binningCategoryBins[iValue];
+         } else {
+            if(size_t { 0 } != cValues) {
+               memcpy(&aCategoryBinsCopy[iValue], &binningCategoryBins[iValue], sizeof(*aCategoryBinsCopy) * cValues);
+            }
+            pBinning->m_aCategoryBins = &aCategoryBinsCopy[iValue];
+         }
+      } else if(IsEytzingerCuts(cValues) && (!bView || cValues <= cSamplesView)) {
+         const size_t cLevels = GetEytzingerLevels(cValues);
+         BuildEytzingerCuts(cValues, &aValuesAll[iValue], cLevels, &aEytzingerAll[iEytzinger]);
+         pBinning->m_cEytzingerLevels = cLevels;
+         pBinning->m_aEytzinger = &aEytzingerAll[iEytzinger];
+         iEytzinger += size_t { 1 } << cLevels;
+      }
+      iValue += cValues;
+   }
+
+   // the terms keep the caller's order so that the scores are summed in the same order as the python predictor,
+   // which makes our results identical to it rather than just close
+   size_t iDimensionAll = 0;
+   size_t iTensorScore = 0;
+   for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+      ScoringTerm * const pTerm = &aTerms[iTerm];
+      const size_t cDimensions = static_cast<size_t>(termDimensionCounts[iTerm]);
+      size_t * const aiBinnings = &aiBinningsAll[iDimensionAll];
+      size_t * const acStrides = &acStridesAll[iDimensionAll];
+
+      // tensors are C ordered, so the last dimension has the smallest stride
+      size_t cStride = cScores;
+      size_t iDimension = cDimensions;
+      while(size_t { 0 } != iDimension) {
+         --iDimension;
+         const size_t iBinning = static_cast<size_t>(termBinningIndexes[iDimensionAll + iDimension]);
+         aiBinnings[iDimension] = iBinning;
+         acStrides[iDimension] = cStride;
+         cStride *= aBinnings[iBinning].m_cBins;
+      }
+
+      pTerm->m_cDimensions = cDimensions;
+      pTerm->m_aiBinnings = aiBinnings;
+      pTerm->m_acStrides = acStrides;
+      pTerm->m_aScores = nullptr == aTensorsAll ? nullptr : &aTensorsAll[iTensorScore];
+
+      iDimensionAll += cDimensions;
+      iTensorScore += cStride;
+   }
+
+   EBM_ASSERT(cTensorScoresTotal == iTensorScore);
+
+   for(size_t iScore = 0; iScore < cScores; ++iScore) {
+      aIntercept[iScore] = nullptr == intercept ? 0.0 : intercept[iScore];
+   }
+
+   ScoringModel * const pScoringModel = reinterpret_cast<ScoringModel *>(pArena);
+   pScoringModel->m_handleVerification = k_handleVerificationOk;
+   pScoringModel->m_cFeaturesMin = cFeaturesMin;
+   pScoringModel->m_cBinnings = cBinnings;
+   pScoringModel->m_aBinnings = aBinnings;
+   pScoringModel->m_cTerms = cTerms;
+   pScoringModel->m_aTerms = aTerms;
+   pScoringModel->m_cScores = cScores;
+   pScoringModel->m_aIntercept = aIntercept;
+   pScoringModel->m_pThreadPool = pThreadPool;
+   pScoringModel->m_cBytesArena = cBytesArena;
+
+   *ppScoringModelOut = pScoringModel;
+
+   LOG_0(Trace_Info, "Exited ScoringModel::Create");
+   return Error_None;
+}
+
+ErrorEbm ScoringModel::Score(
+   const size_t cSamples,
+   const size_t cFeatures,
+   const bool bFortranOrdered,
+   const double * const aFeatureMatrix,
+   const LinkEbm link,
+   double * const aScoresOut
+) const {
+   EBM_ASSERT(IsLinkSupported(link, m_cScores));
+   EBM_ASSERT(m_cFeaturesMin <= cFeatures);
+   EBM_ASSERT(size_t { 0 } == cSamples || size_t { 0 } == m_cBinnings || nullptr != aFeatureMatrix);
+
+   if(size_t { 0 } == cSamples || size_t { 0 } == m_cScores) {
+      return Error_None;
+   }
+   EBM_ASSERT(nullptr != aScoresOut);
+
+   const size_t cBytesPerBlockSample = GetBytesPerBlockSample(m_cBinnings);
+   const size_t cBlockSamples = EbmMin(cSamples, GetBlockSamplesMax(cBytesPerBlockSample));
+   const size_t cBlocks = (cSamples - size_t { 1 }) / cBlockSamples + size_t { 1 };
+
+   if(IsMultiplyError(cBytesPerBlockSample, cBlockSamples)) {
+      LOG_0(Trace_Warning, "WARNING ScoringModel::Score IsMultiplyError(cBytesPerBlockSample, cBlockSamples)");
+      return Error_OutOfMemory;
+   }
+   const size_t cBytesScratchPerThread = cBytesPerBlockSample * cBlockSamples;
+
+   ThreadPool * pThreadPool = nullptr;
+   ErrorEbm error = nullptr == m_pThreadPool ? ThreadPool::BorrowShared(&pThreadPool) :
+      ThreadPool::Borrow(m_pThreadPool, &pThreadPool);
+   if(Error_None != error) {
+      return error;
+   }
+
+   // our own pool already holds enough scratch for the largest block, so this only allocates on the shared pool
+   // or on the single threaded pool that we get when another caller is using the pool
+   unsigned char * const aScratch = pThreadPool->GetScratch(cBytesScratchPerThread);
+   if(nullptr == aScratch) {
+      ThreadPool::GiveBack(pThreadPool);
+      return Error_OutOfMemory;
+   }
+
+   ScoringContext context;
+   context.m_pScoringModel = this;
+   context.m_aBinnings = m_aBinnings;
+   context.m_cBinnings = m_cBinnings;
+   context.m_aTerms = m_aTerms;
+   context.m_cTerms = m_cTerms;
+   context.m_cScores = m_cScores;
+   context.m_aIntercept = m_aIntercept;
+   context.m_cSamples = cSamples;
+   context.m_cFeatures = cFeatures;
+   context.m_bFortranOrdered = bFortranOrdered;
+   context.m_aFeatureMatrix = aFeatureMatrix;
+   context.m_link = link;
+   context.m_aScoresOut = aScoresOut;
+   context.m_cBlockSamples = cBlockSamples;
+   context.m_cBytesScratchPerThread = cBytesScratchPerThread;
+   context.m_aScratch = aScratch;
+
+   error = pThreadPool->Run(cBlocks, ScoreBlock, &context);
+
+   ThreadPool::GiveBack(pThreadPool);
+
+   return error;
+}
+
+// checks the arguments that are shared by PredictScores and PredictScoresWithModel
+static ErrorEbm CheckScoringArgs(
+   const char * const sFunction,
+   const IntEbm countSamples,
+   const IntEbm countFeatures,
+   const size_t cFeaturesMin,
+   const double * const featureMatrix,
+   const size_t cScores,
+   const LinkEbm link,
+   double * const scoresOut
+) {
+   if(countSamples < IntEbm { 0 } || IsConvertError<size_t>(countSamples)) {
+      LOG_N(Trace_Error, "ERROR %s countSamples must be a non-negative size_t", sFunction);
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   if(countFeatures < IntEbm { 0 } || IsConvertError<size_t>(countFeatures)) {
+      LOG_N(Trace_Error, "ERROR %s countFeatures must be a non-negative size_t", sFunction);
+      return Error_IllegalParamVal;
+   }
+   const size_t cFeatures = static_cast<size_t>(countFeatures);
+   if(cFeatures < cFeaturesMin) {
+      LOG_N(Trace_Error, "ERROR %s the model uses more features than countFeatures", sFunction);
+      return Error_IllegalParamVal;
+   }
+
+   if(!ScoringModel::IsLinkSupported(link, cScores)) {
+      LOG_N(Trace_Error, "ERROR %s link is not supported for this number of scores", sFunction);
+      return Error_IllegalParamVal;
+   }
+
+   if(size_t { 0 } == cSamples) {
+      return Error_None;
+   }
+
+   if(size_t { 0 } != cFeaturesMin) {
+      if(IsMultiplyError(sizeof(*featureMatrix), cSamples, cFeatures)) {
+         LOG_N(Trace_Error, "ERROR %s IsMultiplyError(sizeof(*featureMatrix), cSamples, cFeatures)", sFunction);
+         return Error_IllegalParamVal;
+      }
+      if(nullptr == featureMatrix) {
+         LOG_N(Trace_Error, "ERROR %s featureMatrix cannot be nullptr", sFunction);
+         return Error_IllegalParamVal;
+      }
+   }
+
+   if(size_t { 0 } != cScores) {
+      if(IsMultiplyError(sizeof(*scoresOut), cSamples, cScores)) {
+         LOG_N(Trace_Error, "ERROR %s IsMultiplyError(sizeof(*scoresOut), cSamples, cScores)", sFunction);
+         return Error_IllegalParamVal;
+      }
+      if(nullptr == scoresOut) {
+         LOG_N(Trace_Error, "ERROR %s scoresOut cannot be nullptr", sFunction);
+         return Error_IllegalParamVal;
+      }
+   }
+
+   return Error_None;
+}
+
+static ErrorEbm CheckModelCounts(
+   const char * const sFunction,
+   const IntEbm countBinnings,
+   const IntEbm countTerms,
+   const IntEbm countScores
+) {
+   if(countBinnings < IntEbm { 0 } || IsConvertError<size_t>(countBinnings)) {
+      LOG_N(Trace_Error, "ERROR %s countBinnings must be a non-negative size_t", sFunction);
+      return Error_IllegalParamVal;
+   }
+   if(countTerms < IntEbm { 0 } || IsConvertError<size_t>(countTerms)) {
+      LOG_N(Trace_Error, "ERROR %s countTerms must be a non-negative size_t", sFunction);
+      return Error_IllegalParamVal;
+   }
+   if(countScores < IntEbm { 0 } || IsConvertError<size_t>(countScores)) {
+      LOG_N(Trace_Error, "ERROR %s countScores must be a non-negative size_t", sFunction);
+      return Error_IllegalParamVal;
+   }
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION PredictScores(
+   IntEbm countSamples,
+   IntEbm countFeatures,
+   BoolEbm isFortranOrdered,
+   const double * featureMatrix,
+   IntEbm countBinnings,
+   const IntEbm * binningFeatureIndexes,
+   const BoolEbm * binningIsCategorical,
+   const IntEbm * binningCountBins,
+   const IntEbm * binningCountValues,
+   const double * binningValues,
+   const IntEbm * binningCategoryBins,
+   IntEbm countTerms,
+   const IntEbm * termDimensionCounts,
+   const IntEbm * termBinningIndexes,
+   IntEbm countScores,
+   const double * termScores,
+   const double * intercept,
+   LinkEbm link,
+   double * scoresOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered PredictScores: "
+      "countSamples=%" IntEbmPrintf ", "
+      "countFeatures=%" IntEbmPrintf ", "
+      "isFortranOrdered=%s, "
+      "featureMatrix=%p, "
+      "countBinnings=%" IntEbmPrintf ", "
+      "binningFeatureIndexes=%p, "
+      "binningIsCategorical=%p, "
+      "binningCountBins=%p, "
+      "binningCountValues=%p, "
+      "binningValues=%p, "
+      "binningCategoryBins=%p, "
+      "countTerms=%" IntEbmPrintf ", "
+      "termDimensionCounts=%p, "
+      "termBinningIndexes=%p, "
+      "countScores=%" IntEbmPrintf ", "
+      "termScores=%p, "
+      "intercept=%p, "
+      "link=%" LinkEbmPrintf ", "
+      "scoresOut=%p"
+      ,
+      countSamples,
+      countFeatures,
+      ObtainTruth(isFortranOrdered),
+      static_cast<const void *>(featureMatrix),
+      countBinnings,
+      static_cast<const void *>(binningFeatureIndexes),
+      static_cast<const void *>(binningIsCategorical),
+      static_cast<const void *>(binningCountBins),
+      static_cast<const void *>(binningCountValues),
+      static_cast<const void *>(binningValues),
+      static_cast<const void *>(binningCategoryBins),
+      countTerms,
+      static_cast<const void *>(termDimensionCounts),
+      static_cast<const void *>(termBinningIndexes),
+      countScores,
+      static_cast<const void *>(termScores),
+      static_cast<const void *>(intercept),
+      link,
+      static_cast<void *>(scoresOut)
+   );
+
+   ErrorEbm error;
+
+   error = CheckModelCounts("PredictScores", countBinnings, countTerms, countScores);
+   if(Error_None != error) {
+      return error;
+   }
+
+   // a view only holds the binning and term metadata, so this does not copy the cuts or tensors, and it scores on
+   // the library wide pool.  An illegal countSamples is rejected by CheckScoringArgs below
+   const size_t cSamplesView = countSamples < IntEbm { 0 } || IsConvertError<size_t>(countSamples) ? size_t { 0 } :
+      static_cast<size_t>(countSamples);
+   ScoringModel * pScoringModel = nullptr;
+   error = ScoringModel::Create(
+      true,
+      cSamplesView,
+      static_cast<size_t>(countBinnings),
+      binningFeatureIndexes,
+      binningIsCategorical,
+      binningCountBins,
+      binningCountValues,
+      binningValues,
+      binningCategoryBins,
+      static_cast<size_t>(countTerms),
+      termDimensionCounts,
+      termBinningIndexes,
+      static_cast<size_t>(countScores),
+      termScores,
+      intercept,
+      &pScoringModel
+   );
+   if(Error_None != error) {
+      return error;
+   }
+
+   error = CheckScoringArgs(
+      "PredictScores",
+      countSamples,
+      countFeatures,
+      pScoringModel->GetCountFeaturesMin(),
+      featureMatrix,
+      static_cast<size_t>(countScores),
+      link,
+      scoresOut
+   );
+   if(Error_None == error) {
+      error = pScoringModel->Score(
+         static_cast<size_t>(countSamples),
+         static_cast<size_t>(countFeatures),
+         EBM_FALSE != isFortranOrdered,
+         featureMatrix,
+         link,
+         scoresOut
+      );
+   }
+
+   ScoringModel::Free(pScoringModel);
+
+   LOG_N(Trace_Info, "Exited PredictScores: error=%" ErrorEbmPrintf, error);
+   return error;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateScoringModel(
+   IntEbm countBinnings,
+   const IntEbm * binningFeatureIndexes,
+   const BoolEbm * binningIsCategorical,
+   const IntEbm * binningCountBins,
+   const IntEbm * binningCountValues,
+   const double * binningValues,
+   const IntEbm * binningCategoryBins,
+   IntEbm countTerms,
+   const IntEbm * termDimensionCounts,
+   const IntEbm * termBinningIndexes,
+   IntEbm countScores,
+   const double * termScores,
+   const double * intercept,
+   ScoringModelHandle * scoringModelHandleOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered CreateScoringModel: "
+      "countBinnings=%" IntEbmPrintf ", "
+      "binningFeatureIndexes=%p, "
+      "binningIsCategorical=%p, "
+      "binningCountBins=%p, "
+      "binningCountValues=%p, "
+      "binningValues=%p, "
+      "binningCategoryBins=%p, "
+      "countTerms=%" IntEbmPrintf ", "
+      "termDimensionCounts=%p, "
+      "termBinningIndexes=%p, "
+      "countScores=%" IntEbmPrintf ", "
+      "termScores=%p, "
+      "intercept=%p, "
+      "scoringModelHandleOut=%p"
+      ,
+      countBinnings,
+      static_cast<const void *>(binningFeatureIndexes),
+      static_cast<const void *>(binningIsCategorical),
+      static_cast<const void *>(binningCountBins),
+      static_cast<const void *>(binningCountValues),
+      static_cast<const void *>(binningValues),
+      static_cast<const void *>(binningCategoryBins),
+      countTerms,
+      static_cast<const void *>(termDimensionCounts),
+      static_cast<const void *>(termBinningIndexes),
+      countScores,
+      static_cast<const void *>(termScores),
+      static_cast<const void *>(intercept),
+      static_cast<void *>(scoringModelHandleOut)
+   );
+
+   if(nullptr == scoringModelHandleOut) {
+      LOG_0(Trace_Error, "ERROR CreateScoringModel nullptr == scoringModelHandleOut");
+      return Error_IllegalParamVal;
+   }
+   *scoringModelHandleOut = nullptr; // set this to nullptr as soon as possible so the caller doesn't attempt to free it
+
+   ErrorEbm error;
+
+   error = CheckModelCounts("CreateScoringModel", countBinnings, countTerms, countScores);
+   if(Error_None != error) {
+      return error;
+   }
+
+   ScoringModel * pScoringModel = nullptr;
+   error = ScoringModel::Create(
+      false,
+      0,
+      static_cast<size_t>(countBinnings),
+      binningFeatureIndexes,
+      binningIsCategorical,
+      binningCountBins,
+      binningCountValues,
+      binningValues,
+      binningCategoryBins,
+      static_cast<size_t>(countTerms),
+      termDimensionCounts,
+      termBinningIndexes,
+      static_cast<size_t>(countScores),
+      termScores,
+      intercept,
+      &pScoringModel
+   );
+   if(Error_None != error) {
+      return error;
+   }
+
+   const ScoringModelHandle handle = pScoringModel->GetHandle();
+   *scoringModelHandleOut = handle;
+
+   LOG_N(Trace_Info, "Exited CreateScoringModel: *scoringModelHandleOut=%p", static_cast<void *>(handle));
+   return Error_None;
+}
+
+EBM_API_BODY void EBM_CALLING_CONVENTION FreeScoringModel(ScoringModelHandle scoringModelHandle) {
+   LOG_N(Trace_Info, "Entered FreeScoringModel: scoringModelHandle=%p", static_cast<void *>(scoringModelHandle));
+
+   ScoringModel * const pScoringModel = ScoringModel::GetScoringModelFromHandle(scoringModelHandle);
+   // if the handle is invalid GetScoringModelFromHandle already logged it and returns nullptr, which Free ignores
+   ScoringModel::Free(pScoringModel);
+
+   LOG_0(Trace_Info, "Exited FreeScoringModel");
+}
+
+// don't bother using a lock here.  We don't care if an extra log message is written out due to thread parallism
+static int g_cLogEnterPredictScoresWithModel = 25;
+static int g_cLogExitPredictScoresWithModel = 25;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION PredictScoresWithModel(
+   ScoringModelHandle scoringModelHandle,
+   IntEbm countSamples,
+   IntEbm countFeatures,
+   BoolEbm isFortranOrdered,
+   const double * featureMatrix,
+   LinkEbm link,
+   double * scoresOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogEnterPredictScoresWithModel,
+      Trace_Info,
+      Trace_Verbose,
+      "Entered PredictScoresWithModel: "
+      "scoringModelHandle=%p, "
+      "countSamples=%" IntEbmPrintf ", "
+      "countFeatures=%" IntEbmPrintf ", "
+      "isFortranOrdered=%s, "
+      "featureMatrix=%p, "
+      "link=%" LinkEbmPrintf ", "
+      "scoresOut=%p"
+      ,
+      static_cast<void *>(scoringModelHandle),
+      countSamples,
+      countFeatures,
+      ObtainTruth(isFortranOrdered),
+      static_cast<const void *>(featureMatrix),
+      link,
+      static_cast<void *>(scoresOut)
+   );
+
+   const ScoringModel * const pScoringModel = ScoringModel::GetScoringModelFromHandle(scoringModelHandle);
+   if(nullptr == pScoringModel) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   ErrorEbm error = CheckScoringArgs(
+      "PredictScoresWithModel",
+      countSamples,
+      countFeatures,
+      pScoringModel->GetCountFeaturesMin(),
+      featureMatrix,
+      pScoringModel->GetCountScores(),
+      link,
+      scoresOut
+   );
+   if(Error_None == error) {
+      error = pScoringModel->Score(
+         static_cast<size_t>(countSamples),
+         static_cast<size_t>(countFeatures),
+         EBM_FALSE != isFortranOrdered,
+         featureMatrix,
+         link,
+         scoresOut
+      );
+   }
+
+   LOG_COUNTED_N(
+      &g_cLogExitPredictScoresWithModel,
+      Trace_Info,
+      Trace_Verbose,
+      "Exited PredictScoresWithModel: error=%" ErrorEbmPrintf,
+      error
+   );
+   return error;
+}
+
+} // DEFINED_ZONE_NAME
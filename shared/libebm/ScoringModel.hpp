@@ -0,0 +1,155 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef SCORING_MODEL_HPP
+#define SCORING_MODEL_HPP
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "libebm.h" // ErrorEbm
+#include "logging.h" // EBM_ASSERT
+#include "unzoned.h"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+struct ScoringBinning final {
+   size_t m_iFeature;
+   size_t m_cBins;
+   size_t m_cValues;
+   const double * m_aValues;
+   // nullptr for continuous binnings
+   const IntEbm * m_aCategoryBins;
+   // continuous binnings with many cuts also hold them in the Eytzinger layout from BuildEytzingerCuts.  Zero and
+   // nullptr otherwise
+   size_t m_cEytzingerLevels;
+   const double * m_aEytzinger;
+};
+static_assert(std::is_standard_layout<ScoringBinning>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ScoringBinning>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+struct ScoringTerm final {
+   size_t m_cDimensions;
+   const size_t * m_aiBinnings;
+   // the distance in doubles between neighbouring bins of each dimension, already multiplied by the score count
+   const size_t * m_acStrides;
+   const double * m_aScores;
+};
+static_assert(std::is_standard_layout<ScoringTerm>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ScoringTerm>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+class ThreadPool;
+
+// ScoringModel holds everything needed for prediction in a single cache aligned arena.  The ScoringModel object
+// itself is at the start of the arena and all the pointers inside it point into the rest of the arena.  Once
+// created the model itself is never modified, so any number of threads can score with it at the same time.  A
+// reusable model also owns a thread pool and its scratch memory, which are created once in Create.  One caller
+// at a time runs on that pool and callers that arrive while it is busy score on their own thread.
+class ScoringModel final {
+   static constexpr size_t k_handleVerificationOk = 18541; // random 15 bit number
+   static constexpr size_t k_handleVerificationFreed = 6293; // random 15 bit number
+   size_t m_handleVerification; // this needs to be at the top and make it pointer sized to keep best alignment
+
+   // the feature matrix needs at least this many features to hold every feature that we bin
+   size_t m_cFeaturesMin;
+
+   size_t m_cBinnings;
+   const ScoringBinning * m_aBinnings;
+
+   size_t m_cTerms;
+   const ScoringTerm * m_aTerms;
+
+   size_t m_cScores;
+   const double * m_aIntercept;
+
+   // nullptr for views, which score on the library wide pool
+   ThreadPool * m_pThreadPool;
+
+   size_t m_cBytesArena;
+
+public:
+
+   ScoringModel() = default; // preserve our POD status
+   ~ScoringModel() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   static void Free(ScoringModel * const pScoringModel);
+
+   // A view points at the caller's cuts, categories and tensors instead of copying them, and has no threads of its
+   // own, so it is cheap enough to build for a single PredictScores call.  The caller's arrays must outlive it.
+   // cSamplesView is the number of samples the view will score, which decides if building Eytzinger cuts pays off.
+   static ErrorEbm Create(
+      const bool bView,
+      const size_t cSamplesView,
+      const size_t cBinnings,
+      const IntEbm * const binningFeatureIndexes,
+      const BoolEbm * const binningIsCategorical,
+      const IntEbm * const binningCountBins,
+      const IntEbm * const binningCountValues,
+      const double * const binningValues,
+      const IntEbm * const binningCategoryBins,
+      const size_t cTerms,
+      const IntEbm * const termDimensionCounts,
+      const IntEbm * const termBinningIndexes,
+      const size_t cScores,
+      const double * const termScores,
+      const double * const intercept,
+      ScoringModel ** const ppScoringModelOut
+   );
+
+   // the caller has already checked that the link can be applied to m_cScores scores with IsLinkSupported
+   ErrorEbm Score(
+      const size_t cSamples,
+      const size_t cFeatures,
+      const bool bFortranOrdered,
+      const double * const aFeatureMatrix,
+      const LinkEbm link,
+      double * const aScoresOut
+   ) const;
+
+   static bool IsLinkSupported(const LinkEbm link, const size_t cScores);
+
+   INLINE_ALWAYS static ScoringModel * GetScoringModelFromHandle(const ScoringModelHandle scoringModelHandle) {
+      if(nullptr == scoringModelHandle) {
+         LOG_0(Trace_Error, "ERROR GetScoringModelFromHandle null scoringModelHandle");
+         return nullptr;
+      }
+      ScoringModel * const pScoringModel = reinterpret_cast<ScoringModel *>(scoringModelHandle);
+      if(k_handleVerificationOk == pScoringModel->m_handleVerification) {
+         return pScoringModel;
+      }
+      if(k_handleVerificationFreed == pScoringModel->m_handleVerification) {
+         LOG_0(Trace_Error, "ERROR GetScoringModelFromHandle attempt to use freed ScoringModelHandle");
+      } else {
+         LOG_0(Trace_Error, "ERROR GetScoringModelFromHandle attempt to use invalid ScoringModelHandle");
+      }
+      return nullptr;
+   }
+   INLINE_ALWAYS ScoringModelHandle GetHandle() {
+      return reinterpret_cast<ScoringModelHandle>(this);
+   }
+
+   INLINE_ALWAYS size_t GetCountFeaturesMin() const {
+      return m_cFeaturesMin;
+   }
+
+   INLINE_ALWAYS size_t GetCountScores() const {
+      return m_cScores;
+   }
+};
+static_assert(std::is_standard_layout<ScoringModel>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ScoringModel>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+} // DEFINED_ZONE_NAME
+
+#endif // SCORING_MODEL_HPP
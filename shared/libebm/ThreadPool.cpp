@@ -0,0 +1,321 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "pch.hpp"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <stdlib.h> // malloc, free
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "libebm.h" // EBM_API_BODY
+#include "logging.h" // EBM_ASSERT
+
+#define ZONE_main
+#include "zones.h"
+
+#include "common.hpp" // IsMultiplyError
+
+#include "ThreadPool.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// we default to a single thread so that callers which already parallelize at a higher level (like the python
+// joblib outer bags) do not get oversubscribed unless they explicitly ask for more threads
+static std::atomic<IntEbm> g_countThreads(IntEbm { 1 });
+
+EBM_API_BODY void EBM_CALLING_CONVENTION SetThreadCount(IntEbm countThreads) {
+   LOG_N(Trace_Info, "Entered SetThreadCount: countThreads=%" IntEbmPrintf, countThreads);
+   g_countThreads.store(countThreads, std::memory_order_relaxed);
+   LOG_0(Trace_Info, "Exited SetThreadCount");
+}
+
+size_t ThreadPool::GetCountThreadsConfig() {
+   const IntEbm countThreads = g_countThreads.load(std::memory_order_relaxed);
+   if(IntEbm { 0 } < countThreads) {
+      if(IsConvertError<size_t>(countThreads)) {
+         return std::numeric_limits<size_t>::max();
+      }
+      return static_cast<size_t>(countThreads);
+   }
+
+   // hardware_concurrency can return 0 if the value is not computable
+   const IntEbm countHardware = static_cast<IntEbm>(std::thread::hardware_concurrency());
+   // zero means use all hardware threads and negative numbers leave that many hardware threads unused
+   if(countHardware <= -countThreads) {
+      return 1;
+   }
+   return static_cast<size_t>(countHardware + countThreads);
+}
+
+ThreadPool::~ThreadPool() {
+   if(nullptr != m_aWorkers) {
+      {
+         std::lock_guard<std::mutex> lock(m_mutex);
+         m_bShutdown = true;
+      }
+      m_conditionWork.notify_all();
+
+      std::thread * pWorker = m_aWorkers;
+      const std::thread * const pWorkersEnd = m_aWorkers + (m_cThreads - 1);
+      do {
+         if(pWorker->joinable()) {
+            pWorker->join();
+         }
+         ++pWorker;
+      } while(pWorkersEnd != pWorker);
+
+      delete[] m_aWorkers;
+   }
+   free(m_aScratch);
+}
+
+void ThreadPool::Free(ThreadPool * const pThreadPool) {
+   LOG_0(Trace_Info, "Entered ThreadPool::Free");
+
+   // legal to call with nullptr, just like free()
+   delete pThreadPool;
+
+   LOG_0(Trace_Info, "Exited ThreadPool::Free");
+}
+
+ErrorEbm ThreadPool::Create(const size_t cThreads, ThreadPool ** const ppThreadPoolOut) {
+   LOG_0(Trace_Info, "Entered ThreadPool::Create");
+
+   EBM_ASSERT(1 <= cThreads);
+   EBM_ASSERT(nullptr != ppThreadPoolOut);
+   EBM_ASSERT(nullptr == *ppThreadPoolOut);
+
+   ThreadPool * pThreadPool;
+   try {
+      pThreadPool = new ThreadPool();
+   } catch(const std::bad_alloc &) {
+      LOG_0(Trace_Warning, "WARNING ThreadPool::Create Out of memory allocating ThreadPool");
+      return Error_OutOfMemory;
+   } catch(...) {
+      LOG_0(Trace_Warning, "WARNING ThreadPool::Create Unknown error");
+      return Error_UnexpectedInternal;
+   }
+   if(nullptr == pThreadPool) {
+      // this should be impossible since bad_alloc should have been thrown, but let's be untrusting
+      LOG_0(Trace_Warning, "WARNING ThreadPool::Create nullptr == pThreadPool");
+      return Error_OutOfMemory;
+   }
+
+   if(size_t { 1 } != cThreads) {
+      const size_t cWorkers = cThreads - 1;
+      try {
+         pThreadPool->m_aWorkers = new std::thread[cWorkers];
+      } catch(const std::bad_alloc &) {
+         LOG_0(Trace_Warning, "WARNING ThreadPool::Create Out of memory allocating workers");
+         delete pThreadPool;
+         return Error_OutOfMemory;
+      } catch(...) {
+         LOG_0(Trace_Warning, "WARNING ThreadPool::Create Unknown error allocating workers");
+         delete pThreadPool;
+         return Error_UnexpectedInternal;
+      }
+      // the destructor joins all workers in m_aWorkers, which is legal even for threads that were never started
+      pThreadPool->m_cThreads = cThreads;
+
+      size_t iWorker = 0;
+      do {
+         try {
+            pThreadPool->m_aWorkers[iWorker] = std::thread(&ThreadPool::WorkerLoop, pThreadPool, iWorker + 1);
+         } catch(const std::bad_alloc &) {
+            LOG_0(Trace_Warning, "WARNING ThreadPool::Create thread start out of memory");
+            delete pThreadPool;
+            return Error_OutOfMemory;
+         } catch(...) {
+            // the C++ standard doesn't really seem to say what kind of exceptions we'd get for various errors, so
+            // about the best we can do is catch(...) since the exact exceptions seem to be implementation specific
+            LOG_0(Trace_Warning, "WARNING ThreadPool::Create thread start failed");
+            delete pThreadPool;
+            return Error_ThreadStartFailed;
+         }
+         ++iWorker;
+      } while(cWorkers != iWorker);
+   }
+
+   *ppThreadPoolOut = pThreadPool;
+
+   LOG_0(Trace_Info, "Exited ThreadPool::Create");
+   return Error_None;
+}
+
+ErrorEbm ThreadPool::Borrow(ThreadPool * const pThreadPool, ThreadPool ** const ppThreadPoolOut) {
+   EBM_ASSERT(nullptr != pThreadPool);
+   EBM_ASSERT(nullptr != ppThreadPoolOut);
+   EBM_ASSERT(nullptr == *ppThreadPoolOut);
+
+   if(!pThreadPool->m_bLent.exchange(true, std::memory_order_acquire)) {
+      *ppThreadPoolOut = pThreadPool;
+      return Error_None;
+   }
+   // a single threaded pool starts no threads, so this costs one small allocation
+   return Create(1, ppThreadPoolOut);
+}
+
+// the library wide pool used by the APIs that have no handle to keep a pool in, like DiscretizeMatrix.  It is
+// replaced when a caller finds that SetThreadCount has changed the number of threads, but otherwise it is leaked
+// on purpose.  Freeing it from a static destructor would join the worker threads while the Windows loader lock is
+// held during DLL_PROCESS_DETACH, and exiting threads need that lock, so FreeLibrary or process exit could deadlock.
+// The idle workers are blocked waiting for work, and the OS reclaims them and the pool when the process ends
+static std::mutex g_mutexThreadPoolShared;
+static ThreadPool * g_pThreadPoolShared = nullptr;
+
+ErrorEbm ThreadPool::BorrowShared(ThreadPool ** const ppThreadPoolOut) {
+   EBM_ASSERT(nullptr != ppThreadPoolOut);
+   EBM_ASSERT(nullptr == *ppThreadPoolOut);
+
+   const size_t cThreads = GetCountThreadsConfig();
+   {
+      std::lock_guard<std::mutex> lock(g_mutexThreadPoolShared);
+      ThreadPool * pThreadPool = g_pThreadPoolShared;
+      if(nullptr != pThreadPool) {
+         if(pThreadPool->m_bLent.exchange(true, std::memory_order_acquire)) {
+            // another caller is running on the shared pool
+            return Create(1, ppThreadPoolOut);
+         }
+         if(cThreads == pThreadPool->m_cThreads) {
+            *ppThreadPoolOut = pThreadPool;
+            return Error_None;
+         }
+         // we hold the pool, so nobody else can be using it while we replace it
+         g_pThreadPoolShared = nullptr;
+         Free(pThreadPool);
+      }
+
+      pThreadPool = nullptr;
+      const ErrorEbm error = Create(cThreads, &pThreadPool);
+      if(Error_None != error) {
+         return error;
+      }
+      pThreadPool->m_bLent.store(true, std::memory_order_relaxed);
+      g_pThreadPoolShared = pThreadPool;
+      *ppThreadPoolOut = pThreadPool;
+   }
+   return Error_None;
+}
+
+void ThreadPool::GiveBack(ThreadPool * const pThreadPool) {
+   if(nullptr != pThreadPool) {
+      if(pThreadPool->m_bLent.load(std::memory_order_relaxed)) {
+         pThreadPool->m_bLent.store(false, std::memory_order_release);
+      } else {
+         // a single threaded pool that was created because the lent pool was busy
+         Free(pThreadPool);
+      }
+   }
+}
+
+unsigned char * ThreadPool::GetScratch(const size_t cBytesPerThread) {
+   if(m_cBytesScratchPerThread < cBytesPerThread || nullptr == m_aScratch) {
+      if(IsMultiplyError(cBytesPerThread, m_cThreads)) {
+         LOG_0(Trace_Warning, "WARNING ThreadPool::GetScratch IsMultiplyError(cBytesPerThread, m_cThreads)");
+         return nullptr;
+      }
+      free(m_aScratch);
+      m_cBytesScratchPerThread = 0;
+      // malloc(0) is allowed to return nullptr, so always ask for at least 1 byte
+      m_aScratch = static_cast<unsigned char *>(malloc(EbmMax(size_t { 1 }, cBytesPerThread * m_cThreads)));
+      if(nullptr == m_aScratch) {
+         LOG_0(Trace_Warning, "WARNING ThreadPool::GetScratch nullptr == m_aScratch");
+         return nullptr;
+      }
+      m_cBytesScratchPerThread = cBytesPerThread;
+   }
+   return m_aScratch;
+}
+
+void ThreadPool::ExecuteTasks(const size_t iThread) {
+   const ThreadPoolTaskFunction pTaskFunction = m_pTaskFunction;
+   void * const pContext = m_pContext;
+   const size_t cTasks = m_cTasks;
+   while(true) {
+      if(Error_None != m_error.load(std::memory_order_relaxed)) {
+         return;
+      }
+      const size_t iTask = m_iTaskNext.fetch_add(1, std::memory_order_relaxed);
+      if(cTasks <= iTask) {
+         return;
+      }
+      const ErrorEbm error = (*pTaskFunction)(pContext, iTask, iThread);
+      if(Error_None != error) {
+         ErrorEbm expected = Error_None;
+         m_error.compare_exchange_strong(expected, error, std::memory_order_relaxed);
+      }
+   }
+}
+
+void ThreadPool::WorkerLoop(const size_t iThread) {
+   size_t generation = 0;
+   std::unique_lock<std::mutex> lock(m_mutex);
+   while(true) {
+      while(!m_bShutdown && generation == m_generation) {
+         m_conditionWork.wait(lock);
+      }
+      if(m_bShutdown) {
+         return;
+      }
+      generation = m_generation;
+
+      lock.unlock();
+      ExecuteTasks(iThread);
+      lock.lock();
+
+      EBM_ASSERT(1 <= m_cWorkersBusy);
+      --m_cWorkersBusy;
+      if(size_t { 0 } == m_cWorkersBusy) {
+         m_conditionDone.notify_one();
+      }
+   }
+}
+
+ErrorEbm ThreadPool::Run(const size_t cTasks, const ThreadPoolTaskFunction pTaskFunction, void * const pContext) {
+   EBM_ASSERT(nullptr != pTaskFunction);
+
+   if(size_t { 1 } == m_cThreads || cTasks <= size_t { 1 }) {
+      // no need to wake the workers.  Run everything on the calling thread in task order
+      for(size_t iTask = 0; iTask < cTasks; ++iTask) {
+         const ErrorEbm error = (*pTaskFunction)(pContext, iTask, 0);
+         if(Error_None != error) {
+            return error;
+         }
+      }
+      return Error_None;
+   }
+
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      EBM_ASSERT(size_t { 0 } == m_cWorkersBusy);
+      m_pTaskFunction = pTaskFunction;
+      m_pContext = pContext;
+      m_cTasks = cTasks;
+      m_iTaskNext.store(0, std::memory_order_relaxed);
+      m_error.store(Error_None, std::memory_order_relaxed);
+      m_cWorkersBusy = m_cThreads - 1;
+      ++m_generation;
+   }
+   m_conditionWork.notify_all();
+
+   ExecuteTasks(0);
+
+   {
+      // acquiring the mutex after the workers have released it also makes their writes visible to us
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while(size_t { 0 } != m_cWorkersBusy) {
+         m_conditionDone.wait(lock);
+      }
+   }
+
+   return m_error.load(std::memory_order_relaxed);
+}
+
+} // DEFINED_ZONE_NAME
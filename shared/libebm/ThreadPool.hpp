@@ -0,0 +1,114 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "libebm.h" // ErrorEbm
+#include "logging.h" // EBM_ASSERT
+#include "unzoned.h"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// Task functions are called with the index of the task and the index of the thread executing it.  The thread index
+// is in the range [0, GetCountThreads()) with the calling thread always being index 0, so callers can use it to
+// select per-thread scratch memory.  Task functions must not throw.
+typedef ErrorEbm (*ThreadPoolTaskFunction)(void * const pContext, const size_t iTask, const size_t iThread);
+
+class ThreadPool final {
+   // ThreadPool owns std::thread, std::mutex, etc, so like BoosterCore it cannot be POD and is allocated with new
+
+   size_t m_cThreads;
+   std::thread * m_aWorkers;
+
+   std::mutex m_mutex;
+   std::condition_variable m_conditionWork;
+   std::condition_variable m_conditionDone;
+
+   // these are written by Run while holding m_mutex, before m_generation is incremented
+   size_t m_generation;
+   bool m_bShutdown;
+   size_t m_cWorkersBusy;
+   ThreadPoolTaskFunction m_pTaskFunction;
+   void * m_pContext;
+   size_t m_cTasks;
+
+   std::atomic_size_t m_iTaskNext;
+   std::atomic<ErrorEbm> m_error;
+
+   // set while a pool that outlives a single call is lent out through Borrow or BorrowShared
+   std::atomic<bool> m_bLent;
+
+   // per thread scratch memory that is kept between calls, see GetScratch
+   size_t m_cBytesScratchPerThread;
+   unsigned char * m_aScratch;
+
+   inline ThreadPool() noexcept :
+      m_cThreads(1),
+      m_aWorkers(nullptr),
+      m_generation(0),
+      m_bShutdown(false),
+      m_cWorkersBusy(0),
+      m_pTaskFunction(nullptr),
+      m_pContext(nullptr),
+      m_cTasks(0),
+      m_iTaskNext(0),
+      m_error(Error_None),
+      m_bLent(false),
+      m_cBytesScratchPerThread(0),
+      m_aScratch(nullptr) {
+   }
+
+   ~ThreadPool();
+
+   void ExecuteTasks(const size_t iThread);
+   void WorkerLoop(const size_t iThread);
+
+public:
+
+   static ErrorEbm Create(const size_t cThreads, ThreadPool ** const ppThreadPoolOut);
+   static void Free(ThreadPool * const pThreadPool);
+
+   // the number of threads in the library wide configuration set by SetThreadCount. Always 1 or more.
+   static size_t GetCountThreadsConfig();
+
+   inline size_t GetCountThreads() const {
+      return m_cThreads;
+   }
+
+   // Borrow lends out a pool that is kept for many calls, like the pool of a ScoringModel.  If another caller is
+   // already running on pThreadPool, a new single threaded pool is returned instead so that concurrent callers
+   // proceed on their own thread rather than waiting.  BorrowShared does the same with the library wide pool,
+   // which is created on first use and recreated when SetThreadCount changes the number of threads.  Either way
+   // the pool must be handed back with GiveBack.
+   static ErrorEbm Borrow(ThreadPool * const pThreadPool, ThreadPool ** const ppThreadPoolOut);
+   static ErrorEbm BorrowShared(ThreadPool ** const ppThreadPoolOut);
+   static void GiveBack(ThreadPool * const pThreadPool);
+
+   // returns GetCountThreads() consecutive regions of cBytesPerThread bytes, one for each iThread.  The memory is
+   // kept with the pool and is only reallocated when a caller asks for more than before.  Returns nullptr on
+   // allocation failure.  The contents are not preserved between calls.
+   unsigned char * GetScratch(const size_t cBytesPerThread);
+
+   // Run executes the tasks [0, cTasks) and returns after all of them have completed.  The calling thread
+   // participates in the work.  Tasks are handed out dynamically, so the thread that executes any given task is
+   // not deterministic.  Callers that require deterministic results should therefore accumulate into memory
+   // indexed by iTask rather than iThread.  Run is not re-entrant and a ThreadPool must only be used by one
+   // caller at a time.  If any task fails, tasks that have not yet started are skipped and the first error
+   // encountered is returned.
+   ErrorEbm Run(const size_t cTasks, const ThreadPoolTaskFunction pTaskFunction, void * const pContext);
+};
+
+} // DEFINED_ZONE_NAME
+
+#endif // THREAD_POOL_HPP
@@ -6,6 +6,7 @@
 #define BRIDGE_C_H
 
 #include <stdlib.h> // free
+#include <stddef.h> // ptrdiff_t
 
 #include "libebm.h" // ErrorEbm, BoolEbm, etc..
 #include "logging.h"
@@ -25,6 +26,14 @@ typedef float FloatSmall;
 static_assert(sizeof(UIntSmall) < sizeof(UIntBig), "UIntBig must be able to contain UIntSmall");
 static_assert(sizeof(FloatSmall) < sizeof(FloatBig), "FloatBig must be able to contain FloatSmall");
 
+// the maximum number of inner bags that BinSumsBoosting can bin in a single pass over the data
+#define k_cBagsPerPassMax     (STATIC_CAST(size_t, 8))
+// the maximum number of partner features that BinSumsInteraction can pair with one anchor feature in a single pass
+#define k_cPartnersPerPassMax     (STATIC_CAST(size_t, 16))
+
+// m_iTargetConst holds this when the subset's samples can have different classes, so m_aTargets must be read
+#define k_iTargetPerSample     (STATIC_CAST(ptrdiff_t, -1))
+
 struct ApplyUpdateBridge {
    size_t m_cScores;
    int m_cPack;
@@ -38,6 +47,7 @@ struct ApplyUpdateBridge {
    size_t m_cSamples;
    const void * m_aPacked; // uint64_t or uint32_t
    const void * m_aTargets; // uint64_t or uint32_t or float or double
+   ptrdiff_t m_iTargetConst; // the class of every sample when the data is sorted by target, or k_iTargetPerSample
    const void * m_aWeights; // float or double
    void * m_aSampleScores; // float or double
    void * m_aGradientsAndHessians; // float or double
@@ -52,13 +62,25 @@ struct BinSumsBoostingBridge {
    int m_cPack;
 
    size_t m_cSamples;
-   const void * m_aGradientsAndHessians; // float or double
+   const void * m_aGradientsAndHessians; // float or double, or int8_t or int16_t if m_cQuantizedBytes is not 0
    const void * m_aWeights; // float or double
    const uint8_t * m_pCountOccurrences;
    const void * m_aPacked; // uint64_t or uint32_t
 
    void * m_aFastBins; // Bin<...> (can't use BinBase * since this is only C here)
 
+   // if m_cQuantizedBytes is 1 or 2, then the gradients and hessians are quantized to integers of that many bytes and
+   // are summed into int32_t fast bins laid out as [count, gradient, hessian, gradient, hessian, ...] for each bin.
+   // There are no weights in that case, only the occurrence counts, and m_cBags is 1
+   int m_cQuantizedBytes;
+
+   // if m_cBags is 2 or more, then that many inner bags are binned in one pass over the data and the weights,
+   // occurrences, and fast bins for each bag come from the arrays below instead of the single bag fields above
+   size_t m_cBags;
+   const void * m_aaBagWeights[k_cBagsPerPassMax]; // float or double
+   const uint8_t * m_apBagCountOccurrences[k_cBagsPerPassMax];
+   void * m_aaBagFastBins[k_cBagsPerPassMax]; // Bin<...>
+
 #ifndef NDEBUG
    const void * m_pDebugFastBinsEnd;
 #endif // NDEBUG
@@ -70,7 +92,7 @@ struct BinSumsInteractionBridge {
 
    size_t m_cSamples;
    const void * m_aGradientsAndHessians; // float or double
-   const void * m_aWeights; // float or double
+   const void * m_aWeights; // float or double, and the gradients and hessians are multiplied by these when binned
 
    size_t m_cRuntimeRealDimensions;
    size_t m_acBins[k_cDimensionsMax];
@@ -79,11 +101,31 @@ struct BinSumsInteractionBridge {
 
    void * m_aFastBins; // Bin<...> (can't use BinBase * since this is only C here)
 
+   // if m_cPartners is 1 or more, then the single dimension above is an anchor feature and the pair tensors of the
+   // anchor against that many partner features are binned in one pass over the data.  Partner i is the second
+   // dimension of its tensor, and its tensor goes into m_aaPartnerFastBins[i] instead of m_aFastBins
+   size_t m_cPartners;
+   size_t m_acPartnerBins[k_cPartnersPerPassMax];
+   int m_acPartnerItemsPerBitPack[k_cPartnersPerPassMax];
+   const void * m_aaPartnerPacked[k_cPartnersPerPassMax]; // uint64_t or uint32_t
+   void * m_aaPartnerFastBins[k_cPartnersPerPassMax]; // Bin<...>
+
 #ifndef NDEBUG
    const void * m_pDebugFastBinsEnd;
 #endif // NDEBUG
 };
 
+struct DiscretizeBridge {
+   size_t m_cSamples;
+   const double * m_aFeatureVals;
+   size_t m_cCuts; // 1 or more.  Zero cuts are handled before we get here
+   // zero if m_aCutsLowerBoundInclusive holds the sorted cuts.  Otherwise m_aCutsLowerBoundInclusive holds the cuts in
+   // the Eytzinger layout from BuildEytzingerCuts, with 2^m_cEytzingerLevels slots
+   size_t m_cEytzingerLevels;
+   const double * m_aCutsLowerBoundInclusive;
+   IntEbm * m_aBinIndexesOut;
+};
+
 struct ObjectiveWrapper;
 
 // these are extern "C" function pointers so we can't call anything other than an extern "C" function with them
@@ -171,6 +213,13 @@ INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Cpu_64(
    ObjectiveWrapper * const pObjectiveWrapperOut
 );
 
+INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Cpu_32(
+   const Config * const pConfig,
+   const char * const sObjective,
+   const char * const sObjectiveEnd,
+   ObjectiveWrapper * const pObjectiveWrapperOut
+);
+
 INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Avx512f_32(
    const Config * const pConfig,
    const char * const sObjective,
@@ -178,6 +227,13 @@ INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Avx512f_32(
    ObjectiveWrapper * const pObjectiveWrapperOut
 );
 
+INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Avx512f_64(
+   const Config * const pConfig,
+   const char * const sObjective,
+   const char * const sObjectiveEnd,
+   ObjectiveWrapper * const pObjectiveWrapperOut
+);
+
 INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Avx2_32(
    const Config * const pConfig,
    const char * const sObjective,
@@ -185,6 +241,13 @@ INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Avx2_32(
    ObjectiveWrapper * const pObjectiveWrapperOut
 );
 
+INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Avx2_64(
+   const Config * const pConfig,
+   const char * const sObjective,
+   const char * const sObjectiveEnd,
+   ObjectiveWrapper * const pObjectiveWrapperOut
+);
+
 INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Cuda_32(
    const Config * const pConfig,
    const char * const sObjective,
@@ -192,6 +255,13 @@ INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Cuda_32(
    ObjectiveWrapper * const pObjectiveWrapperOut
 );
 
+// Discretize has no objective, so the SIMD zones expose their Discretize kernels directly.  They process doubles
+// even in the 32 bit float zones since the cuts and feature values that we get from the caller are always doubles.
+typedef void (* DISCRETIZE_C)(const DiscretizeBridge * const pParams);
+
+INTERNAL_IMPORT_EXPORT_INCLUDE void Discretize_Avx512f_32(const DiscretizeBridge * const pParams);
+INTERNAL_IMPORT_EXPORT_INCLUDE void Discretize_Avx2_32(const DiscretizeBridge * const pParams);
+
 INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateMetric_Cpu_64(
    const Config * const pConfig,
    const char * const sMetric,
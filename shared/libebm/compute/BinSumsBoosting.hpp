@@ -606,6 +606,331 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
    } while(pGradientsAndHessiansEnd != pGradientAndHessian);
 }
 
+template<typename TFloat, bool bHessian, int cCompilerPack>
+GPU_DEVICE NEVER_INLINE static void BinSumsBoostingBagsInternal(BinSumsBoostingBridge * const pParams) {
+   // Bins several inner bags in a single pass over the data. The bags only differ in their weights and
+   // occurrence counts, so the packed bin indexes and the gradients/hessians are loaded and decoded once for
+   // all of them. Each bag is accumulated into its own fast bins in the same order as BinSumsBoostingInternal
+   // would, so the resulting sums are identical to binning each bag separately.
+   // Inner bags always have weights and occurrence counts, and we only do this for single score bitpacked terms.
+
+#ifndef GPU_COMPILE
+   EBM_ASSERT(nullptr != pParams);
+   EBM_ASSERT(1 <= pParams->m_cSamples);
+   EBM_ASSERT(0 == pParams->m_cSamples % size_t { TFloat::k_cSIMDPack });
+   EBM_ASSERT(nullptr != pParams->m_aGradientsAndHessians);
+   EBM_ASSERT(size_t { 1 } == pParams->m_cScores);
+   EBM_ASSERT(size_t { 2 } <= pParams->m_cBags);
+   EBM_ASSERT(pParams->m_cBags <= k_cBagsPerPassMax);
+#endif // GPU_COMPILE
+
+   const size_t cBags = pParams->m_cBags;
+
+   Bin<typename TFloat::T, typename TFloat::TInt::T, bHessian, size_t { 1 }> * aaBins[k_cBagsPerPassMax];
+   const typename TFloat::T * apWeights[k_cBagsPerPassMax];
+   const uint8_t * apCountOccurrences[k_cBagsPerPassMax];
+   size_t iBagInit = 0;
+   do {
+      aaBins[iBagInit] = reinterpret_cast<BinBase *>(pParams->m_aaBagFastBins[iBagInit])->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, size_t { 1 }>();
+      apWeights[iBagInit] = reinterpret_cast<const typename TFloat::T *>(pParams->m_aaBagWeights[iBagInit]);
+      apCountOccurrences[iBagInit] = pParams->m_apBagCountOccurrences[iBagInit];
+#ifndef GPU_COMPILE
+      EBM_ASSERT(nullptr != aaBins[iBagInit]);
+      EBM_ASSERT(nullptr != apWeights[iBagInit]);
+      EBM_ASSERT(nullptr != apCountOccurrences[iBagInit]);
+#endif // GPU_COMPILE
+      ++iBagInit;
+   } while(cBags != iBagInit);
+
+   const size_t cSamples = pParams->m_cSamples;
+
+   const typename TFloat::T * pGradientAndHessian = reinterpret_cast<const typename TFloat::T *>(pParams->m_aGradientsAndHessians);
+   const typename TFloat::T * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cSamples;
+
+   const typename TFloat::TInt::T cBytesPerBin = static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, size_t { 1 }));
+
+   const int cItemsPerBitPack = GET_ITEMS_PER_BIT_PACK(cCompilerPack, pParams->m_cPack);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(k_cItemsPerBitPackNone != cItemsPerBitPack); // we require this condition to be templated
+   EBM_ASSERT(1 <= cItemsPerBitPack);
+   EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(typename TFloat::TInt::T));
+#endif // GPU_COMPILE
+
+   const int cBitsPerItemMax = GetCountBits<typename TFloat::TInt::T>(cItemsPerBitPack);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(1 <= cBitsPerItemMax);
+   EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(typename TFloat::TInt::T));
+#endif // GPU_COMPILE
+
+   int cShift = static_cast<int>(((cSamples >> TFloat::k_cSIMDShift) - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
+   const int cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+
+   const typename TFloat::TInt maskBits = MakeLowMask<typename TFloat::TInt::T>(cBitsPerItemMax);
+
+   const typename TFloat::TInt::T * pInputData = reinterpret_cast<const typename TFloat::TInt::T *>(pParams->m_aPacked);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(nullptr != pInputData);
+#endif // GPU_COMPILE
+
+   // the weights and occurrences of all bags are indexed by the same sample offset
+   size_t iSample = 0;
+   do {
+      const typename TFloat::TInt iTensorBinCombined = TFloat::TInt::Load(pInputData);
+      pInputData += TFloat::TInt::k_cSIMDPack;
+      do {
+         const TFloat gradient = TFloat::Load(pGradientAndHessian);
+         TFloat hessian;
+         if(bHessian) {
+            hessian = TFloat::Load(&pGradientAndHessian[TFloat::k_cSIMDPack]);
+         }
+         pGradientAndHessian += (bHessian ? size_t { 2 } : size_t { 1 }) * TFloat::k_cSIMDPack;
+
+         typename TFloat::TInt iTensorBin = (iTensorBinCombined >> cShift) & maskBits;
+         iTensorBin = Multiply<typename TFloat::TInt, typename TFloat::TInt::T,
+            1 != TFloat::k_cSIMDPack,
+            static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, size_t { 1 }))>(
+               iTensorBin, cBytesPerBin);
+
+         size_t iBag = 0;
+         do {
+            const TFloat weight = TFloat::Load(&apWeights[iBag][iSample]);
+            const typename TFloat::TInt cOccurences = TFloat::TInt::LoadBytes(&apCountOccurrences[iBag][iSample]);
+            auto * const aBins = aaBins[iBag];
+
+            // BEWARE: pBin can point to the same bin in multiple samples within the SIMD pack, so we need to 
+            // serialize fetching sums
+            if(bHessian) {
+               TFloat::Execute([aBins](
+                  int,
+                  const typename TFloat::TInt::T i,
+                  const typename TFloat::TInt::T c,
+                  const typename TFloat::T w,
+                  const typename TFloat::T grad,
+                  const typename TFloat::T hess
+               ) {
+                  auto * const pBin = IndexBin(aBins, static_cast<size_t>(i));
+                  auto * const pGradientPair = pBin->GetGradientPairs();
+                  typename TFloat::TInt::T cBinSamples = pBin->GetCountSamples();
+                  typename TFloat::T binWeight = pBin->GetWeight();
+                  typename TFloat::T binGrad = pGradientPair->m_sumGradients;
+                  typename TFloat::T binHess = pGradientPair->GetHess();
+                  cBinSamples += c;
+                  binWeight += w;
+                  binGrad += grad;
+                  binHess += hess;
+                  pBin->SetCountSamples(cBinSamples);
+                  pBin->SetWeight(binWeight);
+                  pGradientPair->m_sumGradients = binGrad;
+                  pGradientPair->SetHess(binHess);
+               }, iTensorBin, cOccurences, weight, gradient * weight, hessian * weight);
+            } else {
+               TFloat::Execute([aBins](
+                  int,
+                  const typename TFloat::TInt::T i,
+                  const typename TFloat::TInt::T c,
+                  const typename TFloat::T w,
+                  const typename TFloat::T grad
+               ) {
+                  auto * const pBin = IndexBin(aBins, static_cast<size_t>(i));
+                  auto * const pGradientPair = pBin->GetGradientPairs();
+                  typename TFloat::TInt::T cBinSamples = pBin->GetCountSamples();
+                  typename TFloat::T binWeight = pBin->GetWeight();
+                  typename TFloat::T binGrad = pGradientPair->m_sumGradients;
+                  cBinSamples += c;
+                  binWeight += w;
+                  binGrad += grad;
+                  pBin->SetCountSamples(cBinSamples);
+                  pBin->SetWeight(binWeight);
+                  pGradientPair->m_sumGradients = binGrad;
+               }, iTensorBin, cOccurences, weight, gradient * weight);
+            }
+            ++iBag;
+         } while(cBags != iBag);
+         iSample += TFloat::k_cSIMDPack;
+
+         cShift -= cBitsPerItemMax;
+      } while(0 <= cShift);
+      cShift = cShiftReset;
+   } while(pGradientsAndHessiansEnd != pGradientAndHessian);
+}
+
+template<
+   typename TFloat,
+   bool bHessian,
+   bool bReplication,
+   typename TQuantized,
+   int cCompilerPack,
+   typename std::enable_if<k_cItemsPerBitPackNone == cCompilerPack, int>::type = 0
+>
+GPU_DEVICE NEVER_INLINE static void BinSumsBoostingQuantizedInternal(BinSumsBoostingBridge * const pParams) {
+   // The integer counterpart of the single bin BinSumsBoostingInternal.  Every sample goes into the one int32_t bin, 
+   // and integer addition is exact, so the order in which the lanes are added does not matter.
+
+#ifndef GPU_COMPILE
+   EBM_ASSERT(nullptr != pParams);
+   EBM_ASSERT(1 <= pParams->m_cSamples);
+   EBM_ASSERT(0 == pParams->m_cSamples % size_t { TFloat::k_cSIMDPack });
+   EBM_ASSERT(sizeof(TQuantized) == static_cast<size_t>(pParams->m_cQuantizedBytes));
+   EBM_ASSERT(nullptr != pParams->m_aGradientsAndHessians);
+   EBM_ASSERT(nullptr == pParams->m_aWeights);
+   EBM_ASSERT(nullptr != pParams->m_aFastBins);
+#endif // GPU_COMPILE
+
+   static constexpr size_t cSIMDPack = static_cast<size_t>(TFloat::k_cSIMDPack);
+   static constexpr size_t cItemsPerScore = bHessian ? size_t { 2 } : size_t { 1 };
+
+   const size_t cScores = pParams->m_cScores;
+   const size_t cSamples = pParams->m_cSamples;
+
+   int32_t * const aBins = reinterpret_cast<int32_t *>(pParams->m_aFastBins);
+
+   const TQuantized * pGradientAndHessian = reinterpret_cast<const TQuantized *>(pParams->m_aGradientsAndHessians);
+   const TQuantized * const pGradientsAndHessiansEnd = pGradientAndHessian + cItemsPerScore * cScores * cSamples;
+
+   const uint8_t * pCountOccurrences;
+   if(bReplication) {
+      pCountOccurrences = pParams->m_pCountOccurrences;
+#ifndef GPU_COMPILE
+      EBM_ASSERT(nullptr != pCountOccurrences);
+#endif // GPU_COMPILE
+   }
+
+   do {
+      size_t iLane = 0;
+      do {
+         const int32_t cOccurrences = bReplication ? static_cast<int32_t>(pCountOccurrences[iLane]) : int32_t { 1 };
+         int32_t * pBin = aBins;
+         *pBin += cOccurrences;
+         ++pBin;
+
+         const TQuantized * pGradHess = &pGradientAndHessian[iLane];
+         size_t iScore = 0;
+         do {
+            *pBin += cOccurrences * static_cast<int32_t>(pGradHess[0]);
+            ++pBin;
+            if(bHessian) {
+               *pBin += cOccurrences * static_cast<int32_t>(pGradHess[cSIMDPack]);
+               ++pBin;
+            }
+            pGradHess += cItemsPerScore * cSIMDPack;
+            ++iScore;
+         } while(cScores != iScore);
+         ++iLane;
+      } while(cSIMDPack != iLane);
+
+      if(bReplication) {
+         pCountOccurrences += cSIMDPack;
+      }
+      pGradientAndHessian += cItemsPerScore * cScores * cSIMDPack;
+   } while(pGradientsAndHessiansEnd != pGradientAndHessian);
+}
+
+template<
+   typename TFloat,
+   bool bHessian,
+   bool bReplication,
+   typename TQuantized,
+   int cCompilerPack,
+   typename std::enable_if<k_cItemsPerBitPackNone != cCompilerPack, int>::type = 0
+>
+GPU_DEVICE NEVER_INLINE static void BinSumsBoostingQuantizedInternal(BinSumsBoostingBridge * const pParams) {
+   // The integer counterpart of the bit packed BinSumsBoostingInternal.  The bin indexes are unpacked in SIMD
+   // registers, but the int32_t sums are added lane by lane since several lanes can hit the same bin.  Zones that
+   // can gather and scatter integers provide their own kernel for the single score case instead of this one.
+
+#ifndef GPU_COMPILE
+   EBM_ASSERT(nullptr != pParams);
+   EBM_ASSERT(1 <= pParams->m_cSamples);
+   EBM_ASSERT(0 == pParams->m_cSamples % size_t { TFloat::k_cSIMDPack });
+   EBM_ASSERT(sizeof(TQuantized) == static_cast<size_t>(pParams->m_cQuantizedBytes));
+   EBM_ASSERT(nullptr != pParams->m_aGradientsAndHessians);
+   EBM_ASSERT(nullptr == pParams->m_aWeights);
+   EBM_ASSERT(nullptr != pParams->m_aFastBins);
+#endif // GPU_COMPILE
+
+   static constexpr size_t cSIMDPack = static_cast<size_t>(TFloat::k_cSIMDPack);
+   static constexpr size_t cItemsPerScore = bHessian ? size_t { 2 } : size_t { 1 };
+
+   const size_t cScores = pParams->m_cScores;
+   const size_t cSamples = pParams->m_cSamples;
+   const size_t cItemsPerBin = size_t { 1 } + cItemsPerScore * cScores;
+
+   int32_t * const aBins = reinterpret_cast<int32_t *>(pParams->m_aFastBins);
+
+   const TQuantized * pGradientAndHessian = reinterpret_cast<const TQuantized *>(pParams->m_aGradientsAndHessians);
+   const TQuantized * const pGradientsAndHessiansEnd = pGradientAndHessian + cItemsPerScore * cScores * cSamples;
+
+   const uint8_t * pCountOccurrences = nullptr;
+   if(bReplication) {
+      pCountOccurrences = pParams->m_pCountOccurrences;
+#ifndef GPU_COMPILE
+      EBM_ASSERT(nullptr != pCountOccurrences);
+#endif // GPU_COMPILE
+   }
+
+   const int cItemsPerBitPack = GET_ITEMS_PER_BIT_PACK(cCompilerPack, pParams->m_cPack);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(k_cItemsPerBitPackNone != cItemsPerBitPack); // we require this condition to be templated
+   EBM_ASSERT(1 <= cItemsPerBitPack);
+   EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(typename TFloat::TInt::T));
+#endif // GPU_COMPILE
+
+   const int cBitsPerItemMax = GetCountBits<typename TFloat::TInt::T>(cItemsPerBitPack);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(1 <= cBitsPerItemMax);
+   EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(typename TFloat::TInt::T));
+#endif // GPU_COMPILE
+
+   int cShift = static_cast<int>(((cSamples >> TFloat::k_cSIMDShift) - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
+   const int cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+
+   const typename TFloat::TInt maskBits = MakeLowMask<typename TFloat::TInt::T>(cBitsPerItemMax);
+
+   const typename TFloat::TInt::T * pInputData = reinterpret_cast<const typename TFloat::TInt::T *>(pParams->m_aPacked);
+#ifndef GPU_COMPILE
+   EBM_ASSERT(nullptr != pInputData);
+#endif // GPU_COMPILE
+
+   do {
+      const typename TFloat::TInt iTensorBinCombined = TFloat::TInt::Load(pInputData);
+      pInputData += TFloat::TInt::k_cSIMDPack;
+      do {
+         const typename TFloat::TInt iTensorBin = (iTensorBinCombined >> cShift) & maskBits;
+
+         TFloat::TInt::Execute([aBins, cItemsPerBin, cScores, pGradientAndHessian, pCountOccurrences](
+            const int iLane, 
+            const typename TFloat::TInt::T i
+         ) {
+            const int32_t cOccurrences = bReplication ? static_cast<int32_t>(pCountOccurrences[iLane]) : int32_t { 1 };
+            int32_t * pBin = &aBins[static_cast<size_t>(i) * cItemsPerBin];
+            *pBin += cOccurrences;
+            ++pBin;
+
+            const TQuantized * pGradHess = &pGradientAndHessian[iLane];
+            size_t iScore = 0;
+            do {
+               *pBin += cOccurrences * static_cast<int32_t>(pGradHess[0]);
+               ++pBin;
+               if(bHessian) {
+                  *pBin += cOccurrences * static_cast<int32_t>(pGradHess[cSIMDPack]);
+                  ++pBin;
+               }
+               pGradHess += cItemsPerScore * cSIMDPack;
+               ++iScore;
+            } while(cScores != iScore);
+         }, iTensorBin);
+
+         if(bReplication) {
+            pCountOccurrences += cSIMDPack;
+         }
+         pGradientAndHessian += cItemsPerScore * cScores * cSIMDPack;
+
+         cShift -= cBitsPerItemMax;
+      } while(0 <= cShift);
+      cShift = cShiftReset;
+   } while(pGradientsAndHessiansEnd != pGradientAndHessian);
+}
+
 template<typename TFloat, bool bHessian, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
 GPU_GLOBAL static void RemoteBinSumsBoosting(BinSumsBoostingBridge * const pParams) {
    BinSumsBoostingInternal<TFloat, bHessian, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
@@ -616,6 +941,44 @@ INLINE_RELEASE_TEMPLATED ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge
    return TFloat::template OperatorBinSumsBoosting<bHessian, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
 }
 
+template<typename TFloat, bool bHessian, int cCompilerPack>
+GPU_GLOBAL static void RemoteBinSumsBoostingBags(BinSumsBoostingBridge * const pParams) {
+   BinSumsBoostingBagsInternal<TFloat, bHessian, cCompilerPack>(pParams);
+}
+
+template<typename TFloat, bool bHessian, int cCompilerPack>
+INLINE_RELEASE_TEMPLATED ErrorEbm OperatorBinSumsBoostingBags(BinSumsBoostingBridge * const pParams) {
+   return TFloat::template OperatorBinSumsBoostingBags<bHessian, cCompilerPack>(pParams);
+}
+
+template<typename TFloat, bool bHessian, bool bReplication, typename TQuantized, int cCompilerPack>
+GPU_GLOBAL static void RemoteBinSumsBoostingQuantized(BinSumsBoostingBridge * const pParams) {
+   BinSumsBoostingQuantizedInternal<TFloat, bHessian, bReplication, TQuantized, cCompilerPack>(pParams);
+}
+
+template<typename TFloat, bool bHessian, bool bReplication, typename TQuantized, int cCompilerPack>
+INLINE_RELEASE_TEMPLATED ErrorEbm OperatorBinSumsBoostingQuantized(BinSumsBoostingBridge * const pParams) {
+   return TFloat::template OperatorBinSumsBoostingQuantized<bHessian, bReplication, TQuantized, cCompilerPack>(pParams);
+}
+
+template<typename TFloat, bool bHessian, bool bReplication, typename TQuantized>
+INLINE_RELEASE_TEMPLATED static ErrorEbm BitPackBoostingQuantized(BinSumsBoostingBridge * const pParams) {
+   if(k_cItemsPerBitPackNone != pParams->m_cPack) {
+      return OperatorBinSumsBoostingQuantized<TFloat, bHessian, bReplication, TQuantized, k_cItemsPerBitPackDynamic>(pParams);
+   } else {
+      return OperatorBinSumsBoostingQuantized<TFloat, bHessian, bReplication, TQuantized, k_cItemsPerBitPackNone>(pParams);
+   }
+}
+
+template<typename TFloat, bool bHessian, typename TQuantized>
+INLINE_RELEASE_TEMPLATED static ErrorEbm ReplicationBoostingQuantized(BinSumsBoostingBridge * const pParams) {
+   if(nullptr != pParams->m_pCountOccurrences) {
+      return BitPackBoostingQuantized<TFloat, bHessian, true, TQuantized>(pParams);
+   } else {
+      return BitPackBoostingQuantized<TFloat, bHessian, false, TQuantized>(pParams);
+   }
+}
+
 template<typename TFloat, bool bHessian, bool bWeight, bool bReplication, size_t cCompilerScores>
 INLINE_RELEASE_TEMPLATED static ErrorEbm BitPackBoosting(BinSumsBoostingBridge * const pParams) {
    if(k_cItemsPerBitPackNone != pParams->m_cPack) {
@@ -659,7 +1022,45 @@ INLINE_RELEASE_TEMPLATED static ErrorEbm BinSumsBoosting(BinSumsBoostingBridge *
    ErrorEbm error;
 
    EBM_ASSERT(1 <= pParams->m_cScores);
-   if(EBM_FALSE != pParams->m_bHessian) {
+   if(0 != pParams->m_cQuantizedBytes) {
+      LOG_N(Trace_Verbose, "BinSumsBoosting summing %d byte quantized gradients in zone 0x%" UAccelerationFlagsPrintf, 
+         pParams->m_cQuantizedBytes, static_cast<UAccelerationFlags>(TFloat::k_zone));
+
+      // the integer sums need integer bag weights, so quantized subsets only have occurrence counts
+      EBM_ASSERT(nullptr == pParams->m_aWeights);
+      EBM_ASSERT(size_t { 1 } == pParams->m_cBags);
+      if(sizeof(int8_t) == static_cast<size_t>(pParams->m_cQuantizedBytes)) {
+         if(EBM_FALSE != pParams->m_bHessian) {
+            error = ReplicationBoostingQuantized<TFloat, true, int8_t>(pParams);
+         } else {
+            error = ReplicationBoostingQuantized<TFloat, false, int8_t>(pParams);
+         }
+      } else {
+         EBM_ASSERT(sizeof(int16_t) == static_cast<size_t>(pParams->m_cQuantizedBytes));
+         if(EBM_FALSE != pParams->m_bHessian) {
+            error = ReplicationBoostingQuantized<TFloat, true, int16_t>(pParams);
+         } else {
+            error = ReplicationBoostingQuantized<TFloat, false, int16_t>(pParams);
+         }
+      }
+   } else if(size_t { 2 } <= pParams->m_cBags) {
+#ifndef NDEBUG
+      for(size_t iDebug = 0; iDebug < pParams->m_cBags; ++iDebug) {
+         EBM_ASSERT(IsAligned(pParams->m_aaBagWeights[iDebug]));
+         EBM_ASSERT(IsAligned(pParams->m_apBagCountOccurrences[iDebug]));
+         EBM_ASSERT(IsAligned(pParams->m_aaBagFastBins[iDebug]));
+      }
+#endif // NDEBUG
+
+      // multiple inner bags are only binned together for single score bitpacked terms
+      EBM_ASSERT(size_t { 1 } == pParams->m_cScores);
+      EBM_ASSERT(k_cItemsPerBitPackNone != pParams->m_cPack);
+      if(EBM_FALSE != pParams->m_bHessian) {
+         error = OperatorBinSumsBoostingBags<TFloat, true, k_cItemsPerBitPackDynamic>(pParams);
+      } else {
+         error = OperatorBinSumsBoostingBags<TFloat, false, k_cItemsPerBitPackDynamic>(pParams);
+      }
+   } else if(EBM_FALSE != pParams->m_bHessian) {
       static constexpr bool bHessian = true;
       if(nullptr != pParams->m_aWeights) {
          static constexpr bool bWeight = true;
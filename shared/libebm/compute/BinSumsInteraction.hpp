@@ -211,8 +211,9 @@ GPU_DEVICE NEVER_INLINE static void BinSumsInteractionInternal(BinSumsInteractio
          pBin->SetCountSamples(pBin->GetCountSamples() + typename TFloat::TInt::T { 1 });
       });
 
+      TFloat weight;
       if(bWeight) {
-         const TFloat weight = TFloat::Load(pWeight);
+         weight = TFloat::Load(pWeight);
          pWeight += TFloat::k_cSIMDPack;
 
          TFloat::Execute([apBins](const int i, const typename TFloat::T x) {
@@ -233,8 +234,12 @@ GPU_DEVICE NEVER_INLINE static void BinSumsInteractionInternal(BinSumsInteractio
       size_t iScore = 0;
       do {
          if(bHessian) {
-            const TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << (TFloat::k_cSIMDShift + 1)]);
-            const TFloat hessian = TFloat::Load(&pGradientAndHessian[(iScore << (TFloat::k_cSIMDShift + 1)) + TFloat::k_cSIMDPack]);
+            TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << (TFloat::k_cSIMDShift + 1)]);
+            TFloat hessian = TFloat::Load(&pGradientAndHessian[(iScore << (TFloat::k_cSIMDShift + 1)) + TFloat::k_cSIMDPack]);
+            if(bWeight) {
+               gradient *= weight;
+               hessian *= weight;
+            }
             TFloat::Execute([apBins, iScore](const int i, const typename TFloat::T grad, const typename TFloat::T hess) {
                // BEWARE: unless we generate a separate histogram for each SIMD stream and later merge them, pBin can 
                // point to the same bin in multiple samples within the SIMD pack, so we need to serialize fetching sums
@@ -249,7 +254,10 @@ GPU_DEVICE NEVER_INLINE static void BinSumsInteractionInternal(BinSumsInteractio
                pGradientPair->SetHess(binHess);
             }, gradient, hessian);
          } else {
-            const TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << TFloat::k_cSIMDShift]);
+            TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << TFloat::k_cSIMDShift]);
+            if(bWeight) {
+               gradient *= weight;
+            }
             TFloat::Execute([apBins, iScore](const int i, const typename TFloat::T grad) {
                // BEWARE: unless we generate a separate histogram for each SIMD stream and later merge them, pBin can 
                // point to the same bin in multiple samples within the SIMD pack, so we need to serialize fetching sums
@@ -267,6 +275,243 @@ GPU_DEVICE NEVER_INLINE static void BinSumsInteractionInternal(BinSumsInteractio
 }
 WARNING_POP
 
+WARNING_PUSH
+WARNING_DISABLE_UNINITIALIZED_MEMBER_VARIABLE
+template<typename TFloat, bool bHessian, bool bWeight, size_t cCompilerScores>
+GPU_DEVICE NEVER_INLINE static void BinSumsInteractionPartnersInternal(BinSumsInteractionBridge * const pParams) {
+   // Bins the pair tensors of one anchor feature against several partner features in a single pass over the data.
+   // The gradients, hessians, weights, and anchor bins are loaded and decoded once for all the partners. Each partner
+   // is accumulated into its own fast bins in the same order as BinSumsInteractionInternal would for the pair
+   // (anchor, partner), so the resulting sums are identical to binning each pair separately.
+
+   static constexpr size_t cArrayScores = GetArrayScores(cCompilerScores);
+
+#ifndef GPU_COMPILE
+   EBM_ASSERT(nullptr != pParams);
+   EBM_ASSERT(1 <= pParams->m_cSamples);
+   EBM_ASSERT(0 == pParams->m_cSamples % size_t { TFloat::k_cSIMDPack });
+   EBM_ASSERT(nullptr != pParams->m_aGradientsAndHessians);
+   EBM_ASSERT(k_dynamicScores == cCompilerScores || cCompilerScores == pParams->m_cScores);
+   EBM_ASSERT(1 == pParams->m_cRuntimeRealDimensions);
+   EBM_ASSERT(1 <= pParams->m_cPartners);
+   EBM_ASSERT(pParams->m_cPartners <= k_cPartnersPerPassMax);
+#endif // GPU_COMPILE
+
+   const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pParams->m_cScores);
+   const size_t cPartners = pParams->m_cPartners;
+
+   const size_t cSamples = pParams->m_cSamples;
+
+   const typename TFloat::T * pGradientAndHessian = reinterpret_cast<const typename TFloat::T *>(pParams->m_aGradientsAndHessians);
+   const typename TFloat::T * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cScores * cSamples;
+
+   struct alignas(EbmMax(alignof(typename TFloat::TInt), alignof(void *), alignof(int))) PackedData {
+      int m_cShift;
+      int m_cBitsPerItemMax;
+      int m_cShiftReset;
+      const typename TFloat::TInt::T * m_pData;
+
+      typename TFloat::TInt iBinCombined;
+      typename TFloat::TInt maskBits;
+   };
+
+   // the anchor is at index 0 and the partners follow it
+   PackedData aPackedData[1 + k_cPartnersPerPassMax];
+   Bin<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores> * aaBins[k_cPartnersPerPassMax];
+
+   size_t iPackedInit = 0;
+   do {
+      PackedData * const pPackedData = &aPackedData[iPackedInit];
+
+      const void * pPacked;
+      int cItemsPerBitPack;
+      if(size_t { 0 } == iPackedInit) {
+         pPacked = pParams->m_aaPacked[0];
+         cItemsPerBitPack = pParams->m_acItemsPerBitPack[0];
+      } else {
+         pPacked = pParams->m_aaPartnerPacked[iPackedInit - 1];
+         cItemsPerBitPack = pParams->m_acPartnerItemsPerBitPack[iPackedInit - 1];
+         aaBins[iPackedInit - 1] = reinterpret_cast<BinBase *>(pParams->m_aaPartnerFastBins[iPackedInit - 1])->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores>();
+#ifndef GPU_COMPILE
+         EBM_ASSERT(nullptr != aaBins[iPackedInit - 1]);
+         EBM_ASSERT(size_t { 2 } <= pParams->m_acPartnerBins[iPackedInit - 1]);
+#endif // GPU_COMPILE
+      }
+
+      const typename TFloat::TInt::T * const pData = reinterpret_cast<const typename TFloat::TInt::T *>(pPacked);
+      pPackedData->iBinCombined = TFloat::TInt::Load(pData);
+      pPackedData->m_pData = pData + TFloat::TInt::k_cSIMDPack;
+
+#ifndef GPU_COMPILE
+      EBM_ASSERT(1 <= cItemsPerBitPack);
+      EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(typename TFloat::TInt::T));
+#endif // GPU_COMPILE
+
+      const int cBitsPerItemMax = GetCountBits<typename TFloat::TInt::T>(cItemsPerBitPack);
+#ifndef GPU_COMPILE
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(typename TFloat::TInt::T));
+#endif // GPU_COMPILE
+      pPackedData->m_cBitsPerItemMax = cBitsPerItemMax;
+
+      pPackedData->m_cShift = (static_cast<int>(((cSamples >> TFloat::k_cSIMDShift) - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) + 1) * cBitsPerItemMax;
+      pPackedData->m_cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+
+      pPackedData->maskBits = MakeLowMask<typename TFloat::TInt::T>(cBitsPerItemMax);
+
+      ++iPackedInit;
+   } while(size_t { 1 } + cPartners != iPackedInit);
+
+   const size_t cBytesPerBin = GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, cScores);
+
+   // the partner is the second dimension, so each of its bins skips over all the bins of the anchor
+   const size_t cAnchorBins = pParams->m_acBins[0];
+#ifndef GPU_COMPILE
+   EBM_ASSERT(size_t { 2 } <= cAnchorBins);
+#endif // GPU_COMPILE
+   const size_t cBytesPartnerStride = cBytesPerBin * cAnchorBins;
+
+   const typename TFloat::T * pWeight;
+   if(bWeight) {
+      pWeight = reinterpret_cast<const typename TFloat::T *>(pParams->m_aWeights);
+#ifndef GPU_COMPILE
+      EBM_ASSERT(nullptr != pWeight);
+#endif // GPU_COMPILE
+   }
+
+   while(true) {
+      size_t aAnchorBytes[TFloat::k_cSIMDPack];
+      {
+         PackedData * const pPackedData = &aPackedData[0];
+
+         const int shift = pPackedData->m_cShift - pPackedData->m_cBitsPerItemMax;
+         pPackedData->m_cShift = shift;
+         if(shift < 0) {
+            if(pGradientsAndHessiansEnd == pGradientAndHessian) {
+               // the anchor and all the partners reach the end simultaneously
+               return;
+            }
+            const typename TFloat::TInt::T * const pData = pPackedData->m_pData;
+            pPackedData->iBinCombined = TFloat::TInt::Load(pData);
+            pPackedData->m_pData = pData + TFloat::TInt::k_cSIMDPack;
+            pPackedData->m_cShift = pPackedData->m_cShiftReset;
+         }
+
+         const typename TFloat::TInt iBin = (pPackedData->iBinCombined >> pPackedData->m_cShift) & pPackedData->maskBits;
+
+#ifndef NDEBUG
+#ifndef GPU_COMPILE
+         TFloat::TInt::Execute([cAnchorBins](int, const typename TFloat::TInt::T x) {
+            EBM_ASSERT(static_cast<size_t>(x) < cAnchorBins);
+         }, iBin);
+#endif // GPU_COMPILE
+#endif // NDEBUG
+
+         TFloat::TInt::Execute([&aAnchorBytes, cBytesPerBin](const int i, const typename TFloat::TInt::T x) {
+            aAnchorBytes[i] = static_cast<size_t>(x) * cBytesPerBin;
+         }, iBin);
+      }
+
+      TFloat weight;
+      if(bWeight) {
+         weight = TFloat::Load(pWeight);
+         pWeight += TFloat::k_cSIMDPack;
+      }
+
+      size_t iPartner = 0;
+      do {
+         PackedData * const pPackedData = &aPackedData[size_t { 1 } + iPartner];
+
+         const int shift = pPackedData->m_cShift - pPackedData->m_cBitsPerItemMax;
+         pPackedData->m_cShift = shift;
+         if(shift < 0) {
+            const typename TFloat::TInt::T * const pData = pPackedData->m_pData;
+            pPackedData->iBinCombined = TFloat::TInt::Load(pData);
+            pPackedData->m_pData = pData + TFloat::TInt::k_cSIMDPack;
+            pPackedData->m_cShift = pPackedData->m_cShiftReset;
+         }
+
+         const typename TFloat::TInt iBin = (pPackedData->iBinCombined >> pPackedData->m_cShift) & pPackedData->maskBits;
+
+#ifndef NDEBUG
+#ifndef GPU_COMPILE
+         const size_t cPartnerBins = pParams->m_acPartnerBins[iPartner];
+         TFloat::TInt::Execute([cPartnerBins](int, const typename TFloat::TInt::T x) {
+            EBM_ASSERT(static_cast<size_t>(x) < cPartnerBins);
+         }, iBin);
+#endif // GPU_COMPILE
+#endif // NDEBUG
+
+         auto * const aBins = aaBins[iPartner];
+         Bin<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores> * apBins[TFloat::k_cSIMDPack];
+         TFloat::TInt::Execute([aBins, &apBins, &aAnchorBytes, cBytesPartnerStride](const int i, const typename TFloat::TInt::T x) {
+            apBins[i] = IndexByte(aBins, aAnchorBytes[i] + static_cast<size_t>(x) * cBytesPartnerStride);
+         }, iBin);
+
+         TFloat::Execute([apBins](const int i) {
+            auto * const pBin = apBins[i];
+            pBin->SetCountSamples(pBin->GetCountSamples() + typename TFloat::TInt::T { 1 });
+         });
+
+         if(bWeight) {
+            TFloat::Execute([apBins](const int i, const typename TFloat::T x) {
+               auto * const pBin = apBins[i];
+               pBin->SetWeight(pBin->GetWeight() + x);
+            }, weight);
+         } else {
+            TFloat::Execute([apBins](const int i) {
+               auto * const pBin = apBins[i];
+               pBin->SetWeight(pBin->GetWeight() + typename TFloat::T { 1.0 });
+            });
+         }
+
+         size_t iScore = 0;
+         do {
+            if(bHessian) {
+               TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << (TFloat::k_cSIMDShift + 1)]);
+               TFloat hessian = TFloat::Load(&pGradientAndHessian[(iScore << (TFloat::k_cSIMDShift + 1)) + TFloat::k_cSIMDPack]);
+               if(bWeight) {
+                  gradient *= weight;
+                  hessian *= weight;
+               }
+               TFloat::Execute([apBins, iScore](const int i, const typename TFloat::T grad, const typename TFloat::T hess) {
+                  // BEWARE: pBin can point to the same bin in multiple samples within the SIMD pack, so we need to
+                  // serialize fetching sums
+                  auto * const pBin = apBins[i];
+                  auto * const aGradientPair = pBin->GetGradientPairs();
+                  auto * const pGradientPair = &aGradientPair[iScore];
+                  typename TFloat::T binGrad = pGradientPair->m_sumGradients;
+                  typename TFloat::T binHess = pGradientPair->GetHess();
+                  binGrad += grad;
+                  binHess += hess;
+                  pGradientPair->m_sumGradients = binGrad;
+                  pGradientPair->SetHess(binHess);
+               }, gradient, hessian);
+            } else {
+               TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << TFloat::k_cSIMDShift]);
+               if(bWeight) {
+                  gradient *= weight;
+               }
+               TFloat::Execute([apBins, iScore](const int i, const typename TFloat::T grad) {
+                  // BEWARE: pBin can point to the same bin in multiple samples within the SIMD pack, so we need to
+                  // serialize fetching sums
+                  auto * const pBin = apBins[i];
+                  auto * const aGradientPair = pBin->GetGradientPairs();
+                  auto * const pGradientPair = &aGradientPair[iScore];
+                  pGradientPair->m_sumGradients += grad;
+               }, gradient);
+            }
+            ++iScore;
+         } while(cScores != iScore);
+
+         ++iPartner;
+      } while(cPartners != iPartner);
+
+      pGradientAndHessian += cScores << (bHessian ? (TFloat::k_cSIMDShift + 1) : TFloat::k_cSIMDShift);
+   }
+}
+WARNING_POP
+
 template<typename TFloat, bool bHessian, bool bWeight, size_t cCompilerScores, size_t cCompilerDimensions>
 GPU_GLOBAL static void RemoteBinSumsInteraction(BinSumsInteractionBridge * const pParams) {
    BinSumsInteractionInternal<TFloat, bHessian, bWeight, cCompilerScores, cCompilerDimensions>(pParams);
@@ -277,6 +522,26 @@ INLINE_RELEASE_TEMPLATED ErrorEbm OperatorBinSumsInteraction(BinSumsInteractionB
    return TFloat::template OperatorBinSumsInteraction<bHessian, bWeight, cCompilerScores, cCompilerDimensions>(pParams);
 }
 
+template<typename TFloat, bool bHessian, bool bWeight, size_t cCompilerScores>
+GPU_GLOBAL static void RemoteBinSumsInteractionPartners(BinSumsInteractionBridge * const pParams) {
+   BinSumsInteractionPartnersInternal<TFloat, bHessian, bWeight, cCompilerScores>(pParams);
+}
+
+template<typename TFloat, bool bHessian, bool bWeight, size_t cCompilerScores>
+INLINE_RELEASE_TEMPLATED ErrorEbm OperatorBinSumsInteractionPartners(BinSumsInteractionBridge * const pParams) {
+   return TFloat::template OperatorBinSumsInteractionPartners<bHessian, bWeight, cCompilerScores>(pParams);
+}
+
+template<typename TFloat, bool bHessian, bool bWeight>
+INLINE_RELEASE_TEMPLATED static ErrorEbm CountClassesInteractionPartners(BinSumsInteractionBridge * const pParams) {
+   // only the common single score case is specialized since the partner loop already dominates
+   if(size_t { 1 } == pParams->m_cScores) {
+      return OperatorBinSumsInteractionPartners<TFloat, bHessian, bWeight, k_oneScore>(pParams);
+   } else {
+      return OperatorBinSumsInteractionPartners<TFloat, bHessian, bWeight, k_dynamicScores>(pParams);
+   }
+}
+
 
 template<typename TFloat, bool bHessian, bool bWeight, size_t cCompilerScores, size_t cCompilerDimensionsPossible>
 struct CountDimensionsInteraction final {
@@ -325,12 +590,32 @@ INLINE_RELEASE_TEMPLATED static ErrorEbm BinSumsInteraction(BinSumsInteractionBr
    for(size_t i = 0 ; i < pParams->m_cRuntimeRealDimensions; ++i) {
       EBM_ASSERT(IsAligned(pParams->m_aaPacked[i]));
    }
+   for(size_t i = 0; i < pParams->m_cPartners; ++i) {
+      EBM_ASSERT(IsAligned(pParams->m_aaPartnerPacked[i]));
+      EBM_ASSERT(IsAligned(pParams->m_aaPartnerFastBins[i]));
+   }
 #endif // NDEBUG
 
    ErrorEbm error;
 
    EBM_ASSERT(1 <= pParams->m_cScores);
-   if(EBM_FALSE != pParams->m_bHessian) {
+   if(size_t { 0 } != pParams->m_cPartners) {
+      EBM_ASSERT(size_t { 1 } == pParams->m_cRuntimeRealDimensions);
+      EBM_ASSERT(pParams->m_cPartners <= k_cPartnersPerPassMax);
+      if(EBM_FALSE != pParams->m_bHessian) {
+         if(nullptr != pParams->m_aWeights) {
+            error = CountClassesInteractionPartners<TFloat, true, true>(pParams);
+         } else {
+            error = CountClassesInteractionPartners<TFloat, true, false>(pParams);
+         }
+      } else {
+         if(nullptr != pParams->m_aWeights) {
+            error = CountClassesInteractionPartners<TFloat, false, true>(pParams);
+         } else {
+            error = CountClassesInteractionPartners<TFloat, false, false>(pParams);
+         }
+      }
+   } else if(EBM_FALSE != pParams->m_bHessian) {
       static constexpr bool bHessian = true;
       if(nullptr != pParams->m_aWeights) {
          static constexpr bool bWeights = true;
@@ -106,7 +106,9 @@ class Registration {
    }
 
 protected:
-   const bool m_zones;
+   // GetObjective masks these with the caller's AccelerationFlags to find the SIMD zones that it may create, so this
+   // needs to keep every zone bit.  Storing it in a bool would leave only AccelerationFlags_Nvidia after the mask
+   const AccelerationFlags m_zones;
    const char * const m_sRegistrationName;
 
    static void CheckParamNames(const char * const sParamName, std::vector<const char *> usedParamNames) {
@@ -26,6 +26,7 @@
 #include "Objective.hpp"
 
 #include "approximate_math.hpp"
+#include "accurate_math.hpp"
 #include "compute_wrapper.hpp"
 
 namespace DEFINED_ZONE_NAME {
@@ -482,12 +483,36 @@ struct alignas(k_cAlignment) Avx2_32_Float final {
       return Avx2_32_Float(_mm256_sqrt_ps(val.m_data));
    }
 
+   friend inline Avx2_32_Float Round(const Avx2_32_Float & val) noexcept {
+      return Avx2_32_Float(_mm256_round_ps(val.m_data, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+   }
+
+   friend inline Avx2_32_Float Ldexp(const Avx2_32_Float & val, const Avx2_32_Float & exponent) noexcept {
+      // the result can be subnormal even when 2^exponent is not representable, so we apply the exponent in two
+      // halves that are each within the normal range
+      const __m256 half = _mm256_round_ps(_mm256_mul_ps(exponent.m_data, _mm256_set1_ps(0.5f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+      const __m256i bias = _mm256_set1_epi32(127);
+      const __m256i scale1 = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(half), bias), 23);
+      const __m256i scale2 = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(_mm256_sub_ps(exponent.m_data, half)), bias), 23);
+      return Avx2_32_Float(_mm256_mul_ps(_mm256_mul_ps(val.m_data, _mm256_castsi256_ps(scale1)), _mm256_castsi256_ps(scale2)));
+   }
+
+   friend inline Avx2_32_Float GetExponent(const Avx2_32_Float & val) noexcept {
+      const __m256i biased = _mm256_srli_epi32(_mm256_castps_si256(val.m_data), 23);
+      return Avx2_32_Float(_mm256_cvtepi32_ps(_mm256_sub_epi32(biased, _mm256_set1_epi32(127))));
+   }
+
+   friend inline Avx2_32_Float GetMantissa(const Avx2_32_Float & val) noexcept {
+      const __m256i bits = _mm256_and_si256(_mm256_castps_si256(val.m_data), _mm256_set1_epi32(0x007FFFFF));
+      return Avx2_32_Float(_mm256_castsi256_ps(_mm256_or_si256(bits, _mm256_set1_epi32(0x3F800000))));
+   }
+
    friend inline Avx2_32_Float Exp(const Avx2_32_Float & val) noexcept {
-      return ApplyFunc([](T x) { return std::exp(x); }, val);
+      return ExpAccurate(val);
    }
 
    friend inline Avx2_32_Float Log(const Avx2_32_Float & val) noexcept {
-      return ApplyFunc([](T x) { return std::log(x); }, val);
+      return LogAccurate(val);
    }
 
    template<
@@ -636,6 +661,20 @@ struct alignas(k_cAlignment) Avx2_32_Float final {
    }
 
 
+   template<bool bHessian, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingBags(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoostingBags<Avx2_32_Float, bHessian, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bReplication, typename TQuantized, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingQuantized(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoostingQuantized<Avx2_32_Float, bHessian, bReplication, TQuantized, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
    template<bool bHessian, bool bWeight, size_t cCompilerScores, size_t cCompilerDimensions>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteraction(BinSumsInteractionBridge * const pParams) noexcept {
       RemoteBinSumsInteraction<Avx2_32_Float, bHessian, bWeight, cCompilerScores, cCompilerDimensions>(pParams);
@@ -643,6 +682,13 @@ struct alignas(k_cAlignment) Avx2_32_Float final {
    }
 
 
+   template<bool bHessian, bool bWeight, size_t cCompilerScores>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteractionPartners(BinSumsInteractionBridge * const pParams) noexcept {
+      RemoteBinSumsInteractionPartners<Avx2_32_Float, bHessian, bWeight, cCompilerScores>(pParams);
+      return Error_None;
+   }
+
+
 private:
 
    inline Avx2_32_Float(const TPack & data) noexcept : m_data(data) {
@@ -710,6 +756,153 @@ INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsInteraction_Avx2_32(
    return (*pBinSumsInteractionCpp)(pParams);
 }
 
+// Up to this many cuts it is faster to compare each value against every cut than to binary search with gathers
+static constexpr size_t k_cCutsLinearMaxAvx2 = 32;
+// Each binary search step waits on a gather, so we interleave this many independent packs to hide that latency
+static constexpr size_t k_cDiscretizePacksAvx2 = 4;
+// the Eytzinger search handles this many top levels with broadcast comparisons (2^levels - 1 of them) before gathering
+static constexpr size_t k_cEytzingerLevelsTopAvx2 = 3;
+
+enum class DiscretizeSearchAvx2 {
+   Linear,
+   Binary,
+   Eytzinger
+};
+
+// bins cPacks * 4 doubles. Bins are identical to DiscretizeOneSample: 0 for NaN, otherwise 1 + the count of cuts <= val
+template<DiscretizeSearchAvx2 search, size_t cPacks>
+inline static void DiscretizePacksAvx2(
+   const __m256d * const aVal,
+   __m256i * const aiBin,
+   const size_t cCuts,
+   const size_t cEytzingerLevels,
+   const double * const aCuts
+) noexcept {
+   if(DiscretizeSearchAvx2::Eytzinger == search) {
+      // every lane walks the same number of levels of the perfect tree.  The top levels are shared by all lanes
+      // and sit together at the front of the array, so only the last few levels miss the cache.  Gathers are
+      // our bottleneck, so we descend the first levels by counting the cuts <= val in them instead.  Node k
+      // at the top of the remaining levels is 2^levels + that count
+      const size_t cLevelsTop = cEytzingerLevels < k_cEytzingerLevelsTopAvx2 ?
+         cEytzingerLevels : k_cEytzingerLevelsTopAvx2;
+      const size_t iNodeTopEnd = size_t { 1 } << cLevelsTop;
+      for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+         aiBin[iPack] = _mm256_set1_epi64x(static_cast<long long>(iNodeTopEnd));
+      }
+      for(size_t iNode = 1; iNode < iNodeTopEnd; ++iNode) {
+         const __m256d cut = _mm256_set1_pd(aCuts[iNode]);
+         for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+            const __m256d mask = _mm256_cmp_pd(cut, aVal[iPack], _CMP_LE_OQ);
+            aiBin[iPack] = _mm256_sub_epi64(aiBin[iPack], _mm256_castpd_si256(mask));
+         }
+      }
+      for(size_t iLevel = cLevelsTop; iLevel < cEytzingerLevels; ++iLevel) {
+         for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+            const __m256d cut = _mm256_i64gather_pd(aCuts, aiBin[iPack], sizeof(double));
+            // the padding is NaN, which compares false like a cut above every value.  True is -1, so subtract it
+            const __m256d mask = _mm256_cmp_pd(cut, aVal[iPack], _CMP_LE_OQ);
+            aiBin[iPack] = _mm256_sub_epi64(_mm256_add_epi64(aiBin[iPack], aiBin[iPack]), _mm256_castpd_si256(mask));
+         }
+      }
+      // the leaf we land on, counted from the left, is the number of cuts <= val
+      const __m256i leafFirst = _mm256_set1_epi64x(static_cast<long long>(size_t { 1 } << cEytzingerLevels));
+      for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+         aiBin[iPack] = _mm256_sub_epi64(aiBin[iPack], leafFirst);
+      }
+   } else {
+      for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+         aiBin[iPack] = _mm256_setzero_si256();
+      }
+   }
+   if(DiscretizeSearchAvx2::Linear == search) {
+      for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+         const __m256d cut = _mm256_set1_pd(aCuts[iCut]);
+         for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+            // true comparisons are all ones, which is -1, so subtracting adds one.  NaN values stay at zero
+            const __m256d mask = _mm256_cmp_pd(cut, aVal[iPack], _CMP_LE_OQ);
+            aiBin[iPack] = _mm256_sub_epi64(aiBin[iPack], _mm256_castpd_si256(mask));
+         }
+      }
+   } else if(DiscretizeSearchAvx2::Binary == search) {
+      // branchless upper bound.  The remaining length is the same for every lane, so only the base differs
+      size_t cRemaining = cCuts;
+      while(size_t { 1 } < cRemaining) {
+         const size_t cHalf = cRemaining >> 1;
+         const __m256i half = _mm256_set1_epi64x(static_cast<long long>(cHalf));
+         for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+            const __m256d cut = _mm256_i64gather_pd(aCuts, _mm256_add_epi64(aiBin[iPack], half), sizeof(double));
+            const __m256d mask = _mm256_cmp_pd(cut, aVal[iPack], _CMP_LE_OQ);
+            aiBin[iPack] = _mm256_add_epi64(aiBin[iPack], _mm256_and_si256(_mm256_castpd_si256(mask), half));
+         }
+         cRemaining -= cHalf;
+      }
+      for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+         const __m256d cut = _mm256_i64gather_pd(aCuts, aiBin[iPack], sizeof(double));
+         const __m256d mask = _mm256_cmp_pd(cut, aVal[iPack], _CMP_LE_OQ);
+         aiBin[iPack] = _mm256_sub_epi64(aiBin[iPack], _mm256_castpd_si256(mask));
+      }
+   }
+   const __m256i one = _mm256_set1_epi64x(1);
+   for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+      // non-missing values start from bin 1
+      const __m256d ordered = _mm256_cmp_pd(aVal[iPack], aVal[iPack], _CMP_ORD_Q);
+      aiBin[iPack] = _mm256_add_epi64(aiBin[iPack], _mm256_and_si256(_mm256_castpd_si256(ordered), one));
+   }
+}
+
+template<DiscretizeSearchAvx2 search>
+static void DiscretizeAvx2(const DiscretizeBridge * const pParams) noexcept {
+   static constexpr size_t cPack = 4;
+   static constexpr size_t cPacks = k_cDiscretizePacksAvx2;
+   static_assert(sizeof(IntEbm) == sizeof(long long), "we store the bins as 64 bit integers");
+
+   const size_t cCuts = pParams->m_cCuts;
+   const size_t cEytzingerLevels = pParams->m_cEytzingerLevels;
+   const double * const aCuts = pParams->m_aCutsLowerBoundInclusive;
+
+   const double * pVal = pParams->m_aFeatureVals;
+   IntEbm * piBin = pParams->m_aBinIndexesOut;
+   size_t cRemaining = pParams->m_cSamples;
+
+   __m256d aVal[cPacks];
+   __m256i aiBin[cPacks];
+   while(cPack * cPacks <= cRemaining) {
+      for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+         aVal[iPack] = _mm256_loadu_pd(pVal + iPack * cPack);
+      }
+      DiscretizePacksAvx2<search, cPacks>(aVal, aiBin, cCuts, cEytzingerLevels, aCuts);
+      for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+         _mm256_storeu_si256(reinterpret_cast<__m256i *>(piBin + iPack * cPack), aiBin[iPack]);
+      }
+      pVal += cPack * cPacks;
+      piBin += cPack * cPacks;
+      cRemaining -= cPack * cPacks;
+   }
+   while(size_t { 0 } != cRemaining) {
+      const size_t cItems = cRemaining < cPack ? cRemaining : cPack;
+      const __m256i mask = _mm256_cmpgt_epi64(
+         _mm256_set1_epi64x(static_cast<long long>(cItems)), _mm256_set_epi64x(3, 2, 1, 0));
+      aVal[0] = _mm256_maskload_pd(pVal, mask);
+      DiscretizePacksAvx2<search, 1>(aVal, aiBin, cCuts, cEytzingerLevels, aCuts);
+      _mm256_maskstore_epi64(reinterpret_cast<long long *>(piBin), mask, aiBin[0]);
+      pVal += cItems;
+      piBin += cItems;
+      cRemaining -= cItems;
+   }
+}
+
+INTERNAL_IMPORT_EXPORT_BODY void Discretize_Avx2_32(const DiscretizeBridge * const pParams) {
+   EBM_ASSERT(nullptr != pParams);
+   EBM_ASSERT(size_t { 1 } <= pParams->m_cCuts);
+   if(size_t { 0 } != pParams->m_cEytzingerLevels) {
+      DiscretizeAvx2<DiscretizeSearchAvx2::Eytzinger>(pParams);
+   } else if(pParams->m_cCuts <= k_cCutsLinearMaxAvx2) {
+      DiscretizeAvx2<DiscretizeSearchAvx2::Linear>(pParams);
+   } else {
+      DiscretizeAvx2<DiscretizeSearchAvx2::Binary>(pParams);
+   }
+}
+
 INTERNAL_IMPORT_EXPORT_BODY ErrorEbm CreateObjective_Avx2_32(
    const Config * const pConfig,
    const char * const sObjective,
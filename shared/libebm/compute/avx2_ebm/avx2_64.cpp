@@ -0,0 +1,693 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+// The 64 bit AVX2 zone is compiled and dispatched alongside the 32 bit AVX2 zone, so it shares its bridge macro.
+// It holds 4 doubles per pack instead of 8 floats, which allows us to use SIMD when exact double results are needed.
+#ifdef BRIDGE_AVX2_32
+
+#define _CRT_SECURE_NO_DEPRECATE
+
+#include <cmath> // exp, log
+#include <limits> // numeric_limits
+#include <type_traits> // is_unsigned
+#include <string.h> // memcpy
+#include <immintrin.h> // SIMD.  Do not include in pch.hpp!
+
+#include "libebm.h"
+#include "logging.h"
+#include "unzoned.h"
+
+#define ZONE_avx2
+#include "zones.h"
+
+#include "bridge.h"
+#include "common.hpp"
+#include "bridge.hpp"
+
+#include "Registration.hpp"
+#include "Objective.hpp"
+
+#include "approximate_math.hpp"
+#include "accurate_math.hpp"
+#include "compute_wrapper.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// this is super-special and included inside the zone namespace
+#include "objective_registrations.hpp"
+
+static constexpr size_t k_cAlignment = 32;
+
+struct alignas(k_cAlignment) Avx2_64_Float;
+
+struct alignas(k_cAlignment) Avx2_64_Int final {
+   friend Avx2_64_Float;
+   friend inline Avx2_64_Float IfEqual(const Avx2_64_Int & cmp1, const Avx2_64_Int & cmp2, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept;
+
+   using T = uint64_t;
+   using TPack = __m256i;
+   static_assert(std::is_unsigned<T>::value, "T must be an unsigned integer type");
+   static_assert(std::is_same<UIntBig, T>::value || std::is_same<UIntSmall, T>::value, 
+      "T must be either UIntBig or UIntSmall");
+   static constexpr AccelerationFlags k_zone = AccelerationFlags_AVX2;
+   static constexpr int k_cSIMDShift = 2;
+   static constexpr int k_cSIMDPack = 1 << k_cSIMDShift;
+
+   ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
+   inline Avx2_64_Int() noexcept {
+   }
+
+   inline Avx2_64_Int(const T & val) noexcept : m_data(_mm256_set1_epi64x(static_cast<long long>(val))) {
+   }
+
+   inline static Avx2_64_Int Load(const T * const a) noexcept {
+      return Avx2_64_Int(_mm256_load_si256(reinterpret_cast<const TPack *>(a)));
+   }
+
+   inline void Store(T * const a) const noexcept {
+      _mm256_store_si256(reinterpret_cast<TPack *>(a), m_data);
+   }
+
+   inline static Avx2_64_Int LoadBytes(const uint8_t * const a) noexcept {
+      int32_t bytes;
+      memcpy(&bytes, a, sizeof(bytes));
+      return Avx2_64_Int(_mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes)));
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Int & val0) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+
+      // no loops because this will disable optimizations for loops in the caller
+      func(0, a0[0]);
+      func(1, a0[1]);
+      func(2, a0[2]);
+      func(3, a0[3]);
+   }
+
+   inline static Avx2_64_Int MakeIndexes() noexcept {
+      return Avx2_64_Int(_mm256_set_epi64x(3, 2, 1, 0));
+   }
+
+   inline Avx2_64_Int operator+ (const Avx2_64_Int & other) const noexcept {
+      return Avx2_64_Int(_mm256_add_epi64(m_data, other.m_data));
+   }
+
+   inline Avx2_64_Int operator* (const T & other) const noexcept {
+      // AVX2 has no 64 bit low multiply, so build it from 32 bit multiplies.  The parts of the cross products
+      // above 64 bits are discarded, just as they would be in an ordinary uint64_t multiply
+      const __m256i mul = _mm256_set1_epi64x(static_cast<long long>(other));
+      const __m256i low = _mm256_mul_epu32(m_data, mul);
+      const __m256i cross = _mm256_add_epi64(
+         _mm256_mul_epu32(_mm256_srli_epi64(m_data, 32), mul),
+         _mm256_mul_epu32(m_data, _mm256_srli_epi64(mul, 32))
+      );
+      return Avx2_64_Int(_mm256_add_epi64(low, _mm256_slli_epi64(cross, 32)));
+   }
+
+   inline Avx2_64_Int operator>> (int shift) const noexcept {
+      return Avx2_64_Int(_mm256_srli_epi64(m_data, shift));
+   }
+
+   inline Avx2_64_Int operator<< (int shift) const noexcept {
+      return Avx2_64_Int(_mm256_slli_epi64(m_data, shift));
+   }
+
+   inline Avx2_64_Int operator& (const Avx2_64_Int & other) const noexcept {
+      return Avx2_64_Int(_mm256_and_si256(m_data, other.m_data));
+   }
+
+private:
+   inline Avx2_64_Int(const TPack & data) noexcept : m_data(data) {
+   }
+
+   TPack m_data;
+};
+static_assert(std::is_standard_layout<Avx2_64_Int>::value && std::is_trivially_copyable<Avx2_64_Int>::value,
+   "This allows offsetof, memcpy, memset, inter-language, GPU and cross-machine use where needed");
+
+
+struct alignas(k_cAlignment) Avx2_64_Float final {
+   using T = double;
+   using TPack = __m256d;
+   using TInt = Avx2_64_Int;
+   static_assert(std::is_same<FloatBig, T>::value || std::is_same<FloatSmall, T>::value,
+      "T must be either FloatBig or FloatSmall");
+   static constexpr AccelerationFlags k_zone = TInt::k_zone;
+   static constexpr int k_cSIMDShift = TInt::k_cSIMDShift;
+   static constexpr int k_cSIMDPack = TInt::k_cSIMDPack;
+
+   ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
+   inline Avx2_64_Float() noexcept {
+   }
+
+   inline Avx2_64_Float(const double val) noexcept : m_data(_mm256_set1_pd(static_cast<T>(val))) {
+   }
+   inline Avx2_64_Float(const float val) noexcept : m_data(_mm256_set1_pd(static_cast<T>(val))) {
+   }
+   inline Avx2_64_Float(const int val) noexcept : m_data(_mm256_set1_pd(static_cast<T>(val))) {
+   }
+
+
+   inline Avx2_64_Float operator+() const noexcept {
+      return *this;
+   }
+
+   inline Avx2_64_Float operator-() const noexcept {
+      return Avx2_64_Float(_mm256_xor_pd(m_data, _mm256_set1_pd(-0.0)));
+   }
+
+
+   inline Avx2_64_Float operator+ (const Avx2_64_Float & other) const noexcept {
+      return Avx2_64_Float(_mm256_add_pd(m_data, other.m_data));
+   }
+
+   inline Avx2_64_Float operator- (const Avx2_64_Float & other) const noexcept {
+      return Avx2_64_Float(_mm256_sub_pd(m_data, other.m_data));
+   }
+
+   inline Avx2_64_Float operator* (const Avx2_64_Float & other) const noexcept {
+      return Avx2_64_Float(_mm256_mul_pd(m_data, other.m_data));
+   }
+
+   inline Avx2_64_Float operator/ (const Avx2_64_Float & other) const noexcept {
+      return Avx2_64_Float(_mm256_div_pd(m_data, other.m_data));
+   }
+
+
+   inline Avx2_64_Float & operator+= (const Avx2_64_Float & other) noexcept {
+      *this = (*this) + other;
+      return *this;
+   }
+
+   inline Avx2_64_Float & operator-= (const Avx2_64_Float & other) noexcept {
+      *this = (*this) - other;
+      return *this;
+   }
+
+   inline Avx2_64_Float & operator*= (const Avx2_64_Float & other) noexcept {
+      *this = (*this) * other;
+      return *this;
+   }
+
+   inline Avx2_64_Float & operator/= (const Avx2_64_Float & other) noexcept {
+      *this = (*this) / other;
+      return *this;
+   }
+
+
+   friend inline Avx2_64_Float operator+ (const double val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) + other;
+   }
+
+   friend inline Avx2_64_Float operator- (const double val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) - other;
+   }
+
+   friend inline Avx2_64_Float operator* (const double val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) * other;
+   }
+
+   friend inline Avx2_64_Float operator/ (const double val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) / other;
+   }
+
+
+   friend inline Avx2_64_Float operator+ (const float val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) + other;
+   }
+
+   friend inline Avx2_64_Float operator- (const float val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) - other;
+   }
+
+   friend inline Avx2_64_Float operator* (const float val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) * other;
+   }
+
+   friend inline Avx2_64_Float operator/ (const float val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) / other;
+   }
+
+
+   inline static Avx2_64_Float Load(const T * const a) noexcept {
+      return Avx2_64_Float(_mm256_load_pd(a));
+   }
+
+   inline void Store(T * const a) const noexcept {
+      _mm256_store_pd(a, m_data);
+   }
+
+   inline static Avx2_64_Float Load(const T * const a, const TInt & i) noexcept {
+      // i is treated as signed, so we should only use the lower 63 bits otherwise we'll read from memory before a
+      return Avx2_64_Float(_mm256_i64gather_pd(a, i.m_data, sizeof(a[0])));
+   }
+
+   inline void Store(T * const a, const TInt & i) const noexcept {
+      alignas(k_cAlignment) TInt::T ints[k_cSIMDPack];
+      alignas(k_cAlignment) T floats[k_cSIMDPack];
+
+      i.Store(ints);
+      Store(floats);
+
+      a[ints[0]] = floats[0];
+      a[ints[1]] = floats[1];
+      a[ints[2]] = floats[2];
+      a[ints[3]] = floats[3];
+   }
+
+   template<typename TFunc>
+   friend inline Avx2_64_Float ApplyFunc(const TFunc & func, const Avx2_64_Float & val) noexcept {
+      alignas(k_cAlignment) T aTemp[k_cSIMDPack];
+      val.Store(aTemp);
+
+      aTemp[0] = func(aTemp[0]);
+      aTemp[1] = func(aTemp[1]);
+      aTemp[2] = func(aTemp[2]);
+      aTemp[3] = func(aTemp[3]);
+
+      return Load(aTemp);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func) noexcept {
+      func(0);
+      func(1);
+      func(2);
+      func(3);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Float & val0) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+
+      func(0, a0[0]);
+      func(1, a0[1]);
+      func(2, a0[2]);
+      func(3, a0[3]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Float & val0, const Avx2_64_Float & val1) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) T a1[k_cSIMDPack];
+      val1.Store(a1);
+
+      func(0, a0[0], a1[0]);
+      func(1, a0[1], a1[1]);
+      func(2, a0[2], a1[2]);
+      func(3, a0[3], a1[3]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Int & val0, const Avx2_64_Float & val1) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) T a1[k_cSIMDPack];
+      val1.Store(a1);
+
+      func(0, a0[0], a1[0]);
+      func(1, a0[1], a1[1]);
+      func(2, a0[2], a1[2]);
+      func(3, a0[3], a1[3]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Int & val0, const Avx2_64_Float & val1, const Avx2_64_Float & val2) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) T a1[k_cSIMDPack];
+      val1.Store(a1);
+      alignas(k_cAlignment) T a2[k_cSIMDPack];
+      val2.Store(a2);
+
+      func(0, a0[0], a1[0], a2[0]);
+      func(1, a0[1], a1[1], a2[1]);
+      func(2, a0[2], a1[2], a2[2]);
+      func(3, a0[3], a1[3], a2[3]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Int & val0, const Avx2_64_Float & val1, const Avx2_64_Float & val2, const Avx2_64_Float & val3) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) T a1[k_cSIMDPack];
+      val1.Store(a1);
+      alignas(k_cAlignment) T a2[k_cSIMDPack];
+      val2.Store(a2);
+      alignas(k_cAlignment) T a3[k_cSIMDPack];
+      val3.Store(a3);
+
+      func(0, a0[0], a1[0], a2[0], a3[0]);
+      func(1, a0[1], a1[1], a2[1], a3[1]);
+      func(2, a0[2], a1[2], a2[2], a3[2]);
+      func(3, a0[3], a1[3], a2[3], a3[3]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Int & val0, const Avx2_64_Int & val1, const Avx2_64_Float & val2, const Avx2_64_Float & val3) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) TInt::T a1[k_cSIMDPack];
+      val1.Store(a1);
+      alignas(k_cAlignment) T a2[k_cSIMDPack];
+      val2.Store(a2);
+      alignas(k_cAlignment) T a3[k_cSIMDPack];
+      val3.Store(a3);
+
+      func(0, a0[0], a1[0], a2[0], a3[0]);
+      func(1, a0[1], a1[1], a2[1], a3[1]);
+      func(2, a0[2], a1[2], a2[2], a3[2]);
+      func(3, a0[3], a1[3], a2[3], a3[3]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Int & val0, const Avx2_64_Int & val1, const Avx2_64_Float & val2, const Avx2_64_Float & val3, const Avx2_64_Float & val4) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) TInt::T a1[k_cSIMDPack];
+      val1.Store(a1);
+      alignas(k_cAlignment) T a2[k_cSIMDPack];
+      val2.Store(a2);
+      alignas(k_cAlignment) T a3[k_cSIMDPack];
+      val3.Store(a3);
+      alignas(k_cAlignment) T a4[k_cSIMDPack];
+      val4.Store(a4);
+
+      func(0, a0[0], a1[0], a2[0], a3[0], a4[0]);
+      func(1, a0[1], a1[1], a2[1], a3[1], a4[1]);
+      func(2, a0[2], a1[2], a2[2], a3[2], a4[2]);
+      func(3, a0[3], a1[3], a2[3], a3[3], a4[3]);
+   }
+
+   friend inline Avx2_64_Float IfLess(const Avx2_64_Float & cmp1, const Avx2_64_Float & cmp2, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept {
+      const __m256d mask = _mm256_cmp_pd(cmp1.m_data, cmp2.m_data, _CMP_LT_OQ);
+      return Avx2_64_Float(_mm256_blendv_pd(falseVal.m_data, trueVal.m_data, mask));
+   }
+
+   friend inline Avx2_64_Float IfEqual(const Avx2_64_Float & cmp1, const Avx2_64_Float & cmp2, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept {
+      const __m256d mask = _mm256_cmp_pd(cmp1.m_data, cmp2.m_data, _CMP_EQ_OQ);
+      return Avx2_64_Float(_mm256_blendv_pd(falseVal.m_data, trueVal.m_data, mask));
+   }
+
+   friend inline Avx2_64_Float IfNaN(const Avx2_64_Float & cmp, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept {
+      // rely on the fact that a == a can only be false if a is a NaN
+      return IfEqual(cmp, cmp, falseVal, trueVal);
+   }
+
+   friend inline Avx2_64_Float IfEqual(const Avx2_64_Int & cmp1, const Avx2_64_Int & cmp2, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept {
+      const __m256i mask = _mm256_cmpeq_epi64(cmp1.m_data, cmp2.m_data);
+      return Avx2_64_Float(_mm256_blendv_pd(falseVal.m_data, trueVal.m_data, _mm256_castsi256_pd(mask)));
+   }
+
+   friend inline Avx2_64_Float Abs(const Avx2_64_Float & val) noexcept {
+      return Avx2_64_Float(_mm256_andnot_pd(_mm256_set1_pd(-0.0), val.m_data));
+   }
+
+   friend inline Avx2_64_Float FastApproxReciprocal(const Avx2_64_Float & val) noexcept {
+      // AVX2 has no approximate reciprocal for doubles
+      return Avx2_64_Float(1.0) / val;
+   }
+
+   friend inline Avx2_64_Float FastApproxDivide(const Avx2_64_Float & dividend, const Avx2_64_Float & divisor) noexcept {
+      return dividend / divisor;
+   }
+
+   friend inline Avx2_64_Float FusedMultiplyAdd(const Avx2_64_Float & mul1, const Avx2_64_Float & mul2, const Avx2_64_Float & add) noexcept {
+      // For AVX, Intel initially built FMA3, and AMD built FMA4, but AMD later depricated FMA4 and supported
+      // FMA3 by the time AVX2 rolled out.  We only support AVX2 and above (not AVX) since we benefit from the
+      // integer parts of AVX2. Just to be sure though we also check the cpuid for FMA3 during init
+      return Avx2_64_Float(_mm256_fmadd_pd(mul1.m_data, mul2.m_data, add.m_data));
+   }
+
+   friend inline Avx2_64_Float FusedNegateMultiplyAdd(const Avx2_64_Float & mul1, const Avx2_64_Float & mul2, const Avx2_64_Float & add) noexcept {
+      // For AVX, Intel initially built FMA3, and AMD built FMA4, but AMD later depricated FMA4 and supported
+      // FMA3 by the time AVX2 rolled out.  We only support AVX2 and above (not AVX) since we benefit from the
+      // integer parts of AVX2. Just to be sure though we also check the cpuid for FMA3 during init
+
+      // equivalent to: -(mul1 * mul2) + add
+      return Avx2_64_Float(_mm256_fnmadd_pd(mul1.m_data, mul2.m_data, add.m_data));
+   }
+
+   friend inline Avx2_64_Float Sqrt(const Avx2_64_Float & val) noexcept {
+      return Avx2_64_Float(_mm256_sqrt_pd(val.m_data));
+   }
+
+   friend inline Avx2_64_Float Round(const Avx2_64_Float & val) noexcept {
+      return Avx2_64_Float(_mm256_round_pd(val.m_data, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+   }
+
+   friend inline Avx2_64_Float Ldexp(const Avx2_64_Float & val, const Avx2_64_Float & exponent) noexcept {
+      // the result can be subnormal even when 2^exponent is not representable, so we apply the exponent in two
+      // halves that are each within the normal range.  AVX2 cannot convert doubles to 64 bit integers, but adding
+      // 1.5 * 2^52 to an integral double leaves the integer in the low bits
+      const __m256d magic = _mm256_set1_pd(6755399441055744.0);
+      const __m256d half = _mm256_round_pd(_mm256_mul_pd(exponent.m_data, _mm256_set1_pd(0.5)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+      const __m256i bias = _mm256_set1_epi64x(1023);
+      const __m256i scale1 = _mm256_slli_epi64(_mm256_add_epi64(_mm256_castpd_si256(_mm256_add_pd(half, magic)), bias), 52);
+      const __m256i scale2 = _mm256_slli_epi64(_mm256_add_epi64(_mm256_castpd_si256(_mm256_add_pd(_mm256_sub_pd(exponent.m_data, half), magic)), bias), 52);
+      return Avx2_64_Float(_mm256_mul_pd(_mm256_mul_pd(val.m_data, _mm256_castsi256_pd(scale1)), _mm256_castsi256_pd(scale2)));
+   }
+
+   friend inline Avx2_64_Float GetExponent(const Avx2_64_Float & val) noexcept {
+      // the biased exponent has 11 bits, so we convert it to a double by placing it in the mantissa of 2^52
+      const __m256i biased = _mm256_srli_epi64(_mm256_castpd_si256(val.m_data), 52);
+      const __m256d combined = _mm256_castsi256_pd(_mm256_or_si256(biased, _mm256_castpd_si256(_mm256_set1_pd(4503599627370496.0))));
+      return Avx2_64_Float(_mm256_sub_pd(combined, _mm256_set1_pd(4503599627370496.0 + 1023.0)));
+   }
+
+   friend inline Avx2_64_Float GetMantissa(const Avx2_64_Float & val) noexcept {
+      const __m256i bits = _mm256_and_si256(_mm256_castpd_si256(val.m_data), _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+      return Avx2_64_Float(_mm256_castsi256_pd(_mm256_or_si256(bits, _mm256_set1_epi64x(0x3FF0000000000000LL))));
+   }
+
+   friend inline Avx2_64_Float Exp(const Avx2_64_Float & val) noexcept {
+      return ExpAccurate(val);
+   }
+
+   friend inline Avx2_64_Float Log(const Avx2_64_Float & val) noexcept {
+      return LogAccurate(val);
+   }
+
+   template<
+      bool bDisableApprox,
+      bool bNegateInput = false,
+      bool bNaNPossible = true,
+      bool bUnderflowPossible = true,
+      bool bOverflowPossible = true,
+      bool bSpecialCaseZero = false,
+      typename std::enable_if<bDisableApprox, int>::type = 0
+   >
+   static inline Avx2_64_Float ApproxExp(
+      const Avx2_64_Float & val, 
+      const int32_t addExpSchraudolphTerm = k_expTermZeroMeanErrorForSoftmaxWithZeroedLogit
+   ) noexcept {
+      UNUSED(addExpSchraudolphTerm);
+      return Exp(bNegateInput ? -val : val);
+   }
+
+   template<
+      bool bDisableApprox,
+      bool bNegateInput = false,
+      bool bNaNPossible = true,
+      bool bUnderflowPossible = true,
+      bool bOverflowPossible = true,
+      bool bSpecialCaseZero = false,
+      typename std::enable_if<!bDisableApprox, int>::type = 0
+   >
+   static inline Avx2_64_Float ApproxExp(
+      const Avx2_64_Float & val, 
+      const int32_t addExpSchraudolphTerm = k_expTermZeroMeanErrorForSoftmaxWithZeroedLogit
+   ) noexcept {
+      // The Schraudolph trick in the float32 zones writes directly into the float exponent bits.  We keep the
+      // double exponent layout by applying the same scalar approximation as Cpu_64 to each lane, which keeps
+      // the results of this zone identical to Cpu_64
+      return ApplyFunc([addExpSchraudolphTerm](T x) {
+         return ExpApproxSchraudolph<
+            bNegateInput, bNaNPossible, bUnderflowPossible, bOverflowPossible, bSpecialCaseZero
+         >(x, addExpSchraudolphTerm);
+      }, val);
+   }
+
+
+   template<
+      bool bDisableApprox,
+      bool bNegateOutput = false,
+      bool bNaNPossible = true,
+      bool bNegativePossible = false,
+      bool bZeroPossible = false, // if false, positive zero returns a big negative number, negative zero returns a big positive number
+      bool bPositiveInfinityPossible = false, // if false, +inf returns a big positive number.  If val can be a double that is above the largest representable float, then setting this is necessary to avoid undefined behavior
+      typename std::enable_if<bDisableApprox, int>::type = 0
+   >
+   static inline Avx2_64_Float ApproxLog(
+      const Avx2_64_Float & val, 
+      const float addLogSchraudolphTerm = k_logTermLowerBoundInputCloseToOne
+   ) noexcept {
+      UNUSED(addLogSchraudolphTerm);
+      Avx2_64_Float ret = Log(val);
+      return bNegateOutput ? -ret : ret;
+   }
+
+   template<
+      bool bDisableApprox,
+      bool bNegateOutput = false,
+      bool bNaNPossible = true,
+      bool bNegativePossible = false,
+      bool bZeroPossible = false, // if false, positive zero returns a big negative number, negative zero returns a big positive number
+      bool bPositiveInfinityPossible = false, // if false, +inf returns a big positive number.  If val can be a double that is above the largest representable float, then setting this is necessary to avoid undefined behavior
+      typename std::enable_if<!bDisableApprox, int>::type = 0
+   >
+   static inline Avx2_64_Float ApproxLog(
+      const Avx2_64_Float & val, 
+      const float addLogSchraudolphTerm = k_logTermLowerBoundInputCloseToOne
+   ) noexcept {
+      return ApplyFunc([addLogSchraudolphTerm](T x) {
+         return LogApproxSchraudolph<
+            bNegateOutput, bNaNPossible, bNegativePossible, bZeroPossible, bPositiveInfinityPossible
+         >(x, addLogSchraudolphTerm);
+      }, val);
+   }
+
+   friend inline T Sum(const Avx2_64_Float & val) noexcept {
+      const __m128d vlow = _mm256_castpd256_pd128(val.m_data);
+      const __m128d vhigh = _mm256_extractf128_pd(val.m_data, 1);
+      const __m128d sum = _mm_add_pd(vlow, vhigh);
+      return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+   }
+
+
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorApplyUpdate(const Objective * const pObjective, ApplyUpdateBridge * const pData) noexcept {
+      RemoteApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, cCompilerPack>(pObjective, pData);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoosting<Avx2_64_Float, bHessian, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingBags(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoostingBags<Avx2_64_Float, bHessian, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bReplication, typename TQuantized, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingQuantized(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoostingQuantized<Avx2_64_Float, bHessian, bReplication, TQuantized, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bWeight, size_t cCompilerScores, size_t cCompilerDimensions>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteraction(BinSumsInteractionBridge * const pParams) noexcept {
+      RemoteBinSumsInteraction<Avx2_64_Float, bHessian, bWeight, cCompilerScores, cCompilerDimensions>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bWeight, size_t cCompilerScores>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteractionPartners(BinSumsInteractionBridge * const pParams) noexcept {
+      RemoteBinSumsInteractionPartners<Avx2_64_Float, bHessian, bWeight, cCompilerScores>(pParams);
+      return Error_None;
+   }
+
+
+private:
+
+   inline Avx2_64_Float(const TPack & data) noexcept : m_data(data) {
+   }
+
+   TPack m_data;
+};
+static_assert(std::is_standard_layout<Avx2_64_Float>::value && std::is_trivially_copyable<Avx2_64_Float>::value,
+   "This allows offsetof, memcpy, memset, inter-language, GPU and cross-machine use where needed");
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm ApplyUpdate_Avx2_64(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   ApplyUpdateBridge * const pData
+) {
+   const Objective * const pObjective = static_cast<const Objective *>(pObjectiveWrapper->m_pObjective);
+   const APPLY_UPDATE_CPP pApplyUpdateCpp =
+      (static_cast<FunctionPointersCpp*>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pApplyUpdateCpp;
+
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pData->m_aMulticlassMidwayTemp));
+   EBM_ASSERT(IsAligned(pData->m_aUpdateTensorScores));
+   EBM_ASSERT(IsAligned(pData->m_aPacked));
+   EBM_ASSERT(IsAligned(pData->m_aTargets));
+   EBM_ASSERT(IsAligned(pData->m_aWeights));
+   EBM_ASSERT(IsAligned(pData->m_aSampleScores));
+   EBM_ASSERT(IsAligned(pData->m_aGradientsAndHessians));
+
+   return (*pApplyUpdateCpp)(pObjective, pData);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsBoosting_Avx2_64(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   BinSumsBoostingBridge * const pParams
+) {
+   const BIN_SUMS_BOOSTING_CPP pBinSumsBoostingCpp =
+      (static_cast<FunctionPointersCpp *>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pBinSumsBoostingCpp;
+
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
+   EBM_ASSERT(IsAligned(pParams->m_aWeights));
+   EBM_ASSERT(IsAligned(pParams->m_pCountOccurrences));
+   EBM_ASSERT(IsAligned(pParams->m_aPacked));
+   EBM_ASSERT(IsAligned(pParams->m_aFastBins));
+
+   return (*pBinSumsBoostingCpp)(pParams);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsInteraction_Avx2_64(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   BinSumsInteractionBridge * const pParams
+) {
+   const BIN_SUMS_INTERACTION_CPP pBinSumsInteractionCpp =
+      (static_cast<FunctionPointersCpp *>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pBinSumsInteractionCpp;
+
+#ifndef NDEBUG
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
+   EBM_ASSERT(IsAligned(pParams->m_aWeights));
+   EBM_ASSERT(IsAligned(pParams->m_aFastBins));
+   for(size_t iDebug = 0; iDebug < pParams->m_cRuntimeRealDimensions; ++iDebug) {
+      EBM_ASSERT(IsAligned(pParams->m_aaPacked[iDebug]));
+   }
+#endif // NDEBUG
+
+   return (*pBinSumsInteractionCpp)(pParams);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm CreateObjective_Avx2_64(
+   const Config * const pConfig,
+   const char * const sObjective,
+   const char * const sObjectiveEnd,
+   ObjectiveWrapper * const pObjectiveWrapperOut
+) {
+   pObjectiveWrapperOut->m_pApplyUpdateC = ApplyUpdate_Avx2_64;
+   pObjectiveWrapperOut->m_pBinSumsBoostingC = BinSumsBoosting_Avx2_64;
+   pObjectiveWrapperOut->m_pBinSumsInteractionC = BinSumsInteraction_Avx2_64;
+   ErrorEbm error = ComputeWrapper<Avx2_64_Float>::FillWrapper(pObjectiveWrapperOut);
+   if(Error_None != error) {
+      return error;
+   }
+   return Objective::CreateObjective<Avx2_64_Float>(pConfig, sObjective, sObjectiveEnd, pObjectiveWrapperOut);
+}
+
+} // DEFINED_ZONE_NAME
+
+#endif // BRIDGE_AVX2_32
\ No newline at end of file
@@ -9,7 +9,18 @@
 #include <cmath> // exp, log
 #include <limits> // numeric_limits
 #include <type_traits> // is_unsigned
+#include <string.h> // memset
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC 12 reports the self initialized __Y of _mm512_undefined_* in avx512fintrin.h as uninitialized wherever an
+// unmasked AVX-512 intrinsic is inlined.  The warning points into the header, so it is silenced around the include
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
 #include <immintrin.h> // SIMD.  Do not include in pch.hpp!
+#pragma GCC diagnostic pop
+#else // GCC
+#include <immintrin.h> // SIMD.  Do not include in pch.hpp!
+#endif // GCC
 
 #include "libebm.h"
 #include "logging.h"
@@ -26,6 +37,7 @@
 #include "Objective.hpp"
 
 #include "approximate_math.hpp"
+#include "accurate_math.hpp"
 #include "compute_wrapper.hpp"
 
 namespace DEFINED_ZONE_NAME {
@@ -40,6 +52,549 @@ static constexpr size_t k_cAlignment = 64;
 
 struct alignas(k_cAlignment) Avx512f_32_Float;
 
+// For a single score the float32 bins are laid out as [count, weight, gradient, hessian] with 4 bytes per field.
+// The vectorized BinSumsBoosting below reads and writes those fields with gathers and scatters at these offsets.
+static constexpr int k_iBinOffsetCount = 0;
+static constexpr int k_iBinOffsetWeight = 4;
+static constexpr int k_iBinOffsetGradient = 8;
+static constexpr int k_iBinOffsetHessian = 12;
+static_assert(GetBinSize<float, uint32_t>(false, size_t { 1 }) == size_t { 12 }, "unexpected Bin layout");
+static_assert(GetBinSize<float, uint32_t>(true, size_t { 1 }) == size_t { 16 }, "unexpected Bin layout");
+
+// When the feature has few enough bins we give each SIMD lane its own private copy of the histogram so that lanes
+// never collide, and then sum the 16 copies at the end.  With 5 bits there are at most 32 bins, so the 4 fields
+// across the 16 lanes occupy 8KB of stack, which stays resident in L1 alongside the streaming inputs.
+static constexpr int k_cBitsPrivateHistogramsMax = 5;
+
+template<bool bHessian>
+INLINE_ALWAYS static void AccumulateBinsAvx512f(
+   unsigned char * const pBase,
+   const __mmask16 mask,
+   const __m512i iBin,
+   const __m512i cOccurences,
+   const __m512 weight,
+   const __m512 gradient,
+   const __m512 hessian
+) noexcept {
+   // iBin holds byte offsets, so the gathers and scatters use a scale of 1
+   __m512i cBinSamples = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), mask, iBin, pBase + k_iBinOffsetCount, 1);
+   cBinSamples = _mm512_add_epi32(cBinSamples, cOccurences);
+   _mm512_mask_i32scatter_epi32(pBase + k_iBinOffsetCount, mask, iBin, cBinSamples, 1);
+
+   __m512 binWeight = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, iBin, pBase + k_iBinOffsetWeight, 1);
+   binWeight = _mm512_add_ps(binWeight, weight);
+   _mm512_mask_i32scatter_ps(pBase + k_iBinOffsetWeight, mask, iBin, binWeight, 1);
+
+   __m512 binGrad = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, iBin, pBase + k_iBinOffsetGradient, 1);
+   binGrad = _mm512_add_ps(binGrad, gradient);
+   _mm512_mask_i32scatter_ps(pBase + k_iBinOffsetGradient, mask, iBin, binGrad, 1);
+
+   if(bHessian) {
+      __m512 binHess = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, iBin, pBase + k_iBinOffsetHessian, 1);
+      binHess = _mm512_add_ps(binHess, hessian);
+      _mm512_mask_i32scatter_ps(pBase + k_iBinOffsetHessian, mask, iBin, binHess, 1);
+   }
+}
+
+// This replaces the serialized per-lane updates in the generic single score bit packed BinSumsBoostingInternal.
+// With many bins, AVX512CD's vpconflictd tells us which lanes share a bin with an earlier lane, and we
+// gather/add/scatter in rounds where each round only contains lanes whose earlier conflicting lanes are already
+// done.  Within a bin the samples are therefore added in the same order as the scalar code, so the sums are
+// bit-identical to it.  With few bins we use lane-private histograms instead, which needs no conflict detection
+// but changes the order of the float additions.
+template<bool bHessian, bool bWeight, bool bReplication, bool bPrivate>
+static void BinSumsBoostingScatterAvx512f(BinSumsBoostingBridge * const pParams) noexcept {
+   static_assert(bWeight || !bReplication, "bReplication cannot be true if bWeight is false");
+   static constexpr int k_cLanes = 16;
+
+   EBM_ASSERT(nullptr != pParams);
+   EBM_ASSERT(1 <= pParams->m_cSamples);
+   EBM_ASSERT(0 == pParams->m_cSamples % size_t { k_cLanes });
+   EBM_ASSERT(nullptr != pParams->m_aGradientsAndHessians);
+   EBM_ASSERT(nullptr != pParams->m_aFastBins);
+   EBM_ASSERT(size_t { 1 } == pParams->m_cScores);
+
+   auto * const aBins = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<float, uint32_t, bHessian, size_t { 1 }>();
+   EBM_ASSERT(reinterpret_cast<const unsigned char *>(aBins->GetGradientPairs()) - 
+      reinterpret_cast<const unsigned char *>(aBins) == k_iBinOffsetGradient);
+
+   const size_t cSamples = pParams->m_cSamples;
+
+   const float * pGradientAndHessian = reinterpret_cast<const float *>(pParams->m_aGradientsAndHessians);
+   const float * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cSamples;
+
+   const int cItemsPerBitPack = pParams->m_cPack;
+   EBM_ASSERT(k_cItemsPerBitPackNone != cItemsPerBitPack);
+   EBM_ASSERT(1 <= cItemsPerBitPack);
+   EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(uint32_t));
+
+   const int cBitsPerItemMax = GetCountBits<uint32_t>(cItemsPerBitPack);
+   EBM_ASSERT(1 <= cBitsPerItemMax);
+   EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(uint32_t));
+   EBM_ASSERT(!bPrivate || cBitsPerItemMax <= k_cBitsPrivateHistogramsMax);
+
+   int cShift = static_cast<int>(((cSamples >> 4) - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
+   const int cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+
+   const __m512i maskBits = _mm512_set1_epi32(static_cast<int>(MakeLowMask<uint32_t>(cBitsPerItemMax)));
+   const __m512i cBytesPerBin = _mm512_set1_epi32(static_cast<int>(GetBinSize<float, uint32_t>(bHessian, size_t { 1 })));
+
+   const uint32_t * pInputData = reinterpret_cast<const uint32_t *>(pParams->m_aPacked);
+   EBM_ASSERT(nullptr != pInputData);
+
+   const float * pWeight;
+   const uint8_t * pCountOccurrences;
+   if(bWeight) {
+      pWeight = reinterpret_cast<const float *>(pParams->m_aWeights);
+      EBM_ASSERT(nullptr != pWeight);
+      if(bReplication) {
+         pCountOccurrences = pParams->m_pCountOccurrences;
+         EBM_ASSERT(nullptr != pCountOccurrences);
+      }
+   }
+
+   // each private histogram field is stored bin major, so [iBin * 16 + iLane] and the 16 lanes of a bin form one
+   // register for the final reduction
+   static constexpr size_t k_cPrivateItems = size_t { k_cLanes } << (bPrivate ? k_cBitsPrivateHistogramsMax : 0);
+   alignas(k_cAlignment) uint32_t aPrivateCounts[k_cPrivateItems];
+   alignas(k_cAlignment) float aPrivateWeights[k_cPrivateItems];
+   alignas(k_cAlignment) float aPrivateGradients[k_cPrivateItems];
+   alignas(k_cAlignment) float aPrivateHessians[bHessian ? k_cPrivateItems : size_t { 1 }];
+   const __m512i iLanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+   __m512i iBinMax = _mm512_setzero_si512();
+   if(bPrivate) {
+      const size_t cBytesUsed = sizeof(aPrivateCounts[0]) * (size_t { k_cLanes } << cBitsPerItemMax);
+      memset(aPrivateCounts, 0, cBytesUsed);
+      memset(aPrivateWeights, 0, cBytesUsed);
+      memset(aPrivateGradients, 0, cBytesUsed);
+      if(bHessian) {
+         memset(aPrivateHessians, 0, cBytesUsed);
+      }
+   }
+
+   const __m512i one = _mm512_set1_epi32(1);
+   do {
+      const __m512i iTensorBinCombined = _mm512_load_si512(pInputData);
+      pInputData += k_cLanes;
+      do {
+         __m512 weight;
+         __m512i cOccurences = one;
+         if(bWeight) {
+            weight = _mm512_load_ps(pWeight);
+            pWeight += k_cLanes;
+            if(bReplication) {
+               cOccurences = _mm512_cvtepu8_epi32(_mm_load_si128(reinterpret_cast<const __m128i *>(pCountOccurrences)));
+               pCountOccurrences += k_cLanes;
+            }
+         } else {
+            weight = _mm512_set1_ps(1.0f);
+         }
+
+         __m512 gradient = _mm512_load_ps(pGradientAndHessian);
+         __m512 hessian = _mm512_setzero_ps();
+         if(bHessian) {
+            hessian = _mm512_load_ps(&pGradientAndHessian[k_cLanes]);
+         }
+         pGradientAndHessian += (bHessian ? size_t { 2 } : size_t { 1 }) * k_cLanes;
+
+         if(bWeight) {
+            gradient = _mm512_mul_ps(gradient, weight);
+            if(bHessian) {
+               hessian = _mm512_mul_ps(hessian, weight);
+            }
+         }
+
+         const __m512i iTensorBin = _mm512_and_si512(_mm512_srli_epi32(iTensorBinCombined, static_cast<unsigned int>(cShift)), maskBits);
+
+         if(bPrivate) {
+            iBinMax = _mm512_max_epu32(iBinMax, iTensorBin);
+            const __m512i iPrivate = _mm512_add_epi32(_mm512_slli_epi32(iTensorBin, 4), iLanes);
+
+            // every lane owns a distinct slot, so there is nothing to serialize
+            __m512i cBinSamples = _mm512_i32gather_epi32(iPrivate, aPrivateCounts, 4);
+            _mm512_i32scatter_epi32(aPrivateCounts, iPrivate, _mm512_add_epi32(cBinSamples, cOccurences), 4);
+            __m512 binWeight = _mm512_i32gather_ps(iPrivate, aPrivateWeights, 4);
+            _mm512_i32scatter_ps(aPrivateWeights, iPrivate, _mm512_add_ps(binWeight, weight), 4);
+            __m512 binGrad = _mm512_i32gather_ps(iPrivate, aPrivateGradients, 4);
+            _mm512_i32scatter_ps(aPrivateGradients, iPrivate, _mm512_add_ps(binGrad, gradient), 4);
+            if(bHessian) {
+               __m512 binHess = _mm512_i32gather_ps(iPrivate, aPrivateHessians, 4);
+               _mm512_i32scatter_ps(aPrivateHessians, iPrivate, _mm512_add_ps(binHess, hessian), 4);
+            }
+         } else {
+            // bit j of lane i in conflicts is set if lane j < i has the same bin as lane i
+            const __m512i conflicts = _mm512_conflict_epi32(iTensorBin);
+            const __m512i iByte = _mm512_mullo_epi32(iTensorBin, cBytesPerBin);
+
+            __mmask16 todo = __mmask16 { 0xFFFF };
+            do {
+               // the lanes that are still todo and have no earlier lane for the same bin still todo
+               const __mmask16 ready = _mm512_mask_testn_epi32_mask(todo, conflicts, _mm512_set1_epi32(static_cast<int>(todo)));
+               AccumulateBinsAvx512f<bHessian>(
+                  reinterpret_cast<unsigned char *>(aBins), ready, iByte, cOccurences, weight, gradient, hessian);
+               todo = static_cast<__mmask16>(todo & ~ready);
+            } while(0 != todo);
+         }
+
+         cShift -= cBitsPerItemMax;
+      } while(0 <= cShift);
+      cShift = cShiftReset;
+   } while(pGradientsAndHessiansEnd != pGradientAndHessian);
+
+   if(bPrivate) {
+      // we only touched bins up to the highest index seen, and the real histogram can be shorter than
+      // 2^cBitsPerItemMax, so stop there to avoid writing past the end of aFastBins
+      const size_t cBinsUsed = static_cast<size_t>(_mm512_reduce_max_epu32(iBinMax)) + size_t { 1 };
+      for(size_t iBin = 0; iBin < cBinsUsed; ++iBin) {
+         const size_t iFirst = iBin * size_t { k_cLanes };
+         auto * const pBin = IndexBin(aBins, iBin * GetBinSize<float, uint32_t>(bHessian, size_t { 1 }));
+         auto * const pGradientPair = pBin->GetGradientPairs();
+         pBin->SetCountSamples(pBin->GetCountSamples() + 
+            static_cast<uint32_t>(_mm512_reduce_add_epi32(_mm512_load_si512(&aPrivateCounts[iFirst]))));
+         pBin->SetWeight(pBin->GetWeight() + _mm512_reduce_add_ps(_mm512_load_ps(&aPrivateWeights[iFirst])));
+         pGradientPair->m_sumGradients += _mm512_reduce_add_ps(_mm512_load_ps(&aPrivateGradients[iFirst]));
+         if(bHessian) {
+            pGradientPair->SetHess(pGradientPair->GetHess() + _mm512_reduce_add_ps(_mm512_load_ps(&aPrivateHessians[iFirst])));
+         }
+      }
+   }
+}
+
+// Bins several inner bags in one pass over the data like the generic BinSumsBoostingBagsInternal.  The packed bins, 
+// the gradients and hessians, and with many bins the conflict rounds are computed once per pack and shared by all 
+// the bags.  Each bag is then accumulated exactly like BinSumsBoostingScatterAvx512f accumulates a single weighted 
+// and replicated bag, so the sums do not depend on how many bags are binned together.  With few bins every bag
+// gets its own lane-private histograms, which for 8 bags is 64KB of stack.
+template<bool bHessian, bool bPrivate>
+static void BinSumsBoostingBagsScatterAvx512f(BinSumsBoostingBridge * const pParams) noexcept {
+   static constexpr int k_cLanes = 16;
+
+   EBM_ASSERT(nullptr != pParams);
+   EBM_ASSERT(1 <= pParams->m_cSamples);
+   EBM_ASSERT(0 == pParams->m_cSamples % size_t { k_cLanes });
+   EBM_ASSERT(nullptr != pParams->m_aGradientsAndHessians);
+   EBM_ASSERT(size_t { 1 } == pParams->m_cScores);
+   EBM_ASSERT(size_t { 2 } <= pParams->m_cBags);
+   EBM_ASSERT(pParams->m_cBags <= k_cBagsPerPassMax);
+
+   const size_t cBags = pParams->m_cBags;
+
+   unsigned char * apBins[k_cBagsPerPassMax];
+   const float * apWeights[k_cBagsPerPassMax];
+   const uint8_t * apCountOccurrences[k_cBagsPerPassMax];
+   size_t iBagInit = 0;
+   do {
+      apBins[iBagInit] = reinterpret_cast<unsigned char *>(pParams->m_aaBagFastBins[iBagInit]);
+      apWeights[iBagInit] = reinterpret_cast<const float *>(pParams->m_aaBagWeights[iBagInit]);
+      apCountOccurrences[iBagInit] = pParams->m_apBagCountOccurrences[iBagInit];
+      EBM_ASSERT(nullptr != apBins[iBagInit]);
+      EBM_ASSERT(nullptr != apWeights[iBagInit]);
+      EBM_ASSERT(nullptr != apCountOccurrences[iBagInit]);
+      ++iBagInit;
+   } while(cBags != iBagInit);
+
+   const size_t cSamples = pParams->m_cSamples;
+
+   const float * pGradientAndHessian = reinterpret_cast<const float *>(pParams->m_aGradientsAndHessians);
+   const float * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cSamples;
+
+   const int cItemsPerBitPack = pParams->m_cPack;
+   EBM_ASSERT(k_cItemsPerBitPackNone != cItemsPerBitPack);
+   EBM_ASSERT(1 <= cItemsPerBitPack);
+   EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(uint32_t));
+
+   const int cBitsPerItemMax = GetCountBits<uint32_t>(cItemsPerBitPack);
+   EBM_ASSERT(1 <= cBitsPerItemMax);
+   EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(uint32_t));
+   EBM_ASSERT(!bPrivate || cBitsPerItemMax <= k_cBitsPrivateHistogramsMax);
+
+   int cShift = static_cast<int>(((cSamples >> 4) - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
+   const int cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+
+   const __m512i maskBits = _mm512_set1_epi32(static_cast<int>(MakeLowMask<uint32_t>(cBitsPerItemMax)));
+   const __m512i cBytesPerBin = _mm512_set1_epi32(static_cast<int>(GetBinSize<float, uint32_t>(bHessian, size_t { 1 })));
+
+   const uint32_t * pInputData = reinterpret_cast<const uint32_t *>(pParams->m_aPacked);
+   EBM_ASSERT(nullptr != pInputData);
+
+   static constexpr size_t k_cPrivateItems = size_t { k_cLanes } << (bPrivate ? k_cBitsPrivateHistogramsMax : 0);
+   static constexpr size_t k_cPrivateBags = bPrivate ? k_cBagsPerPassMax : size_t { 1 };
+   alignas(k_cAlignment) uint32_t aaPrivateCounts[k_cPrivateBags][k_cPrivateItems];
+   alignas(k_cAlignment) float aaPrivateWeights[k_cPrivateBags][k_cPrivateItems];
+   alignas(k_cAlignment) float aaPrivateGradients[k_cPrivateBags][k_cPrivateItems];
+   alignas(k_cAlignment) float aaPrivateHessians[bHessian ? k_cPrivateBags : size_t { 1 }][bHessian ? k_cPrivateItems : size_t { 1 }];
+   const __m512i iLanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+   __m512i iBinMax = _mm512_setzero_si512();
+   if(bPrivate) {
+      const size_t cBytesUsed = sizeof(aaPrivateCounts[0][0]) * (size_t { k_cLanes } << cBitsPerItemMax);
+      for(size_t iBag = 0; iBag < cBags; ++iBag) {
+         memset(aaPrivateCounts[iBag], 0, cBytesUsed);
+         memset(aaPrivateWeights[iBag], 0, cBytesUsed);
+         memset(aaPrivateGradients[iBag], 0, cBytesUsed);
+         if(bHessian) {
+            memset(aaPrivateHessians[iBag], 0, cBytesUsed);
+         }
+      }
+   }
+
+   // the weights and occurrences of all bags are indexed by the same sample offset
+   size_t iSample = 0;
+   do {
+      const __m512i iTensorBinCombined = _mm512_load_si512(pInputData);
+      pInputData += k_cLanes;
+      do {
+         const __m512 gradient = _mm512_load_ps(pGradientAndHessian);
+         __m512 hessian = _mm512_setzero_ps();
+         if(bHessian) {
+            hessian = _mm512_load_ps(&pGradientAndHessian[k_cLanes]);
+         }
+         pGradientAndHessian += (bHessian ? size_t { 2 } : size_t { 1 }) * k_cLanes;
+
+         const __m512i iTensorBin = _mm512_and_si512(_mm512_srli_epi32(iTensorBinCombined, static_cast<unsigned int>(cShift)), maskBits);
+
+         __m512i iPrivate = _mm512_setzero_si512();
+         __m512i iByte = _mm512_setzero_si512();
+         __mmask16 aReady[k_cLanes];
+         int cRounds = 0;
+         if(bPrivate) {
+            iBinMax = _mm512_max_epu32(iBinMax, iTensorBin);
+            iPrivate = _mm512_add_epi32(_mm512_slli_epi32(iTensorBin, 4), iLanes);
+         } else {
+            // the bags share their bins, so the conflict rounds of BinSumsBoostingScatterAvx512f are the same for all
+            const __m512i conflicts = _mm512_conflict_epi32(iTensorBin);
+            iByte = _mm512_mullo_epi32(iTensorBin, cBytesPerBin);
+
+            __mmask16 todo = __mmask16 { 0xFFFF };
+            do {
+               const __mmask16 ready = _mm512_mask_testn_epi32_mask(todo, conflicts, _mm512_set1_epi32(static_cast<int>(todo)));
+               aReady[cRounds] = ready;
+               ++cRounds;
+               todo = static_cast<__mmask16>(todo & ~ready);
+            } while(0 != todo);
+         }
+
+         size_t iBag = 0;
+         do {
+            const __m512 weight = _mm512_load_ps(&apWeights[iBag][iSample]);
+            const __m512i cOccurences = _mm512_cvtepu8_epi32(
+               _mm_load_si128(reinterpret_cast<const __m128i *>(&apCountOccurrences[iBag][iSample])));
+            const __m512 gradientWeighted = _mm512_mul_ps(gradient, weight);
+            __m512 hessianWeighted = hessian;
+            if(bHessian) {
+               hessianWeighted = _mm512_mul_ps(hessian, weight);
+            }
+
+            if(bPrivate) {
+               uint32_t * const aPrivateCounts = aaPrivateCounts[iBag];
+               float * const aPrivateWeights = aaPrivateWeights[iBag];
+               float * const aPrivateGradients = aaPrivateGradients[iBag];
+
+               __m512i cBinSamples = _mm512_i32gather_epi32(iPrivate, aPrivateCounts, 4);
+               _mm512_i32scatter_epi32(aPrivateCounts, iPrivate, _mm512_add_epi32(cBinSamples, cOccurences), 4);
+               __m512 binWeight = _mm512_i32gather_ps(iPrivate, aPrivateWeights, 4);
+               _mm512_i32scatter_ps(aPrivateWeights, iPrivate, _mm512_add_ps(binWeight, weight), 4);
+               __m512 binGrad = _mm512_i32gather_ps(iPrivate, aPrivateGradients, 4);
+               _mm512_i32scatter_ps(aPrivateGradients, iPrivate, _mm512_add_ps(binGrad, gradientWeighted), 4);
+               if(bHessian) {
+                  float * const aPrivateHessians = aaPrivateHessians[iBag];
+                  __m512 binHess = _mm512_i32gather_ps(iPrivate, aPrivateHessians, 4);
+                  _mm512_i32scatter_ps(aPrivateHessians, iPrivate, _mm512_add_ps(binHess, hessianWeighted), 4);
+               }
+            } else {
+               int iRound = 0;
+               do {
+                  AccumulateBinsAvx512f<bHessian>(
+                     apBins[iBag], aReady[iRound], iByte, cOccurences, weight, gradientWeighted, hessianWeighted);
+                  ++iRound;
+               } while(cRounds != iRound);
+            }
+            ++iBag;
+         } while(cBags != iBag);
+         iSample += k_cLanes;
+
+         cShift -= cBitsPerItemMax;
+      } while(0 <= cShift);
+      cShift = cShiftReset;
+   } while(pGradientsAndHessiansEnd != pGradientAndHessian);
+
+   if(bPrivate) {
+      const size_t cBinsUsed = static_cast<size_t>(_mm512_reduce_max_epu32(iBinMax)) + size_t { 1 };
+      for(size_t iBag = 0; iBag < cBags; ++iBag) {
+         auto * const aBins = reinterpret_cast<BinBase *>(apBins[iBag])->Specialize<float, uint32_t, bHessian, size_t { 1 }>();
+         for(size_t iBin = 0; iBin < cBinsUsed; ++iBin) {
+            const size_t iFirst = iBin * size_t { k_cLanes };
+            auto * const pBin = IndexBin(aBins, iBin * GetBinSize<float, uint32_t>(bHessian, size_t { 1 }));
+            auto * const pGradientPair = pBin->GetGradientPairs();
+            pBin->SetCountSamples(pBin->GetCountSamples() + 
+               static_cast<uint32_t>(_mm512_reduce_add_epi32(_mm512_load_si512(&aaPrivateCounts[iBag][iFirst]))));
+            pBin->SetWeight(pBin->GetWeight() + _mm512_reduce_add_ps(_mm512_load_ps(&aaPrivateWeights[iBag][iFirst])));
+            pGradientPair->m_sumGradients += _mm512_reduce_add_ps(_mm512_load_ps(&aaPrivateGradients[iBag][iFirst]));
+            if(bHessian) {
+               pGradientPair->SetHess(pGradientPair->GetHess() + 
+                  _mm512_reduce_add_ps(_mm512_load_ps(&aaPrivateHessians[iBag][iFirst])));
+            }
+         }
+      }
+   }
+}
+
+template<typename TQuantized>
+INLINE_ALWAYS static __m512i LoadQuantizedAvx512f(const TQuantized * const p) noexcept;
+
+template<>
+INLINE_ALWAYS __m512i LoadQuantizedAvx512f<int8_t>(const int8_t * const p) noexcept {
+   return _mm512_cvtepi8_epi32(_mm_load_si128(reinterpret_cast<const __m128i *>(p)));
+}
+
+template<>
+INLINE_ALWAYS __m512i LoadQuantizedAvx512f<int16_t>(const int16_t * const p) noexcept {
+   return _mm512_cvtepi16_epi32(_mm256_load_si256(reinterpret_cast<const __m256i *>(p)));
+}
+
+// The integer version of BinSumsBoostingScatterAvx512f for quantized gradients.  The int8_t or int16_t values are
+// widened to 16 int32 lanes, multiplied by the occurrence counts, and gathered/added/scattered into the int32_t
+// [count, gradient, hessian] bins.  Integer addition is exact, so the private histograms and the conflict rounds
+// both produce exactly the sums of the generic BinSumsBoostingQuantizedInternal.
+template<bool bHessian, bool bReplication, typename TQuantized, bool bPrivate>
+static void BinSumsBoostingQuantizedScatterAvx512f(BinSumsBoostingBridge * const pParams) noexcept {
+   static constexpr int k_cLanes = 16;
+   static constexpr int k_cItemsPerBin = bHessian ? 3 : 2;
+
+   EBM_ASSERT(nullptr != pParams);
+   EBM_ASSERT(1 <= pParams->m_cSamples);
+   EBM_ASSERT(0 == pParams->m_cSamples % size_t { k_cLanes });
+   EBM_ASSERT(sizeof(TQuantized) == static_cast<size_t>(pParams->m_cQuantizedBytes));
+   EBM_ASSERT(nullptr != pParams->m_aGradientsAndHessians);
+   EBM_ASSERT(nullptr == pParams->m_aWeights);
+   EBM_ASSERT(nullptr != pParams->m_aFastBins);
+   EBM_ASSERT(size_t { 1 } == pParams->m_cScores);
+
+   int32_t * const aBins = reinterpret_cast<int32_t *>(pParams->m_aFastBins);
+
+   const size_t cSamples = pParams->m_cSamples;
+
+   const TQuantized * pGradientAndHessian = reinterpret_cast<const TQuantized *>(pParams->m_aGradientsAndHessians);
+   const TQuantized * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cSamples;
+
+   const int cItemsPerBitPack = pParams->m_cPack;
+   EBM_ASSERT(k_cItemsPerBitPackNone != cItemsPerBitPack);
+   EBM_ASSERT(1 <= cItemsPerBitPack);
+   EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(uint32_t));
+
+   const int cBitsPerItemMax = GetCountBits<uint32_t>(cItemsPerBitPack);
+   EBM_ASSERT(1 <= cBitsPerItemMax);
+   EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(uint32_t));
+   EBM_ASSERT(!bPrivate || cBitsPerItemMax <= k_cBitsPrivateHistogramsMax);
+
+   int cShift = static_cast<int>(((cSamples >> 4) - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
+   const int cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+
+   const __m512i maskBits = _mm512_set1_epi32(static_cast<int>(MakeLowMask<uint32_t>(cBitsPerItemMax)));
+   const __m512i cItemsPerBin = _mm512_set1_epi32(k_cItemsPerBin);
+
+   const uint32_t * pInputData = reinterpret_cast<const uint32_t *>(pParams->m_aPacked);
+   EBM_ASSERT(nullptr != pInputData);
+
+   const uint8_t * pCountOccurrences;
+   if(bReplication) {
+      pCountOccurrences = pParams->m_pCountOccurrences;
+      EBM_ASSERT(nullptr != pCountOccurrences);
+   }
+
+   static constexpr size_t k_cPrivateItems = size_t { k_cLanes } << (bPrivate ? k_cBitsPrivateHistogramsMax : 0);
+   alignas(k_cAlignment) int32_t aPrivateCounts[k_cPrivateItems];
+   alignas(k_cAlignment) int32_t aPrivateGradients[k_cPrivateItems];
+   alignas(k_cAlignment) int32_t aPrivateHessians[bHessian ? k_cPrivateItems : size_t { 1 }];
+   const __m512i iLanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+   __m512i iBinMax = _mm512_setzero_si512();
+   if(bPrivate) {
+      const size_t cBytesUsed = sizeof(aPrivateCounts[0]) * (size_t { k_cLanes } << cBitsPerItemMax);
+      memset(aPrivateCounts, 0, cBytesUsed);
+      memset(aPrivateGradients, 0, cBytesUsed);
+      if(bHessian) {
+         memset(aPrivateHessians, 0, cBytesUsed);
+      }
+   }
+
+   const __m512i one = _mm512_set1_epi32(1);
+   do {
+      const __m512i iTensorBinCombined = _mm512_load_si512(pInputData);
+      pInputData += k_cLanes;
+      do {
+         __m512i cOccurences = one;
+         if(bReplication) {
+            cOccurences = _mm512_cvtepu8_epi32(_mm_load_si128(reinterpret_cast<const __m128i *>(pCountOccurrences)));
+            pCountOccurrences += k_cLanes;
+         }
+
+         __m512i gradient = LoadQuantizedAvx512f<TQuantized>(pGradientAndHessian);
+         __m512i hessian = _mm512_setzero_si512();
+         if(bHessian) {
+            hessian = LoadQuantizedAvx512f<TQuantized>(&pGradientAndHessian[k_cLanes]);
+         }
+         pGradientAndHessian += (bHessian ? size_t { 2 } : size_t { 1 }) * k_cLanes;
+
+         if(bReplication) {
+            gradient = _mm512_mullo_epi32(gradient, cOccurences);
+            if(bHessian) {
+               hessian = _mm512_mullo_epi32(hessian, cOccurences);
+            }
+         }
+
+         const __m512i iTensorBin = _mm512_and_si512(_mm512_srli_epi32(iTensorBinCombined, static_cast<unsigned int>(cShift)), maskBits);
+
+         if(bPrivate) {
+            iBinMax = _mm512_max_epu32(iBinMax, iTensorBin);
+            const __m512i iPrivate = _mm512_add_epi32(_mm512_slli_epi32(iTensorBin, 4), iLanes);
+
+            __m512i binCount = _mm512_i32gather_epi32(iPrivate, aPrivateCounts, 4);
+            _mm512_i32scatter_epi32(aPrivateCounts, iPrivate, _mm512_add_epi32(binCount, cOccurences), 4);
+            __m512i binGrad = _mm512_i32gather_epi32(iPrivate, aPrivateGradients, 4);
+            _mm512_i32scatter_epi32(aPrivateGradients, iPrivate, _mm512_add_epi32(binGrad, gradient), 4);
+            if(bHessian) {
+               __m512i binHess = _mm512_i32gather_epi32(iPrivate, aPrivateHessians, 4);
+               _mm512_i32scatter_epi32(aPrivateHessians, iPrivate, _mm512_add_epi32(binHess, hessian), 4);
+            }
+         } else {
+            const __m512i conflicts = _mm512_conflict_epi32(iTensorBin);
+            const __m512i iItem = _mm512_mullo_epi32(iTensorBin, cItemsPerBin);
+
+            __mmask16 todo = __mmask16 { 0xFFFF };
+            do {
+               const __mmask16 ready = _mm512_mask_testn_epi32_mask(todo, conflicts, _mm512_set1_epi32(static_cast<int>(todo)));
+
+               __m512i binCount = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), ready, iItem, aBins, 4);
+               _mm512_mask_i32scatter_epi32(aBins, ready, iItem, _mm512_add_epi32(binCount, cOccurences), 4);
+               __m512i binGrad = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), ready, iItem, &aBins[1], 4);
+               _mm512_mask_i32scatter_epi32(&aBins[1], ready, iItem, _mm512_add_epi32(binGrad, gradient), 4);
+               if(bHessian) {
+                  __m512i binHess = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), ready, iItem, &aBins[2], 4);
+                  _mm512_mask_i32scatter_epi32(&aBins[2], ready, iItem, _mm512_add_epi32(binHess, hessian), 4);
+               }
+
+               todo = static_cast<__mmask16>(todo & ~ready);
+            } while(0 != todo);
+         }
+
+         cShift -= cBitsPerItemMax;
+      } while(0 <= cShift);
+      cShift = cShiftReset;
+   } while(pGradientsAndHessiansEnd != pGradientAndHessian);
+
+   if(bPrivate) {
+      const size_t cBinsUsed = static_cast<size_t>(_mm512_reduce_max_epu32(iBinMax)) + size_t { 1 };
+      for(size_t iBin = 0; iBin < cBinsUsed; ++iBin) {
+         const size_t iFirst = iBin * size_t { k_cLanes };
+         int32_t * const pBin = &aBins[iBin * size_t { k_cItemsPerBin }];
+         pBin[0] += _mm512_reduce_add_epi32(_mm512_load_si512(&aPrivateCounts[iFirst]));
+         pBin[1] += _mm512_reduce_add_epi32(_mm512_load_si512(&aPrivateGradients[iFirst]));
+         if(bHessian) {
+            pBin[2] += _mm512_reduce_add_epi32(_mm512_load_si512(&aPrivateHessians[iFirst]));
+         }
+      }
+   }
+}
+
 struct alignas(k_cAlignment) Avx512f_32_Int final {
    friend Avx512f_32_Float;
    friend inline Avx512f_32_Float IfEqual(const Avx512f_32_Int & cmp1, const Avx512f_32_Int & cmp2, const Avx512f_32_Float & trueVal, const Avx512f_32_Float & falseVal) noexcept;
@@ -543,12 +1098,31 @@ struct alignas(k_cAlignment) Avx512f_32_Float final {
       return Avx512f_32_Float(_mm512_sqrt_ps(val.m_data));
    }
 
+   // the unmasked forms of roundscale, scalef, getexp and getmant pass an undefined source through, which GCC
+   // reports as uninitialized, so we use the zero masked forms with every lane enabled instead
+   friend inline Avx512f_32_Float Round(const Avx512f_32_Float & val) noexcept {
+      return Avx512f_32_Float(_mm512_maskz_roundscale_ps(__mmask16 { 0xFFFF }, val.m_data, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+   }
+
+   friend inline Avx512f_32_Float Ldexp(const Avx512f_32_Float & val, const Avx512f_32_Float & exponent) noexcept {
+      // scalef handles subnormal results directly
+      return Avx512f_32_Float(_mm512_maskz_scalef_ps(__mmask16 { 0xFFFF }, val.m_data, exponent.m_data));
+   }
+
+   friend inline Avx512f_32_Float GetExponent(const Avx512f_32_Float & val) noexcept {
+      return Avx512f_32_Float(_mm512_maskz_getexp_ps(__mmask16 { 0xFFFF }, val.m_data));
+   }
+
+   friend inline Avx512f_32_Float GetMantissa(const Avx512f_32_Float & val) noexcept {
+      return Avx512f_32_Float(_mm512_maskz_getmant_ps(__mmask16 { 0xFFFF }, val.m_data, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero));
+   }
+
    friend inline Avx512f_32_Float Exp(const Avx512f_32_Float & val) noexcept {
-      return ApplyFunc([](T x) { return std::exp(x); }, val);
+      return ExpAccurate(val);
    }
 
    friend inline Avx512f_32_Float Log(const Avx512f_32_Float & val) noexcept {
-      return ApplyFunc([](T x) { return std::log(x); }, val);
+      return LogAccurate(val);
    }
 
 
@@ -687,7 +1261,43 @@ struct alignas(k_cAlignment) Avx512f_32_Float final {
 
    template<bool bHessian, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) noexcept {
-      RemoteBinSumsBoosting<Avx512f_32_Float, bHessian, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      if(size_t { 1 } == cCompilerScores && k_cItemsPerBitPackNone != cCompilerPack) {
+         // the single score bit packed case is the hot path for boosting, so it gets our conflict free scatter
+         if(GetCountBits<uint32_t>(pParams->m_cPack) <= k_cBitsPrivateHistogramsMax) {
+            BinSumsBoostingScatterAvx512f<bHessian, bWeight, bReplication, true>(pParams);
+         } else {
+            BinSumsBoostingScatterAvx512f<bHessian, bWeight, bReplication, false>(pParams);
+         }
+      } else {
+         RemoteBinSumsBoosting<Avx512f_32_Float, bHessian, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      }
+      return Error_None;
+   }
+
+
+   template<bool bHessian, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingBags(BinSumsBoostingBridge * const pParams) noexcept {
+      // use the same private or conflict strategy as OperatorBinSumsBoosting so that the bags sum identically
+      if(GetCountBits<uint32_t>(pParams->m_cPack) <= k_cBitsPrivateHistogramsMax) {
+         BinSumsBoostingBagsScatterAvx512f<bHessian, true>(pParams);
+      } else {
+         BinSumsBoostingBagsScatterAvx512f<bHessian, false>(pParams);
+      }
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bReplication, typename TQuantized, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingQuantized(BinSumsBoostingBridge * const pParams) noexcept {
+      if(k_cItemsPerBitPackNone != cCompilerPack && size_t { 1 } == pParams->m_cScores) {
+         if(GetCountBits<uint32_t>(pParams->m_cPack) <= k_cBitsPrivateHistogramsMax) {
+            BinSumsBoostingQuantizedScatterAvx512f<bHessian, bReplication, TQuantized, true>(pParams);
+         } else {
+            BinSumsBoostingQuantizedScatterAvx512f<bHessian, bReplication, TQuantized, false>(pParams);
+         }
+      } else {
+         RemoteBinSumsBoostingQuantized<Avx512f_32_Float, bHessian, bReplication, TQuantized, cCompilerPack>(pParams);
+      }
       return Error_None;
    }
 
@@ -699,6 +1309,13 @@ struct alignas(k_cAlignment) Avx512f_32_Float final {
    }
 
 
+   template<bool bHessian, bool bWeight, size_t cCompilerScores>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteractionPartners(BinSumsInteractionBridge * const pParams) noexcept {
+      RemoteBinSumsInteractionPartners<Avx512f_32_Float, bHessian, bWeight, cCompilerScores>(pParams);
+      return Error_None;
+   }
+
+
 private:
 
    inline Avx512f_32_Float(const TPack & data) noexcept : m_data(data) {
@@ -766,6 +1383,153 @@ INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsInteraction_Avx512f_32(
    return (*pBinSumsInteractionCpp)(pParams);
 }
 
+// Up to this many cuts it is faster to compare each value against every cut than to binary search with gathers
+static constexpr size_t k_cCutsLinearMaxAvx512f = 32;
+// Each binary search step waits on a gather, so we interleave this many independent packs to hide that latency
+static constexpr size_t k_cDiscretizePacksAvx512f = 8;
+// the Eytzinger search handles this many top levels with broadcast comparisons (2^levels - 1 of them) before gathering
+static constexpr size_t k_cEytzingerLevelsTopAvx512f = 3;
+
+enum class DiscretizeSearchAvx512f {
+   Linear,
+   Binary,
+   Eytzinger
+};
+
+// bins cPacks * 8 doubles. Bins are identical to DiscretizeOneSample: 0 for NaN, otherwise 1 + the count of cuts <= val
+template<DiscretizeSearchAvx512f search, size_t cPacks>
+inline static void DiscretizePacksAvx512f(
+   const __m512d * const aVal,
+   __m512i * const aiBin,
+   const size_t cCuts,
+   const size_t cEytzingerLevels,
+   const double * const aCuts
+) noexcept {
+   const __m512i one = _mm512_set1_epi64(1);
+   if(DiscretizeSearchAvx512f::Eytzinger == search) {
+      // every lane walks the same number of levels of the perfect tree.  The top levels are shared by all lanes
+      // and sit together at the front of the array, so only the last few levels miss the cache.  Gathers are
+      // our bottleneck, so we descend the first levels by counting the cuts <= val in them instead.  Node k
+      // at the top of the remaining levels is 2^levels + that count
+      const size_t cLevelsTop = cEytzingerLevels < k_cEytzingerLevelsTopAvx512f ?
+         cEytzingerLevels : k_cEytzingerLevelsTopAvx512f;
+      const size_t iNodeTopEnd = size_t { 1 } << cLevelsTop;
+      for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+         aiBin[iPack] = _mm512_set1_epi64(static_cast<long long>(iNodeTopEnd));
+      }
+      for(size_t iNode = 1; iNode < iNodeTopEnd; ++iNode) {
+         const __m512d cut = _mm512_set1_pd(aCuts[iNode]);
+         for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+            const __mmask8 mask = _mm512_cmp_pd_mask(cut, aVal[iPack], _CMP_LE_OQ);
+            aiBin[iPack] = _mm512_mask_add_epi64(aiBin[iPack], mask, aiBin[iPack], one);
+         }
+      }
+      for(size_t iLevel = cLevelsTop; iLevel < cEytzingerLevels; ++iLevel) {
+         for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+            const __m512d cut = _mm512_i64gather_pd(aiBin[iPack], aCuts, sizeof(double));
+            // the padding is NaN, which compares false like a cut above every value
+            const __mmask8 mask = _mm512_cmp_pd_mask(cut, aVal[iPack], _CMP_LE_OQ);
+            aiBin[iPack] = _mm512_add_epi64(aiBin[iPack], aiBin[iPack]);
+            aiBin[iPack] = _mm512_mask_add_epi64(aiBin[iPack], mask, aiBin[iPack], one);
+         }
+      }
+      // the leaf we land on, counted from the left, is the number of cuts <= val
+      const __m512i leafFirst = _mm512_set1_epi64(static_cast<long long>(size_t { 1 } << cEytzingerLevels));
+      for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+         aiBin[iPack] = _mm512_sub_epi64(aiBin[iPack], leafFirst);
+      }
+   } else {
+      for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+         aiBin[iPack] = _mm512_setzero_si512();
+      }
+   }
+   if(DiscretizeSearchAvx512f::Linear == search) {
+      for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+         const __m512d cut = _mm512_set1_pd(aCuts[iCut]);
+         for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+            // comparisons with NaN are false, so NaN values stay at zero
+            const __mmask8 mask = _mm512_cmp_pd_mask(cut, aVal[iPack], _CMP_LE_OQ);
+            aiBin[iPack] = _mm512_mask_add_epi64(aiBin[iPack], mask, aiBin[iPack], one);
+         }
+      }
+   } else if(DiscretizeSearchAvx512f::Binary == search) {
+      // branchless upper bound.  The remaining length is the same for every lane, so only the base differs
+      size_t cRemaining = cCuts;
+      while(size_t { 1 } < cRemaining) {
+         const size_t cHalf = cRemaining >> 1;
+         const __m512i half = _mm512_set1_epi64(static_cast<long long>(cHalf));
+         for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+            const __m512d cut = _mm512_i64gather_pd(_mm512_add_epi64(aiBin[iPack], half), aCuts, sizeof(double));
+            const __mmask8 mask = _mm512_cmp_pd_mask(cut, aVal[iPack], _CMP_LE_OQ);
+            aiBin[iPack] = _mm512_mask_add_epi64(aiBin[iPack], mask, aiBin[iPack], half);
+         }
+         cRemaining -= cHalf;
+      }
+      for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+         const __m512d cut = _mm512_i64gather_pd(aiBin[iPack], aCuts, sizeof(double));
+         const __mmask8 mask = _mm512_cmp_pd_mask(cut, aVal[iPack], _CMP_LE_OQ);
+         aiBin[iPack] = _mm512_mask_add_epi64(aiBin[iPack], mask, aiBin[iPack], one);
+      }
+   }
+   for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+      // non-missing values start from bin 1
+      const __mmask8 ordered = _mm512_cmp_pd_mask(aVal[iPack], aVal[iPack], _CMP_ORD_Q);
+      aiBin[iPack] = _mm512_mask_add_epi64(aiBin[iPack], ordered, aiBin[iPack], one);
+   }
+}
+
+template<DiscretizeSearchAvx512f search>
+static void DiscretizeAvx512f(const DiscretizeBridge * const pParams) noexcept {
+   static constexpr size_t cPack = 8;
+   static constexpr size_t cPacks = k_cDiscretizePacksAvx512f;
+   static_assert(sizeof(IntEbm) == sizeof(long long), "we store the bins as 64 bit integers");
+
+   const size_t cCuts = pParams->m_cCuts;
+   const size_t cEytzingerLevels = pParams->m_cEytzingerLevels;
+   const double * const aCuts = pParams->m_aCutsLowerBoundInclusive;
+
+   const double * pVal = pParams->m_aFeatureVals;
+   IntEbm * piBin = pParams->m_aBinIndexesOut;
+   size_t cRemaining = pParams->m_cSamples;
+
+   __m512d aVal[cPacks];
+   __m512i aiBin[cPacks];
+   while(cPack * cPacks <= cRemaining) {
+      for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+         aVal[iPack] = _mm512_loadu_pd(pVal + iPack * cPack);
+      }
+      DiscretizePacksAvx512f<search, cPacks>(aVal, aiBin, cCuts, cEytzingerLevels, aCuts);
+      for(size_t iPack = 0; iPack < cPacks; ++iPack) {
+         _mm512_storeu_si512(piBin + iPack * cPack, aiBin[iPack]);
+      }
+      pVal += cPack * cPacks;
+      piBin += cPack * cPacks;
+      cRemaining -= cPack * cPacks;
+   }
+   while(size_t { 0 } != cRemaining) {
+      const size_t cItems = cRemaining < cPack ? cRemaining : cPack;
+      const __mmask8 mask = static_cast<__mmask8>((1u << cItems) - 1u);
+      aVal[0] = _mm512_maskz_loadu_pd(mask, pVal);
+      DiscretizePacksAvx512f<search, 1>(aVal, aiBin, cCuts, cEytzingerLevels, aCuts);
+      _mm512_mask_storeu_epi64(piBin, mask, aiBin[0]);
+      pVal += cItems;
+      piBin += cItems;
+      cRemaining -= cItems;
+   }
+}
+
+INTERNAL_IMPORT_EXPORT_BODY void Discretize_Avx512f_32(const DiscretizeBridge * const pParams) {
+   EBM_ASSERT(nullptr != pParams);
+   EBM_ASSERT(size_t { 1 } <= pParams->m_cCuts);
+   if(size_t { 0 } != pParams->m_cEytzingerLevels) {
+      DiscretizeAvx512f<DiscretizeSearchAvx512f::Eytzinger>(pParams);
+   } else if(pParams->m_cCuts <= k_cCutsLinearMaxAvx512f) {
+      DiscretizeAvx512f<DiscretizeSearchAvx512f::Linear>(pParams);
+   } else {
+      DiscretizeAvx512f<DiscretizeSearchAvx512f::Binary>(pParams);
+   }
+}
+
 INTERNAL_IMPORT_EXPORT_BODY ErrorEbm CreateObjective_Avx512f_32(
    const Config * const pConfig,
    const char * const sObjective,
@@ -0,0 +1,712 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+// The 64 bit AVX-512 zone is compiled and dispatched alongside the 32 bit AVX-512 zone, so it shares its bridge macro.
+// It holds 8 doubles per pack instead of 16 floats, which allows us to use SIMD when exact double results are needed.
+#ifdef BRIDGE_AVX512F_32
+
+#define _CRT_SECURE_NO_DEPRECATE
+
+#include <cmath> // exp, log
+#include <limits> // numeric_limits
+#include <type_traits> // is_unsigned
+#if defined(__GNUC__) && !defined(__clang__)
+// see the matching include in avx512f_32.cpp for why the uninitialized warnings are disabled around this header
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h> // SIMD.  Do not include in pch.hpp!
+#pragma GCC diagnostic pop
+#else // GCC
+#include <immintrin.h> // SIMD.  Do not include in pch.hpp!
+#endif // GCC
+
+#include "libebm.h"
+#include "logging.h"
+#include "unzoned.h"
+
+#define ZONE_avx512f
+#include "zones.h"
+
+#include "bridge.h"
+#include "common.hpp"
+#include "bridge.hpp"
+
+#include "Registration.hpp"
+#include "Objective.hpp"
+
+#include "approximate_math.hpp"
+#include "accurate_math.hpp"
+#include "compute_wrapper.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// this is super-special and included inside the zone namespace
+#include "objective_registrations.hpp"
+
+static constexpr size_t k_cAlignment = 64;
+
+struct alignas(k_cAlignment) Avx512f_64_Float;
+
+struct alignas(k_cAlignment) Avx512f_64_Int final {
+   friend Avx512f_64_Float;
+   friend inline Avx512f_64_Float IfEqual(const Avx512f_64_Int & cmp1, const Avx512f_64_Int & cmp2, const Avx512f_64_Float & trueVal, const Avx512f_64_Float & falseVal) noexcept;
+
+   using T = uint64_t;
+   using TPack = __m512i;
+   static_assert(std::is_unsigned<T>::value, "T must be an unsigned integer type");
+   static_assert(std::is_same<UIntBig, T>::value || std::is_same<UIntSmall, T>::value,
+      "T must be either UIntBig or UIntSmall");
+   static constexpr AccelerationFlags k_zone = AccelerationFlags_AVX512F;
+   static constexpr int k_cSIMDShift = 3;
+   static constexpr int k_cSIMDPack = 1 << k_cSIMDShift;
+
+   ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
+   inline Avx512f_64_Int() noexcept {
+   }
+
+   inline Avx512f_64_Int(const T & val) noexcept : m_data(_mm512_set1_epi64(static_cast<long long>(val))) {
+   }
+
+   inline static Avx512f_64_Int Load(const T * const a) noexcept {
+      return Avx512f_64_Int(_mm512_load_si512(a));
+   }
+
+   inline void Store(T * const a) const noexcept {
+      _mm512_store_si512(a, m_data);
+   }
+
+   inline static Avx512f_64_Int LoadBytes(const uint8_t * const a) noexcept {
+      return Avx512f_64_Int(_mm512_cvtepu8_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(a))));
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx512f_64_Int & val0) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+
+      // no loops because this will disable optimizations for loops in the caller
+      func(0, a0[0]);
+      func(1, a0[1]);
+      func(2, a0[2]);
+      func(3, a0[3]);
+      func(4, a0[4]);
+      func(5, a0[5]);
+      func(6, a0[6]);
+      func(7, a0[7]);
+   }
+
+   inline static Avx512f_64_Int MakeIndexes() noexcept {
+      return Avx512f_64_Int(_mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0));
+   }
+
+   inline Avx512f_64_Int operator+ (const Avx512f_64_Int & other) const noexcept {
+      return Avx512f_64_Int(_mm512_add_epi64(m_data, other.m_data));
+   }
+
+   inline Avx512f_64_Int operator* (const T & other) const noexcept {
+      // _mm512_mullo_epi64 requires AVX512DQ, so build the 64 bit low multiply from 32 bit multiplies.  The parts
+      // of the cross products above 64 bits are discarded, just as they would be in an ordinary uint64_t multiply
+      const __m512i mul = _mm512_set1_epi64(static_cast<long long>(other));
+      const __m512i low = _mm512_mul_epu32(m_data, mul);
+      const __m512i cross = _mm512_add_epi64(
+         _mm512_mul_epu32(_mm512_srli_epi64(m_data, 32), mul),
+         _mm512_mul_epu32(m_data, _mm512_srli_epi64(mul, 32))
+      );
+      return Avx512f_64_Int(_mm512_add_epi64(low, _mm512_slli_epi64(cross, 32)));
+   }
+
+   inline Avx512f_64_Int operator>> (int shift) const noexcept {
+      return Avx512f_64_Int(_mm512_srli_epi64(m_data, shift));
+   }
+
+   inline Avx512f_64_Int operator<< (int shift) const noexcept {
+      return Avx512f_64_Int(_mm512_slli_epi64(m_data, shift));
+   }
+
+   inline Avx512f_64_Int operator& (const Avx512f_64_Int & other) const noexcept {
+      return Avx512f_64_Int(_mm512_and_si512(m_data, other.m_data));
+   }
+
+private:
+   inline Avx512f_64_Int(const TPack & data) noexcept : m_data(data) {
+   }
+
+   TPack m_data;
+};
+static_assert(std::is_standard_layout<Avx512f_64_Int>::value && std::is_trivially_copyable<Avx512f_64_Int>::value,
+   "This allows offsetof, memcpy, memset, inter-language, GPU and cross-machine use where needed");
+
+
+struct alignas(k_cAlignment) Avx512f_64_Float final {
+   using T = double;
+   using TPack = __m512d;
+   using TInt = Avx512f_64_Int;
+   static_assert(std::is_same<FloatBig, T>::value || std::is_same<FloatSmall, T>::value,
+      "T must be either FloatBig or FloatSmall");
+   static constexpr AccelerationFlags k_zone = TInt::k_zone;
+   static constexpr int k_cSIMDShift = TInt::k_cSIMDShift;
+   static constexpr int k_cSIMDPack = TInt::k_cSIMDPack;
+
+   ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
+   inline Avx512f_64_Float() noexcept {
+   }
+
+   inline Avx512f_64_Float(const double val) noexcept : m_data(_mm512_set1_pd(static_cast<T>(val))) {
+   }
+   inline Avx512f_64_Float(const float val) noexcept : m_data(_mm512_set1_pd(static_cast<T>(val))) {
+   }
+   inline Avx512f_64_Float(const int val) noexcept : m_data(_mm512_set1_pd(static_cast<T>(val))) {
+   }
+
+
+   inline Avx512f_64_Float operator+() const noexcept {
+      return *this;
+   }
+
+   inline Avx512f_64_Float operator-() const noexcept {
+      return Avx512f_64_Float(_mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(m_data), _mm512_set1_epi64(std::numeric_limits<long long>::min()))));
+   }
+
+
+   inline Avx512f_64_Float operator+ (const Avx512f_64_Float & other) const noexcept {
+      return Avx512f_64_Float(_mm512_add_pd(m_data, other.m_data));
+   }
+
+   inline Avx512f_64_Float operator- (const Avx512f_64_Float & other) const noexcept {
+      return Avx512f_64_Float(_mm512_sub_pd(m_data, other.m_data));
+   }
+
+   inline Avx512f_64_Float operator* (const Avx512f_64_Float & other) const noexcept {
+      return Avx512f_64_Float(_mm512_mul_pd(m_data, other.m_data));
+   }
+
+   inline Avx512f_64_Float operator/ (const Avx512f_64_Float & other) const noexcept {
+      return Avx512f_64_Float(_mm512_div_pd(m_data, other.m_data));
+   }
+
+
+   inline Avx512f_64_Float & operator+= (const Avx512f_64_Float & other) noexcept {
+      *this = (*this) + other;
+      return *this;
+   }
+
+   inline Avx512f_64_Float & operator-= (const Avx512f_64_Float & other) noexcept {
+      *this = (*this) - other;
+      return *this;
+   }
+
+   inline Avx512f_64_Float & operator*= (const Avx512f_64_Float & other) noexcept {
+      *this = (*this) * other;
+      return *this;
+   }
+
+   inline Avx512f_64_Float & operator/= (const Avx512f_64_Float & other) noexcept {
+      *this = (*this) / other;
+      return *this;
+   }
+
+
+   friend inline Avx512f_64_Float operator+ (const double val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) + other;
+   }
+
+   friend inline Avx512f_64_Float operator- (const double val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) - other;
+   }
+
+   friend inline Avx512f_64_Float operator* (const double val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) * other;
+   }
+
+   friend inline Avx512f_64_Float operator/ (const double val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) / other;
+   }
+
+
+   friend inline Avx512f_64_Float operator+ (const float val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) + other;
+   }
+
+   friend inline Avx512f_64_Float operator- (const float val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) - other;
+   }
+
+   friend inline Avx512f_64_Float operator* (const float val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) * other;
+   }
+
+   friend inline Avx512f_64_Float operator/ (const float val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) / other;
+   }
+
+
+   inline static Avx512f_64_Float Load(const T * const a) noexcept {
+      return Avx512f_64_Float(_mm512_load_pd(a));
+   }
+
+   inline void Store(T * const a) const noexcept {
+      _mm512_store_pd(a, m_data);
+   }
+
+   inline static Avx512f_64_Float Load(const T * const a, const TInt & i) noexcept {
+      // i is treated as signed, so we should only use the lower 31 bits otherwise we'll read from memory before a
+      return Avx512f_64_Float(_mm512_i64gather_pd(i.m_data, a, sizeof(a[0])));
+   }
+
+   inline void Store(T * const a, const TInt & i) const noexcept {
+      // i is treated as signed, so we should only use the lower 31 bits otherwise we'll read from memory before a
+      _mm512_i64scatter_pd(a, i.m_data, m_data, sizeof(a[0]));
+   }
+
+   template<typename TFunc>
+   friend inline Avx512f_64_Float ApplyFunc(const TFunc & func, const Avx512f_64_Float & val) noexcept {
+      alignas(k_cAlignment) T aTemp[k_cSIMDPack];
+      val.Store(aTemp);
+
+      aTemp[0] = func(aTemp[0]);
+      aTemp[1] = func(aTemp[1]);
+      aTemp[2] = func(aTemp[2]);
+      aTemp[3] = func(aTemp[3]);
+      aTemp[4] = func(aTemp[4]);
+      aTemp[5] = func(aTemp[5]);
+      aTemp[6] = func(aTemp[6]);
+      aTemp[7] = func(aTemp[7]);
+
+      return Load(aTemp);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func) noexcept {
+      func(0);
+      func(1);
+      func(2);
+      func(3);
+      func(4);
+      func(5);
+      func(6);
+      func(7);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx512f_64_Float & val0) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+
+      func(0, a0[0]);
+      func(1, a0[1]);
+      func(2, a0[2]);
+      func(3, a0[3]);
+      func(4, a0[4]);
+      func(5, a0[5]);
+      func(6, a0[6]);
+      func(7, a0[7]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx512f_64_Float & val0, const Avx512f_64_Float & val1) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) T a1[k_cSIMDPack];
+      val1.Store(a1);
+
+      func(0, a0[0], a1[0]);
+      func(1, a0[1], a1[1]);
+      func(2, a0[2], a1[2]);
+      func(3, a0[3], a1[3]);
+      func(4, a0[4], a1[4]);
+      func(5, a0[5], a1[5]);
+      func(6, a0[6], a1[6]);
+      func(7, a0[7], a1[7]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx512f_64_Int & val0, const Avx512f_64_Float & val1) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) T a1[k_cSIMDPack];
+      val1.Store(a1);
+
+      func(0, a0[0], a1[0]);
+      func(1, a0[1], a1[1]);
+      func(2, a0[2], a1[2]);
+      func(3, a0[3], a1[3]);
+      func(4, a0[4], a1[4]);
+      func(5, a0[5], a1[5]);
+      func(6, a0[6], a1[6]);
+      func(7, a0[7], a1[7]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx512f_64_Int & val0, const Avx512f_64_Float & val1, const Avx512f_64_Float & val2) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) T a1[k_cSIMDPack];
+      val1.Store(a1);
+      alignas(k_cAlignment) T a2[k_cSIMDPack];
+      val2.Store(a2);
+
+      func(0, a0[0], a1[0], a2[0]);
+      func(1, a0[1], a1[1], a2[1]);
+      func(2, a0[2], a1[2], a2[2]);
+      func(3, a0[3], a1[3], a2[3]);
+      func(4, a0[4], a1[4], a2[4]);
+      func(5, a0[5], a1[5], a2[5]);
+      func(6, a0[6], a1[6], a2[6]);
+      func(7, a0[7], a1[7], a2[7]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx512f_64_Int & val0, const Avx512f_64_Float & val1, const Avx512f_64_Float & val2, const Avx512f_64_Float & val3) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) T a1[k_cSIMDPack];
+      val1.Store(a1);
+      alignas(k_cAlignment) T a2[k_cSIMDPack];
+      val2.Store(a2);
+      alignas(k_cAlignment) T a3[k_cSIMDPack];
+      val3.Store(a3);
+
+      func(0, a0[0], a1[0], a2[0], a3[0]);
+      func(1, a0[1], a1[1], a2[1], a3[1]);
+      func(2, a0[2], a1[2], a2[2], a3[2]);
+      func(3, a0[3], a1[3], a2[3], a3[3]);
+      func(4, a0[4], a1[4], a2[4], a3[4]);
+      func(5, a0[5], a1[5], a2[5], a3[5]);
+      func(6, a0[6], a1[6], a2[6], a3[6]);
+      func(7, a0[7], a1[7], a2[7], a3[7]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx512f_64_Int & val0, const Avx512f_64_Int & val1, const Avx512f_64_Float & val2, const Avx512f_64_Float & val3) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) TInt::T a1[k_cSIMDPack];
+      val1.Store(a1);
+      alignas(k_cAlignment) T a2[k_cSIMDPack];
+      val2.Store(a2);
+      alignas(k_cAlignment) T a3[k_cSIMDPack];
+      val3.Store(a3);
+
+      func(0, a0[0], a1[0], a2[0], a3[0]);
+      func(1, a0[1], a1[1], a2[1], a3[1]);
+      func(2, a0[2], a1[2], a2[2], a3[2]);
+      func(3, a0[3], a1[3], a2[3], a3[3]);
+      func(4, a0[4], a1[4], a2[4], a3[4]);
+      func(5, a0[5], a1[5], a2[5], a3[5]);
+      func(6, a0[6], a1[6], a2[6], a3[6]);
+      func(7, a0[7], a1[7], a2[7], a3[7]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx512f_64_Int & val0, const Avx512f_64_Int & val1, const Avx512f_64_Float & val2, const Avx512f_64_Float & val3, const Avx512f_64_Float & val4) noexcept {
+      alignas(k_cAlignment) TInt::T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) TInt::T a1[k_cSIMDPack];
+      val1.Store(a1);
+      alignas(k_cAlignment) T a2[k_cSIMDPack];
+      val2.Store(a2);
+      alignas(k_cAlignment) T a3[k_cSIMDPack];
+      val3.Store(a3);
+      alignas(k_cAlignment) T a4[k_cSIMDPack];
+      val4.Store(a4);
+
+      func(0, a0[0], a1[0], a2[0], a3[0], a4[0]);
+      func(1, a0[1], a1[1], a2[1], a3[1], a4[1]);
+      func(2, a0[2], a1[2], a2[2], a3[2], a4[2]);
+      func(3, a0[3], a1[3], a2[3], a3[3], a4[3]);
+      func(4, a0[4], a1[4], a2[4], a3[4], a4[4]);
+      func(5, a0[5], a1[5], a2[5], a3[5], a4[5]);
+      func(6, a0[6], a1[6], a2[6], a3[6], a4[6]);
+      func(7, a0[7], a1[7], a2[7], a3[7], a4[7]);
+   }
+
+   friend inline Avx512f_64_Float IfLess(const Avx512f_64_Float & cmp1, const Avx512f_64_Float & cmp2, const Avx512f_64_Float & trueVal, const Avx512f_64_Float & falseVal) noexcept {
+      const __mmask8 mask = _mm512_cmp_pd_mask(cmp1.m_data, cmp2.m_data, _CMP_LT_OQ);
+      return Avx512f_64_Float(_mm512_mask_blend_pd(mask, falseVal.m_data, trueVal.m_data));
+   }
+
+   friend inline Avx512f_64_Float IfEqual(const Avx512f_64_Float & cmp1, const Avx512f_64_Float & cmp2, const Avx512f_64_Float & trueVal, const Avx512f_64_Float & falseVal) noexcept {
+      const __mmask8 mask = _mm512_cmp_pd_mask(cmp1.m_data, cmp2.m_data, _CMP_EQ_OQ);
+      return Avx512f_64_Float(_mm512_mask_blend_pd(mask, falseVal.m_data, trueVal.m_data));
+   }
+
+   friend inline Avx512f_64_Float IfNaN(const Avx512f_64_Float & cmp, const Avx512f_64_Float & trueVal, const Avx512f_64_Float & falseVal) noexcept {
+      // rely on the fact that a == a can only be false if a is a NaN
+      return IfEqual(cmp, cmp, falseVal, trueVal);
+   }
+
+   friend inline Avx512f_64_Float IfEqual(const Avx512f_64_Int & cmp1, const Avx512f_64_Int & cmp2, const Avx512f_64_Float & trueVal, const Avx512f_64_Float & falseVal) noexcept {
+      const __mmask8 mask = _mm512_cmpeq_epi64_mask(cmp1.m_data, cmp2.m_data);
+      return Avx512f_64_Float(_mm512_mask_blend_pd(mask, falseVal.m_data, trueVal.m_data));
+   }
+
+   friend inline Avx512f_64_Float Abs(const Avx512f_64_Float & val) noexcept {
+      return Avx512f_64_Float(_mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(val.m_data), _mm512_set1_epi64(std::numeric_limits<long long>::max()))));
+   }
+
+   friend inline Avx512f_64_Float FastApproxReciprocal(const Avx512f_64_Float & val) noexcept {
+      // _mm512_rcp14_pd only has 14 bits of precision, which defeats the purpose of a double zone, so divide
+      return Avx512f_64_Float(1.0) / val;
+   }
+
+   friend inline Avx512f_64_Float FastApproxDivide(const Avx512f_64_Float & dividend, const Avx512f_64_Float & divisor) noexcept {
+      return dividend / divisor;
+   }
+
+   friend inline Avx512f_64_Float FusedMultiplyAdd(const Avx512f_64_Float & mul1, const Avx512f_64_Float & mul2, const Avx512f_64_Float & add) noexcept {
+      return Avx512f_64_Float(_mm512_fmadd_pd(mul1.m_data, mul2.m_data, add.m_data));
+   }
+
+   friend inline Avx512f_64_Float FusedNegateMultiplyAdd(const Avx512f_64_Float & mul1, const Avx512f_64_Float & mul2, const Avx512f_64_Float & add) noexcept {
+      // equivalent to: -(mul1 * mul2) + add
+      return Avx512f_64_Float(_mm512_fnmadd_pd(mul1.m_data, mul2.m_data, add.m_data));
+   }
+
+   friend inline Avx512f_64_Float Sqrt(const Avx512f_64_Float & val) noexcept {
+      return Avx512f_64_Float(_mm512_sqrt_pd(val.m_data));
+   }
+
+   // the unmasked forms of roundscale, scalef, getexp and getmant pass an undefined source through, which GCC
+   // reports as uninitialized, so we use the zero masked forms with every lane enabled instead
+   friend inline Avx512f_64_Float Round(const Avx512f_64_Float & val) noexcept {
+      return Avx512f_64_Float(_mm512_maskz_roundscale_pd(__mmask8 { 0xFF }, val.m_data, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+   }
+
+   friend inline Avx512f_64_Float Ldexp(const Avx512f_64_Float & val, const Avx512f_64_Float & exponent) noexcept {
+      // scalef handles subnormal results directly
+      return Avx512f_64_Float(_mm512_maskz_scalef_pd(__mmask8 { 0xFF }, val.m_data, exponent.m_data));
+   }
+
+   friend inline Avx512f_64_Float GetExponent(const Avx512f_64_Float & val) noexcept {
+      return Avx512f_64_Float(_mm512_maskz_getexp_pd(__mmask8 { 0xFF }, val.m_data));
+   }
+
+   friend inline Avx512f_64_Float GetMantissa(const Avx512f_64_Float & val) noexcept {
+      return Avx512f_64_Float(_mm512_maskz_getmant_pd(__mmask8 { 0xFF }, val.m_data, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero));
+   }
+
+   friend inline Avx512f_64_Float Exp(const Avx512f_64_Float & val) noexcept {
+      return ExpAccurate(val);
+   }
+
+   friend inline Avx512f_64_Float Log(const Avx512f_64_Float & val) noexcept {
+      return LogAccurate(val);
+   }
+
+
+   template<
+      bool bDisableApprox,
+      bool bNegateInput = false,
+      bool bNaNPossible = true,
+      bool bUnderflowPossible = true,
+      bool bOverflowPossible = true,
+      bool bSpecialCaseZero = false,
+      typename std::enable_if<bDisableApprox, int>::type = 0
+   >
+   static inline Avx512f_64_Float ApproxExp(
+      const Avx512f_64_Float & val,
+      const int32_t addExpSchraudolphTerm = k_expTermZeroMeanErrorForSoftmaxWithZeroedLogit
+   ) noexcept {
+      UNUSED(addExpSchraudolphTerm);
+      return Exp(bNegateInput ? -val : val);
+   }
+
+   template<
+      bool bDisableApprox,
+      bool bNegateInput = false,
+      bool bNaNPossible = true,
+      bool bUnderflowPossible = true,
+      bool bOverflowPossible = true,
+      bool bSpecialCaseZero = false,
+      typename std::enable_if<!bDisableApprox, int>::type = 0
+   >
+   static inline Avx512f_64_Float ApproxExp(
+      const Avx512f_64_Float & val,
+      const int32_t addExpSchraudolphTerm = k_expTermZeroMeanErrorForSoftmaxWithZeroedLogit
+   ) noexcept {
+      // The Schraudolph trick in the float32 zones writes directly into the float exponent bits.  We keep the
+      // double exponent layout by applying the same scalar approximation as Cpu_64 to each lane, which keeps
+      // the results of this zone identical to Cpu_64
+      return ApplyFunc([addExpSchraudolphTerm](T x) {
+         return ExpApproxSchraudolph<
+            bNegateInput, bNaNPossible, bUnderflowPossible, bOverflowPossible, bSpecialCaseZero
+         >(x, addExpSchraudolphTerm);
+      }, val);
+   }
+
+   template<
+      bool bDisableApprox,
+      bool bNegateOutput = false,
+      bool bNaNPossible = true,
+      bool bNegativePossible = false,
+      bool bZeroPossible = false, // if false, positive zero returns a big negative number, negative zero returns a big positive number
+      bool bPositiveInfinityPossible = false, // if false, +inf returns a big positive number.  If val can be a double that is above the largest representable float, then setting this is necessary to avoid undefined behavior
+      typename std::enable_if<bDisableApprox, int>::type = 0
+   >
+   static inline Avx512f_64_Float ApproxLog(
+      const Avx512f_64_Float & val,
+      const float addLogSchraudolphTerm = k_logTermLowerBoundInputCloseToOne
+   ) noexcept {
+      UNUSED(addLogSchraudolphTerm);
+      Avx512f_64_Float ret = Log(val);
+      return bNegateOutput ? -ret : ret;
+   }
+
+   template<
+      bool bDisableApprox,
+      bool bNegateOutput = false,
+      bool bNaNPossible = true,
+      bool bNegativePossible = false,
+      bool bZeroPossible = false, // if false, positive zero returns a big negative number, negative zero returns a big positive number
+      bool bPositiveInfinityPossible = false, // if false, +inf returns a big positive number.  If val can be a double that is above the largest representable float, then setting this is necessary to avoid undefined behavior
+      typename std::enable_if<!bDisableApprox, int>::type = 0
+   >
+   static inline Avx512f_64_Float ApproxLog(
+      const Avx512f_64_Float & val,
+      const float addLogSchraudolphTerm = k_logTermLowerBoundInputCloseToOne
+   ) noexcept {
+      return ApplyFunc([addLogSchraudolphTerm](T x) {
+         return LogApproxSchraudolph<
+            bNegateOutput, bNaNPossible, bNegativePossible, bZeroPossible, bPositiveInfinityPossible
+         >(x, addLogSchraudolphTerm);
+      }, val);
+   }
+
+   friend inline T Sum(const Avx512f_64_Float & val) noexcept {
+      return _mm512_reduce_add_pd(val.m_data);
+   }
+
+
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorApplyUpdate(const Objective * const pObjective, ApplyUpdateBridge * const pData) noexcept {
+      RemoteApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, cCompilerPack>(pObjective, pData);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoosting<Avx512f_64_Float, bHessian, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingBags(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoostingBags<Avx512f_64_Float, bHessian, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bReplication, typename TQuantized, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingQuantized(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoostingQuantized<Avx512f_64_Float, bHessian, bReplication, TQuantized, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bWeight, size_t cCompilerScores, size_t cCompilerDimensions>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteraction(BinSumsInteractionBridge * const pParams) noexcept {
+      RemoteBinSumsInteraction<Avx512f_64_Float, bHessian, bWeight, cCompilerScores, cCompilerDimensions>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bWeight, size_t cCompilerScores>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteractionPartners(BinSumsInteractionBridge * const pParams) noexcept {
+      RemoteBinSumsInteractionPartners<Avx512f_64_Float, bHessian, bWeight, cCompilerScores>(pParams);
+      return Error_None;
+   }
+
+
+private:
+
+   inline Avx512f_64_Float(const TPack & data) noexcept : m_data(data) {
+   }
+
+   TPack m_data;
+};
+static_assert(std::is_standard_layout<Avx512f_64_Float>::value && std::is_trivially_copyable<Avx512f_64_Float>::value,
+   "This allows offsetof, memcpy, memset, inter-language, GPU and cross-machine use where needed");
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm ApplyUpdate_Avx512f_64(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   ApplyUpdateBridge * const pData
+) {
+   const Objective * const pObjective = static_cast<const Objective *>(pObjectiveWrapper->m_pObjective);
+   const APPLY_UPDATE_CPP pApplyUpdateCpp =
+      (static_cast<FunctionPointersCpp*>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pApplyUpdateCpp;
+
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pData->m_aMulticlassMidwayTemp));
+   EBM_ASSERT(IsAligned(pData->m_aUpdateTensorScores));
+   EBM_ASSERT(IsAligned(pData->m_aPacked));
+   EBM_ASSERT(IsAligned(pData->m_aTargets));
+   EBM_ASSERT(IsAligned(pData->m_aWeights));
+   EBM_ASSERT(IsAligned(pData->m_aSampleScores));
+   EBM_ASSERT(IsAligned(pData->m_aGradientsAndHessians));
+
+   return (*pApplyUpdateCpp)(pObjective, pData);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsBoosting_Avx512f_64(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   BinSumsBoostingBridge * const pParams
+) {
+   const BIN_SUMS_BOOSTING_CPP pBinSumsBoostingCpp =
+      (static_cast<FunctionPointersCpp *>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pBinSumsBoostingCpp;
+
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
+   EBM_ASSERT(IsAligned(pParams->m_aWeights));
+   EBM_ASSERT(IsAligned(pParams->m_pCountOccurrences));
+   EBM_ASSERT(IsAligned(pParams->m_aPacked));
+   EBM_ASSERT(IsAligned(pParams->m_aFastBins));
+
+   return (*pBinSumsBoostingCpp)(pParams);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsInteraction_Avx512f_64(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   BinSumsInteractionBridge * const pParams
+) {
+   const BIN_SUMS_INTERACTION_CPP pBinSumsInteractionCpp =
+      (static_cast<FunctionPointersCpp *>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pBinSumsInteractionCpp;
+
+#ifndef NDEBUG
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
+   EBM_ASSERT(IsAligned(pParams->m_aWeights));
+   EBM_ASSERT(IsAligned(pParams->m_aFastBins));
+   for(size_t iDebug = 0; iDebug < pParams->m_cRuntimeRealDimensions; ++iDebug) {
+      EBM_ASSERT(IsAligned(pParams->m_aaPacked[iDebug]));
+   }
+#endif // NDEBUG
+
+   return (*pBinSumsInteractionCpp)(pParams);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm CreateObjective_Avx512f_64(
+   const Config * const pConfig,
+   const char * const sObjective,
+   const char * const sObjectiveEnd,
+   ObjectiveWrapper * const pObjectiveWrapperOut
+) {
+   pObjectiveWrapperOut->m_pApplyUpdateC = ApplyUpdate_Avx512f_64;
+   pObjectiveWrapperOut->m_pBinSumsBoostingC = BinSumsBoosting_Avx512f_64;
+   pObjectiveWrapperOut->m_pBinSumsInteractionC = BinSumsInteraction_Avx512f_64;
+   ErrorEbm error = ComputeWrapper<Avx512f_64_Float>::FillWrapper(pObjectiveWrapperOut);
+   if(Error_None != error) {
+      return error;
+   }
+   return Objective::CreateObjective<Avx512f_64_Float>(pConfig, sObjective, sObjectiveEnd, pObjectiveWrapperOut);
+}
+
+} // DEFINED_ZONE_NAME
+
+#endif // BRIDGE_AVX512F_32
@@ -0,0 +1,491 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#define _CRT_SECURE_NO_DEPRECATE
+
+#include <cmath> // exp, log
+#include <limits> // numeric_limits
+#include <type_traits> // is_unsigned
+
+#include "libebm.h"
+#include "logging.h"
+#include "unzoned.h"
+
+#define ZONE_cpu
+#include "zones.h"
+
+#include "bridge.h"
+#include "common.hpp"
+#include "bridge.hpp"
+
+#include "Registration.hpp"
+#include "Objective.hpp"
+
+#include "approximate_math.hpp"
+#include "compute_wrapper.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// this is super-special and included inside the zone namespace
+#include "objective_registrations.hpp"
+
+// Cpu_32 is the scalar counterpart of the 32 bit SIMD zones.  It computes in float and packs into uint32_t, which
+// halves the memory traffic of ApplyUpdate and BinSums on machines without AVX2 compared to Cpu_64.  Like the
+// SIMD zones, its data subsets are limited to k_cSubsetSamplesMax samples to keep the float sums precise.
+
+struct Cpu_32_Float;
+
+struct Cpu_32_Int final {
+   friend Cpu_32_Float;
+   friend inline Cpu_32_Float IfEqual(const Cpu_32_Int & cmp1, const Cpu_32_Int & cmp2, const Cpu_32_Float & trueVal, const Cpu_32_Float & falseVal) noexcept;
+
+   using T = uint32_t;
+   using TPack = uint32_t;
+   static_assert(std::is_unsigned<T>::value, "T must be an unsigned integer type");
+   static_assert(std::is_same<UIntBig, T>::value || std::is_same<UIntSmall, T>::value,
+      "T must be either UIntBig or UIntSmall");
+   // like Cpu_64 every objective can be compiled for this zone, including those registered as CPU only
+   static constexpr AccelerationFlags k_zone = AccelerationFlags_NONE;
+   static constexpr int k_cSIMDShift = 0;
+   static constexpr int k_cSIMDPack = 1 << k_cSIMDShift;
+
+   ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
+   inline Cpu_32_Int() noexcept {
+   }
+
+   inline Cpu_32_Int(const T & val) noexcept : m_data(val) {
+   }
+
+   inline static Cpu_32_Int Load(const T * const a) noexcept {
+      return Cpu_32_Int(*a);
+   }
+
+   inline void Store(T * const a) const noexcept {
+      *a = m_data;
+   }
+
+   inline static Cpu_32_Int LoadBytes(const uint8_t * const a) noexcept {
+      return Cpu_32_Int(*a);
+   }
+
+   template<typename TFunc, typename... TArgs>
+   static inline void Execute(const TFunc & func, const TArgs &... args) noexcept {
+      func(0, (args.m_data)...);
+   }
+
+   inline static Cpu_32_Int MakeIndexes() noexcept {
+      return Cpu_32_Int(0);
+   }
+
+   inline Cpu_32_Int operator+ (const Cpu_32_Int & other) const noexcept {
+      return Cpu_32_Int(m_data + other.m_data);
+   }
+
+   inline Cpu_32_Int operator* (const T & other) const noexcept {
+      return Cpu_32_Int(m_data * other);
+   }
+
+   inline Cpu_32_Int operator>> (int shift) const noexcept {
+      return Cpu_32_Int(m_data >> shift);
+   }
+
+   inline Cpu_32_Int operator<< (int shift) const noexcept {
+      return Cpu_32_Int(m_data << shift);
+   }
+
+   inline Cpu_32_Int operator& (const Cpu_32_Int & other) const noexcept {
+      return Cpu_32_Int(m_data & other.m_data);
+   }
+
+private:
+   TPack m_data;
+};
+static_assert(std::is_standard_layout<Cpu_32_Int>::value && std::is_trivially_copyable<Cpu_32_Int>::value,
+   "This allows offsetof, memcpy, memset, inter-language, GPU and cross-machine use where needed");
+
+
+struct Cpu_32_Float final {
+   using T = float;
+   using TPack = float;
+   using TInt = Cpu_32_Int;
+   static_assert(std::is_same<FloatBig, T>::value || std::is_same<FloatSmall, T>::value,
+      "T must be either FloatBig or FloatSmall");
+   static constexpr AccelerationFlags k_zone = TInt::k_zone;
+   static constexpr int k_cSIMDShift = TInt::k_cSIMDShift;
+   static constexpr int k_cSIMDPack = TInt::k_cSIMDPack;
+
+   ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
+   inline Cpu_32_Float() noexcept {
+   }
+
+   inline Cpu_32_Float(const double val) noexcept : m_data(static_cast<T>(val)) {
+   }
+   inline Cpu_32_Float(const float val) noexcept : m_data(static_cast<T>(val)) {
+   }
+   inline Cpu_32_Float(const int val) noexcept : m_data(static_cast<T>(val)) {
+   }
+
+
+   inline Cpu_32_Float operator+() const noexcept {
+      return *this;
+   }
+
+   inline Cpu_32_Float operator-() const noexcept {
+      return Cpu_32_Float(-m_data);
+   }
+
+
+   inline Cpu_32_Float operator+ (const Cpu_32_Float & other) const noexcept {
+      return Cpu_32_Float(m_data + other.m_data);
+   }
+
+   inline Cpu_32_Float operator- (const Cpu_32_Float & other) const noexcept {
+      return Cpu_32_Float(m_data - other.m_data);
+   }
+
+   inline Cpu_32_Float operator* (const Cpu_32_Float & other) const noexcept {
+      return Cpu_32_Float(m_data * other.m_data);
+   }
+
+   inline Cpu_32_Float operator/ (const Cpu_32_Float & other) const noexcept {
+      return Cpu_32_Float(m_data / other.m_data);
+   }
+
+
+   inline Cpu_32_Float & operator+= (const Cpu_32_Float & other) noexcept {
+      *this = (*this) + other;
+      return *this;
+   }
+
+   inline Cpu_32_Float & operator-= (const Cpu_32_Float & other) noexcept {
+      *this = (*this) - other;
+      return *this;
+   }
+
+   inline Cpu_32_Float & operator*= (const Cpu_32_Float & other) noexcept {
+      *this = (*this) * other;
+      return *this;
+   }
+
+   inline Cpu_32_Float & operator/= (const Cpu_32_Float & other) noexcept {
+      *this = (*this) / other;
+      return *this;
+   }
+
+
+   friend inline Cpu_32_Float operator+ (const double val, const Cpu_32_Float & other) noexcept {
+      return Cpu_32_Float(val) + other;
+   }
+
+   friend inline Cpu_32_Float operator- (const double val, const Cpu_32_Float & other) noexcept {
+      return Cpu_32_Float(val) - other;
+   }
+
+   friend inline Cpu_32_Float operator* (const double val, const Cpu_32_Float & other) noexcept {
+      return Cpu_32_Float(val) * other;
+   }
+
+   friend inline Cpu_32_Float operator/ (const double val, const Cpu_32_Float & other) noexcept {
+      return Cpu_32_Float(val) / other;
+   }
+
+
+   friend inline Cpu_32_Float operator+ (const float val, const Cpu_32_Float & other) noexcept {
+      return Cpu_32_Float(val) + other;
+   }
+
+   friend inline Cpu_32_Float operator- (const float val, const Cpu_32_Float & other) noexcept {
+      return Cpu_32_Float(val) - other;
+   }
+
+   friend inline Cpu_32_Float operator* (const float val, const Cpu_32_Float & other) noexcept {
+      return Cpu_32_Float(val) * other;
+   }
+
+   friend inline Cpu_32_Float operator/ (const float val, const Cpu_32_Float & other) noexcept {
+      return Cpu_32_Float(val) / other;
+   }
+
+
+   inline static Cpu_32_Float Load(const T * const a) noexcept {
+      return Cpu_32_Float(*a);
+   }
+
+   inline void Store(T * const a) const noexcept {
+      *a = m_data;
+   }
+
+   inline static Cpu_32_Float Load(const T * const a, const TInt & i) noexcept {
+      return Cpu_32_Float(a[i.m_data]);
+   }
+
+   inline void Store(T * const a, const TInt & i) const noexcept {
+      a[i.m_data] = m_data;
+   }
+
+   template<typename TFunc>
+   friend inline Cpu_32_Float ApplyFunc(const TFunc & func, const Cpu_32_Float & val) noexcept {
+      return Cpu_32_Float(func(val.m_data));
+   }
+
+   template<typename TFunc, typename... TArgs>
+   static inline void Execute(const TFunc & func, const TArgs &... args) noexcept {
+      func(0, (args.m_data)...);
+   }
+
+   friend inline Cpu_32_Float IfLess(const Cpu_32_Float & cmp1, const Cpu_32_Float & cmp2, const Cpu_32_Float & trueVal, const Cpu_32_Float & falseVal) noexcept {
+      return cmp1.m_data < cmp2.m_data ? trueVal : falseVal;
+   }
+
+   friend inline Cpu_32_Float IfEqual(const Cpu_32_Float & cmp1, const Cpu_32_Float & cmp2, const Cpu_32_Float & trueVal, const Cpu_32_Float & falseVal) noexcept {
+      return cmp1.m_data == cmp2.m_data ? trueVal : falseVal;
+   }
+
+   friend inline Cpu_32_Float IfNaN(const Cpu_32_Float & cmp, const Cpu_32_Float & trueVal, const Cpu_32_Float & falseVal) noexcept {
+      return std::isnan(cmp.m_data) ? trueVal : falseVal;
+   }
+
+   friend inline Cpu_32_Float IfEqual(const Cpu_32_Int & cmp1, const Cpu_32_Int & cmp2, const Cpu_32_Float & trueVal, const Cpu_32_Float & falseVal) noexcept {
+      return cmp1.m_data == cmp2.m_data ? trueVal : falseVal;
+   }
+
+   friend inline Cpu_32_Float Abs(const Cpu_32_Float & val) noexcept {
+      return Cpu_32_Float(std::abs(val.m_data));
+   }
+
+   friend inline Cpu_32_Float FastApproxReciprocal(const Cpu_32_Float & val) noexcept {
+      return Cpu_32_Float(T { 1.0 } / val.m_data);
+   }
+
+   friend inline Cpu_32_Float FastApproxDivide(const Cpu_32_Float & dividend, const Cpu_32_Float & divisor) noexcept {
+      return Cpu_32_Float(dividend.m_data / divisor.m_data);
+   }
+
+   friend inline Cpu_32_Float FusedMultiplyAdd(const Cpu_32_Float & mul1, const Cpu_32_Float & mul2, const Cpu_32_Float & add) noexcept {
+      return mul1 * mul2 + add;
+   }
+
+   friend inline Cpu_32_Float FusedNegateMultiplyAdd(const Cpu_32_Float & mul1, const Cpu_32_Float & mul2, const Cpu_32_Float & add) noexcept {
+      return add - mul1 * mul2;
+   }
+
+   friend inline Cpu_32_Float Sqrt(const Cpu_32_Float & val) noexcept {
+      return Cpu_32_Float(std::sqrt(val.m_data));
+   }
+
+   friend inline Cpu_32_Float Exp(const Cpu_32_Float & val) noexcept {
+      return Cpu_32_Float(std::exp(val.m_data));
+   }
+
+   friend inline Cpu_32_Float Log(const Cpu_32_Float & val) noexcept {
+      return Cpu_32_Float(std::log(val.m_data));
+   }
+
+
+
+
+   template<
+      bool bDisableApprox,
+      bool bNegateInput = false,
+      bool bNaNPossible = true,
+      bool bUnderflowPossible = true,
+      bool bOverflowPossible = true,
+      bool bSpecialCaseZero = false,
+      typename std::enable_if<bDisableApprox, int>::type = 0
+   >
+   static inline Cpu_32_Float ApproxExp(
+      const Cpu_32_Float & val,
+      const int32_t addExpSchraudolphTerm = k_expTermZeroMeanErrorForSoftmaxWithZeroedLogit
+   ) noexcept {
+      UNUSED(addExpSchraudolphTerm);
+      return Exp(bNegateInput ? -val : val);
+   }
+
+   template<
+      bool bDisableApprox,
+      bool bNegateInput = false,
+      bool bNaNPossible = true,
+      bool bUnderflowPossible = true,
+      bool bOverflowPossible = true,
+      bool bSpecialCaseZero = false,
+      typename std::enable_if<!bDisableApprox, int>::type = 0
+   >
+   static inline Cpu_32_Float ApproxExp(
+      const Cpu_32_Float & val, 
+      const int32_t addExpSchraudolphTerm = k_expTermZeroMeanErrorForSoftmaxWithZeroedLogit
+   ) noexcept {
+      // TODO: we might want different constants for binary classification and multiclass. See notes in approximate_math.hpp
+      return Cpu_32_Float(ExpApproxSchraudolph<
+         bNegateInput, bNaNPossible, bUnderflowPossible, bOverflowPossible, bSpecialCaseZero
+      >(val.m_data, addExpSchraudolphTerm));
+   }
+
+
+   template<
+      bool bDisableApprox,
+      bool bNegateOutput = false,
+      bool bNaNPossible = true,
+      bool bNegativePossible = false,
+      bool bZeroPossible = false, // if false, positive zero returns a big negative number, negative zero returns a big positive number
+      bool bPositiveInfinityPossible = false, // if false, +inf returns a big positive number.  If val can be a double that is above the largest representable float, then setting this is necessary to avoid undefined behavior
+      typename std::enable_if<bDisableApprox, int>::type = 0
+   >
+   static inline Cpu_32_Float ApproxLog(
+      const Cpu_32_Float & val, 
+      const float addLogSchraudolphTerm = k_logTermLowerBoundInputCloseToOne
+   ) noexcept {
+      UNUSED(addLogSchraudolphTerm);
+      Cpu_32_Float ret = Log(val);
+      return bNegateOutput ? -ret : ret;
+   }
+
+   template<
+      bool bDisableApprox,
+      bool bNegateOutput = false,
+      bool bNaNPossible = true,
+      bool bNegativePossible = false,
+      bool bZeroPossible = false, // if false, positive zero returns a big negative number, negative zero returns a big positive number
+      bool bPositiveInfinityPossible = false, // if false, +inf returns a big positive number.  If val can be a double that is above the largest representable float, then setting this is necessary to avoid undefined behavior
+      typename std::enable_if<!bDisableApprox, int>::type = 0
+   >
+   static inline Cpu_32_Float ApproxLog(
+      const Cpu_32_Float & val, 
+      const float addLogSchraudolphTerm = k_logTermLowerBoundInputCloseToOne
+   ) noexcept {
+      return Cpu_32_Float(LogApproxSchraudolph<
+         bNegateOutput, bNaNPossible, bNegativePossible, bZeroPossible, bPositiveInfinityPossible
+      >(val.m_data, addLogSchraudolphTerm));
+   }
+
+   friend inline T Sum(const Cpu_32_Float & val) noexcept {
+      return val.m_data;
+   }
+
+
+   template<typename TObjective, bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorApplyUpdate(const Objective * const pObjective, ApplyUpdateBridge * const pData) noexcept {
+      RemoteApplyUpdate<TObjective, bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, cCompilerPack>(pObjective, pData);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bWeight, bool bReplication, size_t cCompilerScores, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoosting<Cpu_32_Float, bHessian, bWeight, bReplication, cCompilerScores, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingBags(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoostingBags<Cpu_32_Float, bHessian, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bReplication, typename TQuantized, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingQuantized(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoostingQuantized<Cpu_32_Float, bHessian, bReplication, TQuantized, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bWeight, size_t cCompilerScores, size_t cCompilerDimensions>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteraction(BinSumsInteractionBridge * const pParams) noexcept {
+      RemoteBinSumsInteraction<Cpu_32_Float, bHessian, bWeight, cCompilerScores, cCompilerDimensions>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bWeight, size_t cCompilerScores>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteractionPartners(BinSumsInteractionBridge * const pParams) noexcept {
+      RemoteBinSumsInteractionPartners<Cpu_32_Float, bHessian, bWeight, cCompilerScores>(pParams);
+      return Error_None;
+   }
+
+
+private:
+
+   TPack m_data;
+};
+static_assert(std::is_standard_layout<Cpu_32_Float>::value && std::is_trivially_copyable<Cpu_32_Float>::value,
+   "This allows offsetof, memcpy, memset, inter-language, GPU and cross-machine use where needed");
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm ApplyUpdate_Cpu_32(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   ApplyUpdateBridge * const pData
+) {
+   const Objective * const pObjective = static_cast<const Objective *>(pObjectiveWrapper->m_pObjective);
+   const APPLY_UPDATE_CPP pApplyUpdateCpp =
+      (static_cast<FunctionPointersCpp*>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pApplyUpdateCpp;
+
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pData->m_aMulticlassMidwayTemp));
+   EBM_ASSERT(IsAligned(pData->m_aUpdateTensorScores));
+   EBM_ASSERT(IsAligned(pData->m_aPacked));
+   EBM_ASSERT(IsAligned(pData->m_aTargets));
+   EBM_ASSERT(IsAligned(pData->m_aWeights));
+   EBM_ASSERT(IsAligned(pData->m_aSampleScores));
+   EBM_ASSERT(IsAligned(pData->m_aGradientsAndHessians));
+
+   return (*pApplyUpdateCpp)(pObjective, pData);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsBoosting_Cpu_32(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   BinSumsBoostingBridge * const pParams
+) {
+   const BIN_SUMS_BOOSTING_CPP pBinSumsBoostingCpp =
+      (static_cast<FunctionPointersCpp *>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pBinSumsBoostingCpp;
+
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
+   EBM_ASSERT(IsAligned(pParams->m_aWeights));
+   EBM_ASSERT(IsAligned(pParams->m_pCountOccurrences));
+   EBM_ASSERT(IsAligned(pParams->m_aPacked));
+   EBM_ASSERT(IsAligned(pParams->m_aFastBins));
+
+   return (*pBinSumsBoostingCpp)(pParams);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm BinSumsInteraction_Cpu_32(
+   const ObjectiveWrapper * const pObjectiveWrapper,
+   BinSumsInteractionBridge * const pParams
+) {
+   const BIN_SUMS_INTERACTION_CPP pBinSumsInteractionCpp =
+      (static_cast<FunctionPointersCpp *>(pObjectiveWrapper->m_pFunctionPointersCpp))->m_pBinSumsInteractionCpp;
+
+#ifndef NDEBUG
+   // all our memory should be aligned. It is required by SIMD for correctness or performance
+   EBM_ASSERT(IsAligned(pParams->m_aGradientsAndHessians));
+   EBM_ASSERT(IsAligned(pParams->m_aWeights));
+   EBM_ASSERT(IsAligned(pParams->m_aFastBins));
+   for (size_t iDebug = 0; iDebug < pParams->m_cRuntimeRealDimensions; ++iDebug) {
+      EBM_ASSERT(IsAligned(pParams->m_aaPacked[iDebug]));
+   }
+#endif // NDEBUG
+
+   return (*pBinSumsInteractionCpp)(pParams);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm CreateObjective_Cpu_32(
+   const Config * const pConfig,
+   const char * const sObjective,
+   const char * const sObjectiveEnd,
+   ObjectiveWrapper * const pObjectiveWrapperOut
+) {
+   pObjectiveWrapperOut->m_pApplyUpdateC = ApplyUpdate_Cpu_32;
+   pObjectiveWrapperOut->m_pBinSumsBoostingC = BinSumsBoosting_Cpu_32;
+   pObjectiveWrapperOut->m_pBinSumsInteractionC = BinSumsInteraction_Cpu_32;
+   ErrorEbm error = ComputeWrapper<Cpu_32_Float>::FillWrapper(pObjectiveWrapperOut);
+   if(Error_None != error) {
+      return error;
+   }
+   return Objective::CreateObjective<Cpu_32_Float>(pConfig, sObjective, sObjectiveEnd, pObjectiveWrapperOut);
+}
+
+} // DEFINED_ZONE_NAME
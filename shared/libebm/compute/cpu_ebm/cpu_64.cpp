@@ -375,6 +375,20 @@ struct Cpu_64_Float final {
    }
 
 
+   template<bool bHessian, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingBags(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoostingBags<Cpu_64_Float, bHessian, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bReplication, typename TQuantized, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingQuantized(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoostingQuantized<Cpu_64_Float, bHessian, bReplication, TQuantized, cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
    template<bool bHessian, bool bWeight, size_t cCompilerScores, size_t cCompilerDimensions>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteraction(BinSumsInteractionBridge * const pParams) noexcept {
       RemoteBinSumsInteraction<Cpu_64_Float, bHessian, bWeight, cCompilerScores, cCompilerDimensions>(pParams);
@@ -382,6 +396,13 @@ struct Cpu_64_Float final {
    }
 
 
+   template<bool bHessian, bool bWeight, size_t cCompilerScores>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteractionPartners(BinSumsInteractionBridge * const pParams) noexcept {
+      RemoteBinSumsInteractionPartners<Cpu_64_Float, bHessian, bWeight, cCompilerScores>(pParams);
+      return Error_None;
+   }
+
+
 private:
 
    TPack m_data;
@@ -480,6 +480,24 @@ struct Cuda_32_Float final {
    }
 
 
+   template<bool bHessian, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingBags(BinSumsBoostingBridge * const pParams) noexcept {
+      // TODO: move memory to the GPU and return errors
+      static constexpr size_t k_cItems = 5;
+      RemoteBinSumsBoostingBags<Cuda_32_Float, bHessian, cCompilerPack><<<1, k_cItems>>>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, bool bReplication, typename TQuantized, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoostingQuantized(BinSumsBoostingBridge * const pParams) noexcept {
+      // TODO: move memory to the GPU and return errors
+      static constexpr size_t k_cItems = 5;
+      RemoteBinSumsBoostingQuantized<Cuda_32_Float, bHessian, bReplication, TQuantized, cCompilerPack><<<1, k_cItems>>>(pParams);
+      return Error_None;
+   }
+
+
    template<bool bHessian, size_t cCompilerScores, size_t cCompilerDimensions, bool bWeight>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteraction(BinSumsInteractionBridge * const pParams) noexcept {
       // TODO: move memory to the GPU and return errors
@@ -489,6 +507,15 @@ struct Cuda_32_Float final {
    }
 
 
+   template<bool bHessian, bool bWeight, size_t cCompilerScores>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteractionPartners(BinSumsInteractionBridge * const pParams) noexcept {
+      // TODO: move memory to the GPU and return errors
+      static constexpr size_t k_cItems = 5;
+      RemoteBinSumsInteractionPartners<Cuda_32_Float, bHessian, bWeight, cCompilerScores><<<1, k_cItems>>>(pParams);
+      return Error_None;
+   }
+
+
 
 private:
 
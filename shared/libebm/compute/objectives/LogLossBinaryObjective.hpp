@@ -73,6 +73,26 @@ struct LogLossBinaryObjective : BinaryObjective {
 
    template<bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack>
    GPU_DEVICE NEVER_INLINE void InjectedApplyUpdate(ApplyUpdateBridge * const pData) const {
+      // when the data is sorted by target every sample in the subset has the same class, which lets us select the
+      // numerator and the sign of the score at compile time and skip loading the targets
+      if(ptrdiff_t { 0 } == pData->m_iTargetConst) {
+         TargetApplyUpdate<bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, cCompilerPack, 0>(pData);
+      } else if(ptrdiff_t { 1 } == pData->m_iTargetConst) {
+         TargetApplyUpdate<bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, cCompilerPack, 1>(pData);
+      } else {
+#ifndef GPU_COMPILE
+         EBM_ASSERT(k_iTargetPerSample == pData->m_iTargetConst);
+#endif // GPU_COMPILE
+         TargetApplyUpdate<bValidation, bWeight, bHessian, bDisableApprox, cCompilerScores, cCompilerPack, k_iCompilerTargetPerSample>(pData);
+      }
+   }
+
+private:
+
+   static constexpr int k_iCompilerTargetPerSample = -1;
+
+   template<bool bValidation, bool bWeight, bool bHessian, bool bDisableApprox, size_t cCompilerScores, int cCompilerPack, int cCompilerTarget>
+   GPU_DEVICE INLINE_ALWAYS void TargetApplyUpdate(ApplyUpdateBridge * const pData) const {
       static_assert(k_oneScore == cCompilerScores, "We special case the classifiers so do not need to handle them");
       static_assert(!bValidation || !bHessian, "bHessian can only be true if bValidation is false");
       static_assert(bValidation || !bWeight, "bWeight can only be true if bValidation is true");
@@ -86,7 +106,7 @@ struct LogLossBinaryObjective : BinaryObjective {
       EBM_ASSERT(0 == pData->m_cSamples % size_t { TFloat::k_cSIMDPack });
       EBM_ASSERT(nullptr != pData->m_aSampleScores);
       EBM_ASSERT(1 == pData->m_cScores);
-      EBM_ASSERT(nullptr != pData->m_aTargets);
+      EBM_ASSERT(k_iCompilerTargetPerSample != cCompilerTarget || nullptr != pData->m_aTargets);
 #endif // GPU_COMPILE
 
       const typename TFloat::T * const aUpdateTensorScores = reinterpret_cast<const typename TFloat::T *>(pData->m_aUpdateTensorScores);
@@ -157,8 +177,7 @@ struct LogLossBinaryObjective : BinaryObjective {
             pInputData += TFloat::TInt::k_cSIMDPack;
          }
          while(true) {
-            // TODO: the speed of this loop can probably be improved by (AFTER eliminating the target by sorting the data):
-            //   0) eliminate the target by sorting the data and making it a templated argument, so it has 0 CPU cost
+            // TODO: the speed of this loop can probably be improved by:
             //   1) fetch the score from memory (predictable load is fast)
             //   2) issue the gather operation FOR THE NEXT loop(unpredictable load is slow)
             //   3) move the fetched gather operation from the previous loop into a new register
@@ -172,8 +191,11 @@ struct LogLossBinaryObjective : BinaryObjective {
                updateScore = TFloat::Load(aUpdateTensorScores, iTensorBin);
             }
 
-            const typename TFloat::TInt target = TFloat::TInt::Load(pTargetData);
-            pTargetData += TFloat::TInt::k_cSIMDPack;
+            typename TFloat::TInt target;
+            if(k_iCompilerTargetPerSample == cCompilerTarget) {
+               target = TFloat::TInt::Load(pTargetData);
+               pTargetData += TFloat::TInt::k_cSIMDPack;
+            }
 
             TFloat sampleScore = TFloat::Load(pSampleScore);
             sampleScore += updateScore;
@@ -181,13 +203,16 @@ struct LogLossBinaryObjective : BinaryObjective {
             pSampleScore += TFloat::k_cSIMDPack;
 
             if(bValidation) {
-               // TODO: similar to the gradient calculation above, once we sort our data by the target values we
-               //       will be able to pass all the targets==0 and target==1 in to a single call to this function
-               //       and we can therefore template the target value.  We can then call ExpForBinaryClassification
-               //       with a TEMPLATED parameter that indicates it if should negative sampleScore within the function
-               //       This will eliminate both the IfEqual call, and also the negation, so it's a great optimization.
+               // TODO: when the target is templated we could call ExpForBinaryClassification with a TEMPLATED 
+               //       parameter that indicates if it should negate sampleScore within the function, which would
+               //       also eliminate the negation below
                
-               TFloat metric = IfEqual(typename TFloat::TInt(0), target, sampleScore, -sampleScore);
+               TFloat metric;
+               if(k_iCompilerTargetPerSample == cCompilerTarget) {
+                  metric = IfEqual(typename TFloat::TInt(0), target, sampleScore, -sampleScore);
+               } else {
+                  metric = 0 == cCompilerTarget ? sampleScore : -sampleScore;
+               }
                metric = TFloat::template ApproxExp<bDisableApprox, false>(metric);
                metric += 1.0;
                metric = TFloat::template ApproxLog<bDisableApprox, false>(metric);
@@ -210,13 +235,10 @@ struct LogLossBinaryObjective : BinaryObjective {
                // gradient will be +0.5 if actual value was 1 but we were 50%/50% by having sampleScore be 0
                // gradient will be -0.5 if actual value was 0 but we were 50%/50% by having sampleScore be 0
 
-               // TODO : In the future we'll sort our data by the target value and process them together, so we'll 
-               //    know ahead of time if 0 == target or 1 == target.  This means we can pre-select the numerator
-               //    to be either +1 or -1 as a template controlled constant that doesn't need to be runtime selected
-               // TODO : In the future we'll sort our data by the target value and process them together. Once that
-               //    happens we can eliminate the runtime check that can negate sampleScore AND we can also 
-               //    avoid the negation itself by calling ExpForBinaryClassification with a templated parameter
-               //    to use negative constants that will effectively take the exp of -sampleScore for no cost
+               // When the data is sorted by target we know ahead of time if 0 == target or 1 == target, so the
+               //    numerator is a template controlled constant and the runtime check that negates sampleScore is gone.
+               // TODO : we could also avoid the negation itself by calling ExpForBinaryClassification with a templated 
+               //    parameter to use negative constants that will effectively take the exp of -sampleScore for no cost
                // 
                // !!! IMPORTANT: when using an approximate exp function, the formula used to compute the gradients becomes very
                //                important.  We want something that is balanced from positive to negative, which this version
@@ -235,8 +257,18 @@ struct LogLossBinaryObjective : BinaryObjective {
                //                const FLOAT gradient = (UNPREDICTABLE(0 == target) ? FLOAT { -1 } : FLOAT { 1 }) / (FLOAT{ 1 } + ExpForBinaryClassification(UNPREDICTABLE(0 == target) ? -sampleScore : sampleScore));
                // !!! IMPORTANT: SEE ABOVE
 
-               const TFloat numerator = IfEqual(typename TFloat::TInt(0), target, TFloat(1), TFloat(-1));
-               TFloat denominator = IfEqual(typename TFloat::TInt(0), target, -sampleScore, sampleScore);
+               TFloat numerator;
+               TFloat denominator;
+               if(k_iCompilerTargetPerSample == cCompilerTarget) {
+                  numerator = IfEqual(typename TFloat::TInt(0), target, TFloat(1), TFloat(-1));
+                  denominator = IfEqual(typename TFloat::TInt(0), target, -sampleScore, sampleScore);
+               } else if(0 == cCompilerTarget) {
+                  numerator = 1.0;
+                  denominator = -sampleScore;
+               } else {
+                  numerator = -1.0;
+                  denominator = sampleScore;
+               }
                denominator = TFloat::template ApproxExp<bDisableApprox, false>(denominator);
                denominator += 1.0;
 
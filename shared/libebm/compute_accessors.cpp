@@ -138,15 +138,29 @@ static bool IsFMA3() {
    return 0 != (abcd[2] & (1 << 12));
 }
 
+static bool IsAVX512CD() {
+   // only call this if 9 <= DetectInstructionset(), which stands for AVX512F
+   // The avx512f zone is compiled with AVX512CD enabled because BinSumsBoosting uses vpconflictd. Every processor
+   // with AVX512F also implements AVX512CD, but check anyways like IsFMA3 does.
+   int abcd[4];
+   cpuid(abcd, 7);
+   return 0 != (abcd[1] & (1 << 28));
+}
+
 #endif // INTEL_SIMD
 
 extern ErrorEbm GetObjective(
    const Config * const pConfig,
    const char * sObjective,
    const AccelerationFlags acceleration,
+   const bool bDoublePrecision,
+   const bool bFloat32,
    ObjectiveWrapper * const pCpuObjectiveWrapperOut,
    ObjectiveWrapper * const pSIMDObjectiveWrapperOut
 ) noexcept {
+   // bDoublePrecision restricts us to the zones that compute in double, which are Cpu_64 and the 64 bit SIMD zones.
+   // bFloat32 is the caller asking for float32, which is the only way to get the scalar Cpu_32 zone
+
    EBM_ASSERT(nullptr != pConfig);
    EBM_ASSERT(nullptr != pCpuObjectiveWrapperOut);
    EBM_ASSERT(nullptr == pCpuObjectiveWrapperOut->m_pObjective);
@@ -173,20 +187,30 @@ extern ErrorEbm GetObjective(
       return error;
    }
 
-   const AccelerationFlags zones = static_cast<AccelerationFlags>(pCpuObjectiveWrapperOut->m_zones & acceleration);
+   // Cpu_64 is the default.  The SIMD zones change the results, either by computing in float32 or by summing in a
+   // different order, so they are only used when the caller asks for float32 or disables approximations
+   const AccelerationFlags zones = bDoublePrecision || bFloat32 ? 
+      static_cast<AccelerationFlags>(pCpuObjectiveWrapperOut->m_zones & acceleration) : AccelerationFlags_NONE;
 
    // when compiled with only CPU these variables are not used
    UNUSED(zones);
    UNUSED(pSIMDObjectiveWrapperOut);
+   UNUSED(bDoublePrecision);
+   EBM_ASSERT(!bDoublePrecision || !bFloat32);
 
    do {
 #ifdef BRIDGE_AVX512F_32
       if(0 != (AccelerationFlags_AVX512F & zones)) {
          LOG_0(Trace_Info, "INFO GetObjective checking for AVX512F compatibility");
          EBM_ASSERT(nullptr != pSIMDObjectiveWrapperOut);
-         if(9 <= DetectInstructionset()) {
-            LOG_0(Trace_Info, "INFO GetObjective creating AVX512F SIMD Objective");
-            error = CreateObjective_Avx512f_32(pConfig, sObjective, sObjectiveEnd, pSIMDObjectiveWrapperOut);
+         if(9 <= DetectInstructionset() && IsAVX512CD()) {
+            if(bDoublePrecision) {
+               LOG_0(Trace_Info, "INFO GetObjective creating AVX512F 64 bit SIMD Objective");
+               error = CreateObjective_Avx512f_64(pConfig, sObjective, sObjectiveEnd, pSIMDObjectiveWrapperOut);
+            } else {
+               LOG_0(Trace_Info, "INFO GetObjective creating AVX512F SIMD Objective");
+               error = CreateObjective_Avx512f_32(pConfig, sObjective, sObjectiveEnd, pSIMDObjectiveWrapperOut);
+            }
             if(Error_None != error) {
                return error;
             }
@@ -200,8 +224,13 @@ extern ErrorEbm GetObjective(
          LOG_0(Trace_Info, "INFO GetObjective checking for AVX2 compatibility");
          EBM_ASSERT(nullptr != pSIMDObjectiveWrapperOut);
          if(8 <= DetectInstructionset() && IsFMA3()) {
-            LOG_0(Trace_Info, "INFO GetObjective creating AVX2 SIMD Objective");
-            error = CreateObjective_Avx2_32(pConfig, sObjective, sObjectiveEnd, pSIMDObjectiveWrapperOut);
+            if(bDoublePrecision) {
+               LOG_0(Trace_Info, "INFO GetObjective creating AVX2 64 bit SIMD Objective");
+               error = CreateObjective_Avx2_64(pConfig, sObjective, sObjectiveEnd, pSIMDObjectiveWrapperOut);
+            } else {
+               LOG_0(Trace_Info, "INFO GetObjective creating AVX2 SIMD Objective");
+               error = CreateObjective_Avx2_32(pConfig, sObjective, sObjectiveEnd, pSIMDObjectiveWrapperOut);
+            }
             if(Error_None != error) {
                return error;
             }
@@ -210,12 +239,51 @@ extern ErrorEbm GetObjective(
       }
 #endif // BRIDGE_AVX2_32
 
+      // without SIMD we can still halve the memory bandwidth by computing in float on the CPU.  Every objective can
+      // run in this zone, so unlike SIMD it does not depend on the acceleration flags
+      if(bFloat32) {
+         LOG_0(Trace_Info, "INFO GetObjective creating 32 bit CPU Objective");
+         EBM_ASSERT(nullptr != pSIMDObjectiveWrapperOut);
+         error = CreateObjective_Cpu_32(pConfig, sObjective, sObjectiveEnd, pSIMDObjectiveWrapperOut);
+         if(Error_None != error) {
+            return error;
+         }
+         break;
+      }
+
       LOG_0(Trace_Info, "INFO GetObjective no SIMD option found");
    } while(false);
 
    return Error_None;
 }
 
+static DISCRETIZE_C DetectDiscretizeSIMD() noexcept {
+#ifdef BRIDGE_AVX512F_32
+   if(9 <= DetectInstructionset() && IsAVX512CD()) {
+      LOG_0(Trace_Info, "INFO GetDiscretizeSIMD using AVX512F");
+      return Discretize_Avx512f_32;
+   }
+#endif // BRIDGE_AVX512F_32
+
+#ifdef BRIDGE_AVX2_32
+   // the AVX2 zone is compiled with FMA enabled, so require it like GetObjective does
+   if(8 <= DetectInstructionset() && IsFMA3()) {
+      LOG_0(Trace_Info, "INFO GetDiscretizeSIMD using AVX2");
+      return Discretize_Avx2_32;
+   }
+#endif // BRIDGE_AVX2_32
+
+   LOG_0(Trace_Info, "INFO GetDiscretizeSIMD no SIMD option found");
+   return nullptr;
+}
+
+extern DISCRETIZE_C GetDiscretizeSIMD() noexcept {
+   // Discretize can be called once per sample, so detect the instruction set only once.  Static initialization
+   // of locals is thread safe in C++11
+   static const DISCRETIZE_C pDiscretizeSIMD = DetectDiscretizeSIMD();
+   return pDiscretizeSIMD;
+}
+
 #ifdef NEVER
 // TODO: eventually enable metrics
 INLINE_RELEASE_UNTEMPLATED static ErrorEbm GetMetrics(
@@ -7,6 +7,7 @@
 #include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
 #include <string.h> // memcpy
+#include <algorithm> // upper_bound
 
 #include "logging.h" // EBM_ASSERT
 #include "unzoned.h"
@@ -19,6 +20,7 @@
 
 #include "ebm_internal.hpp"
 #include "dataset_shared.hpp"
+#include "ThreadPool.hpp"
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -31,6 +33,7 @@ namespace DEFINED_ZONE_NAME {
 //   - our boosting algorithm is position independent, so we can sort the data by the target feature, which
 //     helps us because we can move the class number into a loop counter and not fetch the memory, and it allows
 //     us to elimiante a branch when calculating statistics since all samples will have the same target within a loop
+//     (DONE for CreateBoosterFlags_TargetSorted via SortDataSetByTarget, but only binary logloss uses it so far)
 //   - we'll be sorting on the target, so we can't sort primarily on intput features (secondary sort ok)
 //     So, sparse input features are not typically expected to clump into ranges of non - default parameters
 //     So, we won't use ranges in our representation, so our sparse feature representation will be
@@ -157,7 +160,6 @@ static_assert(std::is_trivial<FeatureDataSetShared>::value,
    "These structs are shared between processes, so they definetly need to be standard layout and trivial");
 
 struct SparseFeatureDataSetShared {
-   // TODO: implement sparse features
    UIntShared m_defaultVal;
    UIntShared m_cNonDefaults;
 
@@ -517,6 +519,9 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CheckDataSet(IntEbm countBytesAlloc
                return Error_IllegalParamVal;
             }
 
+            // the readers walk the non-default samples in order alongside the dense samples, so the sample
+            // indexes need to be strictly increasing
+            UIntShared iSampleMin = 0;
             const SparseFeatureDataSetSharedEntry * pNonDefault = ArrayToPointer(pSparseFeatureDataSetShared->m_nonDefaults);
             const SparseFeatureDataSetSharedEntry * const pNonDefaultEnd = &pNonDefault[cNonDefaults];
             while(pNonDefaultEnd != pNonDefault) {
@@ -525,10 +530,21 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CheckDataSet(IntEbm countBytesAlloc
                   return Error_IllegalParamVal;
                }
 
+               if(pNonDefault->m_iSample < iSampleMin) {
+                  LOG_0(Trace_Error, "ERROR CheckDataSet pNonDefault->m_iSample < iSampleMin");
+                  return Error_IllegalParamVal;
+               }
+               iSampleMin = pNonDefault->m_iSample + UIntShared { 1 };
+
                if(countBins <= pNonDefault->m_nonDefaultVal) {
                   LOG_0(Trace_Error, "ERROR CheckDataSet countBins <= pNonDefault->m_nonDefaultVal");
                   return Error_IllegalParamVal;
                }
+
+               if(defaultVal == pNonDefault->m_nonDefaultVal) {
+                  LOG_0(Trace_Error, "ERROR CheckDataSet defaultVal == pNonDefault->m_nonDefaultVal");
+                  return Error_IllegalParamVal;
+               }
                ++pNonDefault;
             }
          } else {
@@ -980,14 +996,143 @@ static IntEbm AppendHeader(
 }
 WARNING_POP
 
-static bool DecideIfSparse(const size_t cSamples, const IntEbm * binIndexes) {
-   // For sparsity in the data set shared memory the only thing that matters is compactness since we don't use
-   // this memory in any high performance loops
+// a feature is stored sparsely only if that takes no more memory than the dense bit packing.  The booster and the
+// interaction detector densify every feature when they load the dataset, so the sparse layout only saves memory in
+// the shared dataset and there is no reason to choose it when it is larger
+static bool DecideIfSparse(
+   const size_t cSamples,
+   const IntEbm * const binIndexes,
+   const size_t cBytesDense,
+   IntEbm * const pIndexBinDefaultOut,
+   size_t * const pcNonDefaultsOut
+) {
+   // The decision depends only on the data, so MeasureFeature and FillFeature always agree on it. We do not validate
+   // the bin indexes here. Illegal ones are rejected when the feature is filled
+
+   EBM_ASSERT(1 <= cSamples);
+   EBM_ASSERT(nullptr != binIndexes);
+   EBM_ASSERT(nullptr != pIndexBinDefaultOut);
+   EBM_ASSERT(nullptr != pcNonDefaultsOut);
+
+   // a sparse feature needs more than half of its samples in the default bin to be smaller than the densest bit
+   // packing, so the default bin is the majority bin, which the Boyer-Moore vote finds without a histogram
+   const IntEbm * pBinIndex = binIndexes;
+   const IntEbm * const pBinIndexesEnd = binIndexes + cSamples;
+   IntEbm indexBinCandidate = *pBinIndex;
+   size_t cVotes = 0;
+   do {
+      const IntEbm indexBin = *pBinIndex;
+      if(size_t { 0 } == cVotes) {
+         indexBinCandidate = indexBin;
+         cVotes = 1;
+      } else if(indexBinCandidate == indexBin) {
+         ++cVotes;
+      } else {
+         --cVotes;
+      }
+      ++pBinIndex;
+   } while(pBinIndexesEnd != pBinIndex);
+
+   size_t cNonDefaults = 0;
+   pBinIndex = binIndexes;
+   do {
+      if(indexBinCandidate != *pBinIndex) {
+         ++cNonDefaults;
+      }
+      ++pBinIndex;
+   } while(pBinIndexesEnd != pBinIndex);
+
+   *pIndexBinDefaultOut = indexBinCandidate;
+   *pcNonDefaultsOut = cNonDefaults;
 
-   UNUSED(cSamples);
-   UNUSED(binIndexes);
+   if(cSamples <= cNonDefaults * size_t { 2 }) {
+      return false;
+   }
 
-   // TODO: evalute the data to decide if the feature should be sparse or not
+   // cNonDefaults is less than cSamples, so this can only overflow on a system where the samples do not fit in memory
+   if(IsMultiplyError(sizeof(SparseFeatureDataSetSharedEntry), cNonDefaults)) {
+      return false;
+   }
+   const size_t cBytesNonDefaults = sizeof(SparseFeatureDataSetSharedEntry) * cNonDefaults;
+   const size_t cBytesSparseHeader = offsetof(SparseFeatureDataSetShared, m_nonDefaults);
+   return !IsAddError(cBytesSparseHeader, cBytesNonDefaults) && cBytesSparseHeader + cBytesNonDefaults <= cBytesDense;
+}
+
+// FeaturePack holds what is needed to bit pack the bin indexes of a feature into its section of the shared dataset.
+// The first data unit holds the leftover items, so every other unit holds cItemsPerBitPack items, which lets
+// separate threads pack separate ranges of units
+struct FeaturePack final {
+   IntEbm m_indexBinIllegal;
+   bool m_bMissing;
+   int m_cItemsPerBitPack;
+   int m_cBitsPerItemMax;
+   size_t m_cSamples;
+   size_t m_cDataUnits;
+   const IntEbm * m_aBinIndexes;
+   UIntShared * m_aFillData;
+};
+static_assert(std::is_standard_layout<FeaturePack>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<FeaturePack>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+// PackFeatureBins packs the data units [iUnitStart, iUnitEnd) and returns true if a bin index is illegal
+static bool PackFeatureBins(const FeaturePack * const pPack, const size_t iUnitStart, const size_t iUnitEnd) {
+   EBM_ASSERT(nullptr != pPack);
+   EBM_ASSERT(iUnitStart < iUnitEnd);
+   EBM_ASSERT(iUnitEnd <= pPack->m_cDataUnits);
+
+   const size_t cItemsPerBitPack = static_cast<size_t>(pPack->m_cItemsPerBitPack);
+   const int cBitsPerItemMax = pPack->m_cBitsPerItemMax;
+   const size_t cItemsFirst = (pPack->m_cSamples - size_t { 1 }) % cItemsPerBitPack + size_t { 1 };
+   const int cShiftReset = (pPack->m_cItemsPerBitPack - 1) * cBitsPerItemMax;
+   const IntEbm indexBinIllegal = pPack->m_indexBinIllegal;
+   const bool bMissing = pPack->m_bMissing;
+
+   int cShift = cShiftReset;
+   const IntEbm * pBinIndex = pPack->m_aBinIndexes;
+   if(size_t { 0 } == iUnitStart) {
+      cShift = static_cast<int>(cItemsFirst - size_t { 1 }) * cBitsPerItemMax;
+   } else {
+      pBinIndex += cItemsFirst + (iUnitStart - size_t { 1 }) * cItemsPerBitPack;
+   }
+   UIntShared * pFillData = pPack->m_aFillData + iUnitStart;
+   const UIntShared * const pFillDataEnd = pPack->m_aFillData + iUnitEnd;
+   do {
+      UIntShared bits = 0;
+      do {
+         IntEbm indexBin = *pBinIndex;
+         if(indexBinIllegal <= indexBin) {
+            LOG_0(Trace_Error, "ERROR PackFeatureBins indexBinIllegal <= indexBin");
+            return true;
+         }
+         if(bMissing) {
+            if(indexBin < IntEbm { 0 }) {
+               LOG_0(Trace_Error, "ERROR PackFeatureBins indexBin can't be negative");
+               return true;
+            }
+         } else {
+            if(indexBin <= IntEbm { 0 }) {
+               LOG_0(Trace_Error, "ERROR PackFeatureBins indexBin <= IntEbm { 0 }");
+               return true;
+            }
+            --indexBin;
+         }
+         ++pBinIndex;
+
+         // since countBins can be converted to these, so now can indexBin
+         EBM_ASSERT(!IsConvertError<UIntShared>(indexBin));
+
+         EBM_ASSERT(0 <= cShift);
+         EBM_ASSERT(cShift < COUNT_BITS(UIntShared));
+         bits |= static_cast<UIntShared>(indexBin) << cShift;
+         cShift -= cBitsPerItemMax;
+      } while(0 <= cShift);
+      cShift = cShiftReset;
+      *pFillData = bits;
+      ++pFillData;
+   } while(pFillDataEnd != pFillData);
+   EBM_ASSERT(iUnitEnd != pPack->m_cDataUnits || pBinIndex == pPack->m_aBinIndexes + pPack->m_cSamples);
    return false;
 }
 
@@ -1001,10 +1146,14 @@ static IntEbm AppendFeature(
    const IntEbm countSamples,
    const IntEbm * binIndexes,
    const size_t cBytesAllocated,
-   unsigned char * const pFillMem
+   unsigned char * const pFillMem,
+   FeaturePack * const pPackOut = nullptr
 ) {
+   // if pPackOut is not nullptr the bin indexes are not packed.  pPackOut receives what is needed to pack them later
+   // and the dataset is not locked if this is its last section, so the caller needs to do both
    EBM_ASSERT(size_t { 0 } == cBytesAllocated && nullptr == pFillMem || 
       nullptr != pFillMem && k_cBytesHeaderId <= cBytesAllocated);
+   EBM_ASSERT(nullptr == pPackOut || nullptr != pFillMem);
 
    LOG_N(
       Trace_Info,
@@ -1061,14 +1210,24 @@ static IntEbm AppendFeature(
       const size_t cSamples = static_cast<size_t>(countSamples);
 
       bool bSparse = false;
+      IntEbm indexBinDefault = 0;
+      size_t cNonDefaults = 0;
       if(size_t { 0 } != cSamples) {
          if(nullptr == binIndexes) {
             LOG_0(Trace_Error, "ERROR AppendFeature nullptr == binIndexes");
             goto return_bad;
          }
 
-         // TODO: handle sparse data someday
-         bSparse = DecideIfSparse(cSamples, binIndexes);
+         // if there is only 1 bin nothing is stored, so there is nothing to make sparse
+         if(UIntShared { 1 } < cBins) {
+            const int cItemsPerBitPack = GetCountItemsBitPacked<UIntShared>(CountBitsRequired(cBins - UIntShared { 1 }));
+            EBM_ASSERT(1 <= cItemsPerBitPack);
+            const size_t cDataUnits = (cSamples - size_t { 1 }) / static_cast<size_t>(cItemsPerBitPack) + size_t { 1 };
+            const size_t cBytesDense = IsMultiplyError(sizeof(UIntShared), cDataUnits) ? 
+               std::numeric_limits<size_t>::max() : sizeof(UIntShared) * cDataUnits;
+
+            bSparse = DecideIfSparse(cSamples, binIndexes, cBytesDense, &indexBinDefault, &cNonDefaults);
+         }
       }
 
       size_t iOffset = 0;
@@ -1120,6 +1279,11 @@ static IntEbm AppendFeature(
          pFeatureDataSetShared->m_cBins = cBins;
       }
 
+      if(nullptr != pPackOut) {
+         pPackOut->m_cSamples = 0;
+         pPackOut->m_cDataUnits = 0;
+      }
+
       // if there is only 1 bin we always know what it will be and we do not need to store anything
       if(size_t { 0 } != cSamples) {
          const IntEbm * pBinIndex = binIndexes;
@@ -1138,6 +1302,55 @@ static IntEbm AppendFeature(
                }
                ++pBinIndex;
             } while(pBinIndexsEnd != pBinIndex);
+         } else if(bSparse) {
+            // DecideIfSparse checked that this cannot overflow
+            const size_t cBytesSparse = offsetof(SparseFeatureDataSetShared, m_nonDefaults) +
+               sizeof(SparseFeatureDataSetSharedEntry) * cNonDefaults;
+
+            if(IsAddError(iByteCur, cBytesSparse)) {
+               LOG_0(Trace_Error, "ERROR AppendFeature IsAddError(iByteCur, cBytesSparse)");
+               goto return_bad;
+            }
+            const size_t iByteNext = iByteCur + cBytesSparse;
+
+            if(nullptr != pFillMem) {
+               if(cBytesAllocated < iByteNext) {
+                  LOG_0(Trace_Error, "ERROR AppendFeature cBytesAllocated < iByteNext");
+                  goto return_bad;
+               }
+
+               const IntEbm indexBinIllegal = countBins - (EBM_FALSE != isUnknown ? IntEbm { 0 } : IntEbm { 1 });
+               const IntEbm indexBinShift = EBM_FALSE != isMissing ? IntEbm { 0 } : IntEbm { 1 };
+
+               SparseFeatureDataSetShared * const pSparseFeatureDataSetShared =
+                  reinterpret_cast<SparseFeatureDataSetShared *>(pFillMem + iByteCur);
+               // if the default bin is illegal we find it in the loop below since every sample is checked
+               pSparseFeatureDataSetShared->m_defaultVal = static_cast<UIntShared>(indexBinDefault - indexBinShift);
+               pSparseFeatureDataSetShared->m_cNonDefaults = static_cast<UIntShared>(cNonDefaults);
+
+               SparseFeatureDataSetSharedEntry * pNonDefault = ArrayToPointer(pSparseFeatureDataSetShared->m_nonDefaults);
+               size_t iSample = 0;
+               do {
+                  const IntEbm indexBin = *pBinIndex;
+                  if(indexBinIllegal <= indexBin) {
+                     LOG_0(Trace_Error, "ERROR AppendFeature indexBinIllegal <= indexBin");
+                     goto return_bad;
+                  }
+                  if(indexBin < indexBinShift) {
+                     LOG_0(Trace_Error, "ERROR AppendFeature indexBin is below the first legal bin");
+                     goto return_bad;
+                  }
+                  if(indexBinDefault != indexBin) {
+                     pNonDefault->m_iSample = static_cast<UIntShared>(iSample);
+                     pNonDefault->m_nonDefaultVal = static_cast<UIntShared>(indexBin - indexBinShift);
+                     ++pNonDefault;
+                  }
+                  ++iSample;
+                  ++pBinIndex;
+               } while(pBinIndexsEnd != pBinIndex);
+               EBM_ASSERT(ArrayToPointer(pSparseFeatureDataSetShared->m_nonDefaults) + cNonDefaults == pNonDefault);
+            }
+            iByteCur = iByteNext;
          } else {
             const int cBitsRequiredMin = CountBitsRequired(cBins - UIntShared { 1 });
             EBM_ASSERT(1 <= cBitsRequiredMin);
@@ -1176,46 +1389,20 @@ static IntEbm AppendFeature(
                   LOG_0(Trace_Error, "ERROR AppendFeature IsMultiplyError(sizeof(binIndexes[0]), cSamples)");
                   goto return_bad;
                }
-               UIntShared * pFillData = reinterpret_cast<UIntShared *>(pFillMem + iByteCur);
-
-               int cShift = static_cast<int>((cSamples - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
-               const int cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
-               const IntEbm indexBinIllegal = countBins - (EBM_FALSE != isUnknown ? IntEbm { 0 } : IntEbm { 1 });
-               do {
-                  UIntShared bits = 0;
-                  do {
-                     IntEbm indexBin = *pBinIndex;
-                     if(indexBinIllegal <= indexBin) {
-                        LOG_0(Trace_Error, "ERROR AppendFeature indexBinIllegal <= indexBin");
-                        goto return_bad;
-                     }
-                     if(EBM_FALSE != isMissing) {
-                        if(indexBin < IntEbm { 0 }) {
-                           LOG_0(Trace_Error, "ERROR AppendFeature indexBin can't be negative");
-                           goto return_bad;
-                        }
-                     } else {
-                        if(indexBin <= IntEbm { 0 }) {
-                           LOG_0(Trace_Error, "ERROR AppendFeature indexBin <= IntEbm { 0 }");
-                           goto return_bad;
-                        }
-                        --indexBin;
-                     }
-                     ++pBinIndex;
-
-                     // since countBins can be converted to these, so now can indexBin
-                     EBM_ASSERT(!IsConvertError<UIntShared>(indexBin));
-
-                     EBM_ASSERT(0 <= cShift);
-                     EBM_ASSERT(cShift < COUNT_BITS(UIntShared));
-                     bits |= static_cast<UIntShared>(indexBin) << cShift;
-                     cShift -= cBitsPerItemMax;
-                  } while(0 <= cShift);
-                  cShift = cShiftReset;
-                  *pFillData = bits;
-                  ++pFillData;
-               } while(pBinIndexsEnd != pBinIndex);
-               EBM_ASSERT(reinterpret_cast<unsigned char *>(pFillData) == pFillMem + iByteNext);
+               FeaturePack pack;
+               pack.m_indexBinIllegal = countBins - (EBM_FALSE != isUnknown ? IntEbm { 0 } : IntEbm { 1 });
+               pack.m_bMissing = EBM_FALSE != isMissing;
+               pack.m_cItemsPerBitPack = cItemsPerBitPack;
+               pack.m_cBitsPerItemMax = cBitsPerItemMax;
+               pack.m_cSamples = cSamples;
+               pack.m_cDataUnits = cDataUnits;
+               pack.m_aBinIndexes = binIndexes;
+               pack.m_aFillData = reinterpret_cast<UIntShared *>(pFillMem + iByteCur);
+               if(nullptr != pPackOut) {
+                  *pPackOut = pack;
+               } else if(PackFeatureBins(&pack, 0, cDataUnits)) {
+                  goto return_bad;
+               }
             }
             iByteCur = iByteNext;
          }
@@ -1236,9 +1423,11 @@ static IntEbm AppendFeature(
                goto return_bad;
             }
 
-            const ErrorEbm error = LockDataSetShared(cBytesAllocated, pFillMem);
-            if(Error_None != error) {
-               return error;
+            if(nullptr == pPackOut) {
+               const ErrorEbm error = LockDataSetShared(cBytesAllocated, pFillMem);
+               if(Error_None != error) {
+                  return error;
+               }
             }
          } else {
             if(cBytesAllocated - sizeof(UIntShared) < iByteCur) {
@@ -1817,6 +2006,204 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION FillFeature(
    return static_cast<ErrorEbm>(ret);
 }
 
+// each packing task of FillFeatures packs this many data units of one feature
+static constexpr size_t k_cDataUnitsPerPackTask = 4096;
+
+struct FillFeaturesContext final {
+   const FeaturePack * m_aPacks;
+   // the tasks of feature i are m_aiFirstTasks[i] up to m_aiFirstTasks[i + 1]
+   const size_t * m_aiFirstTasks;
+   size_t m_cFeatures;
+};
+static_assert(std::is_standard_layout<FillFeaturesContext>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<FillFeaturesContext>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+static ErrorEbm PackFeatureTask(void * const pContextVoid, const size_t iTask, const size_t iThread) {
+   UNUSED(iThread);
+   const FillFeaturesContext * const pContext = static_cast<const FillFeaturesContext *>(pContextVoid);
+
+   // features without data units have no tasks, so this finds the last feature whose first task is at or before iTask
+   const size_t * const piFirstTasksEnd = pContext->m_aiFirstTasks + pContext->m_cFeatures + size_t { 1 };
+   const size_t iFeature =
+      static_cast<size_t>(std::upper_bound(pContext->m_aiFirstTasks, piFirstTasksEnd, iTask) - pContext->m_aiFirstTasks) -
+      size_t { 1 };
+   EBM_ASSERT(iFeature < pContext->m_cFeatures);
+
+   const FeaturePack * const pPack = &pContext->m_aPacks[iFeature];
+   const size_t iUnitStart = (iTask - pContext->m_aiFirstTasks[iFeature]) * k_cDataUnitsPerPackTask;
+   const size_t iUnitEnd = EbmMin(iUnitStart + k_cDataUnitsPerPackTask, pPack->m_cDataUnits);
+   return PackFeatureBins(pPack, iUnitStart, iUnitEnd) ? Error_IllegalParamVal : Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION FillFeatures(
+   IntEbm countFeatures,
+   const IntEbm * countBins,
+   const BoolEbm * isMissing,
+   const BoolEbm * isUnknown,
+   const BoolEbm * isNominal,
+   IntEbm countSamples,
+   const IntEbm * binIndexes,
+   IntEbm countBytesAllocated,
+   void * fillMem
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered FillFeatures: "
+      "countFeatures=%" IntEbmPrintf ", "
+      "countBins=%p, "
+      "isMissing=%p, "
+      "isUnknown=%p, "
+      "isNominal=%p, "
+      "countSamples=%" IntEbmPrintf ", "
+      "binIndexes=%p, "
+      "countBytesAllocated=%" IntEbmPrintf ", "
+      "fillMem=%p"
+      ,
+      countFeatures,
+      static_cast<const void *>(countBins),
+      static_cast<const void *>(isMissing),
+      static_cast<const void *>(isUnknown),
+      static_cast<const void *>(isNominal),
+      countSamples,
+      static_cast<const void *>(binIndexes),
+      countBytesAllocated,
+      fillMem
+   );
+
+   if(nullptr == fillMem) {
+      LOG_0(Trace_Error, "ERROR FillFeatures nullptr == fillMem");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsConvertError<size_t>(countBytesAllocated)) {
+      LOG_0(Trace_Error, "ERROR FillFeatures countBytesAllocated is outside the range of a valid size");
+      // don't set the header to bad if we don't have enough memory for the header itself
+      return Error_IllegalParamVal;
+   }
+   const size_t cBytesAllocated = static_cast<size_t>(countBytesAllocated);
+
+   if(cBytesAllocated < k_cBytesHeaderId) {
+      LOG_0(Trace_Error, "ERROR FillFeatures cBytesAllocated < k_cBytesHeaderId");
+      // don't check or set the header to bad if we don't have enough memory for the header id itself
+      return Error_IllegalParamVal;
+   }
+
+   unsigned char * const pFillMem = static_cast<unsigned char *>(fillMem);
+   HeaderDataSetShared * const pHeaderDataSetShared = reinterpret_cast<HeaderDataSetShared *>(pFillMem);
+   if(k_sharedDataSetWorkingId != pHeaderDataSetShared->m_id) {
+      LOG_0(Trace_Error, "ERROR FillFeatures k_sharedDataSetWorkingId != pHeaderDataSetShared->m_id");
+      // don't set the header to bad since it's already set to something invalid and we don't know why
+      return Error_IllegalParamVal;
+   }
+
+   if(countFeatures < IntEbm { 0 } || IsConvertError<size_t>(countFeatures)) {
+      LOG_0(Trace_Error, "ERROR FillFeatures countFeatures must be a non-negative size_t");
+      pHeaderDataSetShared->m_id = k_sharedDataSetErrorId;
+      return Error_IllegalParamVal;
+   }
+   const size_t cFeatures = static_cast<size_t>(countFeatures);
+   if(size_t { 0 } == cFeatures) {
+      LOG_0(Trace_Info, "INFO FillFeatures no features");
+      return Error_None;
+   }
+   if(nullptr == countBins || nullptr == isMissing || nullptr == isUnknown || nullptr == isNominal) {
+      LOG_0(Trace_Error, "ERROR FillFeatures the feature arrays cannot be nullptr");
+      pHeaderDataSetShared->m_id = k_sharedDataSetErrorId;
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countSamples) || IsMultiplyError(cFeatures, static_cast<size_t>(countSamples))) {
+      // AppendFeature checks the sign of countSamples
+      LOG_0(Trace_Error, "ERROR FillFeatures countSamples is outside the range of a valid index");
+      pHeaderDataSetShared->m_id = k_sharedDataSetErrorId;
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   if(IsHeaderError(static_cast<UIntShared>(cSamples), cBytesAllocated, pFillMem)) {
+      pHeaderDataSetShared->m_id = k_sharedDataSetErrorId;
+      return Error_IllegalParamVal;
+   }
+   // the internal state is only valid while sections remain, and IsHeaderError checked that it fits
+   const size_t iOffsetFirst = static_cast<size_t>(
+      *reinterpret_cast<const UIntShared *>(pFillMem + cBytesAllocated - sizeof(UIntShared)));
+   const size_t cOffsets = static_cast<size_t>(pHeaderDataSetShared->m_cFeatures) +
+      static_cast<size_t>(pHeaderDataSetShared->m_cWeights) +
+      static_cast<size_t>(pHeaderDataSetShared->m_cTargets);
+
+   if(IsMultiplyError(sizeof(FeaturePack) + sizeof(size_t), cFeatures) ||
+      IsAddError((sizeof(FeaturePack) + sizeof(size_t)) * cFeatures, sizeof(size_t))) {
+      LOG_0(Trace_Warning, "WARNING FillFeatures the features are too large for memory");
+      pHeaderDataSetShared->m_id = k_sharedDataSetErrorId;
+      return Error_OutOfMemory;
+   }
+   char * const aMem = static_cast<char *>(malloc((sizeof(FeaturePack) + sizeof(size_t)) * cFeatures + sizeof(size_t)));
+   if(nullptr == aMem) {
+      LOG_0(Trace_Warning, "WARNING FillFeatures nullptr == aMem");
+      pHeaderDataSetShared->m_id = k_sharedDataSetErrorId;
+      return Error_OutOfMemory;
+   }
+   FeaturePack * const aPacks = reinterpret_cast<FeaturePack *>(aMem);
+   size_t * const aiFirstTasks = reinterpret_cast<size_t *>(aPacks + cFeatures);
+
+   // lay out the sections and write their headers and offsets one feature at a time, which is cheap, then pack the
+   // bin indexes of all the features together, split into tasks of whole data units
+   ErrorEbm error = Error_None;
+   size_t cTasks = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const IntEbm ret = AppendFeature(
+         countBins[iFeature],
+         isMissing[iFeature],
+         isUnknown[iFeature],
+         isNominal[iFeature],
+         countSamples,
+         nullptr == binIndexes ? nullptr : binIndexes + cSamples * iFeature,
+         cBytesAllocated,
+         pFillMem,
+         &aPacks[iFeature]
+      );
+      if(Error_None != ret) {
+         // already logged, and the header is already marked as bad
+         error = static_cast<ErrorEbm>(ret);
+         goto exit_free;
+      }
+      aiFirstTasks[iFeature] = cTasks;
+      cTasks += (aPacks[iFeature].m_cDataUnits + (k_cDataUnitsPerPackTask - size_t { 1 })) / k_cDataUnitsPerPackTask;
+   }
+   aiFirstTasks[cFeatures] = cTasks;
+
+   if(size_t { 0 } != cTasks) {
+      ThreadPool * pThreadPool = nullptr;
+      error = ThreadPool::Create(EbmMin(ThreadPool::GetCountThreadsConfig(), cTasks), &pThreadPool);
+      if(Error_None == error) {
+         FillFeaturesContext context;
+         context.m_aPacks = aPacks;
+         context.m_aiFirstTasks = aiFirstTasks;
+         context.m_cFeatures = cFeatures;
+
+         error = pThreadPool->Run(cTasks, PackFeatureTask, &context);
+
+         ThreadPool::Free(pThreadPool);
+      }
+      if(Error_None != error) {
+         pHeaderDataSetShared->m_id = k_sharedDataSetErrorId;
+         goto exit_free;
+      }
+   }
+
+   if(iOffsetFirst + cFeatures == cOffsets) {
+      // AppendFeature leaves locking the dataset to us since the last feature was not packed yet
+      error = LockDataSetShared(cBytesAllocated, pFillMem);
+   }
+
+exit_free:;
+   free(aMem);
+
+   LOG_N(Trace_Info, "Exited FillFeatures: error=%" ErrorEbmPrintf, error);
+   return error;
+}
+
 EBM_API_BODY IntEbm EBM_CALLING_CONVENTION MeasureWeight(
    IntEbm countSamples,
    const double * weights
@@ -2386,4 +2773,434 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ExtractTargetClasses(
    return Error_None;
 }
 
+static void DecodeSortedBins(
+   const unsigned char * const pDataSetShared,
+   const size_t iFeature,
+   const size_t cSamples,
+   const size_t * const aiOriginal,
+   UIntShared * const aValsTemp,
+   IntEbm * const aBinIndexesOut,
+   IntEbm * const pCountBinsOut,
+   BoolEbm * const pIsMissingOut,
+   BoolEbm * const pIsUnknownOut,
+   BoolEbm * const pIsNominalOut
+) {
+   EBM_ASSERT(1 <= cSamples);
+
+   bool bMissing;
+   bool bUnknown;
+   bool bNominal;
+   bool bSparse;
+   UIntShared cBins;
+   UIntShared defaultValSparse;
+   size_t cNonDefaultsSparse;
+   const void * const pFeatureData = GetDataSetSharedFeature(
+      pDataSetShared,
+      iFeature,
+      &bMissing,
+      &bUnknown,
+      &bNominal,
+      &bSparse,
+      &cBins,
+      &defaultValSparse,
+      &cNonDefaultsSparse
+   );
+   EBM_ASSERT(nullptr != pFeatureData);
+
+   // decode in the original order since that is how the bits are packed
+   UIntShared * pVal = aValsTemp;
+   const UIntShared * const pValsEnd = aValsTemp + cSamples;
+   if(bSparse) {
+      const SparseFeatureDataSetSharedEntry * pNonDefault = 
+         static_cast<const SparseFeatureDataSetSharedEntry *>(pFeatureData);
+      const SparseFeatureDataSetSharedEntry * const pNonDefaultsEnd = pNonDefault + cNonDefaultsSparse;
+      size_t iSample = 0;
+      do {
+         *pVal = GetSparseFeatureBin(&pNonDefault, pNonDefaultsEnd, defaultValSparse, iSample);
+         ++iSample;
+         ++pVal;
+      } while(pValsEnd != pVal);
+   } else if(cBins <= UIntShared { 1 }) {
+      // nothing is stored when there is only 1 bin
+      do {
+         *pVal = 0;
+         ++pVal;
+      } while(pValsEnd != pVal);
+   } else {
+      const int cItemsPerBitPack = GetCountItemsBitPacked<UIntShared>(CountBitsRequired(cBins - UIntShared { 1 }));
+      EBM_ASSERT(1 <= cItemsPerBitPack);
+      const int cBitsPerItemMax = GetCountBits<UIntShared>(cItemsPerBitPack);
+      const UIntShared maskBits = MakeLowMask<UIntShared>(cBitsPerItemMax);
+
+      const UIntShared * pData = static_cast<const UIntShared *>(pFeatureData);
+      int iShift = static_cast<int>((cSamples - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack));
+      do {
+         *pVal = (*pData >> (iShift * cBitsPerItemMax)) & maskBits;
+         --iShift;
+         if(iShift < 0) {
+            ++pData;
+            iShift = cItemsPerBitPack - 1;
+         }
+         ++pVal;
+      } while(pValsEnd != pVal);
+   }
+
+   const IntEbm indexBinShift = bMissing ? IntEbm { 0 } : IntEbm { 1 };
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      aBinIndexesOut[iSample] = static_cast<IntEbm>(aValsTemp[aiOriginal[iSample]]) + indexBinShift;
+   }
+
+   // cBins came from a countBins that fit into IntEbm before missing and unknown were removed
+   *pCountBinsOut = static_cast<IntEbm>(cBins) + indexBinShift + (bUnknown ? IntEbm { 0 } : IntEbm { 1 });
+   *pIsMissingOut = bMissing ? EBM_TRUE : EBM_FALSE;
+   *pIsUnknownOut = bUnknown ? EBM_TRUE : EBM_FALSE;
+   *pIsNominalOut = bNominal ? EBM_TRUE : EBM_FALSE;
+}
+
+static IntEbm AppendSorted(
+   const unsigned char * const pDataSetShared,
+   const size_t cSamples,
+   const size_t cFeatures,
+   const size_t cWeights,
+   const size_t cTargets,
+   const size_t * const aiOriginal,
+   void * const aTemp,
+   IntEbm * const aBinIndexesTemp,
+   const size_t cBytesAllocated,
+   unsigned char * const pFillMem
+) {
+   // returns the size when measuring and Error_None when filling.  Errors are negative in both cases
+   IntEbm ret = AppendHeader(
+      static_cast<IntEbm>(cFeatures), 
+      static_cast<IntEbm>(cWeights), 
+      static_cast<IntEbm>(cTargets), 
+      cBytesAllocated, 
+      pFillMem
+   );
+   if(ret < IntEbm { 0 }) {
+      return ret;
+   }
+   IntEbm cBytesSum = ret;
+   const IntEbm countSamples = static_cast<IntEbm>(cSamples);
+
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      IntEbm countBins;
+      BoolEbm isMissing;
+      BoolEbm isUnknown;
+      BoolEbm isNominal;
+      DecodeSortedBins(
+         pDataSetShared,
+         iFeature,
+         cSamples,
+         aiOriginal,
+         static_cast<UIntShared *>(aTemp),
+         aBinIndexesTemp,
+         &countBins,
+         &isMissing,
+         &isUnknown,
+         &isNominal
+      );
+      ret = AppendFeature(
+         countBins,
+         isMissing,
+         isUnknown,
+         isNominal,
+         countSamples,
+         aBinIndexesTemp,
+         cBytesAllocated,
+         pFillMem
+      );
+      if(ret < IntEbm { 0 }) {
+         return ret;
+      }
+      cBytesSum += ret;
+   }
+
+   double * const aFloatsTemp = static_cast<double *>(aTemp);
+   for(size_t iWeight = 0; iWeight < cWeights; ++iWeight) {
+      const FloatShared * const aWeights = GetDataSetSharedWeight(pDataSetShared, iWeight);
+      EBM_ASSERT(nullptr != aWeights);
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         aFloatsTemp[iSample] = static_cast<double>(aWeights[aiOriginal[iSample]]);
+      }
+      ret = AppendWeight(countSamples, aFloatsTemp, cBytesAllocated, pFillMem);
+      if(ret < IntEbm { 0 }) {
+         return ret;
+      }
+      cBytesSum += ret;
+   }
+
+   for(size_t iTarget = 0; iTarget < cTargets; ++iTarget) {
+      ptrdiff_t cClasses;
+      const void * const aTargets = GetDataSetSharedTarget(pDataSetShared, iTarget, &cClasses);
+      if(nullptr == aTargets) {
+         // already logged
+         return IntEbm { Error_IllegalParamVal };
+      }
+      const bool bClassification = ptrdiff_t { 0 } <= cClasses;
+      if(bClassification) {
+         const UIntShared * const aClasses = static_cast<const UIntShared *>(aTargets);
+         for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+            aBinIndexesTemp[iSample] = static_cast<IntEbm>(aClasses[aiOriginal[iSample]]);
+         }
+         ret = AppendTarget(true, static_cast<IntEbm>(cClasses), countSamples, aBinIndexesTemp, cBytesAllocated, pFillMem);
+      } else {
+         const FloatShared * const aFloats = static_cast<const FloatShared *>(aTargets);
+         for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+            aFloatsTemp[iSample] = static_cast<double>(aFloats[aiOriginal[iSample]]);
+         }
+         ret = AppendTarget(false, 0, countSamples, aFloatsTemp, cBytesAllocated, pFillMem);
+      }
+      if(ret < IntEbm { 0 }) {
+         return ret;
+      }
+      cBytesSum += ret;
+   }
+   return nullptr != pFillMem ? IntEbm { Error_None } : cBytesSum;
+}
+
+extern ErrorEbm SortDataSetByTarget(
+   const unsigned char * const pDataSetShared,
+   const BagEbm * const aBag,
+   unsigned char ** const ppDataSetSortedOut,
+   BagEbm ** const paBagSortedOut,
+   size_t ** const paiOriginalOut
+) {
+   LOG_0(Trace_Info, "Entered SortDataSetByTarget");
+
+   EBM_ASSERT(nullptr != pDataSetShared);
+   EBM_ASSERT(nullptr != ppDataSetSortedOut);
+   EBM_ASSERT(nullptr != paBagSortedOut);
+   EBM_ASSERT(nullptr != paiOriginalOut);
+
+   *ppDataSetSortedOut = nullptr;
+   *paBagSortedOut = nullptr;
+   *paiOriginalOut = nullptr;
+
+   ErrorEbm error;
+
+   UIntShared countSamples;
+   size_t cFeatures;
+   size_t cWeights;
+   size_t cTargets;
+   error = GetDataSetSharedHeader(pDataSetShared, &countSamples, &cFeatures, &cWeights, &cTargets);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+   if(IsConvertError<size_t>(countSamples)) {
+      LOG_0(Trace_Error, "ERROR SortDataSetByTarget IsConvertError<size_t>(countSamples)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   if(size_t { 0 } == cSamples || size_t { 0 } == cTargets) {
+      return Error_None;
+   }
+
+   ptrdiff_t cClasses;
+   const void * const aTargets = GetDataSetSharedTarget(pDataSetShared, 0, &cClasses);
+   if(nullptr == aTargets) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+   if(cClasses < ptrdiff_t { 2 }) {
+      // regression has no classes to sort by, and with 1 class the samples are already sorted
+      return Error_None;
+   }
+   const size_t cClassesSort = static_cast<size_t>(cClasses);
+
+   IntEbm * aBinIndexesTemp = nullptr;
+   void * aTemp = nullptr;
+   unsigned char * pDataSetSorted = nullptr;
+   BagEbm * aBagSorted = nullptr;
+   IntEbm cBytes;
+
+   if(IsAddError(cClassesSort, size_t { 1 }) || IsMultiplyError(sizeof(size_t), cClassesSort + size_t { 1 }) ||
+      IsMultiplyError(sizeof(size_t), cSamples) || IsMultiplyError(sizeof(IntEbm), cSamples) ||
+      IsMultiplyError(EbmMax(sizeof(UIntShared), sizeof(double)), cSamples)) {
+      LOG_0(Trace_Warning, "WARNING SortDataSetByTarget IsMultiplyError");
+      return Error_OutOfMemory;
+   }
+
+   size_t * const aiClassStart = static_cast<size_t *>(malloc(sizeof(size_t) * (cClassesSort + size_t { 1 })));
+   if(nullptr == aiClassStart) {
+      LOG_0(Trace_Warning, "WARNING SortDataSetByTarget nullptr == aiClassStart");
+      return Error_OutOfMemory;
+   }
+   size_t * const aiOriginal = static_cast<size_t *>(malloc(sizeof(size_t) * cSamples));
+   if(nullptr == aiOriginal) {
+      LOG_0(Trace_Warning, "WARNING SortDataSetByTarget nullptr == aiOriginal");
+      error = Error_OutOfMemory;
+      goto exit_free;
+   }
+
+   {
+      // a stable counting sort keeps the original order of the samples within each class
+      const UIntShared * const aClasses = static_cast<const UIntShared *>(aTargets);
+      memset(aiClassStart, 0, sizeof(size_t) * (cClassesSort + size_t { 1 }));
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         EBM_ASSERT(aClasses[iSample] < static_cast<UIntShared>(cClassesSort)); // checked when creating the dataset
+         ++aiClassStart[static_cast<size_t>(aClasses[iSample]) + size_t { 1 }];
+      }
+      for(size_t iClass = 0; iClass < cClassesSort; ++iClass) {
+         aiClassStart[iClass + size_t { 1 }] += aiClassStart[iClass];
+      }
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         aiOriginal[aiClassStart[static_cast<size_t>(aClasses[iSample])]++] = iSample;
+      }
+   }
+
+   aBinIndexesTemp = static_cast<IntEbm *>(malloc(sizeof(IntEbm) * cSamples));
+   if(nullptr == aBinIndexesTemp) {
+      LOG_0(Trace_Warning, "WARNING SortDataSetByTarget nullptr == aBinIndexesTemp");
+      error = Error_OutOfMemory;
+      goto exit_free;
+   }
+   aTemp = malloc(EbmMax(sizeof(UIntShared), sizeof(double)) * cSamples);
+   if(nullptr == aTemp) {
+      LOG_0(Trace_Warning, "WARNING SortDataSetByTarget nullptr == aTemp");
+      error = Error_OutOfMemory;
+      goto exit_free;
+   }
+
+   // the layout is position independent, so the sorted dataset is the same size, but we need to measure it anyways
+   cBytes = AppendSorted(pDataSetShared, cSamples, cFeatures, cWeights, cTargets, aiOriginal, aTemp, aBinIndexesTemp, 0, nullptr);
+   if(cBytes < IntEbm { 0 }) {
+      error = static_cast<ErrorEbm>(cBytes);
+      goto exit_free;
+   }
+   if(IsConvertError<size_t>(cBytes)) {
+      LOG_0(Trace_Warning, "WARNING SortDataSetByTarget IsConvertError<size_t>(cBytes)");
+      error = Error_OutOfMemory;
+      goto exit_free;
+   }
+   pDataSetSorted = static_cast<unsigned char *>(malloc(static_cast<size_t>(cBytes)));
+   if(nullptr == pDataSetSorted) {
+      LOG_0(Trace_Warning, "WARNING SortDataSetByTarget nullptr == pDataSetSorted");
+      error = Error_OutOfMemory;
+      goto exit_free;
+   }
+   error = static_cast<ErrorEbm>(AppendSorted(pDataSetShared, cSamples, cFeatures, cWeights, cTargets, aiOriginal, 
+      aTemp, aBinIndexesTemp, static_cast<size_t>(cBytes), pDataSetSorted));
+   if(Error_None != error) {
+      goto exit_free;
+   }
+
+   if(nullptr != aBag) {
+      if(IsMultiplyError(sizeof(BagEbm), cSamples)) {
+         LOG_0(Trace_Warning, "WARNING SortDataSetByTarget IsMultiplyError(sizeof(BagEbm), cSamples)");
+         error = Error_OutOfMemory;
+         goto exit_free;
+      }
+      aBagSorted = static_cast<BagEbm *>(malloc(sizeof(BagEbm) * cSamples));
+      if(nullptr == aBagSorted) {
+         LOG_0(Trace_Warning, "WARNING SortDataSetByTarget nullptr == aBagSorted");
+         error = Error_OutOfMemory;
+         goto exit_free;
+      }
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         aBagSorted[iSample] = aBag[aiOriginal[iSample]];
+      }
+   }
+
+   *ppDataSetSortedOut = pDataSetSorted;
+   pDataSetSorted = nullptr;
+   *paBagSortedOut = aBagSorted;
+   aBagSorted = nullptr;
+   *paiOriginalOut = aiOriginal;
+
+   LOG_0(Trace_Info, "Exited SortDataSetByTarget");
+
+   free(aTemp);
+   free(aBinIndexesTemp);
+   free(aiClassStart);
+   return Error_None;
+
+exit_free:;
+   free(aBagSorted);
+   free(pDataSetSorted);
+   free(aTemp);
+   free(aBinIndexesTemp);
+   free(aiOriginal);
+   free(aiClassStart);
+   return error;
+}
+
+extern ErrorEbm SortInitScores(
+   const size_t cSamples,
+   const size_t * const aiOriginal,
+   const size_t cScores,
+   const double * const aInitScores,
+   double ** const paInitScoresSortedOut
+) {
+   EBM_ASSERT(nullptr != aiOriginal);
+   EBM_ASSERT(1 <= cScores);
+   EBM_ASSERT(nullptr != paInitScoresSortedOut);
+
+   *paInitScoresSortedOut = nullptr;
+   if(nullptr == aInitScores || size_t { 0 } == cSamples) {
+      return Error_None;
+   }
+
+   if(IsMultiplyError(sizeof(double), cScores, cSamples)) {
+      LOG_0(Trace_Warning, "WARNING SortInitScores IsMultiplyError(sizeof(double), cScores, cSamples)");
+      return Error_OutOfMemory;
+   }
+   double * const aInitScoresSorted = static_cast<double *>(malloc(sizeof(double) * cScores * cSamples));
+   if(nullptr == aInitScoresSorted) {
+      LOG_0(Trace_Warning, "WARNING SortInitScores nullptr == aInitScoresSorted");
+      return Error_OutOfMemory;
+   }
+   double * pInitScoreSorted = aInitScoresSorted;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      memcpy(pInitScoreSorted, &aInitScores[aiOriginal[iSample] * cScores], sizeof(double) * cScores);
+      pInitScoreSorted += cScores;
+   }
+   *paInitScoresSortedOut = aInitScoresSorted;
+   return Error_None;
+}
+
+extern ErrorEbm CountIncludedClassSamples(
+   const unsigned char * const pDataSetShared,
+   const BagEbm direction,
+   const BagEbm * const aBag,
+   const size_t cClasses,
+   size_t * const acClassSamplesOut
+) {
+   EBM_ASSERT(nullptr != pDataSetShared);
+   EBM_ASSERT(BagEbm { -1 } == direction || BagEbm { 1 } == direction);
+   EBM_ASSERT(2 <= cClasses);
+   EBM_ASSERT(nullptr != acClassSamplesOut);
+
+   UIntShared countSamples;
+   size_t cFeatures;
+   size_t cWeights;
+   size_t cTargets;
+   const ErrorEbm error = GetDataSetSharedHeader(pDataSetShared, &countSamples, &cFeatures, &cWeights, &cTargets);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+   EBM_ASSERT(!IsConvertError<size_t>(countSamples)); // the caller checked this
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   ptrdiff_t cClassesShared;
+   const UIntShared * const aClasses = 
+      static_cast<const UIntShared *>(GetDataSetSharedTarget(pDataSetShared, 0, &cClassesShared));
+   EBM_ASSERT(nullptr != aClasses);
+   EBM_ASSERT(static_cast<size_t>(cClassesShared) == cClasses);
+
+   memset(acClassSamplesOut, 0, sizeof(size_t) * cClasses);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      // replicated samples are included once per replication, as they are in the data subsets
+      const BagEbm replication = nullptr == aBag ? BagEbm { 1 } : aBag[iSample];
+      if(BagEbm { 0 } < replication * direction) {
+         acClassSamplesOut[static_cast<size_t>(aClasses[iSample])] += 
+            static_cast<size_t>(BagEbm { 0 } < replication ? replication : -replication);
+      }
+   }
+   return Error_None;
+}
+
 } // DEFINED_ZONE_NAME
@@ -28,6 +28,27 @@ static_assert(std::is_standard_layout<SparseFeatureDataSetSharedEntry>::value,
 static_assert(std::is_trivial<SparseFeatureDataSetSharedEntry>::value,
    "These structs are shared between processes, so they definetly need to be standard layout and trivial");
 
+// returns the bin of sample iSample of a sparse feature.  The samples must be requested in increasing order, and
+// *ppNonDefault is moved past any non-default samples that were skipped over
+inline static UIntShared GetSparseFeatureBin(
+   const SparseFeatureDataSetSharedEntry ** const ppNonDefault,
+   const SparseFeatureDataSetSharedEntry * const pNonDefaultsEnd,
+   const UIntShared defaultVal,
+   const size_t iSample
+) {
+   const SparseFeatureDataSetSharedEntry * pNonDefault = *ppNonDefault;
+   while(pNonDefaultsEnd != pNonDefault && static_cast<size_t>(pNonDefault->m_iSample) < iSample) {
+      ++pNonDefault;
+   }
+   UIntShared val = defaultVal;
+   if(pNonDefaultsEnd != pNonDefault && static_cast<size_t>(pNonDefault->m_iSample) == iSample) {
+      val = pNonDefault->m_nonDefaultVal;
+      ++pNonDefault;
+   }
+   *ppNonDefault = pNonDefault;
+   return val;
+}
+
 extern ErrorEbm GetDataSetSharedHeader(
    const unsigned char * const pDataSetShared,
    UIntShared * const pcSamplesOut,
@@ -61,6 +82,34 @@ extern const void * GetDataSetSharedTarget(
    ptrdiff_t * const pcClassesOut
 );
 
+// SortDataSetByTarget makes a copy of a classification dataset with the samples stably sorted by class, and
+// returns the original index of each sorted sample in *paiOriginalOut.  For regression, or if there is nothing
+// to sort, all the outputs are nullptr and the original dataset should be used.  The caller frees the outputs
+extern ErrorEbm SortDataSetByTarget(
+   const unsigned char * const pDataSetShared,
+   const BagEbm * const aBag,
+   unsigned char ** const ppDataSetSortedOut,
+   BagEbm ** const paBagSortedOut,
+   size_t ** const paiOriginalOut
+);
+
+extern ErrorEbm SortInitScores(
+   const size_t cSamples,
+   const size_t * const aiOriginal,
+   const size_t cScores,
+   const double * const aInitScores,
+   double ** const paInitScoresSortedOut
+);
+
+// the number of samples of each class that are included in the bag direction, counting replication
+extern ErrorEbm CountIncludedClassSamples(
+   const unsigned char * const pDataSetShared,
+   const BagEbm direction,
+   const BagEbm * const aBag,
+   const size_t cClasses,
+   size_t * const acClassSamplesOut
+);
+
 } // DEFINED_ZONE_NAME
 
 #endif // DATASET_SHARED_HPP
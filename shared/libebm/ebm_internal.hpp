@@ -52,6 +52,66 @@ static constexpr FloatCalc k_epsilonNegativeGainAllowed = FloatCalc { -1e-7 };
 
 static constexpr bool k_bUseLogitboost = false;
 
+// the boosting histograms are binned in at most this many slots that are summed in slot order afterwards.  The
+// number of slots depends only on the number of training subsets, so the thread count only decides which thread
+// bins each slot and never changes the model
+static constexpr size_t k_cBinSumsSlotsMax = 16;
+
+// Reading C ordered data one column at a time touches a new cache line for every value.  Copying stripes of
+// columns out of each row amortizes the cache lines across the stripe, and the measurements in Discretize.cpp
+// found 64 columns to be the fastest stripe width
+static constexpr size_t k_cTransposeStripeColumnsMax = 64;
+
+// copies cColumns columns (at most k_cTransposeStripeColumnsMax) chosen by aiColumns from cRows rows of a C ordered
+// matrix with cColumnsMatrix columns into aColumnsOut, where each output column holds cRows contiguous values
+extern void TransposeStripe(
+   const size_t cRows,
+   const size_t cColumnsMatrix,
+   const double * const aRows,
+   const size_t cColumns,
+   const size_t * const aiColumns,
+   double * const aColumnsOut
+) noexcept;
+
+// Features with this many cuts or more are binned through an Eytzinger (breadth first) layout of their cuts, which
+// keeps the top levels of the search together in cache instead of spread over the whole sorted array
+static constexpr size_t k_cCutsEytzingerMin = 1024;
+
+// the number of levels in the smallest perfect binary tree that holds cCuts cuts, which is also the number of
+// comparisons needed to bin a value.  The Eytzinger array has 2^levels slots since slot 0 is unused
+INLINE_ALWAYS static size_t GetEytzingerLevels(const size_t cCuts) noexcept {
+   EBM_ASSERT(size_t { 1 } <= cCuts);
+   size_t cLevels = 0;
+   while((cCuts >> cLevels) != size_t { 0 }) {
+      ++cLevels;
+   }
+   return cLevels;
+}
+
+// true if features with cCuts cuts should be binned through the Eytzinger layout.  The tree can take up to twice
+// the memory of the cuts, so giant cut counts keep using the sorted cuts
+INLINE_ALWAYS static bool IsEytzingerCuts(const size_t cCuts) noexcept {
+   return k_cCutsEytzingerMin <= cCuts && cCuts <= size_t { std::numeric_limits<int32_t>::max() };
+}
+
+// fills the 2^cLevels slots of aEytzingerOut with the sorted cuts in breadth first order, padding the tree with NaN
+extern void BuildEytzingerCuts(
+   const size_t cCuts,
+   const double * const aCuts,
+   const size_t cLevels,
+   double * const aEytzingerOut
+) noexcept;
+
+// bins like Discretize using the array from BuildEytzingerCuts
+extern void DiscretizeEytzinger(
+   const size_t cSamples,
+   const double * const aFeatureVals,
+   const size_t cCuts,
+   const size_t cLevels,
+   const double * const aEytzinger,
+   IntEbm * const aBinIndexesOut
+) noexcept;
+
 extern double FloatTickIncrementInternal(double deprecisioned[1]) noexcept;
 extern double FloatTickDecrementInternal(double deprecisioned[1]) noexcept;
 
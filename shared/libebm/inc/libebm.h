@@ -131,6 +131,10 @@ typedef struct _InteractionHandle {
    uint32_t handleVerification; // should be 21773 if ok. Do not use size_t since that requires an additional header.
 } * InteractionHandle;
 
+typedef struct _ScoringModelHandle {
+   uint32_t handleVerification; // should be 18541 if ok. Do not use size_t since that requires an additional header.
+} * ScoringModelHandle;
+
 #define BOOL_CAST(val)                             (STATIC_CAST(BoolEbm, (val)))
 #define ERROR_CAST(val)                            (STATIC_CAST(ErrorEbm, (val)))
 #define LINK_FLAGS_CAST(val)                       (STATIC_CAST(LinkFlags, (val)))
@@ -206,6 +210,10 @@ typedef struct _InteractionHandle {
 #define CreateBoosterFlags_DifferentialPrivacy     (CREATE_BOOSTER_FLAGS_CAST(0x00000001))
 #define CreateBoosterFlags_DisableApprox           (CREATE_BOOSTER_FLAGS_CAST(0x00000002))
 #define CreateBoosterFlags_BinaryAsMulticlass      (CREATE_BOOSTER_FLAGS_CAST(0x00000004))
+#define CreateBoosterFlags_TargetSorted            (CREATE_BOOSTER_FLAGS_CAST(0x00000008))
+#define CreateBoosterFlags_QuantizeGradients       (CREATE_BOOSTER_FLAGS_CAST(0x00000010))
+#define CreateBoosterFlags_QuantizeGradientsInt8   (CREATE_BOOSTER_FLAGS_CAST(0x00000020))
+#define CreateBoosterFlags_Float32                 (CREATE_BOOSTER_FLAGS_CAST(0x00000040))
 
 #define TermBoostFlags_Default                     (TERM_BOOST_FLAGS_CAST(0x00000000))
 #define TermBoostFlags_DisableNewtonGain           (TERM_BOOST_FLAGS_CAST(0x00000001))
@@ -217,6 +225,8 @@ typedef struct _InteractionHandle {
 #define CreateInteractionFlags_DifferentialPrivacy (CREATE_INTERACTION_FLAGS_CAST(0x00000001))
 #define CreateInteractionFlags_DisableApprox       (CREATE_INTERACTION_FLAGS_CAST(0x00000002))
 #define CreateInteractionFlags_BinaryAsMulticlass  (CREATE_INTERACTION_FLAGS_CAST(0x00000004))
+#define CreateInteractionFlags_TargetSorted        (CREATE_INTERACTION_FLAGS_CAST(0x00000008))
+#define CreateInteractionFlags_Float32             (CREATE_INTERACTION_FLAGS_CAST(0x00000010))
 
 #define CalcInteractionFlags_Default               (CALC_INTERACTION_FLAGS_CAST(0x00000000))
 #define CalcInteractionFlags_Pure                  (CALC_INTERACTION_FLAGS_CAST(0x00000001))
@@ -289,6 +299,12 @@ EBM_API_INCLUDE void EBM_CALLING_CONVENTION SetLogCallback(LogCallbackFunction l
 EBM_API_INCLUDE void EBM_CALLING_CONVENTION SetTraceLevel(TraceEbm traceLevel);
 EBM_API_INCLUDE const char * EBM_CALLING_CONVENTION GetTraceLevelString(TraceEbm traceLevel);
 
+// SetThreadCount sets the number of threads that newly created handles will use. The default is 1. 
+// Zero means use all hardware threads, and negative values leave that many hardware threads unused.
+// The thread count does not change the models. With several inner bags, each bag draws from its own rng seeded
+// from the caller's rng in bag order, whether the bags are boosted in parallel or one after another.
+EBM_API_INCLUDE void EBM_CALLING_CONVENTION SetThreadCount(IntEbm countThreads);
+
 EBM_API_INCLUDE void EBM_CALLING_CONVENTION CleanFloats(IntEbm count, double * valsInOut);
 
 EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureRNG(void);
@@ -323,6 +339,48 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
    IntEbm * countCutsInOut,
    double * cutsLowerBoundInclusiveOut
 );
+// CutQuantiles cuts countFeatures features like calling CutQuantile on each of them, on the threads set by
+// SetThreadCount.  The values of feature i are featureVals[i * countSamples] up to featureVals[(i + 1) * countSamples].
+// minSamplesBin and countCutsInOut hold one item per feature.  The cuts of each feature are written right after the
+// space requested by the previous features in countCutsInOut.  On error the contents of countCutsInOut are undefined.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CutQuantiles(
+   IntEbm countFeatures,
+   IntEbm countSamples,
+   const double * featureVals,
+   const IntEbm * minSamplesBin,
+   BoolEbm isRounded,
+   IntEbm * countCutsInOut,
+   double * cutsLowerBoundInclusiveOut
+);
+// The quantile sketch functions compute quantile cuts over data that is seen in chunks, possibly on separate machines.
+// MeasureQuantileSketch returns the number of bytes needed for a sketch (or a negative ErrorEbm).  countItemsPerLevel
+// must be even and trades memory for accuracy.  InitQuantileSketch sets up a sketch in the caller's buffer,
+// AddToQuantileSketch adds a chunk of feature values (NaN values are counted as missing), and MergeQuantileSketch
+// adds the contents of one sketch into another with the same countItemsPerLevel.  The sketch holds no pointers, so
+// its bytes can be copied or saved and used later.  CutQuantileSketch returns the cuts that CutQuantile would
+// return on the sketched values, which are exact if fewer than countItemsPerLevel values were added.
+EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureQuantileSketch(IntEbm countItemsPerLevel);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION InitQuantileSketch(
+   IntEbm countItemsPerLevel,
+   IntEbm countBytesAllocated,
+   void * sketchOut
+);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION AddToQuantileSketch(
+   IntEbm countSamples,
+   const double * featureVals,
+   void * sketch
+);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION MergeQuantileSketch(
+   const void * sketchFrom,
+   void * sketchInto
+);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CutQuantileSketch(
+   const void * sketch,
+   IntEbm minSamplesBin,
+   BoolEbm isRounded,
+   IntEbm * countCutsInOut,
+   double * cutsLowerBoundInclusiveOut
+);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CutWinsorized(
    IntEbm countSamples,
    const double * featureVals,
@@ -347,6 +405,86 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION Discretize(
    const double * cutsLowerBoundInclusive,
    IntEbm * binIndexesOut
 );
+// DiscretizeMatrix bins several columns of a C ordered countSamples by countFeatures matrix of doubles in one call.
+// - binning i bins the feature binningFeatureIndexes[i] with binningCountCuts[i] cuts, and binningCuts is the
+//   concatenation of the cuts of all binnings in order. Each binning gives the same bins as Discretize.
+// - binIndexesOut receives countBinnings * countSamples bin indexes, with the bins of each binning contiguous.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION DiscretizeMatrix(
+   IntEbm countSamples,
+   IntEbm countFeatures,
+   const double * featureMatrix,
+   IntEbm countBinnings,
+   const IntEbm * binningFeatureIndexes,
+   const IntEbm * binningCountCuts,
+   const double * binningCuts,
+   IntEbm * binIndexesOut
+);
+
+// PredictScores evaluates a whole model over a countSamples by countFeatures matrix of doubles.
+// - each binning turns one feature column into bin indexes. Continuous binnings hold their cuts in binningValues
+//   and use the same bins as Discretize. Categorical binnings hold their category values in strictly increasing
+//   order in binningValues, with the bin of each value at the same position in binningCategoryBins. Missing (NaN)
+//   values go into bin 0 and categories that do not match go into the last bin.
+// - binningValues and binningCategoryBins are the concatenation of the values of all binnings in order.
+//   binningCategoryBins can be NULL if there are no categorical binnings.
+// - each term uses termDimensionCounts[i] binnings from termBinningIndexes, and its scores are a C ordered tensor
+//   with one dimension per binning of length binningCountBins followed by countScores. termScores is the
+//   concatenation of these tensors in term order.
+// - scoresOut receives countSamples * countScores values in C order. Link_identity returns the summed scores, and
+//   Link_log, Link_logit, Link_vlogit, and Link_mlogit apply their inverse link function.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION PredictScores(
+   IntEbm countSamples,
+   IntEbm countFeatures,
+   BoolEbm isFortranOrdered,
+   const double * featureMatrix,
+   IntEbm countBinnings,
+   const IntEbm * binningFeatureIndexes,
+   const BoolEbm * binningIsCategorical,
+   const IntEbm * binningCountBins,
+   const IntEbm * binningCountValues,
+   const double * binningValues,
+   const IntEbm * binningCategoryBins,
+   IntEbm countTerms,
+   const IntEbm * termDimensionCounts,
+   const IntEbm * termBinningIndexes,
+   IntEbm countScores,
+   const double * termScores,
+   const double * intercept,
+   LinkEbm link,
+   double * scoresOut
+);
+
+// CreateScoringModel takes the same model description as PredictScores and copies it into a single immutable
+// allocation that can then be used by any number of threads at once through PredictScoresWithModel. This avoids
+// repeating the validation and copying of the model on every call when scoring many small batches.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateScoringModel(
+   IntEbm countBinnings,
+   const IntEbm * binningFeatureIndexes,
+   const BoolEbm * binningIsCategorical,
+   const IntEbm * binningCountBins,
+   const IntEbm * binningCountValues,
+   const double * binningValues,
+   const IntEbm * binningCategoryBins,
+   IntEbm countTerms,
+   const IntEbm * termDimensionCounts,
+   const IntEbm * termBinningIndexes,
+   IntEbm countScores,
+   const double * termScores,
+   const double * intercept,
+   ScoringModelHandle * scoringModelHandleOut
+);
+EBM_API_INCLUDE void EBM_CALLING_CONVENTION FreeScoringModel(
+   ScoringModelHandle scoringModelHandle
+);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION PredictScoresWithModel(
+   ScoringModelHandle scoringModelHandle,
+   IntEbm countSamples,
+   IntEbm countFeatures,
+   BoolEbm isFortranOrdered,
+   const double * featureMatrix,
+   LinkEbm link,
+   double * scoresOut
+);
 
 EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureDataSetHeader(
    IntEbm countFeatures,
@@ -392,6 +530,20 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION FillFeature(
    IntEbm countBytesAllocated,
    void * fillMem
 );
+// FillFeatures fills the next countFeatures features like calling FillFeature on each of them, and packs their
+// bins on the threads set by SetThreadCount.  The bins of feature i are binIndexes[i * countSamples] up to
+// binIndexes[(i + 1) * countSamples].  The features are measured with MeasureFeature as usual.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION FillFeatures(
+   IntEbm countFeatures,
+   const IntEbm * countBins,
+   const BoolEbm * isMissing,
+   const BoolEbm * isUnknown,
+   const BoolEbm * isNominal,
+   IntEbm countSamples,
+   const IntEbm * binIndexes,
+   IntEbm countBytesAllocated,
+   void * fillMem
+);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION FillWeight(
    IntEbm countSamples,
    const double * weights,
@@ -446,6 +598,17 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION SampleWithoutReplacementStratifi
    const IntEbm * targets,
    BagEbm * bagOut
 );
+// SubsampleWithoutReplacement draws countSubsampleSamples of the training samples (positive counts in bag, or all the
+// samples if bag is nullptr) of dataSet.  Classification targets are stratified like SampleWithoutReplacementStratified.
+// bagOut keeps the bag counts of the chosen samples and the validation samples, and the training samples that were not
+// chosen get -1, so the initScores of bag can also be used with bagOut.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION SubsampleWithoutReplacement(
+   void * rng,
+   const void * dataSet,
+   const BagEbm * bag,
+   IntEbm countSubsampleSamples,
+   BagEbm * bagOut
+);
 
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION DetermineTask(
    const char * objective,
@@ -472,6 +635,19 @@ EBM_API_INCLUDE LinkEbm EBM_CALLING_CONVENTION GetLinkFunctionInt(
    const char * link
 );
 
+// CreateBoosterFlags_TargetSorted keeps the samples of each class of a classification dataset together in their own
+// data subsets, so binary log loss does not need to read the targets.  Scores match the unsorted layout up to the
+// floating point summation order, but the inner bags drawn from the same rng differ.
+// CreateBoosterFlags_QuantizeGradients rounds the training gradients and hessians to 16 bit integers with stochastic
+// rounding after every update, and builds the histograms with integer sums that are scaled back afterwards.  The 
+// floating point training gradients are not kept, so the booster cannot be used to create an interaction detector.
+// CreateBoosterFlags_QuantizeGradientsInt8 does the same with 8 bit integers, which halves the memory again but 
+// only has 127 levels per sign.  Both are ignored for weighted datasets and for RMSE regression, whose gradients are
+// the residuals.  Models differ slightly from unquantized boosting but remain deterministic given rng.
+// CreateBoosterFlags_Float32 computes the gradients and histograms in float32 instead of float64, which halves their
+// memory bandwidth.  Without a SIMD zone allowed by acceleration it uses the scalar float32 CPU zone.  The float32
+// SIMD zones are only used with this flag, and the float64 SIMD zones only with CreateBoosterFlags_DisableApprox, so
+// with neither flag everything is computed by the float64 CPU zone whatever the acceleration flags are.
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
    void * rng,
    const void * dataSet,
@@ -525,6 +701,32 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
    BoosterHandle boosterHandle,
    double * avgValidationMetricOut
 );
+// BoostRounds runs whole boosting rounds natively, using the same cyclic, greedy, smoothing, and early stopping
+// schedule as calling GenerateTermUpdate and ApplyTermUpdate for each term from the caller. If callback is not
+// NULL it is called after each round and boosting stops if it returns EBM_TRUE. countRoundsOut receives the
+// number of rounds completed and bestMetricOut the lowest validation metric seen.
+typedef BoolEbm (EBM_CALLING_CONVENTION * BoostRoundsCallbackFunction)(
+   void * callbackContext,
+   IntEbm indexRound,
+   double bestMetric
+);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION BoostRounds(
+   void * rng,
+   BoosterHandle boosterHandle,
+   TermBoostFlags flags,
+   double learningRate,
+   IntEbm minSamplesLeaf,
+   IntEbm maxLeaves,
+   double greediness,
+   IntEbm smoothingRounds,
+   IntEbm maxRounds,
+   IntEbm earlyStoppingRounds,
+   double earlyStoppingTolerance,
+   BoostRoundsCallbackFunction callback,
+   void * callbackContext,
+   IntEbm * countRoundsOut,
+   double * bestMetricOut
+);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION GetBestTermScores(
    BoosterHandle boosterHandle, 
    IntEbm indexTerm,
@@ -536,6 +738,9 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION GetCurrentTermScores(
    double * termScoresTensorOut
 );
 
+// CreateInteractionFlags_TargetSorted keeps the samples of each class together in their own data subsets, as with
+// CreateBoosterFlags_TargetSorted
+// CreateInteractionFlags_Float32 computes in float32, as with CreateBoosterFlags_Float32
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
    const void * dataSet,
    const BagEbm * bag,
@@ -547,6 +752,16 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
    const double * experimentalParams,
    InteractionHandle * interactionHandleOut
 );
+// CreateInteractionDetectorFromBooster creates an interaction detector on the training set of a booster without
+// building another dataset.  It uses the booster's gradients, weights and the bin indexes of its single feature
+// terms in place, so the strengths are those of the booster's current model, and they change as it boosts.
+// - calculating strengths on a feature that has no single feature term in the booster returns Error_IllegalParamVal.
+// - the booster cannot have both inner bags and sample weights since its inner bags mix in the bagging counts.
+// - do not boost while calculating strengths.  The booster stays alive until the detector is freed.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetectorFromBooster(
+   BoosterHandle boosterHandle,
+   InteractionHandle * interactionHandleOut
+);
 EBM_API_INCLUDE void EBM_CALLING_CONVENTION FreeInteractionDetector(
    InteractionHandle interactionHandle
 );
@@ -559,6 +774,51 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
    IntEbm minSamplesLeaf,
    double * avgInteractionStrengthOut
 );
+// CalcInteractionStrengths calculates the same strengths as CalcInteractionStrength for countTerms terms in one call,
+// spreading the terms over the threads set by SetThreadCount.
+// - term i has dimensionCounts[i] features, and featureIndexes is the concatenation of the features of all terms.
+// - if countTopTerms is zero, strengthsOut receives the strength of every term in order.
+// - otherwise only the countTopTerms strongest terms are kept. topTermIndexesOut receives their term indexes and
+//   strengthsOut their strengths, strongest first with ties going to the lower term index. Unused entries receive
+//   -1 as the term index. Pairs whose bound on their strength shows that they cannot be among the top terms are
+//   not fully calculated. This does not change the results, and countPrunedTermsOut receives how many were skipped
+//   if it is not nullptr.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrengths(
+   InteractionHandle interactionHandle,
+   IntEbm countTerms,
+   const IntEbm * dimensionCounts,
+   const IntEbm * featureIndexes,
+   CalcInteractionFlags flags,
+   IntEbm maxCardinality,
+   IntEbm minSamplesLeaf,
+   IntEbm countTopTerms,
+   IntEbm * topTermIndexesOut,
+   double * strengthsOut,
+   IntEbm * countPrunedTermsOut
+);
+// CalcInteractionStrengthsRefined ranks terms approximately for large datasets.  Every term is first calculated on
+// subsampleInteractionHandle, which is normally created on a bag from SubsampleWithoutReplacement, and only the
+// countRefinedTerms strongest are calculated again on interactionHandle.
+// - topTermIndexesOut and strengthsOut receive the countTopTerms strongest of the refined terms with their strengths
+//   on all the samples, ordered like CalcInteractionStrengths.  countTopTerms cannot be more than countRefinedTerms.
+// - if refinedTermIndexesOut is not nullptr it receives the indexes of the refined terms, strongest on the subsample
+//   first.  Unused entries in the outputs receive -1 as the term index.
+// - minSamplesLeaf is scaled down by the ratio of the sample counts for the subsample.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrengthsRefined(
+   InteractionHandle subsampleInteractionHandle,
+   InteractionHandle interactionHandle,
+   IntEbm countTerms,
+   const IntEbm * dimensionCounts,
+   const IntEbm * featureIndexes,
+   CalcInteractionFlags flags,
+   IntEbm maxCardinality,
+   IntEbm minSamplesLeaf,
+   IntEbm countRefinedTerms,
+   IntEbm countTopTerms,
+   IntEbm * topTermIndexesOut,
+   double * strengthsOut,
+   IntEbm * refinedTermIndexesOut
+);
 
 #ifdef __cplusplus
 } // extern "C"
@@ -15,7 +15,7 @@
 
 #include "RandomDeterministic.hpp"
 #include "RandomNondeterministic.hpp"
-#include "dataset_shared.hpp" // GetDataSetSharedWeight
+#include "dataset_shared.hpp" // GetDataSetSharedHeader, GetDataSetSharedTarget
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -430,6 +430,152 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION SampleWithoutReplacementStratified(
    return Error_None;
 }
 
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION SubsampleWithoutReplacement(
+   void * rng,
+   const void * dataSet,
+   const BagEbm * bag,
+   IntEbm countSubsampleSamples,
+   BagEbm * bagOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered SubsampleWithoutReplacement: "
+      "rng=%p, "
+      "dataSet=%p, "
+      "bag=%p, "
+      "countSubsampleSamples=%" IntEbmPrintf ", "
+      "bagOut=%p"
+      ,
+      rng,
+      static_cast<const void *>(dataSet),
+      static_cast<const void *>(bag),
+      countSubsampleSamples,
+      static_cast<void *>(bagOut)
+   );
+
+   ErrorEbm error;
+
+   if(UNLIKELY(nullptr == dataSet)) {
+      LOG_0(Trace_Error, "ERROR SubsampleWithoutReplacement nullptr == dataSet");
+      return Error_IllegalParamVal;
+   }
+
+   UIntShared countSamples;
+   size_t cFeatures;
+   size_t cWeights;
+   size_t cTargets;
+   error = GetDataSetSharedHeader(static_cast<const unsigned char *>(dataSet), &countSamples, &cFeatures, &cWeights, &cTargets);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+   if(IsConvertError<size_t>(countSamples) || IsMultiplyError(EbmMax(sizeof(IntEbm), sizeof(*bagOut)), static_cast<size_t>(countSamples))) {
+      LOG_0(Trace_Error, "ERROR SubsampleWithoutReplacement the number of samples is too large");
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   if(size_t { 1 } != cTargets) {
+      LOG_0(Trace_Error, "ERROR SubsampleWithoutReplacement the dataset must have 1 target");
+      return Error_IllegalParamVal;
+   }
+
+   if(UNLIKELY(countSubsampleSamples < IntEbm { 0 } || IsConvertError<size_t>(countSubsampleSamples))) {
+      LOG_0(Trace_Error, "ERROR SubsampleWithoutReplacement countSubsampleSamples must be a non-negative size_t");
+      return Error_IllegalParamVal;
+   }
+   const size_t cSubsampleSamples = static_cast<size_t>(countSubsampleSamples);
+
+   if(UNLIKELY(size_t { 0 } == cSamples)) {
+      LOG_0(Trace_Info, "Exited SubsampleWithoutReplacement with zero samples");
+      return Error_None;
+   }
+
+   if(UNLIKELY(nullptr == bagOut)) {
+      LOG_0(Trace_Error, "ERROR SubsampleWithoutReplacement nullptr == bagOut");
+      return Error_IllegalParamVal;
+   }
+
+   // only the training samples are sampled, which are the samples with positive bag counts
+   size_t cTrainingSamples = 0;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      if(nullptr == bag || BagEbm { 0 } < bag[iSample]) {
+         ++cTrainingSamples;
+      }
+   }
+
+   if(cTrainingSamples <= cSubsampleSamples) {
+      LOG_0(Trace_Info, "INFO SubsampleWithoutReplacement the subsample includes all the training samples");
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         bagOut[iSample] = nullptr == bag ? BagEbm { 1 } : bag[iSample];
+      }
+      LOG_0(Trace_Info, "Exited SubsampleWithoutReplacement");
+      return Error_None;
+   }
+
+   ptrdiff_t cClasses;
+   const void * const aTargets = GetDataSetSharedTarget(static_cast<const unsigned char *>(dataSet), 0, &cClasses);
+   if(nullptr == aTargets) {
+      LOG_0(Trace_Error, "ERROR SubsampleWithoutReplacement nullptr == aTargets");
+      return Error_IllegalParamVal;
+   }
+
+   // the sampled bag of the training samples is written at the front of bagOut and then spread out to the positions
+   // of the training samples from the back, which never overwrites an entry that has not been read yet
+   if(ptrdiff_t { Task_GeneralClassification } <= cClasses) {
+      // stratify by the target so that rare classes keep their share of the subsample
+      IntEbm * const aTrainingTargets = static_cast<IntEbm *>(malloc(sizeof(IntEbm) * cTrainingSamples));
+      if(UNLIKELY(nullptr == aTrainingTargets)) {
+         LOG_0(Trace_Warning, "WARNING SubsampleWithoutReplacement nullptr == aTrainingTargets");
+         return Error_OutOfMemory;
+      }
+      const UIntShared * const aClassTargets = static_cast<const UIntShared *>(aTargets);
+      size_t iTraining = 0;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         if(nullptr == bag || BagEbm { 0 } < bag[iSample]) {
+            aTrainingTargets[iTraining] = static_cast<IntEbm>(aClassTargets[iSample]);
+            ++iTraining;
+         }
+      }
+      error = SampleWithoutReplacementStratified(
+         rng,
+         static_cast<IntEbm>(cClasses),
+         static_cast<IntEbm>(cSubsampleSamples),
+         static_cast<IntEbm>(cTrainingSamples - cSubsampleSamples),
+         aTrainingTargets,
+         bagOut
+      );
+      free(aTrainingTargets);
+   } else {
+      error = SampleWithoutReplacement(
+         rng,
+         static_cast<IntEbm>(cSubsampleSamples),
+         static_cast<IntEbm>(cTrainingSamples - cSubsampleSamples),
+         bagOut
+      );
+   }
+   if(Error_None != error) {
+      return error;
+   }
+
+   size_t iTraining = cTrainingSamples;
+   size_t iSample = cSamples;
+   do {
+      --iSample;
+      const BagEbm replication = nullptr == bag ? BagEbm { 1 } : bag[iSample];
+      if(BagEbm { 0 } < replication) {
+         --iTraining;
+         // unselected training samples become validation samples, so the same initScores line up with bagOut
+         bagOut[iSample] = BagEbm { 0 } < bagOut[iTraining] ? replication : BagEbm { -1 };
+      } else {
+         bagOut[iSample] = replication;
+      }
+   } while(size_t { 0 } != iSample);
+   EBM_ASSERT(size_t { 0 } == iTraining);
+
+   LOG_0(Trace_Info, "Exited SubsampleWithoutReplacement");
+   return Error_None;
+}
+
 extern ErrorEbm Unbag(
    const size_t cSamples,
    const BagEbm * const aBag,
@@ -1448,3 +1448,257 @@ TEST_CASE("CutQuantile, chunky randomized check") {
    }
 }
 
+
+TEST_CASE("CutQuantiles, matches CutQuantile on each feature") {
+   static constexpr IntEbm countSamples = 3001;
+   static constexpr size_t k_cFeatures = 7;
+
+   // the features have different value distributions, minSamplesBin values, and requested cut counts, including a
+   // feature with no cuts requested and one with too few unique values to cut
+   std::vector<double> featureVals(k_cFeatures * static_cast<size_t>(countSamples));
+   for(size_t iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+      for(size_t iSample = 0; iSample < static_cast<size_t>(countSamples); ++iSample) {
+         double val;
+         if(6 == iFeature) {
+            val = 3.0;
+         } else if(0 == (iSample + iFeature) % 97) {
+            val = std::numeric_limits<double>::quiet_NaN();
+         } else {
+            val = static_cast<double>((iSample * (iFeature * 2 + 3) + iFeature * 17) % (50 + iFeature * 300)) * 0.25;
+         }
+         featureVals[iFeature * static_cast<size_t>(countSamples) + iSample] = val;
+      }
+   }
+   const std::vector<IntEbm> minSamplesBin = { 1, 3, 10, 1, 50, 2, 1 };
+   const std::vector<IntEbm> countCutsRequested = { 20, 5, 100, 0, 254, 7, 3 };
+
+   for(int iRun = 0; iRun < 2; ++iRun) {
+      SetThreadCount(0 == iRun ? 1 : 4);
+
+      std::vector<IntEbm> countCuts = countCutsRequested;
+      size_t cCutsTotal = 0;
+      for(const IntEbm countCutsRequestedFeature : countCutsRequested) {
+         cCutsTotal += static_cast<size_t>(countCutsRequestedFeature);
+      }
+      std::vector<double> cuts(cCutsTotal);
+
+      ErrorEbm error = CutQuantiles(
+         static_cast<IntEbm>(k_cFeatures),
+         countSamples,
+         &featureVals[0],
+         &minSamplesBin[0],
+         0 == iRun ? EBM_FALSE : EBM_TRUE,
+         &countCuts[0],
+         &cuts[0]
+      );
+      CHECK(Error_None == error);
+
+      size_t iCutFirst = 0;
+      for(size_t iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+         IntEbm countCutsExpected = countCutsRequested[iFeature];
+         std::vector<double> cutsExpected(static_cast<size_t>(countCutsExpected) + 1);
+         error = CutQuantile(
+            countSamples,
+            &featureVals[iFeature * static_cast<size_t>(countSamples)],
+            minSamplesBin[iFeature],
+            0 == iRun ? EBM_FALSE : EBM_TRUE,
+            &countCutsExpected,
+            &cutsExpected[0]
+         );
+         CHECK(Error_None == error);
+
+         CHECK(countCutsExpected == countCuts[iFeature]);
+         if(countCutsExpected == countCuts[iFeature]) {
+            for(size_t iCut = 0; iCut < static_cast<size_t>(countCutsExpected); ++iCut) {
+               CHECK(cutsExpected[iCut] == cuts[iCutFirst + iCut]);
+            }
+         }
+         iCutFirst += static_cast<size_t>(countCutsRequested[iFeature]);
+      }
+      CHECK(0 == countCuts[3]);
+      CHECK(0 == countCuts[6]);
+      CHECK(0 < countCuts[0]);
+   }
+   SetThreadCount(1);
+}
+
+TEST_CASE("CutQuantileSketch, uncompacted sketch matches CutQuantile") {
+   static constexpr IntEbm countSamples = 3001;
+   static constexpr IntEbm countItemsPerLevel = 4096;
+
+   std::vector<double> featureVals(static_cast<size_t>(countSamples));
+   for(size_t iSample = 0; iSample < featureVals.size(); ++iSample) {
+      featureVals[iSample] = 0 == iSample % 97 ? std::numeric_limits<double>::quiet_NaN() :
+         static_cast<double>((iSample * 7 + 17) % 650) * 0.25;
+   }
+
+   const IntEbm countBytes = MeasureQuantileSketch(countItemsPerLevel);
+   CHECK(0 < countBytes);
+   std::vector<unsigned char> sketch1(static_cast<size_t>(countBytes));
+   std::vector<unsigned char> sketch2(static_cast<size_t>(countBytes));
+   ErrorEbm error = InitQuantileSketch(countItemsPerLevel, countBytes, &sketch1[0]);
+   CHECK(Error_None == error);
+   error = InitQuantileSketch(countItemsPerLevel, countBytes, &sketch2[0]);
+   CHECK(Error_None == error);
+
+   // add the first half in two chunks, and the second half to a separate sketch that we merge in
+   static constexpr IntEbm countFirst = 1000;
+   static constexpr IntEbm countSecond = 500;
+   error = AddToQuantileSketch(countFirst, &featureVals[0], &sketch1[0]);
+   CHECK(Error_None == error);
+   error = AddToQuantileSketch(countSecond, &featureVals[countFirst], &sketch1[0]);
+   CHECK(Error_None == error);
+   error = AddToQuantileSketch(
+      countSamples - countFirst - countSecond, &featureVals[countFirst + countSecond], &sketch2[0]);
+   CHECK(Error_None == error);
+   error = MergeQuantileSketch(&sketch2[0], &sketch1[0]);
+   CHECK(Error_None == error);
+
+   for(int iRounded = 0; iRounded < 2; ++iRounded) {
+      for(IntEbm minSamplesBin = 1; minSamplesBin <= 10; minSamplesBin += 9) {
+         IntEbm countCutsExpected = 40;
+         std::vector<double> cutsExpected(static_cast<size_t>(countCutsExpected));
+         error = CutQuantile(countSamples, &featureVals[0], minSamplesBin,
+            0 == iRounded ? EBM_FALSE : EBM_TRUE, &countCutsExpected, &cutsExpected[0]);
+         CHECK(Error_None == error);
+
+         IntEbm countCuts = 40;
+         std::vector<double> cuts(static_cast<size_t>(countCuts));
+         error = CutQuantileSketch(&sketch1[0], minSamplesBin,
+            0 == iRounded ? EBM_FALSE : EBM_TRUE, &countCuts, &cuts[0]);
+         CHECK(Error_None == error);
+
+         CHECK(countCutsExpected == countCuts);
+         if(countCutsExpected == countCuts) {
+            for(size_t iCut = 0; iCut < static_cast<size_t>(countCuts); ++iCut) {
+               CHECK(cutsExpected[iCut] == cuts[iCut]);
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("CutQuantileSketch, compacted and merged sketches approximate the quantiles") {
+   static constexpr size_t k_cSamples = 200000;
+   static constexpr size_t k_cShards = 4;
+   static constexpr IntEbm countItemsPerLevel = 256;
+   static constexpr IntEbm countCutsRequested = 9;
+
+   // a permutation of 0 to k_cSamples - 1 so that the sketch does not see the values in order
+   std::vector<double> featureVals(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      featureVals[iSample] = static_cast<double>(iSample * 7919 % k_cSamples);
+   }
+
+   const IntEbm countBytes = MeasureQuantileSketch(countItemsPerLevel);
+   CHECK(0 < countBytes);
+   std::vector<unsigned char> sketchAll(static_cast<size_t>(countBytes));
+   std::vector<unsigned char> sketchMerged(static_cast<size_t>(countBytes));
+   ErrorEbm error = InitQuantileSketch(countItemsPerLevel, countBytes, &sketchAll[0]);
+   CHECK(Error_None == error);
+   error = InitQuantileSketch(countItemsPerLevel, countBytes, &sketchMerged[0]);
+   CHECK(Error_None == error);
+
+   error = AddToQuantileSketch(static_cast<IntEbm>(k_cSamples), &featureVals[0], &sketchAll[0]);
+   CHECK(Error_None == error);
+
+   static constexpr size_t k_cShardSamples = k_cSamples / k_cShards;
+   for(size_t iShard = 0; iShard < k_cShards; ++iShard) {
+      std::vector<unsigned char> sketchShard(static_cast<size_t>(countBytes));
+      error = InitQuantileSketch(countItemsPerLevel, countBytes, &sketchShard[0]);
+      CHECK(Error_None == error);
+      error = AddToQuantileSketch(
+         static_cast<IntEbm>(k_cShardSamples), &featureVals[iShard * k_cShardSamples], &sketchShard[0]);
+      CHECK(Error_None == error);
+
+      // the sketch holds no pointers, so a byte copy of it is equally usable
+      std::vector<unsigned char> sketchCopy(sketchShard);
+      error = MergeQuantileSketch(&sketchCopy[0], &sketchMerged[0]);
+      CHECK(Error_None == error);
+   }
+
+   for(int iSketch = 0; iSketch < 2; ++iSketch) {
+      IntEbm countCuts = countCutsRequested;
+      std::vector<double> cuts(static_cast<size_t>(countCuts));
+      error = CutQuantileSketch(0 == iSketch ? &sketchAll[0] : &sketchMerged[0], 1, EBM_FALSE, &countCuts, &cuts[0]);
+      CHECK(Error_None == error);
+      CHECK(countCutsRequested == countCuts);
+      if(countCutsRequested == countCuts) {
+         for(size_t iCut = 0; iCut < static_cast<size_t>(countCuts); ++iCut) {
+            const double expected = static_cast<double>(k_cSamples) / static_cast<double>(countCutsRequested + 1) *
+               static_cast<double>(iCut + 1);
+            CHECK(std::abs(cuts[iCut] - expected) < static_cast<double>(k_cSamples) * 0.02);
+         }
+      }
+   }
+
+   error = MergeQuantileSketch(&sketchAll[0], &sketchAll[0]);
+   CHECK(Error_IllegalParamVal == error);
+   CHECK(Error_IllegalParamVal == MeasureQuantileSketch(3));
+}
+
+TEST_CASE("CutQuantileSketch, corrupted sketch header is rejected") {
+   static constexpr IntEbm countItemsPerLevel = 8;
+   // the header is a sequence of UIntEbm: id, itemsPerLevel, samples, missing, compactionParity, then the level counts
+   static constexpr size_t k_iItemsPerLevel = 1;
+   static constexpr size_t k_iSamples = 2;
+   static constexpr size_t k_iMissing = 3;
+   static constexpr size_t k_iLevel0 = 5;
+   static constexpr size_t k_iLevel1 = 6;
+
+   const double featureVals[] = { 5.0, 1.0, 4.0, 2.0, 3.0, 8.0, 7.0, 6.0, 9.0, 0.0, 11.0 };
+   static constexpr IntEbm countSamples = static_cast<IntEbm>(sizeof(featureVals) / sizeof(featureVals[0]));
+
+   const IntEbm countBytes = MeasureQuantileSketch(countItemsPerLevel);
+   CHECK(0 < countBytes);
+   std::vector<unsigned char> sketch(static_cast<size_t>(countBytes));
+   ErrorEbm error = InitQuantileSketch(countItemsPerLevel, countBytes, &sketch[0]);
+   CHECK(Error_None == error);
+   error = AddToQuantileSketch(countSamples, featureVals, &sketch[0]);
+   CHECK(Error_None == error);
+
+   const auto corrupt = [&sketch](const size_t iField, const UIntEbm val) {
+      std::vector<unsigned char> corrupted(sketch);
+      memcpy(&corrupted[iField * sizeof(UIntEbm)], &val, sizeof(val));
+      return corrupted;
+   };
+
+   UIntEbm cItemsLevel0;
+   memcpy(&cItemsLevel0, &sketch[k_iLevel0 * sizeof(UIntEbm)], sizeof(cItemsLevel0));
+   UIntEbm cMissing;
+   memcpy(&cMissing, &sketch[k_iMissing * sizeof(UIntEbm)], sizeof(cMissing));
+
+   std::vector<std::vector<unsigned char>> corruptions;
+   corruptions.push_back(corrupt(k_iItemsPerLevel, 0));
+   corruptions.push_back(corrupt(k_iItemsPerLevel, 7));
+   corruptions.push_back(corrupt(k_iItemsPerLevel, ~UIntEbm { 0 }));
+   corruptions.push_back(corrupt(k_iLevel0, static_cast<UIntEbm>(countItemsPerLevel)));
+   corruptions.push_back(corrupt(k_iLevel0, ~UIntEbm { 0 }));
+   corruptions.push_back(corrupt(k_iLevel1, cItemsLevel0));
+   corruptions.push_back(corrupt(k_iSamples, 0));
+   corruptions.push_back(corrupt(k_iMissing, ~UIntEbm { 0 } - cMissing));
+
+   for(std::vector<unsigned char> & corrupted : corruptions) {
+      IntEbm countCuts = 4;
+      double cuts[4];
+      error = CutQuantileSketch(&corrupted[0], 1, EBM_FALSE, &countCuts, cuts);
+      CHECK(Error_IllegalParamVal == error);
+
+      std::vector<unsigned char> into(static_cast<size_t>(countBytes));
+      error = InitQuantileSketch(countItemsPerLevel, countBytes, &into[0]);
+      CHECK(Error_None == error);
+      error = MergeQuantileSketch(&corrupted[0], &into[0]);
+      CHECK(Error_IllegalParamVal == error);
+      error = MergeQuantileSketch(&into[0], &corrupted[0]);
+      CHECK(Error_IllegalParamVal == error);
+
+      error = AddToQuantileSketch(countSamples, featureVals, &corrupted[0]);
+      CHECK(Error_IllegalParamVal == error);
+   }
+
+   // the untouched sketch is still usable
+   IntEbm countCuts = 4;
+   double cuts[4];
+   error = CutQuantileSketch(&sketch[0], 1, EBM_FALSE, &countCuts, cuts);
+   CHECK(Error_None == error);
+}
@@ -122,3 +122,168 @@ TEST_CASE("Discretize, increasing lengths") {
    }
 }
 
+
+TEST_CASE("Discretize, short lengths and partial SIMD packs") {
+   // the SIMD kernels process 8 or 16 values per loop and then finish with partially filled packs, so check every
+   // length around those boundaries for both the linear compare kernel and the binary search kernel
+   static constexpr size_t cSamplesMax = 40;
+   double featureVals[cSamplesMax];
+   IntEbm aiBins[cSamplesMax + 1];
+
+   std::vector<double> cutsLowerBoundInclusive;
+   for(size_t cCuts : { size_t { 1 }, size_t { 3 }, size_t { 16 }, size_t { 17 }, size_t { 100 } }) {
+      cutsLowerBoundInclusive.clear();
+      for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+         cutsLowerBoundInclusive.push_back(static_cast<double>(iCut) * 2.0);
+      }
+      for(size_t iSample = 0; iSample < cSamplesMax; ++iSample) {
+         // alternate between values exactly on cuts, values between cuts, and the special values
+         const size_t iCut = (iSample * 7) % (cCuts + 2);
+         double val = static_cast<double>(iCut) * 2.0 - (0 == iSample % 2 ? 0.0 : 1.0);
+         val = 0 == iSample % 11 ? std::numeric_limits<double>::quiet_NaN() : val;
+         val = 5 == iSample % 13 ? std::numeric_limits<double>::infinity() : val;
+         val = 9 == iSample % 13 ? -std::numeric_limits<double>::infinity() : val;
+         featureVals[iSample] = val;
+      }
+
+      for(size_t cSamples = 1; cSamples <= cSamplesMax; ++cSamples) {
+         // the kernels should never write past the end of the output
+         aiBins[cSamples] = IntEbm { -1 };
+         const ErrorEbm error = Discretize(
+            static_cast<IntEbm>(cSamples),
+            featureVals,
+            static_cast<IntEbm>(cCuts),
+            &cutsLowerBoundInclusive[0],
+            aiBins
+         );
+         CHECK(Error_None == error);
+         CHECK(IntEbm { -1 } == aiBins[cSamples]);
+
+         for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+            const double val = featureVals[iSample];
+            const IntEbm iBinExpected = std::isnan(val) ? IntEbm { 0 } : IntEbm { 1 } + static_cast<IntEbm>(
+               std::upper_bound(cutsLowerBoundInclusive.begin(), cutsLowerBoundInclusive.end(), val) -
+               cutsLowerBoundInclusive.begin());
+            CHECK(iBinExpected == aiBins[iSample]);
+         }
+      }
+   }
+}
+
+TEST_CASE("Discretize, many cuts use the Eytzinger layout") {
+   // cut counts on both sides of the powers of two that change the depth of the tree
+   for(size_t cCuts : { size_t { 1024 }, size_t { 1500 }, size_t { 2047 }, size_t { 2048 } }) {
+      std::vector<double> cutsLowerBoundInclusive(cCuts);
+      for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+         cutsLowerBoundInclusive[iCut] = static_cast<double>(iCut) * 2.0 - 100.0;
+      }
+
+      // the layout is only built when there are at least as many samples as cuts
+      const size_t cSamples = cCuts + 13;
+      std::vector<double> featureVals(cSamples);
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         // values on the cuts, between cuts, and off both ends
+         double val = static_cast<double>((iSample * 7) % (cCuts + 4)) * 2.0 - 104.0 + (0 == iSample % 2 ? 0.0 : 1.0);
+         val = 0 == iSample % 11 ? std::numeric_limits<double>::quiet_NaN() : val;
+         val = 5 == iSample % 13 ? std::numeric_limits<double>::infinity() : val;
+         val = 9 == iSample % 13 ? -std::numeric_limits<double>::infinity() : val;
+         featureVals[iSample] = val;
+      }
+
+      std::vector<IntEbm> binIndexes(cSamples);
+      const ErrorEbm error = Discretize(
+         static_cast<IntEbm>(cSamples),
+         &featureVals[0],
+         static_cast<IntEbm>(cCuts),
+         &cutsLowerBoundInclusive[0],
+         &binIndexes[0]
+      );
+      CHECK(Error_None == error);
+
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const double val = featureVals[iSample];
+         const IntEbm iBinExpected = std::isnan(val) ? IntEbm { 0 } : IntEbm { 1 } + static_cast<IntEbm>(
+            std::upper_bound(cutsLowerBoundInclusive.begin(), cutsLowerBoundInclusive.end(), val) -
+            cutsLowerBoundInclusive.begin());
+         CHECK(iBinExpected == binIndexes[iSample]);
+      }
+   }
+}
+
+TEST_CASE("DiscretizeMatrix, matches Discretize on each column") {
+   // more binnings than fit in one transposed stripe, a binning with enough cuts for the Eytzinger layout, and a
+   // final block of samples too short for SIMD
+   static constexpr size_t cSamples = 1030;
+   static constexpr size_t cFeatures = 5;
+   static constexpr size_t cBinnings = 70;
+
+   std::vector<double> featureMatrix(cSamples * cFeatures);
+   for(size_t iVal = 0; iVal < featureMatrix.size(); ++iVal) {
+      const double val = static_cast<double>((iVal * 37) % 101) - 50.0;
+      featureMatrix[iVal] = 0 == iVal % 17 ? std::numeric_limits<double>::quiet_NaN() : val;
+   }
+
+   std::vector<IntEbm> binningFeatureIndexes;
+   std::vector<IntEbm> binningCountCuts;
+   std::vector<double> binningCuts;
+   for(size_t iBinning = 0; iBinning < cBinnings; ++iBinning) {
+      binningFeatureIndexes.push_back(static_cast<IntEbm>((iBinning * 3) % cFeatures));
+      const size_t cCuts = 5 == iBinning ? size_t { 1024 } : (iBinning * 11) % 40;
+      binningCountCuts.push_back(static_cast<IntEbm>(cCuts));
+      for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+         binningCuts.push_back(static_cast<double>(iCut) * (5 == iBinning ? 0.0625 : 2.5) - 45.0);
+      }
+   }
+
+   std::vector<IntEbm> binIndexes(cBinnings * cSamples, IntEbm { -1 });
+   ErrorEbm error = DiscretizeMatrix(
+      static_cast<IntEbm>(cSamples),
+      static_cast<IntEbm>(cFeatures),
+      &featureMatrix[0],
+      static_cast<IntEbm>(cBinnings),
+      &binningFeatureIndexes[0],
+      &binningCountCuts[0],
+      &binningCuts[0],
+      &binIndexes[0]
+   );
+   CHECK(Error_None == error);
+
+   std::vector<double> column(cSamples);
+   std::vector<IntEbm> expected(cSamples);
+   const double * pCuts = &binningCuts[0];
+   for(size_t iBinning = 0; iBinning < cBinnings; ++iBinning) {
+      const size_t iFeature = static_cast<size_t>(binningFeatureIndexes[iBinning]);
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         column[iSample] = featureMatrix[iSample * cFeatures + iFeature];
+      }
+      error = Discretize(static_cast<IntEbm>(cSamples), &column[0], binningCountCuts[iBinning], pCuts, &expected[0]);
+      CHECK(Error_None == error);
+      pCuts += binningCountCuts[iBinning];
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         CHECK(expected[iSample] == binIndexes[iBinning * cSamples + iSample]);
+      }
+   }
+}
+
+TEST_CASE("DiscretizeMatrix, illegal inputs") {
+   const double featureMatrix[] = { 1.0, 2.0, 3.0, 4.0 };
+   const double cuts[] = { 2.5 };
+   const IntEbm countCuts[] = { 1 };
+   IntEbm binIndexes[2];
+
+   const IntEbm badFeature[] = { 2 };
+   CHECK(Error_IllegalParamVal == DiscretizeMatrix(2, 2, featureMatrix, 1, badFeature, countCuts, cuts, binIndexes));
+
+   const IntEbm feature[] = { 1 };
+   const IntEbm badCountCuts[] = { -1 };
+   CHECK(Error_IllegalParamVal == DiscretizeMatrix(2, 2, featureMatrix, 1, feature, badCountCuts, cuts, binIndexes));
+   CHECK(Error_IllegalParamVal == DiscretizeMatrix(2, 2, featureMatrix, 1, feature, countCuts, nullptr, binIndexes));
+   CHECK(Error_IllegalParamVal == DiscretizeMatrix(-1, 2, featureMatrix, 1, feature, countCuts, cuts, binIndexes));
+
+   // nothing to do is legal even with null arrays
+   CHECK(Error_None == DiscretizeMatrix(0, 2, nullptr, 1, nullptr, nullptr, nullptr, nullptr));
+
+   CHECK(Error_None == DiscretizeMatrix(2, 2, featureMatrix, 1, feature, countCuts, cuts, binIndexes));
+   CHECK(IntEbm { 1 } == binIndexes[0]);
+   CHECK(IntEbm { 2 } == binIndexes[1]);
+}
@@ -0,0 +1,448 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "pch_test.hpp"
+
+#include <thread>
+
+#include "libebm.h"
+#include "libebm_test.hpp"
+
+static constexpr TestPriority k_filePriority = TestPriority::PredictScores;
+
+// feature 0 is continuous with 2 cuts, feature 1 is categorical with values 10, 20, 30 where 20 and 30 share a bin
+static constexpr IntEbm k_countFeatures = 2;
+static const IntEbm k_binningFeatureIndexes[] { 0, 1 };
+static const BoolEbm k_binningIsCategorical[] { EBM_FALSE, EBM_TRUE };
+static const IntEbm k_binningCountBins[] { 5, 4 };
+static const IntEbm k_binningCountValues[] { 2, 3 };
+static const double k_binningValues[] { 1.5, 3.5, 10, 20, 30 };
+static const IntEbm k_binningCategoryBins[] { 0, 0, 1, 2, 2 };
+static const IntEbm k_termDimensionCounts[] { 1, 1, 2 };
+static const IntEbm k_termBinningIndexes[] { 0, 1, 0, 1 };
+
+static double ExpectedScore(const double val0, const double val1, const double * const aTermScores) {
+   // the missing bin is 0, and the cuts are lower bound inclusive
+   const IntEbm iBin0 = std::isnan(val0) ? 0 : 1 + (k_binningValues[0] <= val0 ? 1 : 0) + (k_binningValues[1] <= val0 ? 1 : 0);
+   IntEbm iBin1 = std::isnan(val1) ? 0 : 3;
+   for(size_t iCategory = 0; iCategory < 3; ++iCategory) {
+      if(k_binningValues[2 + iCategory] == val1) {
+         iBin1 = k_binningCategoryBins[2 + iCategory];
+      }
+   }
+   return 0.25 + aTermScores[iBin0] + aTermScores[5 + iBin1] + aTermScores[5 + 4 + iBin0 * 4 + iBin1];
+}
+
+static std::vector<double> MakeTermScores() {
+   std::vector<double> termScores(5 + 4 + 5 * 4);
+   for(size_t i = 0; i < termScores.size(); ++i) {
+      termScores[i] = static_cast<double>(i) * 0.125 - 1.0;
+   }
+   return termScores;
+}
+
+TEST_CASE("PredictScores, continuous categorical and pair, C and Fortran ordered") {
+   const std::vector<double> termScores = MakeTermScores();
+   const double intercept[] { 0.25 };
+
+   const double aVals0[] { std::numeric_limits<double>::quiet_NaN(), 0.0, 1.5, 2.0, 3.5, 100.0 };
+   const double aVals1[] { 20.0, std::numeric_limits<double>::quiet_NaN(), 10.0, 30.0, 15.0, 10.0 };
+   static constexpr size_t cSamples = sizeof(aVals0) / sizeof(aVals0[0]);
+
+   double aCOrdered[cSamples * 2];
+   double aFortranOrdered[cSamples * 2];
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      aCOrdered[iSample * 2 + 0] = aVals0[iSample];
+      aCOrdered[iSample * 2 + 1] = aVals1[iSample];
+      aFortranOrdered[iSample] = aVals0[iSample];
+      aFortranOrdered[cSamples + iSample] = aVals1[iSample];
+   }
+
+   for(int iOrder = 0; iOrder < 2; ++iOrder) {
+      double scores[cSamples];
+      const ErrorEbm error = PredictScores(
+         static_cast<IntEbm>(cSamples),
+         k_countFeatures,
+         0 == iOrder ? EBM_FALSE : EBM_TRUE,
+         0 == iOrder ? aCOrdered : aFortranOrdered,
+         2,
+         k_binningFeatureIndexes,
+         k_binningIsCategorical,
+         k_binningCountBins,
+         k_binningCountValues,
+         k_binningValues,
+         k_binningCategoryBins,
+         3,
+         k_termDimensionCounts,
+         k_termBinningIndexes,
+         1,
+         &termScores[0],
+         intercept,
+         Link_identity,
+         scores
+      );
+      CHECK(Error_None == error);
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         CHECK_APPROX(scores[iSample], ExpectedScore(aVals0[iSample], aVals1[iSample], &termScores[0]));
+      }
+   }
+}
+
+TEST_CASE("PredictScores, multithreaded matches single threaded") {
+   const std::vector<double> termScores = MakeTermScores();
+   const double intercept[] { 0.25 };
+
+   static constexpr size_t cSamples = 10007;
+   std::vector<double> featureMatrix(cSamples * 2);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      featureMatrix[iSample * 2 + 0] = static_cast<double>(iSample % 9) * 0.5;
+      featureMatrix[iSample * 2 + 1] = static_cast<double>(iSample % 4) * 10.0;
+   }
+
+   std::vector<double> scores1(cSamples);
+   std::vector<double> scores4(cSamples);
+   for(int iRun = 0; iRun < 2; ++iRun) {
+      SetThreadCount(0 == iRun ? 1 : 4);
+      const ErrorEbm error = PredictScores(
+         static_cast<IntEbm>(cSamples),
+         k_countFeatures,
+         EBM_FALSE,
+         &featureMatrix[0],
+         2,
+         k_binningFeatureIndexes,
+         k_binningIsCategorical,
+         k_binningCountBins,
+         k_binningCountValues,
+         k_binningValues,
+         k_binningCategoryBins,
+         3,
+         k_termDimensionCounts,
+         k_termBinningIndexes,
+         1,
+         &termScores[0],
+         intercept,
+         Link_identity,
+         0 == iRun ? &scores1[0] : &scores4[0]
+      );
+      CHECK(Error_None == error);
+   }
+   SetThreadCount(1);
+
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      CHECK(scores1[iSample] == scores4[iSample]);
+      CHECK_APPROX(scores1[iSample],
+         ExpectedScore(featureMatrix[iSample * 2 + 0], featureMatrix[iSample * 2 + 1], &termScores[0]));
+   }
+}
+
+TEST_CASE("PredictScores, inverse links") {
+   // a single term with no dimensions just adds its scores to the intercept
+   const IntEbm termDimensionCounts[] { 0 };
+   const double termScores[] { 0.5, -1.0, 2.0 };
+   const double intercept[] { 0.0, 1.0, -2.0 };
+
+   double scores[3];
+   ErrorEbm error;
+
+   error = PredictScores(1, 0, EBM_FALSE, nullptr, 0, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+      1, termDimensionCounts, nullptr, 1, termScores, intercept, Link_logit, scores);
+   CHECK(Error_None == error);
+   CHECK_APPROX(scores[0], 1.0 / (1.0 + std::exp(-0.5)));
+
+   error = PredictScores(1, 0, EBM_FALSE, nullptr, 0, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+      1, termDimensionCounts, nullptr, 1, termScores, intercept, Link_log, scores);
+   CHECK(Error_None == error);
+   CHECK_APPROX(scores[0], std::exp(0.5));
+
+   error = PredictScores(1, 0, EBM_FALSE, nullptr, 0, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+      1, termDimensionCounts, nullptr, 3, termScores, intercept, Link_mlogit, scores);
+   CHECK(Error_None == error);
+   // all 3 logits are 0.5, 0.0, and 0.0
+   const double sum = std::exp(0.5) + 2.0;
+   CHECK_APPROX(scores[0], std::exp(0.5) / sum);
+   CHECK_APPROX(scores[1], 1.0 / sum);
+   CHECK_APPROX(scores[2], 1.0 / sum);
+
+   // logit needs exactly 1 score
+   error = PredictScores(1, 0, EBM_FALSE, nullptr, 0, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+      1, termDimensionCounts, nullptr, 3, termScores, intercept, Link_logit, scores);
+   CHECK(Error_IllegalParamVal == error);
+}
+
+TEST_CASE("PredictScores, continuous feature with enough cuts for the Eytzinger layout") {
+   static constexpr size_t cCuts = 3000;
+   std::vector<double> cuts(cCuts);
+   for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+      cuts[iCut] = static_cast<double>(iCut) * 0.5;
+   }
+   // the score of each bin is its index, so the scores tell us which bin each sample went into
+   std::vector<double> termScores(cCuts + 3);
+   for(size_t iBin = 0; iBin < termScores.size(); ++iBin) {
+      termScores[iBin] = static_cast<double>(iBin);
+   }
+   const IntEbm binningFeatureIndexes[] { 0 };
+   const BoolEbm binningIsCategorical[] { EBM_FALSE };
+   const IntEbm binningCountBins[] { static_cast<IntEbm>(cCuts + 3) };
+   const IntEbm binningCountValues[] { static_cast<IntEbm>(cCuts) };
+   const IntEbm termDimensionCounts[] { 1 };
+   const IntEbm termBinningIndexes[] { 0 };
+
+   // a few samples use the scalar search, and more use SIMD with a partial pack at the end
+   for(size_t cSamples : { size_t { 5 }, size_t { 1003 } }) {
+      std::vector<double> vals(cSamples);
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         double val = static_cast<double>((iSample * 613) % (cCuts + 7)) * 0.5 - 1.25;
+         val = 0 == iSample % 7 ? static_cast<double>(iSample) * 0.5 : val;
+         val = 3 == iSample % 11 ? std::numeric_limits<double>::quiet_NaN() : val;
+         val = 4 == iSample % 13 ? std::numeric_limits<double>::infinity() : val;
+         val = 1 == iSample % 17 ? -std::numeric_limits<double>::infinity() : val;
+         vals[iSample] = val;
+      }
+
+      std::vector<double> scores(cSamples);
+      const ErrorEbm error = PredictScores(
+         static_cast<IntEbm>(cSamples),
+         1,
+         EBM_FALSE,
+         &vals[0],
+         1,
+         binningFeatureIndexes,
+         binningIsCategorical,
+         binningCountBins,
+         binningCountValues,
+         &cuts[0],
+         nullptr,
+         1,
+         termDimensionCounts,
+         termBinningIndexes,
+         1,
+         &termScores[0],
+         nullptr,
+         Link_identity,
+         &scores[0]
+      );
+      CHECK(Error_None == error);
+
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const double val = vals[iSample];
+         const size_t iBin = std::isnan(val) ? size_t { 0 } :
+            size_t { 1 } + static_cast<size_t>(std::upper_bound(cuts.begin(), cuts.end(), val) - cuts.begin());
+         CHECK(static_cast<double>(iBin) == scores[iSample]);
+      }
+   }
+}
+
+TEST_CASE("PredictScores, illegal inputs") {
+   const std::vector<double> termScores = MakeTermScores();
+   const double featureMatrix[] { 1.0, 10.0 };
+   double scores[1];
+   ErrorEbm error;
+
+   // a continuous binning with 2 cuts needs 4 or more bins
+   const IntEbm binningCountBinsTooFew[] { 3, 4 };
+   error = PredictScores(1, k_countFeatures, EBM_FALSE, featureMatrix, 2, k_binningFeatureIndexes,
+      k_binningIsCategorical, binningCountBinsTooFew, k_binningCountValues, k_binningValues, k_binningCategoryBins,
+      3, k_termDimensionCounts, k_termBinningIndexes, 1, &termScores[0], nullptr, Link_identity, scores);
+   CHECK(Error_IllegalParamVal == error);
+
+   // the binning refers to a feature that is not in the matrix
+   const IntEbm binningFeatureIndexesBad[] { 0, 2 };
+   error = PredictScores(1, k_countFeatures, EBM_FALSE, featureMatrix, 2, binningFeatureIndexesBad,
+      k_binningIsCategorical, k_binningCountBins, k_binningCountValues, k_binningValues, k_binningCategoryBins,
+      3, k_termDimensionCounts, k_termBinningIndexes, 1, &termScores[0], nullptr, Link_identity, scores);
+   CHECK(Error_IllegalParamVal == error);
+
+   // the term refers to a binning that does not exist
+   const IntEbm termBinningIndexesBad[] { 0, 1, 0, 2 };
+   error = PredictScores(1, k_countFeatures, EBM_FALSE, featureMatrix, 2, k_binningFeatureIndexes,
+      k_binningIsCategorical, k_binningCountBins, k_binningCountValues, k_binningValues, k_binningCategoryBins,
+      3, k_termDimensionCounts, termBinningIndexesBad, 1, &termScores[0], nullptr, Link_identity, scores);
+   CHECK(Error_IllegalParamVal == error);
+
+   // categorical values must be sorted
+   const double binningValuesUnsorted[] { 1.5, 3.5, 20, 10, 30 };
+   error = PredictScores(1, k_countFeatures, EBM_FALSE, featureMatrix, 2, k_binningFeatureIndexes,
+      k_binningIsCategorical, k_binningCountBins, k_binningCountValues, binningValuesUnsorted, k_binningCategoryBins,
+      3, k_termDimensionCounts, k_termBinningIndexes, 1, &termScores[0], nullptr, Link_identity, scores);
+   CHECK(Error_IllegalParamVal == error);
+
+   // without an intercept the scores start from zero
+   error = PredictScores(1, k_countFeatures, EBM_FALSE, featureMatrix, 2, k_binningFeatureIndexes,
+      k_binningIsCategorical, k_binningCountBins, k_binningCountValues, k_binningValues, k_binningCategoryBins,
+      3, k_termDimensionCounts, k_termBinningIndexes, 1, &termScores[0], nullptr, Link_identity, scores);
+   CHECK(Error_None == error);
+   CHECK_APPROX(scores[0], ExpectedScore(1.0, 10.0, &termScores[0]) - 0.25);
+}
+
+TEST_CASE("ScoringModel, matches PredictScores when scored from several threads at once") {
+   const std::vector<double> termScores = MakeTermScores();
+   const double intercept[] { 0.25 };
+
+   static constexpr size_t cSamples = 5003;
+   std::vector<double> featureMatrix(cSamples * 2);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      featureMatrix[iSample * 2 + 0] = static_cast<double>(iSample % 11) * 0.5;
+      featureMatrix[iSample * 2 + 1] = static_cast<double>(iSample % 5) * 10.0;
+   }
+
+   std::vector<double> expected(cSamples);
+   ErrorEbm error = PredictScores(static_cast<IntEbm>(cSamples), k_countFeatures, EBM_FALSE, &featureMatrix[0], 2,
+      k_binningFeatureIndexes, k_binningIsCategorical, k_binningCountBins, k_binningCountValues, k_binningValues,
+      k_binningCategoryBins, 3, k_termDimensionCounts, k_termBinningIndexes, 1, &termScores[0], intercept,
+      Link_logit, &expected[0]);
+   CHECK(Error_None == error);
+
+   // the pair is listed before the mains, which only changes the order in which the model sums the scores
+   const IntEbm termDimensionCounts[] { 2, 1, 1 };
+   const IntEbm termBinningIndexes[] { 0, 1, 1, 0 };
+   std::vector<double> termScoresReordered;
+   termScoresReordered.insert(termScoresReordered.end(), termScores.begin() + 9, termScores.end());
+   termScoresReordered.insert(termScoresReordered.end(), termScores.begin() + 5, termScores.begin() + 9);
+   termScoresReordered.insert(termScoresReordered.end(), termScores.begin(), termScores.begin() + 5);
+
+   ScoringModelHandle scoringModelHandle = nullptr;
+   error = CreateScoringModel(2, k_binningFeatureIndexes, k_binningIsCategorical, k_binningCountBins,
+      k_binningCountValues, k_binningValues, k_binningCategoryBins, 3, termDimensionCounts, termBinningIndexes, 1,
+      &termScoresReordered[0], intercept, &scoringModelHandle);
+   CHECK(Error_None == error);
+   CHECK(nullptr != scoringModelHandle);
+
+   // the model owns a copy, so the caller's buffers can be released right after creating it
+   termScoresReordered.clear();
+
+   static constexpr size_t cThreads = 4;
+   std::vector<std::vector<double>> threadScores(cThreads, std::vector<double>(cSamples));
+   ErrorEbm threadErrors[cThreads];
+   std::vector<std::thread> threads;
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      threads.emplace_back([&, iThread]() {
+         threadErrors[iThread] = PredictScoresWithModel(scoringModelHandle, static_cast<IntEbm>(cSamples),
+            k_countFeatures, EBM_FALSE, &featureMatrix[0], Link_logit, &threadScores[iThread][0]);
+      });
+   }
+   for(std::thread & thread : threads) {
+      thread.join();
+   }
+
+   for(size_t iThread = 0; iThread < cThreads; ++iThread) {
+      CHECK(Error_None == threadErrors[iThread]);
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         CHECK_APPROX(threadScores[iThread][iSample], expected[iSample]);
+      }
+   }
+
+   FreeScoringModel(scoringModelHandle);
+}
+
+TEST_CASE("ScoringModel, illegal inputs") {
+   const std::vector<double> termScores = MakeTermScores();
+   const double featureMatrix[] { 1.0, 10.0 };
+   double scores[1];
+   ErrorEbm error;
+
+   ScoringModelHandle scoringModelHandle = reinterpret_cast<ScoringModelHandle>(1);
+   error = CreateScoringModel(2, k_binningFeatureIndexes, k_binningIsCategorical, k_binningCountBins,
+      k_binningCountValues, k_binningValues, k_binningCategoryBins, 3, k_termDimensionCounts, k_termBinningIndexes,
+      -1, &termScores[0], nullptr, &scoringModelHandle);
+   CHECK(Error_IllegalParamVal == error);
+   CHECK(nullptr == scoringModelHandle);
+
+   error = CreateScoringModel(2, k_binningFeatureIndexes, k_binningIsCategorical, k_binningCountBins,
+      k_binningCountValues, k_binningValues, k_binningCategoryBins, 3, k_termDimensionCounts, k_termBinningIndexes,
+      1, &termScores[0], nullptr, &scoringModelHandle);
+   CHECK(Error_None == error);
+
+   // the matrix needs to hold every feature that the model bins
+   error = PredictScoresWithModel(scoringModelHandle, 1, 1, EBM_FALSE, featureMatrix, Link_identity, scores);
+   CHECK(Error_IllegalParamVal == error);
+
+   // mlogit needs 2 or more scores
+   error = PredictScoresWithModel(scoringModelHandle, 1, k_countFeatures, EBM_FALSE, featureMatrix, Link_mlogit,
+      scores);
+   CHECK(Error_IllegalParamVal == error);
+
+   error = PredictScoresWithModel(scoringModelHandle, 1, k_countFeatures, EBM_FALSE, featureMatrix, Link_identity,
+      scores);
+   CHECK(Error_None == error);
+   CHECK_APPROX(scores[0], ExpectedScore(1.0, 10.0, &termScores[0]) - 0.25);
+
+   FreeScoringModel(scoringModelHandle);
+
+   error = PredictScoresWithModel(nullptr, 1, k_countFeatures, EBM_FALSE, featureMatrix, Link_identity, scores);
+   CHECK(Error_IllegalParamVal == error);
+}
+
+TEST_CASE("ScoringModel, sums the terms in the caller's order") {
+   // the sum only comes out as 1.0 if the terms are added in the order given, which is what the python predictor does
+   static constexpr IntEbm countFeatures = 2;
+   const double featureMatrix[] { 0.0, 0.0 };
+   const IntEbm binningFeatureIndexes[] { 1, 0 };
+   const BoolEbm binningIsCategorical[] { EBM_FALSE, EBM_FALSE };
+   const IntEbm binningCountBins[] { 2, 2 };
+   const IntEbm binningCountValues[] { 0, 0 };
+   const IntEbm termDimensionCounts[] { 1, 1, 1 };
+   const IntEbm termBinningIndexes[] { 0, 0, 1 };
+   const double termScores[] { 0.0, 1e16, 0.0, -1e16, 0.0, 1.0 };
+
+   double score = 0.0;
+   ErrorEbm error = PredictScores(1, countFeatures, EBM_FALSE, featureMatrix, 2, binningFeatureIndexes,
+      binningIsCategorical, binningCountBins, binningCountValues, nullptr, nullptr, 3, termDimensionCounts,
+      termBinningIndexes, 1, termScores, nullptr, Link_identity, &score);
+   CHECK(Error_None == error);
+   CHECK(1.0 == score);
+
+   ScoringModelHandle scoringModelHandle = nullptr;
+   error = CreateScoringModel(2, binningFeatureIndexes, binningIsCategorical, binningCountBins, binningCountValues,
+      nullptr, nullptr, 3, termDimensionCounts, termBinningIndexes, 1, termScores, nullptr, &scoringModelHandle);
+   CHECK(Error_None == error);
+
+   score = 0.0;
+   error = PredictScoresWithModel(scoringModelHandle, 1, countFeatures, EBM_FALSE, featureMatrix, Link_identity,
+      &score);
+   CHECK(Error_None == error);
+   CHECK(1.0 == score);
+
+   FreeScoringModel(scoringModelHandle);
+}
+
+TEST_CASE("ScoringModel, keeps its threads across calls") {
+   const std::vector<double> termScores = MakeTermScores();
+   const double intercept[] { 0.25 };
+
+   static constexpr size_t cSamples = 20011;
+   std::vector<double> featureMatrix(cSamples * 2);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      featureMatrix[iSample * 2 + 0] = static_cast<double>(iSample % 7) * 0.75;
+      featureMatrix[iSample * 2 + 1] = static_cast<double>(iSample % 4) * 10.0;
+   }
+
+   std::vector<double> expected(cSamples);
+   ErrorEbm error = PredictScores(static_cast<IntEbm>(cSamples), k_countFeatures, EBM_FALSE, &featureMatrix[0], 2,
+      k_binningFeatureIndexes, k_binningIsCategorical, k_binningCountBins, k_binningCountValues, k_binningValues,
+      k_binningCategoryBins, 3, k_termDimensionCounts, k_termBinningIndexes, 1, &termScores[0], intercept,
+      Link_identity, &expected[0]);
+   CHECK(Error_None == error);
+
+   // the model takes the thread count at creation, so changing it afterwards leaves the model's pool alone
+   SetThreadCount(4);
+   ScoringModelHandle scoringModelHandle = nullptr;
+   error = CreateScoringModel(2, k_binningFeatureIndexes, k_binningIsCategorical, k_binningCountBins,
+      k_binningCountValues, k_binningValues, k_binningCategoryBins, 3, k_termDimensionCounts, k_termBinningIndexes, 1,
+      &termScores[0], intercept, &scoringModelHandle);
+   SetThreadCount(1);
+   CHECK(Error_None == error);
+
+   // small batches after a large one reuse the same scratch space
+   for(size_t cSamplesCall : { cSamples, size_t { 1 }, size_t { 100 }, cSamples }) {
+      std::vector<double> scores(cSamplesCall);
+      error = PredictScoresWithModel(scoringModelHandle, static_cast<IntEbm>(cSamplesCall), k_countFeatures,
+         EBM_FALSE, &featureMatrix[0], Link_identity, &scores[0]);
+      CHECK(Error_None == error);
+      for(size_t iSample = 0; iSample < cSamplesCall; ++iSample) {
+         CHECK(expected[iSample] == scores[iSample]);
+      }
+   }
+
+   FreeScoringModel(scoringModelHandle);
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+// Benchmarks binning several inner bags in a single pass over the data against the per-bag loop.
+//
+// This is not part of the test suite.  Build the release library first with build.sh, then from the repo root:
+//   g++ -O2 -std=c++11 -Ishared/libebm/inc shared/libebm/tests/benchmarks/bin_sums_bags.cpp
+//      -Lbld/lib -lebm_linux_x64 -Wl,-rpath,bld/lib -o bin_sums_bags
+//   ./bin_sums_bags [countSamples] [countBins]
+//
+// The per-bag loop is what libebm does for a booster with a single inner bag, so we time K boosting steps of a
+// booster with 1 inner bag as the baseline for a single boosting step of a booster with K inner bags.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+#include <chrono>
+
+#include "libebm.h"
+
+static void CheckError(const ErrorEbm error, const char * const sFunction) {
+   if(Error_None != error) {
+      fprintf(stderr, "%s failed with error %d\n", sFunction, static_cast<int>(error));
+      exit(1);
+   }
+}
+
+static void EBM_CALLING_CONVENTION LogCallback(const TraceEbm traceLevel, const char * const message) {
+   fprintf(stderr, "%s: %s\n", GetTraceLevelString(traceLevel), message);
+}
+
+static std::vector<unsigned char> MakeDataSet(const IntEbm cSamples, const IntEbm cBins) {
+   std::vector<IntEbm> binIndexes(static_cast<size_t>(cSamples));
+   std::vector<double> targets(static_cast<size_t>(cSamples));
+   uint64_t state = 0x853c49e6748fea9bULL;
+   for(IntEbm iSample = 0; iSample < cSamples; ++iSample) {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      const IntEbm iBin = static_cast<IntEbm>((state >> 33) % static_cast<uint64_t>(cBins));
+      binIndexes[static_cast<size_t>(iSample)] = iBin;
+      targets[static_cast<size_t>(iSample)] = static_cast<double>(iBin) * 0.5 + static_cast<double>((state >> 20) & 0xff) / 256.0;
+   }
+
+   const IntEbm cBytes = MeasureDataSetHeader(1, 0, 1) +
+      MeasureFeature(cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes[0]) +
+      MeasureRegressionTarget(cSamples, &targets[0]);
+   std::vector<unsigned char> dataSet(static_cast<size_t>(cBytes));
+   CheckError(FillDataSetHeader(1, 0, 1, cBytes, &dataSet[0]), "FillDataSetHeader");
+   CheckError(FillFeature(cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes[0], cBytes, &dataSet[0]), "FillFeature");
+   CheckError(FillRegressionTarget(cSamples, &targets[0], cBytes, &dataSet[0]), "FillRegressionTarget");
+   return dataSet;
+}
+
+static double TimeBoostingSteps(const std::vector<unsigned char> & dataSet, const IntEbm cInnerBags, const int cSteps) {
+   std::vector<unsigned char> rng(static_cast<size_t>(MeasureRNG()));
+   InitRNG(42, &rng[0]);
+
+   const IntEbm dimensionCounts[] = { 1 };
+   const IntEbm featureIndexes[] = { 0 };
+   BoosterHandle boosterHandle = nullptr;
+   CheckError(CreateBooster(&rng[0], &dataSet[0], nullptr, nullptr, 1, dimensionCounts, featureIndexes,
+      cInnerBags, CreateBoosterFlags_Default, AccelerationFlags_ALL, "rmse", nullptr, &boosterHandle), "CreateBooster");
+
+   const IntEbm leavesMax[] = { 3 };
+   double gain;
+   // warm up the caches and page in the memory before timing
+   CheckError(GenerateTermUpdate(&rng[0], boosterHandle, 0, TermBoostFlags_Default, 0.01, 2, leavesMax, &gain), "GenerateTermUpdate");
+
+   const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   for(int iStep = 0; iStep < cSteps; ++iStep) {
+      CheckError(GenerateTermUpdate(&rng[0], boosterHandle, 0, TermBoostFlags_Default, 0.01, 2, leavesMax, &gain), "GenerateTermUpdate");
+   }
+   const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+   FreeBooster(boosterHandle);
+   return std::chrono::duration<double>(end - start).count() / static_cast<double>(cSteps);
+}
+
+int main(int argc, char ** argv) {
+   const IntEbm cSamples = 2 <= argc ? static_cast<IntEbm>(atoll(argv[1])) : IntEbm { 1000000 };
+   const IntEbm cBins = 3 <= argc ? static_cast<IntEbm>(atoll(argv[2])) : IntEbm { 64 };
+   static constexpr int k_cSteps = 10;
+
+   SetLogCallback(&LogCallback);
+   SetTraceLevel(Trace_Warning);
+   SetThreadCount(1);
+   const std::vector<unsigned char> dataSet = MakeDataSet(cSamples, cBins);
+
+   const double secondsPerBag = TimeBoostingSteps(dataSet, 1, k_cSteps * 8);
+   printf("samples=%lld bins=%lld per-bag loop: %.3f ms per bag\n",
+      static_cast<long long>(cSamples), static_cast<long long>(cBins), secondsPerBag * 1000.0);
+
+   const IntEbm aInnerBags[] = { 2, 4, 8, 16, 32 };
+   for(const IntEbm cInnerBags : aInnerBags) {
+      const double secondsPass = TimeBoostingSteps(dataSet, cInnerBags, k_cSteps);
+      const double secondsLoop = secondsPerBag * static_cast<double>(cInnerBags);
+      printf("inner bags=%2lld  single pass: %8.3f ms  per-bag loop: %8.3f ms  speedup: %.2fx\n",
+         static_cast<long long>(cInnerBags), secondsPass * 1000.0, secondsLoop * 1000.0, secondsLoop / secondsPass);
+   }
+
+   return 0;
+}
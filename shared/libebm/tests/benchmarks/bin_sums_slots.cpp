@@ -0,0 +1,105 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+// Benchmarks single threaded boosting steps on training sets that are large enough to be binned in several slots.
+//
+// This is not part of the test suite.  Build the release library first with build.sh, then from the repo root:
+//   g++ -O2 -std=c++11 -Ishared/libebm/inc shared/libebm/tests/benchmarks/bin_sums_slots.cpp
+//      -Lbld/lib -lebm_linux_x64 -Wl,-rpath,bld/lib -o bin_sums_slots
+//   ./bin_sums_slots [countBins]
+//
+// Training sets with 32768 or more samples are binned in up to k_cBinSumsSlotsMax slots even with one thread, so
+// that the model does not depend on the thread count.  Each extra slot costs a pass over the tensor bins per
+// boosting step.  To compare against a single slot, rebuild the library with k_cBinSumsSlotsMax set to 1.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+#include <chrono>
+
+#include "libebm.h"
+
+static void CheckError(const ErrorEbm error, const char * const sFunction) {
+   if(Error_None != error) {
+      fprintf(stderr, "%s failed with error %d\n", sFunction, static_cast<int>(error));
+      exit(1);
+   }
+}
+
+static void EBM_CALLING_CONVENTION LogCallback(const TraceEbm traceLevel, const char * const message) {
+   fprintf(stderr, "%s: %s\n", GetTraceLevelString(traceLevel), message);
+}
+
+static std::vector<unsigned char> MakeDataSet(const IntEbm cSamples, const IntEbm cBins) {
+   std::vector<IntEbm> binIndexes0(static_cast<size_t>(cSamples));
+   std::vector<IntEbm> binIndexes1(static_cast<size_t>(cSamples));
+   std::vector<double> targets(static_cast<size_t>(cSamples));
+   uint64_t state = 0x853c49e6748fea9bULL;
+   for(IntEbm iSample = 0; iSample < cSamples; ++iSample) {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      const IntEbm iBin0 = static_cast<IntEbm>((state >> 33) % static_cast<uint64_t>(cBins));
+      const IntEbm iBin1 = static_cast<IntEbm>((state >> 13) % static_cast<uint64_t>(cBins));
+      binIndexes0[static_cast<size_t>(iSample)] = iBin0;
+      binIndexes1[static_cast<size_t>(iSample)] = iBin1;
+      targets[static_cast<size_t>(iSample)] = static_cast<double>(iBin0) * 0.5 - static_cast<double>(iBin1) * 0.25 +
+         static_cast<double>((state >> 5) & 0xff) / 256.0;
+   }
+
+   const IntEbm cBytes = MeasureDataSetHeader(2, 0, 1) +
+      MeasureFeature(cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes0[0]) +
+      MeasureFeature(cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes1[0]) +
+      MeasureRegressionTarget(cSamples, &targets[0]);
+   std::vector<unsigned char> dataSet(static_cast<size_t>(cBytes));
+   CheckError(FillDataSetHeader(2, 0, 1, cBytes, &dataSet[0]), "FillDataSetHeader");
+   CheckError(FillFeature(cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes0[0], cBytes, &dataSet[0]), "FillFeature");
+   CheckError(FillFeature(cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &binIndexes1[0], cBytes, &dataSet[0]), "FillFeature");
+   CheckError(FillRegressionTarget(cSamples, &targets[0], cBytes, &dataSet[0]), "FillRegressionTarget");
+   return dataSet;
+}
+
+static double TimeBoostingSteps(const std::vector<unsigned char> & dataSet, const IntEbm iTerm, const int cSteps) {
+   std::vector<unsigned char> rng(static_cast<size_t>(MeasureRNG()));
+   InitRNG(42, &rng[0]);
+
+   const IntEbm dimensionCounts[] = { 1, 1, 2 };
+   const IntEbm featureIndexes[] = { 0, 1, 0, 1 };
+   BoosterHandle boosterHandle = nullptr;
+   CheckError(CreateBooster(&rng[0], &dataSet[0], nullptr, nullptr, 3, dimensionCounts, featureIndexes,
+      0, CreateBoosterFlags_Default, AccelerationFlags_ALL, "rmse", nullptr, &boosterHandle), "CreateBooster");
+
+   const IntEbm leavesMax[] = { 3, 3 };
+   double gain;
+   // warm up the caches and page in the memory before timing
+   CheckError(GenerateTermUpdate(&rng[0], boosterHandle, iTerm, TermBoostFlags_Default, 0.01, 2, leavesMax, &gain), "GenerateTermUpdate");
+
+   const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   for(int iStep = 0; iStep < cSteps; ++iStep) {
+      CheckError(GenerateTermUpdate(&rng[0], boosterHandle, iTerm, TermBoostFlags_Default, 0.01, 2, leavesMax, &gain), "GenerateTermUpdate");
+   }
+   const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+   FreeBooster(boosterHandle);
+   return std::chrono::duration<double>(end - start).count() / static_cast<double>(cSteps);
+}
+
+int main(int argc, char ** argv) {
+   const IntEbm cBins = 2 <= argc ? static_cast<IntEbm>(atoll(argv[1])) : IntEbm { 256 };
+   static constexpr int k_cSteps = 50;
+
+   SetLogCallback(&LogCallback);
+   SetTraceLevel(Trace_Warning);
+   SetThreadCount(1);
+
+   const IntEbm aSamples[] = { 30000, 40000, 100000, 300000, 1000000 };
+   for(const IntEbm cSamples : aSamples) {
+      const std::vector<unsigned char> dataSet = MakeDataSet(cSamples, cBins);
+      const double seconds1 = TimeBoostingSteps(dataSet, 0, k_cSteps);
+      const double seconds2 = TimeBoostingSteps(dataSet, 2, k_cSteps);
+      printf("samples=%8lld bins=%lld  1 dimension: %8.3f ms  2 dimensions: %8.3f ms\n",
+         static_cast<long long>(cSamples), static_cast<long long>(cBins), seconds1 * 1000.0, seconds2 * 1000.0);
+   }
+
+   return 0;
+}
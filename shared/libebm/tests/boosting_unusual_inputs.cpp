@@ -1913,3 +1913,923 @@ TEST_CASE("tweedie, boosting") {
    termScore = test.GetCurrentTermScore(0, {0}, 0);
    CHECK_APPROX(termScore, 2.3025076860047466);
 }
+
+TEST_CASE("multithreaded bin sums are identical to single threaded, boosting, binary") {
+   static constexpr size_t k_cSamples = 70000;
+
+   std::vector<TestSample> samples;
+   samples.reserve(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      const IntEbm iBin0 = static_cast<IntEbm>(iSample % 7);
+      const IntEbm iBin1 = static_cast<IntEbm>(iSample / 7 % 5);
+      const double target = 0 == (iSample * 2654435761U >> 7) % 3 || 2 <= iBin0 + iBin1 ? 1 : 0;
+      samples.push_back(TestSample({ iBin0, iBin1 }, target));
+   }
+
+   // the training subsets and the order in which their histograms are summed depend only on the number of samples,
+   // so every thread count must give identical models, including for the float32 zones.  With inner bags, 2
+   // threads boost whole bags in parallel while 3 and 4 threads bin the subsets of each bag in parallel
+   for(const IntEbm cInnerBags : { k_countInnerBagsDefault, IntEbm { 3 } }) {
+      for(const CreateBoosterFlags flags : { k_testCreateBoosterFlags_Default, 
+         static_cast<CreateBoosterFlags>(k_testCreateBoosterFlags_Default | CreateBoosterFlags_Float32) }) {
+         const AccelerationFlags acceleration = 
+            0 != (CreateBoosterFlags_Float32 & flags) ? AccelerationFlags_ALL : AccelerationFlags_NONE;
+
+         SetThreadCount(1);
+         TestBoost test1 = TestBoost(
+            Task_BinaryClassification, 
+            { FeatureTest(7), FeatureTest(5) }, 
+            { { 0 }, { 1 }, { 0, 1 } }, 
+            samples, 
+            {},
+            cInnerBags,
+            flags,
+            acceleration
+         );
+
+         SetThreadCount(2);
+         TestBoost test2 = TestBoost(
+            Task_BinaryClassification,
+            { FeatureTest(7), FeatureTest(5) },
+            { { 0 }, { 1 }, { 0, 1 } },
+            samples,
+            {},
+            cInnerBags,
+            flags,
+            acceleration
+         );
+
+         SetThreadCount(3);
+         TestBoost test3 = TestBoost(
+            Task_BinaryClassification,
+            { FeatureTest(7), FeatureTest(5) },
+            { { 0 }, { 1 }, { 0, 1 } },
+            samples,
+            {},
+            cInnerBags,
+            flags,
+            acceleration
+         );
+
+         SetThreadCount(4);
+         TestBoost test4 = TestBoost(
+            Task_BinaryClassification,
+            { FeatureTest(7), FeatureTest(5) },
+            { { 0 }, { 1 }, { 0, 1 } },
+            samples,
+            {},
+            cInnerBags,
+            flags,
+            acceleration
+         );
+         SetThreadCount(1);
+
+         for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+            for(size_t iTerm = 0; iTerm < test1.GetCountTerms(); ++iTerm) {
+               const double gainAvg1 = test1.Boost(iTerm).gainAvg;
+               for(TestBoost * const pTest : { &test2, &test3, &test4 }) {
+                  CHECK(pTest->Boost(iTerm).gainAvg == gainAvg1);
+               }
+            }
+         }
+
+         for(TestBoost * const pTest : { &test2, &test3, &test4 }) {
+            for(size_t iBin0 = 0; iBin0 < 7; ++iBin0) {
+               CHECK(pTest->GetCurrentTermScore(0, { iBin0 }, 0) == test1.GetCurrentTermScore(0, { iBin0 }, 0));
+               for(size_t iBin1 = 0; iBin1 < 5; ++iBin1) {
+                  CHECK(pTest->GetCurrentTermScore(2, { iBin0, iBin1 }, 0) == 
+                     test1.GetCurrentTermScore(2, { iBin0, iBin1 }, 0));
+               }
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("multithreaded inner bags match single threaded, boosting, regression") {
+   std::vector<TestSample> samples;
+   for(size_t iSample = 0; iSample < 200; ++iSample) {
+      const IntEbm iBin0 = static_cast<IntEbm>(iSample % 6);
+      const IntEbm iBin1 = static_cast<IntEbm>(iSample / 6 % 4);
+      const double target = static_cast<double>(iBin0 * 3 - iBin1) + static_cast<double>(iSample % 11) * 0.25;
+      samples.push_back(TestSample({ iBin0, iBin1 }, target));
+   }
+
+   SetThreadCount(1);
+   TestBoost test1 = TestBoost(
+      Task_Regression,
+      { FeatureTest(6), FeatureTest(4) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      samples,
+      {},
+      5
+   );
+
+   SetThreadCount(4);
+   TestBoost test4 = TestBoost(
+      Task_Regression,
+      { FeatureTest(6), FeatureTest(4) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      samples,
+      {},
+      5
+   );
+   SetThreadCount(1);
+
+   for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+      for(size_t iTerm = 0; iTerm < test1.GetCountTerms(); ++iTerm) {
+         const double gainAvg1 = test1.Boost(iTerm).gainAvg;
+         const double gainAvg4 = test4.Boost(iTerm).gainAvg;
+         CHECK_APPROX(gainAvg4, gainAvg1);
+      }
+   }
+
+   for(size_t iBin0 = 0; iBin0 < 6; ++iBin0) {
+      CHECK_APPROX(test4.GetCurrentTermScore(0, { iBin0 }, 0), test1.GetCurrentTermScore(0, { iBin0 }, 0));
+      for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+         CHECK_APPROX(
+            test4.GetCurrentTermScore(2, { iBin0, iBin1 }, 0),
+            test1.GetCurrentTermScore(2, { iBin0, iBin1 }, 0)
+         );
+      }
+   }
+}
+
+TEST_CASE("multithreaded inner bags match single threaded, random splits, boosting, regression") {
+   std::vector<TestSample> samples;
+   for(size_t iSample = 0; iSample < 300; ++iSample) {
+      const IntEbm iBin0 = static_cast<IntEbm>(iSample % 9);
+      const IntEbm iBin1 = static_cast<IntEbm>(iSample / 9 % 5);
+      const double target = static_cast<double>(iBin0 - iBin1 * 2) + static_cast<double>(iSample % 13) * 0.125;
+      samples.push_back(TestSample({ iBin0, iBin1 }, target));
+   }
+
+   // random splits, with and without the gradient sums that differential privacy uses, draw from the rng of each
+   // inner bag, which is seeded the same way whether the bags are boosted serially or in parallel, so the updates
+   // must be identical for any thread count.  The test harness zeros the updates of gradient sums, so we compare
+   // the updates directly before applying them
+   for(const TermBoostFlags flags : { TermBoostFlags_RandomSplits,
+      static_cast<TermBoostFlags>(TermBoostFlags_RandomSplits | TermBoostFlags_GradientSums) }) {
+
+      SetThreadCount(1);
+      TestBoost test1 = TestBoost(
+         Task_Regression,
+         { FeatureTest(9), FeatureTest(5) },
+         { { 0 }, { 1 }, { 0, 1 } },
+         samples,
+         {},
+         5
+      );
+
+      SetThreadCount(2);
+      TestBoost test2 = TestBoost(
+         Task_Regression,
+         { FeatureTest(9), FeatureTest(5) },
+         { { 0 }, { 1 }, { 0, 1 } },
+         samples,
+         {},
+         5
+      );
+
+      SetThreadCount(4);
+      TestBoost test4 = TestBoost(
+         Task_Regression,
+         { FeatureTest(9), FeatureTest(5) },
+         { { 0 }, { 1 }, { 0, 1 } },
+         samples,
+         {},
+         5
+      );
+      SetThreadCount(1);
+
+      const IntEbm leavesMax[] = { 3, 3 };
+      for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+         for(size_t iTerm = 0; iTerm < test1.GetCountTerms(); ++iTerm) {
+            const size_t cUpdates = 0 == iTerm ? size_t { 9 } : 1 == iTerm ? size_t { 5 } : size_t { 9 * 5 };
+
+            double gainAvg1;
+            ErrorEbm error = GenerateTermUpdate(test1.GetRng(), test1.GetBoosterHandle(), 
+               static_cast<IntEbm>(iTerm), flags, k_learningRateDefault, k_minSamplesLeafDefault, leavesMax, &gainAvg1);
+            CHECK(Error_None == error);
+            double update1[9 * 5];
+            error = GetTermUpdate(test1.GetBoosterHandle(), update1);
+            CHECK(Error_None == error);
+            error = ApplyTermUpdate(test1.GetBoosterHandle(), nullptr);
+            CHECK(Error_None == error);
+
+            for(TestBoost * const pTest : { &test2, &test4 }) {
+               double gainAvg;
+               error = GenerateTermUpdate(pTest->GetRng(), pTest->GetBoosterHandle(), 
+                  static_cast<IntEbm>(iTerm), flags, k_learningRateDefault, k_minSamplesLeafDefault, leavesMax, &gainAvg);
+               CHECK(Error_None == error);
+               CHECK(gainAvg == gainAvg1);
+
+               double update[9 * 5];
+               error = GetTermUpdate(pTest->GetBoosterHandle(), update);
+               CHECK(Error_None == error);
+               for(size_t iUpdate = 0; iUpdate < cUpdates; ++iUpdate) {
+                  CHECK(update[iUpdate] == update1[iUpdate]);
+               }
+
+               error = ApplyTermUpdate(pTest->GetBoosterHandle(), nullptr);
+               CHECK(Error_None == error);
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("multithreaded inner bags match single threaded, weighted, boosting") {
+   // with one thread the inner bags are binned together in passes of up to 8 bags, and with several threads each
+   // bag is binned on its own, so this compares the multi bag histograms against the single bag ones.  11 bags
+   // need a full and a partial pass, the 40 bin feature and the pair have enough bins to use the conflict rounds of
+   // the SIMD zones and the 7 bin feature uses private histograms.  Inner bags are always replicated and weighted
+   std::vector<TestSample> samples;
+   for(size_t iSample = 0; iSample < 1000; ++iSample) {
+      const IntEbm iBin0 = static_cast<IntEbm>(iSample * 7 % 40);
+      const IntEbm iBin1 = static_cast<IntEbm>(iSample / 3 % 7);
+      const double weight = 0.5 + static_cast<double>(iSample % 7) * 0.25;
+      samples.push_back(TestSample({ iBin0, iBin1 }, static_cast<double>((iBin0 + iBin1 + iSample % 3) % 2), weight));
+   }
+
+   for(const TaskEbm task : { Task_Regression, Task_BinaryClassification }) {
+      SetThreadCount(1);
+      TestBoost test1 = TestBoost(
+         task,
+         { FeatureTest(40), FeatureTest(7) },
+         { { 0 }, { 1 }, { 0, 1 } },
+         samples,
+         {},
+         11
+      );
+
+      SetThreadCount(4);
+      TestBoost test4 = TestBoost(
+         task,
+         { FeatureTest(40), FeatureTest(7) },
+         { { 0 }, { 1 }, { 0, 1 } },
+         samples,
+         {},
+         11
+      );
+      SetThreadCount(1);
+
+      for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+         for(size_t iTerm = 0; iTerm < test1.GetCountTerms(); ++iTerm) {
+            const double gainAvg1 = test1.Boost(iTerm).gainAvg;
+            const double gainAvg4 = test4.Boost(iTerm).gainAvg;
+            CHECK(gainAvg4 == gainAvg1);
+         }
+      }
+
+      for(size_t iBin0 = 0; iBin0 < 40; ++iBin0) {
+         CHECK(test4.GetCurrentTermScore(0, { iBin0 }, 0) == test1.GetCurrentTermScore(0, { iBin0 }, 0));
+         for(size_t iBin1 = 0; iBin1 < 7; ++iBin1) {
+            CHECK(test4.GetCurrentTermScore(2, { iBin0, iBin1 }, 0) == test1.GetCurrentTermScore(2, { iBin0, iBin1 }, 0));
+         }
+      }
+      for(size_t iBin1 = 0; iBin1 < 7; ++iBin1) {
+         CHECK(test4.GetCurrentTermScore(1, { iBin1 }, 0) == test1.GetCurrentTermScore(1, { iBin1 }, 0));
+      }
+   }
+}
+
+static BoolEbm EBM_CALLING_CONVENTION StopAfterTwoRounds(void * callbackContext, IntEbm indexRound, double bestMetric) {
+   UNUSED(bestMetric);
+   *static_cast<IntEbm *>(callbackContext) = indexRound;
+   return IntEbm { 1 } <= indexRound ? EBM_TRUE : EBM_FALSE;
+}
+
+TEST_CASE("BoostRounds matches calling GenerateTermUpdate per term, boosting, regression") {
+   std::vector<TestSample> samples;
+   std::vector<TestSample> validation;
+   for(size_t iSample = 0; iSample < 120; ++iSample) {
+      const IntEbm iBin0 = static_cast<IntEbm>(iSample % 5);
+      const IntEbm iBin1 = static_cast<IntEbm>(iSample / 5 % 3);
+      const double target = static_cast<double>(iBin0 * 2 - iBin1) + static_cast<double>(iSample % 7) * 0.5;
+      (0 == iSample % 4 ? validation : samples).push_back(TestSample({ iBin0, iBin1 }, target));
+   }
+
+   static constexpr double k_greediness = 0.5;
+   static constexpr IntEbm k_smoothingRounds = 2;
+   static constexpr IntEbm k_maxRounds = 30;
+   static constexpr IntEbm k_earlyStoppingRounds = 3;
+   static constexpr double k_earlyStoppingTolerance = 0.0;
+   static constexpr IntEbm k_leavesMax = 3;
+
+   TestBoost testManual = TestBoost(
+      Task_Regression,
+      { FeatureTest(5), FeatureTest(3) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      samples,
+      validation
+   );
+
+   // replicate the python boosting loop using single boosting steps
+   std::vector<std::pair<double, size_t>> heap;
+   double greedyPortion = 0.0;
+   double metricMin = std::numeric_limits<double>::infinity();
+   double metricBreakpoint = std::numeric_limits<double>::infinity();
+   IntEbm cNoChangeRun = 0;
+   IntEbm cSmoothingRounds = k_smoothingRounds;
+   IntEbm cRoundsManual = 0;
+   while(cRoundsManual < k_maxRounds) {
+      if(greedyPortion < 1.0) {
+         heap.clear();
+      }
+      TermBoostFlags flags = TermBoostFlags_Default;
+      if(IntEbm { 0 } < cSmoothingRounds) {
+         flags = static_cast<TermBoostFlags>(
+            TermBoostFlags_DisableNewtonGain | TermBoostFlags_DisableNewtonUpdate | TermBoostFlags_RandomSplits);
+      }
+      for(size_t iTermCyclic = 0; iTermCyclic < testManual.GetCountTerms(); ++iTermCyclic) {
+         size_t iTerm = iTermCyclic;
+         if(1.0 <= greedyPortion) {
+            // the lowest negated gain is the highest gain, and ties go to the lowest term index
+            std::pop_heap(heap.begin(), heap.end(), std::greater<std::pair<double, size_t>>());
+            iTerm = heap.back().second;
+            heap.pop_back();
+         }
+         const BoostRet ret = testManual.Boost(iTerm, flags, k_learningRateDefault, k_minSamplesLeafDefault,
+            std::vector<IntEbm>(2, k_leavesMax));
+         heap.push_back(std::make_pair(-ret.gainAvg, iTerm));
+         std::push_heap(heap.begin(), heap.end(), std::greater<std::pair<double, size_t>>());
+         metricMin = std::min(metricMin, ret.validationMetric);
+      }
+      ++cRoundsManual;
+
+      if(IntEbm { 0 } == cNoChangeRun) {
+         metricBreakpoint = metricMin;
+      }
+      if(metricMin + k_earlyStoppingTolerance < metricBreakpoint) {
+         cNoChangeRun = 0;
+      } else {
+         ++cNoChangeRun;
+      }
+      if(1.0 <= greedyPortion) {
+         greedyPortion -= 1.0;
+      }
+      if(IntEbm { 0 } < cSmoothingRounds) {
+         cNoChangeRun = 0;
+         --cSmoothingRounds;
+      } else {
+         greedyPortion += k_greediness;
+      }
+      if(k_earlyStoppingRounds <= cNoChangeRun) {
+         break;
+      }
+   }
+
+   TestBoost testNative = TestBoost(
+      Task_Regression,
+      { FeatureTest(5), FeatureTest(3) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      samples,
+      validation
+   );
+
+   IntEbm cRoundsNative = -1;
+   double metricNative = 0.0;
+   const ErrorEbm error = BoostRounds(
+      testNative.GetRng(),
+      testNative.GetBoosterHandle(),
+      TermBoostFlags_Default,
+      k_learningRateDefault,
+      k_minSamplesLeafDefault,
+      k_leavesMax,
+      k_greediness,
+      k_smoothingRounds,
+      k_maxRounds,
+      k_earlyStoppingRounds,
+      k_earlyStoppingTolerance,
+      nullptr,
+      nullptr,
+      &cRoundsNative,
+      &metricNative
+   );
+   CHECK(Error_None == error);
+   CHECK(cRoundsManual == cRoundsNative);
+   CHECK(metricMin == metricNative);
+
+   for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+      CHECK(testManual.GetCurrentTermScore(0, { iBin0 }, 0) == testNative.GetCurrentTermScore(0, { iBin0 }, 0));
+      for(size_t iBin1 = 0; iBin1 < 3; ++iBin1) {
+         CHECK(testManual.GetCurrentTermScore(2, { iBin0, iBin1 }, 0) ==
+            testNative.GetCurrentTermScore(2, { iBin0, iBin1 }, 0));
+      }
+   }
+}
+
+TEST_CASE("BoostRounds callback stops boosting, boosting, regression") {
+   TestBoost test = TestBoost(
+      Task_Regression,
+      { FeatureTest(2) },
+      { { 0 } },
+      { TestSample({ 0 }, 10), TestSample({ 1 }, 20) },
+      { TestSample({ 0 }, 12), TestSample({ 1 }, 18) }
+   );
+
+   IntEbm indexRoundLast = -1;
+   IntEbm cRounds = -1;
+   double metric = 0.0;
+   const ErrorEbm error = BoostRounds(
+      test.GetRng(),
+      test.GetBoosterHandle(),
+      TermBoostFlags_Default,
+      k_learningRateDefault,
+      k_minSamplesLeafDefault,
+      3,
+      0.0,
+      0,
+      100,
+      0,
+      0.0,
+      &StopAfterTwoRounds,
+      &indexRoundLast,
+      &cRounds,
+      &metric
+   );
+   CHECK(Error_None == error);
+   CHECK(1 == indexRoundLast);
+   CHECK(2 == cRounds);
+   CHECK(metric < std::numeric_limits<double>::infinity());
+}
+
+TEST_CASE("sparse feature bin sums match the weighted bin means, boosting, regression") {
+   static constexpr size_t k_cSamples = 5003;
+   static constexpr size_t k_cBins = 4;
+
+   // bin 2 holds nearly every sample so the feature is stored sparsely with a default bin in the middle
+   std::vector<TestSample> samples;
+   samples.reserve(k_cSamples);
+   double sumWeightedTargets[k_cBins] = { 0 };
+   double sumWeights[k_cBins] = { 0 };
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      const size_t iCycle = iSample % 499;
+      const size_t iBin = 3 == iCycle ? 0 : 100 == iCycle ? 1 : 250 == iCycle || 251 == iCycle ? 3 : 2;
+      const double target = static_cast<double>(iBin) * 1.5 + static_cast<double>(iSample % 3) * 0.25;
+      const double weight = static_cast<double>(1 + iSample % 4);
+      sumWeightedTargets[iBin] += target * weight;
+      sumWeights[iBin] += weight;
+      samples.push_back(TestSample({ static_cast<IntEbm>(iBin) }, target, weight));
+   }
+
+   for(int iRun = 0; iRun < 2; ++iRun) {
+      SetThreadCount(0 == iRun ? 1 : 4);
+      TestBoost test = TestBoost(Task_Regression, { FeatureTest(k_cBins) }, { { 0 } }, samples, {});
+      test.Boost(0);
+      for(size_t iBin = 0; iBin < k_cBins; ++iBin) {
+         CHECK_APPROX(test.GetCurrentTermScore(0, { iBin }, 0),
+            k_learningRateDefault * sumWeightedTargets[iBin] / sumWeights[iBin]);
+      }
+   }
+   SetThreadCount(1);
+}
+
+TEST_CASE("target sorted layout matches the original layout, boosting, binary") {
+   static constexpr size_t k_cTrainSamples = 1021;
+   static constexpr size_t k_cValidationSamples = 257;
+
+   // the classes are interleaved irregularly so that sorting moves most of the samples
+   std::vector<TestSample> train;
+   for(size_t iSample = 0; iSample < k_cTrainSamples; ++iSample) {
+      const IntEbm bin0 = static_cast<IntEbm>(iSample % 5);
+      const IntEbm bin1 = static_cast<IntEbm>(iSample / 7 % 3);
+      const double target = 0 == (iSample * 7 + iSample / 3) % 5 || 2 == bin0 && 1 == bin1 ? 1.0 : 0.0;
+      const double initScore = static_cast<double>(iSample % 11) * 0.0625 - 0.25;
+      train.push_back(TestSample({ bin0, bin1 }, target, static_cast<double>(1 + iSample % 3), { 0.0, initScore }));
+   }
+   std::vector<TestSample> validation;
+   for(size_t iSample = 0; iSample < k_cValidationSamples; ++iSample) {
+      const IntEbm bin0 = static_cast<IntEbm>(iSample * 3 % 5);
+      const IntEbm bin1 = static_cast<IntEbm>(iSample % 3);
+      const double target = 0 == iSample % 4 || 2 == bin0 && 1 == bin1 ? 1.0 : 0.0;
+      const double initScore = static_cast<double>(iSample % 5) * 0.125 - 0.25;
+      validation.push_back(TestSample({ bin0, bin1 }, target, 1.0, { 0.0, initScore }));
+   }
+
+   for(int iRun = 0; iRun < 2; ++iRun) {
+      SetThreadCount(0 == iRun ? 1 : 4);
+      TestBoost testOriginal = TestBoost(Task_BinaryClassification, { FeatureTest(5), FeatureTest(3) }, 
+         { { 0 }, { 1 }, { 0, 1 } }, train, validation, k_countInnerBagsDefault, CreateBoosterFlags_Default);
+      TestBoost testSorted = TestBoost(Task_BinaryClassification, { FeatureTest(5), FeatureTest(3) }, 
+         { { 0 }, { 1 }, { 0, 1 } }, train, validation, k_countInnerBagsDefault, CreateBoosterFlags_TargetSorted);
+
+      for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+         for(size_t iTerm = 0; iTerm < testOriginal.GetCountTerms(); ++iTerm) {
+            const BoostRet retOriginal = testOriginal.Boost(static_cast<IntEbm>(iTerm));
+            const BoostRet retSorted = testSorted.Boost(static_cast<IntEbm>(iTerm));
+            CHECK_APPROX(retSorted.gainAvg, retOriginal.gainAvg);
+            CHECK_APPROX(retSorted.validationMetric, retOriginal.validationMetric);
+         }
+      }
+      for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+         for(size_t iBin1 = 0; iBin1 < 3; ++iBin1) {
+            CHECK_APPROX(testSorted.GetCurrentTermScore(2, { iBin0, iBin1 }, 0),
+               testOriginal.GetCurrentTermScore(2, { iBin0, iBin1 }, 0));
+         }
+      }
+   }
+   SetThreadCount(1);
+}
+
+TEST_CASE("32 bit CPU zone matches the 64 bit CPU zone, boosting") {
+   static constexpr size_t k_cTrainSamples = 1021;
+   static constexpr size_t k_cValidationSamples = 257;
+
+   for(int iTask = 0; iTask < 2; ++iTask) {
+      const TaskEbm task = 0 == iTask ? Task_Regression : Task_BinaryClassification;
+
+      std::vector<TestSample> train;
+      for(size_t iSample = 0; iSample < k_cTrainSamples; ++iSample) {
+         const IntEbm bin0 = static_cast<IntEbm>(iSample % 5);
+         const IntEbm bin1 = static_cast<IntEbm>(iSample / 7 % 3);
+         const double target = Task_Regression == task ? static_cast<double>(bin0) * 1.5 - static_cast<double>(iSample % 13) * 0.25 :
+            0 == (iSample * 7 + iSample / 3) % 5 || 2 == bin0 && 1 == bin1 ? 1.0 : 0.0;
+         train.push_back(TestSample({ bin0, bin1 }, target, static_cast<double>(1 + iSample % 3)));
+      }
+      std::vector<TestSample> validation;
+      for(size_t iSample = 0; iSample < k_cValidationSamples; ++iSample) {
+         const IntEbm bin0 = static_cast<IntEbm>(iSample * 3 % 5);
+         const IntEbm bin1 = static_cast<IntEbm>(iSample % 3);
+         const double target = Task_Regression == task ? static_cast<double>(bin1) - static_cast<double>(iSample % 7) * 0.5 :
+            0 == iSample % 4 || 2 == bin0 && 1 == bin1 ? 1.0 : 0.0;
+         validation.push_back(TestSample({ bin0, bin1 }, target));
+      }
+
+      TestBoost test64 = TestBoost(task, { FeatureTest(5), FeatureTest(3) }, { { 0 }, { 1 }, { 0, 1 } }, train, 
+         validation, k_countInnerBagsDefault, CreateBoosterFlags_Default, AccelerationFlags_NONE);
+      TestBoost test32 = TestBoost(task, { FeatureTest(5), FeatureTest(3) }, { { 0 }, { 1 }, { 0, 1 } }, train, 
+         validation, k_countInnerBagsDefault, CreateBoosterFlags_Float32, AccelerationFlags_NONE);
+
+      for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+         for(size_t iTerm = 0; iTerm < test64.GetCountTerms(); ++iTerm) {
+            const BoostRet ret64 = test64.Boost(static_cast<IntEbm>(iTerm));
+            const BoostRet ret32 = test32.Boost(static_cast<IntEbm>(iTerm));
+            CHECK_APPROX_TOLERANCE(ret32.gainAvg, ret64.gainAvg, double { 1e-3 });
+            CHECK_APPROX_TOLERANCE(ret32.validationMetric, ret64.validationMetric, double { 1e-3 });
+         }
+      }
+      for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+         for(size_t iBin1 = 0; iBin1 < 3; ++iBin1) {
+            CHECK_APPROX_TOLERANCE(test32.GetCurrentTermScore(2, { iBin0, iBin1 }, 0),
+               test64.GetCurrentTermScore(2, { iBin0, iBin1 }, 0), double { 1e-3 });
+         }
+      }
+   }
+}
+
+TEST_CASE("64 bit SIMD zones match the 64 bit CPU zone when approximations are disabled, boosting") {
+   static constexpr size_t k_cTrainSamples = 1021;
+   static constexpr size_t k_cValidationSamples = 257;
+
+   // a single leaf sums every sample into one bin, which goes through a different kernel than the tensor bins
+   static const std::vector<IntEbm> k_leavesMaxSingle = { IntEbm { 1 }, IntEbm { 1 } };
+
+   for(TaskEbm task : { Task_Regression, Task_BinaryClassification, TaskEbm { 3 } }) {
+      // without weights the SIMD zones add the sample counts and weights per lane instead of reading the weights
+      for(bool bWeighted : { true, false }) {
+         std::vector<TestSample> train;
+         for(size_t iSample = 0; iSample < k_cTrainSamples; ++iSample) {
+            const IntEbm bin0 = static_cast<IntEbm>(iSample % 5);
+            const IntEbm bin1 = static_cast<IntEbm>(iSample / 7 % 3);
+            const double target = Task_Regression == task ? static_cast<double>(bin0) * 1.5 - static_cast<double>(iSample % 13) * 0.25 :
+               Task_BinaryClassification == task ? (0 == (iSample * 7 + iSample / 3) % 5 || 2 == bin0 && 1 == bin1 ? 1.0 : 0.0) :
+               static_cast<double>((static_cast<size_t>(bin0 + bin1) + iSample / 11) % 3);
+            train.push_back(bWeighted ? TestSample({ bin0, bin1 }, target, static_cast<double>(1 + iSample % 3)) :
+               TestSample({ bin0, bin1 }, target));
+         }
+         std::vector<TestSample> validation;
+         for(size_t iSample = 0; iSample < k_cValidationSamples; ++iSample) {
+            const IntEbm bin0 = static_cast<IntEbm>(iSample * 3 % 5);
+            const IntEbm bin1 = static_cast<IntEbm>(iSample % 3);
+            const double target = Task_Regression == task ? static_cast<double>(bin1) - static_cast<double>(iSample % 7) * 0.5 :
+               Task_BinaryClassification == task ? (0 == iSample % 4 || 2 == bin0 && 1 == bin1 ? 1.0 : 0.0) :
+               static_cast<double>(static_cast<size_t>(bin0 + bin1) % 3);
+            validation.push_back(TestSample({ bin0, bin1 }, target));
+         }
+
+         // on machines without AVX2 or AVX-512 these fall back to Cpu_64, which trivially matches
+         TestBoost testCpu = TestBoost(task, { FeatureTest(5), FeatureTest(3) }, { { 0 }, { 1 }, { 0, 1 } }, train, 
+            validation, k_countInnerBagsDefault, CreateBoosterFlags_DisableApprox, AccelerationFlags_NONE);
+         TestBoost testAvx2 = TestBoost(task, { FeatureTest(5), FeatureTest(3) }, { { 0 }, { 1 }, { 0, 1 } }, train, 
+            validation, k_countInnerBagsDefault, CreateBoosterFlags_DisableApprox, AccelerationFlags_AVX2);
+         TestBoost testAvx512 = TestBoost(task, { FeatureTest(5), FeatureTest(3) }, { { 0 }, { 1 }, { 0, 1 } }, train, 
+            validation, k_countInnerBagsDefault, CreateBoosterFlags_DisableApprox, AccelerationFlags_AVX512F);
+
+         for(int iEpoch = 0; iEpoch < 6; ++iEpoch) {
+            const std::vector<IntEbm> & leavesMax = 0 == iEpoch % 3 ? k_leavesMaxSingle : k_leavesMaxDefault;
+            for(size_t iTerm = 0; iTerm < testCpu.GetCountTerms(); ++iTerm) {
+               const IntEbm indexTerm = static_cast<IntEbm>(iTerm);
+               const BoostRet retCpu = 
+                  testCpu.Boost(indexTerm, TermBoostFlags_Default, k_learningRateDefault, k_minSamplesLeafDefault, leavesMax);
+               const BoostRet retAvx2 = 
+                  testAvx2.Boost(indexTerm, TermBoostFlags_Default, k_learningRateDefault, k_minSamplesLeafDefault, leavesMax);
+               const BoostRet retAvx512 = 
+                  testAvx512.Boost(indexTerm, TermBoostFlags_Default, k_learningRateDefault, k_minSamplesLeafDefault, leavesMax);
+               CHECK_APPROX(retAvx2.gainAvg, retCpu.gainAvg);
+               CHECK_APPROX(retAvx2.validationMetric, retCpu.validationMetric);
+               CHECK_APPROX(retAvx512.gainAvg, retCpu.gainAvg);
+               CHECK_APPROX(retAvx512.validationMetric, retCpu.validationMetric);
+            }
+         }
+         for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+            for(size_t iBin1 = 0; iBin1 < 3; ++iBin1) {
+               const double scoreCpu = testCpu.GetCurrentTermScore(2, { iBin0, iBin1 }, 0);
+               CHECK_APPROX(testAvx2.GetCurrentTermScore(2, { iBin0, iBin1 }, 0), scoreCpu);
+               CHECK_APPROX(testAvx512.GetCurrentTermScore(2, { iBin0, iBin1 }, 0), scoreCpu);
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("SIMD exp and log match the CPU zone, poisson, boosting") {
+   static constexpr size_t k_cTrainSamples = 1021;
+   static constexpr size_t k_cValidationSamples = 257;
+
+   // poisson calls Exp and Log directly, so the SIMD zones use their vectorized versions even with approximations
+   std::vector<TestSample> train;
+   for(size_t iSample = 0; iSample < k_cTrainSamples; ++iSample) {
+      const IntEbm bin0 = static_cast<IntEbm>(iSample % 5);
+      const IntEbm bin1 = static_cast<IntEbm>(iSample / 7 % 3);
+      const double target = static_cast<double>(bin0 * 3 + iSample % 4) + 0.5 * static_cast<double>(bin1);
+      train.push_back(TestSample({ bin0, bin1 }, target, static_cast<double>(1 + iSample % 3)));
+   }
+   std::vector<TestSample> validation;
+   for(size_t iSample = 0; iSample < k_cValidationSamples; ++iSample) {
+      const IntEbm bin0 = static_cast<IntEbm>(iSample * 3 % 5);
+      const IntEbm bin1 = static_cast<IntEbm>(iSample % 3);
+      const double target = static_cast<double>(bin0 * 3 + iSample % 5) + 0.5 * static_cast<double>(bin1);
+      validation.push_back(TestSample({ bin0, bin1 }, target));
+   }
+
+   for(int iPrecision = 0; iPrecision < 2; ++iPrecision) {
+      const CreateBoosterFlags flags = 0 == iPrecision ? CreateBoosterFlags_Float32 : CreateBoosterFlags_DisableApprox;
+      const double tolerance = 0 == iPrecision ? double { 1e-3 } : double { 1e-4 };
+
+      // the reference is always Cpu_64, which is what the default flags select
+      TestBoost testCpu = TestBoost(Task_Regression, { FeatureTest(5), FeatureTest(3) }, { { 0 }, { 1 }, { 0, 1 } }, train, 
+         validation, k_countInnerBagsDefault, flags & ~CreateBoosterFlags_Float32, AccelerationFlags_NONE, "poisson_deviance");
+      TestBoost testAvx2 = TestBoost(Task_Regression, { FeatureTest(5), FeatureTest(3) }, { { 0 }, { 1 }, { 0, 1 } }, 
+         train, validation, k_countInnerBagsDefault, flags, AccelerationFlags_AVX2, "poisson_deviance");
+      TestBoost testAvx512 = TestBoost(Task_Regression, { FeatureTest(5), FeatureTest(3) }, { { 0 }, { 1 }, { 0, 1 } }, 
+         train, validation, k_countInnerBagsDefault, flags, AccelerationFlags_AVX512F, "poisson_deviance");
+
+      for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+         for(size_t iTerm = 0; iTerm < testCpu.GetCountTerms(); ++iTerm) {
+            const BoostRet retCpu = testCpu.Boost(static_cast<IntEbm>(iTerm));
+            const BoostRet retAvx2 = testAvx2.Boost(static_cast<IntEbm>(iTerm));
+            const BoostRet retAvx512 = testAvx512.Boost(static_cast<IntEbm>(iTerm));
+            CHECK_APPROX_TOLERANCE(retAvx2.gainAvg, retCpu.gainAvg, tolerance);
+            CHECK_APPROX_TOLERANCE(retAvx2.validationMetric, retCpu.validationMetric, tolerance);
+            CHECK_APPROX_TOLERANCE(retAvx512.gainAvg, retCpu.gainAvg, tolerance);
+            CHECK_APPROX_TOLERANCE(retAvx512.validationMetric, retCpu.validationMetric, tolerance);
+         }
+      }
+      for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+         for(size_t iBin1 = 0; iBin1 < 3; ++iBin1) {
+            const double scoreCpu = testCpu.GetCurrentTermScore(2, { iBin0, iBin1 }, 0);
+            CHECK_APPROX_TOLERANCE(testAvx2.GetCurrentTermScore(2, { iBin0, iBin1 }, 0), scoreCpu, tolerance);
+            CHECK_APPROX_TOLERANCE(testAvx512.GetCurrentTermScore(2, { iBin0, iBin1 }, 0), scoreCpu, tolerance);
+         }
+      }
+   }
+}
+
+TEST_CASE("AVX512F histograms match the CPU zone for few and many bins, boosting") {
+   static constexpr size_t k_cTrainSamples = 2039;
+   static constexpr size_t k_cValidationSamples = 257;
+   static constexpr size_t k_cFewBins = 4;
+   static constexpr size_t k_cManyBins = 300;
+
+   // the few bin feature uses the lane-private histograms and the many bin feature uses conflict detection.  The
+   // many bin feature is skewed so that most SIMD packs have several samples landing in the same bin.
+   for(int iTask = 0; iTask < 2; ++iTask) {
+      const TaskEbm task = 0 == iTask ? Task_Regression : Task_BinaryClassification;
+      for(int iWeighted = 0; iWeighted < 2; ++iWeighted) {
+         std::vector<TestSample> train;
+         for(size_t iSample = 0; iSample < k_cTrainSamples; ++iSample) {
+            const IntEbm bin0 = static_cast<IntEbm>(iSample * 5 / 3 % k_cFewBins);
+            const IntEbm bin1 = static_cast<IntEbm>(0 == iSample % 3 ? iSample * 7 % k_cManyBins : iSample % 5);
+            const double target = Task_Regression == task ? static_cast<double>(bin0) - static_cast<double>(bin1 % 11) * 0.125 :
+               0 == (iSample * 3 + static_cast<size_t>(bin1)) % 4 ? 1.0 : 0.0;
+            if(0 == iWeighted) {
+               train.push_back(TestSample({ bin0, bin1 }, target));
+            } else {
+               train.push_back(TestSample({ bin0, bin1 }, target, static_cast<double>(1 + iSample % 4) * 0.5));
+            }
+         }
+         std::vector<TestSample> validation;
+         for(size_t iSample = 0; iSample < k_cValidationSamples; ++iSample) {
+            const IntEbm bin0 = static_cast<IntEbm>(iSample % k_cFewBins);
+            const IntEbm bin1 = static_cast<IntEbm>(iSample * 11 % k_cManyBins);
+            const double target = Task_Regression == task ? static_cast<double>(bin0) - static_cast<double>(bin1 % 11) * 0.125 :
+               0 == iSample % 4 ? 1.0 : 0.0;
+            validation.push_back(TestSample({ bin0, bin1 }, target));
+         }
+
+         // inner bags make the sample counts replicated, which exercises the occurrence counts
+         const IntEbm cInnerBags = 0 == iWeighted ? k_countInnerBagsDefault : IntEbm { 3 };
+
+         // on machines without AVX-512 this falls back to the CPU zone, which trivially matches
+         TestBoost testCpu = TestBoost(task, { FeatureTest(k_cFewBins), FeatureTest(k_cManyBins) }, { { 0 }, { 1 } }, 
+            train, validation, cInnerBags, CreateBoosterFlags_Default, AccelerationFlags_NONE);
+         TestBoost testAvx512 = TestBoost(task, { FeatureTest(k_cFewBins), FeatureTest(k_cManyBins) }, { { 0 }, { 1 } }, 
+            train, validation, cInnerBags, CreateBoosterFlags_Float32, AccelerationFlags_AVX512F);
+
+         for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+            for(size_t iTerm = 0; iTerm < testCpu.GetCountTerms(); ++iTerm) {
+               const BoostRet retCpu = testCpu.Boost(static_cast<IntEbm>(iTerm));
+               const BoostRet retAvx512 = testAvx512.Boost(static_cast<IntEbm>(iTerm));
+               CHECK_APPROX_TOLERANCE(retAvx512.gainAvg, retCpu.gainAvg, double { 1e-3 });
+               CHECK_APPROX_TOLERANCE(retAvx512.validationMetric, retCpu.validationMetric, double { 1e-3 });
+            }
+         }
+         for(size_t iBin = 0; iBin < k_cFewBins; ++iBin) {
+            CHECK_APPROX_TOLERANCE(testAvx512.GetCurrentTermScore(0, { iBin }, 0), 
+               testCpu.GetCurrentTermScore(0, { iBin }, 0), double { 1e-3 });
+         }
+         for(size_t iBin = 0; iBin < k_cManyBins; iBin += 7) {
+            CHECK_APPROX_TOLERANCE(testAvx512.GetCurrentTermScore(1, { iBin }, 0), 
+               testCpu.GetCurrentTermScore(1, { iBin }, 0), double { 1e-3 });
+         }
+      }
+   }
+}
+
+static std::vector<std::string> g_logMessages;
+
+static void CollectLogMessage(const TraceEbm traceLevel, const char * const message) {
+   UNUSED(traceLevel);
+   g_logMessages.push_back(std::string(message));
+}
+
+static bool IsLogged(const char * const sSubstring) {
+   for(const std::string & message : g_logMessages) {
+      if(std::string::npos != message.find(sSubstring)) {
+         return true;
+      }
+   }
+   return false;
+}
+
+TEST_CASE("the float64 CPU zone is selected by default and float32 SIMD only when asked for, boosting") {
+   std::vector<TestSample> train;
+   for(size_t iSample = 0; iSample < 64; ++iSample) {
+      train.push_back(TestSample({ static_cast<IntEbm>(iSample % 5) }, static_cast<double>(iSample / 3 % 2)));
+   }
+
+   // the Python and R packages pass every acceleration flag by default.  That must not change the zone, so default
+   // models are still computed by Cpu_64.  CreateBoosterFlags_Float32 opts into the float32 SIMD zones
+   std::string zoneFloat32;
+   std::string zoneSIMD;
+   for(const AccelerationFlags acceleration : { AccelerationFlags_ALL, AccelerationFlags_IntelSIMD, AccelerationFlags_NONE }) {
+      for(const CreateBoosterFlags flags : { k_testCreateBoosterFlags_Default, 
+         k_testCreateBoosterFlags_Default | CreateBoosterFlags_Float32 }) {
+
+         g_logMessages.clear();
+         SetLogListener(&CollectLogMessage);
+         TestBoost test = TestBoost(Task_BinaryClassification, { FeatureTest(5) }, { { 0 } }, train, 
+            { TestSample({ 1 }, 0.0) }, k_countInnerBagsDefault, flags, acceleration);
+         SetLogListener(nullptr);
+
+         // approximations are allowed, so the 64 bit SIMD zones are never chosen
+         CHECK(!IsLogged("64 bit SIMD Objective"));
+         const std::string zone = IsLogged("creating AVX512F SIMD Objective") ? "AVX512F" : 
+            IsLogged("creating AVX2 SIMD Objective") ? "AVX2" : 
+            IsLogged("creating 32 bit CPU Objective") ? "CPU32" : "CPU";
+
+         if(0 == (CreateBoosterFlags_Float32 & flags)) {
+            CHECK(!IsLogged("compatibility"));
+            CHECK("CPU" == zone);
+         } else if(AccelerationFlags_NONE == acceleration) {
+            CHECK("CPU32" == zone);
+         } else if(AccelerationFlags_IntelSIMD == acceleration) {
+            zoneSIMD = zone;
+         } else {
+            zoneFloat32 = zone;
+#if defined(__x86_64__) || defined(_M_X64)
+            // the x86-64 builds include the SIMD zones, so asking for float32 must at least check if they can be used
+            CHECK(IsLogged("checking for AVX512F compatibility"));
+#endif // x86-64
+         }
+      }
+   }
+   CHECK(zoneSIMD == zoneFloat32);
+}
+
+TEST_CASE("quantized gradients closely track unquantized boosting, boosting") {
+   static constexpr size_t k_cTrainSamples = 1021;
+   static constexpr size_t k_cValidationSamples = 257;
+
+   for(TaskEbm task : { Task_BinaryClassification, TaskEbm { 3 } }) {
+      const IntEbm cClasses = Task_BinaryClassification == task ? IntEbm { 2 } : IntEbm { task };
+      std::vector<TestSample> train;
+      for(size_t iSample = 0; iSample < k_cTrainSamples; ++iSample) {
+         const IntEbm bin0 = static_cast<IntEbm>(iSample % 5);
+         const IntEbm bin1 = static_cast<IntEbm>(iSample / 7 % 3);
+         const double target = 
+            static_cast<double>((static_cast<size_t>(bin0 + bin1) + iSample / 11) % static_cast<size_t>(cClasses));
+         train.push_back(TestSample({ bin0, bin1 }, target));
+      }
+      std::vector<TestSample> validation;
+      for(size_t iSample = 0; iSample < k_cValidationSamples; ++iSample) {
+         const IntEbm bin0 = static_cast<IntEbm>(iSample * 3 % 5);
+         const IntEbm bin1 = static_cast<IntEbm>(iSample % 3);
+         const double target = static_cast<double>(static_cast<size_t>(bin0 + bin1) % static_cast<size_t>(cClasses));
+         validation.push_back(TestSample({ bin0, bin1 }, target));
+      }
+
+      // 8 bit gradients have 256 times fewer levels than 16 bit ones, so they get looser tolerances
+      for(CreateBoosterFlags quantize : { CreateBoosterFlags_QuantizeGradients, CreateBoosterFlags_QuantizeGradientsInt8 }) {
+         const bool bInt8 = CreateBoosterFlags_QuantizeGradientsInt8 == quantize;
+         for(IntEbm cInnerBags : { k_countInnerBagsDefault, IntEbm { 3 } }) {
+            TestBoost testFloat = TestBoost(task, { FeatureTest(5), FeatureTest(3) }, { { 0 }, { 1 }, { 0, 1 } }, 
+               train, validation, cInnerBags);
+            TestBoost testQuantized = TestBoost(task, { FeatureTest(5), FeatureTest(3) }, { { 0 }, { 1 }, { 0, 1 } }, 
+               train, validation, cInnerBags, k_testCreateBoosterFlags_Default | quantize);
+            TestBoost testQuantizedAgain = TestBoost(task, { FeatureTest(5), FeatureTest(3) }, { { 0 }, { 1 }, { 0, 1 } }, 
+               train, validation, cInnerBags, k_testCreateBoosterFlags_Default | quantize);
+
+            for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+               for(size_t iTerm = 0; iTerm < testFloat.GetCountTerms(); ++iTerm) {
+                  const BoostRet retFloat = testFloat.Boost(static_cast<IntEbm>(iTerm));
+                  const BoostRet retQuantized = testQuantized.Boost(static_cast<IntEbm>(iTerm));
+                  const BoostRet retQuantizedAgain = testQuantizedAgain.Boost(static_cast<IntEbm>(iTerm));
+                  // late gains are tiny differences of large sums, so they see more of the rounding noise than the metric
+                  CHECK_APPROX_TOLERANCE(retQuantized.gainAvg, retFloat.gainAvg, bInt8 ? double { 1e-1 } : double { 1e-2 });
+                  CHECK_APPROX_TOLERANCE(retQuantized.validationMetric, retFloat.validationMetric, 
+                     bInt8 ? double { 1e-2 } : double { 1e-3 });
+                  // the stochastic rounding is seeded from the booster rng, so repeated runs are identical
+                  CHECK(retQuantizedAgain.gainAvg == retQuantized.gainAvg);
+                  CHECK(retQuantizedAgain.validationMetric == retQuantized.validationMetric);
+               }
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("quantized gradients are summed with integers in the SIMD zone, boosting") {
+   std::vector<TestSample> train;
+   for(size_t iSample = 0; iSample < 1024; ++iSample) {
+      const IntEbm bin0 = static_cast<IntEbm>(iSample % 5);
+      const IntEbm bin1 = static_cast<IntEbm>(iSample / 3 % 61);
+      train.push_back(TestSample({ bin0, bin1 }, static_cast<double>((iSample / 7 + iSample % 5) % 2)));
+   }
+
+   // 5 bins use the lane private histograms of the AVX512F kernel, and 61 bins use its conflict rounds
+   for(AccelerationFlags acceleration : { AccelerationFlags_AVX512F, AccelerationFlags_AVX2 }) {
+      for(CreateBoosterFlags quantize : { CreateBoosterFlags_QuantizeGradients, CreateBoosterFlags_QuantizeGradientsInt8 }) {
+         g_logMessages.clear();
+         SetLogListener(&CollectLogMessage);
+         TestBoost test = TestBoost(Task_BinaryClassification, { FeatureTest(5), FeatureTest(61) }, { { 0 }, { 1 } }, 
+            train, { TestSample({ 1, 1 }, 0.0) }, IntEbm { 2 }, k_testCreateBoosterFlags_Default | CreateBoosterFlags_Float32 | quantize, 
+            acceleration);
+         for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+            test.Boost(0);
+            test.Boost(1);
+         }
+         SetLogListener(nullptr);
+
+         const char * const sBytes = CreateBoosterFlags_QuantizeGradientsInt8 == quantize ? 
+            "summing 1 byte quantized gradients" : "summing 2 byte quantized gradients";
+         CHECK(IsLogged(sBytes));
+         if(IsLogged("creating AVX512F")) {
+            CHECK(IsLogged("quantized gradients in zone 0x4"));
+         } else if(IsLogged("creating AVX2")) {
+            CHECK(IsLogged("quantized gradients in zone 0x2"));
+         } else {
+            // no SIMD zone on this machine or in this build, so everything runs in the CPU zone
+            CHECK(IsLogged("quantized gradients in zone 0x0"));
+         }
+      }
+   }
+}
+
+TEST_CASE("quantized gradients are ignored for weighted datasets and RMSE, boosting") {
+   std::vector<TestSample> train;
+   std::vector<TestSample> trainWeighted;
+   for(size_t iSample = 0; iSample < 101; ++iSample) {
+      const IntEbm bin0 = static_cast<IntEbm>(iSample % 5);
+      train.push_back(TestSample({ bin0 }, static_cast<double>(iSample % 7) * 0.5));
+      trainWeighted.push_back(TestSample({ bin0 }, static_cast<double>(iSample % 7) * 0.5, static_cast<double>(1 + iSample % 3)));
+   }
+
+   for(CreateBoosterFlags quantize : { CreateBoosterFlags_QuantizeGradients, CreateBoosterFlags_QuantizeGradientsInt8 }) {
+      // RMSE keeps its residuals in the gradients, so it cannot round them even without weights
+      for(const std::vector<TestSample> * pTrain : { &trainWeighted, &train }) {
+         TestBoost testFloat = TestBoost(Task_Regression, { FeatureTest(5) }, { { 0 } }, *pTrain, { TestSample({ 1 }, 2.0) });
+         TestBoost testQuantized = TestBoost(Task_Regression, { FeatureTest(5) }, { { 0 } }, *pTrain, { TestSample({ 1 }, 2.0) },
+            k_countInnerBagsDefault, k_testCreateBoosterFlags_Default | quantize);
+
+         for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+            const BoostRet retFloat = testFloat.Boost(0);
+            const BoostRet retQuantized = testQuantized.Boost(0);
+            CHECK(retQuantized.gainAvg == retFloat.gainAvg);
+            CHECK(retQuantized.validationMetric == retFloat.validationMetric);
+         }
+      }
+   }
+}
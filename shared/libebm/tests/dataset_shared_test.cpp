@@ -569,3 +569,149 @@ TEST_CASE("dataset_shared, two features, 3 samples, weights, classification") {
 
    CHECK(99 == buffer[static_cast<size_t>(sum)]);
 }
+
+TEST_CASE("dataset_shared, FillFeatures matches FillFeature, classification") {
+   static constexpr size_t k_cSamples = 300007;
+   static constexpr size_t k_cFeatures = 6;
+   const IntEbm countBins[k_cFeatures] = { 3, 4, 19, 300, 3, 70000 };
+   const BoolEbm isMissing[k_cFeatures] = { EBM_FALSE, EBM_TRUE, EBM_TRUE, EBM_FALSE, EBM_FALSE, EBM_TRUE };
+   const BoolEbm isUnknown[k_cFeatures] = { EBM_FALSE, EBM_FALSE, EBM_TRUE, EBM_TRUE, EBM_FALSE, EBM_FALSE };
+   const BoolEbm isNominal[k_cFeatures] = { EBM_FALSE, EBM_TRUE, EBM_FALSE, EBM_FALSE, EBM_TRUE, EBM_FALSE };
+
+   std::vector<IntEbm> binIndexes;
+   for(size_t iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+      // the legal bin indexes are [first, last) once missing and unknown are accounted for
+      const IntEbm first = EBM_FALSE != isMissing[iFeature] ? 0 : 1;
+      const IntEbm last = countBins[iFeature] - (EBM_FALSE != isUnknown[iFeature] ? 0 : 1);
+      for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+         binIndexes.push_back(first + static_cast<IntEbm>((iSample * 7919 + iFeature) % static_cast<size_t>(last - first)));
+      }
+   }
+   std::vector<IntEbm> targets;
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      targets.push_back(static_cast<IntEbm>(iSample % 3));
+   }
+
+   IntEbm sum = MeasureDataSetHeader(k_cFeatures, 0, 1);
+   CHECK(0 <= sum);
+   for(size_t iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+      const IntEbm part = MeasureFeature(countBins[iFeature], isMissing[iFeature], isUnknown[iFeature],
+         isNominal[iFeature], k_cSamples, &binIndexes[k_cSamples * iFeature]);
+      CHECK(0 <= part);
+      sum += part;
+   }
+   sum += MeasureClassificationTarget(3, k_cSamples, &targets[0]);
+
+   ErrorEbm error;
+
+   std::vector<char> expected(static_cast<size_t>(sum));
+   error = FillDataSetHeader(k_cFeatures, 0, 1, sum, &expected[0]);
+   CHECK(Error_None == error);
+   for(size_t iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+      error = FillFeature(countBins[iFeature], isMissing[iFeature], isUnknown[iFeature], isNominal[iFeature],
+         k_cSamples, &binIndexes[k_cSamples * iFeature], sum, &expected[0]);
+      CHECK(Error_None == error);
+   }
+   error = FillClassificationTarget(3, k_cSamples, &targets[0], sum, &expected[0]);
+   CHECK(Error_None == error);
+
+   for(int iRun = 0; iRun < 2; ++iRun) {
+      SetThreadCount(0 == iRun ? 1 : 4);
+
+      // the first features in one call, then the rest in another to check continuing from the internal state
+      static constexpr size_t k_cFirst = 4;
+      std::vector<char> buffer(static_cast<size_t>(sum));
+      error = FillDataSetHeader(k_cFeatures, 0, 1, sum, &buffer[0]);
+      CHECK(Error_None == error);
+      error = FillFeatures(k_cFirst, countBins, isMissing, isUnknown, isNominal, k_cSamples, &binIndexes[0], sum,
+         &buffer[0]);
+      CHECK(Error_None == error);
+      error = FillFeatures(k_cFeatures - k_cFirst, &countBins[k_cFirst], &isMissing[k_cFirst], &isUnknown[k_cFirst],
+         &isNominal[k_cFirst], k_cSamples, &binIndexes[k_cSamples * k_cFirst], sum, &buffer[0]);
+      CHECK(Error_None == error);
+      error = FillClassificationTarget(3, k_cSamples, &targets[0], sum, &buffer[0]);
+      CHECK(Error_None == error);
+      CHECK(expected == buffer);
+   }
+   SetThreadCount(1);
+
+   // an illegal bin index deep in a feature fails the dataset
+   binIndexes[k_cSamples * 2 + k_cSamples - 3] = countBins[2];
+   std::vector<char> buffer(static_cast<size_t>(sum));
+   error = FillDataSetHeader(k_cFeatures, 0, 1, sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillFeatures(k_cFeatures, countBins, isMissing, isUnknown, isNominal, k_cSamples, &binIndexes[0], sum,
+      &buffer[0]);
+   CHECK(Error_IllegalParamVal == error);
+   error = FillClassificationTarget(3, k_cSamples, &targets[0], sum, &buffer[0]);
+   CHECK(Error_IllegalParamVal == error);
+}
+
+TEST_CASE("dataset_shared, sparse layout is not chosen when it is larger than dense, regression") {
+   static constexpr size_t k_cSamples = 64 * 1000;
+   static constexpr IntEbm k_cBins = 2;
+
+   // 1 in 64 samples is outside the default bin, but a 2 bin feature packs densely into far fewer bytes than the
+   // (index, value) entries of its non-default samples would take
+   std::vector<IntEbm> indicatorBins(k_cSamples, 0);
+   std::vector<IntEbm> alternatingBins(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      if(0 == iSample % 64) {
+         indicatorBins[iSample] = 1;
+      }
+      alternatingBins[iSample] = static_cast<IntEbm>(iSample % 2);
+   }
+
+   const IntEbm indicatorPart = MeasureFeature(k_cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &indicatorBins[0]);
+   CHECK(0 <= indicatorPart);
+   const IntEbm alternatingPart = 
+      MeasureFeature(k_cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &alternatingBins[0]);
+   CHECK(0 <= alternatingPart);
+   CHECK(indicatorPart == alternatingPart);
+}
+
+TEST_CASE("dataset_shared, mostly default feature is stored sparsely, regression") {
+   static constexpr size_t k_cSamples = 10000;
+   static constexpr IntEbm k_cBins = 1000;
+
+   std::vector<IntEbm> sparseBins(k_cSamples, 17);
+   std::vector<IntEbm> denseBins(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      if(0 == iSample % 1000) {
+         sparseBins[iSample] = static_cast<IntEbm>(iSample / 1000);
+      }
+      denseBins[iSample] = static_cast<IntEbm>(iSample % static_cast<size_t>(k_cBins));
+   }
+   const std::vector<double> targets(k_cSamples, 1.5);
+
+   const IntEbm sparsePart = MeasureFeature(k_cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &sparseBins[0]);
+   CHECK(0 <= sparsePart);
+   const IntEbm densePart = MeasureFeature(k_cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &denseBins[0]);
+   CHECK(0 <= densePart);
+   CHECK(sparsePart * 10 < densePart);
+
+   IntEbm sum = MeasureDataSetHeader(1, 0, 1);
+   CHECK(0 <= sum);
+   sum += sparsePart;
+   sum += MeasureRegressionTarget(k_cSamples, &targets[0]);
+
+   std::vector<char> buffer(static_cast<size_t>(sum) + 1, 77);
+   buffer[static_cast<size_t>(sum)] = 99;
+
+   ErrorEbm error;
+   error = FillDataSetHeader(1, 0, 1, sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillFeature(k_cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &sparseBins[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillRegressionTarget(k_cSamples, &targets[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+   CHECK(99 == buffer[static_cast<size_t>(sum)]);
+
+   // an illegal bin among the non-default samples is still caught
+   sparseBins[5000] = k_cBins;
+   std::vector<char> bufferBad(static_cast<size_t>(sum));
+   error = FillDataSetHeader(1, 0, 1, sum, &bufferBad[0]);
+   CHECK(Error_None == error);
+   error = FillFeature(k_cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &sparseBins[0], sum, &bufferBad[0]);
+   CHECK(Error_IllegalParamVal == error);
+}
@@ -387,6 +387,31 @@ TEST_CASE("weights totals equivalence, interaction, multiclass") {
    CHECK_APPROX(metricReturn1, metricReturn2);
 }
 
+TEST_CASE("weighted classification strengths are unchanged by binning with the weights, interaction") {
+   // classification used to multiply its gradients and hessians by the weights when the interaction detector was
+   // created, and now BinSumsInteraction multiplies them while binning.  The products are the same, so these
+   // strengths, which were recorded before the change, must not move
+   for(const size_t cClasses : { size_t { 2 }, size_t { 3 } }) {
+      std::vector<TestSample> samples;
+      for(size_t iSample = 0; iSample < 48; ++iSample) {
+         const IntEbm iBin0 = static_cast<IntEbm>(iSample % 4);
+         const IntEbm iBin1 = static_cast<IntEbm>(iSample / 4 % 3);
+         const double target = static_cast<double>((iSample * 7 + iSample / 5) % cClasses);
+         const double weight = 0.25 + static_cast<double>(iSample % 7) * 0.5;
+         samples.push_back(TestSample({ iBin0, iBin1 }, target, weight));
+      }
+
+      TestInteraction test = TestInteraction(
+         static_cast<TaskEbm>(cClasses),
+         { FeatureTest(4), FeatureTest(3) },
+         samples
+      );
+
+      const double strength = test.TestCalcInteractionStrength({ 0, 1 });
+      CHECK_APPROX(strength, size_t { 2 } == cClasses ? 0.021301798544806367 : 0.030999349713911988);
+   }
+}
+
 TEST_CASE("purified interaction strength with impure inputs should be zero, interaction, regression") {
    // impure:
    // feature1 = 3, 5
@@ -473,6 +498,105 @@ TEST_CASE("purified interaction strength same as pre-purified strength, interact
    CHECK_APPROX(metricReturn1, metricReturn2);
 }
 
+TEST_CASE("purified interaction strength with impure inputs should be zero, 3 dimensions, interaction, regression") {
+   // main effects plus a pair effect between features 0 and 1, with random weights, have no 3-way component
+   static const double k_main0[] = { 3.0, 5.0 };
+   static const double k_main1[] = { 11.0, 7.0 };
+   static const double k_main2[] = { -2.0, 13.0 };
+   static const double k_pair01[2][2] = { { 1.5, -4.0 }, { 6.0, 0.25 } };
+   static const double k_weights[] = { 24.25, 21.5, 8.125, 11.625, 3.5, 17.0, 0.75, 9.0 };
+
+   std::vector<TestSample> samples;
+   for(IntEbm i = 0; i < 8; ++i) {
+      const IntEbm bin0 = i & 1;
+      const IntEbm bin1 = (i >> 1) & 1;
+      const IntEbm bin2 = (i >> 2) & 1;
+      const double target = k_main0[bin0] + k_main1[bin1] + k_main2[bin2] + k_pair01[bin0][bin1];
+      samples.push_back(TestSample({ bin0, bin1, bin2 }, target, k_weights[i]));
+   }
+   TestInteraction test = TestInteraction(Task_Regression, { FeatureTest(2), FeatureTest(2), FeatureTest(2) }, samples);
+
+   double metricReturn = test.TestCalcInteractionStrength({ 0, 1, 2 }, CalcInteractionFlags_Pure);
+   CHECK(0 <= metricReturn && metricReturn < 0.0000001);
+
+   // the impure strength includes the main and pair effects
+   metricReturn = test.TestCalcInteractionStrength({ 0, 1, 2 });
+   CHECK(0.1 < metricReturn);
+}
+
+TEST_CASE("purified interaction strength same as pre-purified strength, 3 dimensions, interaction, regression") {
+   // with weights a[i] * b[j] * c[k] the updates f[i] * g[j] * h[k] are pure when a.f, b.g and c.h are all zero
+   static const double k_a[] = { 2.0, 0.5 };
+   static const double k_f[] = { 0.5, -2.0 };
+   static const double k_b[] = { 1.0, 4.0 };
+   static const double k_g[] = { 1.0, -0.25 };
+   static const double k_c[] = { 3.0, 1.0 };
+   static const double k_h[] = { 1.0 / 3.0, -1.0 };
+   static const double k_main0[] = { 3.0, 5.0 };
+   static const double k_pair12[2][2] = { { 11.0, 7.0 }, { -6.0, 2.0 } };
+
+   std::vector<TestSample> samplesPure;
+   std::vector<TestSample> samplesImpure;
+   for(IntEbm i = 0; i < 8; ++i) {
+      const IntEbm bin0 = i & 1;
+      const IntEbm bin1 = (i >> 1) & 1;
+      const IntEbm bin2 = (i >> 2) & 1;
+      const double weight = k_a[bin0] * k_b[bin1] * k_c[bin2];
+      const double pure = 8.0 * k_f[bin0] * k_g[bin1] * k_h[bin2];
+      samplesPure.push_back(TestSample({ bin0, bin1, bin2 }, pure, weight));
+      samplesImpure.push_back(TestSample({ bin0, bin1, bin2 }, pure + k_main0[bin0] + k_pair12[bin1][bin2], weight));
+   }
+   const std::vector<FeatureTest> features = { FeatureTest(2), FeatureTest(2), FeatureTest(2) };
+   TestInteraction test1 = TestInteraction(Task_Regression, features, samplesPure);
+   TestInteraction test2 = TestInteraction(Task_Regression, features, samplesImpure);
+
+   const double metricReturn1 = test1.TestCalcInteractionStrength({ 0, 1, 2 }, CalcInteractionFlags_Pure);
+   const double metricReturn2 = test2.TestCalcInteractionStrength({ 0, 1, 2 }, CalcInteractionFlags_Pure);
+   CHECK(0.1 < metricReturn1);
+   CHECK_APPROX(metricReturn1, metricReturn2);
+
+   // for an already pure input, the impure strength is the same
+   const double metricReturn3 = test1.TestCalcInteractionStrength({ 0, 1, 2 });
+   CHECK_APPROX(metricReturn1, metricReturn3);
+}
+
+TEST_CASE("3 and 4 dimensional interaction strength, interaction, regression") {
+   std::vector<TestSample> samples;
+   for(IntEbm iSample = 0; iSample < 400; ++iSample) {
+      const IntEbm bin0 = iSample % 4;
+      const IntEbm bin1 = (iSample / 4) % 4;
+      const IntEbm bin2 = (iSample / 16) % 4;
+      const IntEbm bin3 = (iSample * 7 + iSample / 64) % 4;
+      // a 3-way interaction between the first 3 features
+      const double sign = ((bin0 < 2) == (bin1 < 2)) == (bin2 < 2) ? 1.0 : -1.0;
+      samples.push_back(TestSample({ bin0, bin1, bin2, bin3 }, 10.0 * sign + 0.01 * static_cast<double>(iSample % 3)));
+   }
+   TestInteraction test = TestInteraction(
+      Task_Regression,
+      { FeatureTest(4), FeatureTest(4), FeatureTest(4), FeatureTest(4) },
+      samples
+   );
+
+   const double strength012 = test.TestCalcInteractionStrength({ 0, 1, 2 }, CalcInteractionFlags_Pure);
+   const double strength013 = test.TestCalcInteractionStrength({ 0, 1, 3 }, CalcInteractionFlags_Pure);
+   const double strength01 = test.TestCalcInteractionStrength({ 0, 1 }, CalcInteractionFlags_Pure);
+   CHECK(1.0 < strength012);
+   CHECK(0 <= strength013 && strength013 < 0.01 * strength012);
+   CHECK(0 <= strength01 && strength01 < 0.01 * strength012);
+
+   // the impure strength also includes the lower order effects of the uneven bin counts
+   const double impure012 = test.TestCalcInteractionStrength({ 0, 1, 2 });
+   CHECK(strength012 <= impure012);
+
+   // a 4th dimension goes through the dynamic version and cannot make the impure gain worse
+   const double impure0123 = test.TestCalcInteractionStrength({ 0, 1, 2, 3 });
+   CHECK(impure012 * 0.999 <= impure0123);
+
+   // one dimension is not an interaction
+   const double strength0 = test.TestCalcInteractionStrength({ 0 });
+   CHECK(std::numeric_limits<double>::lowest() == strength0);
+}
+
 TEST_CASE("compare boosting gain to interaction strength, which should be identical") {
    // we use the same algorithm to calculate interaction strength (gain) and during boosting (gain again)
    // so we would expect them to generate the same response
@@ -529,3 +653,528 @@ TEST_CASE("tweedie, interaction") {
    CHECK_APPROX(metricReturn, 1.25);
 }
 
+
+TEST_CASE("CalcInteractionStrengths matches CalcInteractionStrength, interaction, regression") {
+   std::vector<TestSample> samples;
+   for(int i = 0; i < 60; ++i) {
+      const IntEbm bin0 = i % 3;
+      const IntEbm bin1 = (i / 3) % 3;
+      const IntEbm bin2 = (i / 9) % 3;
+      const IntEbm bin3 = (i * 7) % 3;
+      const double target = static_cast<double>(bin0 * bin1) * 2.0 + static_cast<double>(bin2 * bin3) + 0.25 * i;
+      samples.push_back(TestSample({ bin0, bin1, bin2, bin3 }, target));
+   }
+   TestInteraction test = TestInteraction(
+      Task_Regression,
+      { FeatureTest(3), FeatureTest(3), FeatureTest(3), FeatureTest(3) },
+      samples
+   );
+
+   const std::vector<std::vector<IntEbm>> terms = {
+      { 0, 1 }, { 0, 2 }, { 0, 3 }, { 1, 2 }, { 1, 3 }, { 2, 3 }, { 1 }, {}, { 2, 3 }
+   };
+   std::vector<IntEbm> dimensionCounts;
+   std::vector<IntEbm> featureIndexes;
+   std::vector<double> expected;
+   for(const std::vector<IntEbm> & term : terms) {
+      dimensionCounts.push_back(static_cast<IntEbm>(term.size()));
+      featureIndexes.insert(featureIndexes.end(), term.begin(), term.end());
+      expected.push_back(test.TestCalcInteractionStrength(term));
+   }
+   const IntEbm cTerms = static_cast<IntEbm>(terms.size());
+
+   for(int iRun = 0; iRun < 2; ++iRun) {
+      SetThreadCount(0 == iRun ? 1 : 4);
+
+      std::vector<double> strengths(terms.size());
+      ErrorEbm error = CalcInteractionStrengths(test.GetInteractionHandle(), cTerms, &dimensionCounts[0],
+         &featureIndexes[0], CalcInteractionFlags_Default, 0, 0, 0, nullptr, &strengths[0], nullptr);
+      CHECK(Error_None == error);
+      for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+         CHECK(expected[iTerm] == strengths[iTerm]);
+      }
+
+      // ask for more top terms than there are to check the unused entries
+      const size_t cTop = terms.size() + 2;
+      std::vector<IntEbm> topIndexes(cTop);
+      std::vector<double> topStrengths(cTop);
+      error = CalcInteractionStrengths(test.GetInteractionHandle(), cTerms, &dimensionCounts[0],
+         &featureIndexes[0], CalcInteractionFlags_Default, 0, 0, static_cast<IntEbm>(cTop), &topIndexes[0],
+         &topStrengths[0], nullptr);
+      CHECK(Error_None == error);
+      for(size_t iOut = 0; iOut < terms.size(); ++iOut) {
+         const size_t iTerm = static_cast<size_t>(topIndexes[iOut]);
+         CHECK(iTerm < terms.size());
+         CHECK(expected[iTerm] == topStrengths[iOut]);
+         if(0 != iOut) {
+            const size_t iTermPrev = static_cast<size_t>(topIndexes[iOut - 1]);
+            CHECK(topStrengths[iOut] < topStrengths[iOut - 1] ||
+               (topStrengths[iOut] == topStrengths[iOut - 1] && iTermPrev < iTerm));
+         }
+      }
+      for(size_t iOut = terms.size(); iOut < cTop; ++iOut) {
+         CHECK(IntEbm { -1 } == topIndexes[iOut]);
+      }
+
+      // keeping fewer top terms gives the start of the same order
+      std::vector<IntEbm> top2Indexes(2);
+      std::vector<double> top2Strengths(2);
+      error = CalcInteractionStrengths(test.GetInteractionHandle(), cTerms, &dimensionCounts[0],
+         &featureIndexes[0], CalcInteractionFlags_Default, 0, 0, 2, &top2Indexes[0], &top2Strengths[0], nullptr);
+      CHECK(Error_None == error);
+      CHECK(topIndexes[0] == top2Indexes[0]);
+      CHECK(topIndexes[1] == top2Indexes[1]);
+      CHECK(topStrengths[0] == top2Strengths[0]);
+      CHECK(topStrengths[1] == top2Strengths[1]);
+   }
+   SetThreadCount(1);
+
+   const IntEbm badFeatureIndexes[] = { 0, 4 };
+   const IntEbm badDimensionCounts[] = { 2 };
+   double strength;
+   const ErrorEbm error = CalcInteractionStrengths(test.GetInteractionHandle(), 1, badDimensionCounts,
+      badFeatureIndexes, CalcInteractionFlags_Default, 0, 0, 0, nullptr, &strength, nullptr);
+   CHECK(Error_IllegalParamVal == error);
+}
+
+TEST_CASE("CalcInteractionStrengths pairs sharing an anchor match CalcInteractionStrength, interaction, multiclass") {
+   // more partners than fit in one pass, with weights and several scores
+   static constexpr IntEbm k_cFeatures = 20;
+   std::vector<FeatureTest> features;
+   for(IntEbm iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+      features.push_back(FeatureTest(2 + iFeature % 5));
+   }
+   std::vector<TestSample> samples;
+   for(IntEbm iSample = 0; iSample < 101; ++iSample) {
+      std::vector<IntEbm> bins;
+      for(IntEbm iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+         bins.push_back((iSample * (iFeature + 3) + iSample / 7) % (2 + iFeature % 5));
+      }
+      const IntEbm target = (bins[0] + bins[1 + iSample % (k_cFeatures - 1)]) % 3;
+      samples.push_back(TestSample(bins, static_cast<double>(target), 0.5 + static_cast<double>(iSample % 4)));
+   }
+   TestInteraction test = TestInteraction(3, features, samples);
+
+   std::vector<IntEbm> dimensionCounts;
+   std::vector<IntEbm> featureIndexes;
+   std::vector<double> expected;
+   for(IntEbm iAnchor = 0; iAnchor < 2; ++iAnchor) {
+      for(IntEbm iPartner = 0; iPartner < k_cFeatures; ++iPartner) {
+         if(iAnchor != iPartner) {
+            dimensionCounts.push_back(2);
+            featureIndexes.push_back(iAnchor);
+            featureIndexes.push_back(iPartner);
+            expected.push_back(test.TestCalcInteractionStrength({ iAnchor, iPartner }, CalcInteractionFlags_EnableNewton));
+         }
+      }
+   }
+
+   for(int iRun = 0; iRun < 2; ++iRun) {
+      SetThreadCount(0 == iRun ? 1 : 3);
+
+      std::vector<double> strengths(expected.size());
+      const ErrorEbm error = CalcInteractionStrengths(test.GetInteractionHandle(), 
+         static_cast<IntEbm>(expected.size()), &dimensionCounts[0], &featureIndexes[0], 
+         CalcInteractionFlags_EnableNewton, 0, 0, 0, nullptr, &strengths[0], nullptr);
+      CHECK(Error_None == error);
+      for(size_t iTerm = 0; iTerm < expected.size(); ++iTerm) {
+         CHECK(expected[iTerm] == strengths[iTerm]);
+      }
+   }
+   SetThreadCount(1);
+}
+
+TEST_CASE("CalcInteractionStrengths pruning keeps the exact top terms, interaction, regression") {
+   static constexpr IntEbm k_cFeatures = 12;
+   std::vector<FeatureTest> features;
+   for(IntEbm iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+      features.push_back(FeatureTest(3 + iFeature % 3));
+   }
+   std::vector<TestSample> samples;
+   for(IntEbm iSample = 0; iSample < 200; ++iSample) {
+      std::vector<IntEbm> bins;
+      for(IntEbm iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+         bins.push_back((iSample * (2 * iFeature + 1) + iSample / (iFeature + 2)) % (3 + iFeature % 3));
+      }
+      const double target = 10.0 * static_cast<double>(bins[0] * bins[1]) + 
+         static_cast<double>(bins[2] * bins[3]) + 0.01 * static_cast<double>(iSample % 5);
+      samples.push_back(TestSample(bins, target));
+   }
+   TestInteraction test = TestInteraction(Task_Regression, features, samples);
+
+   std::vector<IntEbm> dimensionCounts;
+   std::vector<IntEbm> featureIndexes;
+   for(IntEbm iFeature1 = 0; iFeature1 < k_cFeatures; ++iFeature1) {
+      for(IntEbm iFeature2 = iFeature1 + 1; iFeature2 < k_cFeatures; ++iFeature2) {
+         dimensionCounts.push_back(2);
+         featureIndexes.push_back(iFeature1);
+         featureIndexes.push_back(iFeature2);
+      }
+   }
+   const size_t cTerms = dimensionCounts.size();
+
+   for(int iFlags = 0; iFlags < 2; ++iFlags) {
+      const CalcInteractionFlags flags = 0 == iFlags ? CalcInteractionFlags_Default : CalcInteractionFlags_Pure;
+
+      SetThreadCount(1);
+      std::vector<double> strengths(cTerms);
+      ErrorEbm error = CalcInteractionStrengths(test.GetInteractionHandle(), static_cast<IntEbm>(cTerms),
+         &dimensionCounts[0], &featureIndexes[0], flags, 0, 0, 0, nullptr, &strengths[0], nullptr);
+      CHECK(Error_None == error);
+      std::vector<size_t> order(cTerms);
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         order[iTerm] = iTerm;
+      }
+      std::sort(order.begin(), order.end(), [&strengths](const size_t iTerm1, const size_t iTerm2) {
+         return strengths[iTerm2] < strengths[iTerm1] || (strengths[iTerm1] == strengths[iTerm2] && iTerm1 < iTerm2);
+      });
+
+      for(int iRun = 0; iRun < 2; ++iRun) {
+         SetThreadCount(0 == iRun ? 1 : 4);
+
+         static constexpr size_t k_cTop = 3;
+         std::vector<IntEbm> topIndexes(k_cTop);
+         std::vector<double> topStrengths(k_cTop);
+         IntEbm cPruned = -1;
+         error = CalcInteractionStrengths(test.GetInteractionHandle(), static_cast<IntEbm>(cTerms),
+            &dimensionCounts[0], &featureIndexes[0], flags, 0, 0, static_cast<IntEbm>(k_cTop), &topIndexes[0],
+            &topStrengths[0], &cPruned);
+         CHECK(Error_None == error);
+         for(size_t iOut = 0; iOut < k_cTop; ++iOut) {
+            CHECK(static_cast<IntEbm>(order[iOut]) == topIndexes[iOut]);
+            CHECK(strengths[order[iOut]] == topStrengths[iOut]);
+         }
+         if(0 == iFlags) {
+            // with one thread every pair after the first few can be compared to the strongest pairs
+            CHECK(0 <= cPruned);
+            CHECK(cPruned < static_cast<IntEbm>(cTerms));
+            if(0 == iRun) {
+               CHECK(0 < cPruned);
+            }
+         } else {
+            // purified gain has no bound, so nothing is pruned
+            CHECK(0 == cPruned);
+         }
+      }
+   }
+   SetThreadCount(1);
+}
+
+TEST_CASE("CalcInteractionStrengthsRefined reports full data strengths of the refined terms, interaction, regression") {
+   static constexpr IntEbm k_cFeatures = 8;
+   std::vector<FeatureTest> features;
+   for(IntEbm iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+      features.push_back(FeatureTest(3 + iFeature % 3));
+   }
+   std::vector<TestSample> samples;
+   std::vector<TestSample> subsamples;
+   for(IntEbm iSample = 0; iSample < 400; ++iSample) {
+      std::vector<IntEbm> bins;
+      for(IntEbm iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+         bins.push_back((iSample * (2 * iFeature + 1) + iSample / (iFeature + 2)) % (3 + iFeature % 3));
+      }
+      const double target = 10.0 * static_cast<double>(bins[0] * bins[1]) +
+         static_cast<double>(bins[2] * bins[3]) + 0.01 * static_cast<double>(iSample % 5);
+      samples.push_back(TestSample(bins, target));
+      if(0 == iSample % 4) {
+         subsamples.push_back(TestSample(bins, target));
+      }
+   }
+   TestInteraction test = TestInteraction(Task_Regression, features, samples);
+   TestInteraction testSubsample = TestInteraction(Task_Regression, features, subsamples);
+
+   std::vector<IntEbm> dimensionCounts;
+   std::vector<IntEbm> featureIndexes;
+   for(IntEbm iFeature1 = 0; iFeature1 < k_cFeatures; ++iFeature1) {
+      for(IntEbm iFeature2 = iFeature1 + 1; iFeature2 < k_cFeatures; ++iFeature2) {
+         dimensionCounts.push_back(2);
+         featureIndexes.push_back(iFeature1);
+         featureIndexes.push_back(iFeature2);
+      }
+   }
+   const IntEbm cTerms = static_cast<IntEbm>(dimensionCounts.size());
+
+   std::vector<double> strengths(dimensionCounts.size());
+   ErrorEbm error = CalcInteractionStrengths(test.GetInteractionHandle(), cTerms, &dimensionCounts[0],
+      &featureIndexes[0], CalcInteractionFlags_Default, 0, 0, 0, nullptr, &strengths[0], nullptr);
+   CHECK(Error_None == error);
+
+   static constexpr size_t k_cRefined = 6;
+   static constexpr size_t k_cTop = 3;
+   std::vector<IntEbm> subsampleTopIndexes(k_cRefined);
+   std::vector<double> subsampleTopStrengths(k_cRefined);
+   error = CalcInteractionStrengths(testSubsample.GetInteractionHandle(), cTerms, &dimensionCounts[0],
+      &featureIndexes[0], CalcInteractionFlags_Default, 0, 0, static_cast<IntEbm>(k_cRefined),
+      &subsampleTopIndexes[0], &subsampleTopStrengths[0], nullptr);
+   CHECK(Error_None == error);
+
+   std::vector<IntEbm> topIndexes(k_cTop);
+   std::vector<double> topStrengths(k_cTop);
+   std::vector<IntEbm> refinedIndexes(k_cRefined);
+   error = CalcInteractionStrengthsRefined(testSubsample.GetInteractionHandle(), test.GetInteractionHandle(), cTerms,
+      &dimensionCounts[0], &featureIndexes[0], CalcInteractionFlags_Default, 0, 0, static_cast<IntEbm>(k_cRefined),
+      static_cast<IntEbm>(k_cTop), &topIndexes[0], &topStrengths[0], &refinedIndexes[0]);
+   CHECK(Error_None == error);
+   CHECK(subsampleTopIndexes == refinedIndexes);
+   for(size_t iOut = 0; iOut < k_cTop; ++iOut) {
+      CHECK(std::find(refinedIndexes.begin(), refinedIndexes.end(), topIndexes[iOut]) != refinedIndexes.end());
+      CHECK(strengths[static_cast<size_t>(topIndexes[iOut])] == topStrengths[iOut]);
+      if(0 != iOut) {
+         CHECK(topStrengths[iOut] <= topStrengths[iOut - 1]);
+      }
+   }
+
+   // refining every term gives the exact top terms
+   std::vector<IntEbm> exactTopIndexes(k_cTop);
+   std::vector<double> exactTopStrengths(k_cTop);
+   error = CalcInteractionStrengths(test.GetInteractionHandle(), cTerms, &dimensionCounts[0], &featureIndexes[0],
+      CalcInteractionFlags_Default, 0, 0, static_cast<IntEbm>(k_cTop), &exactTopIndexes[0], &exactTopStrengths[0],
+      nullptr);
+   CHECK(Error_None == error);
+   std::vector<IntEbm> allRefinedIndexes(dimensionCounts.size() + 1);
+   error = CalcInteractionStrengthsRefined(testSubsample.GetInteractionHandle(), test.GetInteractionHandle(), cTerms,
+      &dimensionCounts[0], &featureIndexes[0], CalcInteractionFlags_Default, 0, 0, cTerms + 1,
+      static_cast<IntEbm>(k_cTop), &topIndexes[0], &topStrengths[0], &allRefinedIndexes[0]);
+   CHECK(Error_None == error);
+   CHECK(exactTopIndexes == topIndexes);
+   CHECK(exactTopStrengths == topStrengths);
+   CHECK(IntEbm { -1 } == allRefinedIndexes[dimensionCounts.size()]);
+
+   // the top terms must come from the refined terms
+   error = CalcInteractionStrengthsRefined(testSubsample.GetInteractionHandle(), test.GetInteractionHandle(), cTerms,
+      &dimensionCounts[0], &featureIndexes[0], CalcInteractionFlags_Default, 0, 0, 2, 3, &topIndexes[0],
+      &topStrengths[0], nullptr);
+   CHECK(Error_IllegalParamVal == error);
+}
+
+TEST_CASE("CreateInteractionDetectorFromBooster matches CreateInteractionDetector on the current model, interaction") {
+   const std::vector<FeatureTest> features = { FeatureTest(3), FeatureTest(4), FeatureTest(2) };
+   const std::vector<std::vector<IntEbm>> termFeatures = { { 0 }, { 1 }, { 2 } };
+   const std::vector<std::vector<IntEbm>> terms = { { 0, 1 }, { 0, 2 }, { 1, 2 }, { 0, 1, 2 } };
+
+   for(int iTask = 0; iTask < 2; ++iTask) {
+      const TaskEbm task = 0 == iTask ? Task_Regression : Task_BinaryClassification;
+
+      std::vector<TestSample> train;
+      for(IntEbm iSample = 0; iSample < 96; ++iSample) {
+         const std::vector<IntEbm> bins = { iSample % 3, (iSample / 3) % 4, (iSample / 12) % 2 };
+         const double weight = 1.0 + 0.25 * static_cast<double>(iSample % 5);
+         double target = static_cast<double>(bins[0] * bins[1]) + 0.5 * static_cast<double>(bins[2]);
+         if(Task_BinaryClassification == task) {
+            target = 2.0 <= target || 0 == iSample % 7 ? 1.0 : 0.0;
+         }
+         train.push_back(TestSample(bins, target, weight));
+      }
+
+      InteractionHandle interactionHandle = nullptr;
+      std::vector<double> strengthsFromBooster;
+      std::vector<TestSample> samplesWithScores;
+      {
+         TestBoost test = TestBoost(task, features, termFeatures, train, {});
+         for(int iRound = 0; iRound < 3; ++iRound) {
+            for(size_t iTerm = 0; iTerm < termFeatures.size(); ++iTerm) {
+               test.Boost(static_cast<IntEbm>(iTerm));
+            }
+         }
+
+         ErrorEbm error = CreateInteractionDetectorFromBooster(test.GetBoosterHandle(), &interactionHandle);
+         CHECK(Error_None == error);
+
+         for(const std::vector<IntEbm> & term : terms) {
+            double strength;
+            error = CalcInteractionStrength(interactionHandle, static_cast<IntEbm>(term.size()), &term[0],
+               CalcInteractionFlags_Default, 0, 0, &strength);
+            CHECK(Error_None == error);
+            strengthsFromBooster.push_back(strength);
+         }
+
+         for(const TestSample & sample : train) {
+            double score = 0.0;
+            for(size_t iTerm = 0; iTerm < termFeatures.size(); ++iTerm) {
+               const size_t iBin = static_cast<size_t>(sample.m_sampleBinIndexes[static_cast<size_t>(termFeatures[iTerm][0])]);
+               score += test.GetCurrentTermScore(iTerm, { iBin }, Task_BinaryClassification == task ? 1 : 0);
+            }
+            // binary classification takes the logits of both classes, with the first one as the zero
+            const std::vector<double> initScores =
+               Task_BinaryClassification == task ? std::vector<double> { 0.0, score } : std::vector<double> { score };
+            samplesWithScores.push_back(TestSample(sample.m_sampleBinIndexes, sample.m_target, sample.m_weight, initScores));
+         }
+      }
+
+      // the same strengths from a dataset built with the booster's current scores as the init scores
+      TestInteraction test = TestInteraction(task, features, samplesWithScores);
+      for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+         const double strength = test.TestCalcInteractionStrength(terms[iTerm]);
+         CHECK(0.0 < strength);
+         CHECK_APPROX(strengthsFromBooster[iTerm], strength);
+
+         // the booster was freed above, but the detector keeps what it needs alive
+         double strengthAfterFree;
+         const ErrorEbm error = CalcInteractionStrength(interactionHandle, static_cast<IntEbm>(terms[iTerm].size()),
+            &terms[iTerm][0], CalcInteractionFlags_Default, 0, 0, &strengthAfterFree);
+         CHECK(Error_None == error);
+         CHECK(strengthsFromBooster[iTerm] == strengthAfterFree);
+      }
+      FreeInteractionDetector(interactionHandle);
+   }
+}
+
+TEST_CASE("CreateInteractionDetectorFromBooster rejects features without a main term, interaction, regression") {
+   std::vector<TestSample> train;
+   for(IntEbm iSample = 0; iSample < 24; ++iSample) {
+      const std::vector<IntEbm> bins = { iSample % 3, (iSample / 3) % 4, (iSample / 12) % 2 };
+      train.push_back(TestSample(bins, static_cast<double>(bins[0] * bins[2])));
+   }
+
+   TestBoost test = TestBoost(
+      Task_Regression,
+      { FeatureTest(3), FeatureTest(4), FeatureTest(2) },
+      { { 0 }, { 0, 1 }, { 2 } },
+      train,
+      {}
+   );
+
+   InteractionHandle interactionHandle = nullptr;
+   ErrorEbm error = CreateInteractionDetectorFromBooster(test.GetBoosterHandle(), &interactionHandle);
+   CHECK(Error_None == error);
+
+   const IntEbm featuresWithMains[] = { 0, 2 };
+   double strength;
+   error = CalcInteractionStrength(interactionHandle, 2, featuresWithMains, CalcInteractionFlags_Default, 0, 0, &strength);
+   CHECK(Error_None == error);
+   CHECK(0.0 < strength);
+
+   // feature 1 only appears in a pair, so its bin indexes are not available
+   const IntEbm featuresWithoutMains[] = { 0, 1 };
+   error = CalcInteractionStrength(interactionHandle, 2, featuresWithoutMains, CalcInteractionFlags_Default, 0, 0, &strength);
+   CHECK(Error_IllegalParamVal == error);
+
+   FreeInteractionDetector(interactionHandle);
+
+   // inner bags mix the bagging counts into the weights, so weighted boosters need to be created without them
+   std::vector<TestSample> trainWeighted;
+   for(IntEbm iSample = 0; iSample < 24; ++iSample) {
+      const std::vector<IntEbm> bins = { iSample % 3, (iSample / 3) % 4, (iSample / 12) % 2 };
+      trainWeighted.push_back(TestSample(bins, static_cast<double>(bins[0] * bins[2]), 2.0));
+   }
+   TestBoost testBagged = TestBoost(
+      Task_Regression,
+      { FeatureTest(3), FeatureTest(4), FeatureTest(2) },
+      { { 0 }, { 1 }, { 2 } },
+      trainWeighted,
+      {},
+      2
+   );
+   interactionHandle = nullptr;
+   error = CreateInteractionDetectorFromBooster(testBagged.GetBoosterHandle(), &interactionHandle);
+   CHECK(Error_IllegalParamVal == error);
+   CHECK(nullptr == interactionHandle);
+}
+
+TEST_CASE("CalcInteractionStrengths with a sparse feature matches CalcInteractionStrength, interaction, regression") {
+   static constexpr size_t k_cSamples = 4001;
+
+   // feature 0 is almost always bin 1, so it is stored sparsely while features 1 and 2 are dense
+   std::vector<TestSample> samples;
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      const size_t iCycle = iSample % 397;
+      const IntEbm bin0 = 5 == iCycle ? 0 : 200 == iCycle ? 2 : 1;
+      const IntEbm bin1 = static_cast<IntEbm>(iSample % 3);
+      const IntEbm bin2 = static_cast<IntEbm>(iSample / 3 % 5);
+      const double target = static_cast<double>(bin0 * bin1) * 2.0 + static_cast<double>(bin2) +
+         static_cast<double>(iSample % 7) * 0.125;
+      samples.push_back(TestSample({ bin0, bin1, bin2 }, target, static_cast<double>(1 + iSample % 2)));
+   }
+   TestInteraction test = TestInteraction(
+      Task_Regression,
+      { FeatureTest(3), FeatureTest(3), FeatureTest(5) },
+      samples
+   );
+
+   const std::vector<std::vector<IntEbm>> terms = { { 0, 1 }, { 0, 2 }, { 1, 2 }, { 2, 0 } };
+   std::vector<IntEbm> dimensionCounts;
+   std::vector<IntEbm> featureIndexes;
+   std::vector<double> expected;
+   for(const std::vector<IntEbm> & term : terms) {
+      dimensionCounts.push_back(static_cast<IntEbm>(term.size()));
+      featureIndexes.insert(featureIndexes.end(), term.begin(), term.end());
+      expected.push_back(test.TestCalcInteractionStrength(term));
+   }
+
+   for(int iRun = 0; iRun < 2; ++iRun) {
+      SetThreadCount(0 == iRun ? 1 : 4);
+      std::vector<double> strengths(terms.size());
+      const ErrorEbm error = CalcInteractionStrengths(test.GetInteractionHandle(), static_cast<IntEbm>(terms.size()),
+         &dimensionCounts[0], &featureIndexes[0], CalcInteractionFlags_Default, 0, 0, 0, nullptr, &strengths[0],
+         nullptr);
+      CHECK(Error_None == error);
+      for(size_t iTerm = 0; iTerm < terms.size(); ++iTerm) {
+         CHECK_APPROX(strengths[iTerm], expected[iTerm]);
+      }
+   }
+   SetThreadCount(1);
+}
+
+TEST_CASE("target sorted layout matches the original layout, interaction, multiclass") {
+   static constexpr size_t k_cSamples = 1531;
+
+   std::vector<TestSample> samples;
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      const IntEbm bin0 = static_cast<IntEbm>(iSample % 4);
+      const IntEbm bin1 = static_cast<IntEbm>(iSample / 5 % 3);
+      const double target = static_cast<double>((bin0 * bin1 + iSample / 11) % 3);
+      const double initScore = static_cast<double>(iSample % 7) * 0.125 - 0.375;
+      samples.push_back(TestSample({ bin0, bin1 }, target, static_cast<double>(1 + iSample % 2), 
+         { initScore, -initScore, 0.5 * initScore }));
+   }
+
+   TestInteraction testOriginal = TestInteraction(
+      3,
+      { FeatureTest(4), FeatureTest(3) },
+      samples,
+      CreateInteractionFlags_Default
+   );
+   TestInteraction testSorted = TestInteraction(
+      3,
+      { FeatureTest(4), FeatureTest(3) },
+      samples,
+      CreateInteractionFlags_TargetSorted
+   );
+
+   const double strength = testOriginal.TestCalcInteractionStrength({ 0, 1 });
+   CHECK(0.0 < strength);
+   CHECK_APPROX(testSorted.TestCalcInteractionStrength({ 0, 1 }), strength);
+}
+
+TEST_CASE("64 bit SIMD zones match the 64 bit CPU zone when approximations are disabled, interaction") {
+   static constexpr size_t k_cSamples = 1021;
+
+   for(TaskEbm task : { Task_Regression, Task_BinaryClassification, TaskEbm { 3 } }) {
+      // without weights the SIMD zones add the sample counts and weights per lane instead of reading the weights
+      for(bool bWeighted : { true, false }) {
+         std::vector<TestSample> samples;
+         for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+            const IntEbm bin0 = static_cast<IntEbm>(iSample % 5);
+            const IntEbm bin1 = static_cast<IntEbm>(iSample / 7 % 3);
+            const double target = Task_Regression == task ? static_cast<double>(bin0 * bin1) - static_cast<double>(iSample % 13) * 0.25 :
+               Task_BinaryClassification == task ? (0 == (iSample * 7 + iSample / 3) % 5 || 2 == bin0 && 1 == bin1 ? 1.0 : 0.0) :
+               static_cast<double>((static_cast<size_t>(bin0 * bin1) + iSample / 11) % 3);
+            samples.push_back(bWeighted ? TestSample({ bin0, bin1 }, target, static_cast<double>(1 + iSample % 3)) :
+               TestSample({ bin0, bin1 }, target));
+         }
+
+         // on machines without AVX2 or AVX-512 these fall back to Cpu_64, which trivially matches
+         TestInteraction testCpu = TestInteraction(task, { FeatureTest(5), FeatureTest(3) }, samples, 
+            CreateInteractionFlags_DisableApprox, AccelerationFlags_NONE);
+         TestInteraction testAvx2 = TestInteraction(task, { FeatureTest(5), FeatureTest(3) }, samples, 
+            CreateInteractionFlags_DisableApprox, AccelerationFlags_AVX2);
+         TestInteraction testAvx512 = TestInteraction(task, { FeatureTest(5), FeatureTest(3) }, samples, 
+            CreateInteractionFlags_DisableApprox, AccelerationFlags_AVX512F);
+
+         const double strengthCpu = testCpu.TestCalcInteractionStrength({ 0, 1 });
+         CHECK(0.0 < strengthCpu);
+         CHECK_APPROX(testAvx2.TestCalcInteractionStrength({ 0, 1 }), strengthCpu);
+         CHECK_APPROX(testAvx512.TestCalcInteractionStrength({ 0, 1 }), strengthCpu);
+      }
+   }
+}
@@ -56,9 +56,18 @@ extern void FAILED(const double val, TestCaseHidden * const pTestCaseHidden, con
 #pragma optimize("", on)
 #endif // _MSC_VER
 
+static LogListener g_logListener = nullptr;
+
+extern void SetLogListener(const LogListener logListener) {
+   g_logListener = logListener;
+}
+
 void EBM_CALLING_CONVENTION LogCallback(const TraceEbm traceLevel, const char * const message) {
    const size_t cChars = strlen(message); // test that the string memory is accessible
    UNUSED(cChars);
+   if(nullptr != g_logListener) {
+      (*g_logListener)(traceLevel, message);
+   }
    if(traceLevel <= Trace_Off) {
       // don't display log messages during tests, but having this code here makes it easy to turn on when needed
       printf("\n%s: %s\n", GetTraceLevelString(traceLevel), message);
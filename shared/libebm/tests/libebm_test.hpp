@@ -28,7 +28,8 @@ enum class TestPriority {
    CutUniform,
    CutWinsorized,
    CutQuantile,
-   Discretize
+   Discretize,
+   PredictScores
 };
 
 class TestException final : public std::exception {
@@ -460,6 +461,10 @@ public:
       return m_boosterHandle;
    }
 
+   inline void * GetRng() {
+      return &m_rng[0];
+   }
+
    BoostRet Boost(
       const IntEbm indexTerm,
       const TermBoostFlags flags = TermBoostFlags_Default,
@@ -513,6 +518,11 @@ public:
    ) const;
 };
 
+// while a listener is set, the test log callback passes every libebm log message to it, regardless of whether
+// the message is displayed.  Tests use this to check which code path libebm took
+typedef void (* LogListener)(const TraceEbm traceLevel, const char * const message);
+void SetLogListener(const LogListener logListener);
+
 void DisplayCuts(
    IntEbm countSamples,
    double * featureVals,
@@ -334,6 +334,110 @@ TEST_CASE("SampleWithoutReplacement, stress test") {
    }
 }
 
+static std::vector<unsigned char> MakeSubsampleDataSet(const std::vector<IntEbm> & targets, const IntEbm cClasses) {
+   const std::vector<IntEbm> binIndexes(targets.size(), 1);
+   const std::vector<double> regressionTargets(targets.begin(), targets.end());
+   const IntEbm cSamples = static_cast<IntEbm>(targets.size());
+
+   const IntEbm size = MeasureDataSetHeader(1, 0, 1) + MeasureFeature(3, EBM_FALSE, EBM_FALSE, EBM_FALSE, cSamples,
+      &binIndexes[0]) + (Task_GeneralClassification <= cClasses ?
+         MeasureClassificationTarget(cClasses, cSamples, &targets[0]) :
+         MeasureRegressionTarget(cSamples, &regressionTargets[0]));
+   std::vector<unsigned char> dataSet(static_cast<size_t>(size));
+   ErrorEbm error = FillDataSetHeader(1, 0, 1, size, &dataSet[0]);
+   if(Error_None == error) {
+      error = FillFeature(3, EBM_FALSE, EBM_FALSE, EBM_FALSE, cSamples, &binIndexes[0], size, &dataSet[0]);
+   }
+   if(Error_None == error) {
+      error = Task_GeneralClassification <= cClasses ?
+         FillClassificationTarget(cClasses, cSamples, &targets[0], size, &dataSet[0]) :
+         FillRegressionTarget(cSamples, &regressionTargets[0], size, &dataSet[0]);
+   }
+   if(Error_None != error) {
+      throw TestException(error, "MakeSubsampleDataSet");
+   }
+   return dataSet;
+}
+
+TEST_CASE("SubsampleWithoutReplacement, classification") {
+   static constexpr size_t cSamples = 1000;
+
+   std::vector<IntEbm> targets;
+   std::vector<BagEbm> bag;
+   size_t aTrainingClassCounts[2] = { 0, 0 };
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const IntEbm target = iSample % 10 < 3 ? 0 : 1;
+      targets.push_back(target);
+      BagEbm replication = 1 + static_cast<BagEbm>(iSample % 3);
+      if(4 == iSample % 5) {
+         replication = -1;
+      } else if(0 == iSample % 7) {
+         replication = 0;
+      } else {
+         ++aTrainingClassCounts[target];
+      }
+      bag.push_back(replication);
+   }
+   const size_t cTrainingSamples = aTrainingClassCounts[0] + aTrainingClassCounts[1];
+   const std::vector<unsigned char> dataSet = MakeSubsampleDataSet(targets, 2);
+
+   std::vector<unsigned char> rng(static_cast<size_t>(MeasureRNG()));
+   InitRNG(k_seed, &rng[0]);
+
+   const size_t cSubsampleSamples = cTrainingSamples / 4;
+   std::vector<BagEbm> bagOut(cSamples);
+   ErrorEbm error = SubsampleWithoutReplacement(&rng[0], &dataSet[0], &bag[0], cSubsampleSamples, &bagOut[0]);
+   CHECK(Error_None == error);
+
+   size_t aSubsampleClassCounts[2] = { 0, 0 };
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      if(bag[iSample] <= BagEbm { 0 }) {
+         CHECK(bag[iSample] == bagOut[iSample]);
+      } else if(BagEbm { 0 } < bagOut[iSample]) {
+         CHECK(bag[iSample] == bagOut[iSample]);
+         ++aSubsampleClassCounts[targets[iSample]];
+      } else {
+         CHECK(BagEbm { -1 } == bagOut[iSample]);
+      }
+   }
+   CHECK(cSubsampleSamples == aSubsampleClassCounts[0] + aSubsampleClassCounts[1]);
+   // stratified, so each class keeps its share of the subsample
+   const double idealClass0 =
+      static_cast<double>(aTrainingClassCounts[0]) * cSubsampleSamples / static_cast<double>(cTrainingSamples);
+   CHECK(std::abs(static_cast<double>(aSubsampleClassCounts[0]) - idealClass0) <= 1.0);
+
+   // asking for all the training samples returns the bag unchanged
+   error = SubsampleWithoutReplacement(&rng[0], &dataSet[0], &bag[0], cTrainingSamples, &bagOut[0]);
+   CHECK(Error_None == error);
+   CHECK(bag == bagOut);
+}
+
+TEST_CASE("SubsampleWithoutReplacement, regression") {
+   static constexpr size_t cSamples = 200;
+
+   std::vector<IntEbm> targets;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      targets.push_back(static_cast<IntEbm>(iSample));
+   }
+   const std::vector<unsigned char> dataSet = MakeSubsampleDataSet(targets, Task_Regression);
+
+   std::vector<unsigned char> rng(static_cast<size_t>(MeasureRNG()));
+   InitRNG(k_seed, &rng[0]);
+
+   std::vector<BagEbm> bagOut(cSamples);
+   const ErrorEbm error = SubsampleWithoutReplacement(&rng[0], &dataSet[0], nullptr, 50, &bagOut[0]);
+   CHECK(Error_None == error);
+
+   size_t cChosen = 0;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      CHECK((BagEbm { 1 } == bagOut[iSample] || BagEbm { -1 } == bagOut[iSample]));
+      if(BagEbm { 1 } == bagOut[iSample]) {
+         ++cChosen;
+      }
+   }
+   CHECK(size_t { 50 } == cChosen);
+}
+
 TEST_CASE("test random number generator equivalency") {
    std::vector<TestSample> samples;
    for(int i = 0; i < 1000; ++i) {